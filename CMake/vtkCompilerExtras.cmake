@@ -25,11 +25,16 @@ if(CMAKE_COMPILER_IS_GNUCXX)
   # Now check if we can use visibility to selectively export symbols
   exec_program(${CMAKE_C_COMPILER} ARGS --version OUTPUT_VARIABLE
     _gcc_version_info)
-  string (REGEX MATCH "[345]\\.[0-9]\\.[0-9]" 
+  string (REGEX MATCH "[1-9][0-9]*\\.[0-9]+\\.[0-9]+"
     _gcc_version "${_gcc_version_info}")
   if(NOT _gcc_version)
-    string (REGEX REPLACE ".*\\(GCC\\).* ([34]\\.[0-9]) .*" "\\1.0" 
+    string (REGEX MATCH "[1-9][0-9]*\\.[0-9]+"
       _gcc_version "${_gcc_version_info}")
+    if(_gcc_version)
+      set(_gcc_version "${_gcc_version}.0")
+    else()
+      set(_gcc_version "0.0.0")
+    endif()
   endif()
   
   # GCC visibility support, on by default and in testing.
@@ -37,7 +42,7 @@ if(CMAKE_COMPILER_IS_GNUCXX)
   option(VTK_USE_GCC_VISIBILITY "Use GCC visibility support if available." ON)
   mark_as_advanced(VTK_USE_GCC_VISIBILITY)
 
-  if(${_gcc_version} VERSION_GREATER 4.2.0 AND BUILD_SHARED_LIBS
+  if("${_gcc_version}" VERSION_GREATER 4.2.0 AND BUILD_SHARED_LIBS
     AND HAVE_GCC_VISIBILITY AND VTK_USE_GCC_VISIBILITY
     AND NOT MINGW AND NOT CYGWIN)
     # Should only be set if GCC is newer than 4.2.0
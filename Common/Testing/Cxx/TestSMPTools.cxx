@@ -0,0 +1,127 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check vtkSMPTools::For, vtkSMPTools::Reduce and vtkSMPThreadLocal with
+// every backend.
+
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+
+#include <vtkstd/vector>
+
+class TestSMPToolsFill
+{
+public:
+  vtkstd::vector<int> *Counts;
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      (*this->Counts)[i] += static_cast<int>(i % 13);
+      }
+    }
+};
+
+class TestSMPToolsSum
+{
+public:
+  vtkSMPThreadLocal<vtkIdType> Partial;
+  vtkSMPThreadLocal<int> Initializations;
+  vtkIdType Total;
+  int BadInitializations;
+
+  TestSMPToolsSum() : Partial(-1), Initializations(0), Total(0),
+                      BadInitializations(0) {}
+
+  void Initialize()
+    {
+    this->Partial.Local() = 0;
+    ++this->Initializations.Local();
+    }
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkIdType& partial = this->Partial.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      partial += i;
+      }
+    }
+  void Reduce()
+    {
+    for (vtkSMPThreadLocal<vtkIdType>::iterator it = this->Partial.begin();
+         it != this->Partial.end(); ++it)
+      {
+      this->Total += *it;
+      }
+    for (vtkSMPThreadLocal<int>::iterator it = this->Initializations.begin();
+         it != this->Initializations.end(); ++it)
+      {
+      this->BadInitializations += (*it != 1);
+      }
+    }
+};
+
+static int TestSMPToolsBackend(int backend)
+{
+  int errors = 0;
+  vtkSMPTools::SetBackend(backend);
+  const char *name = vtkSMPTools::GetBackendAsString();
+
+  const vtkIdType n = 100003;
+  vtkstd::vector<int> counts(n, 0);
+  TestSMPToolsFill fill;
+  fill.Counts = &counts;
+  vtkSMPTools::For(0, n, fill);
+  vtkSMPTools::For(10, 20, 1, fill);
+  vtkSMPTools::For(5, 5, fill);
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    int expected = static_cast<int>(i % 13) * (i >= 10 && i < 20 ? 2 : 1);
+    if (counts[i] != expected)
+      {
+      ++errors;
+      }
+    }
+  if (errors)
+    {
+    cerr << name << ": For visited " << errors << " ids incorrectly" << endl;
+    }
+
+  TestSMPToolsSum sum;
+  vtkSMPTools::Reduce(0, n, 1000, sum);
+  if (sum.Total != n * (n - 1) / 2 || sum.BadInitializations)
+    {
+    cerr << name << ": Reduce gave " << sum.Total << " instead of "
+         << n * (n - 1) / 2 << " with " << sum.BadInitializations
+         << " bad initializations" << endl;
+    ++errors;
+    }
+  if (backend == vtkSMPTools::SEQUENTIAL && sum.Partial.size() != 1)
+    {
+    cerr << name << ": ran on " << sum.Partial.size() << " threads" << endl;
+    ++errors;
+    }
+  return errors;
+}
+
+int TestSMPTools(int, char *[])
+{
+  int errors = 0;
+  vtkSMPTools::Initialize(4);
+  errors += TestSMPToolsBackend(vtkSMPTools::SEQUENTIAL);
+  errors += TestSMPToolsBackend(vtkSMPTools::MULTI_THREADER);
+  errors += TestSMPToolsBackend(vtkSMPTools::THREAD_POOL);
+  vtkSMPTools::SetNumberOfThreads(0);
+  return errors ? 1 : 0;
+}
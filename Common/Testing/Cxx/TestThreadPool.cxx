@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThreadPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that every task handed to vtkThreadPool runs exactly once, that
+// thread ids stay in range, and that nested jobs and the thread pool mode
+// of vtkMultiThreader work.
+
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadPool.h"
+
+#include <vtkstd/vector>
+
+struct TestThreadPoolData
+{
+  vtkSimpleMutexLock Lock;
+  vtkstd::vector<int> Counts;
+  int MaxThreads;
+  int BadThreadIds;
+  vtkThreadPool *Pool;
+  vtkMultiThreaderIDType Caller;
+};
+
+static void TestThreadPoolTask(void *arg, vtkIdType task, int threadId)
+{
+  TestThreadPoolData *data = static_cast<TestThreadPoolData *>(arg);
+  // Uneven amount of work so that stealing kicks in.
+  volatile double sum = 0.0;
+  for (vtkIdType i = 0; i < (task % 7) * 1000; ++i)
+    {
+    sum += i;
+    }
+  data->Lock.Lock();
+  ++data->Counts[task];
+  if (threadId < 0 || threadId >= data->MaxThreads)
+    {
+    ++data->BadThreadIds;
+    }
+  data->Lock.Unlock();
+}
+
+static void TestThreadPoolNestedTask(void *arg, vtkIdType task, int threadId)
+{
+  TestThreadPoolData *data = static_cast<TestThreadPoolData *>(arg);
+  TestThreadPoolData inner;
+  inner.Counts.resize(50, 0);
+  inner.MaxThreads = 3;
+  inner.BadThreadIds = 0;
+  inner.Pool = data->Pool;
+  data->Pool->Execute(TestThreadPoolTask, &inner, 50, 3);
+  int ok = inner.BadThreadIds == 0;
+  for (int i = 0; i < 50; ++i)
+    {
+    ok = ok && inner.Counts[i] == 1;
+    }
+  data->Lock.Lock();
+  data->Counts[task] += ok;
+  if (threadId < 0 || threadId >= data->MaxThreads)
+    {
+    ++data->BadThreadIds;
+    }
+  data->Lock.Unlock();
+}
+
+static int TestThreadPoolCheck(TestThreadPoolData& data, const char *name)
+{
+  int errors = data.BadThreadIds;
+  for (size_t i = 0; i < data.Counts.size(); ++i)
+    {
+    if (data.Counts[i] != 1)
+      {
+      ++errors;
+      }
+    }
+  if (errors)
+    {
+    cerr << name << ": " << errors << " errors" << endl;
+    }
+  return errors;
+}
+
+static VTK_THREAD_RETURN_TYPE TestThreadPoolSingleMethod(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  TestThreadPoolData *data = static_cast<TestThreadPoolData *>(info->UserData);
+  data->Lock.Lock();
+  ++data->Counts[info->ThreadID];
+  if (info->NumberOfThreads != data->MaxThreads)
+    {
+    ++data->BadThreadIds;
+    }
+  // Thread 0 must run on the calling thread, as without the pool.
+  if (info->ThreadID == 0 &&
+      !vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(),
+                                      data->Caller))
+    {
+    ++data->BadThreadIds;
+    }
+  data->Lock.Unlock();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+int TestThreadPool(int, char *[])
+{
+  int errors = 0;
+
+  vtkSmartPointer<vtkThreadPool> pool = vtkSmartPointer<vtkThreadPool>::New();
+  pool->SetNumberOfWorkers(3);
+  if (pool->GetNumberOfWorkers() != 3)
+    {
+    // No thread support, the pool runs everything on the caller.
+    cout << "Pool has " << pool->GetNumberOfWorkers() << " workers" << endl;
+    }
+
+  // Many small tasks on all threads.
+  TestThreadPoolData data;
+  data.Counts.resize(10000, 0);
+  data.MaxThreads = 4;
+  data.BadThreadIds = 0;
+  data.Pool = pool;
+  data.Caller = vtkMultiThreader::GetCurrentThreadID();
+  pool->Execute(TestThreadPoolTask, &data, 10000, 4);
+  errors += TestThreadPoolCheck(data, "Execute");
+
+  // Fewer tasks than threads.
+  data.Counts.assign(2, 0);
+  pool->Execute(TestThreadPoolTask, &data, 2, 4);
+  errors += TestThreadPoolCheck(data, "Few tasks");
+
+  // Repeated small jobs reuse the same threads.
+  for (int i = 0; i < 100; ++i)
+    {
+    data.Counts.assign(8, 0);
+    pool->Execute(TestThreadPoolTask, &data, 8, 4);
+    errors += TestThreadPoolCheck(data, "Repeated");
+    }
+
+  // Tasks that submit jobs to the same pool must not dead-lock.
+  data.Counts.assign(20, 0);
+  pool->Execute(TestThreadPoolNestedTask, &data, 20, 4);
+  errors += TestThreadPoolCheck(data, "Nested");
+
+  // Resizing the pool.
+  pool->SetNumberOfWorkers(1);
+  data.Counts.assign(1000, 0);
+  pool->Execute(TestThreadPoolTask, &data, 1000, 4);
+  errors += TestThreadPoolCheck(data, "Resized");
+  cout << "Steals: " << pool->GetNumberOfSteals() << endl;
+
+  // vtkMultiThreader on top of the process-wide pool.
+  vtkSmartPointer<vtkMultiThreader> threader =
+    vtkSmartPointer<vtkMultiThreader>::New();
+  threader->SetNumberOfThreads(4);
+  threader->UseThreadPoolOn();
+  threader->SetSingleMethod(TestThreadPoolSingleMethod, &data);
+  for (int i = 0; i < 10; ++i)
+    {
+    data.Counts.assign(4, 0);
+    data.MaxThreads = 4;
+    threader->SingleMethodExecute();
+    errors += TestThreadPoolCheck(data, "SingleMethodExecute");
+    }
+
+  data.Counts.assign(500, 0);
+  threader->PieceMethodExecute(TestThreadPoolTask, &data, 500);
+  errors += TestThreadPoolCheck(data, "PieceMethodExecute");
+
+  return errors ? 1 : 0;
+}
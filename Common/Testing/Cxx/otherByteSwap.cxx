@@ -154,8 +154,90 @@ int TestByteSwap(ostream& strm)
 }
 
 
+// Check the range swaps, in place and while copying, against swapping
+// one word at a time.  The lengths and offsets exercise the vector loops,
+// their scalar tails and unaligned buffers.
+int TestByteSwapRanges()
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  const int swapLE = 1;
+#else
+  const int swapLE = 0;
+#endif
+  const int maxWords = 100;
+  unsigned char input[8*maxWords + 8];
+  unsigned char expected[8*maxWords + 8];
+  unsigned char inPlace[8*maxWords + 8];
+  unsigned char copy[8*maxWords + 8];
+  for (int i = 0; i < 8*maxWords + 8; ++i)
+    {
+    input[i] = static_cast<unsigned char>(i*37 + 11);
+    }
+
+  int errors = 0;
+  for (int size = 2; size <= 8; size *= 2)
+    {
+    for (int le = 0; le < 2; ++le)
+      {
+      for (int offset = 0; offset < 3; ++offset)
+        {
+        for (int num = 0; num <= maxWords; ++num)
+          {
+          const unsigned char* in = input + offset;
+          for (int i = 0; i < num*size; ++i)
+            {
+            // Reverse the bytes of each word when the order differs.
+            int j = (le == swapLE) ? (i - i % size) + size - 1 - i % size : i;
+            expected[i] = in[j];
+            }
+          memcpy(inPlace + offset, in, num*size);
+          memset(copy, 0, sizeof(copy));
+          switch (size*2 + le)
+            {
+            case 4:
+              vtkByteSwap::Swap2BERange(inPlace + offset, num);
+              vtkByteSwap::Swap2BERangeCopy(in, copy + offset, num);
+              break;
+            case 5:
+              vtkByteSwap::Swap2LERange(inPlace + offset, num);
+              vtkByteSwap::Swap2LERangeCopy(in, copy + offset, num);
+              break;
+            case 8:
+              vtkByteSwap::Swap4BERange(inPlace + offset, num);
+              vtkByteSwap::Swap4BERangeCopy(in, copy + offset, num);
+              break;
+            case 9:
+              vtkByteSwap::Swap4LERange(inPlace + offset, num);
+              vtkByteSwap::Swap4LERangeCopy(in, copy + offset, num);
+              break;
+            case 16:
+              vtkByteSwap::Swap8BERange(inPlace + offset, num);
+              vtkByteSwap::Swap8BERangeCopy(in, copy + offset, num);
+              break;
+            case 17:
+              vtkByteSwap::Swap8LERange(inPlace + offset, num);
+              vtkByteSwap::Swap8LERangeCopy(in, copy + offset, num);
+              break;
+            }
+          if (memcmp(inPlace + offset, expected, num*size) != 0 ||
+              memcmp(copy + offset, expected, num*size) != 0 ||
+              copy[offset + num*size] != 0)
+            {
+            cerr << "Swap" << size << (le ? "LE" : "BE") << "Range of "
+                 << num << " words at offset " << offset << " failed"
+                 << endl;
+            ++errors;
+            }
+          }
+        }
+      }
+    }
+  return errors;
+}
+
 int otherByteSwap(int,char *[])
 {
   vtksys_ios::ostringstream vtkmsg_with_warning_C4701; 
-  return TestByteSwap(vtkmsg_with_warning_C4701);
+  int result = TestByteSwap(vtkmsg_with_warning_C4701);
+  return result || TestByteSwapRanges();
 } 
@@ -16,6 +16,17 @@
 #include <memory.h>
 #include "vtkObjectFactory.h"
 
+// Swap whole vector registers at a time where the compiler targets them.
+#if defined(__AVX2__)
+# include <immintrin.h>
+# define VTK_BYTE_SWAP_USE_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define VTK_BYTE_SWAP_USE_SSE2
+#endif
+
 vtkStandardNewMacro(vtkByteSwap);
 
 //----------------------------------------------------------------------------
@@ -28,12 +39,126 @@ vtkByteSwap::~vtkByteSwap()
 {
 }
 
+//----------------------------------------------------------------------------
+// Swap the bytes of a whole word.  Compilers turn these into a single
+// byte swap instruction where there is one.
+static inline vtkTypeUInt16 vtkByteSwapWord(vtkTypeUInt16 x)
+{
+  return static_cast<vtkTypeUInt16>((x << 8) | (x >> 8));
+}
+static inline vtkTypeUInt32 vtkByteSwapWord(vtkTypeUInt32 x)
+{
+  return ((x << 24) | ((x << 8) & 0x00FF0000) |
+          ((x >> 8) & 0x0000FF00) | (x >> 24));
+}
+static inline vtkTypeUInt64 vtkByteSwapWord(vtkTypeUInt64 x)
+{
+  return ((static_cast<vtkTypeUInt64>(
+             vtkByteSwapWord(static_cast<vtkTypeUInt32>(x))) << 32) |
+          vtkByteSwapWord(static_cast<vtkTypeUInt32>(x >> 32)));
+}
+
+// Swap the remaining words of a range one at a time.  memcpy keeps
+// unaligned buffers and the aliasing rules safe.
+template <class W>
+static inline void vtkByteSwapWords(const char* in, char* out, vtkIdType num)
+{
+  for(vtkIdType i = 0; i < num; ++i)
+    {
+    W word;
+    memcpy(&word, in + i*sizeof(W), sizeof(W));
+    word = vtkByteSwapWord(word);
+    memcpy(out + i*sizeof(W), &word, sizeof(W));
+    }
+}
+
+#if defined(VTK_BYTE_SWAP_USE_AVX2)
+// Reverse the bytes of every s-byte word in 32 bytes.
+template <size_t s> static inline __m256i vtkByteSwapAVX2(__m256i v);
+VTK_TEMPLATE_SPECIALIZE inline __m256i vtkByteSwapAVX2<2>(__m256i v)
+{
+  return _mm256_shuffle_epi8(v, _mm256_setr_epi8(
+      1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14,
+      1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14));
+}
+VTK_TEMPLATE_SPECIALIZE inline __m256i vtkByteSwapAVX2<4>(__m256i v)
+{
+  return _mm256_shuffle_epi8(v, _mm256_setr_epi8(
+      3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12,
+      3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12));
+}
+VTK_TEMPLATE_SPECIALIZE inline __m256i vtkByteSwapAVX2<8>(__m256i v)
+{
+  return _mm256_shuffle_epi8(v, _mm256_setr_epi8(
+      7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8,
+      7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8));
+}
+#endif
+
+#if defined(VTK_BYTE_SWAP_USE_SSE2)
+// Reverse the bytes of every s-byte word in 16 bytes.  SSE2 has no byte
+// shuffle, so swap the bytes of each 16-bit word and then reverse the
+// order of the 16-bit words.
+template <size_t s> static inline __m128i vtkByteSwapSSE2(__m128i v);
+VTK_TEMPLATE_SPECIALIZE inline __m128i vtkByteSwapSSE2<2>(__m128i v)
+{
+  return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+VTK_TEMPLATE_SPECIALIZE inline __m128i vtkByteSwapSSE2<4>(__m128i v)
+{
+  v = vtkByteSwapSSE2<2>(v);
+  v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2,3,0,1));
+  return _mm_shufflehi_epi16(v, _MM_SHUFFLE(2,3,0,1));
+}
+VTK_TEMPLATE_SPECIALIZE inline __m128i vtkByteSwapSSE2<8>(__m128i v)
+{
+  v = vtkByteSwapSSE2<2>(v);
+  v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0,1,2,3));
+  return _mm_shufflehi_epi16(v, _MM_SHUFFLE(0,1,2,3));
+}
+#endif
+
+// Swap num words of s bytes from in to out.  The buffers may be the same
+// but must not otherwise overlap: each block is loaded before it is
+// stored.
+template <size_t s, class W>
+static void vtkByteSwapCopyRange(const char* in, char* out, vtkIdType num)
+{
+  vtkIdType i = 0;
+#if defined(VTK_BYTE_SWAP_USE_AVX2)
+  const vtkIdType avxWords = static_cast<vtkIdType>(32 / s);
+  for(; i + avxWords <= num; i += avxWords)
+    {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in+i*s));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i*s),
+                        vtkByteSwapAVX2<s>(v));
+    }
+#endif
+#if defined(VTK_BYTE_SWAP_USE_SSE2)
+  const vtkIdType sseWords = static_cast<vtkIdType>(16 / s);
+  for(; i + sseWords <= num; i += sseWords)
+    {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in+i*s));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out+i*s),
+                     vtkByteSwapSSE2<s>(v));
+    }
+#endif
+  vtkByteSwapWords<W>(in + i*s, out + i*s, num - i);
+}
+
 //----------------------------------------------------------------------------
 // Define swap functions for each type size.
 template <size_t s> struct vtkByteSwapper;
 VTK_TEMPLATE_SPECIALIZE struct vtkByteSwapper<1>
 {
   static inline void Swap(char*) {}
+  static inline void SwapRange(const char* in, char* out, vtkIdType num)
+    {
+    if(in != out)
+      {
+      memcpy(out, in, static_cast<size_t>(num));
+      }
+    }
 };
 VTK_TEMPLATE_SPECIALIZE struct vtkByteSwapper<2>
 {
@@ -42,6 +167,10 @@ VTK_TEMPLATE_SPECIALIZE struct vtkByteSwapper<2>
     char one_byte;
     one_byte = data[0]; data[0] = data[1]; data[1] = one_byte;
     }
+  static inline void SwapRange(const char* in, char* out, vtkIdType num)
+    {
+    vtkByteSwapCopyRange<2, vtkTypeUInt16>(in, out, num);
+    }
 };
 VTK_TEMPLATE_SPECIALIZE struct vtkByteSwapper<4>
 {
@@ -51,6 +180,10 @@ VTK_TEMPLATE_SPECIALIZE struct vtkByteSwapper<4>
     one_byte = data[0]; data[0] = data[3]; data[3] = one_byte;
     one_byte = data[1]; data[1] = data[2]; data[2] = one_byte;
     }
+  static inline void SwapRange(const char* in, char* out, vtkIdType num)
+    {
+    vtkByteSwapCopyRange<4, vtkTypeUInt32>(in, out, num);
+    }
 };
 VTK_TEMPLATE_SPECIALIZE struct vtkByteSwapper<8>
 {
@@ -62,17 +195,31 @@ VTK_TEMPLATE_SPECIALIZE struct vtkByteSwapper<8>
     one_byte = data[2]; data[2] = data[5]; data[5] = one_byte;
     one_byte = data[3]; data[3] = data[4]; data[4] = one_byte;
     }
+  static inline void SwapRange(const char* in, char* out, vtkIdType num)
+    {
+    vtkByteSwapCopyRange<8, vtkTypeUInt64>(in, out, num);
+    }
 };
 
 //----------------------------------------------------------------------------
 // Define range swap functions.
 template <class T> inline void vtkByteSwapRange(T* first, vtkIdType num)
 {
-  // Swap one value at a time.
-  T* last = first + num;
-  for(T* p=first; p != last; ++p)
+  char* p = reinterpret_cast<char*>(first);
+  vtkByteSwapper<sizeof(T)>::SwapRange(p, p, num);
+}
+template <class T>
+inline void vtkByteSwapRangeCopy(const T* src, T* dst, vtkIdType num)
+{
+  vtkByteSwapper<sizeof(T)>::SwapRange(reinterpret_cast<const char*>(src),
+                                       reinterpret_cast<char*>(dst), num);
+}
+template <class T>
+inline void vtkByteSwapNoSwapCopy(const T* src, T* dst, vtkIdType num)
+{
+  if(src != dst)
     {
-    vtkByteSwapper<sizeof(T)>::Swap(reinterpret_cast<char*>(p));
+    memcpy(dst, src, static_cast<size_t>(num)*sizeof(T));
     }
 }
 inline bool vtkByteSwapRangeWrite(const char* first, vtkIdType num,
@@ -96,22 +243,27 @@ inline bool vtkByteSwapRangeWrite(const unsigned char* first, vtkIdType num,
   size_t status=fwrite(first,sizeof(unsigned char),static_cast<size_t>(num),f);
   return status==static_cast<size_t>(num);
 }
+// The number of bytes swapped at a time on the way to a file.
+#define VTK_BYTE_SWAP_WRITE_BLOCK 4096
+
 template <class T>
 inline bool vtkByteSwapRangeWrite(const T* first, vtkIdType num, FILE* f, long)
 {
-  // Swap and write one value at a time.  We do not need to do this in
-  // blocks because the file stream is already buffered.
-  const T* last = first + num;
-  bool result=true;
-  for(const T* p=first; p != last && result; ++p)
+  // Swap a block of values at a time into a buffer and write it.
+  char block[VTK_BYTE_SWAP_WRITE_BLOCK];
+  const vtkIdType blockValues = VTK_BYTE_SWAP_WRITE_BLOCK / sizeof(T);
+  const char* p = reinterpret_cast<const char*>(first);
+  for(vtkIdType i = 0; i < num; i += blockValues)
     {
-    // Use a union to avoid breaking C++ aliasing rules.
-    union { T value; char data[sizeof(T)]; } temp = {*p};
-    vtkByteSwapper<sizeof(T)>::Swap(temp.data);
-    size_t status=fwrite(temp.data, sizeof(T), 1, f);
-    result=status==1;
+    vtkIdType n = num - i < blockValues ? num - i : blockValues;
+    vtkByteSwapper<sizeof(T)>::SwapRange(p + i*sizeof(T), block, n);
+    size_t status=fwrite(block, sizeof(T), static_cast<size_t>(n), f);
+    if(status != static_cast<size_t>(n))
+      {
+      return false;
+      }
     }
-  return result;
+  return true;
 }
 inline void vtkByteSwapRangeWrite(const char* first, vtkIdType num,
                                   ostream* os, int)
@@ -137,15 +289,15 @@ template <class T>
 inline void vtkByteSwapRangeWrite(const T* first, vtkIdType num,
                                   ostream* os, long)
 {
-  // Swap and write one value at a time.  We do not need to do this in
-  // blocks because the file stream is already buffered.
-  const T* last = first + num;
-  for(const T* p=first; p != last; ++p)
+  // Swap a block of values at a time into a buffer and write it.
+  char block[VTK_BYTE_SWAP_WRITE_BLOCK];
+  const vtkIdType blockValues = VTK_BYTE_SWAP_WRITE_BLOCK / sizeof(T);
+  const char* p = reinterpret_cast<const char*>(first);
+  for(vtkIdType i = 0; i < num; i += blockValues)
     {
-    // Use a union to avoid breaking C++ aliasing rules.
-    union { T value; char data[sizeof(T)]; } temp = {*p};
-    vtkByteSwapper<sizeof(T)>::Swap(temp.data);
-    os->write(temp.data, sizeof(T));
+    vtkIdType n = num - i < blockValues ? num - i : blockValues;
+    vtkByteSwapper<sizeof(T)>::SwapRange(p + i*sizeof(T), block, n);
+    os->write(block, n*static_cast<vtkIdType>(sizeof(T)));
     }
 }
 
@@ -155,6 +307,11 @@ inline void vtkByteSwapRangeWrite(const T* first, vtkIdType num,
 template <class T> inline void vtkByteSwapBE(T*) {}
 template <class T> inline void vtkByteSwapBERange(T*, vtkIdType) {}
 template <class T>
+inline void vtkByteSwapBERangeCopy(const T* src, T* dst, vtkIdType num)
+{
+  vtkByteSwapNoSwapCopy(src, dst, num);
+}
+template <class T>
 inline bool vtkByteSwapBERangeWrite(const T* p, vtkIdType num, FILE* f)
 {
   size_t status=fwrite(p, sizeof(T), static_cast<size_t>(num), f);
@@ -174,6 +331,11 @@ template <class T> inline void vtkByteSwapLERange(T* p, vtkIdType num)
   vtkByteSwapRange(p, num);
 }
 template <class T>
+inline void vtkByteSwapLERangeCopy(const T* src, T* dst, vtkIdType num)
+{
+  vtkByteSwapRangeCopy(src, dst, num);
+}
+template <class T>
 inline bool vtkByteSwapLERangeWrite(const T* p, vtkIdType num, FILE* f)
 {
   return vtkByteSwapRangeWrite(p, num, f, 1);
@@ -193,6 +355,11 @@ template <class T> inline void vtkByteSwapBERange(T* p, vtkIdType num)
   vtkByteSwapRange(p, num);
 }
 template <class T>
+inline void vtkByteSwapBERangeCopy(const T* src, T* dst, vtkIdType num)
+{
+  vtkByteSwapRangeCopy(src, dst, num);
+}
+template <class T>
 inline bool vtkByteSwapBERangeWrite(const T* p, vtkIdType num, FILE* f)
 {
   return vtkByteSwapRangeWrite(p, num, f, 1);
@@ -205,6 +372,11 @@ inline void vtkByteSwapBERangeWrite(const T* p, vtkIdType num, ostream* os)
 template <class T> inline void vtkByteSwapLE(T*) {}
 template <class T> inline void vtkByteSwapLERange(T*, vtkIdType) {}
 template <class T>
+inline void vtkByteSwapLERangeCopy(const T* src, T* dst, vtkIdType num)
+{
+  vtkByteSwapNoSwapCopy(src, dst, num);
+}
+template <class T>
 inline bool vtkByteSwapLERangeWrite(const T* p, vtkIdType num, FILE* f)
 {
   size_t status=fwrite(p, sizeof(T), static_cast<size_t>(num), f);
@@ -226,6 +398,10 @@ inline void vtkByteSwapLERangeWrite(const T* p, vtkIdType num, ostream* os)
     { vtkByteSwapLERange(p, num); }                                             \
   void vtkByteSwap::SwapBERange(T* p, vtkIdType num)                            \
     { vtkByteSwapBERange(p, num); }                                             \
+  void vtkByteSwap::SwapLERangeCopy(const T* src, T* dst, vtkIdType num)        \
+    { vtkByteSwapLERangeCopy(src, dst, num); }                                  \
+  void vtkByteSwap::SwapBERangeCopy(const T* src, T* dst, vtkIdType num)        \
+    { vtkByteSwapBERangeCopy(src, dst, num); }                                  \
   bool vtkByteSwap::SwapLERangeWrite(const T* p, vtkIdType num, FILE* file)     \
     { return vtkByteSwapLERangeWrite(p, num, file); }                                  \
   bool vtkByteSwap::SwapBERangeWrite(const T* p, vtkIdType num, FILE* file)     \
@@ -283,6 +459,12 @@ typedef double vtkByteSwapType8;
     { vtkByteSwap::SwapLERange(static_cast<vtkByteSwapType##S*>(p), n); }       \
   void vtkByteSwap::Swap##S##BERange(void* p, int n)                            \
     { vtkByteSwap::SwapBERange(static_cast<vtkByteSwapType##S*>(p), n); }       \
+  void vtkByteSwap::Swap##S##LERangeCopy(const void* s, void* d, vtkIdType n)   \
+    { vtkByteSwap::SwapLERangeCopy(static_cast<const vtkByteSwapType##S*>(s),   \
+                                   static_cast<vtkByteSwapType##S*>(d), n); }   \
+  void vtkByteSwap::Swap##S##BERangeCopy(const void* s, void* d, vtkIdType n)   \
+    { vtkByteSwap::SwapBERangeCopy(static_cast<const vtkByteSwapType##S*>(s),   \
+                                   static_cast<vtkByteSwapType##S*>(d), n); }   \
   bool vtkByteSwap::SwapWrite##S##LERange(const void* p, int n, FILE* f)        \
     { return vtkByteSwap::SwapLERangeWrite(static_cast<const vtkByteSwapType##S*>(p),  \
                                     n, f); }                                    \
@@ -305,6 +487,15 @@ VTK_BYTE_SWAP_SIZE(8)
 // assumes the word size is divisible by two.
 void vtkByteSwap::SwapVoidRange(void *buffer, int numWords, int wordSize)
 {
+  char* p = static_cast<char*>(buffer);
+  switch(wordSize)
+    {
+    case 1: return;
+    case 2: vtkByteSwapper<2>::SwapRange(p, p, numWords); return;
+    case 4: vtkByteSwapper<4>::SwapRange(p, p, numWords); return;
+    case 8: vtkByteSwapper<8>::SwapRange(p, p, numWords); return;
+    }
+
   unsigned char temp, *out, *buf;
   int idx1, idx2, inc, half;
   
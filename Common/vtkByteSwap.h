@@ -16,7 +16,8 @@
 // .SECTION Description
 // vtkByteSwap is used by other classes to perform machine dependent byte
 // swapping. Byte swapping is often used when reading or writing binary 
-// files.
+// files.  Ranges are swapped with SSE2 or AVX2 instructions when the
+// compiler targets them.
 #ifndef __vtkByteSwap_h
 #define __vtkByteSwap_h
 
@@ -38,6 +39,8 @@ public:
   static void SwapBE(T* p);                                                     \
   static void SwapLERange(T* p, vtkIdType num);                                 \
   static void SwapBERange(T* p, vtkIdType num);                                 \
+  static void SwapLERangeCopy(const T* src, T* dst, vtkIdType num);             \
+  static void SwapBERangeCopy(const T* src, T* dst, vtkIdType num);             \
   static bool SwapLERangeWrite(const T* p, vtkIdType num, FILE* file);          \
   static bool SwapBERangeWrite(const T* p, vtkIdType num, FILE* file);          \
   static void SwapLERangeWrite(const T* p, vtkIdType num, ostream* os);         \
@@ -76,6 +79,15 @@ public:
   static void Swap4LERange(void* p, int num);
   static void Swap8LERange(void* p, int num);
 
+  // Description:
+  // Copy a block of 2-, 4-, or 8-byte segments from src to dst, swapping
+  // them for storage as Little Endian on the way.  This saves a second
+  // pass over the data when it is moved out of an I/O buffer.  src and
+  // dst may be the same but must not otherwise overlap.
+  static void Swap2LERangeCopy(const void* src, void* dst, vtkIdType num);
+  static void Swap4LERangeCopy(const void* src, void* dst, vtkIdType num);
+  static void Swap8LERangeCopy(const void* src, void* dst, vtkIdType num);
+
   // Description:
   // Swap a block of 2-, 4-, or 8-byte segments for storage as Little Endian.
   // The results are written directly to a file to avoid temporary storage.
@@ -98,6 +110,14 @@ public:
   static void Swap4BERange(void* p, int num);
   static void Swap8BERange(void* p, int num);
 
+  // Description:
+  // Copy a block of 2-, 4-, or 8-byte segments from src to dst, swapping
+  // them for storage as Big Endian on the way.  src and dst may be the
+  // same but must not otherwise overlap.
+  static void Swap2BERangeCopy(const void* src, void* dst, vtkIdType num);
+  static void Swap4BERangeCopy(const void* src, void* dst, vtkIdType num);
+  static void Swap8BERangeCopy(const void* src, void* dst, vtkIdType num);
+
   // Description:
   // Swap a block of 2-, 4-, or 8-byte segments for storage as Big Endian.
   // The results are written directly to a file to avoid temporary storage.
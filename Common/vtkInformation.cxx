@@ -76,12 +76,11 @@ void vtkInformation::PrintSelf(ostream& os, vtkIndent indent)
 //----------------------------------------------------------------------------
 void vtkInformation::PrintKeys(ostream& os, vtkIndent indent)
 {
-  typedef vtkInformationInternals::MapType MapType;
-  for(MapType::const_iterator i = this->Internal->Map.begin();
-      i != this->Internal->Map.end(); ++i)
+  for(int i = this->Internal->NextEntry(0); i < this->Internal->NumberOfSlots;
+      i = this->Internal->NextEntry(i+1))
     {
     // Print the key name first.
-    vtkInformationKey* key = i->first;
+    vtkInformationKey* key = this->Internal->GetSlot(i)->Key;
     os << indent << key->GetName() << ": ";
 
     // Ask the key to print its value.
@@ -132,26 +131,27 @@ void vtkInformation::SetAsObjectBase(vtkInformationKey* key,
     {
     return;
     }
-  typedef vtkInformationInternals::MapType MapType;
-  MapType::iterator i = this->Internal->Map.find(key);
-  if(i != this->Internal->Map.end())
+  typedef vtkInformationInternals::Entry Entry;
+  if(Entry* e = this->Internal->Find(key))
     {
-    vtkObjectBase* oldvalue = i->second;
+    vtkObjectBase* oldvalue = e->Value;
     if(newvalue)
       {
-      i->second = newvalue;
+      e->Value = newvalue;
       newvalue->Register(0);
       }
     else
       {
-      this->Internal->Map.erase(i);
+      this->Internal->Erase(e);
+      }
+    if(oldvalue)
+      {
+      oldvalue->UnRegister(0);
       }
-    oldvalue->UnRegister(0);
     }
   else if(newvalue)
     {
-    MapType::value_type entry(key, newvalue);
-    this->Internal->Map.insert(entry);
+    this->Internal->Insert(key)->Value = newvalue;
     newvalue->Register(0);
     }
   this->Modified(key);
@@ -162,11 +162,97 @@ vtkObjectBase* vtkInformation::GetAsObjectBase(vtkInformationKey* key)
 {
   if(key)
     {
-    typedef vtkInformationInternals::MapType MapType;
-    MapType::const_iterator i = this->Internal->Map.find(key);
-    if(i != this->Internal->Map.end())
+    if(vtkInformationInternals::Entry* e = this->Internal->Find(key))
+      {
+      return e->Value;
+      }
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkInformation::SetAsInteger(vtkInformationKey* key, int value)
+{
+  if(!key)
+    {
+    return;
+    }
+  typedef vtkInformationInternals::Entry Entry;
+  Entry* e = this->Internal->Find(key);
+  if(e && !e->Value)
+    {
+    if(e->Integer == value)
+      {
+      return;
+      }
+    }
+  else if(e)
+    {
+    vtkObjectBase* oldvalue = e->Value;
+    e->Value = 0;
+    oldvalue->UnRegister(0);
+    }
+  else
+    {
+    e = this->Internal->Insert(key);
+    }
+  e->Integer = value;
+  this->Modified(key);
+}
+
+//----------------------------------------------------------------------------
+int* vtkInformation::GetAsInteger(vtkInformationKey* key)
+{
+  if(key)
+    {
+    vtkInformationInternals::Entry* e = this->Internal->Find(key);
+    if(e && !e->Value)
+      {
+      return &e->Integer;
+      }
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkInformation::SetAsDouble(vtkInformationKey* key, double value)
+{
+  if(!key)
+    {
+    return;
+    }
+  typedef vtkInformationInternals::Entry Entry;
+  Entry* e = this->Internal->Find(key);
+  if(e && !e->Value)
+    {
+    if(e->Double == value)
+      {
+      return;
+      }
+    }
+  else if(e)
+    {
+    vtkObjectBase* oldvalue = e->Value;
+    e->Value = 0;
+    oldvalue->UnRegister(0);
+    }
+  else
+    {
+    e = this->Internal->Insert(key);
+    }
+  e->Double = value;
+  this->Modified(key);
+}
+
+//----------------------------------------------------------------------------
+double* vtkInformation::GetAsDouble(vtkInformationKey* key)
+{
+  if(key)
+    {
+    vtkInformationInternals::Entry* e = this->Internal->Find(key);
+    if(e && !e->Value)
       {
-      return i->second;
+      return &e->Double;
       }
     }
   return 0;
@@ -185,11 +271,11 @@ void vtkInformation::Copy(vtkInformation* from, int deep)
   this->Internal = new vtkInformationInternals;
   if(from)
     {
-    typedef vtkInformationInternals::MapType MapType;
-    for(MapType::const_iterator i = from->Internal->Map.begin();
-        i != from->Internal->Map.end(); ++i)
+    vtkInformationInternals* fromInternal = from->Internal;
+    for(int i = fromInternal->NextEntry(0); i < fromInternal->NumberOfSlots;
+        i = fromInternal->NextEntry(i+1))
       {
-      this->CopyEntry(from, i->first, deep);
+      this->CopyEntry(from, fromInternal->GetSlot(i)->Key, deep);
       }
     }
   delete oldInternal;
@@ -805,11 +891,10 @@ void vtkInformation::ReportReferences(vtkGarbageCollector* collector)
 {
   this->Superclass::ReportReferences(collector);
   // Ask each key/value pair to report any references it holds.
-  typedef vtkInformationInternals::MapType MapType;
-  for(MapType::const_iterator i = this->Internal->Map.begin();
-      i != this->Internal->Map.end(); ++i)
+  for(int i = this->Internal->NextEntry(0); i < this->Internal->NumberOfSlots;
+      i = this->Internal->NextEntry(i+1))
     {
-    i->first->Report(this, collector);
+    this->Internal->GetSlot(i)->Key->Report(this, collector);
     }
 }
 
@@ -819,11 +904,10 @@ void vtkInformation::ReportAsObjectBase(vtkInformationKey* key,
 {
   if(key)
     {
-    typedef vtkInformationInternals::MapType MapType;
-    MapType::iterator i = this->Internal->Map.find(key);
-    if(i != this->Internal->Map.end())
+    vtkInformationInternals::Entry* e = this->Internal->Find(key);
+    if(e && e->Value)
       {
-      vtkGarbageCollectorReport(collector, i->second, key->GetName());
+      vtkGarbageCollectorReport(collector, e->Value, key->GetName());
       }
     }
 }
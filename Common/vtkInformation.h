@@ -462,6 +462,15 @@ protected:
   VTK_COMMON_EXPORT void SetAsObjectBase(vtkInformationKey* key, vtkObjectBase* value);
   VTK_COMMON_EXPORT vtkObjectBase* GetAsObjectBase(vtkInformationKey* key);
 
+  // Get/Set an integer or double entry held by the map itself instead of
+  // a vtkObjectBase instance.  The Get methods return the address of the
+  // value, or NULL if the key has no such entry.  The address is valid
+  // until the entry is removed or its key is given an object value.
+  VTK_COMMON_EXPORT void SetAsInteger(vtkInformationKey* key, int value);
+  VTK_COMMON_EXPORT int* GetAsInteger(vtkInformationKey* key);
+  VTK_COMMON_EXPORT void SetAsDouble(vtkInformationKey* key, double value);
+  VTK_COMMON_EXPORT double* GetAsDouble(vtkInformationKey* key);
+
   // Internal implementation details.
   vtkInformationInternals* Internal;
 
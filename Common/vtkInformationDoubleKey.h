@@ -39,6 +39,10 @@ public:
   void Set(vtkInformation* info, double);
   double Get(vtkInformation* info);
 
+  // Description:
+  // Check whether this key appears in the given information object.
+  virtual int Has(vtkInformation* info);
+
   // Description:
   // Copy the entry associated with this key from one information
   // object to another.  If there is no entry in the first information
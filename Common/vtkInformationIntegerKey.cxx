@@ -36,48 +36,23 @@ void vtkInformationIntegerKey::PrintSelf(ostream& os, vtkIndent indent)
 }
 
 //----------------------------------------------------------------------------
-class vtkInformationIntegerValue: public vtkObjectBase
+void vtkInformationIntegerKey::Set(vtkInformation* info, int value)
 {
-public:
-  vtkTypeMacro(vtkInformationIntegerValue, vtkObjectBase);
-  int Value;
-};
+  // The value is held by the information object itself.
+  this->SetAsInteger(info, value);
+}
 
 //----------------------------------------------------------------------------
-void vtkInformationIntegerKey::Set(vtkInformation* info, int value)
+int vtkInformationIntegerKey::Get(vtkInformation* info)
 {
-  if(vtkInformationIntegerValue* oldv =
-     static_cast<vtkInformationIntegerValue *>
-     (this->GetAsObjectBase(info)))
-    {
-    if (oldv->Value != value)
-      {
-      // Replace the existing value.
-      oldv->Value = value;
-      // Since this sets a value without call SetAsObjectBase(),
-      // the info has to be modified here (instead of 
-      // vtkInformation::SetAsObjectBase()
-      info->Modified(this);
-      }
-   }
-  else
-    {
-    // Allocate a new value.
-    vtkInformationIntegerValue* v = new vtkInformationIntegerValue;
-    this->ConstructClass("vtkInformationIntegerValue");
-    v->Value = value;
-    this->SetAsObjectBase(info, v);
-    v->Delete();
-    }
+  int* v = this->GetAsInteger(info);
+  return v?*v:0;
 }
 
 //----------------------------------------------------------------------------
-int vtkInformationIntegerKey::Get(vtkInformation* info)
+int vtkInformationIntegerKey::Has(vtkInformation* info)
 {
-  vtkInformationIntegerValue* v =
-    static_cast<vtkInformationIntegerValue *>
-    (this->GetAsObjectBase(info));
-  return v?v->Value:0;
+  return this->GetAsInteger(info)?1:0;
 }
 
 //----------------------------------------------------------------------------
@@ -106,11 +81,5 @@ void vtkInformationIntegerKey::Print(ostream& os, vtkInformation* info)
 //----------------------------------------------------------------------------
 int* vtkInformationIntegerKey::GetWatchAddress(vtkInformation* info)
 {
-  if(vtkInformationIntegerValue* v =
-     static_cast<vtkInformationIntegerValue *>
-     (this->GetAsObjectBase(info)))
-    {
-    return &v->Value;
-    }
-  return 0;
+  return this->GetAsInteger(info);
 }
@@ -24,12 +24,8 @@
 #include "vtkInformationKey.h"
 #include "vtkObjectBase.h"
 
-#define VTK_INFORMATION_USE_HASH_MAP
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-# include <vtksys/hash_map.hxx>
-#else
-# include <vtksys/stl/map>
-#endif
+#include <vtksys/hash_map.hxx>
+#include <vtkstd/vector>
 
 //----------------------------------------------------------------------------
 class vtkInformationInternals
@@ -37,7 +33,29 @@ class vtkInformationInternals
 public:
   typedef vtkInformationKey* KeyType;
   typedef vtkObjectBase* DataType;
-#ifdef VTK_INFORMATION_USE_HASH_MAP
+
+  // An entry references the vtkObjectBase instance holding its value,
+  // or holds an integer or double itself and has no Value.
+  struct Entry
+  {
+    KeyType Key;
+    DataType Value;
+    union
+    {
+      int Integer;
+      double Double;
+    };
+  };
+
+  // The entries are stored in blocks of BlockSize that never move, so
+  // the address of an integer or double held by an entry (see
+  // GetWatchAddress) stays valid until the entry is removed.  The first
+  // block is part of this object and is searched linearly, which is all
+  // most information objects need.  Once there are more blocks, a hash
+  // map indexes the entries.  Removing an entry leaves a slot with a null
+  // key that the next insertion reuses.
+  enum { BlockSize = 16 };
+
   struct HashFun
   {
     size_t operator()(KeyType key) const
@@ -45,28 +63,121 @@ public:
       return static_cast<size_t>(key - KeyType(0));
       }
   };
-  typedef vtksys::hash_map<KeyType, DataType, HashFun> MapType;
-#else
-  typedef vtksys_stl::map<KeyType, DataType> MapType;
-#endif
-  MapType Map;
+  typedef vtksys::hash_map<KeyType, Entry*, HashFun> IndexType;
 
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-  vtkInformationInternals(): Map(33) {}
-#endif
+  Entry Small[BlockSize];
+  vtkstd::vector<Entry*> Blocks;
+  vtkstd::vector<Entry*> FreeSlots;
+  int NumberOfSlots;
+  IndexType* Index;
+
+  vtkInformationInternals(): NumberOfSlots(0), Index(0) {}
 
   ~vtkInformationInternals()
     {
-    for(MapType::iterator i = this->Map.begin(); i != this->Map.end(); ++i)
+    for(int i = 0; i < this->NumberOfSlots; ++i)
       {
-      if(vtkObjectBase* value = i->second)
+      Entry* e = this->GetSlot(i);
+      if(e->Key && e->Value)
         {
-        value->UnRegister(0);
+        e->Value->UnRegister(0);
         }
       }
+    for(size_t b = 0; b < this->Blocks.size(); ++b)
+      {
+      delete [] this->Blocks[b];
+      }
+    delete this->Index;
+    }
+
+  // Return slot i, which holds an entry if its key is not null.
+  Entry* GetSlot(int i)
+    {
+    return i < BlockSize? this->Small + i :
+      this->Blocks[i/BlockSize - 1] + i%BlockSize;
+    }
+
+  // Return the first slot from i on that holds an entry, or
+  // NumberOfSlots if there is none.
+  int NextEntry(int i)
+    {
+    while(i < this->NumberOfSlots && !this->GetSlot(i)->Key)
+      {
+      ++i;
+      }
+    return i;
     }
-};
 
-#undef VTK_INFORMATION_USE_HASH_MAP
+  // Return the entry of the key, or 0 if there is none.
+  Entry* Find(KeyType key)
+    {
+    if(this->Index)
+      {
+      IndexType::const_iterator i = this->Index->find(key);
+      return i != this->Index->end()? i->second : 0;
+      }
+    for(Entry* e = this->Small; e != this->Small+this->NumberOfSlots; ++e)
+      {
+      if(e->Key == key)
+        {
+        return e;
+        }
+      }
+    return 0;
+    }
+
+  // Add an entry without a value for a key that has none.
+  Entry* Insert(KeyType key)
+    {
+    Entry* e;
+    if(!this->FreeSlots.empty())
+      {
+      e = this->FreeSlots.back();
+      this->FreeSlots.pop_back();
+      }
+    else
+      {
+      if(this->NumberOfSlots ==
+         BlockSize*static_cast<int>(this->Blocks.size() + 1))
+        {
+        this->Blocks.push_back(new Entry[BlockSize]);
+        if(!this->Index)
+          {
+          // The first block is full, index its entries.
+          this->Index = new IndexType;
+          for(int i = 0; i < BlockSize; ++i)
+            {
+            (*this->Index)[this->Small[i].Key] = this->Small + i;
+            }
+          }
+        }
+      e = this->GetSlot(this->NumberOfSlots++);
+      }
+    e->Key = key;
+    e->Value = 0;
+    e->Double = 0.0;
+    if(this->Index)
+      {
+      (*this->Index)[key] = e;
+      }
+    return e;
+    }
+
+  // Remove an entry.  The caller releases the value.
+  void Erase(Entry* e)
+    {
+    if(this->Index)
+      {
+      this->Index->erase(e->Key);
+      }
+    e->Key = 0;
+    e->Value = 0;
+    this->FreeSlots.push_back(e);
+    }
+
+private:
+  vtkInformationInternals(const vtkInformationInternals&);  // Not implemented.
+  void operator=(const vtkInformationInternals&);  // Not implemented.
+};
 
 #endif
@@ -24,7 +24,8 @@ vtkStandardNewMacro(vtkInformationIterator);
 class vtkInformationIteratorInternals
 {
 public:
-  vtkInformationInternals::MapType::iterator Iterator;
+  int Index;
+  vtkInformationIteratorInternals(): Index(0) {}
 };
 
 //----------------------------------------------------------------------------
@@ -86,7 +87,7 @@ void vtkInformationIterator::GoToFirstItem()
     vtkErrorMacro("No information has been set.");
     return;
     }
-  this->Internal->Iterator = this->Information->Internal->Map.begin();
+  this->Internal->Index = this->Information->Internal->NextEntry(0);
 }
 
 //----------------------------------------------------------------------------
@@ -98,7 +99,8 @@ void vtkInformationIterator::GoToNextItem()
     return;
     }
 
-  ++this->Internal->Iterator;
+  this->Internal->Index =
+    this->Information->Internal->NextEntry(this->Internal->Index + 1);
 }
 
 //----------------------------------------------------------------------------
@@ -110,7 +112,7 @@ int vtkInformationIterator::IsDoneWithTraversal()
     return 1;
     }
 
-  if(this->Internal->Iterator == this->Information->Internal->Map.end())
+  if(this->Internal->Index >= this->Information->Internal->NumberOfSlots)
     {
     return 1;
     }
@@ -125,7 +127,7 @@ vtkInformationKey* vtkInformationIterator::GetCurrentKey()
     return 0;
     }
 
-  return this->Internal->Iterator->first;
+  return this->Information->Internal->GetSlot(this->Internal->Index)->Key;
 }
 
 //----------------------------------------------------------------------------
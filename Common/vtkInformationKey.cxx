@@ -31,6 +31,24 @@ public:
     {
     return info->GetAsObjectBase(key);
     }
+  static void SetAsInteger(vtkInformation* info, vtkInformationKey* key,
+                           int value)
+    {
+    info->SetAsInteger(key, value);
+    }
+  static int* GetAsInteger(vtkInformation* info, vtkInformationKey* key)
+    {
+    return info->GetAsInteger(key);
+    }
+  static void SetAsDouble(vtkInformation* info, vtkInformationKey* key,
+                          double value)
+    {
+    info->SetAsDouble(key, value);
+    }
+  static double* GetAsDouble(vtkInformation* info, vtkInformationKey* key)
+    {
+    return info->GetAsDouble(key);
+    }
   static void ReportAsObjectBase(vtkInformation* info, vtkInformationKey* key,
                                  vtkGarbageCollector* collector)
     {
@@ -93,6 +111,30 @@ vtkObjectBase* vtkInformationKey::GetAsObjectBase(vtkInformation* info)
   return vtkInformationKeyToInformationFriendship::GetAsObjectBase(info, this);
 }
 
+//----------------------------------------------------------------------------
+void vtkInformationKey::SetAsInteger(vtkInformation* info, int value)
+{
+  vtkInformationKeyToInformationFriendship::SetAsInteger(info, this, value);
+}
+
+//----------------------------------------------------------------------------
+int* vtkInformationKey::GetAsInteger(vtkInformation* info)
+{
+  return vtkInformationKeyToInformationFriendship::GetAsInteger(info, this);
+}
+
+//----------------------------------------------------------------------------
+void vtkInformationKey::SetAsDouble(vtkInformation* info, double value)
+{
+  vtkInformationKeyToInformationFriendship::SetAsDouble(info, this, value);
+}
+
+//----------------------------------------------------------------------------
+double* vtkInformationKey::GetAsDouble(vtkInformation* info)
+{
+  return vtkInformationKeyToInformationFriendship::GetAsDouble(info, this);
+}
+
 //----------------------------------------------------------------------------
 int vtkInformationKey::Has(vtkInformation* info)
 {
@@ -104,6 +104,13 @@ protected:
   void SetAsObjectBase(vtkInformation* info, vtkObjectBase* value);
   vtkObjectBase* GetAsObjectBase(vtkInformation* info);
 
+  // Set/Get an integer or double value held by the given information
+  // object itself.  The Get methods return NULL if there is none.
+  void SetAsInteger(vtkInformation* info, int value);
+  int* GetAsInteger(vtkInformation* info);
+  void SetAsDouble(vtkInformation* info, double value);
+  double* GetAsDouble(vtkInformation* info);
+
   // Report the object associated with this key instance in the given
   // information object to the collector.
   void ReportAsObjectBase(vtkInformation* info,
@@ -16,6 +16,7 @@
 
 #include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
+#include "vtkThreadPool.h"
 #include "vtkWindows.h"
 
 vtkStandardNewMacro(vtkMultiThreader);
@@ -164,6 +165,7 @@ vtkMultiThreader::vtkMultiThreader()
   this->SingleMethod = NULL;
   this->NumberOfThreads = 
     vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->UseThreadPool = 0;
 
 }
 
@@ -227,6 +229,21 @@ void vtkMultiThreader::SetMultipleMethod( int index,
     }
 }
 
+// Arguments of the SingleMethod when it runs on the thread pool.
+struct vtkMultiThreaderPoolArgs
+{
+  vtkThreadFunctionType Method;
+  vtkMultiThreader::ThreadInfo *Info;
+};
+
+// Run one ThreadID of the SingleMethod on the thread pool.
+static void vtkMultiThreaderPoolExecute(void *arg, vtkIdType threadId,
+                                        int vtkNotUsed(slot))
+{
+  vtkMultiThreaderPoolArgs *args = static_cast<vtkMultiThreaderPoolArgs *>(arg);
+  args->Method((void *)(&args->Info[threadId]));
+}
+
 // Execute the method set as the SingleMethod on NumberOfThreads threads.
 void vtkMultiThreader::SingleMethodExecute()
 {
@@ -258,7 +275,23 @@ void vtkMultiThreader::SingleMethodExecute()
     {
     this->NumberOfThreads = vtkMultiThreaderGlobalMaximumNumberOfThreads;
     }
-  
+
+  // Hand the thread ids over to the persistent workers of the pool
+  if (this->UseThreadPool && this->NumberOfThreads > 1)
+    {
+    for (thread_loop = 0; thread_loop < this->NumberOfThreads; thread_loop++)
+      {
+      this->ThreadInfoArray[thread_loop].UserData        = this->SingleData;
+      this->ThreadInfoArray[thread_loop].NumberOfThreads = this->NumberOfThreads;
+      }
+    vtkMultiThreaderPoolArgs args;
+    args.Method = this->SingleMethod;
+    args.Info = this->ThreadInfoArray;
+    vtkThreadPool::GetInstance()->Execute(vtkMultiThreaderPoolExecute, &args,
+                                          this->NumberOfThreads,
+                                          this->NumberOfThreads);
+    return;
+    }
     
   // We are using sproc (on SGIs), pthreads(on Suns), or a single thread
   // (the default)  
@@ -413,6 +446,14 @@ void vtkMultiThreader::SingleMethodExecute()
 #endif
 }
 
+void vtkMultiThreader::PieceMethodExecute(vtkThreadPoolTaskFunctionType f,
+                                          void *data,
+                                          vtkIdType numberOfPieces)
+{
+  vtkThreadPool::GetInstance()->Execute(f, data, numberOfPieces,
+                                        this->GetNumberOfThreads());
+}
+
 void vtkMultiThreader::MultipleMethodExecute()
 {
   int                thread_loop;
@@ -827,6 +868,7 @@ void vtkMultiThreader::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent); 
 
   os << indent << "Thread Count: " << this->NumberOfThreads << "\n";
+  os << indent << "Use Thread Pool: " << this->UseThreadPool << "\n";
   os << indent << "Global Maximum Number Of Threads: " << 
     vtkMultiThreaderGlobalMaximumNumberOfThreads << endl;
   os << "Thread system used: " <<
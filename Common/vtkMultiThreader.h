@@ -18,11 +18,19 @@
 // execution using sproc() on an SGI, or pthread_create on any platform
 // supporting POSIX threads.  This class can be used to execute a single
 // method on multiple threads, or to specify a method per thread. 
+//
+// When UseThreadPool is on, SingleMethodExecute runs on the persistent
+// process-wide vtkThreadPool instead of creating and joining threads on
+// every call.  PieceMethodExecute always uses the pool and balances a
+// large number of small pieces over the threads.
+// .SECTION See Also
+// vtkThreadPool
 
 #ifndef __vtkMultiThreader_h
 #define __vtkMultiThreader_h
 
 #include "vtkObject.h"
+#include "vtkThreadPool.h" // Needed for vtkThreadPoolTaskFunctionType
 
 #ifdef VTK_USE_SPROC
 #include <sys/types.h> // Needed for unix implementation of sproc
@@ -138,6 +146,16 @@ public:
   static void SetGlobalDefaultNumberOfThreads(int val);
   static int  GetGlobalDefaultNumberOfThreads();
 
+  // Description:
+  // When on, SingleMethodExecute runs the single method on the workers of
+  // the process-wide vtkThreadPool instead of spawning new threads.  Each
+  // ThreadID is still executed exactly once, but no more threads than the
+  // pool holds run at the same time, so the single method must not wait
+  // for the other threads (with a barrier for example).  Off by default.
+  vtkSetMacro(UseThreadPool, int);
+  vtkGetMacro(UseThreadPool, int);
+  vtkBooleanMacro(UseThreadPool, int);
+
   // These methods are excluded from Tcl wrapping 1) because the
   // wrapper gives up on them and 2) because they really shouldn't be
   // called from a script anyway.
@@ -148,6 +166,15 @@ public:
   // this->NumberOfThreads threads.
   void SingleMethodExecute();
 
+  // Description:
+  // Call f(data, pieceId, threadId) for every pieceId in
+  // [0, numberOfPieces) on the process-wide vtkThreadPool, using at most
+  // this->NumberOfThreads threads.  Idle threads steal pieces from busy
+  // ones, so a threadId usually handles several pieces; it is only
+  // guaranteed not to be used by two pieces at the same time.
+  void PieceMethodExecute(vtkThreadPoolTaskFunctionType f, void *data,
+                          vtkIdType numberOfPieces);
+
   // Description:
   // Execute the MultipleMethods (as define by calling SetMultipleMethod
   // for each of the required this->NumberOfThreads methods) using
@@ -197,6 +224,9 @@ protected:
   // The number of threads to use
   int                        NumberOfThreads;
 
+  // Run SingleMethodExecute on the thread pool
+  int                        UseThreadPool;
+
   // An array of thread info containing a thread id
   // (0, 1, 2, .. VTK_MAX_THREADS-1), the thread count, and a pointer
   // to void so that user data can be passed to each thread
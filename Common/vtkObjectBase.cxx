@@ -17,6 +17,7 @@
 #include "vtkDebugLeaks.h"
 #include "vtkGarbageCollector.h"
 #include "vtkWeakPointerBase.h"
+#include "vtkWindows.h"
 
 #include <vtksys/ios/sstream>
 
@@ -245,7 +246,15 @@ void vtkObjectBase::RegisterInternal(vtkObjectBase*, int check)
   if(!(check &&
        vtkObjectBaseToGarbageCollectorFriendship::TakeReference(this)))
     {
+    // Algorithms executing at the same time may register the same data
+    // from several threads.
+#if defined(WIN32) || defined(_WIN32)
+    InterlockedIncrement(reinterpret_cast<LONG*>(&this->ReferenceCount));
+#elif defined(VTK_HAVE_SYNC_BUILTINS)
+    __sync_add_and_fetch(&this->ReferenceCount, 1);
+#else
     ++this->ReferenceCount;
+#endif
     }
 }
 
@@ -253,15 +262,36 @@ void vtkObjectBase::RegisterInternal(vtkObjectBase*, int check)
 void vtkObjectBase::UnRegisterInternal(vtkObjectBase*, int check)
 {
   // If the garbage collector accepts a reference, do not decrement
-  // the count.
-  if(check && this->ReferenceCount > 1 &&
-     vtkObjectBaseToGarbageCollectorFriendship::GiveReference(this))
+  // the count.  The count may change on other threads once it is read,
+  // so it only tells whether offering the reference is worth it, but it
+  // is read atomically like it is updated.
+  if(check)
     {
-    return;
+#if defined(WIN32) || defined(_WIN32)
+    int current = InterlockedCompareExchange(
+      reinterpret_cast<LONG*>(&this->ReferenceCount), 0, 0);
+#elif defined(VTK_HAVE_SYNC_BUILTINS)
+    int current = __sync_add_and_fetch(&this->ReferenceCount, 0);
+#else
+    int current = this->ReferenceCount;
+#endif
+    if(current > 1 &&
+       vtkObjectBaseToGarbageCollectorFriendship::GiveReference(this))
+      {
+      return;
+      }
     }
 
   // Decrement the reference count, delete object if count goes to zero.
-  if(--this->ReferenceCount <= 0)
+#if defined(WIN32) || defined(_WIN32)
+  int count =
+    InterlockedDecrement(reinterpret_cast<LONG*>(&this->ReferenceCount));
+#elif defined(VTK_HAVE_SYNC_BUILTINS)
+  int count = __sync_sub_and_fetch(&this->ReferenceCount, 1);
+#else
+  int count = --this->ReferenceCount;
+#endif
+  if(count <= 0)
     {
     // Clear all weak pointers to the object before deleting it.
     if (this->WeakPointers)
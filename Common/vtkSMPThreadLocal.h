@@ -0,0 +1,143 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPThreadLocal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSMPThreadLocal - one copy of an object per thread
+// .SECTION Description
+// vtkSMPThreadLocal gives every thread that calls Local() its own copy of
+// an object, created on first use as a copy of the exemplar passed to the
+// constructor.  It is meant to hold the partial results of a
+// vtkSMPTools::For loop, which are then combined by iterating over all
+// the copies once the loop is done:
+//
+// \code
+// vtkSMPThreadLocal<double> sum(0.0);
+// ... in the functor: sum.Local() += value;
+// double total = 0.0;
+// for (vtkSMPThreadLocal<double>::iterator it = sum.begin();
+//      it != sum.end(); ++it)
+//   {
+//   total += *it;
+//   }
+// \endcode
+//
+// Local() takes a lock to find the calling thread's copy, so call it once
+// per range rather than once per element.  The copies live until the
+// vtkSMPThreadLocal is destroyed and are never shared between threads.
+// .SECTION See Also
+// vtkSMPTools
+
+#ifndef __vtkSMPThreadLocal_h
+#define __vtkSMPThreadLocal_h
+
+#include "vtkMultiThreader.h" // For vtkMultiThreaderIDType
+#include "vtkMutexLock.h" // For vtkSimpleMutexLock
+
+#include <vtkstd/vector> // For the per-thread storage
+
+template <typename T>
+class vtkSMPThreadLocal
+{
+public:
+  // Description:
+  // Construct with a default-constructed exemplar.
+  vtkSMPThreadLocal() : Exemplar() {}
+
+  // Description:
+  // Every thread's copy starts out as a copy of exemplar.
+  explicit vtkSMPThreadLocal(const T& exemplar) : Exemplar(exemplar) {}
+
+  ~vtkSMPThreadLocal()
+    {
+    for (size_t i = 0; i < this->Values.size(); ++i)
+      {
+      delete this->Values[i];
+      }
+    }
+
+  // Description:
+  // Return the copy that belongs to the calling thread, creating it the
+  // first time the thread asks for it.
+  T& Local()
+    {
+    vtkMultiThreaderIDType self = vtkMultiThreader::GetCurrentThreadID();
+    this->Lock.Lock();
+    T *value = 0;
+    for (size_t i = 0; i < this->Ids.size(); ++i)
+      {
+      if (vtkMultiThreader::ThreadsEqual(this->Ids[i], self))
+        {
+        value = this->Values[i];
+        break;
+        }
+      }
+    if (!value)
+      {
+      value = new T(this->Exemplar);
+      this->Ids.push_back(self);
+      this->Values.push_back(value);
+      }
+    this->Lock.Unlock();
+    return *value;
+    }
+
+  // Description:
+  // Number of threads that have created a copy so far.
+  size_t size() const
+    {
+    return this->Values.size();
+    }
+
+  // Description:
+  // Iterate over the copies of all threads.  Must not be used while
+  // other threads may still call Local().
+  class iterator
+  {
+  public:
+    iterator() : Position() {}
+    T& operator*() { return **this->Position; }
+    T* operator->() { return *this->Position; }
+    iterator& operator++() { ++this->Position; return *this; }
+    bool operator==(const iterator& other) const
+      { return this->Position == other.Position; }
+    bool operator!=(const iterator& other) const
+      { return this->Position != other.Position; }
+  private:
+    friend class vtkSMPThreadLocal<T>;
+    typename vtkstd::vector<T*>::iterator Position;
+  };
+
+  iterator begin()
+    {
+    iterator it;
+    it.Position = this->Values.begin();
+    return it;
+    }
+  iterator end()
+    {
+    iterator it;
+    it.Position = this->Values.end();
+    return it;
+    }
+
+private:
+  vtkSMPThreadLocal(const vtkSMPThreadLocal&);  // Not implemented.
+  void operator=(const vtkSMPThreadLocal&);  // Not implemented.
+
+  T Exemplar;
+  vtkSimpleMutexLock Lock;
+  vtkstd::vector<vtkMultiThreaderIDType> Ids;
+  vtkstd::vector<T*> Values;
+};
+
+#endif
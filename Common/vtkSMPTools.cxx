@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSMPTools.h"
+
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkThreadPool.h"
+
+static int vtkSMPToolsBackend = vtkSMPTools::THREAD_POOL;
+static int vtkSMPToolsNumberOfThreads = 0;
+
+//----------------------------------------------------------------------------
+// One loop: the range is cut into NumberOfChunks chunks of Grain ids.
+struct vtkSMPToolsLoop
+{
+  vtkSMPTools::RangeFunctionType Function;
+  void *Functor;
+  vtkIdType First;
+  vtkIdType Last;
+  vtkIdType Grain;
+  vtkIdType NumberOfChunks;
+
+  // Used by the MULTI_THREADER backend to hand out chunks.
+  vtkSimpleMutexLock Lock;
+  vtkIdType NextChunk;
+
+  void ExecuteChunk(vtkIdType chunk)
+    {
+    vtkIdType begin = this->First + chunk * this->Grain;
+    vtkIdType end = begin + this->Grain;
+    if (end > this->Last)
+      {
+      end = this->Last;
+      }
+    this->Function(this->Functor, begin, end);
+    }
+};
+
+//----------------------------------------------------------------------------
+static void vtkSMPToolsPoolTask(void *arg, vtkIdType chunk, int)
+{
+  static_cast<vtkSMPToolsLoop *>(arg)->ExecuteChunk(chunk);
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkSMPToolsThreaderMethod(void *arg)
+{
+  vtkSMPToolsLoop *loop = static_cast<vtkSMPToolsLoop *>(
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+  for (;;)
+    {
+    loop->Lock.Lock();
+    vtkIdType chunk = loop->NextChunk++;
+    loop->Lock.Unlock();
+    if (chunk >= loop->NumberOfChunks)
+      {
+      break;
+      }
+    loop->ExecuteChunk(chunk);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMPTools::SetBackend(int backend)
+{
+  if (backend < vtkSMPTools::SEQUENTIAL)
+    {
+    backend = vtkSMPTools::SEQUENTIAL;
+    }
+  if (backend > vtkSMPTools::THREAD_POOL)
+    {
+    backend = vtkSMPTools::THREAD_POOL;
+    }
+  vtkSMPToolsBackend = backend;
+}
+
+//----------------------------------------------------------------------------
+int vtkSMPTools::GetBackend()
+{
+  return vtkSMPToolsBackend;
+}
+
+//----------------------------------------------------------------------------
+const char *vtkSMPTools::GetBackendAsString()
+{
+  switch (vtkSMPToolsBackend)
+    {
+    case vtkSMPTools::SEQUENTIAL:
+      return "Sequential";
+    case vtkSMPTools::MULTI_THREADER:
+      return "MultiThreader";
+    default:
+      return "ThreadPool";
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMPTools::SetNumberOfThreads(int num)
+{
+  vtkSMPToolsNumberOfThreads = (num < 0 ? 0 : num);
+}
+
+//----------------------------------------------------------------------------
+int vtkSMPTools::GetNumberOfThreads()
+{
+  if (vtkSMPToolsNumberOfThreads > 0)
+    {
+    return vtkSMPToolsNumberOfThreads;
+    }
+  return vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+}
+
+//----------------------------------------------------------------------------
+void vtkSMPTools::Initialize(int num)
+{
+  vtkSMPTools::SetNumberOfThreads(num);
+  if (num > VTK_MAX_THREADS)
+    {
+    num = VTK_MAX_THREADS;
+    }
+  vtkThreadPool *pool = vtkThreadPool::GetInstance();
+  if (pool->GetNumberOfWorkers() < num - 1)
+    {
+    pool->SetNumberOfWorkers(num - 1);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMPTools::ForRange(vtkIdType first, vtkIdType last, vtkIdType grain,
+                           RangeFunctionType f, void *functor)
+{
+  vtkIdType n = last - first;
+  if (n <= 0)
+    {
+    return;
+    }
+
+  int numThreads = vtkSMPTools::GetNumberOfThreads();
+  if (numThreads > VTK_MAX_THREADS)
+    {
+    numThreads = VTK_MAX_THREADS;
+    }
+  if (grain <= 0)
+    {
+    // A few chunks per thread so that uneven chunks balance out.
+    grain = n / (numThreads * 4);
+    if (grain < 1)
+      {
+      grain = 1;
+      }
+    }
+
+  if (vtkSMPToolsBackend == vtkSMPTools::SEQUENTIAL || numThreads <= 1 ||
+      grain >= n)
+    {
+    f(functor, first, last);
+    return;
+    }
+
+  vtkSMPToolsLoop loop;
+  loop.Function = f;
+  loop.Functor = functor;
+  loop.First = first;
+  loop.Last = last;
+  loop.Grain = grain;
+  loop.NumberOfChunks = (n + grain - 1) / grain;
+  loop.NextChunk = 0;
+
+  if (vtkSMPToolsBackend == vtkSMPTools::MULTI_THREADER)
+    {
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->UseThreadPoolOff();
+    threader->SetNumberOfThreads(
+      loop.NumberOfChunks < numThreads ?
+      static_cast<int>(loop.NumberOfChunks) : numThreads);
+    threader->SetSingleMethod(vtkSMPToolsThreaderMethod, &loop);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+  else
+    {
+    vtkThreadPool::GetInstance()->Execute(
+      vtkSMPToolsPoolTask, &loop, loop.NumberOfChunks, numThreads);
+    }
+}
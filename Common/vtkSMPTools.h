@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSMPTools - parallel for and parallel reduce over id ranges
+// .SECTION Description
+// vtkSMPTools runs loops over a range of ids [first, last) on several
+// threads.  The range is cut into chunks of at most grain ids and every
+// chunk is handed to a functor as functor(begin, end):
+//
+// \code
+// class ScaleFunctor
+// {
+// public:
+//   float *Data;
+//   void operator()(vtkIdType begin, vtkIdType end)
+//     {
+//     for (vtkIdType i = begin; i < end; ++i) { this->Data[i] *= 2; }
+//     }
+// };
+// ScaleFunctor f; f.Data = array->GetPointer(0);
+// vtkSMPTools::For(0, array->GetNumberOfTuples(), f);
+// \endcode
+//
+// Chunks run concurrently, so the functor may only write to disjoint
+// locations.  Per-thread partial results go into a vtkSMPThreadLocal.
+// Reduce() additionally calls functor.Initialize() once in every thread
+// before that thread's first chunk and functor.Reduce() on the calling
+// thread after the last chunk, which is where the partial results are
+// combined.
+//
+// Which threads execute the chunks is selected with SetBackend():
+// SEQUENTIAL runs the whole range on the calling thread, MULTI_THREADER
+// spawns threads with vtkMultiThreader for every loop and THREAD_POOL
+// (the default) hands the chunks to the persistent vtkThreadPool.
+// .SECTION See Also
+// vtkSMPThreadLocal vtkThreadPool vtkMultiThreader
+
+#ifndef __vtkSMPTools_h
+#define __vtkSMPTools_h
+
+#include "vtkSystemIncludes.h"
+#include "vtkSMPThreadLocal.h" // For the reduce implementation
+
+class VTK_COMMON_EXPORT vtkSMPTools
+{
+public:
+  enum BackendType
+  {
+    SEQUENTIAL = 0,
+    MULTI_THREADER,
+    THREAD_POOL
+  };
+
+  // Description:
+  // Select the backend used by all subsequent loops.
+  static void SetBackend(int backend);
+  static int GetBackend();
+  static const char *GetBackendAsString();
+
+  // Description:
+  // Maximum number of threads a loop uses.  Zero (the default) means
+  // vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  static void SetNumberOfThreads(int num);
+  static int GetNumberOfThreads();
+
+  // Description:
+  // Use num threads for all subsequent loops, even on machines with fewer
+  // cores.  Unlike SetNumberOfThreads(), this also grows the process-wide
+  // vtkThreadPool to at least num - 1 workers, which is what tests need to
+  // exercise concurrent code on a single core machine.  Must not be
+  // called while a loop is running.
+  static void Initialize(int num);
+
+  // Description:
+  // Signature of the type-erased range function used by ForRange.
+  typedef void (*RangeFunctionType)(void *functor, vtkIdType begin,
+                                    vtkIdType end);
+
+  // Description:
+  // Call f(functor, begin, end) over chunks of [first, last).  A grain of
+  // zero or less picks a chunk size that gives every thread a few chunks
+  // to balance the load.  Most code should use For() or Reduce() instead.
+  static void ForRange(vtkIdType first, vtkIdType last, vtkIdType grain,
+                       RangeFunctionType f, void *functor);
+
+  // Description:
+  // Parallel for: call functor(begin, end) over chunks of [first, last).
+  template <typename Functor>
+  static void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+                  Functor& functor)
+    {
+    vtkSMPTools::ForRange(first, last, grain,
+                          &vtkSMPTools::ExecuteFunctor<Functor>, &functor);
+    }
+  template <typename Functor>
+  static void For(vtkIdType first, vtkIdType last, Functor& functor)
+    {
+    vtkSMPTools::For(first, last, 0, functor);
+    }
+
+  // Description:
+  // Parallel reduce: like For(), but calls functor.Initialize() once in
+  // every participating thread before its first chunk and
+  // functor.Reduce() once on the calling thread at the end.
+  template <typename Functor>
+  static void Reduce(vtkIdType first, vtkIdType last, vtkIdType grain,
+                     Functor& functor)
+    {
+    InitializingFunctor<Functor> initializing(functor);
+    vtkSMPTools::For(first, last, grain, initializing);
+    functor.Reduce();
+    }
+  template <typename Functor>
+  static void Reduce(vtkIdType first, vtkIdType last, Functor& functor)
+    {
+    vtkSMPTools::Reduce(first, last, 0, functor);
+    }
+
+private:
+  template <typename Functor>
+  static void ExecuteFunctor(void *functor, vtkIdType begin, vtkIdType end)
+    {
+    (*static_cast<Functor *>(functor))(begin, end);
+    }
+
+  // Calls Initialize() the first time a thread runs a chunk.
+  template <typename Functor>
+  class InitializingFunctor
+  {
+  public:
+    InitializingFunctor(Functor& functor) : F(functor), Initialized(0) {}
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      unsigned char& initialized = this->Initialized.Local();
+      if (!initialized)
+        {
+        this->F.Initialize();
+        initialized = 1;
+        }
+      this->F(begin, end);
+      }
+  private:
+    Functor& F;
+    vtkSMPThreadLocal<unsigned char> Initialized;
+  };
+};
+
+#endif
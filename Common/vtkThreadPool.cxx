@@ -0,0 +1,446 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkThreadPool.h"
+
+#include "vtkConditionVariable.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+vtkStandardNewMacro(vtkThreadPool);
+
+// Condition variables are only implemented for pthreads and win32 threads.
+// Everywhere else the pool has no workers and runs every job on the
+// calling thread.
+#if defined(VTK_USE_PTHREADS) || defined(VTK_USE_WIN32_THREADS)
+# define VTK_THREAD_POOL_HAS_WORKERS
+#endif
+
+//----------------------------------------------------------------------------
+// The range of tasks owned by one participating thread.  The owner takes
+// tasks from the front, thieves take the upper half from the back.
+class vtkThreadPoolSlot
+{
+public:
+  vtkThreadPoolSlot() : Begin(0), End(0), Steals(0) {}
+
+  vtkSimpleMutexLock Lock;
+  vtkIdType Begin;
+  vtkIdType End;
+  vtkIdType Steals;
+};
+
+//----------------------------------------------------------------------------
+// One call to vtkThreadPool::Execute.  It lives on the stack of the caller,
+// which does not return before every worker that joined the job has left.
+class vtkThreadPoolJob
+{
+public:
+  vtkThreadPoolJob(vtkThreadPoolTaskFunctionType f, void *data,
+                   vtkIdType numberOfTasks, int maxThreads)
+    {
+    this->Function = f;
+    this->Data = data;
+    this->MaxThreads = maxThreads;
+    this->NumberOfJoined = 0;
+    this->Active = 0;
+    this->Remaining = numberOfTasks;
+    this->Slots = new vtkThreadPoolSlot[maxThreads];
+
+    // Initial static partition, one contiguous range per thread.
+    for (int i = 0; i < maxThreads; ++i)
+      {
+      this->Slots[i].Begin = (numberOfTasks * i) / maxThreads;
+      this->Slots[i].End = (numberOfTasks * (i + 1)) / maxThreads;
+      }
+    }
+  ~vtkThreadPoolJob()
+    {
+    delete [] this->Slots;
+    }
+
+  // Take the next task of the given slot, stealing from another slot when
+  // the own range is empty.  Returns 0 when no task is left anywhere.
+  int NextTask(int slot, vtkIdType& task);
+
+  // Run tasks until there are none left to take.
+  void Participate(int slot);
+
+  vtkThreadPoolTaskFunctionType Function;
+  void *Data;
+  int MaxThreads;
+
+  // Protected by the pool lock.
+  int NumberOfJoined;
+
+  // Protected by DoneLock.
+  int Active;
+  vtkIdType Remaining;
+  vtkSimpleMutexLock DoneLock;
+  vtkSimpleConditionVariable DoneCondition;
+
+  vtkThreadPoolSlot *Slots;
+};
+
+//----------------------------------------------------------------------------
+int vtkThreadPoolJob::NextTask(int slot, vtkIdType& task)
+{
+  vtkThreadPoolSlot& own = this->Slots[slot];
+  own.Lock.Lock();
+  if (own.Begin < own.End)
+    {
+    task = own.Begin++;
+    own.Lock.Unlock();
+    return 1;
+    }
+  own.Lock.Unlock();
+
+  for (;;)
+    {
+    // Find the slot with the most work left.
+    int victim = -1;
+    vtkIdType largest = 0;
+    for (int i = 0; i < this->MaxThreads; ++i)
+      {
+      if (i == slot)
+        {
+        continue;
+        }
+      this->Slots[i].Lock.Lock();
+      vtkIdType left = this->Slots[i].End - this->Slots[i].Begin;
+      this->Slots[i].Lock.Unlock();
+      if (left > largest)
+        {
+        largest = left;
+        victim = i;
+        }
+      }
+    if (victim < 0)
+      {
+      return 0;
+      }
+
+    // Steal the upper half of its range.  Another thief may have been
+    // faster, in which case we look again.
+    vtkThreadPoolSlot& other = this->Slots[victim];
+    other.Lock.Lock();
+    vtkIdType left = other.End - other.Begin;
+    if (left <= 0)
+      {
+      other.Lock.Unlock();
+      continue;
+      }
+    vtkIdType end = other.End;
+    vtkIdType begin = other.End - (left + 1) / 2;
+    other.End = begin;
+    other.Lock.Unlock();
+
+    own.Lock.Lock();
+    own.Begin = begin + 1;
+    own.End = end;
+    ++own.Steals;
+    own.Lock.Unlock();
+    task = begin;
+    return 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPoolJob::Participate(int slot)
+{
+  vtkIdType task;
+  while (this->NextTask(slot, task))
+    {
+    this->Function(this->Data, task, slot);
+
+    this->DoneLock.Lock();
+    if (--this->Remaining == 0)
+      {
+      this->DoneCondition.Broadcast();
+      }
+    this->DoneLock.Unlock();
+    }
+}
+
+//----------------------------------------------------------------------------
+class vtkThreadPoolInternals
+{
+public:
+  vtkThreadPoolInternals() : Shutdown(0), Steals(0) {}
+
+  // Return a job that can still take another thread, or NULL.
+  // Must be called with Lock held.
+  vtkThreadPoolJob *FindJob()
+    {
+    vtkstd::vector<vtkThreadPoolJob*>::iterator it;
+    for (it = this->Jobs.begin(); it != this->Jobs.end(); ++it)
+      {
+      if ((*it)->NumberOfJoined < (*it)->MaxThreads)
+        {
+        return *it;
+        }
+      }
+    return 0;
+    }
+
+  vtkMultiThreader *Threader;
+  vtkstd::vector<int> WorkerIds;
+
+  // Everything below is protected by Lock.
+  vtkSimpleMutexLock Lock;
+  vtkSimpleConditionVariable WorkAvailable;
+  vtkstd::vector<vtkThreadPoolJob*> Jobs;
+  int Shutdown;
+  vtkIdType Steals;
+};
+
+//----------------------------------------------------------------------------
+// Main loop of a worker thread: sleep until a job needs help, work on it
+// until it runs dry, repeat.
+static VTK_THREAD_RETURN_TYPE vtkThreadPoolWorker(void *arg)
+{
+  vtkThreadPoolInternals *internals = static_cast<vtkThreadPoolInternals *>
+    (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+
+  internals->Lock.Lock();
+  while (!internals->Shutdown)
+    {
+    vtkThreadPoolJob *job = internals->FindJob();
+    if (!job)
+      {
+      internals->WorkAvailable.Wait(internals->Lock);
+      continue;
+      }
+    int slot = job->NumberOfJoined++;
+    job->DoneLock.Lock();
+    ++job->Active;
+    job->DoneLock.Unlock();
+    internals->Lock.Unlock();
+
+    job->Participate(slot);
+
+    job->DoneLock.Lock();
+    if (--job->Active == 0 && job->Remaining == 0)
+      {
+      job->DoneCondition.Broadcast();
+      }
+    job->DoneLock.Unlock();
+
+    internals->Lock.Lock();
+    }
+  internals->Lock.Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// The process-wide instance, destroyed (and its threads joined) at exit.
+static vtkSimpleMutexLock vtkThreadPoolInstanceLock;
+static vtkThreadPool *vtkThreadPoolInstance = 0;
+
+class vtkThreadPoolCleanup
+{
+public:
+  ~vtkThreadPoolCleanup()
+    {
+    if (vtkThreadPoolInstance)
+      {
+      vtkThreadPoolInstance->Delete();
+      vtkThreadPoolInstance = 0;
+      }
+    }
+};
+static vtkThreadPoolCleanup vtkThreadPoolCleanupInstance;
+
+//----------------------------------------------------------------------------
+vtkThreadPool *vtkThreadPool::GetInstance()
+{
+  vtkThreadPoolInstanceLock.Lock();
+  if (!vtkThreadPoolInstance)
+    {
+    vtkThreadPoolInstance = vtkThreadPool::New();
+    }
+  vtkThreadPoolInstanceLock.Unlock();
+  return vtkThreadPoolInstance;
+}
+
+//----------------------------------------------------------------------------
+vtkThreadPool::vtkThreadPool()
+{
+  this->Internals = new vtkThreadPoolInternals;
+  this->Internals->Threader = vtkMultiThreader::New();
+  this->StartWorkers(vtkMultiThreader::GetGlobalDefaultNumberOfThreads() - 1);
+}
+
+//----------------------------------------------------------------------------
+vtkThreadPool::~vtkThreadPool()
+{
+  this->StopWorkers();
+  this->Internals->Threader->Delete();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::StartWorkers(int num)
+{
+#ifdef VTK_THREAD_POOL_HAS_WORKERS
+  if (num > VTK_MAX_THREADS - 1)
+    {
+    num = VTK_MAX_THREADS - 1;
+    }
+  this->Internals->Shutdown = 0;
+  for (int i = 0; i < num; ++i)
+    {
+    int id = this->Internals->Threader->SpawnThread(vtkThreadPoolWorker,
+                                                    this->Internals);
+    if (id < 0)
+      {
+      break;
+      }
+    this->Internals->WorkerIds.push_back(id);
+    }
+#else
+  (void)num;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::StopWorkers()
+{
+  this->Internals->Lock.Lock();
+  this->Internals->Shutdown = 1;
+  this->Internals->WorkAvailable.Broadcast();
+  this->Internals->Lock.Unlock();
+
+  vtkstd::vector<int>::iterator it;
+  for (it = this->Internals->WorkerIds.begin();
+       it != this->Internals->WorkerIds.end(); ++it)
+    {
+    this->Internals->Threader->TerminateThread(*it);
+    }
+  this->Internals->WorkerIds.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::SetNumberOfWorkers(int num)
+{
+  if (num < 0)
+    {
+    num = 0;
+    }
+  if (num == this->GetNumberOfWorkers())
+    {
+    return;
+    }
+  this->StopWorkers();
+  this->StartWorkers(num);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadPool::GetNumberOfWorkers()
+{
+  return static_cast<int>(this->Internals->WorkerIds.size());
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkThreadPool::GetNumberOfSteals()
+{
+  this->Internals->Lock.Lock();
+  vtkIdType steals = this->Internals->Steals;
+  this->Internals->Lock.Unlock();
+  return steals;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::Execute(vtkThreadPoolTaskFunctionType f, void *data,
+                            vtkIdType numberOfTasks, int maxThreads)
+{
+  if (numberOfTasks <= 0)
+    {
+    return;
+    }
+  maxThreads = vtkstd::min(maxThreads, this->GetNumberOfWorkers() + 1);
+  if (numberOfTasks < maxThreads)
+    {
+    maxThreads = static_cast<int>(numberOfTasks);
+    }
+
+  // Nothing to share, run everything right here.
+  if (maxThreads <= 1)
+    {
+    for (vtkIdType i = 0; i < numberOfTasks; ++i)
+      {
+      f(data, i, 0);
+      }
+    return;
+    }
+
+  vtkThreadPoolJob job(f, data, numberOfTasks, maxThreads);
+
+  // The calling thread always takes slot 0, and task 0 is taken out of
+  // its range before any worker can see the job, so that it cannot be
+  // stolen.  Code that reports progress or fires events from task 0 then
+  // does so on the calling thread, as with vtkMultiThreader.
+  job.Slots[0].Begin = 1;
+  this->Internals->Lock.Lock();
+  job.NumberOfJoined = 1;
+  this->Internals->Jobs.push_back(&job);
+  this->Internals->WorkAvailable.Broadcast();
+  this->Internals->Lock.Unlock();
+
+  f(data, 0, 0);
+  job.DoneLock.Lock();
+  --job.Remaining;
+  job.DoneLock.Unlock();
+
+  job.Participate(0);
+
+  // No more work to hand out: stop other workers from joining, then wait
+  // for the tasks still running and for every helper to leave the job.
+  this->Internals->Lock.Lock();
+  this->Internals->Jobs.erase(
+    vtkstd::find(this->Internals->Jobs.begin(), this->Internals->Jobs.end(),
+                 &job));
+  this->Internals->Lock.Unlock();
+
+  job.DoneLock.Lock();
+  while (job.Remaining > 0 || job.Active > 0)
+    {
+    job.DoneCondition.Wait(job.DoneLock);
+    }
+  job.DoneLock.Unlock();
+
+  vtkIdType steals = 0;
+  for (int i = 0; i < maxThreads; ++i)
+    {
+    steals += job.Slots[i].Steals;
+    }
+  this->Internals->Lock.Lock();
+  this->Internals->Steals += steals;
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "NumberOfWorkers: " << this->GetNumberOfWorkers() << "\n";
+  os << indent << "NumberOfSteals: " << this->GetNumberOfSteals() << "\n";
+}
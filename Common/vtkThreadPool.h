@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadPool.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkThreadPool - a pool of persistent, work-stealing worker threads
+// .SECTION Description
+// vtkThreadPool keeps a set of worker threads alive between calls so that
+// multithreaded code does not pay for thread creation and joining every
+// time it runs.  Work is handed to the pool as a number of independent
+// tasks.  The tasks are first divided into one contiguous range per
+// participating thread; a thread that runs out of work steals the upper
+// half of the largest range that is left, so that uneven tasks do not leave
+// threads idle.
+//
+// The thread that calls Execute() always works on its own job, which means
+// that nested calls (a task that itself calls Execute()) and concurrent
+// calls from several threads make progress even when every worker is busy.
+//
+// Most code should use the process-wide pool returned by GetInstance(),
+// usually through vtkMultiThreader::PieceMethodExecute() or
+// vtkMultiThreader::SetUseThreadPool().
+// .SECTION See Also
+// vtkMultiThreader
+
+#ifndef __vtkThreadPool_h
+#define __vtkThreadPool_h
+
+#include "vtkObject.h"
+
+//BTX
+// Signature of a task executed by the pool.  taskId is in
+// [0, numberOfTasks) and threadId is in [0, maxThreads).  A threadId is
+// never used by two tasks of the same job at the same time, so it may be
+// used to index per-thread storage.
+typedef void (*vtkThreadPoolTaskFunctionType)(void *data, vtkIdType taskId,
+                                              int threadId);
+
+class vtkThreadPoolInternals;
+//ETX
+
+class VTK_COMMON_EXPORT vtkThreadPool : public vtkObject
+{
+public:
+  static vtkThreadPool *New();
+  vtkTypeMacro(vtkThreadPool,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Return the process-wide pool, creating it on first use.  The pool
+  // starts vtkMultiThreader::GetGlobalDefaultNumberOfThreads() - 1
+  // workers, since the calling thread also does work.
+  static vtkThreadPool *GetInstance();
+
+  // Description:
+  // Set/Get the number of worker threads owned by the pool.  The thread
+  // calling Execute() is not counted.  Changing the number of workers
+  // stops and restarts the threads, so it must not be done while a job
+  // is running.
+  void SetNumberOfWorkers(int num);
+  int GetNumberOfWorkers();
+
+  //BTX
+  // Description:
+  // Call f(data, taskId, threadId) once for every taskId in
+  // [0, numberOfTasks) using at most maxThreads threads, the calling
+  // thread included.  Task 0 always runs on the calling thread, with
+  // threadId 0.  Returns once every task has completed.
+  void Execute(vtkThreadPoolTaskFunctionType f, void *data,
+               vtkIdType numberOfTasks, int maxThreads);
+  //ETX
+
+  // Description:
+  // Number of times a thread took work from another thread's range since
+  // the pool was created.  Useful to check the load balancing.
+  vtkIdType GetNumberOfSteals();
+
+protected:
+  vtkThreadPool();
+  ~vtkThreadPool();
+
+  void StartWorkers(int num);
+  void StopWorkers();
+
+  //BTX
+  vtkThreadPoolInternals *Internals;
+  //ETX
+
+private:
+  vtkThreadPool(const vtkThreadPool&);  // Not implemented.
+  void operator=(const vtkThreadPool&);  // Not implemented.
+};
+
+#endif
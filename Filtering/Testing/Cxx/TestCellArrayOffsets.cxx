@@ -0,0 +1,309 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellArrayOffsets.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Exercise the offsets storage of vtkCellArray: wrapping caller memory,
+// filling the connectivity in parallel from a prefix sum of the cell
+// sizes, traversal and location access, conversion between the storages
+// and random access of unstructured grid and polydata cells.
+
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Cell i has 3 + i % 3 points: i, i+1, ...
+static vtkIdType CellSize(vtkIdType i)
+{
+  return 3 + i % 3;
+}
+
+// Writes the point ids of a range of cells at their offsets.
+class FillConnectivity
+{
+public:
+  const vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      for (vtkIdType j = this->Offsets[i]; j < this->Offsets[i+1]; ++j)
+        {
+        this->Connectivity[j] = i + j - this->Offsets[i];
+        }
+      }
+    }
+};
+
+static int CheckCells(vtkCellArray *cells, vtkIdType numCells,
+                      const char *name)
+{
+  if (cells->GetNumberOfCells() != numCells)
+    {
+    cerr << name << ": " << cells->GetNumberOfCells() << " cells instead of "
+         << numCells << endl;
+    return 1;
+    }
+
+  // Random access by index and by location.
+  vtkIdType loc = 0;
+  for (vtkIdType i = 0; i < numCells; ++i)
+    {
+    vtkIdType npts, *pts, lnpts, *lpts;
+    cells->GetCellAtId(i, npts, pts);
+    cells->GetCell(loc, lnpts, lpts);
+    if (npts != CellSize(i) || lnpts != npts || lpts != pts ||
+        cells->GetCellLocation(i) != loc)
+      {
+      cerr << name << ": cell " << i << " has the wrong size or location"
+           << endl;
+      return 1;
+      }
+    for (vtkIdType j = 0; j < npts; ++j)
+      {
+      if (pts[j] != i + j)
+        {
+        cerr << name << ": cell " << i << " has the wrong points" << endl;
+        return 1;
+        }
+      }
+    loc += npts + 1;
+    }
+  if (cells->GetNumberOfConnectivityEntries() != loc)
+    {
+    cerr << name << ": wrong number of connectivity entries" << endl;
+    return 1;
+    }
+
+  // Traversal.
+  vtkIdType npts, *pts, i = 0;
+  for (cells->InitTraversal(); cells->GetNextCell(npts, pts); ++i)
+    {
+    if (npts != CellSize(i) || pts[0] != i ||
+        cells->GetTraversalLocation(npts) != cells->GetCellLocation(i))
+      {
+      cerr << name << ": traversal differs at cell " << i << endl;
+      return 1;
+      }
+    }
+  if (i != numCells)
+    {
+    cerr << name << ": traversal visited " << i << " cells" << endl;
+    return 1;
+    }
+  return 0;
+}
+
+static int CompareGenericCells(vtkDataSet *a, vtkDataSet *b,
+                               const char *name)
+{
+  VTK_CREATE(vtkGenericCell, ca);
+  VTK_CREATE(vtkGenericCell, cb);
+  VTK_CREATE(vtkIdList, ids);
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+    {
+    a->GetCell(i, ca);
+    b->GetCell(i, cb);
+    b->GetCellPoints(i, ids);
+    if (ca->GetCellType() != cb->GetCellType() ||
+        ca->GetNumberOfPoints() != cb->GetNumberOfPoints() ||
+        ids->GetNumberOfIds() != cb->GetNumberOfPoints())
+      {
+      cerr << name << ": cell " << i << " differs" << endl;
+      return 1;
+      }
+    for (vtkIdType j = 0; j < ca->GetNumberOfPoints(); ++j)
+      {
+      if (ca->GetPointId(j) != cb->GetPointId(j) ||
+          ids->GetId(j) != cb->GetPointId(j))
+        {
+        cerr << name << ": cell " << i << " differs" << endl;
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+
+int TestCellArrayOffsets(int, char *[])
+{
+  int errors = 0;
+  const vtkIdType numCells = 1000;
+
+  // Prefix sum of the cell sizes into caller owned memory, then fill the
+  // connectivity in parallel and hand both to the cell array without
+  // copying.
+  vtkIdType *offsets = new vtkIdType[numCells + 1];
+  offsets[0] = 0;
+  for (vtkIdType i = 0; i < numCells; ++i)
+    {
+    offsets[i+1] = offsets[i] + CellSize(i);
+    }
+  vtkIdType *connectivity = new vtkIdType[offsets[numCells]];
+  FillConnectivity fill;
+  fill.Offsets = offsets;
+  fill.Connectivity = connectivity;
+  vtkSMPTools::For(0, numCells, fill);
+
+  VTK_CREATE(vtkIdTypeArray, offsetsArray);
+  offsetsArray->SetArray(offsets, numCells + 1, 1);
+  VTK_CREATE(vtkIdTypeArray, connectivityArray);
+  connectivityArray->SetArray(connectivity, offsets[numCells], 1);
+
+  VTK_CREATE(vtkCellArray, cells);
+  cells->SetData(offsetsArray, connectivityArray);
+  if (!cells->IsStorageOffsets() ||
+      cells->GetConnectivityArray()->GetPointer(0) != connectivity)
+    {
+    cerr << "SetData copied the arrays" << endl;
+    ++errors;
+    }
+  errors += CheckCells(cells, numCells, "wrapped");
+
+  // The same cells inserted one by one into both storages.
+  VTK_CREATE(vtkCellArray, legacy);
+  VTK_CREATE(vtkCellArray, inserted);
+  inserted->ConvertToOffsetsStorage();
+  for (vtkIdType i = 0; i < numCells; ++i)
+    {
+    vtkIdType pts[5] = { i, i + 1, i + 2, i + 3, i + 4 };
+    legacy->InsertNextCell(CellSize(i), pts);
+    if (i % 2)
+      {
+      inserted->InsertNextCell(CellSize(i), pts);
+      }
+    else
+      {
+      inserted->InsertNextCell(5);
+      for (vtkIdType j = 0; j < CellSize(i); ++j)
+        {
+        inserted->InsertCellPoint(pts[j]);
+        }
+      inserted->UpdateCellCount(static_cast<int>(CellSize(i)));
+      }
+    }
+  errors += CheckCells(legacy, numCells, "legacy");
+  errors += CheckCells(inserted, numCells, "inserted");
+  if (inserted->GetInsertLocation(4) != legacy->GetInsertLocation(4) ||
+      inserted->GetMaxCellSize() != 5)
+    {
+    cerr << "Insert location or maximum cell size differs" << endl;
+    ++errors;
+    }
+
+  // Conversions keep the cells and the locations.
+  VTK_CREATE(vtkCellArray, converted);
+  converted->DeepCopy(inserted);
+  vtkIdType *ia = converted->GetPointer();
+  vtkIdType *la = legacy->GetPointer();
+  for (vtkIdType i = 0; i < legacy->GetNumberOfConnectivityEntries(); ++i)
+    {
+    if (ia[i] != la[i])
+      {
+      cerr << "Conversion to legacy storage differs at " << i << endl;
+      ++errors;
+      break;
+      }
+    }
+  // A list obtained with GetData() keeps its contents after the
+  // conversion to offsets storage.
+  vtkSmartPointer<vtkIdTypeArray> held = converted->GetData();
+  vtkIdType heldSize = held->GetNumberOfTuples();
+  converted->ConvertToOffsetsStorage();
+  errors += CheckCells(converted, numCells, "converted");
+  if (held->GetNumberOfTuples() != heldSize || held->GetValue(0) != 3)
+    {
+    cerr << "Conversion to offsets storage emptied the list from GetData()"
+         << endl;
+    ++errors;
+    }
+
+  // Unstructured grid and polydata random access with both storages.
+  VTK_CREATE(vtkPoints, points);
+  for (vtkIdType i = 0; i < numCells + 5; ++i)
+    {
+    points->InsertNextPoint(i, i % 7, i % 11);
+    }
+  int *types = new int[numCells];
+  for (vtkIdType i = 0; i < numCells; ++i)
+    {
+    types[i] = (CellSize(i) == 3 ? VTK_TRIANGLE :
+                CellSize(i) == 4 ? VTK_QUAD : VTK_POLYGON);
+    }
+  VTK_CREATE(vtkUnstructuredGrid, legacyGrid);
+  legacyGrid->SetPoints(points);
+  legacyGrid->SetCells(types, legacy);
+  VTK_CREATE(vtkUnstructuredGrid, offsetsGrid);
+  offsetsGrid->SetPoints(points);
+  offsetsGrid->SetCells(types, cells);
+  errors += CompareGenericCells(legacyGrid, offsetsGrid, "grid");
+  delete [] types;
+
+  VTK_CREATE(vtkCellArray, verts);
+  verts->ConvertToOffsetsStorage();
+  for (vtkIdType i = 0; i < 10; ++i)
+    {
+    verts->InsertNextCell(1, &i);
+    }
+  VTK_CREATE(vtkPolyData, legacyPoly);
+  legacyPoly->SetPoints(points);
+  legacyPoly->SetPolys(legacy);
+  VTK_CREATE(vtkPolyData, offsetsPoly);
+  offsetsPoly->SetPoints(points);
+  offsetsPoly->SetVerts(verts);
+  offsetsPoly->SetPolys(cells);
+  VTK_CREATE(vtkPolyData, mixedPoly);
+  mixedPoly->SetPoints(points);
+  mixedPoly->SetVerts(verts);
+  mixedPoly->SetPolys(legacy);
+  errors += CompareGenericCells(mixedPoly, offsetsPoly, "polydata");
+  if (offsetsPoly->GetCell(10)->GetPointId(2) != 2)
+    {
+    cerr << "polydata: wrong first polygon" << endl;
+    ++errors;
+    }
+
+  // Building the cells of the datasets reads offsets storage in place.
+  if (!cells->IsStorageOffsets() || !verts->IsStorageOffsets())
+    {
+    cerr << "The datasets converted offsets storage" << endl;
+    ++errors;
+    }
+
+  // Reversing a cell in place.
+  cells->ReverseCell(cells->GetCellLocation(7));
+  vtkIdType npts, *pts;
+  cells->GetCellAtId(7, npts, pts);
+  if (pts[0] != 7 + npts - 1 || pts[npts-1] != 7)
+    {
+    cerr << "ReverseCell failed" << endl;
+    ++errors;
+    }
+
+  offsetsArray->Initialize();
+  connectivityArray->Initialize();
+  delete [] offsets;
+  delete [] connectivity;
+
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCompositeDataPipelineConcurrency.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the concurrent block execution of vtkCompositeDataPipeline
+// .SECTION Description
+// Runs an elevation filter over a multiblock dataset of spheres and an
+// image, with nested blocks and an empty leaf, once block after block and
+// once with ConcurrentBlockExecution on.  Both must produce the same
+// composite output, and the concurrent blocks must be executed by copies
+// of the filter.  A filter that does not set REQUEST_DATA_THREAD_SAFE()
+// must also give the same output when ConcurrentBlockExecution is on.
+
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataPipeline.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkElevationFilter.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTimerLog.h"
+
+#include <math.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// An elevation filter that declares that it can run on several blocks at
+// once, and counts the blocks it executed itself.
+class vtkThreadSafeElevationFilter : public vtkElevationFilter
+{
+public:
+  static vtkThreadSafeElevationFilter* New();
+  vtkTypeMacro(vtkThreadSafeElevationFilter, vtkElevationFilter);
+
+  int Executions;
+
+protected:
+  vtkThreadSafeElevationFilter()
+    {
+    this->Executions = 0;
+    this->GetInformation()->Set(
+      vtkCompositeDataPipeline::REQUEST_DATA_THREAD_SAFE(), 1);
+    }
+
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector)
+    {
+    ++this->Executions;
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+};
+
+vtkStandardNewMacro(vtkThreadSafeElevationFilter);
+
+static vtkMultiBlockDataSet* NewInput(int numSpheres, int resolution)
+{
+  vtkMultiBlockDataSet* input = vtkMultiBlockDataSet::New();
+  VTK_CREATE(vtkMultiBlockDataSet, spheres);
+  for (int i = 0; i < numSpheres; ++i)
+    {
+    VTK_CREATE(vtkSphereSource, source);
+    source->SetCenter(i, 0.5*i, 0.0);
+    source->SetRadius(1.0 + 0.1*i);
+    source->SetThetaResolution(resolution + i);
+    source->SetPhiResolution(resolution);
+    source->Update();
+    VTK_CREATE(vtkPolyData, sphere);
+    sphere->ShallowCopy(source->GetOutput());
+    // leave one leaf empty
+    spheres->SetBlock(i, (i == 3 ? 0 : sphere.GetPointer()));
+    }
+  input->SetBlock(0, spheres);
+
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(8, 6, 4);
+  image->SetOrigin(-2.0, 0.0, 1.0);
+  input->SetBlock(1, image);
+  return input;
+}
+
+static vtkMultiBlockDataSet* Elevation(vtkElevationFilter* filter,
+                                       vtkMultiBlockDataSet* input,
+                                       int concurrent, double* time = 0)
+{
+  filter->SetInput(input);
+  filter->SetLowPoint(0.0, 0.0, 0.0);
+  filter->SetHighPoint(10.0, 5.0, 1.0);
+  vtkCompositeDataPipeline::SafeDownCast(filter->GetExecutive())->
+    SetConcurrentBlockExecution(concurrent);
+  // the executive is not part of the modification time of the filter
+  filter->Modified();
+  VTK_CREATE(vtkTimerLog, timer);
+  timer->StartTimer();
+  filter->Update();
+  timer->StopTimer();
+  if (time)
+    {
+    *time = timer->GetElapsedTime();
+    }
+  vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::New();
+  output->ShallowCopy(filter->GetOutputDataObject(0));
+  return output;
+}
+
+static int CompareOutputs(vtkMultiBlockDataSet* a, vtkMultiBlockDataSet* b,
+                          const char* name)
+{
+  vtkCompositeDataIterator* ia = a->NewIterator();
+  vtkCompositeDataIterator* ib = b->NewIterator();
+  ia->SkipEmptyNodesOff();
+  ib->SkipEmptyNodesOff();
+  int ok = 1;
+  int numLeaves = 0;
+  for (ia->InitTraversal(), ib->InitTraversal();
+       ok && !ia->IsDoneWithTraversal() && !ib->IsDoneWithTraversal();
+       ia->GoToNextItem(), ib->GoToNextItem())
+    {
+    vtkDataSet* da = vtkDataSet::SafeDownCast(ia->GetCurrentDataObject());
+    vtkDataSet* db = vtkDataSet::SafeDownCast(ib->GetCurrentDataObject());
+    if (!da || !db)
+      {
+      ok = (!da && !db);
+      continue;
+      }
+    ++numLeaves;
+    vtkDataArray* ea = da->GetPointData()->GetArray("Elevation");
+    vtkDataArray* eb = db->GetPointData()->GetArray("Elevation");
+    if (strcmp(da->GetClassName(), db->GetClassName()) != 0 ||
+        da->GetNumberOfPoints() != db->GetNumberOfPoints() ||
+        !ea || !eb || ea->GetNumberOfTuples() != da->GetNumberOfPoints() ||
+        eb->GetNumberOfTuples() != db->GetNumberOfPoints())
+      {
+      ok = 0;
+      continue;
+      }
+    for (vtkIdType i = 0; i < ea->GetNumberOfTuples(); ++i)
+      {
+      if (fabs(ea->GetTuple1(i) - eb->GetTuple1(i)) > 1e-6)
+        {
+        ok = 0;
+        break;
+        }
+      }
+    }
+  if (!ia->IsDoneWithTraversal() || !ib->IsDoneWithTraversal() ||
+      numLeaves == 0)
+    {
+    ok = 0;
+    }
+  ia->Delete();
+  ib->Delete();
+  if (!ok)
+    {
+    cerr << name << ": the concurrent output differs" << endl;
+    }
+  return ok;
+}
+
+int TestCompositeDataPipelineConcurrency(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+  vtkCompositeDataPipeline* prototype = vtkCompositeDataPipeline::New();
+  vtkAlgorithm::SetDefaultExecutivePrototype(prototype);
+  prototype->Delete();
+
+  int ok = 1;
+  vtkMultiBlockDataSet* input = NewInput(24, 16);
+  VTK_CREATE(vtkThreadSafeElevationFilter, safe);
+  vtkMultiBlockDataSet* serial = Elevation(safe, input, 0);
+  int serialExecutions = safe->Executions;
+  vtkMultiBlockDataSet* concurrent = Elevation(safe, input, 1);
+  ok = CompareOutputs(serial, concurrent, "Thread-safe filter") && ok;
+  if (serialExecutions == 0 || safe->Executions != serialExecutions)
+    {
+    cerr << "The blocks were not executed by copies of the filter" << endl;
+    ok = 0;
+    }
+  concurrent->Delete();
+
+  VTK_CREATE(vtkElevationFilter, plain);
+  concurrent = Elevation(plain, input, 1);
+  ok = CompareOutputs(serial, concurrent, "Filter without the key") && ok;
+  concurrent->Delete();
+  serial->Delete();
+  input->Delete();
+
+  input = NewInput(200, 100);
+  VTK_CREATE(vtkThreadSafeElevationFilter, timed);
+  const char* names[2] = { "block after block", "concurrent" };
+  for (int mode = 0; mode < 2; ++mode)
+    {
+    double time;
+    Elevation(timed, input, mode, &time)->Delete();
+    cout << "200 blocks, " << names[mode] << ": " << time << " s" << endl;
+    }
+  input->Delete();
+
+  vtkAlgorithm::SetDefaultExecutivePrototype(0);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,355 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestInformationStorage.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test and benchmark of the entries of vtkInformation
+// .SECTION Description
+// Fills information objects with integer, double and string entries,
+// from a few keys to more than are kept in the object itself, removes
+// some of them and checks the values, the iterator, copies and that the
+// values do not move while the object grows.  Then prints the time a
+// chain of trivial filters takes to update, which is mostly spent in the
+// pipeline requests.  The number of filters can be
+// given as the first argument; the default is 128.
+
+#include "vtkInformation.h"
+#include "vtkInformationDoubleKey.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationIterator.h"
+#include "vtkInformationStringKey.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// A filter passing its input through.
+class vtkTrivialPolyDataFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTrivialPolyDataFilter* New();
+  vtkTypeMacro(vtkTrivialPolyDataFilter, vtkPolyDataAlgorithm);
+
+protected:
+  vtkTrivialPolyDataFilter() {}
+
+  int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+                  vtkInformationVector* outputVector)
+    {
+    vtkPolyData* input = vtkPolyData::GetData(inputVector[0]);
+    vtkPolyData* output = vtkPolyData::GetData(outputVector);
+    output->ShallowCopy(input);
+    return 1;
+    }
+};
+
+vtkStandardNewMacro(vtkTrivialPolyDataFilter);
+
+// Keys of every type for the test.  The key manager deletes them at exit.
+const int NumberOfKeys = 48;
+static char KeyNames[NumberOfKeys][16];
+static vtkInformationIntegerKey* IntegerKeys[NumberOfKeys];
+static vtkInformationDoubleKey* DoubleKeys[NumberOfKeys];
+static vtkInformationStringKey* StringKeys[NumberOfKeys];
+
+static void CreateKeys()
+{
+  for (int i = 0; i < NumberOfKeys; ++i)
+    {
+    sprintf(KeyNames[i], "KEY_%d", i);
+    IntegerKeys[i] =
+      new vtkInformationIntegerKey(KeyNames[i], "TestInformationStorage");
+    DoubleKeys[i] =
+      new vtkInformationDoubleKey(KeyNames[i], "TestInformationStorage");
+    StringKeys[i] =
+      new vtkInformationStringKey(KeyNames[i], "TestInformationStorage");
+    }
+}
+
+// Key i holds an integer, a double or a string depending on i % 3, and
+// the keys with i % 4 == 3 are removed.
+static void Fill(vtkInformation* info, int numKeys)
+{
+  for (int i = 0; i < numKeys; ++i)
+    {
+    switch (i % 3)
+      {
+      case 0: info->Set(IntegerKeys[i], i); break;
+      case 1: info->Set(DoubleKeys[i], i + 0.5); break;
+      case 2: info->Set(StringKeys[i], KeyNames[i]); break;
+      }
+    }
+  for (int i = 3; i < numKeys; i += 4)
+    {
+    switch (i % 3)
+      {
+      case 0: info->Remove(IntegerKeys[i]); break;
+      case 1: info->Remove(DoubleKeys[i]); break;
+      case 2: info->Remove(StringKeys[i]); break;
+      }
+    }
+  // Setting an integer again keeps a single entry.
+  if (numKeys > 0)
+    {
+    info->Set(IntegerKeys[0], -1);
+    }
+}
+
+static int Check(vtkInformation* info, int numKeys, const char* name)
+{
+  int numExpected = 0;
+  for (int i = 0; i < numKeys; ++i)
+    {
+    int removed = (i % 4 == 3);
+    numExpected += !removed;
+    int ok = 1;
+    switch (i % 3)
+      {
+      case 0:
+        ok = (info->Has(IntegerKeys[i]) == !removed &&
+              info->Get(IntegerKeys[i]) == (removed ? 0 : (i ? i : -1)));
+        break;
+      case 1:
+        ok = (info->Has(DoubleKeys[i]) == !removed &&
+              info->Get(DoubleKeys[i]) == (removed ? 0.0 : i + 0.5));
+        break;
+      case 2:
+        ok = (info->Has(StringKeys[i]) == !removed &&
+              (removed ? info->Get(StringKeys[i]) == 0 :
+               strcmp(info->Get(StringKeys[i]), KeyNames[i]) == 0));
+        break;
+      }
+    // Keys of another type with the same name are different keys.
+    ok = ok && (i % 3 ? !info->Has(IntegerKeys[i]) :
+                !info->Has(DoubleKeys[i]));
+    if (!ok)
+      {
+      cerr << name << " with " << numKeys << " keys: wrong entry for key "
+           << i << endl;
+      return 0;
+      }
+    }
+
+  // Every key must be visited once.
+  vtkstd::vector<int> visits(NumberOfKeys, 0);
+  VTK_CREATE(vtkInformationIterator, iter);
+  iter->SetInformation(info);
+  int numVisited = 0;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+       iter->GoToNextItem())
+    {
+    vtkInformationKey* key = iter->GetCurrentKey();
+    for (int i = 0; i < numKeys; ++i)
+      {
+      if (key == IntegerKeys[i] || key == DoubleKeys[i] ||
+          key == StringKeys[i])
+        {
+        ++visits[i];
+        }
+      }
+    ++numVisited;
+    }
+  for (int i = 0; i < numKeys; ++i)
+    {
+    if (visits[i] != (i % 4 != 3))
+      {
+      cerr << name << " with " << numKeys << " keys: the iterator visited "
+           << "key " << i << " " << visits[i] << " times" << endl;
+      return 0;
+      }
+    }
+  if (numVisited != numExpected || info->GetNumberOfKeys() != numExpected)
+    {
+    cerr << name << " with " << numKeys << " keys: " << numVisited
+         << " keys instead of " << numExpected << endl;
+    return 0;
+    }
+  return 1;
+}
+
+static int TestEntries()
+{
+  CreateKeys();
+  int ok = 1;
+  int sizes[] = { 0, 1, 5, 15, 16, 17, 24, NumberOfKeys };
+  for (unsigned int s = 0; s < sizeof(sizes)/sizeof(sizes[0]); ++s)
+    {
+    VTK_CREATE(vtkInformation, info);
+    Fill(info, sizes[s]);
+    ok = Check(info, sizes[s], "Filled") && ok;
+
+    VTK_CREATE(vtkInformation, copy);
+    copy->Set(IntegerKeys[1], 1);
+    copy->Copy(info);
+    ok = Check(copy, sizes[s], "Copy") && ok;
+
+    // Copy into an object with more entries than the source.
+    VTK_CREATE(vtkInformation, large);
+    Fill(large, NumberOfKeys);
+    large->Copy(info, 1);
+    ok = Check(large, sizes[s], "Deep copy") && ok;
+
+    info->Clear();
+    if (info->GetNumberOfKeys() != 0)
+      {
+      cerr << "Clear left keys" << endl;
+      ok = 0;
+      }
+    }
+  return ok;
+}
+
+// Keys giving the address of their value.
+class vtkWatchedIntegerKey : public vtkInformationIntegerKey
+{
+public:
+  vtkWatchedIntegerKey(const char* name, const char* location):
+    vtkInformationIntegerKey(name, location) {}
+  int* Watch(vtkInformation* info) { return this->GetWatchAddress(info); }
+};
+
+class vtkWatchedDoubleKey : public vtkInformationDoubleKey
+{
+public:
+  vtkWatchedDoubleKey(const char* name, const char* location):
+    vtkInformationDoubleKey(name, location) {}
+  double* Watch(vtkInformation* info) { return this->GetWatchAddress(info); }
+};
+
+// Grows an information object one entry at a time, then removes and adds
+// entries again.  The values must keep their addresses meanwhile.
+static int TestGrowth()
+{
+  vtkWatchedIntegerKey* watchedInteger =
+    new vtkWatchedIntegerKey("WATCHED", "TestInformationStorage");
+  vtkWatchedDoubleKey* watchedDouble =
+    new vtkWatchedDoubleKey("WATCHED", "TestInformationStorage");
+  VTK_CREATE(vtkInformation, info);
+  info->Set(watchedInteger, 7);
+  info->Set(IntegerKeys[0], 0);
+  info->Set(watchedDouble, 0.5);
+  int* first = watchedInteger->Watch(info);
+  double* firstDouble = watchedDouble->Watch(info);
+  for (int i = 1; i < NumberOfKeys; ++i)
+    {
+    info->Set(IntegerKeys[i], i);
+    for (int j = 0; j <= i; ++j)
+      {
+      if (info->Get(IntegerKeys[j]) != j)
+        {
+        cerr << "Growing to " << i + 3 << " entries lost key " << j << endl;
+        return 0;
+        }
+      }
+    }
+  for (int i = 1; i < NumberOfKeys; i += 2)
+    {
+    info->Remove(IntegerKeys[i]);
+    }
+  for (int i = 1; i < NumberOfKeys; i += 2)
+    {
+    info->Set(DoubleKeys[i], i + 0.5);
+    }
+  if (watchedInteger->Watch(info) != first ||
+      watchedDouble->Watch(info) != firstDouble ||
+      *first != 7 || *firstDouble != 0.5)
+    {
+    cerr << "The first values moved while the entries changed" << endl;
+    return 0;
+    }
+  for (int i = 1; i < NumberOfKeys; ++i)
+    {
+    if (i % 2 ? (info->Has(IntegerKeys[i]) ||
+                 info->Get(DoubleKeys[i]) != i + 0.5) :
+        info->Get(IntegerKeys[i]) != i)
+      {
+      cerr << "Adding entries again gave a wrong value for key " << i
+           << endl;
+      return 0;
+      }
+    }
+  if (info->GetNumberOfKeys() != NumberOfKeys + 2)
+    {
+    cerr << "Adding entries again gave " << info->GetNumberOfKeys()
+         << " keys" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestInformationStorage(int argc, char* argv[])
+{
+  int ok = TestEntries();
+  ok = TestGrowth() && ok;
+
+  int numFilters = (argc > 1 ? atoi(argv[1]) : 0);
+  if (numFilters < 1)
+    {
+    numFilters = 128;
+    }
+  VTK_CREATE(vtkSphereSource, source);
+  source->SetThetaResolution(4);
+  source->SetPhiResolution(4);
+  vtkstd::vector<vtkSmartPointer<vtkTrivialPolyDataFilter> > filters;
+  vtkAlgorithm* previous = source;
+  for (int i = 0; i < numFilters; ++i)
+    {
+    filters.push_back(vtkSmartPointer<vtkTrivialPolyDataFilter>::New());
+    filters.back()->SetInputConnection(previous->GetOutputPort());
+    previous = filters.back();
+    }
+  vtkTrivialPolyDataFilter* last = filters.back();
+  last->Update();
+  if (last->GetOutput()->GetNumberOfCells() !=
+      source->GetOutput()->GetNumberOfCells())
+    {
+    cerr << "The chain of filters lost the cells" << endl;
+    ok = 0;
+    }
+
+  // Execute the whole chain, then only check that it is up to date.
+  const int numUpdates = 200;
+  VTK_CREATE(vtkTimerLog, timer);
+  timer->StartTimer();
+  for (int i = 0; i < numUpdates; ++i)
+    {
+    filters[0]->Modified();
+    last->Update();
+    }
+  timer->StopTimer();
+  cout << numFilters << " trivial filters, executing update: "
+       << 1e6*timer->GetElapsedTime()/(numUpdates*numFilters)
+       << " us per filter" << endl;
+  timer->StartTimer();
+  for (int i = 0; i < numUpdates; ++i)
+    {
+    last->Update();
+    }
+  timer->StopTimer();
+  cout << numFilters << " trivial filters, up to date update: "
+       << 1e6*timer->GetElapsedTime()/(numUpdates*numFilters)
+       << " us per filter" << endl;
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPipelineProfiler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkPipelineProfiler
+// .SECTION Description
+// Profiles the update of a sphere, elevation and contour pipeline and
+// checks the summary: every algorithm executes once, with the cell counts
+// of its input and output.  Updating again without a change and updating
+// after the profiler is removed must not add records.  The Chrome trace
+// must hold one event per record.  A request that ends after Reset()
+// must not complete a record started later.
+
+#include "vtkContourFilter.h"
+#include "vtkDemandDrivenPipeline.h"
+#include "vtkElevationFilter.h"
+#include "vtkExecutive.h"
+#include "vtkInformation.h"
+#include "vtkPipelineProfiler.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTable.h"
+#include "vtkVariant.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Find the summary row of an algorithm and request, -1 if there is none.
+static vtkIdType FindRow(vtkTable* summary, vtkAlgorithm* algorithm,
+                         const char* request)
+{
+  vtksys_ios::ostringstream name;
+  name << algorithm->GetClassName() << "(" << algorithm << ")";
+  for (vtkIdType row = 0; row < summary->GetNumberOfRows(); ++row)
+    {
+    if (summary->GetValueByName(row, "Algorithm").ToString() == name.str() &&
+        summary->GetValueByName(row, "Request").ToString() == request)
+      {
+      return row;
+      }
+    }
+  return -1;
+}
+
+static int CheckExecution(vtkTable* summary, vtkAlgorithm* algorithm,
+                          vtkIdType inputCells, vtkIdType outputCells)
+{
+  vtkIdType row = FindRow(summary, algorithm, "REQUEST_DATA");
+  if (row < 0 || FindRow(summary, algorithm, "REQUEST_INFORMATION") < 0)
+    {
+    cerr << algorithm->GetClassName() << " was not profiled" << endl;
+    return 0;
+    }
+  vtkIdType calls = summary->GetValueByName(row, "Calls").ToLongLong();
+  vtkIdType in = summary->GetValueByName(row, "Input Cells").ToLongLong();
+  vtkIdType out = summary->GetValueByName(row, "Output Cells").ToLongLong();
+  double time = summary->GetValueByName(row, "Time").ToDouble();
+  if (calls != 1 || in != inputCells || out != outputCells || time < 0.0)
+    {
+    cerr << algorithm->GetClassName() << ": " << calls << " calls, "
+         << in << " input and " << out << " output cells, " << time
+         << " s instead of 1 call, " << inputCells << " and "
+         << outputCells << " cells" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestPipelineProfiler(int, char*[])
+{
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  VTK_CREATE(vtkElevationFilter, elevation);
+  elevation->SetInputConnection(sphere->GetOutputPort());
+  VTK_CREATE(vtkContourFilter, contour);
+  contour->SetInputConnection(elevation->GetOutputPort());
+  contour->GenerateValues(5, 0.1, 0.9);
+
+  VTK_CREATE(vtkPipelineProfiler, profiler);
+  vtkExecutive::SetProfiler(profiler);
+  contour->Update();
+
+  int ok = 1;
+  vtkTable* summary = profiler->GetSummary();
+  summary->Dump(32);
+  vtkIdType sphereCells = sphere->GetOutput()->GetNumberOfCells();
+  vtkIdType contourCells = contour->GetOutput()->GetNumberOfCells();
+  ok = CheckExecution(summary, sphere, 0, sphereCells) && ok;
+  ok = CheckExecution(summary, elevation, sphereCells, sphereCells) && ok;
+  ok = CheckExecution(summary, contour, sphereCells, contourCells) && ok;
+  if (FindRow(summary, contour, "REQUEST_UPDATE_EXTENT") < 0)
+    {
+    cerr << "REQUEST_UPDATE_EXTENT was not profiled" << endl;
+    ok = 0;
+    }
+  vtkIdType row = FindRow(summary, sphere, "REQUEST_DATA");
+  if (row >= 0 &&
+      summary->GetValueByName(row, "Memory Delta").ToLongLong() <= 0)
+    {
+    cerr << "The memory of the sphere was not recorded" << endl;
+    ok = 0;
+    }
+
+  // an up to date pipeline does not execute
+  contour->Update();
+  summary = profiler->GetSummary();
+  row = FindRow(summary, contour, "REQUEST_DATA");
+  if (row < 0 || summary->GetValueByName(row, "Calls").ToInt() != 1)
+    {
+    cerr << "The up to date contour filter executed again" << endl;
+    ok = 0;
+    }
+
+  const char* fileName = "TestPipelineProfiler.json";
+  if (!profiler->WriteChromeTrace(fileName))
+    {
+    cerr << "Writing the trace failed" << endl;
+    ok = 0;
+    }
+  else
+    {
+    vtkstd::string trace;
+    ifstream in(fileName);
+    vtkstd::getline(in, trace, '\0');
+    in.close();
+    int numEvents = 0;
+    for (size_t pos = trace.find("\"ph\":\"X\""); pos != vtkstd::string::npos;
+         pos = trace.find("\"ph\":\"X\"", pos + 1))
+      {
+      ++numEvents;
+      }
+    if (trace.find("{\"traceEvents\":[") != 0 ||
+        numEvents != profiler->GetNumberOfRecords())
+      {
+      cerr << "The trace has " << numEvents << " events instead of "
+           << profiler->GetNumberOfRecords() << endl;
+      ok = 0;
+      }
+    vtksys::SystemTools::RemoveFile(fileName);
+    }
+
+  // nothing is recorded without a profiler
+  int numRecords = profiler->GetNumberOfRecords();
+  vtkExecutive::SetProfiler(0);
+  sphere->SetThetaResolution(32);
+  contour->Update();
+  if (profiler->GetNumberOfRecords() != numRecords)
+    {
+    cerr << "Requests were recorded after the profiler was removed" << endl;
+    ok = 0;
+    }
+  profiler->Reset();
+  if (profiler->GetNumberOfRecords() != 0 ||
+      profiler->GetSummary()->GetNumberOfRows() != 0)
+    {
+    cerr << "Reset did not discard the records" << endl;
+    ok = 0;
+    }
+
+  // a request still executing during Reset() ends without a record
+  vtkExecutive* executive = contour->GetExecutive();
+  VTK_CREATE(vtkInformation, request);
+  request->Set(vtkDemandDrivenPipeline::REQUEST_DATA());
+  vtkIdType stale = profiler->StartRequest(
+    executive, request, executive->GetInputInformation(),
+    executive->GetOutputInformation());
+  profiler->Reset();
+  vtkIdType current = profiler->StartRequest(
+    executive, request, executive->GetInputInformation(),
+    executive->GetOutputInformation());
+  profiler->EndRequest(stale, request, executive->GetOutputInformation());
+  if (stale == current || profiler->GetNumberOfRecords() != 1 ||
+      profiler->GetSummary()->GetValueByName(0, "Time").ToDouble() != 0.0)
+    {
+    cerr << "A request ended after Reset completed a newer record" << endl;
+    ok = 0;
+    }
+  profiler->EndRequest(current, request, executive->GetOutputInformation());
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,336 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStaticCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the queries of vtkStaticCellLocator against brute force searches
+// and vtkCellLocator, then time building and intersecting lines against
+// vtkCellLocator.  The resolution of the benchmark sphere can be given
+// with "-r", e.g. "-r 2000".
+
+#include "vtkCellLocator.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtkstd/vector>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Point in cell and closest point queries on a tetrahedral mesh.
+static int CheckVolume()
+{
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(9, 7, 5);
+  image->SetSpacing(0.25, 0.5, 1.0);
+  VTK_CREATE(vtkDataSetTriangleFilter, tetra);
+  tetra->SetInput(image);
+  tetra->Update();
+  vtkUnstructuredGrid *grid = tetra->GetOutput();
+
+  VTK_CREATE(vtkStaticCellLocator, locator);
+  locator->SetDataSet(grid);
+  locator->BuildLocator();
+  VTK_CREATE(vtkGenericCell, cell);
+  double pcoords[3], weights[VTK_CELL_SIZE], closest[3], dist2;
+  int subId;
+
+  for (int q = 0; q < 500; ++q)
+    {
+    // Some query points lie outside the mesh.
+    double x[3] = { vtkMath::Random(-0.5, 2.5), vtkMath::Random(-0.5, 3.5),
+                    vtkMath::Random(-0.5, 4.5) };
+    vtkIdType cellId = locator->FindCell(x, 0.0, cell, pcoords, weights);
+    int inMesh = (x[0] >= 0 && x[0] <= 2 && x[1] >= 0 && x[1] <= 3 &&
+                  x[2] >= 0 && x[2] <= 4);
+    if ((cellId >= 0) != inMesh)
+      {
+      cerr << "FindCell failed for point " << x[0] << " " << x[1] << " "
+           << x[2] << endl;
+      return 1;
+      }
+    if (cellId >= 0)
+      {
+      grid->GetCell(cellId, cell);
+      if (cell->EvaluatePosition(x, closest, subId, pcoords, dist2,
+                                 weights) != 1)
+        {
+        cerr << "FindCell returned a cell that does not contain the point"
+             << endl;
+        return 1;
+        }
+      }
+
+    // Brute force closest point.
+    double best = VTK_DOUBLE_MAX;
+    for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+      {
+      grid->GetCell(i, cell);
+      if (cell->EvaluatePosition(x, closest, subId, pcoords, dist2,
+                                 weights) != -1 && dist2 < best)
+        {
+        best = dist2;
+        }
+      }
+    locator->FindClosestPoint(x, closest, cell, cellId, subId, dist2);
+    if (cellId < 0 || fabs(dist2 - best) > 1e-12)
+      {
+      cerr << "FindClosestPoint returned " << dist2 << " instead of " << best
+           << endl;
+      return 1;
+      }
+    }
+
+  double bounds[6] = { 0.3, 0.9, 1.1, 1.2, 2.0, 3.5 };
+  VTK_CREATE(vtkIdList, ids);
+  locator->FindCellsWithinBounds(bounds, ids);
+  vtkIdType expected = 0;
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+    {
+    double *b = grid->GetCell(i)->GetBounds();
+    if (b[0] <= bounds[1] && bounds[0] <= b[1] && b[2] <= bounds[3] &&
+        bounds[2] <= b[3] && b[4] <= bounds[5] && bounds[4] <= b[5])
+      {
+      ++expected;
+      }
+    }
+  if (ids->GetNumberOfIds() != expected)
+    {
+    cerr << "FindCellsWithinBounds returned " << ids->GetNumberOfIds()
+         << " cells instead of " << expected << endl;
+    return 1;
+    }
+  return 0;
+}
+
+// Random lines through and around a sphere.
+static void MakeLines(vtkIdType numLines, vtkstd::vector<double>& lines)
+{
+  lines.resize(6*numLines);
+  for (vtkIdType i = 0; i < 6*numLines; ++i)
+    {
+    lines[i] = vtkMath::Random(-1.0, 1.0);
+    }
+}
+
+// Line intersections on a triangulated sphere.
+static int CheckSurface()
+{
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(30);
+  sphere->Update();
+  vtkPolyData *surface = sphere->GetOutput();
+
+  VTK_CREATE(vtkStaticCellLocator, locator);
+  locator->SetDataSet(surface);
+  locator->BuildLocator();
+  VTK_CREATE(vtkCellLocator, reference);
+  reference->SetDataSet(surface);
+  reference->BuildLocator();
+
+  const vtkIdType numLines = 500;
+  vtkstd::vector<double> lines;
+  MakeLines(numLines, lines);
+  vtkstd::vector<vtkIdType> cellIds(numLines);
+  vtkstd::vector<double> ts(numLines);
+  locator->IntersectWithLines(numLines, &lines[0], 0.0, &cellIds[0], &ts[0]);
+
+  VTK_CREATE(vtkGenericCell, cell);
+  VTK_CREATE(vtkIdList, ids);
+  double t, x[3], pcoords[3];
+  int subId;
+  vtkIdType cellId;
+  for (vtkIdType i = 0; i < numLines; ++i)
+    {
+    double *p1 = &lines[6*i];
+    double *p2 = &lines[6*i+3];
+    int hit = reference->IntersectWithLine(p1, p2, 0.0, t, x, pcoords, subId,
+                                           cellId, cell);
+    if (hit != (cellIds[i] >= 0) || (hit && fabs(t - ts[i]) > 1e-9))
+      {
+      cerr << "IntersectWithLines failed for line " << i << endl;
+      return 1;
+      }
+    if (hit)
+      {
+      locator->FindCellsAlongLine(p1, p2, 0.0, ids);
+      if (ids->IsId(cellIds[i]) < 0)
+        {
+        cerr << "FindCellsAlongLine missed cell " << cellIds[i] << endl;
+        return 1;
+        }
+      }
+    }
+
+  VTK_CREATE(vtkPolyData, representation);
+  locator->GenerateRepresentation(-1, representation);
+  if (representation->GetNumberOfCells() == 0)
+    {
+    cerr << "Empty representation" << endl;
+    return 1;
+    }
+  return 0;
+}
+
+// Point in cell queries on the benchmark sphere, which has many more cells
+// than a subtree built by a single thread, against a brute force search.
+static int CheckLargeSurface(vtkPolyData *surface)
+{
+  VTK_CREATE(vtkStaticCellLocator, locator);
+  locator->SetDataSet(surface);
+  locator->BuildLocator();
+  VTK_CREATE(vtkGenericCell, cell);
+  double pcoords[3], weights[VTK_CELL_SIZE], closest[3], dist2;
+  int subId;
+  const double tol2 = 1e-8;
+
+  for (int q = 0; q < 50; ++q)
+    {
+    // A random point of a random triangle, moved off the surface for every
+    // other query.
+    vtkIdType cellId = static_cast<vtkIdType>(
+      vtkMath::Random(0, surface->GetNumberOfCells() - 1));
+    vtkPoints *pts = surface->GetCell(cellId)->GetPoints();
+    double r = vtkMath::Random(), s = vtkMath::Random() * (1.0 - r);
+    double x[3];
+    for (int i = 0; i < 3; ++i)
+      {
+      x[i] = (1.0 - r - s) * pts->GetPoint(0)[i] + r * pts->GetPoint(1)[i] +
+        s * pts->GetPoint(2)[i] + (q % 2 ? vtkMath::Random(-1e-3, 1e-3) : 0);
+      }
+
+    vtkIdType expected = -1;
+    for (vtkIdType i = 0; i < surface->GetNumberOfCells() && expected < 0;
+         ++i)
+      {
+      surface->GetCell(i, cell);
+      if (cell->EvaluatePosition(x, closest, subId, pcoords, dist2,
+                                 weights) == 1 && dist2 <= tol2)
+        {
+        expected = i;
+        }
+      }
+
+    cellId = locator->FindCell(x, tol2, cell, pcoords, weights);
+    if ((cellId >= 0) != (expected >= 0))
+      {
+      cerr << "FindCell returned " << cellId << " on the large surface, "
+           << "brute force found " << expected << endl;
+      return 1;
+      }
+    if (cellId >= 0)
+      {
+      surface->GetCell(cellId, cell);
+      if (cell->EvaluatePosition(x, closest, subId, pcoords, dist2,
+                                 weights) != 1 || dist2 > tol2)
+        {
+        cerr << "FindCell returned a cell that does not contain the point "
+             << "on the large surface" << endl;
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+
+int TestStaticCellLocator(int argc, char *argv[])
+{
+  int resolution = 400;
+  for (int i = 1; i + 1 < argc; ++i)
+    {
+    if (strcmp(argv[i], "-r") == 0)
+      {
+      resolution = atoi(argv[i+1]);
+      }
+    }
+
+  vtkMath::RandomSeed(4321);
+  int errors = CheckVolume();
+  errors += CheckSurface();
+
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(resolution);
+  sphere->SetPhiResolution(resolution);
+  sphere->Update();
+  vtkPolyData *surface = sphere->GetOutput();
+  const vtkIdType numLines = 100000;
+  vtkstd::vector<double> lines;
+  MakeLines(numLines, lines);
+  vtkstd::vector<vtkIdType> cellIds(numLines);
+  vtkstd::vector<double> ts(numLines);
+  cout << surface->GetNumberOfCells() << " triangles" << endl;
+  errors += CheckLargeSurface(surface);
+
+  VTK_CREATE(vtkTimerLog, timer);
+  VTK_CREATE(vtkCellLocator, cellLocator);
+  cellLocator->SetDataSet(surface);
+  timer->StartTimer();
+  cellLocator->BuildLocator();
+  timer->StopTimer();
+  double build = timer->GetElapsedTime();
+  VTK_CREATE(vtkGenericCell, cell);
+  double x[3], pcoords[3];
+  int subId;
+  timer->StartTimer();
+  for (vtkIdType i = 0; i < numLines; ++i)
+    {
+    if (!cellLocator->IntersectWithLine(&lines[6*i], &lines[6*i+3], 0.0,
+                                        ts[i], x, pcoords, subId, cellIds[i],
+                                        cell))
+      {
+      cellIds[i] = -1;
+      }
+    }
+  timer->StopTimer();
+  vtkstd::vector<vtkIdType> referenceIds(cellIds);
+  vtkstd::vector<double> referenceTs(ts);
+  cout << "vtkCellLocator: build " << build << " s, " << numLines
+       << " lines " << timer->GetElapsedTime() << " s" << endl;
+
+  VTK_CREATE(vtkStaticCellLocator, staticLocator);
+  staticLocator->SetDataSet(surface);
+  timer->StartTimer();
+  staticLocator->BuildLocator();
+  timer->StopTimer();
+  build = timer->GetElapsedTime();
+  timer->StartTimer();
+  staticLocator->IntersectWithLines(numLines, &lines[0], 0.0, &cellIds[0],
+                                    &ts[0]);
+  timer->StopTimer();
+  cout << "vtkStaticCellLocator: build " << build << " s, " << numLines
+       << " lines " << timer->GetElapsedTime() << " s, "
+       << staticLocator->GetNumberOfNodes() << " nodes" << endl;
+
+  for (vtkIdType i = 0; i < numLines; ++i)
+    {
+    if ((referenceIds[i] >= 0) != (cellIds[i] >= 0) ||
+        (cellIds[i] >= 0 && fabs(referenceTs[i] - ts[i]) > 1e-9))
+      {
+      cerr << "IntersectWithLines failed for line " << i
+           << " on the large surface" << endl;
+      ++errors;
+      break;
+      }
+    }
+
+  return errors ? 1 : 0;
+}
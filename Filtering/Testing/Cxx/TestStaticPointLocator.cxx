@@ -0,0 +1,224 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStaticPointLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the queries of vtkStaticPointLocator against a brute force search,
+// then time building and querying it against vtkPointLocator and
+// vtkKdTreePointLocator.  The size of the benchmark cloud can be given
+// with "-n", e.g. "-n 10000000".
+
+#include "vtkIdList.h"
+#include "vtkKdTreePointLocator.h"
+#include "vtkMath.h"
+#include "vtkPointLocator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// With flat set, z is 0.5; with almost set it is 0.5 plus a tiny noise,
+// so that the cloud is almost but not exactly planar.
+static vtkPolyData *MakeCloud(vtkIdType numPts, int flat, int almost = 0)
+{
+  vtkPoints *points = vtkPoints::New();
+  points->SetNumberOfPoints(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    // Clustered in x so that buckets are unevenly filled.
+    double r = vtkMath::Random();
+    points->SetPoint(i, r*r*r, vtkMath::Random(0.0, 2.0),
+                     flat ? 0.5 + (almost ? vtkMath::Random(0.0, 1.0e-9) : 0.0)
+                     : vtkMath::Random(-1.0, 0.0));
+    }
+  vtkPolyData *cloud = vtkPolyData::New();
+  cloud->SetPoints(points);
+  points->Delete();
+  return cloud;
+}
+
+// Squared distances of all points to x, sorted with their ids.
+static void SortByDistance(vtkPolyData *cloud, const double x[3],
+                           vtkstd::vector<vtkstd::pair<double, vtkIdType> >& d)
+{
+  d.resize(cloud->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < cloud->GetNumberOfPoints(); ++i)
+    {
+    d[i].first = vtkMath::Distance2BetweenPoints(x, cloud->GetPoint(i));
+    d[i].second = i;
+    }
+  vtkstd::sort(d.begin(), d.end());
+}
+
+static int CheckQueries(vtkPolyData *cloud, const char *name)
+{
+  VTK_CREATE(vtkStaticPointLocator, locator);
+  locator->SetDataSet(cloud);
+  locator->BuildLocator();
+  // Thin directions must not blow up the number of buckets.
+  if (locator->GetNumberOfBuckets() > cloud->GetNumberOfPoints())
+    {
+    cerr << name << ": " << locator->GetNumberOfBuckets() << " buckets"
+         << endl;
+    return 1;
+    }
+  VTK_CREATE(vtkIdList, ids);
+  vtkstd::vector<vtkstd::pair<double, vtkIdType> > d;
+
+  for (int q = 0; q < 200; ++q)
+    {
+    // Some query points lie well outside the cloud.
+    double x[3] = { vtkMath::Random(-0.5, 1.5), vtkMath::Random(-0.5, 2.5),
+                    vtkMath::Random(-1.5, 0.5) };
+    SortByDistance(cloud, x, d);
+
+    vtkIdType closest = locator->FindClosestPoint(x);
+    if (vtkMath::Distance2BetweenPoints(x, cloud->GetPoint(closest)) !=
+        d[0].first)
+      {
+      cerr << name << ": FindClosestPoint failed" << endl;
+      return 1;
+      }
+
+    double radius = 0.05 + 0.002*q;
+    double dist2;
+    closest = locator->FindClosestPointWithinRadius(radius, x, dist2);
+    if ((d[0].first <= radius*radius) != (closest >= 0) ||
+        (closest >= 0 && dist2 != d[0].first))
+      {
+      cerr << name << ": FindClosestPointWithinRadius failed" << endl;
+      return 1;
+      }
+
+    int N = 1 + q % 20;
+    locator->FindClosestNPoints(N, x, ids);
+    if (ids->GetNumberOfIds() != N)
+      {
+      cerr << name << ": FindClosestNPoints returned "
+           << ids->GetNumberOfIds() << " points" << endl;
+      return 1;
+      }
+    for (int i = 0; i < N; ++i)
+      {
+      if (ids->GetId(i) != d[i].second)
+        {
+        cerr << name << ": FindClosestNPoints failed" << endl;
+        return 1;
+        }
+      }
+
+    locator->FindPointsWithinRadius(radius, x, ids);
+    vtkIdType inside = 0;
+    while (inside < static_cast<vtkIdType>(d.size()) &&
+           d[inside].first <= radius*radius)
+      {
+      ++inside;
+      }
+    if (ids->GetNumberOfIds() != inside)
+      {
+      cerr << name << ": FindPointsWithinRadius returned "
+           << ids->GetNumberOfIds() << " points instead of " << inside
+           << endl;
+      return 1;
+      }
+    }
+
+  VTK_CREATE(vtkPolyData, representation);
+  locator->GenerateRepresentation(0, representation);
+  if (representation->GetNumberOfCells() == 0)
+    {
+    cerr << name << ": empty representation" << endl;
+    return 1;
+    }
+  return 0;
+}
+
+static void TimeLocator(vtkAbstractPointLocator *locator, vtkPolyData *cloud,
+                        const char *name)
+{
+  VTK_CREATE(vtkTimerLog, timer);
+  locator->SetDataSet(cloud);
+  timer->StartTimer();
+  locator->BuildLocator();
+  timer->StopTimer();
+  double build = timer->GetElapsedTime();
+
+  const int numQueries = 100000;
+  VTK_CREATE(vtkIdList, ids);
+  vtkMath::RandomSeed(1234);
+  timer->StartTimer();
+  for (int q = 0; q < numQueries; ++q)
+    {
+    double x[3] = { vtkMath::Random(), vtkMath::Random(0.0, 2.0),
+                    vtkMath::Random(-1.0, 0.0) };
+    locator->FindClosestPoint(x);
+    }
+  timer->StopTimer();
+  double closest = timer->GetElapsedTime();
+
+  timer->StartTimer();
+  for (int q = 0; q < numQueries / 10; ++q)
+    {
+    double x[3] = { vtkMath::Random(), vtkMath::Random(0.0, 2.0),
+                    vtkMath::Random(-1.0, 0.0) };
+    locator->FindClosestNPoints(10, x, ids);
+    }
+  timer->StopTimer();
+  double closestN = timer->GetElapsedTime();
+
+  cout << name << ": build " << build << " s, " << numQueries
+       << " closest point queries " << closest << " s, " << numQueries / 10
+       << " closest 10 points queries " << closestN << " s" << endl;
+}
+
+int TestStaticPointLocator(int argc, char *argv[])
+{
+  vtkIdType numPts = 200000;
+  for (int i = 1; i + 1 < argc; ++i)
+    {
+    if (strcmp(argv[i], "-n") == 0)
+      {
+      numPts = atol(argv[i+1]);
+      }
+    }
+
+  int errors = 0;
+  vtkMath::RandomSeed(5678);
+  vtkPolyData *cloud = MakeCloud(2000, 0);
+  errors += CheckQueries(cloud, "volume");
+  cloud->Delete();
+  cloud = MakeCloud(2000, 1);
+  errors += CheckQueries(cloud, "plane");
+  cloud->Delete();
+  cloud = MakeCloud(2000, 1, 1);
+  errors += CheckQueries(cloud, "almost plane");
+  cloud->Delete();
+
+  cloud = MakeCloud(numPts, 0);
+  cout << numPts << " points" << endl;
+  VTK_CREATE(vtkPointLocator, pointLocator);
+  TimeLocator(pointLocator, cloud, "vtkPointLocator");
+  VTK_CREATE(vtkKdTreePointLocator, kdTreeLocator);
+  TimeLocator(kdTreeLocator, cloud, "vtkKdTreePointLocator");
+  VTK_CREATE(vtkStaticPointLocator, staticLocator);
+  TimeLocator(staticLocator, cloud, "vtkStaticPointLocator");
+  cloud->Delete();
+
+  return errors ? 1 : 0;
+}
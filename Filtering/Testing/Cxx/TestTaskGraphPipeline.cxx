@@ -0,0 +1,260 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTaskGraphPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test and benchmark of vtkTaskGraphPipeline
+// .SECTION Description
+// Builds a pipeline that fans out from one source into three elevation
+// filters, which declare that they can read their input concurrently,
+// followed by a contour, a slice and a glyph filter, and appends the
+// branches again.  The pipeline is updated with vtkCompositeDataPipeline
+// and with vtkTaskGraphPipeline, through the append filter and through
+// UpdateAll() on the three branches, and the outputs must agree.
+// Releasing data must fall back to the recursive order.  Then prints the
+// update times of both executives for a larger source, whose resolution
+// can be given as the first argument, e.g. 1000 for a benchmark; the
+// default keeps the test fast.
+
+#include "vtkAppendPolyData.h"
+#include "vtkCompositeDataPipeline.h"
+#include "vtkConeSource.h"
+#include "vtkContourFilter.h"
+#include "vtkCutter.h"
+#include "vtkElevationFilter.h"
+#include "vtkExecutiveCollection.h"
+#include "vtkGlyph3D.h"
+#include "vtkInformation.h"
+#include "vtkObjectFactory.h"
+#include "vtkPlane.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTaskGraphPipeline.h"
+#include "vtkTimerLog.h"
+
+#include <stdlib.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// An elevation filter that declares that it can read its input while
+// other filters read it.
+class vtkTaskGraphElevationFilter : public vtkElevationFilter
+{
+public:
+  static vtkTaskGraphElevationFilter* New();
+  vtkTypeMacro(vtkTaskGraphElevationFilter, vtkElevationFilter);
+
+protected:
+  vtkTaskGraphElevationFilter()
+    {
+    this->GetInformation()->Set(
+      vtkCompositeDataPipeline::REQUEST_DATA_THREAD_SAFE(), 1);
+    }
+};
+
+vtkStandardNewMacro(vtkTaskGraphElevationFilter);
+
+// The source, the three branches and the append filter joining them.
+class FanOutPipeline
+{
+public:
+  FanOutPipeline(int resolution)
+    {
+    this->Sphere = vtkSmartPointer<vtkSphereSource>::New();
+    this->Sphere->SetThetaResolution(resolution);
+    this->Sphere->SetPhiResolution(resolution);
+    for (int i = 0; i < 3; ++i)
+      {
+      this->Elevation[i] = vtkSmartPointer<vtkTaskGraphElevationFilter>::New();
+      this->Elevation[i]->SetInputConnection(this->Sphere->GetOutputPort());
+      this->Elevation[i]->SetLowPoint(-0.5*(i == 0), -0.5*(i == 1),
+                                      -0.5*(i == 2));
+      this->Elevation[i]->SetHighPoint(0.5*(i == 0), 0.5*(i == 1),
+                                       0.5*(i == 2));
+      }
+
+    this->Contour = vtkSmartPointer<vtkContourFilter>::New();
+    this->Contour->SetInputConnection(this->Elevation[0]->GetOutputPort());
+    this->Contour->GenerateValues(9, 0.1, 0.9);
+
+    VTK_CREATE(vtkPlane, plane);
+    plane->SetNormal(1.0, 1.0, 0.0);
+    this->Slice = vtkSmartPointer<vtkCutter>::New();
+    this->Slice->SetInputConnection(this->Elevation[1]->GetOutputPort());
+    this->Slice->SetCutFunction(plane);
+
+    this->Cone = vtkSmartPointer<vtkConeSource>::New();
+    this->Cone->SetResolution(8);
+    this->Cone->SetHeight(0.02);
+    this->Cone->SetRadius(0.01);
+    this->Glyph = vtkSmartPointer<vtkGlyph3D>::New();
+    this->Glyph->SetInputConnection(this->Elevation[2]->GetOutputPort());
+    this->Glyph->SetSourceConnection(this->Cone->GetOutputPort());
+
+    this->Append = vtkSmartPointer<vtkAppendPolyData>::New();
+    this->Append->AddInputConnection(this->Contour->GetOutputPort());
+    this->Append->AddInputConnection(this->Slice->GetOutputPort());
+    this->Append->AddInputConnection(this->Glyph->GetOutputPort());
+    }
+
+  vtkSmartPointer<vtkSphereSource> Sphere;
+  vtkSmartPointer<vtkTaskGraphElevationFilter> Elevation[3];
+  vtkSmartPointer<vtkContourFilter> Contour;
+  vtkSmartPointer<vtkCutter> Slice;
+  vtkSmartPointer<vtkConeSource> Cone;
+  vtkSmartPointer<vtkGlyph3D> Glyph;
+  vtkSmartPointer<vtkAppendPolyData> Append;
+};
+
+static int ComparePolyData(vtkPolyData* a, vtkPolyData* b, const char* name)
+{
+  if (a->GetNumberOfPoints() == 0 ||
+      a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    cerr << name << ": " << b->GetNumberOfPoints() << " points and "
+         << b->GetNumberOfCells() << " cells instead of "
+         << a->GetNumberOfPoints() << " and " << a->GetNumberOfCells()
+         << endl;
+    return 0;
+    }
+  double ba[6], bb[6];
+  a->GetBounds(ba);
+  b->GetBounds(bb);
+  for (int i = 0; i < 6; ++i)
+    {
+    if (ba[i] != bb[i])
+      {
+      cerr << name << ": the bounds differ" << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static int CompareBranches(FanOutPipeline& a, FanOutPipeline& b,
+                           const char* name)
+{
+  int ok = ComparePolyData(a.Contour->GetOutput(), b.Contour->GetOutput(),
+                           "Contour");
+  ok = ComparePolyData(a.Slice->GetOutput(), b.Slice->GetOutput(),
+                       "Slice") && ok;
+  ok = ComparePolyData(a.Glyph->GetOutput(), b.Glyph->GetOutput(),
+                       "Glyph") && ok;
+  if (!ok)
+    {
+    cerr << "The branches differ after " << name << endl;
+    }
+  return ok;
+}
+
+static void UseExecutive(vtkExecutive* prototype)
+{
+  vtkAlgorithm::SetDefaultExecutivePrototype(prototype);
+  prototype->Delete();
+}
+
+static vtkTaskGraphPipeline* GetTaskGraphPipeline(vtkAlgorithm* algorithm)
+{
+  return vtkTaskGraphPipeline::SafeDownCast(algorithm->GetExecutive());
+}
+
+int TestTaskGraphPipeline(int argc, char* argv[])
+{
+  vtkSMPTools::Initialize(4);
+  int ok = 1;
+
+  UseExecutive(vtkCompositeDataPipeline::New());
+  FanOutPipeline* reference = new FanOutPipeline(40);
+  reference->Append->Update();
+
+  UseExecutive(vtkTaskGraphPipeline::New());
+  FanOutPipeline* graph = new FanOutPipeline(40);
+  graph->Append->Update();
+  ok = CompareBranches(*reference, *graph, "updating the append filter") &&
+       ok;
+  ok = ComparePolyData(reference->Append->GetOutput(),
+                       graph->Append->GetOutput(), "Append") && ok;
+  // the sphere, three elevation, contour, slice, cone and glyph filters
+  int numTasks = GetTaskGraphPipeline(graph->Append)->GetLastNumberOfTasks();
+  if (numTasks != 8)
+    {
+    cerr << "Updating the append filter ran " << numTasks
+         << " tasks instead of 8" << endl;
+    ok = 0;
+    }
+
+  // the branches are sinks of their own, the up to date cone is skipped
+  reference->Sphere->SetThetaResolution(50);
+  reference->Append->Update();
+  graph->Sphere->SetThetaResolution(50);
+  VTK_CREATE(vtkExecutiveCollection, sinks);
+  sinks->AddItem(graph->Contour->GetExecutive());
+  sinks->AddItem(graph->Slice->GetExecutive());
+  sinks->AddItem(graph->Glyph->GetExecutive());
+  if (!vtkTaskGraphPipeline::UpdateAll(sinks))
+    {
+    cerr << "UpdateAll failed" << endl;
+    ok = 0;
+    }
+  ok = CompareBranches(*reference, *graph, "UpdateAll") && ok;
+  numTasks = GetTaskGraphPipeline(graph->Glyph)->GetLastNumberOfTasks();
+  if (numTasks != 7)
+    {
+    cerr << "UpdateAll ran " << numTasks << " tasks instead of 7" << endl;
+    ok = 0;
+    }
+
+  // released inputs cannot be shared between branches running at once
+  reference->Sphere->SetThetaResolution(30);
+  reference->Append->Update();
+  graph->Sphere->SetThetaResolution(30);
+  graph->Elevation[1]->ReleaseDataFlagOn();
+  graph->Append->Update();
+  ok = CompareBranches(*reference, *graph, "releasing data") && ok;
+  numTasks = GetTaskGraphPipeline(graph->Append)->GetLastNumberOfTasks();
+  if (numTasks != 0)
+    {
+    cerr << "Released data ran " << numTasks << " tasks instead of none"
+         << endl;
+    ok = 0;
+    }
+  delete reference;
+  delete graph;
+
+  int resolution = (argc > 1 ? atoi(argv[1]) : 0);
+  if (resolution < 8)
+    {
+    resolution = 200;
+    }
+  const char* names[2] = { "vtkCompositeDataPipeline",
+                           "vtkTaskGraphPipeline" };
+  VTK_CREATE(vtkTimerLog, timer);
+  for (int mode = 0; mode < 2; ++mode)
+    {
+    UseExecutive(mode ? vtkTaskGraphPipeline::New() :
+                 vtkCompositeDataPipeline::New());
+    FanOutPipeline* pipeline = new FanOutPipeline(resolution);
+    timer->StartTimer();
+    pipeline->Append->Update();
+    timer->StopTimer();
+    cout << "Sphere resolution " << resolution << ", " << names[mode]
+         << ": " << timer->GetElapsedTime() << " s" << endl;
+    delete pipeline;
+    }
+
+  vtkAlgorithm::SetDefaultExecutivePrototype(0);
+  return ok ? 0 : 1;
+}
@@ -87,6 +87,32 @@ vtkAbstractInterpolatedVelocityField::~vtkAbstractInterpolatedVelocityField()
     }
 }
 
+//---------------------------------------------------------------------------
+void vtkAbstractInterpolatedVelocityField::ComputeTolerances()
+{
+  this->DataSets->Tolerances2.resize( this->DataSets->size() );
+  for ( size_t i = 0; i < this->DataSets->size(); i ++ )
+    {
+    this->DataSets->Tolerances2[i] = ( *this->DataSets )[i]->GetLength() *
+      vtkAbstractInterpolatedVelocityField::TOLERANCE_SCALE;
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkAbstractInterpolatedVelocityField::CopyTolerances
+  ( vtkAbstractInterpolatedVelocityField * from )
+{
+  if ( *from->DataSets == *this->DataSets &&
+       from->DataSets->Tolerances2.size() == from->DataSets->size() )
+    {
+    this->DataSets->Tolerances2 = from->DataSets->Tolerances2;
+    }
+  else
+    {
+    this->DataSets->Tolerances2.clear();
+    }
+}
+
 //---------------------------------------------------------------------------
 int vtkAbstractInterpolatedVelocityField::FunctionValues
   ( vtkDataSet * dataset, double * x, double * f )
@@ -111,8 +137,35 @@ int vtkAbstractInterpolatedVelocityField::FunctionValues
     return 0;
     }
 
-  double tol2 = dataset->GetLength() * 
-                vtkAbstractInterpolatedVelocityField::TOLERANCE_SCALE;
+  // Use the tolerance computed up front when there is one, so that the
+  // dataset is only read.
+  double tol2 = -1.0;
+  vtkAbstractInterpolatedVelocityFieldDataSetsType & dataSets =
+    *this->DataSets;
+  if ( dataSets.Tolerances2.size() == dataSets.size() )
+    {
+    if ( this->LastDataSetIndex >= 0 &&
+         this->LastDataSetIndex < static_cast<int>( dataSets.size() ) &&
+         dataSets[this->LastDataSetIndex] == dataset )
+      {
+      tol2 = dataSets.Tolerances2[this->LastDataSetIndex];
+      }
+    else
+      {
+      for ( size_t k = 0; k < dataSets.size() && tol2 < 0.0; k ++ )
+        {
+        if ( dataSets[k] == dataset )
+          {
+          tol2 = dataSets.Tolerances2[k];
+          }
+        }
+      }
+    }
+  if ( tol2 < 0.0 )
+    {
+    tol2 = dataset->GetLength() * 
+           vtkAbstractInterpolatedVelocityField::TOLERANCE_SCALE;
+    }
 
   int found = 0;
 
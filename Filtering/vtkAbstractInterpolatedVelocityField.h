@@ -153,6 +153,16 @@ public:
   // match is found. THIS FUNCTION DOES NOT CHANGE THE REFERENCE COUNT OF 
   // dataset FOR THREAD SAFETY REASONS.
   virtual void AddDataSet( vtkDataSet * dataset ) = 0;
+
+  // Description:
+  // Compute the cell search tolerance of every dataset added so far, or
+  // copy them from another velocity field with the same datasets. Until
+  // then FunctionValues() computes the tolerance from the dataset length
+  // on every call, which updates the cached bounds of the dataset. Either
+  // call is needed before the datasets are searched from several threads.
+  // Adding a dataset invalidates the tolerances.
+  void ComputeTolerances();
+  void CopyTolerances( vtkAbstractInterpolatedVelocityField * from );
   
   // Description:
   // Evaluate the velocity field f at point (x, y, z).
@@ -224,7 +234,12 @@ private:
 
 //BTX
 typedef vtkstd::vector< vtkDataSet * > DataSetsTypeBase;
-class   vtkAbstractInterpolatedVelocityFieldDataSetsType: public DataSetsTypeBase { };
+class   vtkAbstractInterpolatedVelocityFieldDataSetsType: public DataSetsTypeBase
+{
+public:
+  // Squared cell search tolerance of every dataset, see ComputeTolerances().
+  vtkstd::vector< double > Tolerances2;
+};
 //ETX
 
 #endif
@@ -116,6 +116,14 @@ vtkAlgorithm::~vtkAlgorithm()
   this->ProgressText = NULL;
 }
 
+//----------------------------------------------------------------------------
+void vtkAlgorithm::CopyParameters(vtkAlgorithm* from)
+{
+  // The copy must not share the input array information, which
+  // GetInputArrayInformation() fills in on demand.
+  this->Information->Copy(from->GetInformation(), 1);
+}
+
 //----------------------------------------------------------------------------
 // Update the progress of the process object. If a ProgressMethod exists,
 // executes it. Then set the Progress ivar to amount. The parameter amount
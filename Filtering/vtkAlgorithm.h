@@ -139,6 +139,12 @@ public:
   vtkGetObjectMacro(Information, vtkInformation);
   virtual void SetInformation(vtkInformation*);
 
+  // Description:
+  // Copy the parameters of another instance of the same class, such as
+  // the input arrays to process.  Used by executives that execute private
+  // copies of an algorithm.  Sub-classes can add more after chaining.
+  virtual void CopyParameters(vtkAlgorithm* from);
+
   // Description:
   // Get the number of input ports used by the algorithm.
   int GetNumberOfInputPorts();
@@ -23,18 +23,86 @@
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
 #include "vtkPointData.h"
 
+#include <string.h>
+
 vtkStandardNewMacro(vtkCachedStreamingDemandDrivenPipeline);
 
+//----------------------------------------------------------------------------
+// Returns 1 if the cached data were produced for the requested time.
+static int vtkCachedStreamingDemandDrivenPipelineSameTime(
+  vtkInformation* outInfo, vtkDataObject* data)
+{
+  vtkInformation* dataInfo = data->GetInformation();
+  if (!outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()) ||
+      !dataInfo->Has(vtkDataObject::DATA_TIME_STEPS()))
+    {
+    return 1;
+    }
+  int length =
+    outInfo->Length(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS());
+  if (length != dataInfo->Length(vtkDataObject::DATA_TIME_STEPS()))
+    {
+    return 0;
+    }
+  double* requested =
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS());
+  double* times = dataInfo->Get(vtkDataObject::DATA_TIME_STEPS());
+  for (int i = 0; i < length; ++i)
+    {
+    if (requested[i] != times[i])
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Copy the given extent of an array laid out over inExt into an array
+// laid out over outExt, one row at a time.
+static void vtkCachedStreamingDemandDrivenPipelineCopyExtent(
+  vtkDataArray* out, const int outExt[6],
+  vtkDataArray* in, const int inExt[6], const int ext[6])
+{
+  size_t tupleSize = in->GetDataTypeSize() * in->GetNumberOfComponents();
+  size_t rowSize = (ext[1] - ext[0] + 1) * tupleSize;
+  vtkIdType outRow = outExt[1] - outExt[0] + 1;
+  vtkIdType outSlice = outRow * (outExt[3] - outExt[2] + 1);
+  vtkIdType inRow = inExt[1] - inExt[0] + 1;
+  vtkIdType inSlice = inRow * (inExt[3] - inExt[2] + 1);
+  unsigned char* outPtr = static_cast<unsigned char*>(out->GetVoidPointer(0));
+  unsigned char* inPtr = static_cast<unsigned char*>(in->GetVoidPointer(0));
+  for (int z = ext[4]; z <= ext[5]; ++z)
+    {
+    for (int y = ext[2]; y <= ext[3]; ++y)
+      {
+      vtkIdType outId = (z - outExt[4]) * outSlice + (y - outExt[2]) * outRow +
+        (ext[0] - outExt[0]);
+      vtkIdType inId = (z - inExt[4]) * inSlice + (y - inExt[2]) * inRow +
+        (ext[0] - inExt[0]);
+      memcpy(outPtr + outId * tupleSize, inPtr + inId * tupleSize, rowSize);
+      }
+    }
+}
+
 
 //----------------------------------------------------------------------------
 vtkCachedStreamingDemandDrivenPipeline
 ::vtkCachedStreamingDemandDrivenPipeline()
 {
   this->CacheSize = 0;
+  this->CacheMemoryLimit = 0;
   this->Data = NULL;
   this->Times = NULL;
+  this->PartialHit = -1;
+  for (int i = 0; i < 6; ++i)
+    {
+    this->MissingExtent[i] = 0;
+    }
   
   this->SetCacheSize(10);
 }
@@ -57,6 +125,7 @@ void vtkCachedStreamingDemandDrivenPipeline::SetCacheSize(int size)
     }
   
   this->Modified();
+  this->PartialHit = -1;
   
   // free the old data
   for (idx = 0; idx < this->CacheSize; ++idx)
@@ -100,6 +169,7 @@ void vtkCachedStreamingDemandDrivenPipeline
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CacheSize: " << this->CacheSize << "\n";
+  os << indent << "CacheMemoryLimit: " << this->CacheMemoryLimit << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -164,6 +234,7 @@ int vtkCachedStreamingDemandDrivenPipeline
 
   // First look through the cached data to see if it is still valid.
   int i;
+  this->PartialHit = -1;
   unsigned long pmt = this->GetPipelineMTime();
   for (i = 0; i < this->CacheSize; ++i)
     {
@@ -221,11 +292,19 @@ int vtkCachedStreamingDemandDrivenPipeline
     int dataExtent[6];
     int updateExtent[6];
     outInfo->Get(UPDATE_EXTENT(), updateExtent);
+    if (updateExtent[0] > updateExtent[1] ||
+        updateExtent[2] > updateExtent[3] ||
+        updateExtent[4] > updateExtent[5])
+      {
+      return 1;
+      }
 
     // check to see if any data in the cache fits this request
     for (i = 0; i < this->CacheSize; ++i)
       {
-      if (this->Data[i])
+      if (this->Data[i] &&
+          vtkCachedStreamingDemandDrivenPipelineSameTime(outInfo,
+                                                         this->Data[i]))
         {
         dataInfo = this->Data[i]->GetInformation();
         dataInfo->Get(vtkDataObject::DATA_EXTENT(), dataExtent);
@@ -236,26 +315,31 @@ int vtkCachedStreamingDemandDrivenPipeline
              updateExtent[2] < dataExtent[2] ||
              updateExtent[3] > dataExtent[3] ||
              updateExtent[4] < dataExtent[4] ||
-             updateExtent[5] > dataExtent[5]) &&
-           (updateExtent[0] <= updateExtent[1] &&
-            updateExtent[2] <= updateExtent[3] &&
-            updateExtent[4] <= updateExtent[5]))
+             updateExtent[5] > dataExtent[5]))
           {
           // we have a match
-          // Pass this data to output.
+          // Pass this data to output.  The cached extent may be larger
+          // than the request, which spares copying it.
           vtkImageData *id = vtkImageData::SafeDownCast(dataObject);
           vtkImageData *id2 = vtkImageData::SafeDownCast(this->Data[i]);
           if (id && id2)
             {
             id->SetExtent(dataExtent);
             id->GetPointData()->PassData(id2->GetPointData());
+            id->GetCellData()->PassData(id2->GetCellData());
+            id->GetInformation()->CopyEntry(
+              dataInfo, vtkDataObject::DATA_TIME_STEPS());
             // not sure if we need this
             dataObject->DataHasBeenGenerated();
+            this->Times[i] = dataObject->GetUpdateTime();
             return 0;
             }
           }
         }
       }
+
+    // Otherwise maybe only a slab is missing.
+    this->FindPartialHit(outInfo, updateExtent);
     }
   
   // We do need to execute
@@ -279,13 +363,233 @@ int vtkCachedStreamingDemandDrivenPipeline
   // first do the ususal thing
   int result = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
   
+  vtkInformation* outInfo = outInfoVec->GetInformationObject(0);
+  vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
+  vtkInformation* inInfo = inInfoVec[0]->GetInformationObject(0);
+  vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
+
+  vtkImageData *id = vtkImageData::SafeDownCast(dataObject);  
+  vtkImageData *inputImage = vtkImageData::SafeDownCast(input);
+  if (id && inputImage)
+    {
+    int updateExtent[6];
+    outInfo->Get(UPDATE_EXTENT(), updateExtent);
+    if (this->PartialHit < 0 ||
+        !this->StitchOutput(id, updateExtent, inputImage))
+      {
+      id->SetExtent(inputImage->GetExtent());
+      id->GetPointData()->PassData(inputImage->GetPointData());
+      id->GetCellData()->PassData(inputImage->GetCellData());
+      }
+    id->DataHasBeenGenerated();
+    }
+  this->PartialHit = -1;
+
   // then save the newly generated data
+  if (this->CacheSize > 0)
+    {
+    this->InsertIntoCache(dataObject, input);
+    }
+  
+  return result;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline
+::CopyDefaultInformation(vtkInformation* request, int direction,
+                         vtkInformationVector** inInfoVec,
+                         vtkInformationVector* outInfoVec)
+{
+  this->Superclass::CopyDefaultInformation(request, direction,
+                                           inInfoVec, outInfoVec);
+
+  // Only ask the input for what the cache does not have.
+  if (request->Has(REQUEST_UPDATE_EXTENT()) && this->PartialHit >= 0 &&
+      this->GetNumberOfInputPorts() > 0 &&
+      inInfoVec[0]->GetNumberOfInformationObjects() > 0)
+    {
+    vtkInformation* inInfo = inInfoVec[0]->GetInformationObject(0);
+    inInfo->Set(UPDATE_EXTENT(), this->MissingExtent, 6);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline
+::FindPartialHit(vtkInformation* outInfo, int updateExtent[6])
+{
+  vtkIdType bestSize = 0;
+  for (int i = 0; i < this->CacheSize; ++i)
+    {
+    vtkImageData *id = vtkImageData::SafeDownCast(this->Data[i]);
+    if (!id || id->GetCellData()->GetNumberOfArrays() > 0 ||
+        !vtkCachedStreamingDemandDrivenPipelineSameTime(outInfo, id))
+      {
+      continue;
+      }
+
+    // The overlap must span the request along all the axes but one, and
+    // reach one end of the request along that one.
+    int* dataExtent = id->GetExtent();
+    int missing[6];
+    int axis = -1;
+    int a;
+    for (a = 0; a < 3; ++a)
+      {
+      int lo = updateExtent[2*a];
+      int hi = updateExtent[2*a+1];
+      missing[2*a] = lo;
+      missing[2*a+1] = hi;
+      if (dataExtent[2*a] <= lo && dataExtent[2*a+1] >= hi)
+        {
+        continue;
+        }
+      if (axis >= 0 || dataExtent[2*a] > hi || dataExtent[2*a+1] < lo)
+        {
+        break;
+        }
+      axis = a;
+      if (dataExtent[2*a] <= lo)
+        {
+        missing[2*a] = dataExtent[2*a+1] + 1;
+        }
+      else if (dataExtent[2*a+1] >= hi)
+        {
+        missing[2*a+1] = dataExtent[2*a] - 1;
+        }
+      else
+        {
+        break;
+        }
+      }
+    if (a < 3 || axis < 0)
+      {
+      continue;
+      }
+
+    vtkIdType size = 1;
+    for (a = 0; a < 3; ++a)
+      {
+      size *= updateExtent[2*a+1] - updateExtent[2*a] + 1;
+      }
+    size -= static_cast<vtkIdType>(missing[1] - missing[0] + 1) *
+      (missing[3] - missing[2] + 1) * (missing[5] - missing[4] + 1);
+    if (size > bestSize)
+      {
+      bestSize = size;
+      this->PartialHit = i;
+      for (a = 0; a < 6; ++a)
+        {
+        this->MissingExtent[a] = missing[a];
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCachedStreamingDemandDrivenPipeline
+::StitchOutput(vtkImageData* output, int updateExtent[6], vtkImageData* input)
+{
+  vtkImageData* cached = vtkImageData::SafeDownCast(this->Data[this->PartialHit]);
+  int* inExt = input->GetExtent();
+  int* cachedExt = cached->GetExtent();
+  int overlap[6];
+  int i;
+  for (i = 0; i < 3; ++i)
+    {
+    if (inExt[2*i] > this->MissingExtent[2*i] ||
+        inExt[2*i+1] < this->MissingExtent[2*i+1])
+      {
+      return 0;
+      }
+    overlap[2*i] = (cachedExt[2*i] > updateExtent[2*i]) ?
+      cachedExt[2*i] : updateExtent[2*i];
+    overlap[2*i+1] = (cachedExt[2*i+1] < updateExtent[2*i+1]) ?
+      cachedExt[2*i+1] : updateExtent[2*i+1];
+    }
+
+  // Every array of the input must be cached with the same layout.
+  vtkPointData* inPD = input->GetPointData();
+  vtkPointData* cachedPD = cached->GetPointData();
+  if (input->GetCellData()->GetNumberOfArrays() > 0 ||
+      inPD->GetNumberOfArrays() != cachedPD->GetNumberOfArrays())
+    {
+    return 0;
+    }
+  for (i = 0; i < inPD->GetNumberOfArrays(); ++i)
+    {
+    vtkDataArray* inArray = inPD->GetArray(i);
+    vtkDataArray* cachedArray = cachedPD->GetArray(i);
+    if (!inArray || !cachedArray || inArray->GetDataTypeSize() == 0 ||
+        inArray->GetDataType() != cachedArray->GetDataType() ||
+        inArray->GetNumberOfComponents() !=
+        cachedArray->GetNumberOfComponents())
+      {
+      return 0;
+      }
+    }
+
+  output->SetExtent(updateExtent);
+  vtkIdType numPts = output->GetNumberOfPoints();
+  vtkPointData* outPD = output->GetPointData();
+  outPD->Initialize();
+  output->GetCellData()->Initialize();
+  for (i = 0; i < inPD->GetNumberOfArrays(); ++i)
+    {
+    vtkDataArray* inArray = inPD->GetArray(i);
+    vtkDataArray* outArray = inArray->NewInstance();
+    outArray->SetName(inArray->GetName());
+    outArray->SetNumberOfComponents(inArray->GetNumberOfComponents());
+    outArray->SetNumberOfTuples(numPts);
+    vtkCachedStreamingDemandDrivenPipelineCopyExtent(
+      outArray, updateExtent, cachedPD->GetArray(i), cachedExt, overlap);
+    vtkCachedStreamingDemandDrivenPipelineCopyExtent(
+      outArray, updateExtent, inArray, inExt, this->MissingExtent);
+    int idx = outPD->AddArray(outArray);
+    int attribute = inPD->IsArrayAnAttribute(i);
+    if (attribute >= 0)
+      {
+      outPD->SetActiveAttribute(idx, attribute);
+      }
+    outArray->Delete();
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline
+::InsertIntoCache(vtkDataObject* dataObject, vtkDataObject* input)
+{
+  vtkImageData *id = vtkImageData::SafeDownCast(dataObject);
+  int i;
+
+  // Images covered by the new one will not be used anymore.
+  if (id)
+    {
+    int* ext = id->GetExtent();
+    for (i = 0; i < this->CacheSize; ++i)
+      {
+      vtkImageData *id2 = vtkImageData::SafeDownCast(this->Data[i]);
+      int* ext2 = id2 ? id2->GetExtent() : 0;
+      if (ext2 &&
+          ext2[0] >= ext[0] && ext2[1] <= ext[1] &&
+          ext2[2] >= ext[2] && ext2[3] <= ext[3] &&
+          ext2[4] >= ext[4] && ext2[5] <= ext[5] &&
+          vtkCachedStreamingDemandDrivenPipelineSameTime(
+            dataObject->GetPipelineInformation(), id2))
+        {
+        id2->Delete();
+        this->Data[i] = NULL;
+        this->Times[i] = 0;
+        }
+      }
+    }
+
   unsigned long bestTime = VTK_LARGE_INTEGER;
   int bestIdx = 0;
   
   // Save the image in cache.
   // Find a spot to put the data.
-  for (int i = 0; i < this->CacheSize; ++i)
+  for (i = 0; i < this->CacheSize; ++i)
     {
     if (this->Data[i] == NULL)
       {
@@ -300,24 +604,11 @@ int vtkCachedStreamingDemandDrivenPipeline
       }
     }
 
-  vtkInformation* outInfo = outInfoVec->GetInformationObject(0);
-  vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
   if (this->Data[bestIdx] == NULL)
     {
     this->Data[bestIdx] = dataObject->NewInstance();
     }
   this->Data[bestIdx]->ReleaseData();
-
-  vtkImageData *id = vtkImageData::SafeDownCast(dataObject);  
-  if (id)
-    {
-    vtkInformation* inInfo = inInfoVec[0]->GetInformationObject(0);
-    vtkImageData *input = 
-      vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
-    id->SetExtent(input->GetExtent());
-    id->GetPointData()->PassData(input->GetPointData());
-    id->DataHasBeenGenerated();
-    }
   
   vtkImageData *id2 = vtkImageData::SafeDownCast(this->Data[bestIdx]);
   if (id && id2)
@@ -326,11 +617,44 @@ int vtkCachedStreamingDemandDrivenPipeline
     id2->SetScalarType(id->GetScalarType());
     id2->SetNumberOfScalarComponents(
       id->GetNumberOfScalarComponents());
-    id2->GetPointData()->SetScalars(
-      id->GetPointData()->GetScalars());
+    id2->GetPointData()->PassData(id->GetPointData());
+    id2->GetCellData()->PassData(id->GetCellData());
+    }
+  if (input)
+    {
+    this->Data[bestIdx]->GetInformation()->CopyEntry(
+      input->GetInformation(), vtkDataObject::DATA_TIME_STEPS());
     }
   
   this->Times[bestIdx] = dataObject->GetUpdateTime();
-  
-  return result;
+
+  // Drop the least recently used images beyond the memory limit.
+  if (this->CacheMemoryLimit == 0)
+    {
+    return;
+    }
+  for (;;)
+    {
+    unsigned long size = 0;
+    int oldest = -1;
+    for (i = 0; i < this->CacheSize; ++i)
+      {
+      if (this->Data[i])
+        {
+        size += this->Data[i]->GetActualMemorySize();
+        if (i != bestIdx &&
+            (oldest < 0 || this->Times[i] < this->Times[oldest]))
+          {
+          oldest = i;
+          }
+        }
+      }
+    if (size <= this->CacheMemoryLimit || oldest < 0)
+      {
+      return;
+      }
+    this->Data[oldest]->Delete();
+    this->Data[oldest] = NULL;
+    this->Times[oldest] = 0;
+    }
 }
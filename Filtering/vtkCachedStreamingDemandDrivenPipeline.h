@@ -14,7 +14,11 @@
 =========================================================================*/
 // .NAME vtkCachedStreamingDemandDrivenPipeline -
 // .SECTION Description
-// vtkCachedStreamingDemandDrivenPipeline
+// vtkCachedStreamingDemandDrivenPipeline keeps the images its algorithm
+// produced.  A request contained in a cached image of the same time step
+// is answered with that image, which may be larger than the request.
+// When a cached image covers all of a request but one slab, only the slab
+// is requested from the input and the two are stitched together.
 
 #ifndef __vtkCachedStreamingDemandDrivenPipeline_h
 #define __vtkCachedStreamingDemandDrivenPipeline_h
@@ -23,6 +27,7 @@
 
 class vtkInformationIntegerKey;
 class vtkInformationIntegerVectorKey;
+class vtkImageData;
 class vtkCachedStreamingDemandDrivenPipelineInternals;
 
 class VTK_FILTERING_EXPORT vtkCachedStreamingDemandDrivenPipeline : 
@@ -45,6 +50,13 @@ public:
   void SetCacheSize(int size);
   vtkGetMacro(CacheSize, int);
 
+  // Description:
+  // The maximum memory in kilobytes kept in the cache.  The least
+  // recently used images are dropped first.  It defaults to 0, which
+  // limits the cache by CacheSize only.
+  vtkSetMacro(CacheMemoryLimit, unsigned long);
+  vtkGetMacro(CacheMemoryLimit, unsigned long);
+
 protected:
   vtkCachedStreamingDemandDrivenPipeline();
   ~vtkCachedStreamingDemandDrivenPipeline();
@@ -55,12 +67,37 @@ protected:
   virtual int ExecuteData(vtkInformation* request,
                           vtkInformationVector** inInfoVec,
                           vtkInformationVector* outInfoVec);
-  
+  virtual void CopyDefaultInformation(vtkInformation* request, int direction,
+                                      vtkInformationVector** inInfoVec,
+                                      vtkInformationVector* outInfoVec);
+
+  // Description:
+  // Find the cached image that covers the most of the update extent while
+  // leaving a single slab to compute.  Sets PartialHit and MissingExtent.
+  void FindPartialHit(vtkInformation* outInfo, int updateExtent[6]);
+
+  // Description:
+  // Fill the update extent of the output from the partial hit and the
+  // input.  Returns 0 if their arrays do not match.
+  int StitchOutput(vtkImageData* output, int updateExtent[6],
+                   vtkImageData* input);
+
+  // Description:
+  // Keep the output in the cache, dropping the images it covers and the
+  // least recently used ones beyond the limits.
+  void InsertIntoCache(vtkDataObject* output, vtkDataObject* input);
+
   int CacheSize;
+  unsigned long CacheMemoryLimit;
   
   vtkDataObject **Data;
   unsigned long *Times;
 
+  // The cached image completed by the current request, or -1, and the
+  // extent requested from the input to complete it.
+  int PartialHit;
+  int MissingExtent[6];
+
 private:
   vtkCachedStreamingDemandDrivenPipelineInternals* CachedStreamingDemandDrivenInternal;
 private:
@@ -24,6 +24,9 @@ vtkCellArray::vtkCellArray()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->Offsets = NULL;
+  this->Connectivity = NULL;
+  this->TraversalCellId = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -36,24 +39,68 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
     }
 
   this->Ia->DeepCopy(ca->Ia);
+  if (ca->Offsets)
+    {
+    if (!this->Offsets)
+      {
+      this->Offsets = vtkIdTypeArray::New();
+      this->Connectivity = vtkIdTypeArray::New();
+      }
+    this->Offsets->DeepCopy(ca->Offsets);
+    this->Connectivity->DeepCopy(ca->Connectivity);
+    }
+  else
+    {
+    this->ReleaseOffsetsStorage();
+    }
   this->NumberOfCells = ca->NumberOfCells;
   this->InsertLocation = ca->InsertLocation;
   this->TraversalLocation = ca->TraversalLocation;
+  this->TraversalCellId = ca->TraversalCellId;
 }
 
 //----------------------------------------------------------------------------
 vtkCellArray::~vtkCellArray()
 {
   this->Ia->Delete();
+  this->ReleaseOffsetsStorage();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseOffsetsStorage()
+{
+  if (this->Offsets)
+    {
+    this->Offsets->Delete();
+    this->Offsets = NULL;
+    this->Connectivity->Delete();
+    this->Connectivity = NULL;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReplaceLegacyArray()
+{
+  // Whoever still holds the old list (from GetData() for example) keeps
+  // its contents, as with SetCells().
+  this->Ia->Delete();
+  this->Ia = vtkIdTypeArray::New();
 }
 
 //----------------------------------------------------------------------------
 void vtkCellArray::Initialize()
 {
   this->Ia->Initialize();
+  if (this->Offsets)
+    {
+    this->Connectivity->Initialize();
+    this->Offsets->Initialize();
+    this->Offsets->InsertNextValue(0);
+    }
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -63,6 +110,20 @@ int vtkCellArray::GetMaxCellSize()
 {
   int i, npts=0, maxSize=0;
 
+  if (this->Offsets)
+    {
+    vtkIdType *offsets = this->Offsets->GetPointer(0);
+    for (vtkIdType cellId=0; cellId < this->NumberOfCells; cellId++)
+      {
+      if ( (npts=static_cast<int>(offsets[cellId+1]-offsets[cellId]))
+           > maxSize )
+        {
+        maxSize = npts;
+        }
+      }
+    return maxSize;
+    }
+
   for (i=0; i<this->Ia->GetMaxId(); i+=(npts+1))
     {
     if ( (npts=this->Ia->GetValue(i)) > maxSize )
@@ -80,6 +141,7 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
   if ( cells && cells != this->Ia )
     {
     this->Modified();
+    this->ReleaseOffsetsStorage();
     this->Ia->Delete();
     this->Ia = cells;
     this->Ia->Register(this);
@@ -90,10 +152,165 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkCellArray::SetData(vtkIdTypeArray *offsets,
+                           vtkIdTypeArray *connectivity)
+{
+  if ( !offsets || !connectivity || offsets->GetNumberOfTuples() < 1 )
+    {
+    vtkErrorMacro("Offsets storage needs an offsets array with at least "
+                  "one entry and a connectivity array.");
+    return;
+    }
+  if ( offsets->GetValue(0) != 0 ||
+       offsets->GetValue(offsets->GetMaxId()) !=
+       connectivity->GetMaxId() + 1 )
+    {
+    vtkErrorMacro("The offsets must start at 0 and end at the size of the "
+                  "connectivity array.");
+    return;
+    }
+
+  // Register before releasing in case the arrays are our own.
+  offsets->Register(this);
+  connectivity->Register(this);
+  this->ReleaseOffsetsStorage();
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  this->ReplaceLegacyArray();
+
+  this->NumberOfCells = offsets->GetMaxId();
+  this->InsertLocation = connectivity->GetMaxId() + 1 + this->NumberOfCells;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertToOffsetsStorage()
+{
+  if (this->Offsets)
+    {
+    return;
+    }
+
+  vtkIdType numCells = this->NumberOfCells;
+  vtkIdType size = this->Ia->GetMaxId() + 1;
+  this->Offsets = vtkIdTypeArray::New();
+  this->Connectivity = vtkIdTypeArray::New();
+  vtkIdType *offsets = this->Offsets->WritePointer(0, numCells + 1);
+  vtkIdType *conn = this->Connectivity->WritePointer(0, size - numCells);
+
+  vtkIdType *ia = this->Ia->GetPointer(0);
+  vtkIdType loc = 0, end = 0;
+  for (vtkIdType cellId=0; cellId < numCells; cellId++)
+    {
+    vtkIdType npts = ia[loc++];
+    if (loc + npts > size)
+      {
+      // A cell started with InsertNextCell(int) that is still incomplete.
+      npts = size - loc;
+      }
+    offsets[cellId] = end;
+    for (vtkIdType i=0; i < npts; i++)
+      {
+      conn[end++] = ia[loc++];
+      }
+    }
+  offsets[numCells] = end;
+
+  this->Connectivity->SetNumberOfTuples(end);
+  this->TraversalCellId = this->FindCell(this->TraversalLocation);
+  this->ReplaceLegacyArray();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertToLegacyStorage()
+{
+  if (!this->Offsets)
+    {
+    return;
+    }
+
+  vtkDebugMacro(<< "Converting " << this->NumberOfCells << " cells from "
+                << "offsets storage to the legacy list, the cell pointers "
+                << "returned before are invalid.");
+  vtkIdType numCells = this->NumberOfCells;
+  vtkIdType *offsets = this->Offsets->GetPointer(0);
+  vtkIdType *conn = this->Connectivity->GetPointer(0);
+  vtkIdType *ia = this->Ia->WritePointer(0, offsets[numCells] + numCells);
+  for (vtkIdType cellId=0; cellId < numCells; cellId++)
+    {
+    vtkIdType npts = offsets[cellId+1] - offsets[cellId];
+    *ia++ = npts;
+    for (vtkIdType i=0; i < npts; i++)
+      {
+      *ia++ = *conn++;
+      }
+    }
+  this->ReleaseOffsetsStorage();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::FindCell(vtkIdType loc)
+{
+  // The location of cell i is offsets[i]+i, which increases strictly with i.
+  vtkIdType *offsets = this->Offsets->GetPointer(0);
+  vtkIdType low = 0;
+  vtkIdType high = this->NumberOfCells;
+  while (low < high)
+    {
+    vtkIdType mid = low + (high - low) / 2;
+    if (offsets[mid] + mid < loc)
+      {
+      low = mid + 1;
+      }
+    else
+      {
+      high = mid;
+      }
+    }
+  return low;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellLocation(vtkIdType cellId)
+{
+  if (this->Offsets)
+    {
+    return this->Offsets->GetValue(cellId) + cellId;
+    }
+
+  vtkIdType *ia = this->Ia->GetPointer(0);
+  vtkIdType loc = 0;
+  for (vtkIdType i=0; i < cellId; i++)
+    {
+    loc += ia[loc] + 1;
+    }
+  return loc;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Squeeze()
+{
+  this->Ia->Squeeze();
+  if (this->Offsets)
+    {
+    this->Offsets->Squeeze();
+    this->Connectivity->Squeeze();
+    }
+}
+
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  unsigned long size = this->Ia->GetActualMemorySize();
+  if (this->Offsets)
+    {
+    size += this->Offsets->GetActualMemorySize() +
+      this->Connectivity->GetActualMemorySize();
+    }
+  return size;
 }
 
 //----------------------------------------------------------------------------
@@ -115,8 +332,8 @@ int vtkCellArray::GetNextCell(vtkIdList *pts)
 //----------------------------------------------------------------------------
 void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
 {
-  vtkIdType npts = this->Ia->GetValue(loc++);
-  vtkIdType *ppts = this->Ia->GetPointer(loc);
+  vtkIdType npts, *ppts;
+  this->GetCell(loc, npts, ppts);
   pts->SetNumberOfIds(npts);
   for (vtkIdType i = 0; i < npts; i++)
     {
@@ -132,4 +349,6 @@ void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
   os << indent << "Insert Location: " << this->InsertLocation << endl;
   os << indent << "Traversal Location: " << this->TraversalLocation << endl;
+  os << indent << "Storage: "
+     << (this->Offsets ? "Offsets" : "Legacy") << endl;
 }
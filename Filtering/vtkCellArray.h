@@ -26,6 +26,30 @@
 // using the vtkCellTypes and vtkCellLinks objects to extend the definition of
 // the data structure.
 //
+// Alternatively the cells can be stored as two arrays: a connectivity
+// array with the point ids of all cells, and an offsets array of
+// NumberOfCells+1 entries where cell i uses the point ids
+// connectivity[offsets[i]] to connectivity[offsets[i+1]-1].  With this
+// offsets storage GetCellAtId() finds a cell in constant time, and since
+// the offsets of a set of cells are a prefix sum of their sizes, cells can
+// be written in parallel.  SetData() wraps existing offsets and
+// connectivity arrays without copying them (use vtkIdTypeArray::SetArray()
+// with save=1 to wrap memory owned by the caller).
+//
+// All other methods work with either storage.  Locations (see GetCell(),
+// GetInsertLocation() and GetTraversalLocation()) are always positions in
+// the (n,id1,id2,...) list, so they stay valid when the storage is
+// converted; with offsets storage, looking a cell up by location is a
+// binary search.  GetPointer(), GetData(), WritePointer() and SetCells()
+// expose the (n,id1,id2,...) list and convert offsets storage back to it.
+// That conversion copies the whole connectivity and drops the offsets
+// arrays: the pointers returned by GetCellAtId() and GetNextCell() become
+// invalid, and cells are found by walking the list again.  vtkPolyData
+// and vtkUnstructuredGrid read offsets storage by cell index and never
+// convert it, so code that only goes through them and GetCellAtId(),
+// GetNextCell() or GetOffsetsArray()/GetConnectivityArray() keeps the
+// constant time access.
+//
 // .SECTION See Also
 // vtkCellTypes vtkCellLinks
 
@@ -50,7 +74,10 @@ public:
   // Description:
   // Allocate memory and set the size to extend by.
   int Allocate(const vtkIdType sz, const int ext=1000)
-    {return this->Ia->Allocate(sz,ext);}
+    {
+    return (this->Offsets ? this->Connectivity->Allocate(sz,ext) :
+            this->Ia->Allocate(sz,ext));
+    }
 
   // Description:
   // Free any memory and reset to an empty state.
@@ -78,7 +105,7 @@ public:
   // Description:
   // A cell traversal methods that is more efficient than vtkDataSet traversal
   // methods.  InitTraversal() initializes the traversal of the list of cells.
-  void InitTraversal() {this->TraversalLocation=0;};
+  void InitTraversal() {this->TraversalLocation=0; this->TraversalCellId=0;};
 
   // Description:
   // A cell traversal methods that is more efficient than vtkDataSet traversal
@@ -95,14 +122,23 @@ public:
   // Description:
   // Get the size of the allocated connectivity array.
   vtkIdType GetSize()
-    {return this->Ia->GetSize();}
+    {
+    return (this->Offsets ?
+            this->Connectivity->GetSize() + this->Offsets->GetSize() :
+            this->Ia->GetSize());
+    }
 
   // Description:
   // Get the total number of entries (i.e., data values) in the connectivity
   // array. This may be much less than the allocated size (i.e., return value
-  // from GetSize().)
+  // from GetSize().)  With offsets storage this is the number of entries the
+  // (n,id1,id2,...) list would have.
   vtkIdType GetNumberOfConnectivityEntries()
-    {return this->Ia->GetMaxId()+1;}
+    {
+    return (this->Offsets ?
+            this->Connectivity->GetMaxId() + 1 + this->NumberOfCells :
+            this->Ia->GetMaxId() + 1);
+    }
 
   // Description:
   // Internal method used to retrieve a cell given an offset into
@@ -114,6 +150,45 @@ public:
   // the internal array.
   void GetCell(vtkIdType loc, vtkIdList* pts);
 
+  // Description:
+  // Retrieve the cell with the given index.  This takes constant time with
+  // offsets storage and walks the cells with the legacy storage.  It does
+  // not modify the cell array, so several threads may call it at once.
+  // pts is valid until the cells change or the storage is converted.
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, vtkIdType* &pts);
+
+  // Description:
+  // Return the location of the cell with the given index, see
+  // GetCellAtId().
+  vtkIdType GetCellLocation(vtkIdType cellId);
+
+  // Description:
+  // Use the given arrays as offsets storage, sharing them rather than
+  // copying them.  offsets must hold one entry more than there are cells,
+  // starting with 0 and ending with the number of values in connectivity.
+  // As with SetCells(), anything referring to the old cells becomes
+  // invalid.
+  void SetData(vtkIdTypeArray *offsets, vtkIdTypeArray *connectivity);
+
+  // Description:
+  // Convert between the legacy (n,id1,id2,...) list and offsets storage.
+  // Cell locations stay valid.
+  void ConvertToOffsetsStorage();
+  void ConvertToLegacyStorage();
+
+  // Description:
+  // Return 1 if the cells are in offsets storage.
+  int IsStorageOffsets()
+    {return (this->Offsets ? 1 : 0);}
+
+  // Description:
+  // Access the offsets and connectivity arrays of the offsets storage,
+  // converting to offsets storage first if needed.
+  vtkIdTypeArray *GetOffsetsArray()
+    {this->ConvertToOffsetsStorage(); return this->Offsets;}
+  vtkIdTypeArray *GetConnectivityArray()
+    {this->ConvertToOffsetsStorage(); return this->Connectivity;}
+
   // Description:
   // Insert a cell object. Return the cell id of the cell.
   vtkIdType InsertNextCell(vtkCell *cell);
@@ -156,7 +231,13 @@ public:
   vtkIdType GetTraversalLocation()
     {return this->TraversalLocation;}
   void SetTraversalLocation(vtkIdType loc)
-    {this->TraversalLocation = loc;}
+    {
+    this->TraversalLocation = loc;
+    if (this->Offsets)
+      {
+      this->TraversalCellId = this->FindCell(loc);
+      }
+    }
 
   // Description:
   // Computes the current traversal location within the internal array. Used
@@ -179,9 +260,12 @@ public:
   int GetMaxCellSize();
 
   // Description:
-  // Get pointer to array of cell data.
+  // Get pointer to array of cell data.  With offsets storage this first
+  // converts the cells to the legacy list, in time and memory linear in
+  // the size of the connectivity, which invalidates the cell pointers
+  // returned before.
   vtkIdType *GetPointer()
-    {return this->Ia->GetPointer(0);}
+    {this->ConvertToLegacyStorage(); return this->Ia->GetPointer(0);}
 
   // Description:
   // Get pointer to data array for purpose of direct writes of data. Size is the
@@ -204,9 +288,12 @@ public:
   void DeepCopy(vtkCellArray *ca);
 
   // Description:
-  // Return the underlying data as a data array.
+  // Return the underlying data as a data array.  With offsets storage
+  // this first converts the cells to the legacy list, like GetPointer().
+  // A caller that keeps the array must Register() it: converting to
+  // offsets storage later replaces it with a new array.
   vtkIdTypeArray* GetData()
-    {return this->Ia;}
+    {this->ConvertToLegacyStorage(); return this->Ia;}
 
   // Description:
   // Reuse list. Reset to initial condition.
@@ -214,8 +301,7 @@ public:
 
   // Description:
   // Reclaim any extra memory.
-  void Squeeze()
-    {this->Ia->Squeeze();}
+  void Squeeze();
 
   // Description:
   // Return the memory in kilobytes consumed by this cell array. Used to
@@ -230,11 +316,30 @@ protected:
   vtkCellArray();
   ~vtkCellArray();
 
+  // Description:
+  // Index of the cell at location loc of offsets storage, or NumberOfCells
+  // for the end of the list.
+  vtkIdType FindCell(vtkIdType loc);
+
+  // Description:
+  // Drop the offsets storage arrays, if any.
+  void ReleaseOffsetsStorage();
+
+  // Description:
+  // Give up the legacy list for a new, empty one when switching to
+  // offsets storage.
+  void ReplaceLegacyArray();
+
   vtkIdType NumberOfCells;
   vtkIdType InsertLocation;     //keep track of current insertion point
   vtkIdType TraversalLocation;   //keep track of traversal position
   vtkIdTypeArray *Ia;
 
+  // Offsets storage, both NULL with the legacy storage.
+  vtkIdTypeArray *Offsets;
+  vtkIdTypeArray *Connectivity;
+  vtkIdType TraversalCellId;
+
 private:
   vtkCellArray(const vtkCellArray&);  // Not implemented.
   void operator=(const vtkCellArray&);  // Not implemented.
@@ -245,10 +350,22 @@ private:
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType* pts)
 {
-  vtkIdType i = this->Ia->GetMaxId() + 1;
-  vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
+  vtkIdType i;
+  vtkIdType *ptr;
+  if (this->Offsets)
+    {
+    i = this->Connectivity->GetMaxId() + 1;
+    ptr = this->Connectivity->WritePointer(i, npts);
+    this->Offsets->InsertNextValue(i + npts);
+    }
+  else
+    {
+    i = this->Ia->GetMaxId() + 1;
+    ptr = this->Ia->WritePointer(i, npts+1);
+    *ptr++ = npts;
+    }
 
-  for ( *ptr++ = npts, i = 0; i < npts; i++)
+  for (i = 0; i < npts; i++)
     {
     *ptr++ = *pts++;
     }
@@ -262,7 +379,17 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
-  this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
+  if (this->Offsets)
+    {
+    // The cell grows as points are inserted, so its count is implicit.
+    vtkIdType end = this->Connectivity->GetMaxId() + 1;
+    this->Offsets->InsertNextValue(end);
+    this->InsertLocation = end + this->NumberOfCells + 1;
+    }
+  else
+    {
+    this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
+    }
   this->NumberOfCells++;
 
   return this->NumberOfCells - 1;
@@ -271,13 +398,25 @@ inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 //----------------------------------------------------------------------------
 inline void vtkCellArray::InsertCellPoint(vtkIdType id)
 {
-  this->Ia->InsertValue(this->InsertLocation++, id);
+  if (this->Offsets)
+    {
+    this->Offsets->SetValue(this->NumberOfCells,
+                            this->Connectivity->InsertNextValue(id) + 1);
+    this->InsertLocation++;
+    }
+  else
+    {
+    this->Ia->InsertValue(this->InsertLocation++, id);
+    }
 }
 
 //----------------------------------------------------------------------------
 inline void vtkCellArray::UpdateCellCount(int npts)
 {
-  this->Ia->SetValue(this->InsertLocation-npts-1, npts);
+  if (!this->Offsets)
+    {
+    this->Ia->SetValue(this->InsertLocation-npts-1, npts);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -299,14 +438,46 @@ inline void vtkCellArray::Reset()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
   this->Ia->Reset();
+  if (this->Offsets)
+    {
+    this->Connectivity->Reset();
+    this->Offsets->Reset();
+    this->Offsets->InsertNextValue(0);
+    }
+}
+
+//----------------------------------------------------------------------------
+inline void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                                      vtkIdType* &pts)
+{
+  if (this->Offsets)
+    {
+    vtkIdType *offsets = this->Offsets->GetPointer(cellId);
+    npts = offsets[1] - offsets[0];
+    pts = this->Connectivity->GetPointer(offsets[0]);
+    }
+  else
+    {
+    this->GetCell(this->GetCellLocation(cellId), npts, pts);
+    }
 }
 
 //----------------------------------------------------------------------------
 inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 {
-  if ( this->Ia->GetMaxId() >= 0 &&
-       this->TraversalLocation <= this->Ia->GetMaxId() )
+  if (this->Offsets)
+    {
+    if (this->TraversalCellId < this->NumberOfCells)
+      {
+      this->GetCellAtId(this->TraversalCellId++, npts, pts);
+      this->TraversalLocation += npts + 1;
+      return 1;
+      }
+    }
+  else if ( this->Ia->GetMaxId() >= 0 &&
+            this->TraversalLocation <= this->Ia->GetMaxId() )
     {
     npts = this->Ia->GetValue(this->TraversalLocation++);
     pts = this->Ia->GetPointer(this->TraversalLocation);
@@ -322,6 +493,11 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
                                   vtkIdType* &pts)
 {
+  if (this->Offsets)
+    {
+    this->GetCellAtId(this->FindCell(loc), npts, pts);
+    return;
+    }
   npts = this->Ia->GetValue(loc++);
   pts  = this->Ia->GetPointer(loc);
 }
@@ -331,8 +507,9 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 {
   int i;
   vtkIdType tmp;
-  vtkIdType npts=this->Ia->GetValue(loc);
-  vtkIdType *pts=this->Ia->GetPointer(loc+1);
+  vtkIdType npts;
+  vtkIdType *pts;
+  this->GetCell(loc, npts, pts);
   for (i=0; i < (npts/2); i++)
     {
     tmp = pts[i];
@@ -345,7 +522,9 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
                                       const vtkIdType *pts)
 {
-  vtkIdType *oldPts=this->Ia->GetPointer(loc+1);
+  vtkIdType oldNpts;
+  vtkIdType *oldPts;
+  this->GetCell(loc, oldNpts, oldPts);
   for (int i=0; i < npts; i++)
     {
     oldPts[i] = pts[i];
@@ -356,6 +535,7 @@ inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
 inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
                                              const vtkIdType size)
 {
+  this->ConvertToLegacyStorage();
   this->NumberOfCells = ncells;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
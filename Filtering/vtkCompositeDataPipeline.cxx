@@ -17,7 +17,9 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkAlgorithm.h"
 #include "vtkAlgorithmOutput.h"
 #include "vtkCompositeDataIterator.h"
+#include "vtkFieldData.h"
 #include "vtkImageData.h"
+#include "vtkInformationDataObjectKey.h"
 #include "vtkInformationDoubleKey.h"
 #include "vtkInformationExecutivePortKey.h"
 #include "vtkInformationExecutivePortVectorKey.h"
@@ -25,19 +27,26 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkInformationIdTypeKey.h"
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationIntegerVectorKey.h"
+#include "vtkInformationIterator.h"
 #include "vtkInformationKey.h"
 #include "vtkInformationObjectBaseKey.h"
 #include "vtkInformationStringKey.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStructuredGrid.h"
 #include "vtkTemporalDataSet.h"
+#include "vtkTrivialProducer.h"
 #include "vtkUniformGrid.h"
 
+#include <vtkstd/vector>
+
 //----------------------------------------------------------------------------
 #if defined (JB_DEBUG1)
   #ifndef WIN32
@@ -88,12 +97,95 @@ vtkInformationKeyMacro(vtkCompositeDataPipeline, COMPOSITE_DATA_META_DATA, Objec
 vtkInformationKeyMacro(vtkCompositeDataPipeline, UPDATE_COMPOSITE_INDICES, IntegerVector);
 vtkInformationKeyMacro(vtkCompositeDataPipeline, COMPOSITE_INDICES, IntegerVector);
 vtkInformationKeyMacro(vtkCompositeDataPipeline, COMPOSITE_INDEX, Integer);
+vtkInformationKeyMacro(vtkCompositeDataPipeline, REQUEST_DATA_THREAD_SAFE, Integer);
+
+//----------------------------------------------------------------------------
+// The private pipeline information of a block executed concurrently.
+class vtkCompositeDataPipelineBlock
+{
+public:
+  vtkSmartPointer<vtkInformation> Request;
+  vtkstd::vector<vtkSmartPointer<vtkInformationVector> > Inputs;
+  vtkstd::vector<vtkInformationVector*> InputPointers;
+  vtkSmartPointer<vtkInformationVector> Outputs;
+  vtkSmartPointer<vtkTrivialProducer> Producer;
+  int Result;
+};
+
+//----------------------------------------------------------------------------
+// Executes REQUEST_DATA for a range of blocks.  Every thread executes its
+// blocks with a private copy of the algorithm, since the algorithm's own
+// state, such as its progress, must not be shared between threads.
+class vtkCompositeDataPipelineBlockFunctor
+{
+public:
+  vtkAlgorithm* Algorithm;
+  vtkCompositeDataPipelineBlock* Blocks;
+  vtkSMPThreadLocal<vtkAlgorithm*> Copies;
+  vtkSimpleMutexLock Lock;
+
+  void Initialize()
+    {
+    // The copies are made one at a time, as their constructors may use
+    // shared state such as the object factories.
+    this->Lock.Lock();
+    vtkAlgorithm* copy = this->Algorithm->NewInstance();
+    copy->CopyParameters(this->Algorithm);
+    this->Lock.Unlock();
+    this->Copies.Local() = copy;
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkAlgorithm* copy = this->Copies.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkCompositeDataPipelineBlock& block = this->Blocks[i];
+      block.Result = copy->ProcessRequest(
+        block.Request, &block.InputPointers[0], block.Outputs);
+      }
+    }
+
+  void Reduce()
+    {
+    for (vtkSMPThreadLocal<vtkAlgorithm*>::iterator it = this->Copies.begin();
+         it != this->Copies.end(); ++it)
+      {
+      (*it)->Delete();
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Copy the information of a port without its links to the executives of
+// the pipeline, so that releasing the copy does not make the garbage
+// collector walk the whole pipeline.  The data object is copied only if
+// copyData is set.
+static void vtkCompositeDataPipelineCopyPort(vtkInformation* from,
+                                             vtkInformation* to,
+                                             int copyData)
+{
+  vtkInformationIterator* iter = vtkInformationIterator::New();
+  iter->SetInformationWeak(from);
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem())
+    {
+    vtkInformationKey* key = iter->GetCurrentKey();
+    if (key != vtkExecutive::PRODUCER() && key != vtkExecutive::CONSUMERS() &&
+        (copyData || key != vtkDataObject::DATA_OBJECT()))
+      {
+      to->CopyEntry(from, key);
+      }
+    }
+  iter->Delete();
+}
 
 //----------------------------------------------------------------------------
 vtkCompositeDataPipeline::vtkCompositeDataPipeline()
 {
   this->InLocalLoop = 0;
   this->SuppressResetPipelineInformation = 0;
+  this->ConcurrentBlockExecution = 0;
   this->InformationCache = vtkInformation::New();
 
   this->GenericRequest = vtkInformation::New();
@@ -644,7 +736,10 @@ void vtkCompositeDataPipeline::ExecuteSimpleAlgorithm(
     vtkSmartPointer<vtkCompositeDataIterator> iter;
     iter.TakeReference(input->NewIterator());
     iter->VisitOnlyLeavesOn();
-    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); 
+    int concurrent = this->ExecuteSimpleAlgorithmConcurrently(
+      inInfoVec, outInfoVec, inInfo, outInfo, r, input, compositeOutput,
+      times, numTimeSteps);
+    for (iter->InitTraversal(); !concurrent && !iter->IsDoneWithTraversal();
       iter->GoToNextItem())
       {
       // if it is a temporal input, set the time for each piece
@@ -727,6 +822,190 @@ vtkDataObject* vtkCompositeDataPipeline::ExecuteSimpleAlgorithmForBlock(
     return 0;
     }
 
+  int storedPiece[2];
+  this->PrepareSimpleAlgorithmForBlock(inInfoVec, outInfoVec, inInfo, outInfo,
+                                       request, dobj, storedPiece);
+
+  request->Set(REQUEST_DATA());
+  this->Superclass::ExecuteData(request,inInfoVec,outInfoVec);
+  request->Remove(REQUEST_DATA());
+  
+  this->RestoreSimpleAlgorithmPiece(storedPiece);
+
+  vtkDataObject* output = outInfo->Get(vtkDataObject::DATA_OBJECT());
+  if (!output)
+    {
+    return 0;
+    }
+  vtkDataObject* outputCopy = output->NewInstance();
+  outputCopy->ShallowCopy(output);
+  return outputCopy;
+}
+
+//----------------------------------------------------------------------------
+// Execute REQUEST_DATA for all the leaves at once.  The passes before it
+// change the pipeline information of this executive, so they still run
+// for one leaf after another, and the information they leave behind is
+// copied for each leaf.
+int vtkCompositeDataPipeline::ExecuteSimpleAlgorithmConcurrently(
+  vtkInformationVector** inInfoVec,
+  vtkInformationVector* outInfoVec,
+  vtkInformation* inInfo,
+  vtkInformation* outInfo,
+  vtkInformation* request,
+  vtkCompositeDataSet* input,
+  vtkCompositeDataSet* compositeOutput,
+  double* times, int numTimeSteps)
+{
+  // Only the first output is collected in the composite output.
+  if (!this->ConcurrentBlockExecution ||
+      !this->Algorithm->GetInformation()->Get(REQUEST_DATA_THREAD_SAFE()) ||
+      this->Algorithm->GetNumberOfOutputPorts() != 1)
+    {
+    return 0;
+    }
+
+  vtkDebugMacro(<< "ExecuteSimpleAlgorithmConcurrently");
+
+  int numInputPorts = this->Algorithm->GetNumberOfInputPorts();
+  vtkstd::vector<vtkCompositeDataPipelineBlock> blocks;
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(input->NewIterator());
+  iter->VisitOnlyLeavesOn();
+  // Copying the blocks when the vector grows is slow, since releasing a
+  // copy makes the garbage collector check the objects it refers to.
+  size_t numBlocks = 0;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem())
+    {
+    numBlocks += (iter->GetCurrentDataObject() ? 1 : 0);
+    }
+  blocks.reserve(numBlocks);
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem())
+    {
+    // if it is a temporal input, set the time for each piece
+    if (times)
+      {
+      outInfo->Set(UPDATE_TIME_STEPS(), times, numTimeSteps);
+      }
+    vtkDataObject* dobj = iter->GetCurrentDataObject();
+    if (!dobj)
+      {
+      continue;
+      }
+
+    int storedPiece[2];
+    this->PrepareSimpleAlgorithmForBlock(inInfoVec, outInfoVec, inInfo,
+                                         outInfo, request, dobj, storedPiece);
+
+    vtkCompositeDataPipelineBlock block;
+    block.Result = 0;
+    block.Request = vtkSmartPointer<vtkInformation>::New();
+    block.Request->Copy(request);
+    block.Request->Set(REQUEST_DATA());
+    for (int i = 0; i < numInputPorts; ++i)
+      {
+      vtkSmartPointer<vtkInformationVector> inputs =
+        vtkSmartPointer<vtkInformationVector>::New();
+      for (int j = 0; j < inInfoVec[i]->GetNumberOfInformationObjects(); ++j)
+        {
+        vtkInformation* info = vtkInformation::New();
+        vtkCompositeDataPipelineCopyPort(
+          inInfoVec[i]->GetInformationObject(j), info, 1);
+        inputs->Append(info);
+        info->Delete();
+        }
+      block.Inputs.push_back(inputs);
+      block.InputPointers.push_back(inputs);
+      }
+
+    // The block gets a new output of the type that REQUEST_DATA_OBJECT
+    // chose for it.  The output needs a producer of its own, since data
+    // objects such as vtkImageData that have none make one when they
+    // execute, and it is prepared the way ExecuteDataStart() prepares
+    // outputs.
+    block.Outputs = vtkSmartPointer<vtkInformationVector>::New();
+    vtkDataObject* output = outInfo->Get(vtkDataObject::DATA_OBJECT());
+    if (output)
+      {
+      vtkDataObject* blockOutput = output->NewInstance();
+      block.Producer = vtkSmartPointer<vtkTrivialProducer>::New();
+      block.Producer->SetOutput(blockOutput);
+      vtkInformation* blockOutInfo = blockOutput->GetPipelineInformation();
+      vtkCompositeDataPipelineCopyPort(outInfo, blockOutInfo, 0);
+      block.Outputs->Append(blockOutInfo);
+      blockOutput->CopyInformationFromPipeline(block.Request);
+      vtkDataObject* firstInput = (numInputPorts > 0 ?
+        this->GetInputData(0, 0) : 0);
+      if (firstInput && firstInput->GetFieldData())
+        {
+        blockOutput->GetFieldData()->PassData(firstInput->GetFieldData());
+        }
+      blockOutput->Delete();
+      }
+    else
+      {
+      block.Outputs->Append(vtkSmartPointer<vtkInformation>::New());
+      }
+
+    this->RestoreSimpleAlgorithmPiece(storedPiece);
+    blocks.push_back(block);
+    }
+
+  if (!blocks.empty())
+    {
+    vtkCompositeDataPipelineBlockFunctor functor;
+    functor.Algorithm = this->Algorithm;
+    functor.Blocks = &blocks[0];
+    // Requests made by the algorithm while it executes are errors.
+    this->InAlgorithm = 1;
+    vtkSMPTools::Reduce(0, static_cast<vtkIdType>(blocks.size()), 1,
+                        functor);
+    this->InAlgorithm = 0;
+    }
+
+  // Collect the outputs in the same order.
+  size_t next = 0;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem())
+    {
+    if (!iter->GetCurrentDataObject())
+      {
+      continue;
+      }
+    vtkCompositeDataPipelineBlock& block = blocks[next++];
+    if (!block.Result)
+      {
+      vtkErrorMacro("Algorithm " << this->Algorithm->GetClassName()
+                    << "(" << this->Algorithm
+                    << ") returned failure for block "
+                    << iter->GetCurrentFlatIndex());
+      }
+    vtkDataObject* output = block.Outputs->GetInformationObject(0)->Get(
+      vtkDataObject::DATA_OBJECT());
+    if (output)
+      {
+      output->Register(this);
+      output->SetPipelineInformation(0);
+      compositeOutput->SetDataSet(iter, output);
+      output->UnRegister(this);
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompositeDataPipeline::PrepareSimpleAlgorithmForBlock(
+  vtkInformationVector** inInfoVec,
+  vtkInformationVector* outInfoVec,
+  vtkInformation* inInfo,
+  vtkInformation* outInfo,
+  vtkInformation* request,
+  vtkDataObject* dobj,
+  int storedPiece[2])
+{
   double time = 0;
   int hasTime = outInfo->Length(UPDATE_TIME_STEPS());
   if (hasTime)
@@ -770,8 +1049,8 @@ vtkDataObject* vtkCompositeDataPipeline::ExecuteSimpleAlgorithmForBlock(
   this->Superclass::ExecuteInformation(request,inInfoVec,outInfoVec);
   request->Remove(REQUEST_INFORMATION());
   
-  int storedPiece = -1;
-  int storedNumPieces = -1;
+  storedPiece[0] = -1;
+  storedPiece[1] = -1;
   for(int m=0; m < this->Algorithm->GetNumberOfOutputPorts(); ++m)
     {
     vtkInformation* info = this->GetOutputInformation(m);
@@ -790,9 +1069,9 @@ vtkDataObject* vtkCompositeDataPipeline::ExecuteSimpleAlgorithmForBlock(
       info->Set(
         vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT_INITIALIZED(), 
         1);
-      storedPiece = 
+      storedPiece[0] = 
         info->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
-      storedNumPieces= 
+      storedPiece[1] = 
         info->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
       info->Set(
         vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(), 
@@ -813,34 +1092,25 @@ vtkDataObject* vtkCompositeDataPipeline::ExecuteSimpleAlgorithmForBlock(
   this->CallAlgorithm(request, vtkExecutive::RequestUpstream,
                       inInfoVec, outInfoVec);
   request->Remove(REQUEST_UPDATE_EXTENT());
-  
-  request->Set(REQUEST_DATA());
-  this->Superclass::ExecuteData(request,inInfoVec,outInfoVec);
-  request->Remove(REQUEST_DATA());
-  
+}
+
+//----------------------------------------------------------------------------
+void vtkCompositeDataPipeline::RestoreSimpleAlgorithmPiece(int storedPiece[2])
+{
   for(int m=0; m < this->Algorithm->GetNumberOfOutputPorts(); ++m)
     {
     vtkInformation* info = this->GetOutputInformation(m);
-    if (storedPiece!=-1)
+    if (storedPiece[0]!=-1)
       {
       info->Set(
         vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(), 
-        storedNumPieces);
+        storedPiece[1]);
       vtkDebugMacro(<< "UPDATE_PIECE_NUMBER() 0"  << " " << info);
       info->Set(
         vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(), 
-        storedPiece);
+        storedPiece[0]);
       }
     }
-
-  vtkDataObject* output = outInfo->Get(vtkDataObject::DATA_OBJECT());
-  if (!output)
-    {
-    return 0;
-    }
-  vtkDataObject* outputCopy = output->NewInstance();
-  outputCopy->ShallowCopy(output);
-  return outputCopy;
 }
 
 
@@ -1517,5 +1787,7 @@ void vtkCompositeDataPipeline::MarkOutputsGenerated(
 void vtkCompositeDataPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ConcurrentBlockExecution: "
+     << this->ConcurrentBlockExecution << endl;
 }
 
@@ -35,6 +35,12 @@
 // it will invoke the  vtkStreamingDemandDrivenPipeline passes in a loop, 
 // passing a different block each time and will collect the results in a 
 // composite dataset. 
+//
+// A simple filter that sets REQUEST_DATA_THREAD_SAFE() in its information
+// can run on several blocks at once: when ConcurrentBlockExecution is on,
+// the passes before REQUEST_DATA still run one block after another, but
+// the REQUEST_DATA passes of all the leaves are handed to vtkSMPTools,
+// which execute them with per-thread copies of the filter.
 // .SECTION See also
 //  vtkCompositeDataSet
 
@@ -116,6 +122,28 @@ public:
   // *** THIS IS AN EXPERIMENTAL FEATURE. IT MAY CHANGE WITHOUT NOTICE ***
   static vtkInformationIntegerKey* COMPOSITE_INDEX();
 
+  // Description:
+  // REQUEST_DATA_THREAD_SAFE() is set to 1 in the information of a simple
+  // (non-composite-aware) algorithm, vtkAlgorithm::GetInformation(), by
+  // algorithms whose RequestData() may run on several inputs at the same
+  // time in copies made by NewInstance() and CopyParameters(): it may
+  // only read its inputs and change the copy and its outputs, and
+  // CopyParameters() must copy every parameter it reads.
+  // vtkTaskGraphPipeline also lets such algorithms read an input at the
+  // same time as other algorithms.
+  static vtkInformationIntegerKey* REQUEST_DATA_THREAD_SAFE();
+
+  // Description:
+  // When on, and the algorithm sets REQUEST_DATA_THREAD_SAFE(), the
+  // leaves of a composite input are executed concurrently.  Every thread
+  // executes its leaves with its own copy of the algorithm, whose progress
+  // is not reported.  Every leaf gets private shallow copies of the input
+  // and output information and its own output data object, which are put
+  // back in the composite output once all leaves are done.  Off by default.
+  vtkSetMacro(ConcurrentBlockExecution, int);
+  vtkGetMacro(ConcurrentBlockExecution, int);
+  vtkBooleanMacro(ConcurrentBlockExecution, int);
+
 protected:
   vtkCompositeDataPipeline();
   ~vtkCompositeDataPipeline();
@@ -181,6 +209,34 @@ protected:
     vtkInformation* request,  
     vtkDataObject* dobj);
 
+  // Run the passes that precede REQUEST_DATA for one block, and restore
+  // the piece request that they changed.  ExecuteSimpleAlgorithmForBlock()
+  // runs REQUEST_DATA in between.
+  void PrepareSimpleAlgorithmForBlock(
+    vtkInformationVector** inInfoVec,
+    vtkInformationVector* outInfoVec,
+    vtkInformation* inInfo,
+    vtkInformation* outInfo,
+    vtkInformation* request,
+    vtkDataObject* dobj,
+    int storedPiece[2]);
+  void RestoreSimpleAlgorithmPiece(int storedPiece[2]);
+
+  // Execute REQUEST_DATA of the leaves of input concurrently and put the
+  // results in compositeOutput.  Returns 0 if the algorithm does not
+  // allow it, in which case nothing was done.
+  int ExecuteSimpleAlgorithmConcurrently(
+    vtkInformationVector** inInfoVec,
+    vtkInformationVector* outInfoVec,
+    vtkInformation* inInfo,
+    vtkInformation* outInfo,
+    vtkInformation* request,
+    vtkCompositeDataSet* input,
+    vtkCompositeDataSet* compositeOutput,
+    double* times, int numTimeSteps);
+
+  int ConcurrentBlockExecution;
+
   bool ShouldIterateOverInput(int& compositePort);
   bool ShouldIterateTemporalData(vtkInformation *request,
                                  vtkInformationVector** inInfoVec, 
@@ -253,6 +253,20 @@ vtkCell *vtkDataSet::FindAndGetCell (double x[3], vtkCell *cell,
   return cell;
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkDataSet::FindCell(double x[3], double tol2, vtkGenericCell *cell,
+                               double pcoords[3], double *weights)
+{
+  int subId;
+  vtkIdType cellId =
+    this->FindCell(x, NULL, cell, -1, tol2, subId, pcoords, weights);
+  if (cellId >= 0)
+    {
+    this->GetCell(cellId, cell);
+    }
+  return cellId;
+}
+
 //----------------------------------------------------------------------------
 void vtkDataSet::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
                                   vtkIdList *cellIds)
@@ -188,7 +188,19 @@ public:
                              vtkGenericCell *gencell, vtkIdType cellId,
                              double tol2, int& subId, double pcoords[3],
                              double *weights) = 0;
-  
+
+  // Description:
+  // Reentrant version of FindCell().  All the scratch space belongs to the
+  // caller: cell, which holds the found cell on return, pcoords, and
+  // weights (at least GetMaxCellSize() values).  The dataset itself is
+  // only read, so several threads can search it at once as long as each
+  // one passes its own cell and weights.  The default implementation
+  // calls the vtkGenericCell version of FindCell() above.
+  // THIS METHOD IS THREAD SAFE IF FIRST CALLED FROM A SINGLE THREAD AND
+  // THE DATASET IS NOT MODIFIED
+  virtual vtkIdType FindCell(double x[3], double tol2, vtkGenericCell *cell,
+                             double pcoords[3], double *weights);
+
   // Description:
   // Locate the cell that contains a point and return the cell. Also returns
   // the subcell id, parametric coordinates and weights for subsequent
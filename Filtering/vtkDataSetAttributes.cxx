@@ -736,12 +736,14 @@ void vtkDataSetAttributes::InterpolatePoint(vtkDataSetAttributes *fromPd,
                                             vtkIdType toId, vtkIdList *ptIds, 
                                             double *weights)
 {
-  int i;
-  for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End(); 
-      i=this->RequiredArrays.NextIndex())
+  // Walk the list by position instead of moving the iterator so that
+  // several threads may interpolate different points at the same time.
+  int numRequired = this->RequiredArrays.GetListSize();
+  for (int pos = 0; pos < numRequired; ++pos)
     {
-    vtkAbstractArray* fromArray = this->Data[this->TargetIndices[i]];    
-    fromArray->InterpolateTuple(toId, ptIds, fromPd->Data[i], weights);
+    int i = this->RequiredArrays.GetIndex(pos);
+    vtkAbstractArray* toArray = this->Data[this->TargetIndices[i]];
+    toArray->InterpolateTuple(toId, ptIds, fromPd->Data[i], weights);
     }
 }
 
@@ -483,6 +483,8 @@ public:
   // If the INTERPOLATION copy flag is set to 0 for an array, interpolation
   // is prevented. If the flag is set to 1, weighted interpolation occurs.
   // If the flag is set to 2, nearest neighbor interpolation is used.
+  // Several threads may interpolate different toIds at once, provided the
+  // destination arrays already hold all their tuples.
   void InterpolatePoint(vtkDataSetAttributes *fromPd, vtkIdType toId, 
                         vtkIdList *ids, double *weights);
   
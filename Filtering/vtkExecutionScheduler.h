@@ -31,10 +31,12 @@
 // thread/computing resources distributing
 // .SECTION Description
 // This is a class for balancing the computing resources throughout
-// the network
+// the network.  vtkTaskGraphPipeline schedules the execution of a
+// pipeline on the shared thread pool and should be used instead in new
+// code.
 
 // .SECTION See Also
-// vtkComputingResources vtkThreadedStreamingPipeline
+// vtkComputingResources vtkThreadedStreamingPipeline vtkTaskGraphPipeline
 
 #ifndef __vtkExecutionScheduler_h
 #define __vtkExecutionScheduler_h
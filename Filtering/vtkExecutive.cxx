@@ -16,6 +16,7 @@
 
 #include "vtkAlgorithm.h"
 #include "vtkAlgorithmOutput.h"
+#include "vtkCriticalSection.h"
 #include "vtkDataObject.h"
 #include "vtkGarbageCollector.h"
 #include "vtkInformation.h"
@@ -25,6 +26,7 @@
 #include "vtkInformationKeyVectorKey.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPipelineProfiler.h"
 #include "vtkSmartPointer.h"
 
 #include <vtkstd/vector>
@@ -42,6 +44,11 @@ vtkInformationKeyMacro(vtkExecutive, FROM_OUTPUT_PORT, Integer);
 vtkInformationKeyMacro(vtkExecutive, KEYS_TO_COPY, KeyVector);
 vtkInformationKeyMacro(vtkExecutive, PRODUCER, ExecutivePort);
 
+vtkPipelineProfiler* vtkExecutive::Profiler = 0;
+
+// Guards Profiler, which executives on several threads read.
+static vtkSimpleCriticalSection vtkExecutiveProfilerCritSect;
+
 //----------------------------------------------------------------------------
 class vtkExecutiveInternals
 {
@@ -742,11 +749,34 @@ int vtkExecutive::CallAlgorithm(vtkInformation* request, int direction,
   // Copy default information in the direction of information flow.
   this->CopyDefaultInformation(request, direction, inInfo, outInfo);
 
+  // Hold a reference so the profiler may be changed during the request.
+  vtkExecutiveProfilerCritSect.Lock();
+  vtkPipelineProfiler* profiler = vtkExecutive::Profiler;
+  if(profiler)
+    {
+    profiler->Register(0);
+    }
+  vtkExecutiveProfilerCritSect.Unlock();
+  vtkIdType record = -1;
+  if(profiler)
+    {
+    record = profiler->StartRequest(this, request, inInfo, outInfo);
+    }
+
   // Invoke the request on the algorithm.
   this->InAlgorithm = 1;
   int result = this->Algorithm->ProcessRequest(request, inInfo, outInfo);
   this->InAlgorithm = 0;
 
+  if(profiler)
+    {
+    if(record >= 0)
+      {
+      profiler->EndRequest(record, request, outInfo);
+      }
+    profiler->UnRegister(0);
+    }
+
   // If the algorithm failed report it now.
   if(!result)
     {
@@ -759,6 +789,32 @@ int vtkExecutive::CallAlgorithm(vtkInformation* request, int direction,
   return result;
 }
 
+//----------------------------------------------------------------------------
+void vtkExecutive::SetProfiler(vtkPipelineProfiler* profiler)
+{
+  if(profiler)
+    {
+    profiler->Register(0);
+    }
+  vtkExecutiveProfilerCritSect.Lock();
+  vtkPipelineProfiler* old = vtkExecutive::Profiler;
+  vtkExecutive::Profiler = profiler;
+  vtkExecutiveProfilerCritSect.Unlock();
+  if(old)
+    {
+    old->UnRegister(0);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineProfiler* vtkExecutive::GetProfiler()
+{
+  vtkExecutiveProfilerCritSect.Lock();
+  vtkPipelineProfiler* profiler = vtkExecutive::Profiler;
+  vtkExecutiveProfilerCritSect.Unlock();
+  return profiler;
+}
+
 //----------------------------------------------------------------------------
 int vtkExecutive::CheckAlgorithm(const char* method,
                                  vtkInformation* request)
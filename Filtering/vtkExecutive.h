@@ -38,6 +38,7 @@ class vtkInformationIntegerKey;
 class vtkInformationRequestKey;
 class vtkInformationKeyVectorKey;
 class vtkInformationVector;
+class vtkPipelineProfiler;
 
 class VTK_FILTERING_EXPORT vtkExecutive : public vtkObject
 {
@@ -180,6 +181,13 @@ public:
                             vtkInformationVector** inInfo,
                             vtkInformationVector* outInfo);
 
+  // Description:
+  // Set/Get the profiler recording the requests that all executives pass
+  // to their algorithms in CallAlgorithm().  The default, NULL, records
+  // nothing.
+  static void SetProfiler(vtkPipelineProfiler* profiler);
+  static vtkPipelineProfiler* GetProfiler();
+
 protected:
   vtkExecutive();
   ~vtkExecutive();
@@ -228,6 +236,8 @@ protected:
   vtkInformationVector** SharedInputInformation;
   vtkInformationVector* SharedOutputInformation;
 
+  static vtkPipelineProfiler* Profiler;
+
 private:
   // Store an information object for each output port of the algorithm.
   vtkInformationVector* OutputInformation;
@@ -352,6 +352,12 @@ public:
                              vtkGenericCell *gencell, vtkIdType cellId,
                              double tol2, int& subId, double pcoords[3],
                              double *weights);
+
+  // Description:
+  // Reentrant version of FindCell(), see vtkDataSet.
+  //BTX
+  using vtkDataSet::FindCell;
+  //ETX
   
   // Description:
   // Restore data object to initial state,
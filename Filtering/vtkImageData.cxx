@@ -632,6 +632,15 @@ void vtkImageData::GetCellBounds(vtkIdType cellId, double bounds[6])
 double *vtkImageData::GetPoint(vtkIdType ptId)
 {
   static double x[3];
+  this->GetPoint(ptId, x);
+  return x;
+}
+
+//----------------------------------------------------------------------------
+// Unlike GetPoint(ptId) this does not use a static buffer, so it may be
+// called from several threads at once.
+void vtkImageData::GetPoint(vtkIdType ptId, double x[3])
+{
   int i, loc[3];
   const double *origin = this->Origin;
   const double *spacing = this->Spacing;
@@ -646,7 +655,7 @@ double *vtkImageData::GetPoint(vtkIdType ptId)
   if (dims[0] == 0 || dims[1] == 0 || dims[2] == 0)
     {
     vtkErrorMacro("Requesting a point from an empty image.");
-    return x;
+    return;
     }
 
   // "loc" holds the point x,y,z indices
@@ -655,7 +664,7 @@ double *vtkImageData::GetPoint(vtkIdType ptId)
   switch (this->DataDescription)
     {
     case VTK_EMPTY:
-      return x;
+      return;
 
     case VTK_SINGLE_POINT:
       break;
@@ -698,8 +707,6 @@ double *vtkImageData::GetPoint(vtkIdType ptId)
     {
     x[i] = origin[i] + (loc[i]+extent[i*2]) * spacing[i];
     }
-
-  return x;
 }
 
 //----------------------------------------------------------------------------
@@ -822,6 +829,72 @@ vtkIdType vtkImageData::FindCell(double x[3], vtkCell *vtkNotUsed(cell),
   return this->ComputeCellId(idx);
 }
 
+//----------------------------------------------------------------------------
+// Only the origin, spacing and extent are read (not the cached bounds or
+// dimensions), so this can be called from several threads at once.
+vtkIdType vtkImageData::FindCell(double x[3], double tol2,
+                                 vtkGenericCell *cell, double pcoords[3],
+                                 double *weights)
+{
+  const int* extent = this->Extent;
+  const double* origin = this->Origin;
+  const double* spacing = this->Spacing;
+  int idx[3];
+  double r[3] = { 0.0, 0.0, 0.0 };
+  double dist2 = 0.0;
+  int numAxes = 0;
+
+  for (int i=0; i<3; i++)
+    {
+    int minIdx = extent[i*2];
+    int maxIdx = extent[i*2+1];
+    if ( minIdx > maxIdx )
+      {
+      return -1;
+      }
+
+    double loc = (minIdx == maxIdx ? minIdx :
+                  (x[i] - origin[i]) / spacing[i]);
+    idx[i] = vtkMath::Floor(loc);
+    double t = loc - idx[i];
+    if ( idx[i] < minIdx || minIdx == maxIdx )
+      {
+      idx[i] = minIdx;
+      t = 0.0;
+      }
+    else if ( idx[i] >= maxIdx )
+      {
+      idx[i] = maxIdx - 1;
+      t = 1.0;
+      }
+
+    // Distance to the clamped location.
+    double dist = x[i] - (origin[i] + (idx[i] + t)*spacing[i]);
+    dist2 += dist*dist;
+
+    // The parametric coordinates of pixels and lines only count the axes
+    // along which the image has more than one point.
+    if ( minIdx != maxIdx )
+      {
+      r[numAxes++] = t;
+      }
+    }
+
+  if ( dist2 > tol2 )
+    {
+    return -1;
+    }
+
+  vtkIdType cellId = this->ComputeCellId(idx);
+  this->GetCell(cellId, cell);
+  for (int i=0; i<3; i++)
+    {
+    pcoords[i] = r[i];
+    }
+  cell->InterpolateFunctions(pcoords, weights);
+  return cellId;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkImageData::FindAndGetCell(double x[3],
                                       vtkCell *vtkNotUsed(cell),
@@ -70,6 +70,9 @@ public:
     double x[3], vtkCell *cell, vtkGenericCell *gencell,
     vtkIdType cellId, double tol2, int& subId,
     double pcoords[3], double *weights);
+  virtual vtkIdType FindCell(
+    double x[3], double tol2, vtkGenericCell *cell, double pcoords[3],
+    double *weights);
   virtual vtkCell *FindAndGetCell(double x[3], vtkCell *cell, vtkIdType cellId,
                                   double tol2, int& subId, double pcoords[3],
                                   double *weights);
@@ -412,13 +415,6 @@ inline void vtkImageData::ComputeIncrements()
   this->ComputeIncrements(this->Increments);
 }
 
-//----------------------------------------------------------------------------
-inline void vtkImageData::GetPoint(vtkIdType id, double x[3])
-{
-  const double *p = this->GetPoint(id);
-  x[0] = p[0]; x[1] = p[1]; x[2] = p[2];
-}
-
 //----------------------------------------------------------------------------
 inline vtkIdType vtkImageData::GetNumberOfPoints()
 {
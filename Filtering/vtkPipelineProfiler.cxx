@@ -0,0 +1,413 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineProfiler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPipelineProfiler.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkExecutive.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStringArray.h"
+#include "vtkTable.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/map>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+#include <vtksys/ios/sstream>
+
+vtkStandardNewMacro(vtkPipelineProfiler);
+
+//----------------------------------------------------------------------------
+// The requests that are profiled, in the order of a pipeline update.
+static const char* vtkPipelineProfilerRequestNames[3] =
+{
+  "REQUEST_INFORMATION", "REQUEST_UPDATE_EXTENT", "REQUEST_DATA"
+};
+
+//----------------------------------------------------------------------------
+struct vtkPipelineProfilerRecord
+{
+  vtkstd::string Algorithm;
+  int Request;
+  int Thread;
+  double Start;
+  double Duration;
+  vtkIdType InputCells;
+  vtkIdType OutputCells;
+  unsigned long MemoryBefore;
+  long MemoryDelta;
+};
+
+//----------------------------------------------------------------------------
+// The records of all threads, and the threads numbered in the order they
+// were first seen.  Records are numbered by a serial number that Reset()
+// does not restart, FirstSerial being the number of Records[0].  All
+// members are protected by the lock.
+class vtkPipelineProfilerInternals
+{
+public:
+  vtkstd::vector<vtkPipelineProfilerRecord> Records;
+  vtkstd::vector<vtkMultiThreaderIDType> Threads;
+  vtkIdType FirstSerial;
+  vtkSimpleMutexLock Lock;
+
+  vtkPipelineProfilerInternals(): FirstSerial(0) {}
+
+  int GetThread(vtkMultiThreaderIDType id)
+    {
+    for(size_t i = 0; i < this->Threads.size(); ++i)
+      {
+      if(vtkMultiThreader::ThreadsEqual(this->Threads[i], id))
+        {
+        return static_cast<int>(i);
+        }
+      }
+    this->Threads.push_back(id);
+    return static_cast<int>(this->Threads.size() - 1);
+    }
+};
+
+//----------------------------------------------------------------------------
+// The totals of one algorithm and request type in the summary.
+struct vtkPipelineProfilerTotal
+{
+  vtkIdType Calls;
+  double Time;
+  vtkIdType InputCells;
+  vtkIdType OutputCells;
+  long MemoryDelta;
+  const vtkPipelineProfilerRecord* First;
+};
+
+typedef vtkstd::pair<vtkstd::string, int> vtkPipelineProfilerKey;
+typedef vtkstd::map<vtkPipelineProfilerKey, vtkPipelineProfilerTotal>
+  vtkPipelineProfilerTotals;
+
+static bool vtkPipelineProfilerLongerTime(
+  const vtkPipelineProfilerTotal* a, const vtkPipelineProfilerTotal* b)
+{
+  return a->Time > b->Time;
+}
+
+//----------------------------------------------------------------------------
+static vtkIdType vtkPipelineProfilerCountCells(vtkDataObject* data)
+{
+  if(vtkDataSet* ds = vtkDataSet::SafeDownCast(data))
+    {
+    return ds->GetNumberOfCells();
+    }
+  vtkIdType numCells = 0;
+  if(vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data))
+    {
+    vtkCompositeDataIterator* iter = cd->NewIterator();
+    for(iter->InitTraversal(); !iter->IsDoneWithTraversal();
+        iter->GoToNextItem())
+      {
+      numCells += vtkPipelineProfilerCountCells(
+        iter->GetCurrentDataObject());
+      }
+    iter->Delete();
+    }
+  return numCells;
+}
+
+//----------------------------------------------------------------------------
+static vtkIdType vtkPipelineProfilerCountCells(vtkInformationVector* infoVec)
+{
+  vtkIdType numCells = 0;
+  for(int i = 0; i < infoVec->GetNumberOfInformationObjects(); ++i)
+    {
+    vtkInformation* info = infoVec->GetInformationObject(i);
+    numCells += vtkPipelineProfilerCountCells(
+      info->Get(vtkDataObject::DATA_OBJECT()));
+    }
+  return numCells;
+}
+
+//----------------------------------------------------------------------------
+static unsigned long vtkPipelineProfilerMemorySize(vtkInformationVector* v)
+{
+  unsigned long size = 0;
+  for(int i = 0; i < v->GetNumberOfInformationObjects(); ++i)
+    {
+    vtkInformation* info = v->GetInformationObject(i);
+    if(vtkDataObject* data = info->Get(vtkDataObject::DATA_OBJECT()))
+      {
+      size += data->GetActualMemorySize();
+      }
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineProfiler::vtkPipelineProfiler()
+{
+  this->Internals = new vtkPipelineProfilerInternals;
+  this->Summary = vtkTable::New();
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineProfiler::~vtkPipelineProfiler()
+{
+  delete this->Internals;
+  this->Summary->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfRecords: " << this->GetNumberOfRecords() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::Reset()
+{
+  this->Internals->Lock.Lock();
+  this->Internals->FirstSerial +=
+    static_cast<vtkIdType>(this->Internals->Records.size());
+  this->Internals->Records.clear();
+  this->Internals->Threads.clear();
+  this->Internals->Lock.Unlock();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkPipelineProfiler::GetNumberOfRecords()
+{
+  this->Internals->Lock.Lock();
+  int numRecords = static_cast<int>(this->Internals->Records.size());
+  this->Internals->Lock.Unlock();
+  return numRecords;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPipelineProfiler::StartRequest(vtkExecutive* executive,
+                                            vtkInformation* request,
+                                            vtkInformationVector** inInfoVec,
+                                            vtkInformationVector* outInfoVec)
+{
+  vtkPipelineProfilerRecord record;
+  if(request->Has(vtkDemandDrivenPipeline::REQUEST_INFORMATION()))
+    {
+    record.Request = 0;
+    }
+  else if(request->Has(
+            vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_EXTENT()))
+    {
+    record.Request = 1;
+    }
+  else if(request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+    {
+    record.Request = 2;
+    }
+  else
+    {
+    return -1;
+    }
+
+  vtkAlgorithm* algorithm = executive->GetAlgorithm();
+  vtksys_ios::ostringstream name;
+  name << algorithm->GetClassName() << "(" << algorithm << ")";
+  record.Algorithm = name.str();
+  record.InputCells = 0;
+  if(record.Request == 2)
+    {
+    for(int i = 0; i < executive->GetNumberOfInputPorts(); ++i)
+      {
+      record.InputCells += vtkPipelineProfilerCountCells(inInfoVec[i]);
+      }
+    }
+  record.OutputCells = 0;
+  record.MemoryBefore = vtkPipelineProfilerMemorySize(outInfoVec);
+  record.MemoryDelta = 0;
+  record.Duration = 0.0;
+
+  // Start the clock last so that the profiler does not count itself.
+  record.Start = vtkTimerLog::GetUniversalTime();
+  this->Internals->Lock.Lock();
+  record.Thread =
+    this->Internals->GetThread(vtkMultiThreader::GetCurrentThreadID());
+  vtkIdType serial = this->Internals->FirstSerial +
+    static_cast<vtkIdType>(this->Internals->Records.size());
+  this->Internals->Records.push_back(record);
+  this->Internals->Lock.Unlock();
+  return serial;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::EndRequest(vtkIdType serial,
+                                     vtkInformation* request,
+                                     vtkInformationVector* outInfoVec)
+{
+  double end = vtkTimerLog::GetUniversalTime();
+  unsigned long memory = vtkPipelineProfilerMemorySize(outInfoVec);
+  vtkIdType outputCells = 0;
+  if(request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+    {
+    outputCells = vtkPipelineProfilerCountCells(outInfoVec);
+    }
+
+  this->Internals->Lock.Lock();
+  // The record is gone if Reset() was called while the algorithm executed.
+  vtkIdType index = serial - this->Internals->FirstSerial;
+  if(index >= 0 &&
+     index < static_cast<vtkIdType>(this->Internals->Records.size()))
+    {
+    vtkPipelineProfilerRecord& record = this->Internals->Records[index];
+    record.Duration = end - record.Start;
+    record.OutputCells = outputCells;
+    record.MemoryDelta = static_cast<long>(memory) -
+      static_cast<long>(record.MemoryBefore);
+    }
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkTable* vtkPipelineProfiler::GetSummary()
+{
+  this->Internals->Lock.Lock();
+  vtkstd::vector<vtkPipelineProfilerRecord> records =
+    this->Internals->Records;
+  this->Internals->Lock.Unlock();
+
+  vtkPipelineProfilerTotals totals;
+  for(size_t i = 0; i < records.size(); ++i)
+    {
+    const vtkPipelineProfilerRecord& record = records[i];
+    vtkPipelineProfilerKey key(record.Algorithm, record.Request);
+    vtkPipelineProfilerTotals::iterator t = totals.find(key);
+    if(t == totals.end())
+      {
+      vtkPipelineProfilerTotal total = { 0, 0.0, 0, 0, 0, &record };
+      t = totals.insert(vtkPipelineProfilerTotals::value_type(key,
+                                                              total)).first;
+      }
+    t->second.Calls += 1;
+    t->second.Time += record.Duration;
+    t->second.InputCells += record.InputCells;
+    t->second.OutputCells += record.OutputCells;
+    t->second.MemoryDelta += record.MemoryDelta;
+    }
+  vtkstd::vector<const vtkPipelineProfilerTotal*> rows;
+  for(vtkPipelineProfilerTotals::const_iterator t = totals.begin();
+      t != totals.end(); ++t)
+    {
+    rows.push_back(&t->second);
+    }
+  vtkstd::stable_sort(rows.begin(), rows.end(),
+                      vtkPipelineProfilerLongerTime);
+
+  vtkStringArray* algorithms = vtkStringArray::New();
+  algorithms->SetName("Algorithm");
+  vtkStringArray* requests = vtkStringArray::New();
+  requests->SetName("Request");
+  vtkIdTypeArray* calls = vtkIdTypeArray::New();
+  calls->SetName("Calls");
+  vtkDoubleArray* times = vtkDoubleArray::New();
+  times->SetName("Time");
+  vtkIdTypeArray* inputCells = vtkIdTypeArray::New();
+  inputCells->SetName("Input Cells");
+  vtkIdTypeArray* outputCells = vtkIdTypeArray::New();
+  outputCells->SetName("Output Cells");
+  vtkIdTypeArray* memory = vtkIdTypeArray::New();
+  memory->SetName("Memory Delta");
+  for(size_t i = 0; i < rows.size(); ++i)
+    {
+    const vtkPipelineProfilerTotal* total = rows[i];
+    algorithms->InsertNextValue(total->First->Algorithm);
+    requests->InsertNextValue(
+      vtkPipelineProfilerRequestNames[total->First->Request]);
+    calls->InsertNextValue(total->Calls);
+    times->InsertNextValue(total->Time);
+    inputCells->InsertNextValue(total->InputCells);
+    outputCells->InsertNextValue(total->OutputCells);
+    memory->InsertNextValue(static_cast<vtkIdType>(total->MemoryDelta));
+    }
+
+  this->Summary->Initialize();
+  vtkAbstractArray* columns[7] =
+    { algorithms, requests, calls, times, inputCells, outputCells, memory };
+  for(int c = 0; c < 7; ++c)
+    {
+    this->Summary->AddColumn(columns[c]);
+    columns[c]->Delete();
+    }
+  return this->Summary;
+}
+
+//----------------------------------------------------------------------------
+int vtkPipelineProfiler::WriteChromeTrace(const char* fileName)
+{
+  if(!fileName)
+    {
+    vtkErrorMacro("No file name given.");
+    return 0;
+    }
+  ofstream os(fileName, ios::out);
+  if(!os)
+    {
+    vtkErrorMacro("Cannot open " << fileName << " for writing.");
+    return 0;
+    }
+
+  this->Internals->Lock.Lock();
+  vtkstd::vector<vtkPipelineProfilerRecord> records =
+    this->Internals->Records;
+  this->Internals->Lock.Unlock();
+
+  // Time stamps are microseconds from the first request.
+  double origin = (records.empty() ? 0.0 : records[0].Start);
+  for(size_t i = 1; i < records.size(); ++i)
+    {
+    origin = (records[i].Start < origin ? records[i].Start : origin);
+    }
+  os.setf(ios::fixed, ios::floatfield);
+  os.precision(3);
+  os << "{\"traceEvents\":[";
+  for(size_t i = 0; i < records.size(); ++i)
+    {
+    const vtkPipelineProfilerRecord& record = records[i];
+    const char* request = vtkPipelineProfilerRequestNames[record.Request];
+    os << (i ? ",\n" : "\n")
+       << "{\"name\":\"" << record.Algorithm << "\",\"cat\":\""
+       << request << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << record.Thread
+       << ",\"ts\":" << (record.Start - origin)*1e6
+       << ",\"dur\":" << record.Duration*1e6
+       << ",\"args\":{\"request\":\"" << request << "\""
+       << ",\"input_cells\":" << record.InputCells
+       << ",\"output_cells\":" << record.OutputCells
+       << ",\"memory_delta_kb\":" << record.MemoryDelta << "}}";
+    }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  os.flush();
+  if(!os)
+    {
+    vtkErrorMacro("Writing " << fileName << " failed.");
+    return 0;
+    }
+  return 1;
+}
@@ -0,0 +1,110 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineProfiler.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPipelineProfiler - Record the time spent by every algorithm
+// .SECTION Description
+// vtkPipelineProfiler records the requests that executives pass to their
+// algorithms.  Once it is given to vtkExecutive::SetProfiler(), every
+// REQUEST_INFORMATION, REQUEST_UPDATE_EXTENT and REQUEST_DATA pass of
+// every pipeline is recorded with the algorithm, the thread and the wall
+// time it took, the change of the actual memory size of the outputs of
+// the algorithm, and for REQUEST_DATA the number of cells of its inputs
+// and outputs.  Times include any pipeline an algorithm updates
+// internally.
+//
+// GetSummary() adds the records up per algorithm and request, and
+// WriteChromeTrace() writes all of them as a trace-event JSON file that
+// chrome://tracing and Perfetto display as a timeline, one row per
+// thread.  A profiler may record pipelines that execute on several
+// threads.
+//
+// .SECTION Example
+// \code
+// vtkPipelineProfiler* profiler = vtkPipelineProfiler::New();
+// vtkExecutive::SetProfiler(profiler);
+// renderWindow->Render();
+// vtkExecutive::SetProfiler(0);
+// profiler->GetSummary()->Dump(24);
+// profiler->WriteChromeTrace("render.json");
+// \endcode
+// .SECTION See Also
+// vtkExecutive vtkTimerLog
+
+#ifndef __vtkPipelineProfiler_h
+#define __vtkPipelineProfiler_h
+
+#include "vtkObject.h"
+
+class vtkExecutive;
+class vtkInformation;
+class vtkInformationVector;
+class vtkTable;
+//BTX
+class vtkPipelineProfilerInternals;
+//ETX
+
+class VTK_FILTERING_EXPORT vtkPipelineProfiler : public vtkObject
+{
+public:
+  static vtkPipelineProfiler* New();
+  vtkTypeMacro(vtkPipelineProfiler,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Discard all records.
+  void Reset();
+
+  // Description:
+  // Get the number of requests recorded since the last Reset().
+  int GetNumberOfRecords();
+
+  // Description:
+  // Get a table with one row per algorithm and request type, sorted by
+  // time, the longest first.  The columns are "Algorithm" (class name and
+  // address), "Request", "Calls", "Time" (total seconds), "Input Cells",
+  // "Output Cells" and "Memory Delta" (total kilobytes).  The table is
+  // owned by the profiler and rebuilt by every call.
+  vtkTable* GetSummary();
+
+  // Description:
+  // Write all records to a Chrome trace-event JSON file.  Returns 1 on
+  // success.
+  int WriteChromeTrace(const char* fileName);
+
+  //BTX
+  // Description:
+  // Called by vtkExecutive::CallAlgorithm before and after the algorithm
+  // processes a request.  StartRequest returns the serial number of the
+  // record to pass to EndRequest, or -1 if the request is not profiled.
+  // EndRequest ignores records discarded by Reset() meanwhile.
+  vtkIdType StartRequest(vtkExecutive* executive, vtkInformation* request,
+                         vtkInformationVector** inInfoVec,
+                         vtkInformationVector* outInfoVec);
+  void EndRequest(vtkIdType record, vtkInformation* request,
+                  vtkInformationVector* outInfoVec);
+  //ETX
+
+protected:
+  vtkPipelineProfiler();
+  ~vtkPipelineProfiler();
+
+  vtkPipelineProfilerInternals* Internals;
+  vtkTable* Summary;
+
+private:
+  vtkPipelineProfiler(const vtkPipelineProfiler&);  // Not implemented.
+  void operator=(const vtkPipelineProfiler&);  // Not implemented.
+};
+
+#endif
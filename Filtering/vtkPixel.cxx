@@ -217,7 +217,7 @@ static int edges[4][2] = { {0,1}, {1,3}, {2,3}, {0,2} };
 
 void vtkPixel::Contour(double value, vtkDataArray *cellScalars,
                        vtkIncrementalPointLocator *locator,
-                       vtkCellArray *vtkNotUsed(verts),
+                       vtkCellArray *verts,
                        vtkCellArray *lines, 
                        vtkCellArray *vtkNotUsed(polys), 
                        vtkPointData *inPd, vtkPointData *outPd,
@@ -227,7 +227,7 @@ void vtkPixel::Contour(double value, vtkDataArray *cellScalars,
   vtkMarchingSquaresLineCases *lineCase;
   EDGE_LIST  *edge;
   int i, j, index, *vert;
-  int newCellId;
+  vtkIdType newCellId;
   vtkIdType pts[2];
   double t, x1[3], x2[3], x[3];
 
@@ -242,6 +242,7 @@ void vtkPixel::Contour(double value, vtkDataArray *cellScalars,
 
   lineCase = vtkMarchingSquaresLineCases::GetCases() + index;
   edge = lineCase->edges;
+  vtkIdType offset = verts->GetNumberOfCells();
 
   for ( ; edge[0] > -1; edge += 2 )
     {
@@ -270,7 +271,7 @@ void vtkPixel::Contour(double value, vtkDataArray *cellScalars,
     // check for degenerate line
     if ( pts[0] != pts[1] )
       {
-      newCellId = lines->InsertNextCell(2,pts);
+      newCellId = offset + lines->InsertNextCell(2,pts);
       outCd->CopyData(inCd,cellId,newCellId);
       }
     }
@@ -21,6 +21,7 @@
 #include "vtkInformationVector.h"
 #include "vtkPointLocator.h"
 #include "vtkSource.h"
+#include "vtkStaticCellLocator.h"
 
 #include "vtkSmartPointer.h"
 #define VTK_CREATE(type, name) \
@@ -35,6 +36,7 @@ vtkPointSet::vtkPointSet ()
 {
   this->Points = NULL;
   this->Locator = NULL;
+  this->CellLocator = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -47,6 +49,7 @@ vtkPointSet::~vtkPointSet ()
     this->Locator->UnRegister(this);
     this->Locator = NULL;
     }
+  this->ReleaseCellLocator();
 }
 
 //----------------------------------------------------------------------------
@@ -61,6 +64,7 @@ void vtkPointSet::CopyStructure(vtkDataSet *ds)
       {
       this->Locator->Initialize();
       }
+    this->ReleaseCellLocator();
     this->SetPoints(ps->Points);
     }
 }
@@ -86,7 +90,40 @@ void vtkPointSet::Initialize()
     {
     this->Locator->Initialize();
     }
+  this->ReleaseCellLocator();
 }
+
+//----------------------------------------------------------------------------
+void vtkPointSet::Modified()
+{
+  this->Superclass::Modified();
+  this->ReleaseCellLocator();
+}
+
+//----------------------------------------------------------------------------
+void vtkPointSet::BuildCellLocator()
+{
+  if ( !this->CellLocator )
+    {
+    this->CellLocator = vtkStaticCellLocator::New();
+    this->CellLocator->Register(this);
+    this->CellLocator->Delete();
+    this->CellLocator->SetDataSet(this);
+    }
+  this->CellLocator->BuildLocator();
+}
+
+//----------------------------------------------------------------------------
+void vtkPointSet::ReleaseCellLocator()
+{
+  if ( this->CellLocator )
+    {
+    vtkStaticCellLocator *locator = this->CellLocator;
+    this->CellLocator = NULL;
+    locator->UnRegister(this);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPointSet::ComputeBounds()
 {
@@ -333,6 +370,26 @@ vtkIdType vtkPointSet::FindCell(double x[3], vtkCell *cell, vtkIdType cellId,
 
 #undef VTK_MAX_WALK
 
+//----------------------------------------------------------------------------
+// Unlike the walk above, which needs the cell links and scratch id lists,
+// the static cell locator is only read once built, so this version can
+// run on several threads at once.  Without a cell locator it falls back
+// to the walk.
+vtkIdType vtkPointSet::FindCell(double x[3], double tol2, vtkGenericCell *cell,
+                                double pcoords[3], double *weights)
+{
+  if ( !this->Points || this->GetNumberOfCells() < 1 )
+    {
+    return -1;
+    }
+
+  if ( !this->CellLocator )
+    {
+    return this->Superclass::FindCell(x, tol2, cell, pcoords, weights);
+    }
+  return this->CellLocator->FindCell(x, tol2, cell, pcoords, weights);
+}
+
 
 //----------------------------------------------------------------------------
 void vtkPointSet::Squeeze()
@@ -349,6 +406,7 @@ void vtkPointSet::ReportReferences(vtkGarbageCollector* collector)
 {
   this->Superclass::ReportReferences(collector);
   vtkGarbageCollectorReport(collector, this->Locator, "Locator");
+  vtkGarbageCollectorReport(collector, this->CellLocator, "CellLocator");
 }
 
 //----------------------------------------------------------------------------
@@ -423,5 +481,6 @@ void vtkPointSet::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Points: " << this->GetNumberOfPoints() << "\n";
   os << indent << "Point Coordinates: " << this->Points << "\n";
   os << indent << "Locator: " << this->Locator << "\n";
+  os << indent << "Cell Locator: " << this->CellLocator << "\n";
 }
 
@@ -31,6 +31,7 @@
 #include "vtkPoints.h" // Needed for inline methods
 
 class vtkPointLocator;
+class vtkStaticCellLocator;
 
 class VTK_FILTERING_EXPORT vtkPointSet : public vtkDataSet
 {
@@ -62,6 +63,28 @@ public:
                              double tol2, int& subId, double pcoords[3],
                              double *weights);
 
+  // Description:
+  // Reentrant FindCell(), see vtkDataSet.  It searches the cell locator
+  // built by BuildCellLocator(), which is only read, so several threads
+  // can search at once.  Without a cell locator it walks the cells like
+  // the versions above and is not thread safe.
+  virtual vtkIdType FindCell(double x[3], double tol2, vtkGenericCell *cell,
+                             double pcoords[3], double *weights);
+
+  // Description:
+  // Build the vtkStaticCellLocator used by the reentrant FindCell(), or
+  // bring it up to date.  Call it from a single thread before searching
+  // from several.  The locator holds about a bounding box per cell; it is
+  // freed by ReleaseCellLocator(), Initialize() and Modified().
+  // THIS METHOD IS NOT THREAD SAFE.
+  void BuildCellLocator();
+  void ReleaseCellLocator();
+  vtkGetObjectMacro(CellLocator, vtkStaticCellLocator);
+
+  // Description:
+  // Also frees the cell locator, see BuildCellLocator().
+  virtual void Modified();
+
   // Description:
   // Get MTime which also considers its vtkPoints MTime.
   unsigned long GetMTime();
@@ -106,6 +129,7 @@ protected:
 
   vtkPoints *Points;
   vtkPointLocator *Locator;
+  vtkStaticCellLocator *CellLocator;
 
   virtual void ReportReferences(vtkGarbageCollector*);
 private:
@@ -35,6 +35,87 @@
 
 vtkStandardNewMacro(vtkPolyData);
 
+//----------------------------------------------------------------------------
+// Look up the cell at location loc of cells, one of the cell arrays of
+// self.  With offsets storage, the cell normally is at index cellId minus
+// the cells of the arrays before it (BuildCells() numbers verts, lines,
+// polys and then strips), which is found in constant time instead of
+// searching for the location.
+static inline void vtkPolyDataGetCell(vtkPolyData *self, vtkCellArray *cells,
+                                      vtkIdType cellId, vtkIdType loc,
+                                      vtkIdType &npts, vtkIdType* &pts)
+{
+  if (cells->IsStorageOffsets())
+    {
+    vtkCellArray *arrays[4] =
+      { self->GetVerts(), self->GetLines(), self->GetPolys(),
+        self->GetStrips() };
+    vtkIdType index = cellId;
+    for (int i = 0; i < 4 && arrays[i] != cells; i++)
+      {
+      index -= arrays[i]->GetNumberOfCells();
+      }
+    if (index >= 0 && index < cells->GetNumberOfCells() &&
+        cells->GetCellLocation(index) == loc)
+      {
+      cells->GetCellAtId(index, npts, pts);
+      return;
+      }
+    }
+  cells->GetCell(loc, npts, pts);
+}
+
+//----------------------------------------------------------------------------
+// The cell types of verts, lines, polys and strips of npts points.
+typedef unsigned char (*vtkPolyDataCellTypeFunction)(vtkIdType npts);
+
+static unsigned char vtkPolyDataVertType(vtkIdType npts)
+{
+  return (npts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX);
+}
+
+static unsigned char vtkPolyDataLineType(vtkIdType npts)
+{
+  return (npts > 2 ? VTK_POLY_LINE : VTK_LINE);
+}
+
+static unsigned char vtkPolyDataPolyType(vtkIdType npts)
+{
+  return (npts == 3 ? VTK_TRIANGLE : (npts == 4 ? VTK_QUAD : VTK_POLYGON));
+}
+
+static unsigned char vtkPolyDataStripType(vtkIdType)
+{
+  return VTK_TRIANGLE_STRIP;
+}
+
+//----------------------------------------------------------------------------
+// Add the cells of ca, one of the cell arrays of a polydata, to cells.
+// Offsets storage is read by cell index, so that it is neither converted
+// nor traversed.
+static void vtkPolyDataInsertCells(vtkCellTypes *cells, vtkCellArray *ca,
+                                   vtkPolyDataCellTypeFunction cellType)
+{
+  vtkIdType npts=0;
+  vtkIdType *pts=0;
+  if (ca->IsStorageOffsets())
+    {
+    vtkIdType numCells = ca->GetNumberOfCells();
+    vtkIdType loc = 0;
+    for (vtkIdType cellId=0; cellId < numCells; cellId++)
+      {
+      ca->GetCellAtId(cellId, npts, pts);
+      cells->InsertNextCell((*cellType)(npts), loc);
+      loc += npts + 1;
+      }
+    return;
+    }
+  for (ca->InitTraversal(); ca->GetNextCell(npts,pts); )
+    {
+    cells->InsertNextCell((*cellType)(npts), ca->GetTraversalLocation(npts));
+    }
+}
+
 //----------------------------------------------------------------------------
 // Initialize static member.  This member is used to simplify traversal
 // of verts, lines, polygons, and triangle strips lists.  It basically 
@@ -275,7 +356,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Vertex = vtkVertex::New();
         }
       cell = this->Vertex;
-      this->Verts->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Verts, cellId, loc, numPts, pts);
       break;
 
     case VTK_POLY_VERTEX:
@@ -284,7 +365,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->PolyVertex = vtkPolyVertex::New();
         }
       cell = this->PolyVertex;
-      this->Verts->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Verts, cellId, loc, numPts, pts);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -295,7 +376,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Line = vtkLine::New();
         }
       cell = this->Line;
-      this->Lines->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Lines, cellId, loc, numPts, pts);
       break;
 
     case VTK_POLY_LINE:
@@ -304,7 +385,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->PolyLine = vtkPolyLine::New();
         }
       cell = this->PolyLine;
-      this->Lines->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Lines, cellId, loc, numPts, pts);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -315,7 +396,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Triangle = vtkTriangle::New();
         }
       cell = this->Triangle;
-      this->Polys->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Polys, cellId, loc, numPts, pts);
       break;
 
     case VTK_QUAD:
@@ -324,7 +405,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Quad = vtkQuad::New();
         }
       cell = this->Quad;
-      this->Polys->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Polys, cellId, loc, numPts, pts);
       break;
 
     case VTK_POLYGON:
@@ -333,7 +414,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Polygon = vtkPolygon::New();
         }
       cell = this->Polygon;
-      this->Polys->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Polys, cellId, loc, numPts, pts);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -344,7 +425,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->TriangleStrip = vtkTriangleStrip::New();
         }
       cell = this->TriangleStrip;
-      this->Strips->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Strips, cellId, loc, numPts, pts);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -389,48 +470,48 @@ void vtkPolyData::GetCell(vtkIdType cellId, vtkGenericCell *cell)
     {
     case VTK_VERTEX:
       cell->SetCellTypeToVertex();
-      this->Verts->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Verts, cellId, loc, numPts, pts);
       break;
 
     case VTK_POLY_VERTEX:
       cell->SetCellTypeToPolyVertex();
-      this->Verts->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Verts, cellId, loc, numPts, pts);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_LINE: 
       cell->SetCellTypeToLine();
-      this->Lines->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Lines, cellId, loc, numPts, pts);
       break;
 
     case VTK_POLY_LINE:
       cell->SetCellTypeToPolyLine();
-      this->Lines->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Lines, cellId, loc, numPts, pts);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_TRIANGLE:
       cell->SetCellTypeToTriangle();
-      this->Polys->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Polys, cellId, loc, numPts, pts);
       break;
 
     case VTK_QUAD:
       cell->SetCellTypeToQuad();
-      this->Polys->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Polys, cellId, loc, numPts, pts);
       break;
 
     case VTK_POLYGON:
       cell->SetCellTypeToPolygon();
-      this->Polys->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Polys, cellId, loc, numPts, pts);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_TRIANGLE_STRIP:
       cell->SetCellTypeToTriangleStrip();
-      this->Strips->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Strips, cellId, loc, numPts, pts);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -543,22 +624,22 @@ void vtkPolyData::GetCellBounds(vtkIdType cellId, double bounds[6])
     {
     case VTK_VERTEX:
     case VTK_POLY_VERTEX:
-      this->Verts->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Verts, cellId, loc, numPts, pts);
       break;
 
     case VTK_LINE: 
     case VTK_POLY_LINE:
-      this->Lines->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Lines, cellId, loc, numPts, pts);
       break;
 
     case VTK_TRIANGLE:
     case VTK_QUAD:
     case VTK_POLYGON:
-      this->Polys->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Polys, cellId, loc, numPts, pts);
       break;
 
     case VTK_TRIANGLE_STRIP:
-      this->Strips->GetCell(loc,numPts,pts);
+      vtkPolyDataGetCell(this, this->Strips, cellId, loc, numPts, pts);
       break;
 
     default:
@@ -959,8 +1040,6 @@ void vtkPolyData::BuildCells()
   vtkCellArray *inLines=this->GetLines();
   vtkCellArray *inPolys=this->GetPolys();
   vtkCellArray *inStrips=this->GetStrips();
-  vtkIdType npts=0;
-  vtkIdType *pts=0;
   vtkCellTypes *cells;
 
   vtkDebugMacro (<< "Building PolyData cells.");
@@ -982,52 +1061,10 @@ void vtkPolyData::BuildCells()
   //
   // Traverse various lists to create cell array
   //
-  for (inVerts->InitTraversal(); inVerts->GetNextCell(npts,pts); )
-    {
-    if ( npts > 1 )
-      {
-      cells->InsertNextCell(VTK_POLY_VERTEX,
-                            inVerts->GetTraversalLocation(npts));
-      }
-    else
-      {
-      cells->InsertNextCell(VTK_VERTEX,inVerts->GetTraversalLocation(npts));
-      }
-    }
-
-  for (inLines->InitTraversal(); inLines->GetNextCell(npts,pts); )
-    {
-    if ( npts > 2 )
-      {
-      cells->InsertNextCell(VTK_POLY_LINE,inLines->GetTraversalLocation(npts));
-      }
-    else
-      {
-      cells->InsertNextCell(VTK_LINE,inLines->GetTraversalLocation(npts));
-      } 
-    }
-
-  for (inPolys->InitTraversal(); inPolys->GetNextCell(npts,pts); )
-    {
-    if ( npts == 3 )
-      {
-      cells->InsertNextCell(VTK_TRIANGLE,inPolys->GetTraversalLocation(npts));
-      }
-    else if ( npts == 4 )
-      {
-      cells->InsertNextCell(VTK_QUAD,inPolys->GetTraversalLocation(npts));
-      }
-    else
-      {
-      cells->InsertNextCell(VTK_POLYGON,inPolys->GetTraversalLocation(npts));
-      }
-    }
-
-  for (inStrips->InitTraversal(); inStrips->GetNextCell(npts,pts); )
-    {
-    cells->InsertNextCell(VTK_TRIANGLE_STRIP,
-                          inStrips->GetTraversalLocation(npts));
-    }
+  vtkPolyDataInsertCells(cells, inVerts, vtkPolyDataVertType);
+  vtkPolyDataInsertCells(cells, inLines, vtkPolyDataLineType);
+  vtkPolyDataInsertCells(cells, inPolys, vtkPolyDataPolyType);
+  vtkPolyDataInsertCells(cells, inStrips, vtkPolyDataStripType);
 }
 
 //----------------------------------------------------------------------------
@@ -1106,19 +1143,19 @@ void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
   switch (type)
     {
     case VTK_VERTEX: case VTK_POLY_VERTEX:
-      this->Verts->GetCell(loc,npts,pts);
+      vtkPolyDataGetCell(this, this->Verts, cellId, loc, npts, pts);
       break;
 
     case VTK_LINE: case VTK_POLY_LINE:
-      this->Lines->GetCell(loc,npts,pts);
+      vtkPolyDataGetCell(this, this->Lines, cellId, loc, npts, pts);
       break;
 
     case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
-      this->Polys->GetCell(loc,npts,pts);
+      vtkPolyDataGetCell(this, this->Polys, cellId, loc, npts, pts);
       break;
 
     case VTK_TRIANGLE_STRIP:
-      this->Strips->GetCell(loc,npts,pts);
+      vtkPolyDataGetCell(this, this->Strips, cellId, loc, npts, pts);
       break;
 
     default:
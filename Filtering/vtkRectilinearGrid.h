@@ -82,6 +82,9 @@ public:
   vtkCell *FindAndGetCell(double x[3], vtkCell *cell, vtkIdType cellId, 
                           double tol2, int& subId, double pcoords[3],
                           double *weights);
+//BTX
+  using vtkDataSet::FindCell;
+//ETX
   int GetCellType(vtkIdType cellId);
   void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
     {vtkStructuredData::GetCellPoints(cellId,ptIds,this->DataDescription,
@@ -0,0 +1,1328 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStaticCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkStaticCellLocator.h"
+
+#include "vtkCell.h"
+#include "vtkCellArray.h"
+#include "vtkDataSet.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+#include <float.h>
+
+#if defined(__SSE__)
+# include <xmmintrin.h>
+# define VTK_STATIC_CELL_LOCATOR_SSE
+#endif
+
+vtkStandardNewMacro(vtkStaticCellLocator);
+
+// Number of bins per axis of the surface area heuristic.
+#define VTK_STATIC_CELL_LOCATOR_BINS 16
+// Nodes with more cells are split one at a time, with the cells binned in
+// parallel; smaller nodes are the roots of subtrees built in parallel.
+#define VTK_STATIC_CELL_LOCATOR_SUBTREE_SIZE 32768
+// Depth of the binary tree at which nodes become leaves regardless of
+// their number of cells.
+#define VTK_STATIC_CELL_LOCATOR_MAX_DEPTH 64
+// Size of the traversal stacks, enough for MAX_DEPTH.
+#define VTK_STATIC_CELL_LOCATOR_STACK_SIZE 256
+
+//----------------------------------------------------------------------------
+// A node with four children.  The boxes are stored per axis so that the
+// four of them are tested together.  Count is 0 for an inner node,
+// whose index is Child, the number of cells for a leaf, whose ids start
+// at CellIds[Child], and -1 for an unused child.
+struct vtkStaticCellLocatorNode
+{
+  float Min[3][4];
+  float Max[3][4];
+  vtkIdType Child[4];
+  int Count[4];
+};
+
+//----------------------------------------------------------------------------
+class vtkStaticCellLocatorTree
+{
+public:
+  vtkstd::vector<vtkStaticCellLocatorNode> Nodes;
+  vtkstd::vector<vtkIdType> CellIds;
+  // Slack added to the boxes for the rounding of the float tests.
+  double Padding;
+};
+
+//----------------------------------------------------------------------------
+// Round to the closest float towards minus or plus infinity so that float
+// boxes contain the double boxes.
+static inline float vtkStaticCellLocatorFloatDown(double v)
+{
+  float f = static_cast<float>(v);
+  if (f > v)
+    {
+    f -= (f > 0 ? f : -f) * FLT_EPSILON + FLT_MIN;
+    }
+  return f;
+}
+
+static inline float vtkStaticCellLocatorFloatUp(double v)
+{
+  float f = static_cast<float>(v);
+  if (f < v)
+    {
+    f += (f > 0 ? f : -f) * FLT_EPSILON + FLT_MIN;
+    }
+  return f;
+}
+
+//----------------------------------------------------------------------------
+// Return a bit mask of the children of node whose boxes overlap
+// [lo,hi].
+static inline int vtkStaticCellLocatorOverlap(
+  const vtkStaticCellLocatorNode& node, const float lo[3], const float hi[3])
+{
+#ifdef VTK_STATIC_CELL_LOCATOR_SSE
+  __m128 mask = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+  for (int a = 0; a < 3; a++)
+    {
+    mask = _mm_and_ps(mask,
+      _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.Min[a]), _mm_set1_ps(hi[a])),
+                 _mm_cmple_ps(_mm_set1_ps(lo[a]), _mm_loadu_ps(node.Max[a]))));
+    }
+  return _mm_movemask_ps(mask);
+#else
+  int mask = 0;
+  for (int i = 0; i < 4; i++)
+    {
+    if (node.Min[0][i] <= hi[0] && lo[0] <= node.Max[0][i] &&
+        node.Min[1][i] <= hi[1] && lo[1] <= node.Max[1][i] &&
+        node.Min[2][i] <= hi[2] && lo[2] <= node.Max[2][i])
+      {
+      mask |= 1 << i;
+      }
+    }
+  return mask;
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Clip the segment origin + t*dir, t in [0,tMax], against the four boxes
+// of node grown by pad.  Return a bit mask of the boxes hit and their
+// entry parameters in tNear.
+static inline int vtkStaticCellLocatorSlabs(
+  const vtkStaticCellLocatorNode& node, const float origin[3],
+  const float invDir[3], float pad, float tMax, float tNear[4])
+{
+#ifdef VTK_STATIC_CELL_LOCATOR_SSE
+  __m128 vpad = _mm_set1_ps(pad);
+  __m128 t0 = _mm_setzero_ps();
+  __m128 t1 = _mm_set1_ps(tMax);
+  for (int a = 0; a < 3; a++)
+    {
+    __m128 o = _mm_set1_ps(origin[a]);
+    __m128 inv = _mm_set1_ps(invDir[a]);
+    __m128 ta = _mm_mul_ps(
+      _mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(node.Min[a]), vpad), o), inv);
+    __m128 tb = _mm_mul_ps(
+      _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(node.Max[a]), vpad), o), inv);
+    t0 = _mm_max_ps(t0, _mm_min_ps(ta, tb));
+    t1 = _mm_min_ps(t1, _mm_max_ps(ta, tb));
+    }
+  _mm_storeu_ps(tNear, t0);
+  return _mm_movemask_ps(_mm_cmple_ps(t0, t1));
+#else
+  int mask = 0;
+  for (int i = 0; i < 4; i++)
+    {
+    float t0 = 0.0f;
+    float t1 = tMax;
+    for (int a = 0; a < 3; a++)
+      {
+      float ta = ((node.Min[a][i] - pad) - origin[a]) * invDir[a];
+      float tb = ((node.Max[a][i] + pad) - origin[a]) * invDir[a];
+      t0 = vtkstd::max(t0, vtkstd::min(ta, tb));
+      t1 = vtkstd::min(t1, vtkstd::max(ta, tb));
+      }
+    tNear[i] = t0;
+    if (t0 <= t1)
+      {
+      mask |= 1 << i;
+      }
+    }
+  return mask;
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Squared distance from x to a box.
+static inline double vtkStaticCellLocatorDistance2(const double x[3],
+                                                   const double lo[3],
+                                                   const double hi[3])
+{
+  double d2 = 0.0;
+  for (int a = 0; a < 3; a++)
+    {
+    double d = (x[a] < lo[a] ? lo[a] - x[a] :
+                x[a] > hi[a] ? x[a] - hi[a] : 0.0);
+    d2 += d * d;
+    }
+  return d2;
+}
+
+//----------------------------------------------------------------------------
+// Whether the segment p1 + t*(p2-p1), t in [0,1], meets bounds grown by
+// pad.
+static inline int vtkStaticCellLocatorSegmentHitsBounds(
+  const double p1[3], const double p2[3], const double bounds[6], double pad)
+{
+  double t0 = 0.0, t1 = 1.0;
+  for (int a = 0; a < 3; a++)
+    {
+    double lo = bounds[2*a] - pad;
+    double hi = bounds[2*a+1] + pad;
+    double d = p2[a] - p1[a];
+    if (d == 0.0)
+      {
+      if (p1[a] < lo || p1[a] > hi)
+        {
+        return 0;
+        }
+      continue;
+      }
+    double ta = (lo - p1[a]) / d;
+    double tb = (hi - p1[a]) / d;
+    t0 = vtkstd::max(t0, vtkstd::min(ta, tb));
+    t1 = vtkstd::min(t1, vtkstd::max(ta, tb));
+    if (t0 > t1)
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Prepare the float ray used by vtkStaticCellLocatorSlabs().
+static inline void vtkStaticCellLocatorRay(const double p1[3],
+                                           const double p2[3],
+                                           float origin[3], float invDir[3])
+{
+  for (int a = 0; a < 3; a++)
+    {
+    origin[a] = static_cast<float>(p1[a]);
+    double d = p2[a] - p1[a];
+    // Avoid 0*inf in the slab test for lines parallel to an axis.
+    invDir[a] = (d == 0.0 ? 1e30f :
+                 static_cast<float>(vtkstd::max(-1e30, vtkstd::min(1e30,
+                                                                   1.0 / d))));
+    }
+}
+
+//----------------------------------------------------------------------------
+// Binary tree used while building.  Left and Right are -1 for leaves.
+struct vtkStaticCellLocatorBuildNode
+{
+  double Bounds[6];
+  vtkIdType First;
+  vtkIdType Count;
+  vtkIdType Left;
+  vtkIdType Right;
+  int Depth;
+};
+
+typedef vtkstd::vector<vtkStaticCellLocatorBuildNode>
+  vtkStaticCellLocatorBuildNodes;
+
+static void vtkStaticCellLocatorInitBounds(double bounds[6])
+{
+  bounds[0] = bounds[2] = bounds[4] = VTK_DOUBLE_MAX;
+  bounds[1] = bounds[3] = bounds[5] = -VTK_DOUBLE_MAX;
+}
+
+static void vtkStaticCellLocatorAddBounds(double bounds[6],
+                                          const double other[6])
+{
+  for (int a = 0; a < 3; a++)
+    {
+    bounds[2*a] = vtkstd::min(bounds[2*a], other[2*a]);
+    bounds[2*a+1] = vtkstd::max(bounds[2*a+1], other[2*a+1]);
+    }
+}
+
+static double vtkStaticCellLocatorHalfArea(const double bounds[6])
+{
+  double dx = bounds[1] - bounds[0];
+  double dy = bounds[3] - bounds[2];
+  double dz = bounds[5] - bounds[4];
+  return (dx < 0.0 ? 0.0 : dx*dy + dy*dz + dz*dx);
+}
+
+//----------------------------------------------------------------------------
+// Cell counts and bounds of the bins along the three axes.
+struct vtkStaticCellLocatorBins
+{
+  vtkIdType Count[3][VTK_STATIC_CELL_LOCATOR_BINS];
+  double Bounds[3][VTK_STATIC_CELL_LOCATOR_BINS][6];
+  double CentroidBounds[6];
+
+  void Initialize(const double centroidBounds[6])
+    {
+    for (int a = 0; a < 3; a++)
+      {
+      for (int b = 0; b < VTK_STATIC_CELL_LOCATOR_BINS; b++)
+        {
+        this->Count[a][b] = 0;
+        vtkStaticCellLocatorInitBounds(this->Bounds[a][b]);
+        }
+      }
+    for (int i = 0; i < 6; i++)
+      {
+      this->CentroidBounds[i] = centroidBounds[i];
+      }
+    }
+
+  int GetBin(int a, double centroid) const
+    {
+    double lo = this->CentroidBounds[2*a];
+    double extent = this->CentroidBounds[2*a+1] - lo;
+    int b = static_cast<int>(
+      VTK_STATIC_CELL_LOCATOR_BINS * (centroid - lo) / extent);
+    return (b < 0 ? 0 : b >= VTK_STATIC_CELL_LOCATOR_BINS ?
+            VTK_STATIC_CELL_LOCATOR_BINS - 1 : b);
+    }
+
+  void Add(const double bounds[6], const double centroid[3])
+    {
+    for (int a = 0; a < 3; a++)
+      {
+      if (this->CentroidBounds[2*a+1] > this->CentroidBounds[2*a])
+        {
+        int b = this->GetBin(a, centroid[a]);
+        this->Count[a][b]++;
+        vtkStaticCellLocatorAddBounds(this->Bounds[a][b], bounds);
+        }
+      }
+    }
+
+  void Merge(const vtkStaticCellLocatorBins& other)
+    {
+    for (int a = 0; a < 3; a++)
+      {
+      for (int b = 0; b < VTK_STATIC_CELL_LOCATOR_BINS; b++)
+        {
+        this->Count[a][b] += other.Count[a][b];
+        vtkStaticCellLocatorAddBounds(this->Bounds[a][b],
+                                      other.Bounds[a][b]);
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+class vtkStaticCellLocatorBuilder;
+
+// Bin the cells of a large node in parallel.
+class vtkStaticCellLocatorBinFunctor
+{
+public:
+  vtkStaticCellLocatorBuilder *Builder;
+  vtkStaticCellLocatorBins *Result;
+  vtkSMPThreadLocal<vtkStaticCellLocatorBins> Bins;
+
+  void Initialize()
+    {
+    this->Bins.Local().Initialize(this->Result->CentroidBounds);
+    }
+  inline void operator()(vtkIdType begin, vtkIdType end);
+  void Reduce()
+    {
+    for (vtkSMPThreadLocal<vtkStaticCellLocatorBins>::iterator it =
+           this->Bins.begin(); it != this->Bins.end(); ++it)
+      {
+      this->Result->Merge(*it);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Builds the binary tree, or one subtree of it.
+class vtkStaticCellLocatorBuilder
+{
+public:
+  const double (*CellBounds)[6];
+  const double *Centroids;
+  vtkIdType *CellIds;
+  int LeafSize;
+
+  // Split the node into two children, or return 0 if it is a leaf.
+  int Split(vtkStaticCellLocatorBuildNodes& nodes, vtkIdType index)
+    {
+    vtkStaticCellLocatorBuildNode node = nodes[index];
+    if (node.Count <= this->LeafSize ||
+        node.Depth >= VTK_STATIC_CELL_LOCATOR_MAX_DEPTH)
+      {
+      return 0;
+      }
+    vtkIdType *ids = this->CellIds + node.First;
+
+    double centroidBounds[6];
+    vtkStaticCellLocatorInitBounds(centroidBounds);
+    vtkIdType i;
+    for (i = 0; i < node.Count; i++)
+      {
+      const double *c = this->Centroids + 3*ids[i];
+      double b[6] = { c[0], c[0], c[1], c[1], c[2], c[2] };
+      vtkStaticCellLocatorAddBounds(centroidBounds, b);
+      }
+
+    vtkStaticCellLocatorBins bins;
+    bins.Initialize(centroidBounds);
+    if (node.Count > VTK_STATIC_CELL_LOCATOR_SUBTREE_SIZE)
+      {
+      vtkStaticCellLocatorBinFunctor binFunctor;
+      binFunctor.Builder = this;
+      binFunctor.Result = &bins;
+      vtkSMPTools::Reduce(node.First, node.First + node.Count, binFunctor);
+      }
+    else
+      {
+      this->AddToBins(bins, node.First, node.First + node.Count);
+      }
+
+    // Sweep the bins of every axis for the cheapest split.
+    int bestAxis = -1, bestBin = 0;
+    double bestCost = VTK_DOUBLE_MAX;
+    for (int a = 0; a < 3; a++)
+      {
+      if (centroidBounds[2*a+1] <= centroidBounds[2*a])
+        {
+        continue;
+        }
+      double rightArea[VTK_STATIC_CELL_LOCATOR_BINS];
+      vtkIdType rightCount[VTK_STATIC_CELL_LOCATOR_BINS];
+      double bounds[6];
+      vtkStaticCellLocatorInitBounds(bounds);
+      vtkIdType count = 0;
+      int b;
+      for (b = VTK_STATIC_CELL_LOCATOR_BINS - 1; b > 0; b--)
+        {
+        vtkStaticCellLocatorAddBounds(bounds, bins.Bounds[a][b]);
+        count += bins.Count[a][b];
+        rightArea[b] = vtkStaticCellLocatorHalfArea(bounds);
+        rightCount[b] = count;
+        }
+      vtkStaticCellLocatorInitBounds(bounds);
+      count = 0;
+      for (b = 0; b < VTK_STATIC_CELL_LOCATOR_BINS - 1; b++)
+        {
+        vtkStaticCellLocatorAddBounds(bounds, bins.Bounds[a][b]);
+        count += bins.Count[a][b];
+        if (count == 0 || rightCount[b+1] == 0)
+          {
+          continue;
+          }
+        double cost = vtkStaticCellLocatorHalfArea(bounds) * count +
+          rightArea[b+1] * rightCount[b+1];
+        if (cost < bestCost)
+          {
+          bestCost = cost;
+          bestAxis = a;
+          bestBin = b;
+          }
+        }
+      }
+
+    vtkIdType numLeft;
+    if (bestAxis >= 0)
+      {
+      vtkIdType *left = ids;
+      vtkIdType *right = ids + node.Count;
+      while (left < right)
+        {
+        if (bins.GetBin(bestAxis, this->Centroids[3*(*left) + bestAxis]) <=
+            bestBin)
+          {
+          ++left;
+          }
+        else
+          {
+          vtkstd::swap(*left, *--right);
+          }
+        }
+      numLeft = left - ids;
+      }
+    else
+      {
+      // All the centroids coincide, split the cells in two halves.
+      numLeft = node.Count / 2;
+      }
+
+    vtkStaticCellLocatorBuildNode child;
+    child.Left = child.Right = -1;
+    child.Depth = node.Depth + 1;
+    child.First = node.First;
+    child.Count = numLeft;
+    this->ComputeBounds(child);
+    nodes[index].Left = static_cast<vtkIdType>(nodes.size());
+    nodes.push_back(child);
+    child.First = node.First + numLeft;
+    child.Count = node.Count - numLeft;
+    this->ComputeBounds(child);
+    nodes[index].Right = static_cast<vtkIdType>(nodes.size());
+    nodes.push_back(child);
+    return 1;
+    }
+
+  void AddToBins(vtkStaticCellLocatorBins& bins, vtkIdType begin,
+                 vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      vtkIdType cellId = this->CellIds[i];
+      bins.Add(this->CellBounds[cellId], this->Centroids + 3*cellId);
+      }
+    }
+
+  void ComputeBounds(vtkStaticCellLocatorBuildNode& node)
+    {
+    vtkStaticCellLocatorInitBounds(node.Bounds);
+    for (vtkIdType i = 0; i < node.Count; i++)
+      {
+      vtkStaticCellLocatorAddBounds(node.Bounds,
+                                    this->CellBounds[this->CellIds[node.First + i]]);
+      }
+    }
+
+  // Split recursively.
+  void Build(vtkStaticCellLocatorBuildNodes& nodes, vtkIdType index)
+    {
+    if (this->Split(nodes, index))
+      {
+      vtkIdType left = nodes[index].Left;
+      vtkIdType right = nodes[index].Right;
+      this->Build(nodes, left);
+      this->Build(nodes, right);
+      }
+    }
+};
+
+inline void vtkStaticCellLocatorBinFunctor::operator()(vtkIdType begin,
+                                                       vtkIdType end)
+{
+  this->Builder->AddToBins(this->Bins.Local(), begin, end);
+}
+
+//----------------------------------------------------------------------------
+// Build the subtrees below the large nodes.
+class vtkStaticCellLocatorSubtrees
+{
+public:
+  vtkStaticCellLocatorBuilder *Builder;
+  const vtkStaticCellLocatorBuildNodes *Roots;
+  const vtkstd::vector<vtkIdType> *Tasks;
+  vtkstd::vector<vtkStaticCellLocatorBuildNodes> *Subtrees;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType task = begin; task < end; task++)
+      {
+      vtkStaticCellLocatorBuildNodes& subtree = (*this->Subtrees)[task];
+      subtree.push_back((*this->Roots)[(*this->Tasks)[task]]);
+      this->Builder->Build(subtree, 0);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Compute the bounds and centroids of all cells.
+class vtkStaticCellLocatorCellBounds
+{
+public:
+  vtkDataSet *DataSet;
+  double (*CellBounds)[6];
+  double *Centroids;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+      double *bounds = this->CellBounds[cellId];
+      this->DataSet->GetCellBounds(cellId, bounds);
+      for (int a = 0; a < 3; a++)
+        {
+        this->Centroids[3*cellId + a] = 0.5 * (bounds[2*a] + bounds[2*a+1]);
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Convert the binary tree into four-wide nodes: the children of a node
+// are the children of its binary children, or the binary children
+// themselves when they are leaves.
+static vtkIdType vtkStaticCellLocatorCollapse(
+  const vtkStaticCellLocatorBuildNodes& build, vtkIdType index,
+  vtkStaticCellLocatorTree *tree)
+{
+  vtkIdType entries[4];
+  int numEntries = 0;
+  const vtkStaticCellLocatorBuildNode& node = build[index];
+  if (node.Left < 0)
+    {
+    entries[numEntries++] = index;
+    }
+  else
+    {
+    vtkIdType children[2] = { node.Left, node.Right };
+    for (int c = 0; c < 2; c++)
+      {
+      const vtkStaticCellLocatorBuildNode& child = build[children[c]];
+      if (child.Left < 0)
+        {
+        entries[numEntries++] = children[c];
+        }
+      else
+        {
+        entries[numEntries++] = child.Left;
+        entries[numEntries++] = child.Right;
+        }
+      }
+    }
+
+  vtkIdType q = static_cast<vtkIdType>(tree->Nodes.size());
+  vtkStaticCellLocatorNode empty;
+  for (int i = 0; i < 4; i++)
+    {
+    for (int a = 0; a < 3; a++)
+      {
+      empty.Min[a][i] = FLT_MAX;
+      empty.Max[a][i] = -FLT_MAX;
+      }
+    empty.Child[i] = 0;
+    empty.Count[i] = -1;
+    }
+  tree->Nodes.push_back(empty);
+
+  for (int i = 0; i < numEntries; i++)
+    {
+    const vtkStaticCellLocatorBuildNode& entry = build[entries[i]];
+    vtkIdType child;
+    int count;
+    if (entry.Left < 0)
+      {
+      child = entry.First;
+      count = static_cast<int>(entry.Count);
+      }
+    else
+      {
+      child = vtkStaticCellLocatorCollapse(build, entries[i], tree);
+      count = 0;
+      }
+    vtkStaticCellLocatorNode& qnode = tree->Nodes[q];
+    for (int a = 0; a < 3; a++)
+      {
+      qnode.Min[a][i] = vtkStaticCellLocatorFloatDown(entry.Bounds[2*a]);
+      qnode.Max[a][i] = vtkStaticCellLocatorFloatUp(entry.Bounds[2*a+1]);
+      }
+    qnode.Child[i] = child;
+    qnode.Count[i] = count;
+    }
+  return q;
+}
+
+//----------------------------------------------------------------------------
+// Intersect a range of lines.
+class vtkStaticCellLocatorLines
+{
+public:
+  vtkStaticCellLocator *Locator;
+  const double *Lines;
+  double Tolerance;
+  vtkIdType *CellIds;
+  double *T;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkGenericCell> > Cell;
+
+  void Initialize()
+    {
+    this->Cell.Local() = vtkSmartPointer<vtkGenericCell>::New();
+    }
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkGenericCell *cell = this->Cell.Local();
+    double p1[3], p2[3], x[3], pcoords[3];
+    int subId;
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      for (int a = 0; a < 3; a++)
+        {
+        p1[a] = this->Lines[6*i + a];
+        p2[a] = this->Lines[6*i + 3 + a];
+        }
+      if (!this->Locator->IntersectWithLine(p1, p2, this->Tolerance,
+                                            this->T[i], x, pcoords, subId,
+                                            this->CellIds[i], cell))
+        {
+        this->CellIds[i] = -1;
+        }
+      }
+    }
+  void Reduce()
+    {
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkStaticCellLocator::vtkStaticCellLocator()
+{
+  this->NumberOfCellsPerNode = 8;
+  this->Tree = NULL;
+  this->MaxCellSize = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkStaticCellLocator::~vtkStaticCellLocator()
+{
+  this->FreeSearchStructure();
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::FreeSearchStructure()
+{
+  delete this->Tree;
+  this->Tree = NULL;
+  this->FreeCellBounds();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkStaticCellLocator::GetNumberOfNodes()
+{
+  return (this->Tree ? static_cast<vtkIdType>(this->Tree->Nodes.size()) : 0);
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::BuildLocator()
+{
+  if ( (this->Tree != NULL) && (this->BuildTime > this->MTime)
+       && (this->BuildTime > this->DataSet->GetMTime()) )
+    {
+    return;
+    }
+
+  vtkIdType numCells;
+  if ( !this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1 )
+    {
+    vtkErrorMacro( << "No cells to subdivide");
+    return;
+    }
+  vtkDebugMacro( << "Building cell hierarchy..." );
+  this->FreeSearchStructure();
+
+  // Cell bounds and centroids.  The first GetCellBounds() builds the
+  // lazy structures of the dataset before the threads use it.
+  this->CellBounds = new double [numCells][6];
+  double *centroids = new double [3*numCells];
+  this->DataSet->GetCellBounds(0, this->CellBounds[0]);
+  this->MaxCellSize = this->DataSet->GetMaxCellSize();
+  vtkStaticCellLocatorCellBounds cellBounds;
+  cellBounds.DataSet = this->DataSet;
+  cellBounds.CellBounds = this->CellBounds;
+  cellBounds.Centroids = centroids;
+  vtkSMPTools::For(0, numCells, cellBounds);
+
+  this->Tree = new vtkStaticCellLocatorTree;
+  this->Tree->CellIds.resize(numCells);
+  vtkIdType i;
+  for (i = 0; i < numCells; i++)
+    {
+    this->Tree->CellIds[i] = i;
+    }
+
+  vtkStaticCellLocatorBuilder builder;
+  builder.CellBounds = this->CellBounds;
+  builder.Centroids = centroids;
+  builder.CellIds = &this->Tree->CellIds[0];
+  builder.LeafSize = this->NumberOfCellsPerNode;
+
+  // Split the large nodes one by one, then build the subtrees of the
+  // remaining nodes in parallel.  The subtree sizes do not depend on the
+  // number of threads, so neither does the tree.
+  vtkStaticCellLocatorBuildNodes nodes;
+  vtkStaticCellLocatorBuildNode root;
+  root.First = 0;
+  root.Count = numCells;
+  root.Left = root.Right = -1;
+  root.Depth = 0;
+  builder.ComputeBounds(root);
+  nodes.push_back(root);
+  vtkstd::vector<vtkIdType> tasks;
+  vtkstd::vector<vtkIdType> pending(1, 0);
+  while (!pending.empty())
+    {
+    vtkIdType index = pending.back();
+    pending.pop_back();
+    if (nodes[index].Count <= VTK_STATIC_CELL_LOCATOR_SUBTREE_SIZE)
+      {
+      tasks.push_back(index);
+      }
+    else if (builder.Split(nodes, index))
+      {
+      pending.push_back(nodes[index].Right);
+      pending.push_back(nodes[index].Left);
+      }
+    }
+
+  vtkstd::vector<vtkStaticCellLocatorBuildNodes> subtrees(tasks.size());
+  vtkStaticCellLocatorSubtrees subtreeFunctor;
+  subtreeFunctor.Builder = &builder;
+  subtreeFunctor.Roots = &nodes;
+  subtreeFunctor.Tasks = &tasks;
+  subtreeFunctor.Subtrees = &subtrees;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(tasks.size()), 1,
+                   subtreeFunctor);
+
+  // Graft the subtrees: their roots replace the task nodes, the other
+  // nodes are appended.
+  for (size_t task = 0; task < tasks.size(); task++)
+    {
+    vtkStaticCellLocatorBuildNodes& subtree = subtrees[task];
+    vtkIdType base = static_cast<vtkIdType>(nodes.size()) - 1;
+    for (size_t n = 0; n < subtree.size(); n++)
+      {
+      vtkStaticCellLocatorBuildNode node = subtree[n];
+      if (node.Left >= 0)
+        {
+        node.Left += base;
+        node.Right += base;
+        }
+      if (n == 0)
+        {
+        nodes[tasks[task]] = node;
+        }
+      else
+        {
+        nodes.push_back(node);
+        }
+      }
+    vtkStaticCellLocatorBuildNodes().swap(subtree);
+    }
+  delete [] centroids;
+
+  this->Tree->Nodes.reserve(nodes.size() / 2 + 1);
+  vtkStaticCellLocatorCollapse(nodes, 0, this->Tree);
+
+  // Slack for the float rounding of the query points and boxes.
+  double scale = 0.0;
+  for (i = 0; i < 6; i++)
+    {
+    scale = vtkstd::max(scale, fabs(nodes[0].Bounds[i]));
+    }
+  this->Tree->Padding = 4.0 * FLT_EPSILON * scale;
+
+  this->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkStaticCellLocator::FindCell(double x[3], double tol2,
+                                         vtkGenericCell *cell,
+                                         double pcoords[3], double *weights)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+    {
+    return -1;
+    }
+
+  double tol = sqrt(tol2);
+  double pad = tol + this->Tree->Padding;
+  float lo[3], hi[3];
+  for (int a = 0; a < 3; a++)
+    {
+    lo[a] = vtkStaticCellLocatorFloatDown(x[a] - pad);
+    hi[a] = vtkStaticCellLocatorFloatUp(x[a] + pad);
+    }
+
+  vtkIdType stack[VTK_STATIC_CELL_LOCATOR_STACK_SIZE];
+  int top = 0;
+  stack[top++] = 0;
+  double closestPoint[3], dist2;
+  int subId;
+  while (top > 0)
+    {
+    const vtkStaticCellLocatorNode& node = this->Tree->Nodes[stack[--top]];
+    int mask = vtkStaticCellLocatorOverlap(node, lo, hi);
+    for (int i = 0; i < 4; i++)
+      {
+      if (!(mask & (1 << i)) || node.Count[i] < 0)
+        {
+        continue;
+        }
+      if (node.Count[i] == 0)
+        {
+        stack[top++] = node.Child[i];
+        continue;
+        }
+      const vtkIdType *ids = &this->Tree->CellIds[node.Child[i]];
+      for (int c = 0; c < node.Count[i]; c++)
+        {
+        const double *b = this->CellBounds[ids[c]];
+        if (x[0] < b[0] - tol || x[0] > b[1] + tol ||
+            x[1] < b[2] - tol || x[1] > b[3] + tol ||
+            x[2] < b[4] - tol || x[2] > b[5] + tol)
+          {
+          continue;
+          }
+        this->DataSet->GetCell(ids[c], cell);
+        if (cell->EvaluatePosition(x, closestPoint, subId, pcoords, dist2,
+                                   weights) == 1 && dist2 <= tol2)
+          {
+          return ids[c];
+          }
+        }
+      }
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+int vtkStaticCellLocator::IntersectWithLine(
+  double p1[3], double p2[3], double tol, double& t, double x[3],
+  double pcoords[3], int &subId, vtkIdType &cellId, vtkGenericCell *cell)
+{
+  cellId = -1;
+  this->BuildLocator();
+  if (!this->Tree)
+    {
+    return 0;
+    }
+
+  float origin[3], invDir[3];
+  vtkStaticCellLocatorRay(p1, p2, origin, invDir);
+  double length = sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
+  double pad = tol * length + this->Tree->Padding;
+  float fpad = vtkStaticCellLocatorFloatUp(pad);
+
+  // Nearest boxes first, and skip boxes entered after the closest hit.
+  vtkIdType stack[VTK_STATIC_CELL_LOCATOR_STACK_SIZE];
+  float stackT[VTK_STATIC_CELL_LOCATOR_STACK_SIZE];
+  int top = 0;
+  stack[top] = 0;
+  stackT[top++] = 0.0f;
+  double bestT = VTK_DOUBLE_MAX;
+  double cellT, cellX[3], cellPcoords[3];
+  int cellSubId;
+  float tNear[4];
+  while (top > 0)
+    {
+    --top;
+    if (stackT[top] > bestT)
+      {
+      continue;
+      }
+    const vtkStaticCellLocatorNode& node = this->Tree->Nodes[stack[top]];
+    float tMax = (bestT < 1.0 ? static_cast<float>(bestT) : 1.0f);
+    tMax = vtkStaticCellLocatorFloatUp(tMax + 1e-6);
+    int mask = vtkStaticCellLocatorSlabs(node, origin, invDir, fpad, tMax,
+                                         tNear);
+    int children[4];
+    int numChildren = 0;
+    for (int i = 0; i < 4; i++)
+      {
+      if (!(mask & (1 << i)) || node.Count[i] < 0)
+        {
+        continue;
+        }
+      if (node.Count[i] == 0)
+        {
+        children[numChildren++] = i;
+        continue;
+        }
+      const vtkIdType *ids = &this->Tree->CellIds[node.Child[i]];
+      for (int c = 0; c < node.Count[i]; c++)
+        {
+        if (!vtkStaticCellLocatorSegmentHitsBounds(
+              p1, p2, this->CellBounds[ids[c]], pad))
+          {
+          continue;
+          }
+        this->DataSet->GetCell(ids[c], cell);
+        if (cell->IntersectWithLine(p1, p2, tol, cellT, cellX, cellPcoords,
+                                    cellSubId) &&
+            (cellT < bestT || (cellT == bestT && ids[c] < cellId)))
+          {
+          bestT = cellT;
+          cellId = ids[c];
+          t = cellT;
+          subId = cellSubId;
+          for (int a = 0; a < 3; a++)
+            {
+            x[a] = cellX[a];
+            pcoords[a] = cellPcoords[a];
+            }
+          }
+        }
+      }
+    // Push the farthest child first so that the nearest is popped first.
+    for (int n = 0; n < numChildren; n++)
+      {
+      for (int m = n + 1; m < numChildren; m++)
+        {
+        if (tNear[children[m]] > tNear[children[n]])
+          {
+          vtkstd::swap(children[n], children[m]);
+          }
+        }
+      stack[top] = node.Child[children[n]];
+      stackT[top++] = tNear[children[n]];
+      }
+    }
+
+  if (cellId >= 0)
+    {
+    this->DataSet->GetCell(cellId, cell);
+    return 1;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::IntersectWithLines(vtkIdType numLines,
+                                              const double *lines,
+                                              double tol, vtkIdType *cellIds,
+                                              double *t)
+{
+  this->BuildLocator();
+  vtkStaticCellLocatorLines functor;
+  functor.Locator = this;
+  functor.Lines = lines;
+  functor.Tolerance = tol;
+  functor.CellIds = cellIds;
+  functor.T = t;
+  vtkSMPTools::Reduce(0, numLines, functor);
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::FindClosestPoint(
+  double x[3], double closestPoint[3], vtkGenericCell *cell,
+  vtkIdType &cellId, int &subId, double& dist2)
+{
+  int inside;
+  this->FindClosestPointWithinRadius(x, VTK_DOUBLE_MAX, closestPoint, cell,
+                                     cellId, subId, dist2, inside);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkStaticCellLocator::FindClosestPointWithinRadius(
+  double x[3], double radius, double closestPoint[3], vtkGenericCell *cell,
+  vtkIdType &cellId, int &subId, double& dist2, int &inside)
+{
+  cellId = -1;
+  this->BuildLocator();
+  if (!this->Tree)
+    {
+    return 0;
+    }
+
+  double weightsBuffer[VTK_CELL_SIZE];
+  vtkstd::vector<double> weightsVector;
+  double *weights = weightsBuffer;
+  if (this->MaxCellSize > VTK_CELL_SIZE)
+    {
+    weightsVector.resize(this->MaxCellSize);
+    weights = &weightsVector[0];
+    }
+
+  // Nearest boxes first, and skip boxes farther than the closest point.
+  double best2 = (radius < sqrt(VTK_DOUBLE_MAX) ? radius*radius :
+                  VTK_DOUBLE_MAX);
+  vtkIdType stack[VTK_STATIC_CELL_LOCATOR_STACK_SIZE];
+  double stackD2[VTK_STATIC_CELL_LOCATOR_STACK_SIZE];
+  int top = 0;
+  stack[top] = 0;
+  stackD2[top++] = 0.0;
+  double cellClosest[3], cellDist2, pcoords[3];
+  int cellSubId;
+  while (top > 0)
+    {
+    --top;
+    if (stackD2[top] > best2)
+      {
+      continue;
+      }
+    const vtkStaticCellLocatorNode& node = this->Tree->Nodes[stack[top]];
+    int children[4];
+    double childD2[4];
+    int numChildren = 0;
+    for (int i = 0; i < 4; i++)
+      {
+      if (node.Count[i] < 0)
+        {
+        continue;
+        }
+      double lo[3] = { node.Min[0][i], node.Min[1][i], node.Min[2][i] };
+      double hi[3] = { node.Max[0][i], node.Max[1][i], node.Max[2][i] };
+      double d2 = vtkStaticCellLocatorDistance2(x, lo, hi);
+      if (d2 > best2)
+        {
+        continue;
+        }
+      if (node.Count[i] == 0)
+        {
+        childD2[i] = d2;
+        children[numChildren++] = i;
+        continue;
+        }
+      const vtkIdType *ids = &this->Tree->CellIds[node.Child[i]];
+      for (int c = 0; c < node.Count[i]; c++)
+        {
+        const double *b = this->CellBounds[ids[c]];
+        double blo[3] = { b[0], b[2], b[4] };
+        double bhi[3] = { b[1], b[3], b[5] };
+        if (vtkStaticCellLocatorDistance2(x, blo, bhi) > best2)
+          {
+          continue;
+          }
+        this->DataSet->GetCell(ids[c], cell);
+        int cellInside = cell->EvaluatePosition(x, cellClosest, cellSubId,
+                                                pcoords, cellDist2, weights);
+        if (cellInside != -1 &&
+            (cellDist2 < best2 || (cellId < 0 && cellDist2 <= best2) ||
+             (cellDist2 == best2 && ids[c] < cellId)))
+          {
+          best2 = cellDist2;
+          cellId = ids[c];
+          subId = cellSubId;
+          inside = cellInside;
+          dist2 = cellDist2;
+          for (int a = 0; a < 3; a++)
+            {
+            closestPoint[a] = cellClosest[a];
+            }
+          }
+        }
+      }
+    for (int n = 0; n < numChildren; n++)
+      {
+      for (int m = n + 1; m < numChildren; m++)
+        {
+        if (childD2[children[m]] > childD2[children[n]])
+          {
+          vtkstd::swap(children[n], children[m]);
+          }
+        }
+      stack[top] = node.Child[children[n]];
+      stackD2[top++] = childD2[children[n]];
+      }
+    }
+
+  if (cellId >= 0)
+    {
+    this->DataSet->GetCell(cellId, cell);
+    return 1;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::FindCellsWithinBounds(double *bbox,
+                                                 vtkIdList *cells)
+{
+  cells->Reset();
+  this->BuildLocator();
+  if (!this->Tree)
+    {
+    return;
+    }
+
+  float lo[3], hi[3];
+  for (int a = 0; a < 3; a++)
+    {
+    lo[a] = vtkStaticCellLocatorFloatDown(bbox[2*a]);
+    hi[a] = vtkStaticCellLocatorFloatUp(bbox[2*a+1]);
+    }
+  vtkIdType stack[VTK_STATIC_CELL_LOCATOR_STACK_SIZE];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+    {
+    const vtkStaticCellLocatorNode& node = this->Tree->Nodes[stack[--top]];
+    int mask = vtkStaticCellLocatorOverlap(node, lo, hi);
+    for (int i = 3; i >= 0; i--)
+      {
+      if (!(mask & (1 << i)) || node.Count[i] < 0)
+        {
+        continue;
+        }
+      if (node.Count[i] == 0)
+        {
+        stack[top++] = node.Child[i];
+        continue;
+        }
+      const vtkIdType *ids = &this->Tree->CellIds[node.Child[i]];
+      for (int c = 0; c < node.Count[i]; c++)
+        {
+        const double *b = this->CellBounds[ids[c]];
+        if (b[0] <= bbox[1] && bbox[0] <= b[1] &&
+            b[2] <= bbox[3] && bbox[2] <= b[3] &&
+            b[4] <= bbox[5] && bbox[4] <= b[5])
+          {
+          cells->InsertNextId(ids[c]);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::FindCellsAlongLine(double p1[3], double p2[3],
+                                              double tolerance,
+                                              vtkIdList *cells)
+{
+  cells->Reset();
+  this->BuildLocator();
+  if (!this->Tree)
+    {
+    return;
+    }
+
+  float origin[3], invDir[3], tNear[4];
+  vtkStaticCellLocatorRay(p1, p2, origin, invDir);
+  double pad = tolerance + this->Tree->Padding;
+  float fpad = vtkStaticCellLocatorFloatUp(pad);
+  float tMax = vtkStaticCellLocatorFloatUp(1.0 + 1e-6);
+  vtkIdType stack[VTK_STATIC_CELL_LOCATOR_STACK_SIZE];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+    {
+    const vtkStaticCellLocatorNode& node = this->Tree->Nodes[stack[--top]];
+    int mask = vtkStaticCellLocatorSlabs(node, origin, invDir, fpad, tMax,
+                                         tNear);
+    for (int i = 3; i >= 0; i--)
+      {
+      if (!(mask & (1 << i)) || node.Count[i] < 0)
+        {
+        continue;
+        }
+      if (node.Count[i] == 0)
+        {
+        stack[top++] = node.Child[i];
+        continue;
+        }
+      const vtkIdType *ids = &this->Tree->CellIds[node.Child[i]];
+      for (int c = 0; c < node.Count[i]; c++)
+        {
+        if (vtkStaticCellLocatorSegmentHitsBounds(
+              p1, p2, this->CellBounds[ids[c]], tolerance))
+          {
+          cells->InsertNextId(ids[c]);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkStaticCellLocator::InsideCellBounds(double x[3], vtkIdType cellId)
+{
+  if (!this->CellBounds)
+    {
+    return this->Superclass::InsideCellBounds(x, cellId);
+    }
+  const double *b = this->CellBounds[cellId];
+  return (x[0] >= b[0] && x[0] <= b[1] && x[1] >= b[2] && x[1] <= b[3] &&
+          x[2] >= b[4] && x[2] <= b[5]);
+}
+
+//----------------------------------------------------------------------------
+// Generate the boxes of the nodes at the given depth of the four-wide
+// tree, or of the leaves for a negative level.
+void vtkStaticCellLocator::GenerateRepresentation(int level, vtkPolyData *pd)
+{
+  if (!this->Tree)
+    {
+    vtkErrorMacro(<<"Can't build representation...no data!");
+    return;
+    }
+
+  vtkPoints *pts = vtkPoints::New();
+  vtkCellArray *polys = vtkCellArray::New();
+  static const int faces[6][4] = { {0,2,6,4}, {1,5,7,3}, {0,4,5,1},
+                                   {2,3,7,6}, {0,1,3,2}, {4,6,7,5} };
+
+  vtkstd::vector<vtkstd::pair<vtkIdType, int> > stack;
+  stack.push_back(vtkstd::pair<vtkIdType, int>(0, 0));
+  while (!stack.empty())
+    {
+    vtkIdType index = stack.back().first;
+    int depth = stack.back().second;
+    stack.pop_back();
+    const vtkStaticCellLocatorNode& node = this->Tree->Nodes[index];
+    for (int i = 0; i < 4; i++)
+      {
+      if (node.Count[i] < 0)
+        {
+        continue;
+        }
+      if (node.Count[i] == 0 && depth != level)
+        {
+        stack.push_back(vtkstd::pair<vtkIdType, int>(node.Child[i],
+                                                     depth + 1));
+        continue;
+        }
+      if (depth != level && level >= 0)
+        {
+        continue;
+        }
+      vtkIdType ids[8];
+      for (int c = 0; c < 8; c++)
+        {
+        ids[c] = pts->InsertNextPoint(
+          (c & 1) ? node.Max[0][i] : node.Min[0][i],
+          (c & 2) ? node.Max[1][i] : node.Min[1][i],
+          (c & 4) ? node.Max[2][i] : node.Min[2][i]);
+        }
+      for (int f = 0; f < 6; f++)
+        {
+        vtkIdType quad[4] = { ids[faces[f][0]], ids[faces[f][1]],
+                              ids[faces[f][2]], ids[faces[f][3]] };
+        polys->InsertNextCell(4, quad);
+        }
+      }
+    }
+
+  pd->SetPoints(pts);
+  pts->Delete();
+  pd->SetPolys(polys);
+  polys->Delete();
+  pd->Squeeze();
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Nodes: " << this->GetNumberOfNodes() << "\n";
+  os << indent << "Max Cell Size: " << this->MaxCellSize << "\n";
+}
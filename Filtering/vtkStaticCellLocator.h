@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStaticCellLocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkStaticCellLocator - bounding volume hierarchy of the cells of a dataset that does not change
+// .SECTION Description
+// vtkStaticCellLocator organizes the cells of a dataset in a bounding
+// volume hierarchy (BVH).  The hierarchy is built top-down with the
+// binned surface area heuristic: the cell bounds and the bins of large
+// nodes are computed in parallel, and the subtrees below a fixed size are
+// built in parallel.  The tree is then flattened into an array of nodes
+// with four children each.  The boxes of the four children are stored
+// together, so one node test checks all four boxes at once, with SSE
+// instructions when they are available.  Leaves refer to runs of a single
+// array of cell ids.
+//
+// The tree does not depend on the number of threads used to build it.
+// Once BuildLocator() has been called, every query that takes a
+// vtkGenericCell (and for FindCell the pcoords and weights buffers) only
+// reads the locator, so several threads can query it at once, each with
+// its own buffers.  IntersectWithLines() intersects a batch of lines in
+// parallel.
+//
+// NumberOfCellsPerNode sets the maximum number of cells in a leaf.
+//
+// .SECTION See Also
+// vtkCellLocator vtkModifiedBSPTree vtkStaticPointLocator vtkSMPTools
+
+#ifndef __vtkStaticCellLocator_h
+#define __vtkStaticCellLocator_h
+
+#include "vtkAbstractCellLocator.h"
+
+class vtkStaticCellLocatorTree;
+
+class VTK_FILTERING_EXPORT vtkStaticCellLocator : public vtkAbstractCellLocator
+{
+public:
+  // Description:
+  // Construct with at most 8 cells per leaf.
+  static vtkStaticCellLocator *New();
+  vtkTypeMacro(vtkStaticCellLocator,vtkAbstractCellLocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+//BTX
+  using vtkAbstractCellLocator::IntersectWithLine;
+  using vtkAbstractCellLocator::FindClosestPoint;
+  using vtkAbstractCellLocator::FindClosestPointWithinRadius;
+  using vtkAbstractCellLocator::FindCell;
+//ETX
+
+  // Description:
+  // Return the first intersection of the finite line (p1,p2) with the
+  // cells, along with the cell that was hit.  Thread safe.
+  virtual int IntersectWithLine(
+    double p1[3], double p2[3], double tol, double& t, double x[3],
+    double pcoords[3], int &subId, vtkIdType &cellId, vtkGenericCell *cell);
+
+  // Description:
+  // Intersect numLines lines in parallel.  lines holds the two end points
+  // (six values) of every line.  For every line, cellIds receives the
+  // first cell hit or -1, and t the parametric coordinate of the hit
+  // along the line.
+  void IntersectWithLines(vtkIdType numLines, const double *lines,
+                          double tol, vtkIdType *cellIds, double *t);
+
+  // Description:
+  // Return the closest point and the cell which is closest to the point
+  // x.  Thread safe.
+  virtual void FindClosestPoint(
+    double x[3], double closestPoint[3], vtkGenericCell *cell,
+    vtkIdType &cellId, int &subId, double& dist2);
+
+  // Description:
+  // Return the closest point within radius of x and its cell.  Returns 1
+  // if a point was found.  inside is the result of EvaluatePosition() for
+  // the closest cell.  Thread safe.
+  virtual vtkIdType FindClosestPointWithinRadius(
+    double x[3], double radius, double closestPoint[3],
+    vtkGenericCell *cell, vtkIdType &cellId, int &subId, double& dist2,
+    int &inside);
+
+  // Description:
+  // Return the ids of the cells whose bounds overlap bbox.
+  virtual void FindCellsWithinBounds(double *bbox, vtkIdList *cells);
+
+  // Description:
+  // Return the ids of the cells whose bounds, padded by tolerance,
+  // intersect the line (p1,p2).
+  virtual void FindCellsAlongLine(
+    double p1[3], double p2[3], double tolerance, vtkIdList *cells);
+
+  // Description:
+  // Find the cell containing x, or -1.  cell, pcoords and weights (at
+  // least as many as the largest cell has points) are scratch buffers
+  // provided by the caller; a thread that uses its own buffers can call
+  // this concurrently with other threads.  As for vtkDataSet::FindCell(),
+  // x must lie inside the cell and within sqrt(tol2) of it, which matters
+  // for cells of lower dimension than the space.
+  virtual vtkIdType FindCell(
+    double x[3], double tol2, vtkGenericCell *cell, double pcoords[3],
+    double *weights);
+
+  // Description:
+  // Test whether x is inside the bounds of a cell.
+  virtual bool InsideCellBounds(double x[3], vtkIdType cellId);
+
+  // Description:
+  // Return the number of four-wide nodes of the hierarchy.
+  vtkIdType GetNumberOfNodes();
+
+  // Description:
+  // See vtkLocator interface documentation.
+  // These methods are not thread safe.
+  virtual void FreeSearchStructure();
+  virtual void BuildLocator();
+  virtual void GenerateRepresentation(int level, vtkPolyData *pd);
+
+protected:
+  vtkStaticCellLocator();
+  ~vtkStaticCellLocator();
+
+  vtkStaticCellLocatorTree *Tree;
+  int MaxCellSize;
+
+private:
+  vtkStaticCellLocator(const vtkStaticCellLocator&);  // Not implemented.
+  void operator=(const vtkStaticCellLocator&);  // Not implemented.
+};
+
+#endif
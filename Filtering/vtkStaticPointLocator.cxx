@@ -0,0 +1,863 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStaticPointLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkStaticPointLocator.h"
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/utility>
+#include <vtkstd/vector>
+
+vtkStandardNewMacro(vtkStaticPointLocator);
+
+// Number of (bucket, point id) pairs that one thread sorts before the
+// sorted runs are merged.
+#define VTK_STATIC_POINT_LOCATOR_RUN_SIZE 65536
+
+// With automatic divisions, directions shorter than this fraction of the
+// longest one are flat.
+#define VTK_STATIC_POINT_LOCATOR_FLAT_TOL 1.0e-06
+
+// With automatic divisions, at most this many times the requested number
+// of buckets are created.
+#define VTK_STATIC_POINT_LOCATOR_MAX_BUCKET_FACTOR 8.0
+
+//----------------------------------------------------------------------------
+// The ijk indices of a set of buckets.
+class vtkStaticPointLocatorBuckets
+{
+public:
+  vtkstd::vector<int> IJK;
+  int GetNumberOfBuckets()
+    {
+    return static_cast<int>(this->IJK.size() / 3);
+    }
+  const int *GetBucket(int i)
+    {
+    return &this->IJK[3*i];
+    }
+  void InsertNextBucket(int i, int j, int k)
+    {
+    this->IJK.push_back(i);
+    this->IJK.push_back(j);
+    this->IJK.push_back(k);
+    }
+};
+
+//----------------------------------------------------------------------------
+// A point and the bucket it falls into, sorted by bucket and then by id so
+// that the order does not depend on the sort.
+struct vtkStaticPointLocatorTuple
+{
+  vtkIdType Bucket;
+  vtkIdType PtId;
+  bool operator<(const vtkStaticPointLocatorTuple& other) const
+    {
+    return (this->Bucket < other.Bucket ||
+            (this->Bucket == other.Bucket && this->PtId < other.PtId));
+    }
+};
+
+//----------------------------------------------------------------------------
+// Compute the bucket of every point in a range.
+class vtkStaticPointLocatorBin
+{
+public:
+  vtkDataSet *DataSet;
+  vtkStaticPointLocatorTuple *Tuples;
+  double Bounds[6];
+  int Divisions[3];
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    double x[3];
+    vtkIdType product =
+      static_cast<vtkIdType>(this->Divisions[0]) * this->Divisions[1];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->DataSet->GetPoint(ptId, x);
+      int ijk[3];
+      for (int j = 0; j < 3; ++j)
+        {
+        ijk[j] = static_cast<int>(
+          ((x[j] - this->Bounds[2*j]) /
+           (this->Bounds[2*j+1] - this->Bounds[2*j])) * this->Divisions[j]);
+        if (ijk[j] < 0)
+          {
+          ijk[j] = 0;
+          }
+        else if (ijk[j] >= this->Divisions[j])
+          {
+          ijk[j] = this->Divisions[j] - 1;
+          }
+        }
+      this->Tuples[ptId].Bucket = ijk[0] +
+        static_cast<vtkIdType>(ijk[1]) * this->Divisions[0] + ijk[2] * product;
+      this->Tuples[ptId].PtId = ptId;
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Sort runs of RunSize tuples.
+class vtkStaticPointLocatorSortRuns
+{
+public:
+  vtkStaticPointLocatorTuple *Tuples;
+  vtkIdType NumberOfTuples;
+  vtkIdType RunSize;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType run = begin; run < end; ++run)
+      {
+      vtkIdType first = run * this->RunSize;
+      vtkIdType last = vtkstd::min(first + this->RunSize,
+                                   this->NumberOfTuples);
+      vtkstd::sort(this->Tuples + first, this->Tuples + last);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Merge pairs of sorted runs of RunSize tuples from Input into Output.
+class vtkStaticPointLocatorMergeRuns
+{
+public:
+  vtkStaticPointLocatorTuple *Input;
+  vtkStaticPointLocatorTuple *Output;
+  vtkIdType NumberOfTuples;
+  vtkIdType RunSize;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType pair = begin; pair < end; ++pair)
+      {
+      vtkIdType first = 2 * pair * this->RunSize;
+      vtkIdType middle = vtkstd::min(first + this->RunSize,
+                                     this->NumberOfTuples);
+      vtkIdType last = vtkstd::min(middle + this->RunSize,
+                                   this->NumberOfTuples);
+      vtkstd::merge(this->Input + first, this->Input + middle,
+                    this->Input + middle, this->Input + last,
+                    this->Output + first);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Sort the tuples: sort runs in parallel, then merge pairs of runs in
+// parallel until a single run is left.  The result ends up in tuples.
+static void vtkStaticPointLocatorSort(vtkStaticPointLocatorTuple *tuples,
+                                      vtkIdType numTuples)
+{
+  vtkIdType runSize = VTK_STATIC_POINT_LOCATOR_RUN_SIZE;
+  vtkIdType numRuns = (numTuples + runSize - 1) / runSize;
+
+  vtkStaticPointLocatorSortRuns sortRuns;
+  sortRuns.Tuples = tuples;
+  sortRuns.NumberOfTuples = numTuples;
+  sortRuns.RunSize = runSize;
+  vtkSMPTools::For(0, numRuns, 1, sortRuns);
+  if (numRuns < 2)
+    {
+    return;
+    }
+
+  vtkStaticPointLocatorTuple *buffer =
+    new vtkStaticPointLocatorTuple[numTuples];
+  vtkStaticPointLocatorMergeRuns mergeRuns;
+  mergeRuns.Input = tuples;
+  mergeRuns.Output = buffer;
+  mergeRuns.NumberOfTuples = numTuples;
+  for (; runSize < numTuples; runSize *= 2)
+    {
+    mergeRuns.RunSize = runSize;
+    vtkIdType numPairs = (numTuples + 2*runSize - 1) / (2*runSize);
+    vtkSMPTools::For(0, numPairs, 1, mergeRuns);
+    vtkstd::swap(mergeRuns.Input, mergeRuns.Output);
+    }
+  if (mergeRuns.Input != tuples)
+    {
+    vtkstd::copy(buffer, buffer + numTuples, tuples);
+    }
+  delete [] buffer;
+}
+
+//----------------------------------------------------------------------------
+// Extract the sorted point ids and the first position of every bucket.
+class vtkStaticPointLocatorOffsets
+{
+public:
+  const vtkStaticPointLocatorTuple *Tuples;
+  vtkIdType *PointIds;
+  vtkIdType *Offsets;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->PointIds[i] = this->Tuples[i].PtId;
+      // Buckets between the previous tuple's and this one's start here;
+      // every bucket is written by exactly one tuple.
+      vtkIdType bucket = (i > 0 ? this->Tuples[i-1].Bucket + 1 : 0);
+      for (; bucket <= this->Tuples[i].Bucket; ++bucket)
+        {
+        this->Offsets[bucket] = i;
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkStaticPointLocator::vtkStaticPointLocator()
+{
+  this->Divisions[0] = this->Divisions[1] = this->Divisions[2] = 50;
+  this->NumberOfPointsPerBucket = 5;
+  this->H[0] = this->H[1] = this->H[2] = 0.0;
+  this->NumberOfBuckets = 0;
+  this->Offsets = NULL;
+  this->PointIds = NULL;
+  this->FloatPoints = NULL;
+  this->DoublePoints = NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkStaticPointLocator::~vtkStaticPointLocator()
+{
+  this->FreeSearchStructure();
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticPointLocator::FreeSearchStructure()
+{
+  delete [] this->Offsets;
+  this->Offsets = NULL;
+  delete [] this->PointIds;
+  this->PointIds = NULL;
+  this->NumberOfBuckets = 0;
+  this->FloatPoints = NULL;
+  this->DoublePoints = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticPointLocator::BuildLocator()
+{
+  if ( (this->Offsets != NULL) && (this->BuildTime > this->MTime)
+       && (this->BuildTime > this->DataSet->GetMTime()) )
+    {
+    return;
+    }
+
+  vtkDebugMacro( << "Binning points..." );
+  this->Level = 1; //only single lowest level
+
+  vtkIdType numPts;
+  if ( !this->DataSet || (numPts = this->DataSet->GetNumberOfPoints()) < 1 )
+    {
+    vtkErrorMacro( << "No points to subdivide");
+    return;
+    }
+  this->FreeSearchStructure();
+
+  // Size the buckets.  With automatic divisions the buckets are roughly
+  // cubes holding NumberOfPointsPerBucket points on average.  Directions
+  // that are flat, or much thinner than a bucket, get a single division.
+  int i;
+  double *bounds = this->DataSet->GetBounds();
+  double lengths[3], maxLength = 0.0;
+  for (i=0; i<3; i++)
+    {
+    this->Bounds[2*i] = bounds[2*i];
+    this->Bounds[2*i+1] = bounds[2*i+1];
+    lengths[i] = bounds[2*i+1] - bounds[2*i];
+    maxLength = (lengths[i] > maxLength ? lengths[i] : maxLength);
+    if ( lengths[i] <= 0.0 ) //prevent zero width
+      {
+      this->Bounds[2*i+1] = this->Bounds[2*i] + 1.0;
+      }
+    }
+
+  int ndivs[3];
+  if ( this->Automatic )
+    {
+    double numBuckets = static_cast<double>(numPts) /
+      this->NumberOfPointsPerBucket;
+    numBuckets = (numBuckets < 1.0 ? 1.0 : numBuckets);
+    int flat[3];
+    for (i=0; i<3; i++)
+      {
+      flat[i] = (lengths[i] <= VTK_STATIC_POINT_LOCATOR_FLAT_TOL * maxLength);
+      }
+
+    // Find the bucket size over the directions that are not flat.  A
+    // direction shorter than that size is flat too, and the size is
+    // computed again without it.
+    double h = 1.0;
+    int numDims, changed;
+    do
+      {
+      double volume = 1.0;
+      numDims = 0;
+      for (i=0; i<3; i++)
+        {
+        if ( !flat[i] )
+          {
+          volume *= lengths[i];
+          numDims++;
+          }
+        }
+      if ( numDims == 0 )
+        {
+        break;
+        }
+      h = pow(volume / numBuckets, 1.0 / numDims);
+      changed = 0;
+      for (i=0; i<3; i++)
+        {
+        if ( !flat[i] && lengths[i] < h )
+          {
+          flat[i] = 1;
+          changed = 1;
+          }
+        }
+      }
+    while ( changed );
+
+    double product = 1.0;
+    for (i=0; i<3; i++)
+      {
+      double n = (flat[i] ? 1.0 : ceil(lengths[i] / h - 0.5));
+      ndivs[i] = static_cast<int>(n < 1.0 ? 1.0 : n);
+      product *= ndivs[i];
+      }
+
+    // Rounding can only add a few buckets, but never allow many more
+    // buckets than asked for.
+    double maxBuckets = VTK_STATIC_POINT_LOCATOR_MAX_BUCKET_FACTOR *
+      numBuckets;
+    if ( numDims > 0 && product > maxBuckets )
+      {
+      double scale = pow(maxBuckets / product, 1.0 / numDims);
+      for (i=0; i<3; i++)
+        {
+        if ( !flat[i] )
+          {
+          ndivs[i] = static_cast<int>(ndivs[i] * scale);
+          ndivs[i] = (ndivs[i] > 0 ? ndivs[i] : 1);
+          }
+        }
+      }
+    }
+  else
+    {
+    for (i=0; i<3; i++)
+      {
+      ndivs[i] = this->Divisions[i];
+      }
+    }
+  for (i=0; i<3; i++)
+    {
+    this->Divisions[i] = (ndivs[i] > 0 ? ndivs[i] : 1);
+    this->H[i] = (this->Bounds[2*i+1] - this->Bounds[2*i]) /
+      this->Divisions[i];
+    }
+  this->NumberOfBuckets = static_cast<vtkIdType>(this->Divisions[0]) *
+    this->Divisions[1] * this->Divisions[2];
+
+  // Look up point coordinates directly in the points array when possible.
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(this->DataSet);
+  vtkDataArray *pointData =
+    (pointSet && pointSet->GetPoints() ? pointSet->GetPoints()->GetData() :
+     NULL);
+  if ( pointData && pointData->GetDataType() == VTK_FLOAT )
+    {
+    this->FloatPoints = static_cast<float *>(pointData->GetVoidPointer(0));
+    }
+  else if ( pointData && pointData->GetDataType() == VTK_DOUBLE )
+    {
+    this->DoublePoints = static_cast<double *>(pointData->GetVoidPointer(0));
+    }
+
+  // Bin the points and sort them by bucket.  GetPoint() of the structured
+  // datasets computes their dimensions the first time, do that here.
+  double x[3];
+  this->DataSet->GetPoint(0, x);
+  vtkStaticPointLocatorTuple *tuples = new vtkStaticPointLocatorTuple[numPts];
+  vtkStaticPointLocatorBin bin;
+  bin.DataSet = this->DataSet;
+  bin.Tuples = tuples;
+  for (i=0; i<3; i++)
+    {
+    bin.Bounds[2*i] = this->Bounds[2*i];
+    bin.Bounds[2*i+1] = this->Bounds[2*i+1];
+    bin.Divisions[i] = this->Divisions[i];
+    }
+  vtkSMPTools::For(0, numPts, bin);
+  vtkStaticPointLocatorSort(tuples, numPts);
+
+  this->PointIds = new vtkIdType[numPts];
+  this->Offsets = new vtkIdType[this->NumberOfBuckets + 1];
+  vtkStaticPointLocatorOffsets offsets;
+  offsets.Tuples = tuples;
+  offsets.PointIds = this->PointIds;
+  offsets.Offsets = this->Offsets;
+  vtkSMPTools::For(0, numPts, offsets);
+  for (vtkIdType bucket = tuples[numPts-1].Bucket + 1;
+       bucket <= this->NumberOfBuckets; bucket++)
+    {
+    this->Offsets[bucket] = numPts;
+    }
+  delete [] tuples;
+
+  this->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+inline void vtkStaticPointLocator::GetPoint(vtkIdType ptId, double x[3])
+{
+  if ( this->FloatPoints )
+    {
+    const float *p = this->FloatPoints + 3*ptId;
+    x[0] = p[0];
+    x[1] = p[1];
+    x[2] = p[2];
+    }
+  else if ( this->DoublePoints )
+    {
+    const double *p = this->DoublePoints + 3*ptId;
+    x[0] = p[0];
+    x[1] = p[1];
+    x[2] = p[2];
+    }
+  else
+    {
+    this->DataSet->GetPoint(ptId, x);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticPointLocator::GetBucketIndices(const double x[3], int ijk[3])
+{
+  for (int j=0; j<3; j++)
+    {
+    ijk[j] = static_cast<int>(
+      ((x[j] - this->Bounds[2*j]) /
+       (this->Bounds[2*j+1] - this->Bounds[2*j])) * this->Divisions[j]);
+
+    if (ijk[j] < 0)
+      {
+      ijk[j] = 0;
+      }
+    else if (ijk[j] >= this->Divisions[j])
+      {
+      ijk[j] = this->Divisions[j] - 1;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticPointLocator::GetShell(vtkStaticPointLocatorBuckets *buckets,
+                                     const int ijk[3], int level)
+{
+  int minLevel[3], maxLevel[3];
+  for (int j=0; j<3; j++)
+    {
+    minLevel[j] = vtkstd::max(ijk[j] - level, 0);
+    maxLevel[j] = vtkstd::min(ijk[j] + level, this->Divisions[j] - 1);
+    }
+
+  buckets->IJK.clear();
+  for (int k = minLevel[2]; k <= maxLevel[2]; k++)
+    {
+    int kOnShell = (k == ijk[2] - level || k == ijk[2] + level);
+    for (int j = minLevel[1]; j <= maxLevel[1]; j++)
+      {
+      if ( kOnShell || j == ijk[1] - level || j == ijk[1] + level )
+        {
+        for (int i = minLevel[0]; i <= maxLevel[0]; i++)
+          {
+          buckets->InsertNextBucket(i, j, k);
+          }
+        }
+      else
+        {
+        // Only the two ends of the row are on the shell.
+        if ( ijk[0] - level >= 0 )
+          {
+          buckets->InsertNextBucket(ijk[0] - level, j, k);
+          }
+        if ( level > 0 && ijk[0] + level < this->Divisions[0] )
+          {
+          buckets->InsertNextBucket(ijk[0] + level, j, k);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkStaticPointLocator::Distance2OutsideLevel(const double x[3],
+                                                    const int ijk[3],
+                                                    int level)
+{
+  double d = VTK_DOUBLE_MAX;
+  for (int j=0; j<3; j++)
+    {
+    if ( ijk[j] - level > 0 )
+      {
+      d = vtkstd::min(d, x[j] - (this->Bounds[2*j] +
+                                 (ijk[j] - level) * this->H[j]));
+      }
+    if ( ijk[j] + level < this->Divisions[j] - 1 )
+      {
+      d = vtkstd::min(d, this->Bounds[2*j] +
+                      (ijk[j] + level + 1) * this->H[j] - x[j]);
+      }
+    }
+  if ( d == VTK_DOUBLE_MAX )
+    {
+    return VTK_DOUBLE_MAX;
+    }
+  return (d > 0.0 ? d*d : 0.0);
+}
+
+//----------------------------------------------------------------------------
+double vtkStaticPointLocator::Distance2ToBucket(const double x[3],
+                                                int i, int j, int k)
+{
+  int ijk[3] = { i, j, k };
+  double d2 = 0.0;
+  for (int n=0; n<3; n++)
+    {
+    double lo = this->Bounds[2*n] + ijk[n] * this->H[n];
+    double delta = 0.0;
+    if ( x[n] < lo )
+      {
+      delta = lo - x[n];
+      }
+    else if ( x[n] > lo + this->H[n] )
+      {
+      delta = x[n] - lo - this->H[n];
+      }
+    d2 += delta * delta;
+    }
+  return d2;
+}
+
+//----------------------------------------------------------------------------
+// Given a position x, return the id of the point closest to it.  Search
+// shells of buckets around the bucket of x until no bucket outside the
+// searched ones can be closer than the closest point found.
+vtkIdType vtkStaticPointLocator::FindClosestPoint(const double x[3])
+{
+  double dist2;
+  return this->FindClosestPointWithinRadius(VTK_DOUBLE_MAX, x, dist2);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkStaticPointLocator::FindClosestPointWithinRadius(
+  double radius, const double x[3], double& dist2)
+{
+  dist2 = -1.0;
+  if ( !this->DataSet || this->DataSet->GetNumberOfPoints() < 1 )
+    {
+    return -1;
+    }
+  this->BuildLocator(); // will rebuild if modified; otherwise returns
+
+  double radius2 = (radius < sqrt(VTK_DOUBLE_MAX) ? radius*radius :
+                    VTK_DOUBLE_MAX);
+  double minDist2 = VTK_DOUBLE_MAX;
+  vtkIdType closest = -1;
+  int ijk[3];
+  this->GetBucketIndices(x, ijk);
+
+  vtkStaticPointLocatorBuckets buckets;
+  double pt[3];
+  for (int level = 0; ; level++)
+    {
+    this->GetShell(&buckets, ijk, level);
+    for (int b = 0; b < buckets.GetNumberOfBuckets(); b++)
+      {
+      const int *nei = buckets.GetBucket(b);
+      double bucketDist2 = this->Distance2ToBucket(x, nei[0], nei[1], nei[2]);
+      if ( bucketDist2 >= minDist2 || bucketDist2 > radius2 )
+        {
+        continue;
+        }
+      vtkIdType cno = nei[0] + static_cast<vtkIdType>(nei[1]) *
+        this->Divisions[0] + static_cast<vtkIdType>(nei[2]) *
+        this->Divisions[0] * this->Divisions[1];
+      for (vtkIdType j = this->Offsets[cno]; j < this->Offsets[cno+1]; j++)
+        {
+        vtkIdType ptId = this->PointIds[j];
+        this->GetPoint(ptId, pt);
+        double d2 = vtkMath::Distance2BetweenPoints(x, pt);
+        if ( d2 < minDist2 && d2 <= radius2 )
+          {
+          closest = ptId;
+          minDist2 = d2;
+          }
+        }
+      }
+
+    double outside2 = this->Distance2OutsideLevel(x, ijk, level);
+    if ( outside2 == VTK_DOUBLE_MAX || minDist2 <= outside2 ||
+         radius2 < outside2 )
+      {
+      break;
+      }
+    }
+
+  if ( closest != -1 )
+    {
+    dist2 = minDist2;
+    }
+  return closest;
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticPointLocator::FindClosestNPoints(int N, const double x[3],
+                                               vtkIdList *result)
+{
+  result->Reset();
+  if ( N < 1 || !this->DataSet || this->DataSet->GetNumberOfPoints() < 1 )
+    {
+    return;
+    }
+  this->BuildLocator(); // will rebuild if modified; otherwise returns
+
+  // Keep the N closest points in a max-heap ordered by distance and id.
+  typedef vtkstd::pair<double, vtkIdType> DistanceId;
+  vtkstd::vector<DistanceId> heap;
+  heap.reserve(N);
+
+  int ijk[3];
+  this->GetBucketIndices(x, ijk);
+  vtkStaticPointLocatorBuckets buckets;
+  double pt[3];
+  for (int level = 0; ; level++)
+    {
+    this->GetShell(&buckets, ijk, level);
+    for (int b = 0; b < buckets.GetNumberOfBuckets(); b++)
+      {
+      const int *nei = buckets.GetBucket(b);
+      if ( static_cast<int>(heap.size()) == N &&
+           this->Distance2ToBucket(x, nei[0], nei[1], nei[2]) >
+           heap.front().first )
+        {
+        continue;
+        }
+      vtkIdType cno = nei[0] + static_cast<vtkIdType>(nei[1]) *
+        this->Divisions[0] + static_cast<vtkIdType>(nei[2]) *
+        this->Divisions[0] * this->Divisions[1];
+      for (vtkIdType j = this->Offsets[cno]; j < this->Offsets[cno+1]; j++)
+        {
+        vtkIdType ptId = this->PointIds[j];
+        this->GetPoint(ptId, pt);
+        DistanceId candidate(vtkMath::Distance2BetweenPoints(x, pt), ptId);
+        if ( static_cast<int>(heap.size()) < N )
+          {
+          heap.push_back(candidate);
+          vtkstd::push_heap(heap.begin(), heap.end());
+          }
+        else if ( candidate < heap.front() )
+          {
+          vtkstd::pop_heap(heap.begin(), heap.end());
+          heap.back() = candidate;
+          vtkstd::push_heap(heap.begin(), heap.end());
+          }
+        }
+      }
+
+    double outside2 = this->Distance2OutsideLevel(x, ijk, level);
+    if ( outside2 == VTK_DOUBLE_MAX ||
+         (static_cast<int>(heap.size()) == N &&
+          heap.front().first <= outside2) )
+      {
+      break;
+      }
+    }
+
+  vtkstd::sort_heap(heap.begin(), heap.end());
+  result->SetNumberOfIds(static_cast<vtkIdType>(heap.size()));
+  for (size_t i = 0; i < heap.size(); i++)
+    {
+    result->SetId(static_cast<vtkIdType>(i), heap[i].second);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticPointLocator::FindPointsWithinRadius(double R,
+                                                   const double x[3],
+                                                   vtkIdList *result)
+{
+  result->Reset();
+  if ( !this->DataSet || this->DataSet->GetNumberOfPoints() < 1 )
+    {
+    return;
+    }
+  this->BuildLocator(); // will rebuild if modified; otherwise returns
+
+  // Range of buckets overlapping the box around the sphere.
+  int minIJK[3], maxIJK[3];
+  for (int j=0; j<3; j++)
+    {
+    double lo = floor((x[j] - R - this->Bounds[2*j]) / this->H[j]);
+    double hi = floor((x[j] + R - this->Bounds[2*j]) / this->H[j]);
+    if ( hi < 0.0 || lo >= this->Divisions[j] )
+      {
+      return;
+      }
+    minIJK[j] = (lo < 0.0 ? 0 : static_cast<int>(lo));
+    maxIJK[j] = (hi >= this->Divisions[j] ? this->Divisions[j] - 1 :
+                 static_cast<int>(hi));
+    }
+
+  double R2 = R*R;
+  double pt[3];
+  vtkIdType product =
+    static_cast<vtkIdType>(this->Divisions[0]) * this->Divisions[1];
+  for (int k = minIJK[2]; k <= maxIJK[2]; k++)
+    {
+    for (int j = minIJK[1]; j <= maxIJK[1]; j++)
+      {
+      for (int i = minIJK[0]; i <= maxIJK[0]; i++)
+        {
+        if ( this->Distance2ToBucket(x, i, j, k) > R2 )
+          {
+          continue;
+          }
+        vtkIdType cno = i + static_cast<vtkIdType>(j) * this->Divisions[0] +
+          k * product;
+        for (vtkIdType n = this->Offsets[cno]; n < this->Offsets[cno+1]; n++)
+          {
+          vtkIdType ptId = this->PointIds[n];
+          this->GetPoint(ptId, pt);
+          if ( vtkMath::Distance2BetweenPoints(x, pt) <= R2 )
+            {
+            result->InsertNextId(ptId);
+            }
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Generate the faces between empty and non-empty buckets, and the outer
+// faces of the non-empty buckets on the boundary.
+void vtkStaticPointLocator::GenerateRepresentation(int vtkNotUsed(level),
+                                                   vtkPolyData *pd)
+{
+  if ( this->Offsets == NULL )
+    {
+    vtkErrorMacro(<<"Can't build representation...no data!");
+    return;
+    }
+
+  vtkPoints *pts = vtkPoints::New();
+  pts->Allocate(5000);
+  vtkCellArray *polys = vtkCellArray::New();
+  polys->Allocate(10000);
+
+  int ijk[3], d;
+  for (ijk[2]=0; ijk[2] < this->Divisions[2]; ijk[2]++)
+    {
+    for (ijk[1]=0; ijk[1] < this->Divisions[1]; ijk[1]++)
+      {
+      for (ijk[0]=0; ijk[0] < this->Divisions[0]; ijk[0]++)
+        {
+        vtkIdType idx = ijk[0] + static_cast<vtkIdType>(ijk[1]) *
+          this->Divisions[0] + static_cast<vtkIdType>(ijk[2]) *
+          this->Divisions[0] * this->Divisions[1];
+        int inside = (this->GetNumberOfPointsInBucket(idx) > 0);
+        for (d=0; d < 3; d++)
+          {
+          // Face towards the "negative" neighbor.
+          vtkIdType stride = (d == 0 ? 1 : d == 1 ? this->Divisions[0] :
+                              static_cast<vtkIdType>(this->Divisions[0]) *
+                              this->Divisions[1]);
+          int neighborInside = (ijk[d] > 0 &&
+                                this->GetNumberOfPointsInBucket(idx-stride) > 0);
+          if ( inside != neighborInside )
+            {
+            this->GenerateFace(d, ijk[0], ijk[1], ijk[2], pts, polys);
+            }
+          // Faces on the "positive" boundary.
+          if ( inside && ijk[d] + 1 >= this->Divisions[d] )
+            {
+            int next[3] = { ijk[0], ijk[1], ijk[2] };
+            next[d]++;
+            this->GenerateFace(d, next[0], next[1], next[2], pts, polys);
+            }
+          }
+        }
+      }
+    }
+
+  pd->SetPoints(pts);
+  pts->Delete();
+  pd->SetPolys(polys);
+  polys->Delete();
+  pd->Squeeze();
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticPointLocator::GenerateFace(int face, int i, int j, int k,
+                                         vtkPoints *pts, vtkCellArray *polys)
+{
+  // The two directions spanning the face.
+  int u = (face + 1) % 3;
+  int v = (face + 2) % 3;
+
+  vtkIdType ids[4];
+  double origin[3], x[3];
+  origin[0] = this->Bounds[0] + i * this->H[0];
+  origin[1] = this->Bounds[2] + j * this->H[1];
+  origin[2] = this->Bounds[4] + k * this->H[2];
+  ids[0] = pts->InsertNextPoint(origin);
+
+  x[0] = origin[0]; x[1] = origin[1]; x[2] = origin[2];
+  x[u] += this->H[u];
+  ids[1] = pts->InsertNextPoint(x);
+  x[v] += this->H[v];
+  ids[2] = pts->InsertNextPoint(x);
+  x[u] = origin[u];
+  ids[3] = pts->InsertNextPoint(x);
+
+  polys->InsertNextCell(4,ids);
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticPointLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number of Points Per Bucket: "
+     << this->NumberOfPointsPerBucket << "\n";
+  os << indent << "Divisions: (" << this->Divisions[0] << ", "
+     << this->Divisions[1] << ", " << this->Divisions[2] << ")\n";
+  os << indent << "Number of Buckets: " << this->NumberOfBuckets << "\n";
+}
@@ -0,0 +1,164 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStaticPointLocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkStaticPointLocator - quickly locate points of a dataset that does not change
+// .SECTION Description
+// vtkStaticPointLocator divides space into a regular grid of buckets like
+// vtkPointLocator, but is built once from all the points of its dataset
+// instead of point by point.  Every point is binned in parallel, the
+// (bucket, point id) pairs are sorted in parallel, and the point ids end
+// up in one contiguous array ordered by bucket with an offsets array
+// giving the start of every bucket.  There is no per-bucket allocation,
+// so building is much faster than for vtkPointLocator and queries touch
+// far less memory.
+//
+// Points cannot be inserted after the locator is built; use
+// vtkPointLocator or vtkMergePoints for incremental insertion.  The
+// queries are thread safe once BuildLocator() has been called.
+//
+// .SECTION See Also
+// vtkPointLocator vtkKdTreePointLocator vtkSMPTools
+
+#ifndef __vtkStaticPointLocator_h
+#define __vtkStaticPointLocator_h
+
+#include "vtkAbstractPointLocator.h"
+
+class vtkCellArray;
+class vtkIdList;
+class vtkPoints;
+class vtkStaticPointLocatorBuckets;
+
+class VTK_FILTERING_EXPORT vtkStaticPointLocator :
+  public vtkAbstractPointLocator
+{
+public:
+  // Description:
+  // Construct with automatic computation of divisions, averaging
+  // 5 points per bucket.
+  static vtkStaticPointLocator *New();
+  vtkTypeMacro(vtkStaticPointLocator,vtkAbstractPointLocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set the number of divisions in x-y-z directions.  Only used when
+  // Automatic is off.
+  vtkSetVector3Macro(Divisions,int);
+  vtkGetVectorMacro(Divisions,int,3);
+
+  // Description:
+  // Specify the average number of points in each bucket.
+  vtkSetClampMacro(NumberOfPointsPerBucket,int,1,VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfPointsPerBucket,int);
+
+  // Description:
+  // Given a position x, return the id of the point closest to it.
+  // Thread safe if BuildLocator() has been called first.
+  virtual vtkIdType FindClosestPoint(const double x[3]);
+
+  // Description:
+  // Given a position x and a radius r, return the id of the point closest
+  // to x within the radius, or -1.  dist2 returns the squared distance to
+  // the point.  Thread safe if BuildLocator() has been called first.
+  virtual vtkIdType FindClosestPointWithinRadius(
+    double radius, const double x[3], double& dist2);
+
+  // Description:
+  // Find the closest N points to a position, sorted from closest to
+  // farthest.  Thread safe if BuildLocator() has been called first.
+  virtual void FindClosestNPoints(int N, const double x[3], vtkIdList *result);
+
+  // Description:
+  // Find all points within a specified radius R of position x.  The result
+  // is ordered by bucket.  Thread safe if BuildLocator() has been called
+  // first.
+  virtual void FindPointsWithinRadius(double R, const double x[3],
+                                      vtkIdList *result);
+
+  // Description:
+  // Return the number of points in a bucket and a pointer to their ids.
+  // The bucket index is i + j*Divisions[0] + k*Divisions[0]*Divisions[1].
+  vtkIdType GetNumberOfPointsInBucket(vtkIdType bucket)
+    {
+    return (this->Offsets ?
+            this->Offsets[bucket+1] - this->Offsets[bucket] : 0);
+    }
+  const vtkIdType *GetBucketIds(vtkIdType bucket)
+    {
+    return (this->Offsets ? this->PointIds + this->Offsets[bucket] : 0);
+    }
+
+  // Description:
+  // See vtkLocator interface documentation.
+  // These methods are not thread safe.
+  void FreeSearchStructure();
+  void BuildLocator();
+  void GenerateRepresentation(int level, vtkPolyData *pd);
+
+  // Description:
+  // Return the total number of buckets of the built locator.
+  vtkGetMacro(NumberOfBuckets,vtkIdType);
+
+protected:
+  vtkStaticPointLocator();
+  ~vtkStaticPointLocator();
+
+  // Description:
+  // Compute the bucket that contains x, clamped to the grid.
+  void GetBucketIndices(const double x[3], int ijk[3]);
+
+  // Description:
+  // Collect the buckets whose indices differ from ijk by exactly level in
+  // at least one direction.
+  void GetShell(vtkStaticPointLocatorBuckets *buckets, const int ijk[3],
+                int level);
+
+  // Description:
+  // Squared distance from x to the part of space not covered by the
+  // buckets within level of ijk, VTK_DOUBLE_MAX if those buckets cover
+  // the whole grid.
+  double Distance2OutsideLevel(const double x[3], const int ijk[3],
+                               int level);
+
+  // Description:
+  // Squared distance from x to bucket ijk.
+  double Distance2ToBucket(const double x[3], int i, int j, int k);
+
+  // Description:
+  // Fetch the coordinates of a point, directly from the point array when
+  // possible.
+  void GetPoint(vtkIdType ptId, double x[3]);
+
+  void GenerateFace(int face, int i, int j, int k,
+                    vtkPoints *pts, vtkCellArray *polys);
+
+  int Divisions[3]; // Number of sub-divisions in x-y-z directions
+  int NumberOfPointsPerBucket; // Used to compute the divisions
+  double H[3]; // width of each bucket in x-y-z directions
+  vtkIdType NumberOfBuckets;
+
+  vtkIdType *Offsets; // NumberOfBuckets+1 offsets into PointIds
+  vtkIdType *PointIds; // point ids ordered by bucket
+
+  // Point coordinates used for the queries, when the dataset stores them
+  // as a float or double array.
+  float *FloatPoints;
+  double *DoublePoints;
+
+private:
+  vtkStaticPointLocator(const vtkStaticPointLocator&);  // Not implemented.
+  void operator=(const vtkStaticPointLocator&);  // Not implemented.
+};
+
+#endif
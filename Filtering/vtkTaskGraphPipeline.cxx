@@ -0,0 +1,503 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTaskGraphPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTaskGraphPipeline.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkAlgorithmOutput.h"
+#include "vtkConditionVariable.h"
+#include "vtkDataSet.h"
+#include "vtkExecutiveCollection.h"
+#include "vtkGenericCell.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkThreadPool.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/deque>
+#include <vtkstd/map>
+#include <vtkstd/set>
+#include <vtkstd/vector>
+
+vtkStandardNewMacro(vtkTaskGraphPipeline);
+
+//----------------------------------------------------------------------------
+// One REQUEST_DATA task: update the given output ports of an executive.
+class vtkTaskGraphPipelineNode
+{
+public:
+  vtkTaskGraphPipelineNode(vtkTaskGraphPipeline* executive)
+    : Executive(executive), NumberOfProducers(0), ThreadSafe(0), Failed(0)
+    {}
+
+  vtkTaskGraphPipeline* Executive;
+  vtkstd::vector<int> Ports;
+  // The pipeline information of the inputs read by the task.
+  vtkstd::vector<vtkInformation*> Inputs;
+  // The nodes that consume the outputs of this one.
+  vtkstd::vector<int> Consumers;
+  // The producers that have not finished yet.
+  int NumberOfProducers;
+  int ThreadSafe;
+  int Failed;
+};
+
+//----------------------------------------------------------------------------
+class vtkTaskGraphPipelineGraph
+{
+public:
+  vtkTaskGraphPipelineGraph()
+    : Serial(0), Running(0), RunningAlone(0), Result(1) {}
+
+  // Add a node updating the given port of the executive, and the nodes of
+  // the executives above it.  Returns -1 if the port is up to date.  Sets
+  // Serial if the graph cannot be used.
+  int AddExecutive(vtkExecutive* e, int port);
+
+  // Run all nodes using up to the given number of threads.
+  int Execute(int numberOfThreads);
+
+  // Run ready nodes until every node has run.
+  void Work();
+
+  // Make the first calls of the thread-safe methods of the inputs of a
+  // node.
+  void PrepareInputs(int node);
+
+  vtkstd::vector<vtkTaskGraphPipelineNode> Nodes;
+  vtkstd::map<vtkExecutive*, int> NodeIndex;
+  int Serial;
+
+  vtkSimpleMutexLock Lock;
+  vtkSimpleConditionVariable Condition;
+  vtkstd::deque<int> Ready;
+  int Running;
+  int RunningAlone;
+  int Result;
+
+  vtkSimpleMutexLock PrepareLock;
+  vtkstd::set<vtkInformation*> PreparedInputs;
+};
+
+//----------------------------------------------------------------------------
+int vtkTaskGraphPipelineGraph::AddExecutive(vtkExecutive* e, int port)
+{
+  vtkTaskGraphPipeline* executive = vtkTaskGraphPipeline::SafeDownCast(e);
+  if (!executive)
+    {
+    this->Serial = 1;
+    return -1;
+    }
+
+  vtkstd::map<vtkExecutive*, int>::iterator found = this->NodeIndex.find(e);
+  if (found != this->NodeIndex.end())
+    {
+    vtkstd::vector<int>& ports = this->Nodes[found->second].Ports;
+    if (vtkstd::find(ports.begin(), ports.end(), port) == ports.end())
+      {
+      ports.push_back(port);
+      }
+    return found->second;
+    }
+
+  if (!executive->NeedToExecuteData(port, executive->GetInputInformation(),
+                                    executive->GetOutputInformation()))
+    {
+    return -1;
+    }
+
+  // A task cannot iterate over blocks or time steps, since that sends
+  // requests to the shared inputs.
+  int compositePort;
+  if (!executive->CanUpdateInputsConcurrently() ||
+      executive->ShouldIterateOverInput(compositePort))
+    {
+    this->Serial = 1;
+    return -1;
+    }
+
+  int node = static_cast<int>(this->Nodes.size());
+  this->Nodes.push_back(vtkTaskGraphPipelineNode(executive));
+  this->Nodes[node].Ports.push_back(port);
+  this->Nodes[node].ThreadSafe = executive->GetAlgorithm()->GetInformation()->
+    Get(vtkCompositeDataPipeline::REQUEST_DATA_THREAD_SAFE());
+  this->NodeIndex[e] = node;
+  if (!executive->AddInputsToGraph(this, node))
+    {
+    this->Serial = 1;
+    return -1;
+    }
+  return node;
+}
+
+//----------------------------------------------------------------------------
+static void vtkTaskGraphPipelineWork(void* data, vtkIdType, int)
+{
+  static_cast<vtkTaskGraphPipelineGraph*>(data)->Work();
+}
+
+//----------------------------------------------------------------------------
+int vtkTaskGraphPipelineGraph::Execute(int numberOfThreads)
+{
+  int numberOfNodes = static_cast<int>(this->Nodes.size());
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    this->Nodes[i].Executive->InputsUpdatedByGraph = 1;
+    if (this->Nodes[i].NumberOfProducers == 0)
+      {
+      this->Ready.push_back(i);
+      }
+    }
+
+  // Every thread runs the same loop, which waits for ready nodes as long as
+  // some node is running.
+  int numberOfLoops =
+    (numberOfThreads < numberOfNodes ? numberOfThreads : numberOfNodes);
+  vtkThreadPool::GetInstance()->Execute(vtkTaskGraphPipelineWork, this,
+                                        numberOfLoops, numberOfLoops);
+
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    this->Nodes[i].Executive->InputsUpdatedByGraph = 0;
+    this->Nodes[i].Executive->LastNumberOfTasks = numberOfNodes;
+    }
+  return this->Result;
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskGraphPipelineGraph::PrepareInputs(int node)
+{
+  // The first calls build the cells, links and bounds of a data set, and
+  // may traverse cell arrays shared with other data sets, so they are made
+  // by one thread at a time.
+  vtkTaskGraphPipelineNode& n = this->Nodes[node];
+  this->PrepareLock.Lock();
+  for (size_t i = 0; i < n.Inputs.size(); ++i)
+    {
+    if (!this->PreparedInputs.insert(n.Inputs[i]).second)
+      {
+      continue;
+      }
+    vtkDataSet* data = vtkDataSet::SafeDownCast(
+      n.Inputs[i]->Get(vtkDataObject::DATA_OBJECT()));
+    if (data)
+      {
+      double bounds[6];
+      data->GetBounds(bounds);
+      if (data->GetNumberOfCells() > 0)
+        {
+        vtkGenericCell* cell = vtkGenericCell::New();
+        data->GetCell(0, cell);
+        data->GetCellType(0);
+        cell->Delete();
+        }
+      }
+    }
+  this->PrepareLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskGraphPipelineGraph::Work()
+{
+  this->Lock.Lock();
+  for (;;)
+    {
+    // Tasks that are not thread safe run alone, the others run together.
+    vtkstd::deque<int>::iterator next = this->Ready.begin();
+    while (next != this->Ready.end() &&
+           (this->RunningAlone ||
+            (!this->Nodes[*next].ThreadSafe && this->Running > 0)))
+      {
+      ++next;
+      }
+    if (next != this->Ready.end())
+      {
+      int i = *next;
+      vtkTaskGraphPipelineNode& node = this->Nodes[i];
+      this->Ready.erase(next);
+      ++this->Running;
+      this->RunningAlone = !node.ThreadSafe;
+      this->Lock.Unlock();
+
+      // Nodes above a failed node are not executed, as with the
+      // recursive order.
+      int result = !node.Failed;
+      if (result && node.ThreadSafe)
+        {
+        this->PrepareInputs(i);
+        }
+      for (size_t p = 0; result && p < node.Ports.size(); ++p)
+        {
+        result = node.Executive->UpdateData(node.Ports[p]);
+        }
+
+      this->Lock.Lock();
+      --this->Running;
+      this->RunningAlone = 0;
+      if (!result)
+        {
+        this->Result = 0;
+        }
+      for (size_t c = 0; c < node.Consumers.size(); ++c)
+        {
+        vtkTaskGraphPipelineNode& consumer = this->Nodes[node.Consumers[c]];
+        consumer.Failed = consumer.Failed || !result;
+        if (--consumer.NumberOfProducers == 0)
+          {
+          this->Ready.push_back(node.Consumers[c]);
+          }
+        }
+      this->Condition.Broadcast();
+      }
+    else if (this->Running == 0)
+      {
+      // Nothing can start and nothing is running, so every node has run.
+      break;
+      }
+    else
+      {
+      this->Condition.Wait(this->Lock);
+      }
+    }
+  this->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+static int vtkTaskGraphPipelineNumberOfThreads(vtkTaskGraphPipeline* exec)
+{
+  int numberOfThreads = exec->GetNumberOfThreads();
+  return (numberOfThreads > 0 ? numberOfThreads :
+          vtkSMPTools::GetNumberOfThreads());
+}
+
+//----------------------------------------------------------------------------
+vtkTaskGraphPipeline::vtkTaskGraphPipeline()
+{
+  this->NumberOfThreads = 0;
+  this->LastNumberOfTasks = 0;
+  this->InputsUpdatedByGraph = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkTaskGraphPipeline::~vtkTaskGraphPipeline()
+{
+}
+
+//----------------------------------------------------------------------------
+int vtkTaskGraphPipeline::ProcessRequest(vtkInformation* request,
+                                         vtkInformationVector** inInfoVec,
+                                         vtkInformationVector* outInfoVec)
+{
+  if(this->Algorithm && request->Has(REQUEST_DATA()) &&
+     !this->InputsUpdatedByGraph)
+    {
+    int outputPort = -1;
+    if(request->Has(FROM_OUTPUT_PORT()))
+      {
+      outputPort = request->Get(FROM_OUTPUT_PORT());
+      }
+
+    // Update the inputs with a graph, then execute as usual.
+    this->LastNumberOfTasks = 0;
+    int numberOfThreads = vtkTaskGraphPipelineNumberOfThreads(this);
+    if(numberOfThreads > 1 &&
+       this->NeedToExecuteData(outputPort, inInfoVec, outInfoVec) &&
+       this->CanUpdateInputsConcurrently())
+      {
+      vtkTaskGraphPipelineGraph graph;
+      if(this->AddInputsToGraph(&graph, -1) && graph.Nodes.size() > 1)
+        {
+        int result = graph.Execute(numberOfThreads);
+        this->LastNumberOfTasks = static_cast<int>(graph.Nodes.size());
+        if(result)
+          {
+          this->InputsUpdatedByGraph = 1;
+          result = this->Superclass::ProcessRequest(request, inInfoVec,
+                                                    outInfoVec);
+          this->InputsUpdatedByGraph = 0;
+          }
+        return result;
+        }
+      }
+    }
+
+  return this->Superclass::ProcessRequest(request, inInfoVec, outInfoVec);
+}
+
+//----------------------------------------------------------------------------
+int vtkTaskGraphPipeline::ForwardUpstream(vtkInformation* request)
+{
+  if(this->InputsUpdatedByGraph && request->Has(REQUEST_DATA()))
+    {
+    return (this->Algorithm->ModifyRequest(request, BeforeForward) &&
+            this->Algorithm->ModifyRequest(request, AfterForward));
+    }
+  return this->Superclass::ForwardUpstream(request);
+}
+
+//----------------------------------------------------------------------------
+int vtkTaskGraphPipeline::AddInputsToGraph(vtkTaskGraphPipelineGraph* graph,
+                                           int node)
+{
+  for(int i=0; i < this->GetNumberOfInputPorts(); ++i)
+    {
+    int nic = this->Algorithm->GetNumberOfInputConnections(i);
+    for(int j=0; j < nic; ++j)
+      {
+      vtkExecutive* e = this->GetInputExecutive(i, j);
+      if(!e)
+        {
+        continue;
+        }
+      int port = this->Algorithm->GetInputConnection(i, j)->GetIndex();
+      int producer = graph->AddExecutive(e, port);
+      if(graph->Serial)
+        {
+        return 0;
+        }
+      if(node >= 0)
+        {
+        graph->Nodes[node].Inputs.push_back(
+          this->GetInputInformation()[i]->GetInformationObject(j));
+        }
+      // The node of this executive, if any, waits for the producer.
+      if(producer >= 0 && node >= 0)
+        {
+        vtkstd::vector<int>& consumers = graph->Nodes[producer].Consumers;
+        if(vtkstd::find(consumers.begin(), consumers.end(), node) ==
+           consumers.end())
+          {
+          consumers.push_back(node);
+          ++graph->Nodes[node].NumberOfProducers;
+          }
+        }
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkTaskGraphPipeline::CanUpdateInputsConcurrently()
+{
+  // Released inputs would be released by whichever consumer finishes
+  // first.
+  if(this->SharedInputInformation ||
+     vtkDataObject::GetGlobalReleaseDataFlag())
+    {
+    return 0;
+    }
+
+  // Time requests are set on the inputs while forwarding REQUEST_DATA.
+  for(int i=0; i < this->GetNumberOfOutputPorts(); ++i)
+    {
+    vtkInformation* outInfo = this->GetOutputInformation(i);
+    if(outInfo && outInfo->Has(REQUIRES_TIME_DOWNSTREAM()))
+      {
+      return 0;
+      }
+    }
+  for(int i=0; i < this->GetNumberOfInputPorts(); ++i)
+    {
+    vtkInformation* ipi = this->Algorithm->GetInputPortInformation(i);
+    const char* rdt = ipi->Get(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE());
+    if(rdt && !strcmp("vtkTemporalDataSet", rdt))
+      {
+      return 0;
+      }
+    vtkInformationVector* inVector = this->GetInputInformation()[i];
+    for(int j=0; j < inVector->GetNumberOfInformationObjects(); ++j)
+      {
+      if(inVector->GetInformationObject(j)->Get(RELEASE_DATA()))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkTaskGraphPipeline::UpdateAll(vtkExecutiveCollection* executives)
+{
+  int result = 1;
+  int numberOfThreads = 0;
+  vtkTaskGraphPipelineGraph graph;
+  vtkstd::vector<vtkTaskGraphPipeline*> sinks;
+  vtkstd::vector<int> ports;
+  vtkstd::vector<vtkExecutive*> others;
+
+  // Bring the information and update extents of every sink up to date
+  // first, then gather the data requests in a single graph.
+  vtkExecutive* e;
+  executives->InitTraversal();
+  while((e = executives->GetNextItem()) != 0)
+    {
+    vtkTaskGraphPipeline* exec = vtkTaskGraphPipeline::SafeDownCast(e);
+    if(!exec)
+      {
+      others.push_back(e);
+      continue;
+      }
+    int port = (exec->Algorithm->GetNumberOfOutputPorts() ? 0 : -1);
+    if(!exec->UpdateInformation() || !exec->PropagateUpdateExtent(port))
+      {
+      result = 0;
+      continue;
+      }
+    int threads = vtkTaskGraphPipelineNumberOfThreads(exec);
+    numberOfThreads = (threads > numberOfThreads ? threads : numberOfThreads);
+    sinks.push_back(exec);
+    ports.push_back(port);
+    }
+
+  size_t i;
+  for(i=0; i < sinks.size() && !graph.Serial; ++i)
+    {
+    if(!sinks[i]->LastPropogateUpdateExtentShortCircuited)
+      {
+      graph.AddExecutive(sinks[i], ports[i]);
+      }
+    }
+
+  if(numberOfThreads > 1 && !graph.Serial && !graph.Nodes.empty())
+    {
+    result = graph.Execute(numberOfThreads) && result;
+    }
+  for(i=0; i < sinks.size(); ++i)
+    {
+    // Sinks outside of the graph, and streaming sinks asking to execute
+    // again, are updated as usual.
+    if(numberOfThreads <= 1 || graph.Serial || graph.Nodes.empty() ||
+       sinks[i]->ContinueExecuting)
+      {
+      result = sinks[i]->Update(ports[i]) && result;
+      }
+    }
+  for(i=0; i < others.size(); ++i)
+    {
+    result = others[i]->Update() && result;
+    }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskGraphPipeline::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "LastNumberOfTasks: " << this->LastNumberOfTasks << "\n";
+}
@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTaskGraphPipeline.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkTaskGraphPipeline - Executive running independent branches concurrently
+// .SECTION Description
+// vtkTaskGraphPipeline is a vtkCompositeDataPipeline whose REQUEST_DATA
+// pass does not recurse upstream one input after the other.  When data is
+// requested from it, the executive walks the part of the pipeline above it
+// that needs to execute, once, and builds a graph with one task per
+// executive and one dependency per connection.  The tasks are then run on
+// the process-wide vtkThreadPool: a task starts as soon as all of its
+// producers have finished, so the branches of a pipeline that fans out
+// (one reader feeding a contour, a slice and a glyph filter, say) can
+// execute at the same time.  The executive itself executes last, on the
+// calling thread.  UpdateAll() updates several sinks with a single graph.
+//
+// Most algorithms cannot execute while other algorithms read the same
+// data: data sets build their cells and bounds on first use, share arrays
+// with the data sets they were copied from, and accessors such as
+// vtkDataArray::GetTuple(i) return a buffer owned by the array.  A task
+// therefore runs alone unless its algorithm sets
+// vtkCompositeDataPipeline::REQUEST_DATA_THREAD_SAFE() in its information.
+// Tasks that set it run together, and the executive makes the first calls
+// of the thread-safe methods of vtkDataSet on their inputs before they
+// start.
+//
+// The REQUEST_DATA_OBJECT, REQUEST_INFORMATION and REQUEST_UPDATE_EXTENT
+// passes are unchanged.  Every executive of the graph must be a
+// vtkTaskGraphPipeline, and algorithms must not share state with the
+// algorithms of other branches.  Observers of the algorithms may be called
+// from worker threads.
+//
+// The executive falls back to the recursive order of its superclass when
+// the pipeline above it contains another executive type, releases data
+// (see vtkDemandDrivenPipeline::SetReleaseDataFlag), shares input
+// information, iterates over composite or temporal inputs, or when a
+// single thread is available.
+//
+// This executive replaces vtkThreadedStreamingPipeline and
+// vtkExecutionScheduler for running pipelines on several threads.
+// .SECTION See Also
+// vtkThreadPool vtkSMPTools vtkCompositeDataPipeline
+
+#ifndef __vtkTaskGraphPipeline_h
+#define __vtkTaskGraphPipeline_h
+
+#include "vtkCompositeDataPipeline.h"
+
+class vtkExecutiveCollection;
+//BTX
+class vtkTaskGraphPipelineGraph;
+//ETX
+
+class VTK_FILTERING_EXPORT vtkTaskGraphPipeline : public vtkCompositeDataPipeline
+{
+public:
+  static vtkTaskGraphPipeline* New();
+  vtkTypeMacro(vtkTaskGraphPipeline,vtkCompositeDataPipeline);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Generalized interface for asking the executive to fulfill update
+  // requests.
+  virtual int ProcessRequest(vtkInformation* request,
+                             vtkInformationVector** inInfoVec,
+                             vtkInformationVector* outInfoVec);
+
+  // Description:
+  // Update the first output port of every executive of the collection, or
+  // the executive itself if it has no output port.  The pipelines above
+  // all of them are executed as one graph, so that sinks sharing a
+  // source execute concurrently.  Executives that are not
+  // vtkTaskGraphPipeline are updated one after the other.  The update
+  // extents of all sinks are propagated before any algorithm executes, so
+  // sinks sharing a producer must request the same extent from it.
+  // Returns 1 if every update succeeded.
+  static int UpdateAll(vtkExecutiveCollection* executives);
+
+  // Description:
+  // Set/Get the maximum number of threads running tasks of the graphs
+  // started by this executive.  The default, 0, uses
+  // vtkSMPTools::GetNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Number of tasks of the last graph that updated this executive, 0 if
+  // the last REQUEST_DATA used the recursive order.
+  vtkGetMacro(LastNumberOfTasks, int);
+
+protected:
+  vtkTaskGraphPipeline();
+  ~vtkTaskGraphPipeline();
+
+  // Does not forward REQUEST_DATA while the graph updates the inputs.
+  virtual int ForwardUpstream(vtkInformation* request);
+
+  // Add the executives above this one that need to execute to the graph.
+  // Returns 0 if the graph cannot be used.
+  int AddInputsToGraph(vtkTaskGraphPipelineGraph* graph, int node);
+
+  // Whether the inputs of this executive may be updated by a graph.
+  int CanUpdateInputsConcurrently();
+
+  int NumberOfThreads;
+  int LastNumberOfTasks;
+
+  // Set while a graph updates the inputs of this executive.
+  int InputsUpdatedByGraph;
+
+  //BTX
+  friend class vtkTaskGraphPipelineGraph;
+  //ETX
+
+private:
+  vtkTaskGraphPipeline(const vtkTaskGraphPipeline&);  // Not implemented.
+  void operator=(const vtkTaskGraphPipeline&);  // Not implemented.
+};
+
+#endif
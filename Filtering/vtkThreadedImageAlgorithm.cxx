@@ -32,6 +32,8 @@ vtkThreadedImageAlgorithm::vtkThreadedImageAlgorithm()
 {
   this->Threader = vtkMultiThreader::New();
   this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+  this->UseThreadPool = 0;
+  this->PiecesPerThread = 1;
 }
 
 //----------------------------------------------------------------------------
@@ -46,6 +48,8 @@ void vtkThreadedImageAlgorithm::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
   
   os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "UseThreadPool: " << this->UseThreadPool << "\n";
+  os << indent << "PiecesPerThread: " << this->PiecesPerThread << "\n";
 }
 
 struct vtkImageThreadStruct
@@ -56,6 +60,7 @@ struct vtkImageThreadStruct
   vtkInformationVector *OutputsInfo;
   vtkImageData   ***Inputs;
   vtkImageData   **Outputs;
+  int            NumberOfPieces;
 };
 
 //----------------------------------------------------------------------------
@@ -122,22 +127,12 @@ int vtkThreadedImageAlgorithm::SplitExtent(int splitExt[6],
 }
 
 
-// this mess is really a simple function. All it does is call
-// the ThreadedExecute method after setting the correct
-// extent for this thread. Its just a pain to calculate
-// the correct extent.
-VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
+// Find the extent that has to be split between the threads: the update
+// extent of the requesting output port, or of the first connected input
+// when there is no output.  Returns 0 if there is nothing to execute.
+static int vtkThreadedImageAlgorithmGetExtent(vtkImageThreadStruct *str,
+                                              int ext[6])
 {
-  vtkImageThreadStruct *str;
-  int ext[6], splitExt[6], total;
-  int threadId, threadCount;
-  
-  threadId = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->ThreadID;
-  threadCount = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->NumberOfThreads;
-  
-  str = static_cast<vtkImageThreadStruct *>
-    (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
-
   // if we have an output
   if (str->Filter->GetNumberOfOutputPorts())
     {
@@ -149,7 +144,7 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
     // update directly, for now an error
     if (outputPort == -1)
       {
-      return VTK_THREAD_RETURN_VALUE;
+      return 0;
       }
   
     // get the update extent from the output port
@@ -159,42 +154,51 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
     outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), 
                  updateExtent);
     memcpy(ext,updateExtent, sizeof(int)*6);
+    return 1;
     }
-  else
+
+  // if there is no output, then use UE from input, use the first input
+  int inPort;
+  for (inPort = 0; inPort < str->Filter->GetNumberOfInputPorts(); ++inPort)
     {
-    // if there is no output, then use UE from input, use the first input
-    int inPort;
-    for (inPort = 0; inPort < str->Filter->GetNumberOfInputPorts(); ++inPort)
-      {
-      if (str->Filter->GetNumberOfInputConnections(inPort))
-        {
-        int updateExtent[6];
-        str->InputsInfo[inPort]
-          ->GetInformationObject(0)
-          ->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), 
-                updateExtent);
-        memcpy(ext,updateExtent, sizeof(int)*6);
-        break;
-        }
-      }
-    if (inPort >= str->Filter->GetNumberOfInputPorts())
+    if (str->Filter->GetNumberOfInputConnections(inPort))
       {
-      return VTK_THREAD_RETURN_VALUE;
+      int updateExtent[6];
+      str->InputsInfo[inPort]
+        ->GetInformationObject(0)
+        ->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), 
+              updateExtent);
+      memcpy(ext,updateExtent, sizeof(int)*6);
+      return 1;
       }
     }
+  return 0;
+}
+
+// Split the extent into the requested piece and execute it on threadId.
+static void vtkThreadedImageAlgorithmExecutePiece(vtkImageThreadStruct *str,
+                                                  int piece, int numPieces,
+                                                  int threadId)
+{
+  int ext[6], splitExt[6], total;
+
+  if (!vtkThreadedImageAlgorithmGetExtent(str, ext))
+    {
+    return;
+    }
   
   // execute the actual method with appropriate extent
   // first find out how many pieces extent can be split into.
-  total = str->Filter->SplitExtent(splitExt, ext, threadId, threadCount);
+  total = str->Filter->SplitExtent(splitExt, ext, piece, numPieces);
     
-  if (threadId < total)
+  if (piece < total)
     {
     // return if nothing to do
     if (splitExt[1] < splitExt[0] ||
         splitExt[3] < splitExt[2] ||
         splitExt[5] < splitExt[4])
       {
-      return VTK_THREAD_RETURN_VALUE;
+      return;
       }
     str->Filter->ThreadedRequestData(str->Request,
                                      str->InputsInfo, str->OutputsInfo,
@@ -207,10 +211,39 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
   //   break up very well and it is just as efficient to leave a 
   //   few threads idle.
   //   }
+}
+
+// this mess is really a simple function. All it does is call
+// the ThreadedExecute method after setting the correct
+// extent for this thread. Its just a pain to calculate
+// the correct extent.
+VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
+{
+  vtkImageThreadStruct *str;
+  int threadId, threadCount;
+  
+  threadId = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->ThreadID;
+  threadCount = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->NumberOfThreads;
+  
+  str = static_cast<vtkImageThreadStruct *>
+    (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+
+  vtkThreadedImageAlgorithmExecutePiece(str, threadId, threadCount, threadId);
 
   return VTK_THREAD_RETURN_VALUE;
 }
 
+// Piece method for vtkMultiThreader::PieceMethodExecute, used when the
+// extent is split into more pieces than there are threads.
+static void vtkThreadedImageAlgorithmPieceExecute(void *arg, vtkIdType piece,
+                                                  int threadId)
+{
+  vtkImageThreadStruct *str = static_cast<vtkImageThreadStruct *>(arg);
+
+  vtkThreadedImageAlgorithmExecutePiece(str, static_cast<int>(piece),
+                                        str->NumberOfPieces, threadId);
+}
+
 
 //----------------------------------------------------------------------------
 // This is the superclasses style of Execute method.  Convert it into
@@ -285,12 +318,23 @@ int vtkThreadedImageAlgorithm::RequestData(
     }
     
   this->Threader->SetNumberOfThreads(this->NumberOfThreads);
-  this->Threader->SetSingleMethod(vtkThreadedImageAlgorithmThreadedExecute, &str);  
+  this->Threader->SetUseThreadPool(this->UseThreadPool);
+  str.NumberOfPieces = this->NumberOfThreads * this->PiecesPerThread;
 
   // always shut off debugging to avoid threading problems with GetMacros
   int debug = this->Debug;
   this->Debug = 0;
-  this->Threader->SingleMethodExecute();
+  if (this->UseThreadPool && str.NumberOfPieces > this->NumberOfThreads)
+    {
+    this->Threader->PieceMethodExecute(vtkThreadedImageAlgorithmPieceExecute,
+                                       &str, str.NumberOfPieces);
+    }
+  else
+    {
+    this->Threader->SetSingleMethod(vtkThreadedImageAlgorithmThreadedExecute,
+                                    &str);
+    this->Threader->SingleMethodExecute();
+    }
   this->Debug = debug;
 
   // free up the arrays
@@ -19,6 +19,10 @@
 // into smaller extents so that the vtkImageData limits are observed. It 
 // also provides support for multithreading. If you don't need any of this
 // functionality, consider using vtkSimpleImageToImageAlgorithm instead.
+//
+// With UseThreadPool on, the threads come from the persistent
+// vtkThreadPool, and PiecesPerThread lets idle threads steal pieces of
+// the update extent from busy ones.
 // .SECTION See also
 // vtkSimpleImageToImageAlgorithm
 
@@ -58,6 +62,18 @@ public:
   vtkSetClampMacro( NumberOfThreads, int, 1, VTK_MAX_THREADS );
   vtkGetMacro( NumberOfThreads, int );
 
+  // Description:
+  // Run the threads on the persistent vtkThreadPool.  Off by default.
+  vtkSetMacro( UseThreadPool, int );
+  vtkGetMacro( UseThreadPool, int );
+  vtkBooleanMacro( UseThreadPool, int );
+
+  // Description:
+  // Get/Set the number of pieces per thread when using the thread pool.
+  // Above 1, ThreadedRequestData is called once per piece.  Default is 1.
+  vtkSetClampMacro( PiecesPerThread, int, 1, 1024 );
+  vtkGetMacro( PiecesPerThread, int );
+
   // Description:
   // Putting this here until I merge graphics and imaging streaming.
   virtual int SplitExtent(int splitExt[6], int startExt[6], 
@@ -69,6 +85,8 @@ protected:
 
   vtkMultiThreader *Threader;
   int NumberOfThreads;
+  int UseThreadPool;
+  int PiecesPerThread;
   
   // Description:
   // This is called by the superclass.
@@ -31,9 +31,11 @@
 // .SECTION Description
 // vtkThreadeStreamingDemandDrivenPipeline is an executive that supports
 // updating input ports based on the number of threads available.
+// vtkTaskGraphPipeline runs the branches of a pipeline concurrently on the
+// shared thread pool and should be used instead in new code.
 
 // .SECTION See Also
-// vtkExecutionScheduler
+// vtkExecutionScheduler vtkTaskGraphPipeline
 
 
 #ifndef __vtkThreadedStreamingPipeline_h
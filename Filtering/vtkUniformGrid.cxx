@@ -485,6 +485,23 @@ vtkIdType vtkUniformGrid::FindCell(double x[3], vtkCell *vtkNotUsed(cell),
 
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkUniformGrid::FindCell(double x[3], double tol2,
+                                   vtkGenericCell *cell, double pcoords[3],
+                                   double *weights)
+{
+  vtkIdType cellId =
+    this->Superclass::FindCell(x, tol2, cell, pcoords, weights);
+  if ( cellId >= 0 &&
+       (this->PointVisibility->IsConstrained() ||
+        this->CellVisibility->IsConstrained())
+       && !this->IsCellVisible(cellId) )
+    {
+    return -1;
+    }
+  return cellId;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkUniformGrid::FindAndGetCell(double x[3],
                                       vtkCell *vtkNotUsed(cell),
@@ -56,6 +56,9 @@ public:
     double x[3], vtkCell *cell, vtkGenericCell *gencell,
     vtkIdType cellId, double tol2, int& subId,
     double pcoords[3], double *weights);
+  virtual vtkIdType FindCell(
+    double x[3], double tol2, vtkGenericCell *cell, double pcoords[3],
+    double *weights);
   virtual vtkCell *FindAndGetCell(
     double x[3], vtkCell *cell, vtkIdType cellId,
     double tol2, int& subId, double pcoords[3],
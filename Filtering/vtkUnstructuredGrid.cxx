@@ -63,6 +63,26 @@
 
 vtkStandardNewMacro(vtkUnstructuredGrid);
 
+//----------------------------------------------------------------------------
+// Look up the cell at location loc.  With offsets storage the cell is
+// normally the cellId'th one of the cell array, which is found in constant
+// time instead of searching for the location.
+static inline void vtkUnstructuredGridGetCell(vtkCellArray *cells,
+                                              vtkIdType cellId,
+                                              vtkIdType loc, vtkIdType &npts,
+                                              vtkIdType* &pts)
+{
+  if (cells->IsStorageOffsets() && cellId < cells->GetNumberOfCells() &&
+      cells->GetCellLocation(cellId) == loc)
+    {
+    cells->GetCellAtId(cellId, npts, pts);
+    }
+  else
+    {
+    cells->GetCell(loc, npts, pts);
+    }
+}
+
 vtkUnstructuredGrid::vtkUnstructuredGrid ()
 {
   this->Vertex = NULL;
@@ -480,7 +500,7 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
 
   loc = this->Locations->GetValue(cellId);
   vtkDebugMacro(<< "location = " <<  loc);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  vtkUnstructuredGridGetCell(this->Connectivity, cellId, loc, numPts, pts);
 
   int cellType = static_cast<int>(this->Types->GetValue(cellId));
   switch (cellType)
@@ -793,7 +813,7 @@ void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
   cell->SetCellType(cellType);
 
   loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  vtkUnstructuredGridGetCell(this->Connectivity, cellId, loc, numPts, pts);
 
   cell->PointIds->SetNumberOfIds(numPts);
   cell->Points->SetNumberOfPoints(numPts);
@@ -830,7 +850,7 @@ void vtkUnstructuredGrid::GetCellBounds(vtkIdType cellId, double bounds[6])
   vtkIdType *pts, numPts;
 
   loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  vtkUnstructuredGridGetCell(this->Connectivity, cellId, loc, numPts, pts);
 
   // carefully compute the bounds
   if (numPts)
@@ -960,7 +980,8 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdType npts,
       }
     
     // insert cell location
-    this->Locations->InsertNextValue(this->Connectivity->GetData()->GetMaxId()+1);
+    this->Locations->InsertNextValue(
+      this->Connectivity->GetNumberOfConnectivityEntries());
     // insert face location
     this->FaceLocations->InsertNextValue(this->Faces->GetMaxId()+1);
     // insert cell connectivity and faces stream
@@ -1101,10 +1122,25 @@ void vtkUnstructuredGrid::SetCells(int *types, vtkCellArray *cells)
   if (!containPolyhedron)
     {
     // only need to build types and locations
-    for (i=0, cells->InitTraversal(); cells->GetNextCell(npts,pts); i++)
+    if (cells->IsStorageOffsets())
+      {
+      // Read offsets storage by index rather than converting it.
+      vtkIdType loc = 0;
+      for (i=0; i < ncells; i++)
+        {
+        cells->GetCellAtId(i, npts, pts);
+        cellTypes->InsertNextValue(static_cast<unsigned char>(types[i]));
+        cellLocations->InsertNextValue(loc);
+        loc += npts + 1;
+        }
+      }
+    else
       {
-      cellTypes->InsertNextValue(static_cast<unsigned char>(types[i]));
-      cellLocations->InsertNextValue(cells->GetTraversalLocation(npts));
+      for (i=0, cells->InitTraversal(); cells->GetNextCell(npts,pts); i++)
+        {
+        cellTypes->InsertNextValue(static_cast<unsigned char>(types[i]));
+        cellLocations->InsertNextValue(cells->GetTraversalLocation(npts));
+        }
       }
     
     this->SetCells(cellTypes, cellLocations, cells, NULL, NULL);
@@ -1295,7 +1331,7 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
   vtkIdType *pts, numPts;
 
   loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  vtkUnstructuredGridGetCell(this->Connectivity, cellId, loc, numPts, pts);
   ptIds->SetNumberOfIds(numPts);
   for (i=0; i<numPts; i++)
     {
@@ -1314,7 +1350,7 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
 
   loc = this->Locations->GetValue(cellId);
 
-  this->Connectivity->GetCell(loc,npts,pts);
+  vtkUnstructuredGridGetCell(this->Connectivity, cellId, loc, npts, pts);
 }
 
 //----------------------------------------------------------------------------
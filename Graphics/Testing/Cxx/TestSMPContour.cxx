@@ -0,0 +1,252 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPContour.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Contour unstructured and structured grids serially and in parallel and
+// check that both give exactly the same points, cells and attributes.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkContourGrid.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkGridSynchronizedTemplates3D.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnstructuredGrid.h"
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static int CompareFieldData(vtkFieldData *a, vtkFieldData *b,
+                            const char *name)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    cerr << name << ": different number of arrays" << endl;
+    return 1;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+    {
+    vtkDataArray *aa = a->GetArray(i);
+    vtkDataArray *ba = b->GetArray(i);
+    if (!aa || !ba || aa->GetNumberOfTuples() != ba->GetNumberOfTuples() ||
+        aa->GetNumberOfComponents() != ba->GetNumberOfComponents())
+      {
+      cerr << name << ": array " << i << " does not match in size" << endl;
+      return 1;
+      }
+    for (vtkIdType t = 0; t < aa->GetNumberOfTuples(); ++t)
+      {
+      for (int c = 0; c < aa->GetNumberOfComponents(); ++c)
+        {
+        if (aa->GetComponent(t, c) != ba->GetComponent(t, c))
+          {
+          cerr << name << ": array " << aa->GetName() << " tuple " << t
+               << " differs" << endl;
+          return 1;
+          }
+        }
+      }
+    }
+  return 0;
+}
+
+static int CompareCells(vtkCellArray *a, vtkCellArray *b, const char *name)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      a->GetNumberOfConnectivityEntries() !=
+      b->GetNumberOfConnectivityEntries())
+    {
+    cerr << name << ": different number of cells" << endl;
+    return 1;
+    }
+  vtkIdType *pa = a->GetPointer();
+  vtkIdType *pb = b->GetPointer();
+  for (vtkIdType i = 0; i < a->GetNumberOfConnectivityEntries(); ++i)
+    {
+    if (pa[i] != pb[i])
+      {
+      cerr << name << ": connectivity differs at " << i << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+static int ComparePolyData(vtkPolyData *a, vtkPolyData *b, const char *name)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints())
+    {
+    cerr << name << ": " << a->GetNumberOfPoints() << " points instead of "
+         << b->GetNumberOfPoints() << endl;
+    return 1;
+    }
+  if (a->GetNumberOfPoints() == 0 || a->GetNumberOfCells() == 0)
+    {
+    cerr << name << ": empty output" << endl;
+    return 1;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+    double xa[3], xb[3];
+    a->GetPoint(i, xa);
+    b->GetPoint(i, xb);
+    if (xa[0] != xb[0] || xa[1] != xb[1] || xa[2] != xb[2])
+      {
+      cerr << name << ": point " << i << " differs" << endl;
+      return 1;
+      }
+    }
+  return CompareCells(a->GetVerts(), b->GetVerts(), name) +
+    CompareCells(a->GetLines(), b->GetLines(), name) +
+    CompareCells(a->GetPolys(), b->GetPolys(), name) +
+    CompareFieldData(a->GetPointData(), b->GetPointData(), name) +
+    CompareFieldData(a->GetCellData(), b->GetCellData(), name);
+}
+
+// Run the filter serially and in parallel and compare the outputs.
+template <class Filter>
+static int CompareParallel(Filter *filter, const char *name)
+{
+  filter->ParallelExecutionOff();
+  filter->Update();
+  VTK_CREATE(vtkPolyData, reference);
+  reference->DeepCopy(filter->GetOutput());
+
+  filter->ParallelExecutionOn();
+  filter->Update();
+  int errors = ComparePolyData(filter->GetOutput(), reference, name);
+  cout << name << ": " << reference->GetNumberOfPoints() << " points, "
+       << reference->GetNumberOfCells() << " cells" << endl;
+  return errors;
+}
+
+// Sample a smooth function and an integer function, the latter hits the
+// contour values exactly at many grid points.
+static void AddScalars(vtkDataSet *data)
+{
+  VTK_CREATE(vtkFloatArray, smooth);
+  smooth->SetName("Smooth");
+  smooth->SetNumberOfTuples(data->GetNumberOfPoints());
+  VTK_CREATE(vtkShortArray, steps);
+  steps->SetName("Steps");
+  steps->SetNumberOfTuples(data->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < data->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    data->GetPoint(i, x);
+    smooth->SetValue(i, static_cast<float>(
+                       x[0]*x[0] + x[1]*x[1] + x[2]*x[2] + x[0]*x[1]));
+    steps->SetValue(i, static_cast<short>(
+                      static_cast<int>(x[0] + 2*x[1] + 3*x[2]) % 7));
+    }
+  data->GetPointData()->SetScalars(smooth);
+  data->GetPointData()->AddArray(steps);
+}
+
+int TestSMPContour(int, char *[])
+{
+  int errors = 0;
+  vtkSMPTools::Initialize(4);
+
+  // Unstructured grid with tetrahedra, voxels and quads.
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(30, 25, 20);
+  image->SetOrigin(-14.5, -12.0, -9.5);
+  AddScalars(image);
+  VTK_CREATE(vtkIntArray, cellIds);
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+    {
+    cellIds->SetValue(i, static_cast<int>(i));
+    }
+  image->GetCellData()->AddArray(cellIds);
+
+  VTK_CREATE(vtkDataSetTriangleFilter, tetra);
+  tetra->SetInput(image);
+  VTK_CREATE(vtkDataSetSurfaceFilter, surface);
+  surface->SetInput(image);
+  VTK_CREATE(vtkAppendFilter, append);
+  append->AddInputConnection(surface->GetOutputPort());
+  append->AddInputConnection(tetra->GetOutputPort());
+  append->AddInput(image);
+
+  VTK_CREATE(vtkContourGrid, contourGrid);
+  contourGrid->SetInputConnection(append->GetOutputPort());
+  contourGrid->GenerateValues(4, 20.0, 150.0);
+  errors += CompareParallel(contourGrid.GetPointer(), "vtkContourGrid");
+
+  contourGrid->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "Steps");
+  contourGrid->SetNumberOfContours(2);
+  contourGrid->SetValue(0, 2.0);
+  contourGrid->SetValue(1, 5.0);
+  contourGrid->ComputeScalarsOff();
+  errors += CompareParallel(contourGrid.GetPointer(),
+                            "vtkContourGrid degenerate");
+
+  // Curvilinear structured grid.
+  int dims[3] = { 40, 35, 50 };
+  VTK_CREATE(vtkStructuredGrid, grid);
+  grid->SetDimensions(dims);
+  VTK_CREATE(vtkPoints, points);
+  for (int k = 0; k < dims[2]; ++k)
+    {
+    for (int j = 0; j < dims[1]; ++j)
+      {
+      for (int i = 0; i < dims[0]; ++i)
+        {
+        points->InsertNextPoint(i - 19.5 + 0.1*j, j - 17.0, k - 24.5 + 0.05*i);
+        }
+      }
+    }
+  grid->SetPoints(points);
+  AddScalars(grid);
+  cellIds->SetNumberOfTuples(grid->GetNumberOfCells());
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+    {
+    cellIds->SetValue(i, static_cast<int>(i));
+    }
+  grid->GetCellData()->AddArray(cellIds);
+
+  VTK_CREATE(vtkGridSynchronizedTemplates3D, templates);
+  templates->SetInput(grid);
+  templates->GenerateValues(3, 50.0, 400.0);
+  templates->ComputeGradientsOn();
+  errors += CompareParallel(templates.GetPointer(),
+                            "vtkGridSynchronizedTemplates3D");
+
+  templates->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "Steps");
+  templates->SetNumberOfContours(2);
+  templates->SetValue(0, 3.0);
+  templates->SetValue(1, 4.0);
+  templates->ComputeNormalsOff();
+  templates->ComputeGradientsOff();
+  errors += CompareParallel(templates.GetPointer(),
+                            "vtkGridSynchronizedTemplates3D degenerate");
+
+  vtkSMPTools::SetNumberOfThreads(0);
+  return errors ? 1 : 0;
+}
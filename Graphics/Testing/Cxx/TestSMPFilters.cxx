@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPFilters.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Run the filters that use vtkSMPTools with the sequential backend and
+// with the thread pool and check that both give exactly the same output.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellData.h"
+#include "vtkCellDataToPointData.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkElevationFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkGradientFilter.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static int CompareArrays(vtkDataArray *a, vtkDataArray *b, const char *name)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    cerr << name << ": arrays do not match in size" << endl;
+    return 1;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+    {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+      {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+        {
+        cerr << name << ": tuple " << i << " differs" << endl;
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+
+// Update the filter with the sequential backend and with the thread pool
+// and compare the named output array.
+static int CompareBackends(vtkAlgorithm *filter, int cellData,
+                           const char *arrayName, const char *name)
+{
+  vtkSmartPointer<vtkDataArray> reference;
+  for (int pass = 0; pass < 2; ++pass)
+    {
+    vtkSMPTools::SetBackend(pass == 0 ? vtkSMPTools::SEQUENTIAL :
+                            vtkSMPTools::THREAD_POOL);
+    filter->Modified();
+    filter->Update();
+    vtkDataSet *output = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0));
+    vtkFieldData *fd = cellData ?
+      static_cast<vtkFieldData *>(output->GetCellData()) :
+      static_cast<vtkFieldData *>(output->GetPointData());
+    vtkDataArray *array = fd->GetArray(arrayName);
+    if (!array)
+      {
+      cerr << name << ": no " << arrayName << " array" << endl;
+      return 1;
+      }
+    if (pass == 0)
+      {
+      reference.TakeReference(array->NewInstance());
+      reference->DeepCopy(array);
+      }
+    else
+      {
+      return CompareArrays(reference, array, name);
+      }
+    }
+  return 0;
+}
+
+int TestSMPFilters(int, char *[])
+{
+  int errors = 0;
+  vtkSMPTools::Initialize(4);
+
+  // Polygonal input.
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(200);
+
+  VTK_CREATE(vtkElevationFilter, elevation);
+  elevation->SetInputConnection(sphere->GetOutputPort());
+  elevation->SetLowPoint(-0.5, -0.5, -0.5);
+  elevation->SetHighPoint(0.5, 0.5, 0.5);
+  errors += CompareBackends(elevation, 0, "Elevation", "vtkElevationFilter");
+
+  VTK_CREATE(vtkPolyDataNormals, normals);
+  normals->SetInputConnection(elevation->GetOutputPort());
+  normals->SplittingOn();
+  normals->SetFeatureAngle(10.0);
+  normals->ComputeCellNormalsOn();
+  errors += CompareBackends(normals, 0, "Normals", "vtkPolyDataNormals");
+  errors += CompareBackends(normals, 1, "Normals",
+                            "vtkPolyDataNormals cell normals");
+
+  VTK_CREATE(vtkPointDataToCellData, p2c);
+  p2c->SetInputConnection(elevation->GetOutputPort());
+  VTK_CREATE(vtkCellDataToPointData, c2p);
+  c2p->SetInputConnection(p2c->GetOutputPort());
+  errors += CompareBackends(c2p, 0, "Elevation",
+                            "vtkCellDataToPointData poly data");
+
+  VTK_CREATE(vtkGradientFilter, polyGradient);
+  polyGradient->SetInputConnection(elevation->GetOutputPort());
+  polyGradient->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                                "Elevation");
+  errors += CompareBackends(polyGradient, 0, "Gradients",
+                            "vtkGradientFilter poly data");
+
+  // Image input.
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(40, 30, 20);
+  image->SetSpacing(0.1, 0.2, 0.3);
+  VTK_CREATE(vtkFloatArray, scalars);
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    scalars->SetValue(i, static_cast<float>(x[0]*x[1] + x[2]*x[2]));
+    }
+  image->GetPointData()->SetScalars(scalars);
+
+  VTK_CREATE(vtkGradientFilter, imageGradient);
+  imageGradient->SetInput(image);
+  imageGradient->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                                 "Scalars");
+  errors += CompareBackends(imageGradient, 0, "Gradients",
+                            "vtkGradientFilter image data");
+
+  VTK_CREATE(vtkPointDataToCellData, imageP2C);
+  imageP2C->SetInput(image);
+  VTK_CREATE(vtkCellDataToPointData, imageC2P);
+  imageC2P->SetInputConnection(imageP2C->GetOutputPort());
+  errors += CompareBackends(imageC2P, 0, "Scalars",
+                            "vtkCellDataToPointData image data");
+
+  // Unstructured input.
+  VTK_CREATE(vtkAppendFilter, append);
+  append->SetInputConnection(imageP2C->GetOutputPort());
+  VTK_CREATE(vtkCellDataToPointData, gridC2P);
+  gridC2P->SetInputConnection(append->GetOutputPort());
+  errors += CompareBackends(gridC2P, 0, "Scalars",
+                            "vtkCellDataToPointData unstructured grid");
+
+  VTK_CREATE(vtkGradientFilter, gridGradient);
+  gridGradient->SetInputConnection(gridC2P->GetOutputPort());
+  gridGradient->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                                "Scalars");
+  errors += CompareBackends(gridGradient, 0, "Gradients",
+                            "vtkGradientFilter unstructured grid");
+
+  VTK_CREATE(vtkGradientFilter, cellGradient);
+  cellGradient->SetInputConnection(append->GetOutputPort());
+  cellGradient->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_CELLS,
+                                "Scalars");
+  errors += CompareBackends(cellGradient, 1, "Gradients",
+                            "vtkGradientFilter cell data");
+
+  vtkSMPTools::SetBackend(vtkSMPTools::THREAD_POOL);
+  vtkSMPTools::SetNumberOfThreads(0);
+  return errors ? 1 : 0;
+}
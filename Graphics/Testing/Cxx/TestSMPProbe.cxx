@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPProbe.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Probe an unstructured grid and an image on one thread and on several
+// threads, and check that the same points are found and that they get the
+// exact values of a linear field.  The threaded probe searches with a
+// cell locator and may also find points just outside the source, within
+// the probe tolerance, that the single threaded walk misses.
+
+#include "vtkCharArray.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkPolyData.h"
+#include "vtkProbeFilter.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <math.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static double Field(const double x[3])
+{
+  return x[0] + 2.0*x[1] - 3.0*x[2];
+}
+
+// Whether x lies outside the bounds but close to them.
+static int NearBounds(const double x[3], const double bounds[6])
+{
+  int outside = 0;
+  for (int a = 0; a < 3; ++a)
+    {
+    if (x[a] < bounds[2*a] - 1e-3 || x[a] > bounds[2*a+1] + 1e-3)
+      {
+      return 0;
+      }
+    outside |= (x[a] < bounds[2*a] || x[a] > bounds[2*a+1]);
+    }
+  return outside;
+}
+
+static int CheckProbe(vtkDataSet *source, vtkPolyData *probe,
+                      const char *name)
+{
+  double bounds[6];
+  source->GetBounds(bounds);
+  VTK_CREATE(vtkProbeFilter, filter);
+  filter->SetInput(probe);
+  filter->SetSource(source);
+  vtkSmartPointer<vtkCharArray> reference;
+  vtkIdType numValid = 0, numNearBounds = 0;
+  for (int parallel = 0; parallel < 2; ++parallel)
+    {
+    filter->SetParallelExecution(parallel);
+    filter->Update();
+    vtkPointSet *pointSet = vtkPointSet::SafeDownCast(source);
+    if (pointSet && pointSet->GetCellLocator())
+      {
+      cerr << name << ": the probe left a cell locator on the source"
+           << endl;
+      return 1;
+      }
+    vtkDataSet *output = filter->GetOutput();
+    vtkCharArray *mask = vtkCharArray::SafeDownCast(
+      output->GetPointData()->GetArray("vtkValidPointMask"));
+    vtkDataArray *values = output->GetPointData()->GetArray("Field");
+    if (!mask || !values ||
+        values->GetNumberOfTuples() != probe->GetNumberOfPoints())
+      {
+      cerr << name << ": missing output arrays" << endl;
+      return 1;
+      }
+    for (vtkIdType i = 0; i < probe->GetNumberOfPoints(); ++i)
+      {
+      double x[3];
+      probe->GetPoint(i, x);
+      double expected = mask->GetValue(i) ? Field(x) : 0.0;
+      if (fabs(values->GetComponent(i, 0) - expected) > 1e-4)
+        {
+        cerr << name << ": point " << i << " has value "
+             << values->GetComponent(i, 0) << " instead of " << expected
+             << endl;
+        return 1;
+        }
+      }
+    if (parallel == 0)
+      {
+      reference = vtkSmartPointer<vtkCharArray>::New();
+      reference->DeepCopy(mask);
+      numValid = filter->GetValidPoints()->GetNumberOfTuples();
+      }
+    else
+      {
+      for (vtkIdType i = 0; i < probe->GetNumberOfPoints(); ++i)
+        {
+        if (mask->GetValue(i) == reference->GetValue(i))
+          {
+          continue;
+          }
+        double x[3];
+        probe->GetPoint(i, x);
+        if (reference->GetValue(i) || !NearBounds(x, bounds))
+          {
+          cerr << name << ": point " << i << " found on "
+               << (mask->GetValue(i) ? "several threads only" :
+                   "one thread only") << endl;
+          return 1;
+          }
+        ++numNearBounds;
+        }
+      if (filter->GetValidPoints()->GetNumberOfTuples() !=
+          numValid + numNearBounds)
+        {
+        cerr << name << ": the number of valid points differs" << endl;
+        return 1;
+        }
+      }
+    }
+  if (numValid == 0 || numValid == probe->GetNumberOfPoints())
+    {
+    cerr << name << ": expected points both inside and outside" << endl;
+    return 1;
+    }
+  return 0;
+}
+
+int TestSMPProbe(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(21, 16, 11);
+  image->SetOrigin(-1.0, -1.0, -1.0);
+  image->SetSpacing(0.1, 0.1, 0.2);
+  VTK_CREATE(vtkFloatArray, field);
+  field->SetName("Field");
+  field->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    field->SetValue(i, static_cast<float>(Field(x)));
+    }
+  image->GetPointData()->SetScalars(field);
+
+  VTK_CREATE(vtkDataSetTriangleFilter, tetra);
+  tetra->SetInput(image);
+  tetra->Update();
+
+  // Random points, some of them outside the source.
+  vtkMath::RandomSeed(8765);
+  VTK_CREATE(vtkPoints, points);
+  for (int i = 0; i < 20000; ++i)
+    {
+    points->InsertNextPoint(vtkMath::Random(-1.2, 1.2),
+                            vtkMath::Random(-1.2, 0.7),
+                            vtkMath::Random(-1.2, 1.2));
+    }
+  VTK_CREATE(vtkPolyData, probe);
+  probe->SetPoints(points);
+
+  int errors = CheckProbe(tetra->GetOutput(), probe, "unstructured grid");
+  errors += CheckProbe(image, probe, "image");
+
+  vtkSMPTools::SetNumberOfThreads(0);
+  return errors ? 1 : 0;
+}
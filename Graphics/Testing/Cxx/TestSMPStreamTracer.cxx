@@ -0,0 +1,190 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPStreamTracer.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Trace streamlines through an image and an unstructured grid on one
+// thread and on several threads, and check that the outputs are the same
+// point for point, in seed order.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamTracer.h"
+#include "vtkUnstructuredGrid.h"
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static int SameArray(vtkDataArray *a, vtkDataArray *b, const char *name)
+{
+  if (!a || !b)
+    {
+    cerr << name << ": missing array" << endl;
+    return 0;
+    }
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    cerr << name << ": arrays have different sizes" << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+    {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+      {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+        {
+        cerr << name << ": tuple " << i << " differs" << endl;
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+static int CheckTracer(vtkDataSet *input, vtkPolyData *seeds,
+                       const char *name)
+{
+  VTK_CREATE(vtkStreamTracer, tracer);
+  tracer->SetInput(input);
+  tracer->SetSource(seeds);
+  tracer->SetIntegratorTypeToRungeKutta45();
+  tracer->SetIntegrationDirectionToBoth();
+  tracer->SetMaximumPropagation(20.0);
+
+  tracer->SetParallelExecution(0);
+  tracer->Update();
+  VTK_CREATE(vtkPolyData, serial);
+  serial->DeepCopy(tracer->GetOutput());
+
+  tracer->SetParallelExecution(1);
+  tracer->Modified();
+  tracer->Update();
+  vtkPolyData *parallel = tracer->GetOutput();
+
+  if (serial->GetNumberOfLines() < seeds->GetNumberOfPoints())
+    {
+    cerr << name << ": only " << serial->GetNumberOfLines()
+         << " streamlines" << endl;
+    return 1;
+    }
+  if (parallel->GetNumberOfLines() != serial->GetNumberOfLines())
+    {
+    cerr << name << ": " << parallel->GetNumberOfLines()
+         << " streamlines instead of " << serial->GetNumberOfLines() << endl;
+    return 1;
+    }
+
+  vtkCellArray *lines[2] = { serial->GetLines(), parallel->GetLines() };
+  if (lines[0]->GetNumberOfConnectivityEntries() !=
+      lines[1]->GetNumberOfConnectivityEntries())
+    {
+    cerr << name << ": different connectivity" << endl;
+    return 1;
+    }
+  vtkIdType npts[2], *pts[2];
+  lines[0]->InitTraversal();
+  lines[1]->InitTraversal();
+  while (lines[0]->GetNextCell(npts[0], pts[0]))
+    {
+    lines[1]->GetNextCell(npts[1], pts[1]);
+    if (npts[0] != npts[1])
+      {
+      cerr << name << ": different connectivity" << endl;
+      return 1;
+      }
+    for (vtkIdType i = 0; i < npts[0]; ++i)
+      {
+      if (pts[0][i] != pts[1][i])
+        {
+        cerr << name << ": different connectivity" << endl;
+        return 1;
+        }
+      }
+    }
+
+  const char *pointArrays[] = { "velocity", "IntegrationTime", "Vorticity",
+                                "Rotation", "AngularVelocity", "Normals" };
+  int ok = SameArray(serial->GetPoints()->GetData(),
+                     parallel->GetPoints()->GetData(), name);
+  for (int i = 0; i < 6; ++i)
+    {
+    ok = ok && SameArray(serial->GetPointData()->GetArray(pointArrays[i]),
+                         parallel->GetPointData()->GetArray(pointArrays[i]),
+                         pointArrays[i]);
+    }
+  ok = ok && SameArray(
+    serial->GetCellData()->GetArray("ReasonForTermination"),
+    parallel->GetCellData()->GetArray("ReasonForTermination"),
+    "ReasonForTermination");
+  if (!ok)
+    {
+    cerr << name << ": outputs differ" << endl;
+    return 1;
+    }
+  return 0;
+}
+
+int TestSMPStreamTracer(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // A vortex around the z axis with an upward drift.
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(21, 21, 11);
+  image->SetOrigin(-1.0, -1.0, 0.0);
+  image->SetSpacing(0.1, 0.1, 0.1);
+  VTK_CREATE(vtkFloatArray, velocity);
+  velocity->SetName("velocity");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    velocity->SetTuple3(i, -x[1], x[0], 0.1);
+    }
+  image->GetPointData()->SetVectors(velocity);
+
+  VTK_CREATE(vtkDataSetTriangleFilter, tetra);
+  tetra->SetInput(image);
+  tetra->Update();
+
+  // More seeds than fit in one batch, some of them outside the field.
+  vtkMath::RandomSeed(4321);
+  VTK_CREATE(vtkPoints, points);
+  for (int i = 0; i < 300; ++i)
+    {
+    points->InsertNextPoint(vtkMath::Random(-0.8, 0.8),
+                            vtkMath::Random(-0.8, 0.8),
+                            vtkMath::Random(0.1, 0.9));
+    }
+  points->InsertNextPoint(5.0, 5.0, 5.0);
+  VTK_CREATE(vtkPolyData, seeds);
+  seeds->SetPoints(points);
+
+  int errors = CheckTracer(image, seeds, "image");
+  errors += CheckTracer(tetra->GetOutput(), seeds, "unstructured grid");
+
+  vtkSMPTools::SetNumberOfThreads(0);
+  return errors ? 1 : 0;
+}
@@ -20,14 +20,17 @@
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkUnstructuredGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
-#include "vtkUnsignedIntArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 
 #include <algorithm>
 #include <functional>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkCellDataToPointData);
 
@@ -40,6 +43,80 @@ vtkCellDataToPointData::vtkCellDataToPointData()
 
 #define VTK_MAX_CELLS_PER_POINT 4096
 
+//----------------------------------------------------------------------------
+// Averages the cell data around a range of points.  Points without cells
+// (or with too many) are only recorded; they are nulled afterwards on the
+// calling thread because NullPoint() may resize the arrays.
+class vtkCellDataToPointDataFunctor
+{
+public:
+  vtkCellDataToPointData *Filter;
+  vtkDataSet *Input;
+  vtkCellData *InCD;
+  vtkPointData *OutPD;
+  vtkIdType NumberOfPoints;
+  vtkMultiThreaderIDType MainThread;
+
+  vtkSMPThreadLocal<vtkSmartPointer<vtkIdList> > CellIds;
+  vtkSMPThreadLocal<vtkstd::vector<double> > Weights;
+  vtkSMPThreadLocal<vtkstd::vector<vtkIdType> > NullPoints;
+  vtkstd::vector<vtkIdType> AllNullPoints;
+
+  void Initialize()
+    {
+    vtkIdList *cellIds = vtkIdList::New();
+    cellIds->Allocate(VTK_MAX_CELLS_PER_POINT);
+    this->CellIds.Local().TakeReference(cellIds);
+    this->Weights.Local().resize(VTK_MAX_CELLS_PER_POINT);
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    if (this->Filter->GetAbortExecute())
+      {
+      return;
+      }
+    if (vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(),
+                                       this->MainThread))
+      {
+      this->Filter->UpdateProgress(
+        static_cast<double>(begin) / this->NumberOfPoints);
+      }
+
+    vtkIdList *cellIds = this->CellIds.Local();
+    double *weights = &this->Weights.Local()[0];
+    vtkstd::vector<vtkIdType>& nullPoints = this->NullPoints.Local();
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->Input->GetPointCells(ptId, cellIds);
+      vtkIdType numCells = cellIds->GetNumberOfIds();
+      if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
+        {
+        double weight = 1.0 / numCells;
+        for (vtkIdType cellId=0; cellId < numCells; cellId++)
+          {
+          weights[cellId] = weight;
+          }
+        this->OutPD->InterpolatePoint(this->InCD, ptId, cellIds, weights);
+        }
+      else
+        {
+        nullPoints.push_back(ptId);
+        }
+      }
+    }
+
+  void Reduce()
+    {
+    for (vtkSMPThreadLocal<vtkstd::vector<vtkIdType> >::iterator it =
+           this->NullPoints.begin(); it != this->NullPoints.end(); ++it)
+      {
+      this->AllNullPoints.insert(this->AllNullPoints.end(),
+                                 it->begin(), it->end());
+      }
+    }
+};
+
 //----------------------------------------------------------------------------
 int vtkCellDataToPointData::RequestData(
   vtkInformation*,
@@ -62,30 +139,21 @@ int vtkCellDataToPointData::RequestData(
     return this->RequestDataForUnstructuredGrid(0, inputVector, outputVector);
     }
 
-  vtkIdType cellId, ptId;
-  vtkIdType numCells, numPts;
+  vtkIdType numPts;
   vtkCellData *inPD=input->GetCellData();
   vtkPointData *outPD=output->GetPointData();
-  vtkIdList *cellIds;
-  double weight;
-  double *weights;
 
   vtkDebugMacro(<<"Mapping cell data to point data");
 
   // First, copy the input to the output as a starting point
   output->CopyStructure( input );
 
-  cellIds = vtkIdList::New();
-  cellIds->Allocate(VTK_MAX_CELLS_PER_POINT);
-
   if ( (numPts=input->GetNumberOfPoints()) < 1 )
     {
     vtkDebugMacro(<<"No input point data!");
-    cellIds->Delete();
     return 1;
     }
-  weights = new double[VTK_MAX_CELLS_PER_POINT];
-  
+
   // Pass the point data first. The fields and attributes
   // which also exist in the cell data of the input will
   // be over-written during CopyAllocate
@@ -97,33 +165,49 @@ int vtkCellDataToPointData::RequestData(
   // It's weird, but it works.
   outPD->InterpolateAllocate(inPD,numPts);
 
-  int abort=0;
-  vtkIdType progressInterval=numPts/20 + 1;
-  for (ptId=0; ptId < numPts && !abort; ptId++)
+  // The points are averaged in parallel.  Each thread writes its own
+  // tuples in place, so the arrays are sized up front.  Bit arrays pack
+  // several points into one byte and other arrays cannot be written in
+  // place at all, so those inputs are processed on one thread, as are
+  // data sets whose GetPointCells() is not known to be reentrant.
+  int parallel = input->IsA("vtkPolyData") || input->IsA("vtkImageData") ||
+    input->IsA("vtkRectilinearGrid") || input->IsA("vtkStructuredGrid");
+  for (int i = 0; i < inPD->GetNumberOfArrays(); i++)
     {
-    if ( !(ptId % progressInterval) )
+    vtkAbstractArray *array = inPD->GetAbstractArray(i);
+    if (!array->IsA("vtkDataArray") || array->GetDataType() == VTK_BIT)
       {
-      this->UpdateProgress(static_cast<double>(ptId)/numPts);
-      abort = GetAbortExecute();
+      parallel = 0;
       }
-
-    input->GetPointCells(ptId, cellIds);
-    numCells = cellIds->GetNumberOfIds();
-    if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
-      {
-      weight = 1.0 / numCells;
-      for (cellId=0; cellId < numCells; cellId++)
-        {
-        weights[cellId] = weight;
-        }
-      outPD->InterpolatePoint(inPD, ptId, cellIds, weights);
-      }
-    else
+    }
+  for (int i = 0; i < outPD->GetNumberOfArrays(); i++)
+    {
+    vtkAbstractArray *array = outPD->GetAbstractArray(i);
+    if (array->GetNumberOfTuples() < numPts)
       {
-      outPD->NullPoint(ptId);
+      array->SetNumberOfTuples(numPts);
       }
     }
 
+  // Build the cell links (if any) before the threads ask for them.
+  vtkIdList *cellIds = vtkIdList::New();
+  input->GetPointCells(0, cellIds);
+  cellIds->Delete();
+
+  vtkCellDataToPointDataFunctor functor;
+  functor.Filter = this;
+  functor.Input = input;
+  functor.InCD = inPD;
+  functor.OutPD = outPD;
+  functor.NumberOfPoints = numPts;
+  functor.MainThread = vtkMultiThreader::GetCurrentThreadID();
+  vtkSMPTools::Reduce(0, numPts, parallel ? 0 : numPts, functor);
+
+  for (size_t i = 0; i < functor.AllNullPoints.size(); i++)
+    {
+    outPD->NullPoint(functor.AllNullPoints[i]);
+    }
+
   if ( !this->PassCellData )
     {
     output->GetCellData()->CopyAllOff();
@@ -131,9 +215,6 @@ int vtkCellDataToPointData::RequestData(
     }
   output->GetCellData()->PassData(input->GetCellData());
 
-  cellIds->Delete();
-  delete [] weights;
-  
   return 1;
 }
 
@@ -149,46 +230,67 @@ void vtkCellDataToPointData::PrintSelf(ostream& os, vtkIndent indent)
 // Helper template function that implement the major part of the algorighm
 // which will be expanded by the vtkTemplateMacro. The template function is
 // provided so that coverage test can cover this function.
+//
+// The cell values are gathered per point through the point-to-cell table
+// (offsets, cells) rather than scattered per cell, so that the points can
+// be split across threads.  Every point still adds up its cells in
+// increasing cell order, which gives the same sums as the scatter.
 namespace
 {
   template <typename T>
-  void __spread (vtkUnstructuredGrid* const src, vtkUnsignedIntArray* const num,
-             vtkDataArray* const srcarray, vtkDataArray* const dstarray,
-             vtkIdType ncells, vtkIdType npoints, vtkIdType ncomps)
+  class __spread
   {
-    T const* const srcptr = static_cast<T const*>(srcarray->GetVoidPointer(0));
-    T      * const dstptr = static_cast<T      *>(dstarray->GetVoidPointer(0));
-
-    // zero initialization
-    vtkstd::fill_n(dstptr, npoints*ncomps, T(0));
-
-    // accumulate
-    T const* srcbeg = srcptr;
-    for (vtkIdType cid = 0; cid < ncells; ++cid, srcbeg += ncomps)
-      {
-      vtkIdList* const pids = src->GetCell(cid)->GetPointIds();
-      for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
+  public:
+    vtkIdType const* Offsets;
+    vtkIdType const* Cells;
+    T const* SrcPtr;
+    T      * DstPtr;
+    vtkIdType NComps;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkIdType const ncomps = this->NComps;
+      T* dstbeg = this->DstPtr + begin*ncomps;
+      for (vtkIdType pid = begin; pid < end; ++pid, dstbeg += ncomps)
         {
-        T* const dstbeg = dstptr + pids->GetId(i)*ncomps;
+        // zero initialization
+        vtkstd::fill_n(dstbeg, ncomps, T(0));
+
         // accumulate cell data to point data <==> point_data += cell_data
-        vtkstd::transform(srcbeg,srcbeg+ncomps,dstbeg,dstbeg,vtkstd::plus<T>());
+        vtkIdType const cbeg = this->Offsets[pid];
+        vtkIdType const cend = this->Offsets[pid+1];
+        for (vtkIdType c = cbeg; c < cend; ++c)
+          {
+          T const* const srcbeg = this->SrcPtr + this->Cells[c]*ncomps;
+          vtkstd::transform(srcbeg,srcbeg+ncomps,dstbeg,dstbeg,
+                            vtkstd::plus<T>());
+          }
+
+        // average, guard against divide by zero
+        if (unsigned int const denum = static_cast<unsigned int>(cend-cbeg))
+          {
+          // divide point data by the number of cells using it <==>
+          // point_data /= denum
+          vtkstd::transform(dstbeg, dstbeg+ncomps, dstbeg,
+            vtkstd::bind2nd(vtkstd::divides<T>(), denum));
+          }
         }
-      }
+    }
 
-    // average
-    T* dstbeg = dstptr;
-    for (vtkIdType pid = 0; pid < npoints; ++pid, dstbeg += ncomps)
-      {
-      // guard against divide by zero
-      if (unsigned int const denum = num->GetValue(pid))
-        { 
-        // divide point data by the number of cells using it <==>
-        // point_data /= denum
-        vtkstd::transform(dstbeg, dstbeg+ncomps, dstbeg,
-          vtkstd::bind2nd(vtkstd::divides<T>(), denum));
-        }
-      }
-  }
+    static void Execute(vtkIdType const* offsets, vtkIdType const* cells,
+                        vtkDataArray* const srcarray,
+                        vtkDataArray* const dstarray,
+                        vtkIdType npoints, vtkIdType ncomps)
+    {
+      __spread<T> functor;
+      functor.Offsets = offsets;
+      functor.Cells = cells;
+      functor.SrcPtr = static_cast<T const*>(srcarray->GetVoidPointer(0));
+      functor.DstPtr = static_cast<T      *>(dstarray->GetVoidPointer(0));
+      functor.NComps = ncomps;
+      vtkSMPTools::For(0, npoints, functor);
+    }
+  };
 }
 
 //----------------------------------------------------------------------------
@@ -210,19 +312,30 @@ int vtkCellDataToPointData::RequestDataForUnstructuredGrid
     return 1;
     }
 
-  // count the number of cells associated with each point
-  vtkSmartPointer<vtkUnsignedIntArray> num
-    = vtkSmartPointer<vtkUnsignedIntArray>::New();
-  num->SetNumberOfComponents(1);
-  num->SetNumberOfTuples(npoints);
-  vtkstd::fill_n(num->GetPointer(0), npoints, 0u);
+  // count the number of cells associated with each point, then list the
+  // cells of every point in increasing cell order
+  vtkstd::vector<vtkIdType> offsets(npoints+1, 0);
+  vtkIdType npts, *pts;
+  for (vtkIdType cid = 0; cid < ncells; ++cid)
+    {
+    src->GetCellPoints(cid, npts, pts);
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      ++offsets[pts[i]+1];
+      }
+    }
+  for (vtkIdType pid = 0; pid < npoints; ++pid)
+    {
+    offsets[pid+1] += offsets[pid];
+    }
+  vtkstd::vector<vtkIdType> cells(offsets[npoints] > 0 ? offsets[npoints] : 1);
+  vtkstd::vector<vtkIdType> next(offsets.begin(), offsets.end()-1);
   for (vtkIdType cid = 0; cid < ncells; ++cid)
     {
-    vtkIdList* const pids = src->GetCell(cid)->GetPointIds();
-    for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
+    src->GetCellPoints(cid, npts, pts);
+    for (vtkIdType i = 0; i < npts; ++i)
       {
-      vtkIdType const pid = pids->GetId(i);
-      num->SetValue(pid, num->GetValue(pid)+1);
+      cells[next[pts[i]]++] = cid;
       }
     }
 
@@ -289,7 +402,8 @@ int vtkCellDataToPointData::RequestDataForUnstructuredGrid
     switch (srcarray->GetDataType())
       {
       vtkTemplateMacro
-        (__spread<VTK_TT>(src,num,srcarray,dstarray,ncells,npoints,ncomps));
+        (__spread<VTK_TT>::Execute(&offsets[0],&cells[0],srcarray,dstarray,
+                                   npoints,ncomps));
       }
     }
 
@@ -27,9 +27,15 @@
 #include "vtkSimpleScalarTree.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkCutter.h"
+#include "vtkGenericCell.h"
 #include "vtkMergePoints.h"
+#include "vtkMultiThreader.h"
 #include "vtkPointLocator.h"
 #include "vtkIncrementalPointLocator.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
 
 #include <math.h>
 
@@ -50,6 +56,8 @@ vtkContourGrid::vtkContourGrid()
   this->UseScalarTree = 0;
   this->ScalarTree = NULL;
 
+  this->ParallelExecution = 1;
+
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
                                vtkDataSetAttributes::SCALARS);
@@ -90,6 +98,368 @@ unsigned long vtkContourGrid::GetMTime()
   return mTime;
 }
 
+// When contouring in parallel the cells are split into batches of this
+// many cells.  The batches are merged in order, so the output does not
+// depend on the batch size.
+#define VTK_CONTOUR_GRID_BATCH_SIZE 4096
+
+//----------------------------------------------------------------------------
+// The batches are contoured into point and cell data allocated the same way
+// as the output.  Check that this gives the same arrays as the output so
+// that tuples can be copied array by array when merging.
+static int vtkContourGridSameArrays(vtkFieldData *a, vtkFieldData *b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    return 0;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+    {
+    vtkAbstractArray *aa = a->GetAbstractArray(i);
+    vtkAbstractArray *ba = b->GetAbstractArray(i);
+    if (aa->GetDataType() != ba->GetDataType() ||
+        aa->GetNumberOfComponents() != ba->GetNumberOfComponents())
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static void vtkContourGridAllocateAttributes(vtkPointData *inPd,
+                                             vtkCellData *inCd,
+                                             vtkPointData *outPd,
+                                             vtkCellData *outCd,
+                                             int computeScalars,
+                                             vtkIdType estimatedSize)
+{
+  // if we did not ask for scalars to be computed, don't copy them
+  if (!computeScalars)
+    {
+    outPd->CopyScalarsOff();
+    }
+  outPd->InterpolateAllocate(inPd,estimatedSize,estimatedSize);
+  outCd->CopyAllocate(inCd,estimatedSize,estimatedSize);
+}
+
+//----------------------------------------------------------------------------
+// Contour the cells of one dimensionality in one batch into a polydata of
+// its own, merging points with a private vtkMergePoints.
+template <class T>
+class vtkContourGridFunctor
+{
+public:
+  vtkContourGrid *Filter;
+  vtkUnstructuredGrid *Input;
+  vtkDataArray *InScalars;
+  T *Scalars;
+  int NumberOfContours;
+  double *Values;
+  int ComputeScalars;
+  vtkIdType NumberOfCells;
+  vtkIdType NumberOfBatches;
+  // Computed on the calling thread; GetBounds() writes to the input.
+  double Bounds[6];
+  unsigned char CellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkMultiThreaderIDType MainThread;
+  // One entry per (dimensionality, batch), NULL when nothing was produced.
+  vtkstd::vector<vtkPolyData *> Pieces;
+
+  vtkSMPThreadLocal<vtkSmartPointer<vtkGenericCell> > Cell;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkDataArray> > CellScalars;
+
+  void Initialize()
+    {
+    this->Cell.Local() = vtkSmartPointer<vtkGenericCell>::New();
+    vtkDataArray *cellScalars = this->InScalars->NewInstance();
+    cellScalars->SetNumberOfComponents(
+      this->InScalars->GetNumberOfComponents());
+    cellScalars->Allocate(
+      VTK_CELL_SIZE*this->InScalars->GetNumberOfComponents());
+    this->CellScalars.Local().TakeReference(cellScalars);
+    }
+
+  void Reduce()
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    if (this->Filter->GetAbortExecute())
+      {
+      return;
+      }
+    if (vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(),
+                                       this->MainThread))
+      {
+      this->Filter->UpdateProgress(
+        static_cast<double>(begin) / this->Pieces.size());
+      }
+    for (vtkIdType task = begin; task < end; ++task)
+      {
+      vtkIdType first = (task % this->NumberOfBatches) *
+        VTK_CONTOUR_GRID_BATCH_SIZE;
+      vtkIdType last = first + VTK_CONTOUR_GRID_BATCH_SIZE;
+      if (last > this->NumberOfCells)
+        {
+        last = this->NumberOfCells;
+        }
+      this->Pieces[task] = this->ContourBatch(
+        static_cast<int>(task / this->NumberOfBatches) + 1, first, last);
+      }
+    }
+
+  vtkPolyData *ContourBatch(int dimensionality, vtkIdType first,
+                            vtkIdType last)
+    {
+    vtkGenericCell *cell = this->Cell.Local();
+    vtkDataArray *cellScalars = this->CellScalars.Local();
+    vtkPointData *inPd = this->Input->GetPointData();
+    vtkCellData *inCd = this->Input->GetCellData();
+    vtkPolyData *piece = NULL;
+    vtkMergePoints *locator = NULL;
+    vtkIdType npts, *pts;
+    double range[2];
+    int i;
+
+    for (vtkIdType cellId = first; cellId < last; ++cellId)
+      {
+      int cellType = this->Input->GetCellType(cellId);
+      if (cellType >= VTK_NUMBER_OF_CELL_TYPES)
+        { // Protect against new cell types added.
+        vtkGenericWarningMacro("Unknown cell type " << cellType);
+        continue;
+        }
+      if (this->CellTypeDimensions[cellType] != dimensionality)
+        {
+        continue;
+        }
+
+      //find min and max values in scalar data
+      this->Input->GetCellPoints(cellId, npts, pts);
+      range[0] = range[1] = this->Scalars[pts[0]];
+      for (i = 1; i < npts; i++)
+        {
+        double tempScalar = this->Scalars[pts[i]];
+        if (tempScalar <= range[0])
+          {
+          range[0] = tempScalar;
+          }
+        if (tempScalar >= range[1])
+          {
+          range[1] = tempScalar;
+          }
+        }
+
+      int needCell = 0;
+      for (i = 0; i < this->NumberOfContours; i++)
+        {
+        if ((this->Values[i] >= range[0]) && (this->Values[i] <= range[1]))
+          {
+          needCell = 1;
+          }
+        }
+      if (!needCell)
+        {
+        continue;
+        }
+
+      if (!piece)
+        {
+        vtkIdType estimatedSize = static_cast<vtkIdType>(
+          pow(static_cast<double>(last - first), .75));
+        estimatedSize *= this->NumberOfContours;
+        if (estimatedSize < 1024)
+          {
+          estimatedSize = 1024;
+          }
+        piece = vtkPolyData::New();
+        vtkPoints *newPts = vtkPoints::New();
+        newPts->Allocate(estimatedSize,estimatedSize);
+        piece->SetPoints(newPts);
+        newPts->Delete();
+        vtkCellArray *newCells = vtkCellArray::New();
+        piece->SetVerts(newCells);
+        newCells->Delete();
+        newCells = vtkCellArray::New();
+        piece->SetLines(newCells);
+        newCells->Delete();
+        newCells = vtkCellArray::New();
+        newCells->Allocate(estimatedSize,estimatedSize);
+        piece->SetPolys(newCells);
+        newCells->Delete();
+        vtkContourGridAllocateAttributes(inPd, inCd, piece->GetPointData(),
+                                         piece->GetCellData(),
+                                         this->ComputeScalars,
+                                         estimatedSize);
+        locator = vtkMergePoints::New();
+        locator->InitPointInsertion(newPts, this->Bounds, estimatedSize);
+        }
+
+      this->Input->GetCell(cellId, cell);
+      this->InScalars->GetTuples(cell->GetPointIds(), cellScalars);
+      for (i = 0; i < this->NumberOfContours; i++)
+        {
+        if ((this->Values[i] >= range[0]) && (this->Values[i] <= range[1]))
+          {
+          cell->Contour(this->Values[i], cellScalars, locator,
+                        piece->GetVerts(), piece->GetLines(),
+                        piece->GetPolys(), inPd, piece->GetPointData(),
+                        inCd, cellId, piece->GetCellData());
+          }
+        }
+      }
+
+    if (locator)
+      {
+      locator->Delete();
+      }
+    return piece;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Append a batch to the output.  The points of the batch are inserted into
+// the output locator in the order the batch created them, which is the
+// order in which a single pass over the cells creates them, so the merged
+// output has the same point ids as the serial one.  Cell data follows the
+// verts, lines, polys numbering used by vtkCell::Contour().
+static void vtkContourGridMergePiece(vtkPolyData *piece,
+                                     vtkIncrementalPointLocator *locator,
+                                     vtkCellArray *newVerts,
+                                     vtkCellArray *newLines,
+                                     vtkCellArray *newPolys,
+                                     vtkPointData *outPd, vtkCellData *outCd,
+                                     vtkstd::vector<vtkIdType>& pointMap)
+{
+  vtkPoints *pts = piece->GetPoints();
+  vtkPointData *pd = piece->GetPointData();
+  vtkCellData *cd = piece->GetCellData();
+  vtkIdType numPts = pts->GetNumberOfPoints();
+  int numPointArrays = outPd->GetNumberOfArrays();
+  int numCellArrays = outCd->GetNumberOfArrays();
+  double x[3];
+  int i;
+
+  pointMap.resize(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    pts->GetPoint(ptId, x);
+    if (locator->InsertUniquePoint(x, pointMap[ptId]))
+      {
+      for (i = 0; i < numPointArrays; ++i)
+        {
+        outPd->GetAbstractArray(i)->InsertTuple(pointMap[ptId], ptId,
+                                                pd->GetAbstractArray(i));
+        }
+      }
+    }
+
+  vtkCellArray *inCells[3] = { piece->GetVerts(), piece->GetLines(),
+                               piece->GetPolys() };
+  vtkCellArray *outCells[3] = { newVerts, newLines, newPolys };
+  vtkIdType inCellId = 0;
+  vtkIdType offset = 0;
+  vtkIdType npts, *cellPts;
+  vtkIdType newPts[VTK_CELL_SIZE];
+  for (int type = 0; type < 3; ++type)
+    {
+    vtkCellArray *cells = inCells[type];
+    for (cells->InitTraversal(); cells->GetNextCell(npts, cellPts);
+         ++inCellId)
+      {
+      vtkIdType *ids = (npts <= VTK_CELL_SIZE ? newPts : new vtkIdType[npts]);
+      for (vtkIdType j = 0; j < npts; ++j)
+        {
+        ids[j] = pointMap[cellPts[j]];
+        }
+      vtkIdType outCellId = offset + outCells[type]->InsertNextCell(npts, ids);
+      if (ids != newPts)
+        {
+        delete [] ids;
+        }
+      for (i = 0; i < numCellArrays; ++i)
+        {
+        outCd->GetAbstractArray(i)->InsertTuple(outCellId, inCellId,
+                                                cd->GetAbstractArray(i));
+        }
+      }
+    offset += outCells[type]->GetNumberOfCells();
+    }
+}
+
+//----------------------------------------------------------------------------
+// Contour the cells in parallel batches and merge them into the output.
+// Returns 0 without doing anything when the batches cannot be merged
+// exactly, in which case the caller runs the serial loop.
+template <class T>
+int vtkContourGridParallelExecute(vtkContourGrid *self,
+                                  vtkUnstructuredGrid *input,
+                                  vtkDataArray *inScalars, T *scalarArrayPtr,
+                                  int numContours, double *values,
+                                  int computeScalars,
+                                  vtkIncrementalPointLocator *locator,
+                                  vtkCellArray *newVerts,
+                                  vtkCellArray *newLines,
+                                  vtkCellArray *newPolys,
+                                  vtkPointData *outPd, vtkCellData *outCd)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  if (!locator->IsA("vtkMergePoints") ||
+      numCells <= VTK_CONTOUR_GRID_BATCH_SIZE)
+    {
+    return 0;
+    }
+
+  vtkPolyData *prototype = vtkPolyData::New();
+  vtkContourGridAllocateAttributes(input->GetPointData(),
+                                   input->GetCellData(),
+                                   prototype->GetPointData(),
+                                   prototype->GetCellData(),
+                                   computeScalars, 1);
+  int same = vtkContourGridSameArrays(outPd, prototype->GetPointData()) &&
+    vtkContourGridSameArrays(outCd, prototype->GetCellData());
+  prototype->Delete();
+  if (!same)
+    {
+    return 0;
+    }
+
+  vtkContourGridFunctor<T> functor;
+  input->GetBounds(functor.Bounds);
+  functor.Filter = self;
+  functor.Input = input;
+  functor.InScalars = inScalars;
+  functor.Scalars = scalarArrayPtr;
+  functor.NumberOfContours = numContours;
+  functor.Values = values;
+  functor.ComputeScalars = computeScalars;
+  functor.NumberOfCells = numCells;
+  functor.NumberOfBatches = (numCells + VTK_CONTOUR_GRID_BATCH_SIZE - 1) /
+    VTK_CONTOUR_GRID_BATCH_SIZE;
+  vtkCutter::GetCellTypeDimensions(functor.CellTypeDimensions);
+  functor.MainThread = vtkMultiThreader::GetCurrentThreadID();
+  // We skip 0d cells (points), because they cannot be cut (generate no data).
+  // Batches of 1d cells come first, then 2d and 3d cells, so that the
+  // output cells are in the order verts, lines and polys.
+  functor.Pieces.resize(3*functor.NumberOfBatches, NULL);
+  vtkSMPTools::Reduce(0, static_cast<vtkIdType>(functor.Pieces.size()), 1,
+                      functor);
+
+  vtkstd::vector<vtkIdType> pointMap;
+  for (size_t i = 0; i < functor.Pieces.size(); ++i)
+    {
+    if (functor.Pieces[i])
+      {
+      vtkContourGridMergePiece(functor.Pieces[i], locator, newVerts,
+                               newLines, newPolys, outPd, outCd, pointMap);
+      functor.Pieces[i]->Delete();
+      }
+    }
+  return 1;
+}
+
 template <class T>
 void vtkContourGridExecute(vtkContourGrid *self, vtkDataSet *input,
                            vtkPolyData *output,
@@ -147,17 +517,20 @@ void vtkContourGridExecute(vtkContourGrid *self, vtkDataSet *input,
   locator->InitPointInsertion (newPts, input->GetBounds(),estimatedSize);
 
   // interpolate data along edge
-  // if we did not ask for scalars to be computed, don't copy them
-  if (!computeScalars)
-    {
-    outPd->CopyScalarsOff();
-    }
-  outPd->InterpolateAllocate(inPd,estimatedSize,estimatedSize);
-  outCd->CopyAllocate(inCd,estimatedSize,estimatedSize);
+  vtkContourGridAllocateAttributes(inPd, inCd, outPd, outCd, computeScalars,
+                                   estimatedSize);
 
   // If enabled, build a scalar tree to accelerate search
   //
-  if ( !useScalarTree )
+  if ( !useScalarTree && self->GetParallelExecution() &&
+       vtkContourGridParallelExecute(self, grid, inScalars, scalarArrayPtr,
+                                     numContours, values, computeScalars,
+                                     locator, newVerts, newLines, newPolys,
+                                     outPd, outCd) )
+    {
+    // Already contoured in parallel.
+    }
+  else if ( !useScalarTree )
     {
     // Three passes over the cells to process lower dimensional cells first.
     // For poly data output cells need to be added in the order:
@@ -426,6 +799,8 @@ void vtkContourGrid::PrintSelf(ostream& os, vtkIndent indent)
      << (this->ComputeScalars ? "On\n" : "Off\n");
   os << indent << "Use Scalar Tree: " 
      << (this->UseScalarTree ? "On\n" : "Off\n");
+  os << indent << "Parallel Execution: " 
+     << (this->ParallelExecution ? "On\n" : "Off\n");
 
   this->ContourValues->PrintSelf(os,indent.GetNextIndent());
 
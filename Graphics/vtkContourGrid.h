@@ -32,6 +32,9 @@
 // contours are being extracted. If you want to use a scalar tree,
 // invoke the method UseScalarTreeOn().
 //
+// Without a scalar tree the cells are contoured in parallel, see
+// ParallelExecution.
+//
 
 // .SECTION Caveats
 // For unstructured data or structured grids, normals and gradients
@@ -41,7 +44,7 @@
 // .SECTION See Also
 // vtkMarchingContourFilter vtkKitwareContourFilter
 // vtkMarchingCubes vtkSliceCubes vtkDividingCubes vtkMarchingSquares
-// vtkImageMarchingCubes
+// vtkImageMarchingCubes vtkSMPTools
 
 #ifndef __vtkContourGrid_h
 #define __vtkContourGrid_h
@@ -112,6 +115,16 @@ public:
   vtkGetMacro(UseScalarTree,int);
   vtkBooleanMacro(UseScalarTree,int);
 
+  // Description:
+  // When on (the default), the cells are contoured in batches on several
+  // threads with vtkSMPTools and the batches are merged in cell order, so
+  // the output is the same as with a single thread. The parallel path is
+  // only taken when no scalar tree is used and the locator is a
+  // vtkMergePoints.
+  vtkSetMacro(ParallelExecution,int);
+  vtkGetMacro(ParallelExecution,int);
+  vtkBooleanMacro(ParallelExecution,int);
+
   // Description:
   // Set / get a spatial locator for merging points. By default, 
   // an instance of vtkMergePoints is used.
@@ -138,6 +151,7 @@ protected:
   int UseScalarTree;
   vtkScalarTree *ScalarTree;
   vtkEdgeTable *EdgeTable;
+  int ParallelExecution;
   
 private:
   vtkContourGrid(const vtkContourGrid&);  // Not implemented.
@@ -17,15 +17,68 @@
 #include "vtkCellData.h"
 #include "vtkDataSet.h"
 #include "vtkFloatArray.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 
 vtkStandardNewMacro(vtkElevationFilter);
 
+//----------------------------------------------------------------------------
+// Computes the elevation of a range of points.  Only the thread that runs
+// RequestData reports progress; every thread honors an abort request.
+class vtkElevationFilterFunctor
+{
+public:
+  vtkElevationFilter *Filter;
+  vtkDataSet *Input;
+  float *Scalars;
+  double LowPoint[3];
+  double DiffVector[3];
+  double Length2;
+  double ScalarRange[2];
+  vtkIdType NumberOfPoints;
+  vtkMultiThreaderIDType MainThread;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    if (this->Filter->GetAbortExecute())
+      {
+      return;
+      }
+    if (vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(),
+                                       this->MainThread))
+      {
+      this->Filter->UpdateProgress(
+        static_cast<double>(begin) / this->NumberOfPoints);
+      }
+
+    double diffScalar = this->ScalarRange[1] - this->ScalarRange[0];
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      // Project this input point into the 1D system.
+      double x[3];
+      this->Input->GetPoint(i, x);
+      double v[3] = { x[0] - this->LowPoint[0],
+                      x[1] - this->LowPoint[1],
+                      x[2] - this->LowPoint[2] };
+      double s = vtkMath::Dot(v, this->DiffVector) / this->Length2;
+      s = (s < 0.0 ? 0.0 : s > 1.0 ? 1.0 : s);
+
+      // Store the resulting scalar value.
+      this->Scalars[i] =
+        static_cast<float>(this->ScalarRange[0] + s*diffScalar);
+      }
+    }
+};
+
 //----------------------------------------------------------------------------
 vtkElevationFilter::vtkElevationFilter()
 {
@@ -63,6 +116,19 @@ void vtkElevationFilter::PrintSelf(ostream& os, vtkIndent indent)
      << this->ScalarRange[1] << ")\n";
 }
 
+//----------------------------------------------------------------------------
+void vtkElevationFilter::CopyParameters(vtkAlgorithm* from)
+{
+  this->Superclass::CopyParameters(from);
+  vtkElevationFilter* filter = vtkElevationFilter::SafeDownCast(from);
+  if(filter)
+    {
+    this->SetLowPoint(filter->LowPoint);
+    this->SetHighPoint(filter->HighPoint);
+    this->SetScalarRange(filter->ScalarRange);
+    }
+}
+
 //----------------------------------------------------------------------------
 int vtkElevationFilter::RequestData(vtkInformation*,
                                     vtkInformationVector** inputVector,
@@ -100,35 +166,35 @@ int vtkElevationFilter::RequestData(vtkInformation*,
     length2 = 1.0;
     }
 
-  // Support progress and abort.
-  vtkIdType tenth = (numPts >= 10? numPts/10 : 1);
-  double numPtsInv = 1.0/numPts;
-  int abort = 0;
+  // Compute parametric coordinate and map into scalar range.  Other
+  // data sets may answer GetPoint() from a shared buffer, so only the
+  // ones known to be safe are split across threads.
+  vtkElevationFilterFunctor functor;
+  functor.Filter = this;
+  functor.Input = input;
+  functor.Scalars = newScalars->GetPointer(0);
+  functor.Length2 = length2;
+  functor.NumberOfPoints = numPts;
+  functor.MainThread = vtkMultiThreader::GetCurrentThreadID();
+  for (int j = 0; j < 3; ++j)
+    {
+    functor.LowPoint[j] = this->LowPoint[j];
+    functor.DiffVector[j] = diffVector[j];
+    }
+  functor.ScalarRange[0] = this->ScalarRange[0];
+  functor.ScalarRange[1] = this->ScalarRange[1];
 
-  // Compute parametric coordinate and map into scalar range.
-  double diffScalar = this->ScalarRange[1] - this->ScalarRange[0];
   vtkDebugMacro("Generating elevation scalars!");
-  for(vtkIdType i=0; i < numPts && !abort; ++i)
+  if (vtkPointSet::SafeDownCast(input) || vtkImageData::SafeDownCast(input) ||
+      vtkRectilinearGrid::SafeDownCast(input))
     {
-    // Periodically update progress and check for an abort request.
-    if(i % tenth == 0)
-      {
-      this->UpdateProgress((i+1)*numPtsInv);
-      abort = this->GetAbortExecute();
-      }
-
-    // Project this input point into the 1D system.
-    double x[3];
-    input->GetPoint(i, x);
-    double v[3] = { x[0] - this->LowPoint[0],
-                    x[1] - this->LowPoint[1],
-                    x[2] - this->LowPoint[2] };
-    double s = vtkMath::Dot(v, diffVector) / length2;
-    s = (s < 0.0 ? 0.0 : s > 1.0 ? 1.0 : s);
-
-    // Store the resulting scalar value.
-    newScalars->SetValue(i, this->ScalarRange[0] + s*diffScalar);
+    vtkSMPTools::For(0, numPts, functor);
+    }
+  else
+    {
+    functor(0, numPts);
     }
+  this->UpdateProgress(1.0);
 
   // Copy all the input geometry and data to the output.
   output->CopyStructure(input);
@@ -19,6 +19,11 @@
 // are generated by computing a projection of each dataset point onto
 // a line. The line can be oriented arbitrarily. A typical example is
 // to generate scalars based on elevation or height above a plane.
+//
+// The points are processed in parallel with vtkSMPTools when the input is
+// a vtkPointSet, vtkImageData or vtkRectilinearGrid.
+// .SECTION See Also
+// vtkSMPTools
 
 #ifndef __vtkElevationFilter_h
 #define __vtkElevationFilter_h
@@ -49,6 +54,10 @@ public:
   vtkSetVector2Macro(ScalarRange,double);
   vtkGetVectorMacro(ScalarRange,double,2);
 
+  // Description:
+  // Copy the line and the scalar range of another elevation filter.
+  virtual void CopyParameters(vtkAlgorithm* from);
+
 protected:
   vtkElevationFilter();
   ~vtkElevationFilter();
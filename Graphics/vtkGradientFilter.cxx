@@ -25,6 +25,7 @@
 #include "vtkCellDataToPointData.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -34,6 +35,9 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnstructuredGrid.h"
@@ -67,6 +71,8 @@ namespace
   int GetCellParametricData(
     vtkIdType pointId, double pointCoord[3], vtkCell *cell, int & subId, 
     double parametricCoord[3]);
+
+  int PrepareCellQueries(vtkDataSet *structure, int needLinks);
   
   template<class data_type>
   void ComputeCellGradientsUG(
@@ -94,9 +100,11 @@ namespace
   }
 
   // generic way to get the coordinate for either a cell (using 
-  // the parametric center) or a point
+  // the parametric center) or a point.  Cell is scratch space, so that
+  // several threads can ask at once.
   void GetGridEntityCoordinate(vtkDataSet* Grid, int fieldAssociation, 
-                               vtkIdType Index, double Coords[3])
+                               vtkIdType Index, double Coords[3],
+                               vtkGenericCell* Cell)
   {
     if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
       {
@@ -104,7 +112,7 @@ namespace
       }
     else
       {
-      vtkCell* Cell = Grid->GetCell(Index);
+      Grid->GetCell(Index, Cell);
       double pcoords[3];
       int subId = Cell->GetParametricCenter(pcoords);
       vtkstd::vector<double> weights(Cell->GetNumberOfPoints());
@@ -494,92 +502,153 @@ int vtkGradientFilter::ComputeRegularGridGradient(
 
 namespace {
 //-----------------------------------------------------------------------------
-  template<class data_type>
-  void ComputePointGradientsUG(
-    vtkDataSet *structure, data_type *Array,
-    data_type *gradients, int NumberOfInputComponents, int ComputeVorticity)
+  // Cell and link queries build their tables on first use.  Do that here,
+  // on one thread, and report whether the data set can then be queried
+  // from several threads.
+  int PrepareCellQueries(vtkDataSet *structure, int needLinks)
   {
-    vtkIdList* currentPoint = vtkIdList::New();
-    currentPoint->SetNumberOfIds(1);
-    vtkIdList* cellsOnPoint = vtkIdList::New();
-    
-    vtkIdType numpts = structure->GetNumberOfPoints();
-    vtkstd::vector<data_type> g(3*NumberOfInputComponents);
-
-    int NumberOfOutputComponents = 3*NumberOfInputComponents;
-    if(ComputeVorticity)
+    if (structure->GetNumberOfCells() < 1 ||
+        !(structure->IsA("vtkUnstructuredGrid") ||
+          structure->IsA("vtkPolyData")))
       {
-      NumberOfOutputComponents = 3;
+      return 0;
       }
-
-    for (vtkIdType point = 0; point < numpts; point++)
+    vtkGenericCell *cell = vtkGenericCell::New();
+    structure->GetCell(0, cell);
+    cell->Delete();
+    if (needLinks && structure->GetNumberOfPoints() > 0)
       {
-      currentPoint->SetId(0, point);
-      double pointcoords[3];
-      structure->GetPoint(point, pointcoords);
-      // Get all cells touching this point.
-      structure->GetCellNeighbors(-1, currentPoint, cellsOnPoint);
-      vtkIdType numCellNeighbors = cellsOnPoint->GetNumberOfIds();
-      vtkIdType numValidCellNeighbors = 0;
-
-      for(int i=0;i<NumberOfInputComponents*3;i++)
+      vtkIdList *cellIds = vtkIdList::New();
+      structure->GetPointCells(0, cellIds);
+      cellIds->Delete();
+      }
+    return 1;
+  }
+
+//-----------------------------------------------------------------------------
+  template<class data_type>
+  class PointGradientsUGFunctor
+  {
+  public:
+    vtkDataSet *Structure;
+    data_type *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    int ComputeVorticity;
+
+    vtkSMPThreadLocal<vtkSmartPointer<vtkGenericCell> > Cell;
+    vtkSMPThreadLocal<vtkSmartPointer<vtkIdList> > CurrentPoint;
+    vtkSMPThreadLocal<vtkSmartPointer<vtkIdList> > CellsOnPoint;
+
+    void Initialize()
+    {
+      this->Cell.Local() = vtkSmartPointer<vtkGenericCell>::New();
+      this->CurrentPoint.Local() = vtkSmartPointer<vtkIdList>::New();
+      this->CurrentPoint.Local()->SetNumberOfIds(1);
+      this->CellsOnPoint.Local() = vtkSmartPointer<vtkIdList>::New();
+    }
+
+    void Reduce()
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkDataSet *structure = this->Structure;
+      int NumberOfInputComponents = this->NumberOfInputComponents;
+      vtkGenericCell *cell = this->Cell.Local();
+      vtkIdList* currentPoint = this->CurrentPoint.Local();
+      vtkIdList* cellsOnPoint = this->CellsOnPoint.Local();
+      vtkstd::vector<data_type> g(3*NumberOfInputComponents);
+
+      int NumberOfOutputComponents = 3*NumberOfInputComponents;
+      if(this->ComputeVorticity)
         {
-        g[i] = 0;
+        NumberOfOutputComponents = 3;
         }
-      
-      // Iterate on all cells and find all points connected to current point
-      // by an edge.
-      for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+
+      for (vtkIdType point = begin; point < end; point++)
         {
-        vtkCell *cell = structure->GetCell(cellsOnPoint->GetId(neighbor));
-        int subId;
-        double parametricCoord[3];
-        if(GetCellParametricData(point, pointcoords, cell, 
-                                 subId, parametricCoord))
+        currentPoint->SetId(0, point);
+        double pointcoords[3];
+        structure->GetPoint(point, pointcoords);
+        // Get all cells touching this point.
+        structure->GetCellNeighbors(-1, currentPoint, cellsOnPoint);
+        vtkIdType numCellNeighbors = cellsOnPoint->GetNumberOfIds();
+        vtkIdType numValidCellNeighbors = 0;
+
+        for(int i=0;i<NumberOfInputComponents*3;i++)
+          {
+          g[i] = 0;
+          }
+
+        // Iterate on all cells and find all points connected to current point
+        // by an edge.
+        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
           {
-          numValidCellNeighbors++;
-          for(int InputComponent=0;InputComponent<NumberOfInputComponents;InputComponent++)
+          structure->GetCell(cellsOnPoint->GetId(neighbor), cell);
+          int subId;
+          double parametricCoord[3];
+          if(GetCellParametricData(point, pointcoords, cell, 
+                                   subId, parametricCoord))
             {
-            int NumberOfCellPoints = cell->GetNumberOfPoints();
-            vtkstd::vector<double> values(NumberOfCellPoints);
-            // Get values of Array at cell points.
-            for (int i = 0; i < NumberOfCellPoints; i++)
+            numValidCellNeighbors++;
+            for(int InputComponent=0;InputComponent<NumberOfInputComponents;InputComponent++)
               {
-              values[i] = static_cast<double>(
-                Array[cell->GetPointId(i)*NumberOfInputComponents+InputComponent]);
-              }
-            
-            double derivative[3];
-            // Get derivitive of cell at point.
-            cell->Derivatives(subId, parametricCoord, &values[0], 1, derivative);
-            
-            g[InputComponent*3] += static_cast<data_type>(derivative[0]);
-            g[InputComponent*3+1] += static_cast<data_type>(derivative[1]);
-            g[InputComponent*3+2] += static_cast<data_type>(derivative[2]);
-            } // iterating over Components
-          } // if(GetCellParametricData())
-        } // iterating over neighbors
-
-      if (numCellNeighbors > 0)
-        {
-        for(int i=0;i<3*NumberOfInputComponents;i++)
+              int NumberOfCellPoints = cell->GetNumberOfPoints();
+              vtkstd::vector<double> values(NumberOfCellPoints);
+              // Get values of Array at cell points.
+              for (int i = 0; i < NumberOfCellPoints; i++)
+                {
+                values[i] = static_cast<double>(
+                  this->Array[cell->GetPointId(i)*NumberOfInputComponents+InputComponent]);
+                }
+
+              double derivative[3];
+              // Get derivitive of cell at point.
+              cell->Derivatives(subId, parametricCoord, &values[0], 1, derivative);
+
+              g[InputComponent*3] += static_cast<data_type>(derivative[0]);
+              g[InputComponent*3+1] += static_cast<data_type>(derivative[1]);
+              g[InputComponent*3+2] += static_cast<data_type>(derivative[2]);
+              } // iterating over Components
+            } // if(GetCellParametricData())
+          } // iterating over neighbors
+
+        if (numCellNeighbors > 0)
           {
-          g[i] /= numCellNeighbors;
+          for(int i=0;i<3*NumberOfInputComponents;i++)
+            {
+            g[i] /= numCellNeighbors;
+            }
           }
-        }
 
-      if(ComputeVorticity)
-        {
-        ReplaceGradientWithVorticity(&g[0]);
-        }
-      for(int i=0;i<NumberOfOutputComponents;i++)
-        {
-        gradients[point*NumberOfOutputComponents+i] = g[i];
-        }
-      }  // iterating over points in grid
-    
-    currentPoint->Delete();
-    cellsOnPoint->Delete();
+        if(this->ComputeVorticity)
+          {
+          ReplaceGradientWithVorticity(&g[0]);
+          }
+        for(int i=0;i<NumberOfOutputComponents;i++)
+          {
+          this->Gradients[point*NumberOfOutputComponents+i] = g[i];
+          }
+        }  // iterating over points in grid
+    }
+  };
+
+  template<class data_type>
+  void ComputePointGradientsUG(
+    vtkDataSet *structure, data_type *Array,
+    data_type *gradients, int NumberOfInputComponents, int ComputeVorticity)
+  {
+    vtkIdType numpts = structure->GetNumberOfPoints();
+    PointGradientsUGFunctor<data_type> functor;
+    functor.Structure = structure;
+    functor.Array = Array;
+    functor.Gradients = gradients;
+    functor.NumberOfInputComponents = NumberOfInputComponents;
+    functor.ComputeVorticity = ComputeVorticity;
+    int parallel = PrepareCellQueries(structure, 1);
+    vtkSMPTools::Reduce(0, numpts, parallel ? 0 : numpts, functor);
   }
   
 //-----------------------------------------------------------------------------
@@ -615,96 +684,152 @@ namespace {
 
 //-----------------------------------------------------------------------------
   template<class data_type>
-    void ComputeCellGradientsUG(
-      vtkDataSet *structure, data_type *Array, data_type *gradients,
-      int NumberOfInputComponents, int ComputeVorticity)
+  class CellGradientsUGFunctor
   {
-    vtkIdType numcells = structure->GetNumberOfCells();
-    int NumberOfOutputComponents = 3*NumberOfInputComponents;
-    if(ComputeVorticity)
-      {
-      NumberOfOutputComponents = 3;
-      }
-    vtkstd::vector<data_type> g(3*NumberOfInputComponents);
+  public:
+    vtkDataSet *Structure;
+    data_type *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    int ComputeVorticity;
 
-    for (vtkIdType cellid = 0; cellid < numcells; cellid++)
-      {
-      vtkCell *cell = structure->GetCell(cellid);
-      
-      int subId;
-      double cellCenter[3];
-      subId = cell->GetParametricCenter(cellCenter);
-      
-      int numpoints = cell->GetNumberOfPoints();
-      double derivative[3];
-      vtkstd::vector<double> values(numpoints);
-      for(int InputComponent=0;InputComponent<NumberOfInputComponents;
-          InputComponent++)
-        {
-        for (int i = 0; i < numpoints; i++)
-          {
-          values[i] = static_cast<double>(
-            Array[cell->GetPointId(i)*NumberOfInputComponents+InputComponent]);
-          }
-      
-        cell->Derivatives(subId, cellCenter, &values[0], 1, derivative);
-        g[InputComponent*3+0] = static_cast<data_type>(derivative[0]);
-        g[InputComponent*3+1] = static_cast<data_type>(derivative[1]);
-        g[InputComponent*3+2] = static_cast<data_type>(derivative[2]);
-        }
-      if(ComputeVorticity)
+    vtkSMPThreadLocal<vtkSmartPointer<vtkGenericCell> > Cell;
+
+    void Initialize()
+    {
+      this->Cell.Local() = vtkSmartPointer<vtkGenericCell>::New();
+    }
+
+    void Reduce()
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      int NumberOfInputComponents = this->NumberOfInputComponents;
+      int NumberOfOutputComponents = 3*NumberOfInputComponents;
+      if(this->ComputeVorticity)
         {
-        ReplaceGradientWithVorticity(&g[0]);
+        NumberOfOutputComponents = 3;
         }
-      for(int i=0;i<NumberOfOutputComponents;i++)
+      vtkstd::vector<data_type> g(3*NumberOfInputComponents);
+      vtkGenericCell *cell = this->Cell.Local();
+
+      for (vtkIdType cellid = begin; cellid < end; cellid++)
         {
-        gradients[cellid*NumberOfOutputComponents+i] = g[i];
+        this->Structure->GetCell(cellid, cell);
+
+        int subId;
+        double cellCenter[3];
+        subId = cell->GetParametricCenter(cellCenter);
+
+        int numpoints = cell->GetNumberOfPoints();
+        double derivative[3];
+        vtkstd::vector<double> values(numpoints);
+        for(int InputComponent=0;InputComponent<NumberOfInputComponents;
+            InputComponent++)
+          {
+          for (int i = 0; i < numpoints; i++)
+            {
+            values[i] = static_cast<double>(
+              this->Array[cell->GetPointId(i)*NumberOfInputComponents+InputComponent]);
+            }
+
+          cell->Derivatives(subId, cellCenter, &values[0], 1, derivative);
+          g[InputComponent*3+0] = static_cast<data_type>(derivative[0]);
+          g[InputComponent*3+1] = static_cast<data_type>(derivative[1]);
+          g[InputComponent*3+2] = static_cast<data_type>(derivative[2]);
+          }
+        if(this->ComputeVorticity)
+          {
+          ReplaceGradientWithVorticity(&g[0]);
+          }
+        for(int i=0;i<NumberOfOutputComponents;i++)
+          {
+          this->Gradients[cellid*NumberOfOutputComponents+i] = g[i];
+          }
         }
-      }
+    }
+  };
+
+  template<class data_type>
+    void ComputeCellGradientsUG(
+      vtkDataSet *structure, data_type *Array, data_type *gradients,
+      int NumberOfInputComponents, int ComputeVorticity)
+  {
+    vtkIdType numcells = structure->GetNumberOfCells();
+    CellGradientsUGFunctor<data_type> functor;
+    functor.Structure = structure;
+    functor.Array = Array;
+    functor.Gradients = gradients;
+    functor.NumberOfInputComponents = NumberOfInputComponents;
+    functor.ComputeVorticity = ComputeVorticity;
+    int parallel = PrepareCellQueries(structure, 0);
+    vtkSMPTools::Reduce(0, numcells, parallel ? 0 : numcells, functor);
   }
 
 //-----------------------------------------------------------------------------
+  // Computes the gradients of a range of grid rows, each row being all i
+  // for one (j, k).
   template<class Grid, class data_type>
-  void ComputeGradientsSG(Grid output, data_type* Array, data_type* gradients,
-                          int NumberOfInputComponents, int fieldAssociation,
-                          int ComputeVorticity)
+  class GradientsSGFunctor
   {
-    int i, j, k, idx, idx2, ii, InputComponent;
-    double xp[3], xm[3], factor;
-    double xxi, yxi, zxi, xeta, yeta, zeta, xzeta, yzeta, zzeta;
-    double aj, xix, xiy, xiz, etax, etay, etaz, zetax, zetay, zetaz;
-    // for finite differencing -- the values on the "plus" side and
-    // "minus" side of the point to be computed at
-    vtkstd::vector<double> plusvalues(NumberOfInputComponents);
-    vtkstd::vector<double> minusvalues(NumberOfInputComponents);
-
-    vtkstd::vector<double> dValuesdXi(NumberOfInputComponents);
-    vtkstd::vector<double> dValuesdEta(NumberOfInputComponents);
-    vtkstd::vector<double> dValuesdZeta(NumberOfInputComponents);
-
-    int NumberOfOutputComponents = 3*NumberOfInputComponents;
-    if(ComputeVorticity)
-      {
-      NumberOfOutputComponents = 3;
-      }
-    vtkstd::vector<data_type> g(3*NumberOfInputComponents);
+  public:
+    Grid Output;
+    data_type* Array;
+    data_type* Gradients;
+    int NumberOfInputComponents;
+    int FieldAssociation;
+    int ComputeVorticity;
+    int Dims[3];
+
+    vtkSMPThreadLocal<vtkSmartPointer<vtkGenericCell> > Cell;
+
+    void Initialize()
+    {
+      this->Cell.Local() = vtkSmartPointer<vtkGenericCell>::New();
+    }
 
-    int dims[3];
-    output->GetDimensions(dims);
-    if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
-      {
-      // reduce the dimensions by 1 for cells
-      for(i=0;i<3;i++)
+    void Reduce()
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      Grid output = this->Output;
+      data_type* Array = this->Array;
+      data_type* gradients = this->Gradients;
+      int NumberOfInputComponents = this->NumberOfInputComponents;
+      int fieldAssociation = this->FieldAssociation;
+      const int* dims = this->Dims;
+      vtkGenericCell* cell = this->Cell.Local();
+
+      int i, j, k, idx, idx2, ii, InputComponent;
+      double xp[3], xm[3], factor;
+      double xxi, yxi, zxi, xeta, yeta, zeta, xzeta, yzeta, zzeta;
+      double aj, xix, xiy, xiz, etax, etay, etaz, zetax, zetay, zetaz;
+      // for finite differencing -- the values on the "plus" side and
+      // "minus" side of the point to be computed at
+      vtkstd::vector<double> plusvalues(NumberOfInputComponents);
+      vtkstd::vector<double> minusvalues(NumberOfInputComponents);
+
+      vtkstd::vector<double> dValuesdXi(NumberOfInputComponents);
+      vtkstd::vector<double> dValuesdEta(NumberOfInputComponents);
+      vtkstd::vector<double> dValuesdZeta(NumberOfInputComponents);
+
+      int NumberOfOutputComponents = 3*NumberOfInputComponents;
+      if(this->ComputeVorticity)
         {
-        dims[i]--;
+        NumberOfOutputComponents = 3;
         }
-      }
-    int ijsize = dims[0]*dims[1];
-    
-    for (k=0; k<dims[2]; k++) 
-      {
-      for (j=0; j<dims[1]; j++) 
+      vtkstd::vector<data_type> g(3*NumberOfInputComponents);
+
+      int ijsize = dims[0]*dims[1];
+
+      for (vtkIdType row = begin; row < end; row++)
         {
+        j = static_cast<int>(row % dims[1]);
+        k = static_cast<int>(row / dims[1]);
         for (i=0; i<dims[0]; i++) 
           {
           //  Xi derivatives.
@@ -727,8 +852,8 @@ namespace {
             factor = 1.0;
             idx = (i+1) + j*dims[0] + k*ijsize;
             idx2 = i + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            GetGridEntityCoordinate(output, fieldAssociation, idx, xp, cell);
+            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm, cell);
             for(InputComponent=0;InputComponent<NumberOfInputComponents;
                 InputComponent++)
               {
@@ -741,8 +866,8 @@ namespace {
             factor = 1.0;
             idx = i + j*dims[0] + k*ijsize;
             idx2 = i-1 + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            GetGridEntityCoordinate(output, fieldAssociation, idx, xp, cell);
+            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm, cell);
             for(InputComponent=0;InputComponent<NumberOfInputComponents;
                 InputComponent++)
               {
@@ -755,8 +880,8 @@ namespace {
             factor = 0.5;
             idx = (i+1) + j*dims[0] + k*ijsize;
             idx2 = (i-1) + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            GetGridEntityCoordinate(output, fieldAssociation, idx, xp, cell);
+            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm, cell);
             for(InputComponent=0;InputComponent<NumberOfInputComponents;
                 InputComponent++)
               {
@@ -794,8 +919,8 @@ namespace {
             factor = 1.0;
             idx = i + (j+1)*dims[0] + k*ijsize;
             idx2 = i + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            GetGridEntityCoordinate(output, fieldAssociation, idx, xp, cell);
+            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm, cell);
             for(InputComponent=0;InputComponent<NumberOfInputComponents;
                 InputComponent++)
               {
@@ -808,8 +933,8 @@ namespace {
             factor = 1.0;
             idx = i + j*dims[0] + k*ijsize;
             idx2 = i + (j-1)*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            GetGridEntityCoordinate(output, fieldAssociation, idx, xp, cell);
+            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm, cell);
             for(InputComponent=0;InputComponent<NumberOfInputComponents;
                 InputComponent++)
               {
@@ -822,8 +947,8 @@ namespace {
             factor = 0.5;
             idx = i + (j+1)*dims[0] + k*ijsize;
             idx2 = i + (j-1)*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            GetGridEntityCoordinate(output, fieldAssociation, idx, xp, cell);
+            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm, cell);
             for(InputComponent=0;InputComponent<NumberOfInputComponents;
                 InputComponent++)
               {
@@ -861,8 +986,8 @@ namespace {
             factor = 1.0;
             idx = i + j*dims[0] + (k+1)*ijsize;
             idx2 = i + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            GetGridEntityCoordinate(output, fieldAssociation, idx, xp, cell);
+            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm, cell);
             for(InputComponent=0;InputComponent<NumberOfInputComponents;
                 InputComponent++)
               {
@@ -875,8 +1000,8 @@ namespace {
             factor = 1.0;
             idx = i + j*dims[0] + k*ijsize;
             idx2 = i + j*dims[0] + (k-1)*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            GetGridEntityCoordinate(output, fieldAssociation, idx, xp, cell);
+            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm, cell);
             for(InputComponent=0;InputComponent<NumberOfInputComponents;
                 InputComponent++)
               {
@@ -889,8 +1014,8 @@ namespace {
             factor = 0.5;
             idx = i + j*dims[0] + (k+1)*ijsize;
             idx2 = i + j*dims[0] + (k-1)*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            GetGridEntityCoordinate(output, fieldAssociation, idx, xp, cell);
+            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm, cell);
             for(InputComponent=0;InputComponent<NumberOfInputComponents;
                 InputComponent++)
               {
@@ -953,7 +1078,7 @@ namespace {
               zetaz*dValuesdZeta[InputComponent]);
             }
 
-          if(ComputeVorticity)
+          if(this->ComputeVorticity)
             {
             ReplaceGradientWithVorticity(&g[0]);
             }
@@ -963,7 +1088,38 @@ namespace {
             }  
           }
         }
-      } 
+    }
+  };
+
+  template<class Grid, class data_type>
+  void ComputeGradientsSG(Grid output, data_type* Array, data_type* gradients,
+                          int NumberOfInputComponents, int fieldAssociation,
+                          int ComputeVorticity)
+  {
+    GradientsSGFunctor<Grid, data_type> functor;
+    functor.Output = output;
+    functor.Array = Array;
+    functor.Gradients = gradients;
+    functor.NumberOfInputComponents = NumberOfInputComponents;
+    functor.FieldAssociation = fieldAssociation;
+    functor.ComputeVorticity = ComputeVorticity;
+
+    int* dims = functor.Dims;
+    output->GetDimensions(dims);
+    if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
+      {
+      // reduce the dimensions by 1 for cells
+      for(int i=0;i<3;i++)
+        {
+        dims[i]--;
+        }
+      }
+    if (dims[0] < 1 || dims[1] < 1 || dims[2] < 1)
+      {
+      return;
+      }
+
+    vtkSMPTools::Reduce(0, static_cast<vtkIdType>(dims[1])*dims[2], functor);
   }
 
 } // end anonymous namespace
@@ -29,6 +29,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkShortArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
@@ -38,6 +39,8 @@
 #include "vtkUnsignedLongArray.h"
 #include "vtkUnsignedShortArray.h"
 
+#include <vtkstd/vector>
+
 #include <math.h>
 
 vtkStandardNewMacro(vtkGridSynchronizedTemplates3D);
@@ -61,6 +64,8 @@ vtkGridSynchronizedTemplates3D::vtkGridSynchronizedTemplates3D()
   this->MinimumPieceSize[1] = 10;
   this->MinimumPieceSize[2] = 10;
 
+  this->ParallelExecution = 1;
+
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
                                vtkDataSetAttributes::SCALARS);
@@ -334,12 +339,34 @@ if (ComputeScalars) \
   newScalars->InsertNextTuple(&value); \
 } 
 
+//----------------------------------------------------------------------------
+// When contouring in parallel, the execute extent is cut into slabs along z
+// and every contour value of every slab is contoured into its own output.
+// A slab also runs the templates over the plane below it, without creating
+// triangles, so that it knows the edge intersections of that plane.  The
+// points created there are "ghost" points; they are replaced by the points
+// of the slab below when the pieces are merged.
+struct vtkGridSynchronizedTemplates3DPiece
+{
+  int ValueIndex;
+  int ZMin;
+  int ZMax;
+  vtkPolyData *Output;
+  // Number of ghost points, these are the first points of the output.
+  vtkIdType NumberOfGhostPoints;
+  // Edge intersection ids of the ghost plane and of the last plane.
+  vtkstd::vector<int> GhostPlane;
+  vtkstd::vector<int> LastPlane;
+};
+
 //----------------------------------------------------------------------------
 // Contouring filter specialized for structured grids
 template <class T, class PointsType>
 void ContourGrid(vtkGridSynchronizedTemplates3D *self,
                  int *exExt, T *scalars,
-                 vtkStructuredGrid *input, vtkPolyData *output, PointsType*, vtkDataArray *inScalars)
+                 vtkStructuredGrid *input, vtkPolyData *output, PointsType*,
+                 vtkDataArray *inScalars,
+                 vtkGridSynchronizedTemplates3DPiece *piece)
 {
   int *inExt = input->GetExtent();
   int xdim = exExt[1] - exExt[0] + 1;
@@ -351,7 +378,8 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
   PointsType *p0, *p1, *p2, *p3;
   T *inPtrX, *inPtrY, *inPtrZ;
   T *s0, *s1, *s2, *s3;
-  int XMin, XMax, YMin, YMax, ZMin, ZMax;
+  int XMin, XMax, YMin, YMax, ZMin, ZMax, KMax;
+  int vidxMin, vidxMax;
   int incY, incZ;
   PointsType* points =
     static_cast<PointsType*>(input->GetPoints()->GetData()->GetVoidPointer(0));
@@ -399,7 +427,20 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
     {
     newGradients = vtkFloatArray::New();
     }
-  vtkGridSynchronizedTemplates3DInitializeOutput(exExt, input, output, 
+  // Size the output of a piece for its own slab.
+  int pieceExt[6];
+  int *estimateExt = exExt;
+  if (piece)
+    {
+    for (i = 0; i < 4; i++)
+      {
+      pieceExt[i] = exExt[i];
+      }
+    pieceExt[4] = piece->ZMin;
+    pieceExt[5] = piece->ZMax;
+    estimateExt = pieceExt;
+    }
+  vtkGridSynchronizedTemplates3DInitializeOutput(estimateExt, input, output, 
                                                  newScalars, newNormals, newGradients, inScalars);
   newPts = output->GetPoints();
   newPolys = output->GetPolys();
@@ -411,6 +452,18 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
   YMax = exExt[3];
   ZMin = exExt[4];
   ZMax = exExt[5];
+  // A piece only walks its own slab (and the ghost plane below it) for a
+  // single contour value.
+  KMax = ZMax;
+  vidxMin = 0;
+  vidxMax = numContours;
+  if (piece)
+    {
+    ZMin = (piece->ZMin > exExt[4] ? piece->ZMin - 1 : piece->ZMin);
+    KMax = piece->ZMax;
+    vidxMin = piece->ValueIndex;
+    vidxMax = piece->ValueIndex + 1;
+    }
   // to skip over an x row of the input.
   incY = inExt[1]-inExt[0]+1;
   // to skip over an xy slice of the input.
@@ -452,7 +505,7 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
   //      exExt[0], exExt[1], exExt[2], exExt[3], exExt[4], exExt[5]);
 
   // for each contour
-  for (vidx = 0; vidx < numContours; vidx++)
+  for (vidx = vidxMin; vidx < vidxMax; vidx++)
     {
     value = values[vidx];
     //  skip any slices which are overlap for computing gradients.
@@ -466,7 +519,7 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
     v2 = (*s2 < value ? 0 : 1);
 
     //==================================================================
-    for (k = ZMin; k <= ZMax; k++)
+    for (k = ZMin; k <= KMax; k++)
       {
       // swap the buffers
       if (k%2)
@@ -707,6 +760,20 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
         }
       inPtPtrZ += 3*incZ;
       inPtrZ += incZ;
+
+      // Remember the intersections of the ghost plane and of the last
+      // plane for merging.
+      if (piece && (k == KMax || (k == ZMin && ZMin < piece->ZMin)))
+        {
+        isect2Ptr = isect1 + ((k%2) ? xdim*ydim*3 : 0);
+        vtkstd::vector<int>& plane =
+          (k == KMax ? piece->LastPlane : piece->GhostPlane);
+        plane.assign(isect2Ptr, isect2Ptr + xdim*ydim*3);
+        if (k < KMax)
+          {
+          piece->NumberOfGhostPoints = newPts->GetNumberOfPoints();
+          }
+        }
       }
     }
 
@@ -737,15 +804,233 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
 template <class T>
 void ContourGrid(vtkGridSynchronizedTemplates3D *self,
                  int *exExt, T *scalars, vtkStructuredGrid *input,
-                 vtkPolyData *output, vtkDataArray *inScalars)
+                 vtkPolyData *output, vtkDataArray *inScalars,
+                 vtkGridSynchronizedTemplates3DPiece *piece)
 {
   switch(input->GetPoints()->GetData()->GetDataType())
     {
     vtkTemplateMacro(
-                     ContourGrid(self, exExt, scalars, input, output,static_cast<VTK_TT *>(0), inScalars));
+                     ContourGrid(self, exExt, scalars, input, output,static_cast<VTK_TT *>(0), inScalars, piece));
     }
 }
 
+//----------------------------------------------------------------------------
+// Contour the pieces in parallel.
+class vtkGridSynchronizedTemplates3DFunctor
+{
+public:
+  vtkGridSynchronizedTemplates3D *Filter;
+  int *ExecuteExtent;
+  void *Scalars;
+  int ScalarType;
+  vtkStructuredGrid *Input;
+  vtkDataArray *InScalars;
+  vtkstd::vector<vtkGridSynchronizedTemplates3DPiece> *Pieces;
+  vtkMultiThreaderIDType MainThread;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    if (this->Filter->GetAbortExecute())
+      {
+      return;
+      }
+    if (vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(),
+                                       this->MainThread))
+      {
+      this->Filter->UpdateProgress(
+        static_cast<double>(begin) / this->Pieces->size());
+      }
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkGridSynchronizedTemplates3DPiece *piece = &(*this->Pieces)[i];
+      piece->Output = vtkPolyData::New();
+      switch (this->ScalarType)
+        {
+        vtkTemplateMacro(
+          ContourGrid(this->Filter, this->ExecuteExtent,
+                      static_cast<VTK_TT *>(this->Scalars), this->Input,
+                      piece->Output, this->InScalars, piece));
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Append the pieces to the output in the order the serial templates create
+// points and triangles: contour value by contour value, slab by slab.  The
+// ghost points of a slab are mapped through the edge intersections of the
+// last plane of the slab below, which have already been merged.  Since the
+// ghost plane cannot look at the plane below it, two of its points may
+// stand for one point of the slab below; triangles that become degenerate
+// that way are dropped, as the serial templates never create them.
+static void vtkGridSynchronizedTemplates3DMergePieces(
+  vtkstd::vector<vtkGridSynchronizedTemplates3DPiece>& pieces,
+  int numberOfSlabs, vtkPolyData *output)
+{
+  vtkPoints *newPts = output->GetPoints();
+  vtkCellArray *newPolys = output->GetPolys();
+  vtkPointData *outPD = output->GetPointData();
+  vtkCellData *outCD = output->GetCellData();
+  vtkstd::vector<vtkIdType> pointMap;
+  vtkIdType npts, *pts, ptIds[3];
+  size_t i, j;
+
+  for (i = 0; i < pieces.size(); ++i)
+    {
+    vtkGridSynchronizedTemplates3DPiece& piece = pieces[i];
+    vtkPolyData *pieceOutput = piece.Output;
+    if (!pieceOutput)
+      {
+      // Aborted, the pieces after this one may need its points.
+      break;
+      }
+    vtkIdType numPts = pieceOutput->GetNumberOfPoints();
+    vtkIdType numGhostPts = piece.NumberOfGhostPoints;
+    vtkPointData *pd = pieceOutput->GetPointData();
+    pointMap.resize(numPts);
+
+    if (numGhostPts > 0)
+      {
+      vtkGridSynchronizedTemplates3DPiece& below = pieces[i-1];
+      for (j = 0; j < piece.GhostPlane.size(); ++j)
+        {
+        if (piece.GhostPlane[j] > -1)
+          {
+          pointMap[piece.GhostPlane[j]] = below.LastPlane[j];
+          }
+        }
+      }
+    vtkIdType offset = newPts->GetNumberOfPoints();
+    for (vtkIdType ptId = numGhostPts; ptId < numPts; ++ptId)
+      {
+      pointMap[ptId] = offset + ptId - numGhostPts;
+      newPts->InsertNextPoint(pieceOutput->GetPoint(ptId));
+      outPD->CopyData(pd, ptId, pointMap[ptId]);
+      }
+
+    vtkCellArray *polys = pieceOutput->GetPolys();
+    vtkCellData *cd = pieceOutput->GetCellData();
+    vtkIdType cellId = 0;
+    for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ++cellId)
+      {
+      ptIds[0] = pointMap[pts[0]];
+      ptIds[1] = pointMap[pts[1]];
+      ptIds[2] = pointMap[pts[2]];
+      if (ptIds[0] != ptIds[1] &&
+          ptIds[0] != ptIds[2] &&
+          ptIds[1] != ptIds[2])
+        {
+        outCD->CopyData(cd, cellId, newPolys->InsertNextCell(3,ptIds));
+        }
+      }
+
+    // The slab above maps its ghost points through these.
+    if (static_cast<int>(i % numberOfSlabs) < numberOfSlabs - 1)
+      {
+      for (j = 0; j < piece.LastPlane.size(); ++j)
+        {
+        if (piece.LastPlane[j] > -1)
+          {
+          piece.LastPlane[j] = static_cast<int>(pointMap[piece.LastPlane[j]]);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Contour the execute extent as slabs of this many z planes in parallel.
+#define VTK_GRID_SYNCHRONIZED_TEMPLATES_3D_SLAB 8
+
+static int vtkGridSynchronizedTemplates3DParallelContour(
+  vtkGridSynchronizedTemplates3D *self, int *exExt, void *scalars,
+  int scalarType, vtkStructuredGrid *input, vtkPolyData *output,
+  vtkDataArray *inScalars)
+{
+  int numContours = self->GetNumberOfContours();
+  int numberOfSlabs = (exExt[5] - exExt[4] + 1) /
+    VTK_GRID_SYNCHRONIZED_TEMPLATES_3D_SLAB;
+  if (numberOfSlabs < 1)
+    {
+    numberOfSlabs = 1;
+    }
+  if (numContours < 1 || numberOfSlabs*numContours < 2)
+    {
+    return 0;
+    }
+
+  vtkstd::vector<vtkGridSynchronizedTemplates3DPiece> pieces(
+    numContours*numberOfSlabs);
+  int numPlanes = exExt[5] - exExt[4] + 1;
+  int vidx, slab;
+  size_t i;
+  for (vidx = 0; vidx < numContours; vidx++)
+    {
+    for (slab = 0; slab < numberOfSlabs; slab++)
+      {
+      vtkGridSynchronizedTemplates3DPiece& piece =
+        pieces[vidx*numberOfSlabs + slab];
+      piece.ValueIndex = vidx;
+      piece.ZMin = exExt[4] + slab*numPlanes/numberOfSlabs;
+      piece.ZMax = exExt[4] + (slab + 1)*numPlanes/numberOfSlabs - 1;
+      piece.Output = NULL;
+      piece.NumberOfGhostPoints = 0;
+      }
+    }
+
+  // IsCellVisible() updates the dimensions of the grid.
+  input->GetDimensions();
+
+  vtkGridSynchronizedTemplates3DFunctor functor;
+  functor.Filter = self;
+  functor.ExecuteExtent = exExt;
+  functor.Scalars = scalars;
+  functor.ScalarType = scalarType;
+  functor.Input = input;
+  functor.InScalars = inScalars;
+  functor.Pieces = &pieces;
+  functor.MainThread = vtkMultiThreader::GetCurrentThreadID();
+  vtkSMPTools::For(0, static_cast<vtkIdType>(pieces.size()), 1, functor);
+
+  // Allocate the output for exactly what the pieces produced.
+  vtkIdType numPts = 0;
+  vtkIdType numPolys = 0;
+  for (i = 0; i < pieces.size() && pieces[i].Output; ++i)
+    {
+    numPts += pieces[i].Output->GetNumberOfPoints() -
+      pieces[i].NumberOfGhostPoints;
+    numPolys += pieces[i].Output->GetNumberOfPolys();
+    }
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->Allocate(numPts > 0 ? numPts : 1);
+  output->SetPoints(newPts);
+  newPts->Delete();
+  vtkCellArray *newPolys = vtkCellArray::New();
+  newPolys->Allocate(newPolys->EstimateSize(numPolys > 0 ? numPolys : 1,3));
+  output->SetPolys(newPolys);
+  newPolys->Delete();
+  if (pieces[0].Output)
+    {
+    output->GetPointData()->CopyAllOn();
+    output->GetPointData()->CopyAllocate(pieces[0].Output->GetPointData(),
+                                         numPts);
+    output->GetCellData()->CopyAllOn();
+    output->GetCellData()->CopyAllocate(pieces[0].Output->GetCellData(),
+                                        numPolys);
+    }
+
+  vtkGridSynchronizedTemplates3DMergePieces(pieces, numberOfSlabs, output);
+
+  for (i = 0; i < pieces.size(); ++i)
+    {
+    if (pieces[i].Output)
+      {
+      pieces[i].Output->Delete();
+      }
+    }
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // Contouring filter specialized for images (or slices from images)
 void vtkGridSynchronizedTemplates3D::ThreadedExecute(int *exExt, int ,
@@ -781,23 +1066,38 @@ void vtkGridSynchronizedTemplates3D::ThreadedExecute(int *exExt, int ,
   //
   // Check data type and execute appropriate function
   //
+  void *scalars;
+  int scalarType;
+  vtkDoubleArray *image = NULL;
   if (inScalars->GetNumberOfComponents() == 1 )
     {
-    void *scalars = inScalars->GetVoidPointer(0);
-    switch (inScalars->GetDataType())
-      {
-      vtkTemplateMacro(
-                       ContourGrid(this, exExt, static_cast<VTK_TT *>(scalars), input, output, inScalars));
-      }//switch
+    scalars = inScalars->GetVoidPointer(0);
+    scalarType = inScalars->GetDataType();
     }
   else //multiple components - have to convert
     {
-    vtkDoubleArray *image = vtkDoubleArray::New();
+    image = vtkDoubleArray::New();
     image->SetNumberOfComponents(inScalars->GetNumberOfComponents());
     image->Allocate(dataSize*image->GetNumberOfComponents());
     inScalars->GetTuples(0,dataSize,image);
-    double *scalars = image->GetPointer(0);
-    ContourGrid(this, exExt, scalars, input, output, inScalars);
+    scalars = image->GetPointer(0);
+    scalarType = VTK_DOUBLE;
+    }
+
+  if (!this->ParallelExecution ||
+      !vtkGridSynchronizedTemplates3DParallelContour(this, exExt, scalars,
+                                                     scalarType, input,
+                                                     output, inScalars))
+    {
+    switch (scalarType)
+      {
+      vtkTemplateMacro(
+                       ContourGrid(this, exExt, static_cast<VTK_TT *>(scalars), input, output, inScalars, NULL));
+      }//switch
+    }
+
+  if (image)
+    {
     image->Delete();
     }
 
@@ -928,6 +1228,7 @@ void vtkGridSynchronizedTemplates3D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Compute Normals: " << (this->ComputeNormals ? "On\n" : "Off\n");
   os << indent << "Compute Gradients: " << (this->ComputeGradients ? "On\n" : "Off\n");
   os << indent << "Compute Scalars: " << (this->ComputeScalars ? "On\n" : "Off\n");
+  os << indent << "Parallel Execution: " << (this->ParallelExecution ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
@@ -22,7 +22,7 @@
 // This filter is specialized to 3D grids.
 
 // .SECTION See Also
-// vtkContourFilter vtkSynchronizedTemplates3D
+// vtkContourFilter vtkSynchronizedTemplates3D vtkSMPTools
 
 #ifndef __vtkGridSynchronizedTemplates3D_h
 #define __vtkGridSynchronizedTemplates3D_h
@@ -70,6 +70,15 @@ public:
   vtkGetMacro(ComputeScalars,int);
   vtkBooleanMacro(ComputeScalars,int);
 
+  // Description:
+  // When on (the default), the execute extent is cut into slabs along z
+  // and the slabs are contoured on several threads with vtkSMPTools. The
+  // slabs are merged so that the output is the same as with a single
+  // thread.
+  vtkSetMacro(ParallelExecution,int);
+  vtkGetMacro(ParallelExecution,int);
+  vtkBooleanMacro(ParallelExecution,int);
+
   // Description:
   // Set a particular contour value at contour number i. The index i ranges 
   // between 0<=i<NumberOfContours.
@@ -138,6 +147,7 @@ protected:
   int ComputeNormals;
   int ComputeGradients;
   int ComputeScalars;
+  int ParallelExecution;
   vtkContourValues *ContourValues;
 
   int MinimumPieceSize[3];
@@ -20,15 +20,100 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
 
+#include <vtkstd/vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
+//----------------------------------------------------------------------------
+// Computes the normals of a range of polygons of the new mesh.
+class vtkPolyDataNormalsPolygonFunctor
+{
+public:
+  vtkPolyDataNormals *Filter;
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *Normals;
+  vtkIdType NumberOfPolys;
+  vtkMultiThreaderIDType MainThread;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    if (this->Filter->GetAbortExecute())
+      {
+      return;
+      }
+    if (vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(),
+                                       this->MainThread))
+      {
+      this->Filter->UpdateProgress(
+        0.333 + 0.333 * static_cast<double>(begin) / this->NumberOfPolys);
+      }
+
+    vtkIdType npts, *pts;
+    double n[3];
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      float *normal = this->Normals + 3*cellId;
+      normal[0] = static_cast<float>(n[0]);
+      normal[1] = static_cast<float>(n[1]);
+      normal[2] = static_cast<float>(n[2]);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Sums the normals of the polygons around a range of points and normalizes
+// the result.  Offsets and Cells list the polygons of every point in
+// increasing order, so each sum is formed (and rounded to float) in the
+// same order as when the polygons are visited one after the other.
+class vtkPolyDataNormalsPointFunctor
+{
+public:
+  const vtkIdType *Offsets;
+  const vtkIdType *Cells;
+  const float *PolyNormals;
+  float *Normals;
+  double FlipDirection;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+      float sum[3] = { 0.0f, 0.0f, 0.0f };
+      for (vtkIdType c = this->Offsets[ptId]; c < this->Offsets[ptId+1]; c++)
+        {
+        const float *polyNormal = this->PolyNormals + 3*this->Cells[c];
+        for (int j=0; j < 3; j++)
+          {
+          sum[j] = static_cast<float>(static_cast<double>(sum[j]) +
+                                      static_cast<double>(polyNormal[j]));
+          }
+        }
+
+      double vertNormal[3] = { sum[0], sum[1], sum[2] };
+      double length = vtkMath::Norm(vertNormal);
+      float *normal = this->Normals + 3*ptId;
+      for (int j=0; j < 3; j++)
+        {
+        normal[j] = static_cast<float>(
+          length != 0.0 ? vertNormal[j] / length * this->FlipDirection :
+          vertNormal[j]);
+        }
+      }
+    }
+};
+
 // Construct with feature angle=30, splitting and consistency turned on, 
 // flipNormals turned off, and non-manifold traversal turned on.
 vtkPolyDataNormals::vtkPolyDataNormals()
@@ -64,12 +149,10 @@ int vtkPolyDataNormals::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  int j;
   vtkIdType npts = 0;
   vtkIdType i;
   vtkIdType *pts = 0;
   vtkIdType numNewPts;
-  double polyNormal[3], vertNormal[3], length;
   double flipDirection=1.0;
   vtkIdType numPolys, numStrips;
   vtkIdType cellId;
@@ -316,20 +399,14 @@ int vtkPolyDataNormals::RequestData(
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); 
-       cellId++ )
-    {
-    if ((cellId % 1000) == 0)
-      {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
-        {
-        break; 
-        }
-      }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
-    }
+  vtkPolyDataNormalsPolygonFunctor polygonFunctor;
+  polygonFunctor.Filter = this;
+  polygonFunctor.Mesh = this->NewMesh;
+  polygonFunctor.Points = inPts;
+  polygonFunctor.Normals = this->PolyNormals->GetPointer(0);
+  polygonFunctor.NumberOfPolys = numPolys;
+  polygonFunctor.MainThread = vtkMultiThreader::GetCurrentThreadID();
+  vtkSMPTools::For(0, numPolys, polygonFunctor);
 
   // Split mesh if sharp features
   if ( this->Splitting ) 
@@ -400,41 +477,48 @@ int vtkPolyDataNormals::RequestData(
   newNormals->SetNumberOfComponents(3);
   newNormals->SetNumberOfTuples(numNewPts);
   newNormals->SetName("Normals");
-  n[0] = n[1] = n[2] = 0.0;
-  for (i=0; i < numNewPts; i++)
-    {
-    newNormals->SetTuple(i,n);
-    }
 
   if (this->ComputePointNormals)
     {
-    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); 
-          cellId++ )
+    // List the polygons that use every point, then let each point gather
+    // its polygon normals so that the points can be split across threads.
+    vtkstd::vector<vtkIdType> offsets(numNewPts+1, 0);
+    for (newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); )
       {
-      this->PolyNormals->GetTuple(cellId, polyNormal);
-
-      for (i=0; i < npts; i++) 
+      for (i=0; i < npts; i++)
         {
-        newNormals->GetTuple(pts[i], vertNormal);
-        for (j=0; j < 3; j++)
-          {
-          n[j] = vertNormal[j] + polyNormal[j];
-          }
-        newNormals->SetTuple(pts[i],n);
+        offsets[pts[i]+1]++;
         }
       }
-
-    for (i=0; i < numNewPts; i++) 
+    for (i=0; i < numNewPts; i++)
+      {
+      offsets[i+1] += offsets[i];
+      }
+    vtkstd::vector<vtkIdType> cells(offsets[numNewPts] > 0 ?
+                                    offsets[numNewPts] : 1);
+    vtkstd::vector<vtkIdType> next(offsets.begin(), offsets.end()-1);
+    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
+         cellId++ )
       {
-      newNormals->GetTuple(i, vertNormal);
-      length = vtkMath::Norm(vertNormal);
-      if (length != 0.0) 
+      for (i=0; i < npts; i++)
         {
-        for (j=0; j < 3; j++)
-          {
-          n[j] = vertNormal[j] / length * flipDirection;
-          }
+        cells[next[pts[i]]++] = cellId;
         }
+      }
+
+    vtkPolyDataNormalsPointFunctor pointFunctor;
+    pointFunctor.Offsets = &offsets[0];
+    pointFunctor.Cells = &cells[0];
+    pointFunctor.PolyNormals = this->PolyNormals->GetPointer(0);
+    pointFunctor.Normals = newNormals->GetPointer(0);
+    pointFunctor.FlipDirection = flipDirection;
+    vtkSMPTools::For(0, numNewPts, pointFunctor);
+    }
+  else
+    {
+    n[0] = n[1] = n[2] = 0.0;
+    for (i=0; i < numNewPts; i++)
+      {
       newNormals->SetTuple(i,n);
       }
     }
@@ -23,7 +23,8 @@
 // The algorithm works by determining normals for each polygon and then
 // averaging them at shared points. When sharp edges are present, the edges
 // are split and new points generated to prevent blurry edges (due to 
-// Gouraud shading).
+// Gouraud shading). The polygon normals and their averages are computed in
+// parallel with vtkSMPTools; orienting and splitting run on one thread.
 
 // .SECTION Caveats
 // Normals are computed only for polygons and triangle strips. Normals are
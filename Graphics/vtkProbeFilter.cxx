@@ -17,12 +17,18 @@
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkCharArray.h"
+#include "vtkGenericCell.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <vtkstd/vector>
@@ -34,10 +40,90 @@ class vtkProbeFilter::vtkVectorOfArrays :
 {
 };
 
+//----------------------------------------------------------------------------
+// Probe a range of input points.  Every thread has its own cell and
+// weights, and writes only the tuples of its own points into arrays that
+// already hold all the tuples.  A point found in the source is marked
+// with 2 in the mask; the valid point list and the null points are
+// handled afterwards on one thread.
+class vtkProbeFilterFunctor
+{
+public:
+  vtkProbeFilter *Filter;
+  vtkDataSet *Input;
+  vtkDataSet *Source;
+  vtkPointData *OutPD;
+  vtkDataSetAttributes::FieldList *PointList;
+  int SourceIndex;
+  double Tolerance2;
+  char *Mask;
+  // Cell data arrays of the source and the point data arrays they are
+  // copied to.
+  vtkstd::vector<vtkstd::pair<vtkDataArray *, vtkDataArray *> > CellArrays;
+  int MaxCellSize;
+  vtkMultiThreaderIDType MainThread;
+  vtkIdType NumberOfPoints;
+
+  vtkSMPThreadLocal<vtkSmartPointer<vtkGenericCell> > Cell;
+  vtkSMPThreadLocal<vtkstd::vector<double> > Weights;
+
+  void Initialize()
+    {
+    this->Cell.Local() = vtkSmartPointer<vtkGenericCell>::New();
+    this->Weights.Local().resize(this->MaxCellSize);
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    if (this->Filter->GetAbortExecute())
+      {
+      return;
+      }
+    if (vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(),
+                                       this->MainThread))
+      {
+      this->Filter->UpdateProgress(
+        static_cast<double>(begin) / this->NumberOfPoints);
+      }
+
+    vtkGenericCell *cell = this->Cell.Local();
+    double *weights = &this->Weights.Local()[0];
+    vtkPointData *pd = this->Source->GetPointData();
+    double x[3], pcoords[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      if (this->Mask[ptId] == static_cast<char>(1))
+        {
+        continue;
+        }
+      this->Input->GetPoint(ptId, x);
+      vtkIdType cellId =
+        this->Source->FindCell(x, this->Tolerance2, cell, pcoords, weights);
+      if (cellId < 0)
+        {
+        continue;
+        }
+      this->OutPD->InterpolatePoint(*this->PointList, pd, this->SourceIndex,
+                                    ptId, cell->PointIds, weights);
+      for (size_t i = 0; i < this->CellArrays.size(); ++i)
+        {
+        this->CellArrays[i].second->InsertTuple(ptId, cellId,
+                                                this->CellArrays[i].first);
+        }
+      this->Mask[ptId] = static_cast<char>(2);
+      }
+    }
+
+  void Reduce()
+    {
+    }
+};
+
 //----------------------------------------------------------------------------
 vtkProbeFilter::vtkProbeFilter()
 {
   this->SpatialMatch = 0;
+  this->ParallelExecution = 0;
   this->ValidPoints = vtkIdTypeArray::New();
   this->MaskPoints = vtkCharArray::New();
   this->MaskPoints->SetNumberOfComponents(1);
@@ -268,6 +354,27 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
   double minRes2 = minRes * minRes;
   tol2 = tol2 > minRes2 ? minRes2 : tol2;
 
+  // Writing the bits of neighboring points from different threads would
+  // race, so bit arrays are probed on one thread.
+  int parallel = this->ParallelExecution && numPts > 1;
+  for (int i = 0; parallel && i < outPD->GetNumberOfArrays(); i++)
+    {
+    vtkAbstractArray *array = outPD->GetAbstractArray(i);
+    if (array && array->GetDataType() == VTK_BIT)
+      {
+      parallel = 0;
+      }
+    }
+  if (parallel)
+    {
+    if (mcs>256)
+      {
+      delete [] weights;
+      }
+    this->ProbePointsInParallel(input, srcIdx, source, output, tol2);
+    return;
+    }
+
   // Loop over all input points, interpolating source data
   //
   int abort=0;
@@ -334,6 +441,88 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkProbeFilter::ProbePointsInParallel(vtkDataSet *input, int srcIdx,
+                                           vtkDataSet *source,
+                                           vtkDataSet *output, double tol2)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData *outPD = output->GetPointData();
+  vtkCellData *cd = source->GetCellData();
+
+  vtkProbeFilterFunctor functor;
+  functor.Filter = this;
+  functor.Input = input;
+  functor.Source = source;
+  functor.OutPD = outPD;
+  functor.PointList = this->PointList;
+  functor.SourceIndex = srcIdx;
+  functor.Tolerance2 = tol2;
+  functor.MainThread = vtkMultiThreader::GetCurrentThreadID();
+  functor.NumberOfPoints = numPts;
+  vtkVectorOfArrays::iterator iter;
+  for (iter = this->CellArrays->begin(); iter != this->CellArrays->end();
+    ++iter)
+    {
+    vtkDataArray* inArray = cd->GetArray((*iter)->GetName());
+    if (inArray)
+      {
+      functor.CellArrays.push_back(
+        vtkstd::pair<vtkDataArray *, vtkDataArray *>(inArray, *iter));
+      }
+    }
+
+  // Give every output array all its tuples so that the threads only
+  // overwrite values.
+  for (int i = 0; i < outPD->GetNumberOfArrays(); i++)
+    {
+    vtkAbstractArray *array = outPD->GetAbstractArray(i);
+    if (array && array->GetNumberOfTuples() < numPts)
+      {
+      array->SetNumberOfTuples(numPts);
+      }
+    }
+  char *maskArray = this->MaskPoints->GetPointer(0);
+  functor.Mask = maskArray;
+
+  // Point sets are searched with a cell locator, built here and freed
+  // again unless the source already had one.  The first search builds
+  // whatever else the source builds lazily (cells, bounds) before the
+  // threads share it.
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(source);
+  int releaseLocator = (pointSet && !pointSet->GetCellLocator());
+  if (pointSet)
+    {
+    pointSet->BuildCellLocator();
+    }
+  functor.MaxCellSize = source->GetMaxCellSize() + 1;
+  double x[3], pcoords[3];
+  vtkstd::vector<double> weights(functor.MaxCellSize);
+  vtkSmartPointer<vtkGenericCell> cell = vtkSmartPointer<vtkGenericCell>::New();
+  input->GetPoint(0, x);
+  source->FindCell(x, tol2, cell, pcoords, &weights[0]);
+
+  vtkSMPTools::Reduce(0, numPts, functor);
+  if (releaseLocator)
+    {
+    pointSet->ReleaseCellLocator();
+    }
+
+  for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+    {
+    if (maskArray[ptId] == static_cast<char>(2))
+      {
+      maskArray[ptId] = static_cast<char>(1);
+      this->ValidPoints->InsertNextValue(ptId);
+      this->NumberOfValidPoints++;
+      }
+    else if (maskArray[ptId] == static_cast<char>(0) && this->UseNullPoint)
+      {
+      outPD->NullPoint(ptId);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 int vtkProbeFilter::RequestInformation(
   vtkInformation *vtkNotUsed(request),
@@ -510,4 +699,6 @@ void vtkProbeFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ValidPointMaskArrayName: " << (this->ValidPointMaskArrayName?
     this->ValidPointMaskArrayName : "vtkValidPointMask") << "\n";
   os << indent << "ValidPoints: " << this->ValidPoints << "\n";
+  os << indent << "ParallelExecution: "
+     << (this->ParallelExecution ? "On\n" : "Off\n");
 }
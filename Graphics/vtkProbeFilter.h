@@ -31,6 +31,12 @@
 // rendering techniques can be used to visualize the results. Another example:
 // a line or curve can be used to probe data to produce x-y plots along
 // that line or curve.
+//
+// The input points can be probed on several threads with vtkSMPTools, see
+// ParallelExecution.
+//
+// .SECTION See Also
+// vtkSMPTools vtkDataSet::FindCell
 
 #ifndef __vtkProbeFilter_h
 #define __vtkProbeFilter_h
@@ -85,12 +91,27 @@ public:
   vtkSetStringMacro(ValidPointMaskArrayName)
   vtkGetStringMacro(ValidPointMaskArrayName)
 
+  // Description:
+  // When on, the input points are probed on several threads with the
+  // reentrant vtkDataSet::FindCell(), each thread using its own cell and
+  // weights.  Point set sources are then searched with a cell locator
+  // (see vtkPointSet::BuildCellLocator()) instead of the walk from the
+  // closest point, so the output may differ from the single threaded one:
+  // points just outside the source but within the tolerance may also be
+  // found, and a point on the boundary between source cells may take its
+  // values from either of them.  Sources with bit arrays are always
+  // probed on one thread.  Off by default.
+  vtkSetMacro(ParallelExecution, int);
+  vtkGetMacro(ParallelExecution, int);
+  vtkBooleanMacro(ParallelExecution, int);
+
 //BTX 
 protected:
   vtkProbeFilter();
   ~vtkProbeFilter();
 
   int SpatialMatch;
+  int ParallelExecution;
 
   virtual int RequestData(vtkInformation *, vtkInformationVector **, 
     vtkInformationVector *);
@@ -119,6 +140,11 @@ protected:
   void ProbeEmptyPoints(vtkDataSet *input, int srcIdx, vtkDataSet *source, 
     vtkDataSet *output);
 
+  // Description:
+  // Parallel version of the loop of ProbeEmptyPoints().
+  void ProbePointsInParallel(vtkDataSet *input, int srcIdx,
+    vtkDataSet *source, vtkDataSet *output, double tol2);
+
   char* ValidPointMaskArrayName;
   vtkIdTypeArray *ValidPoints;
   vtkCharArray* MaskPoints;
@@ -19,6 +19,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkCriticalSection.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkDoubleArray.h"
 #include "vtkExecutive.h"
@@ -34,6 +35,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkCellLocatorInterpolatedVelocityField.h"
 #include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
@@ -42,7 +44,15 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/vector>
+
+// Number of seeds integrated by a task of the parallel integration.
+#define VTK_STREAM_TRACER_BATCH_SIZE 64
 
 vtkStandardNewMacro(vtkStreamTracer);
 vtkCxxSetObjectMacro(vtkStreamTracer,Integrator,vtkInitialValueProblemSolver);
@@ -78,6 +88,9 @@ vtkStreamTracer::vtkStreamTracer()
 
   this->InterpolatorPrototype = 0;
 
+  this->ParallelExecution = 0;
+  this->IntegrationLock = 0;
+
   this->SetNumberOfInputPorts(2);
 
   // by default process active point vectors
@@ -458,14 +471,35 @@ int vtkStreamTracer::RequestData(
     if (vectors)
       {
       const char *vecName = vectors->GetName();
-      double propagation = 0;
-      vtkIdType numSteps = 0;
-      this->Integrate(input0, output,
-                      seeds, seedIds,
-                      integrationDirections,
-                      lastPoint, func,
-                      maxCellSize, vecName,
-                      propagation, numSteps);
+      vtkTimerLog *timer = vtkTimerLog::New();
+      timer->StartTimer();
+      if (!this->ParallelExecution ||
+          !this->IntegrateInParallel(input0, output,
+                                     seeds, seedIds,
+                                     integrationDirections,
+                                     func, maxCellSize, vecName))
+        {
+        double propagation = 0;
+        vtkIdType numSteps = 0;
+        this->Integrate(input0, output,
+                        seeds, seedIds,
+                        integrationDirections,
+                        lastPoint, func,
+                        maxCellSize, vecName,
+                        propagation, numSteps);
+        }
+      timer->StopTimer();
+
+      // Every point of a streamline but its seed is one integration step.
+      double elapsed = timer->GetElapsedTime();
+      vtkIdType steps = output->GetNumberOfPoints() - output->GetNumberOfLines();
+      vtkTimerLog::FormatAndMarkEvent(
+        "vtkStreamTracer: %ld particle steps in %g s, %g steps/s",
+        static_cast<long>(steps), elapsed,
+        elapsed > 0.0 ? steps / elapsed : 0.0);
+      vtkDebugMacro("Integrated " << steps << " particle steps in "
+                    << elapsed << " s");
+      timer->Delete();
       }
     func->Delete();
     seeds->Delete();
@@ -559,6 +593,265 @@ int vtkStreamTracer::CheckInputs(vtkAbstractInterpolatedVelocityField*& func,
   return VTK_OK;
 }
 
+// Build the search structures that a dataset creates on first use, so that
+// the threads only read them: the bounds, the cell links and the point
+// locator used by vtkPointSet::FindCell().
+static void vtkStreamTracerPrepareDataSet(vtkDataSet *ds)
+{
+  double bounds[6];
+  ds->GetBounds(bounds);
+  if (ds->GetNumberOfPoints() < 1 || ds->GetNumberOfCells() < 1)
+    {
+    return;
+    }
+  vtkIdList *cellIds = vtkIdList::New();
+  ds->GetPointCells(0, cellIds);
+  cellIds->Delete();
+  double x[3];
+  ds->GetPoint(0, x);
+  ds->FindPoint(x);
+}
+
+// Integrate one batch of consecutive seeds per task into a polydata of its
+// own.  Every thread integrates through its own copy of the velocity field.
+class vtkStreamTracerFunctor
+{
+public:
+  vtkStreamTracer *Filter;
+  vtkDataSet *Input0;
+  vtkDataArray *Seeds;
+  vtkIdList *SeedIds;
+  vtkIntArray *IntegrationDirections;
+  vtkAbstractInterpolatedVelocityField *Prototype;
+  vtkstd::vector<vtkDataSet *> DataSets;
+  int MaxCellSize;
+  const char *VectorsName;
+  vtkMultiThreaderIDType MainThread;
+  // One entry per batch, in seed order.
+  vtkstd::vector<vtkPolyData *> Pieces;
+
+  vtkSMPThreadLocal<vtkSmartPointer<vtkAbstractInterpolatedVelocityField> >
+    Func;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkIdList> > BatchIds;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkIntArray> > BatchDirections;
+
+  void Initialize()
+    {
+    vtkAbstractInterpolatedVelocityField *func =
+      this->Prototype->NewInstance();
+    func->CopyParameters(this->Prototype);
+    func->SelectVectors(this->VectorsName);
+    for (size_t i = 0; i < this->DataSets.size(); ++i)
+      {
+      func->AddDataSet(this->DataSets[i]);
+      }
+    func->CopyTolerances(this->Prototype);
+    this->Func.Local().TakeReference(func);
+    this->BatchIds.Local() = vtkSmartPointer<vtkIdList>::New();
+    this->BatchDirections.Local() = vtkSmartPointer<vtkIntArray>::New();
+    }
+
+  void Reduce()
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    if (this->Filter->GetAbortExecute())
+      {
+      return;
+      }
+    if (vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(),
+                                       this->MainThread))
+      {
+      this->Filter->UpdateProgress(
+        static_cast<double>(begin) / this->Pieces.size());
+      }
+    vtkAbstractInterpolatedVelocityField *func = this->Func.Local();
+    vtkIdList *ids = this->BatchIds.Local();
+    vtkIntArray *directions = this->BatchDirections.Local();
+    vtkIdType numLines = this->SeedIds->GetNumberOfIds();
+    for (vtkIdType task = begin; task < end; ++task)
+      {
+      vtkIdType first = task * VTK_STREAM_TRACER_BATCH_SIZE;
+      vtkIdType last = first + VTK_STREAM_TRACER_BATCH_SIZE;
+      if (last > numLines)
+        {
+        last = numLines;
+        }
+      ids->SetNumberOfIds(last - first);
+      directions->SetNumberOfTuples(last - first);
+      for (vtkIdType i = first; i < last; ++i)
+        {
+        ids->SetId(i - first, this->SeedIds->GetId(i));
+        directions->SetValue(i - first,
+                             this->IntegrationDirections->GetValue(i));
+        }
+
+      vtkPolyData *piece = vtkPolyData::New();
+      double lastPoint[3];
+      double propagation = 0;
+      vtkIdType numSteps = 0;
+      this->Filter->Integrate(this->Input0, piece, this->Seeds, ids,
+                              directions, lastPoint, func, this->MaxCellSize,
+                              this->VectorsName, propagation, numSteps);
+      this->Pieces[task] = piece;
+      }
+    }
+};
+
+// Append a batch of streamlines to the output.
+static void vtkStreamTracerAppendPiece(vtkPolyData *piece,
+                                       vtkPoints *outputPoints,
+                                       vtkCellArray *outputLines,
+                                       vtkPointData *outputPD,
+                                       vtkIntArray *retVals)
+{
+  vtkPoints *points = piece->GetPoints();
+  if (!points)
+    {
+    return;
+    }
+  vtkPointData *pd = piece->GetPointData();
+  vtkIdType offset = outputPoints->GetNumberOfPoints();
+  vtkIdType numPts = points->GetNumberOfPoints();
+  double x[3];
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    points->GetPoint(i, x);
+    outputPoints->InsertNextPoint(x);
+    outputPD->CopyData(pd, i, offset + i);
+    }
+
+  vtkCellArray *lines = piece->GetLines();
+  vtkIdType npts, *pts;
+  for (lines->InitTraversal(); lines->GetNextCell(npts, pts); )
+    {
+    outputLines->InsertNextCell(npts);
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      outputLines->InsertCellPoint(offset + pts[i]);
+      }
+    }
+
+  vtkIntArray *reasons = vtkIntArray::SafeDownCast(
+    piece->GetCellData()->GetArray("ReasonForTermination"));
+  if (reasons)
+    {
+    for (vtkIdType i = 0; i < reasons->GetNumberOfTuples(); ++i)
+      {
+      retVals->InsertNextValue(reasons->GetValue(i));
+      }
+    }
+}
+
+int vtkStreamTracer::IntegrateInParallel(vtkDataSet *input0,
+                                         vtkPolyData* output,
+                                         vtkDataArray* seedSource,
+                                         vtkIdList* seedIds,
+                                         vtkIntArray* integrationDirections,
+                                         vtkAbstractInterpolatedVelocityField* func,
+                                         int maxCellSize,
+                                         const char *vecName)
+{
+  // The cell locator interpolators build their locators lazily on first
+  // use, which cannot happen on several threads.
+  vtkIdType numLines = seedIds->GetNumberOfIds();
+  if (numLines <= VTK_STREAM_TRACER_BATCH_SIZE || !this->GetIntegrator() ||
+      !func->IsA("vtkInterpolatedVelocityField"))
+    {
+    return 0;
+    }
+
+  vtkStreamTracerFunctor functor;
+  functor.Filter = this;
+  functor.Input0 = input0;
+  functor.Seeds = seedSource;
+  functor.SeedIds = seedIds;
+  functor.IntegrationDirections = integrationDirections;
+  functor.Prototype = func;
+  functor.MaxCellSize = maxCellSize;
+  functor.VectorsName = vecName;
+  functor.MainThread = vtkMultiThreader::GetCurrentThreadID();
+
+  // The same datasets as in CheckInputs(), in the same order.
+  vtkCompositeDataIterator* iter = this->InputData->NewIterator();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+       iter->GoToNextItem())
+    {
+    vtkDataSet* inp = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    if (inp && inp->GetPointData()->GetVectors(vecName))
+      {
+      vtkStreamTracerPrepareDataSet(inp);
+      functor.DataSets.push_back(inp);
+      }
+    }
+  iter->Delete();
+  func->ComputeTolerances();
+
+  // The normals are generated once all the batches have been appended.
+  vtkIdType numBatches = (numLines + VTK_STREAM_TRACER_BATCH_SIZE - 1) /
+    VTK_STREAM_TRACER_BATCH_SIZE;
+  functor.Pieces.resize(numBatches, NULL);
+  bool generateNormals = this->GenerateNormalsInIntegrate;
+  vtkSimpleCriticalSection lock;
+  this->GenerateNormalsInIntegrate = false;
+  this->IntegrationLock = &lock;
+  vtkSMPTools::Reduce(0, numBatches, 1, functor);
+  this->IntegrationLock = 0;
+  this->GenerateNormalsInIntegrate = generateNormals;
+
+  // Like Integrate(), leave the output empty when aborted.
+  if (this->GetAbortExecute())
+    {
+    for (size_t i = 0; i < functor.Pieces.size(); ++i)
+      {
+      if (functor.Pieces[i])
+        {
+        functor.Pieces[i]->Delete();
+        }
+      }
+    return 1;
+    }
+
+  vtkIdType numPtsTotal = 0;
+  for (size_t i = 0; i < functor.Pieces.size(); ++i)
+    {
+    numPtsTotal += functor.Pieces[i]->GetNumberOfPoints();
+    }
+
+  vtkPoints* outputPoints = vtkPoints::New();
+  outputPoints->Allocate(numPtsTotal);
+  vtkCellArray* outputLines = vtkCellArray::New();
+  vtkIntArray* retVals = vtkIntArray::New();
+  retVals->SetName("ReasonForTermination");
+  vtkPointData* outputPD = output->GetPointData();
+  outputPD->CopyAllocate(functor.Pieces[0]->GetPointData(), numPtsTotal);
+  for (size_t i = 0; i < functor.Pieces.size(); ++i)
+    {
+    vtkStreamTracerAppendPiece(functor.Pieces[i], outputPoints, outputLines,
+                               outputPD, retVals);
+    functor.Pieces[i]->Delete();
+    }
+
+  output->SetPoints(outputPoints);
+  if (numPtsTotal > 1)
+    {
+    output->SetLines(outputLines);
+    if (this->GenerateNormalsInIntegrate)
+      {
+      this->GenerateNormals(output, 0, vecName);
+      }
+    output->GetCellData()->AddArray(retVals);
+    }
+  outputPoints->Delete();
+  outputLines->Delete();
+  retVals->Delete();
+
+  output->Squeeze();
+  return 1;
+}
+
 void vtkStreamTracer::Integrate(vtkDataSet *input0,
                                 vtkPolyData* output,
                                 vtkDataArray* seedSource,
@@ -658,8 +951,20 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
   //       as a consequence a large number of such small vtkPolyData objects
   //       are needed to represent a streamline, consuming up the memory before
   //       the intermediate memory is timely released.
+  //
+  // When running on several threads, the allocation is serialized: it
+  // copies the lookup tables and information keys of the input arrays,
+  // which all the threads share.
+  if (this->IntegrationLock)
+    {
+    this->IntegrationLock->Lock();
+    }
   outputPD->InterpolateAllocate( input0->GetPointData(),
                                  this->MaximumNumberOfSteps );
+  if (this->IntegrationLock)
+    {
+    this->IntegrationLock->Unlock();
+    }
 
   vtkIdType numPtsTotal=0;
   double velocity[3];
@@ -670,7 +975,10 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     {
 
     double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
+    if (!this->IntegrationLock)
+      {
+      this->UpdateProgress(progress);
+      }
 
     switch (integrationDirections->GetValue(currentLine))
       {
@@ -782,9 +1090,12 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
 
       if ( numSteps++ % 1000 == 1 )
         {
-        progress =
-          ( currentLine + propagation / this->MaximumPropagation ) / numLines;
-        this->UpdateProgress(progress);
+        if (!this->IntegrationLock)
+          {
+          progress = ( currentLine + propagation / this->MaximumPropagation )
+            / numLines;
+          this->UpdateProgress(progress);
+          }
 
         if (this->GetAbortExecute())
           {
@@ -817,7 +1128,10 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
           }
         maxStep = stepSize.Interval;
         }
-      this->LastUsedStepSize = stepSize.Interval;
+      if (!this->IntegrationLock)
+        {
+        this->LastUsedStepSize = stepSize.Interval;
+        }
 
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
@@ -1230,6 +1544,8 @@ void vtkStreamTracer::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Vorticity computation: "
      << (this->ComputeVorticity ? " On" : " Off") << endl;
   os << indent << "Rotation scale: " << this->RotationScale << endl;
+  os << indent << "ParallelExecution: "
+     << (this->ParallelExecution ? "On\n" : "Off\n");
 }
 
 vtkExecutive* vtkStreamTracer::CreateDefaultExecutive()
@@ -67,11 +67,14 @@
 // a source object, traces will be generated from each point in the source
 // that is inside the dataset.
 //
+// Seeds can be integrated on several threads with vtkSMPTools, see
+// ParallelExecution.
+//
 // .SECTION See Also
 // vtkRibbonFilter vtkRuledSurfaceFilter vtkInitialValueProblemSolver
 // vtkRungeKutta2 vtkRungeKutta4 vtkRungeKutta45 vtkTemporalStreamTracer
 // vtkAbstractInterpolatedVelocityField vtkInterpolatedVelocityField
-// vtkCellLocatorInterpolatedVelocityField
+// vtkCellLocatorInterpolatedVelocityField vtkSMPTools
 //
 
 #ifndef __vtkStreamTracer_h
@@ -89,6 +92,7 @@ class vtkGenericCell;
 class vtkIdList;
 class vtkIntArray;
 class vtkAbstractInterpolatedVelocityField;
+class vtkSimpleCriticalSection;
 
 class VTK_GRAPHICS_EXPORT vtkStreamTracer : public vtkPolyDataAlgorithm
 {
@@ -296,6 +300,18 @@ public:
   // vtkPointSet::FindCell() coupled with vtkPointLocator).
   void SetInterpolatorType( int interpType );
 
+  // Description:
+  // When on, the seeds are cut into batches that are integrated on
+  // several threads with vtkSMPTools.  Every thread uses its own copy of
+  // the velocity field, with its own cell cache, and the streamlines are
+  // appended to the output in seed order, so the output is the same as
+  // with a single thread.  Interpolators other than
+  // vtkInterpolatedVelocityField are always used on one thread.  Off by
+  // default.
+  vtkSetMacro(ParallelExecution, int);
+  vtkGetMacro(ParallelExecution, int);
+  vtkBooleanMacro(ParallelExecution, int);
+
 protected:
 
   vtkStreamTracer();
@@ -330,6 +346,19 @@ protected:
                        vtkAbstractInterpolatedVelocityField* func);
   int CheckInputs(vtkAbstractInterpolatedVelocityField*& func,
                   int* maxCellSize);
+
+  // Description:
+  // Integrate the seeds in batches on several threads and append the
+  // batches to the output.  Returns 0 without doing anything when the
+  // seeds must be integrated by Integrate() on one thread.
+  int IntegrateInParallel(vtkDataSet *input0,
+                          vtkPolyData* output,
+                          vtkDataArray* seedSource,
+                          vtkIdList* seedIds,
+                          vtkIntArray* integrationDirections,
+                          vtkAbstractInterpolatedVelocityField* func,
+                          int maxCellSize,
+                          const char *vecFieldName);
   void GenerateNormals(vtkPolyData* output, double* firstNormal, const char *vecName);
 
   bool GenerateNormalsInIntegrate;
@@ -384,6 +413,16 @@ protected:
 
   vtkCompositeDataSet* InputData;
 
+  int ParallelExecution;
+
+  // Set while Integrate() runs on several threads.  Integrate() then leaves
+  // the progress to the caller and allocates its output under this lock.
+  vtkSimpleCriticalSection* IntegrationLock;
+
+//BTX
+  friend class vtkStreamTracerFunctor;
+//ETX
+
 private:
   vtkStreamTracer(const vtkStreamTracer&);  // Not implemented.
   void operator=(const vtkStreamTracer&);  // Not implemented.
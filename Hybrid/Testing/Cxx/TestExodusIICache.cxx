@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestExodusIICache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the array cache shared by the Exodus readers
+// .SECTION Description
+// Fills two caches with 1 MiB arrays and checks that the global capacity
+// drops the entries of the cache with the lowest priority first, that a
+// pinned cache is left alone, that equal priorities drop the least
+// recently used entry of all the caches, and that the hit, miss and
+// eviction counts and the global size are kept.
+
+#include "vtkDoubleArray.h"
+#include "vtkExodusIICache.h"
+#include "vtkSmartPointer.h"
+
+#include <math.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Insert a 1 MiB array for the given time step.
+static void InsertArray(vtkExodusIICache* cache, int time)
+{
+  VTK_CREATE(vtkDoubleArray, array);
+  array->SetNumberOfTuples(128 * 1024);
+  vtkExodusIICacheKey key(time, 0, 0, 0);
+  cache->Insert(key, array);
+}
+
+static int Has(vtkExodusIICache* cache, int time)
+{
+  return cache->Find(vtkExodusIICacheKey(time, 0, 0, 0)) != 0;
+}
+
+static int Check(const char* what, double value, double expected)
+{
+  if (fabs(value - expected) > 1.0e-6)
+    {
+    cerr << what << " is " << value << " instead of " << expected << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestExodusIICache(int, char*[])
+{
+  int ok = 1;
+  VTK_CREATE(vtkExodusIICache, low);
+  VTK_CREATE(vtkExodusIICache, high);
+  low->SetCacheCapacity(10.);
+  high->SetCacheCapacity(10.);
+  high->SetPriority(1);
+
+  for (int t = 0; t < 3; ++t)
+    {
+    InsertArray(low, t);
+    InsertArray(high, t);
+    }
+  ok = Check("global size", vtkExodusIICache::GetGlobalCacheSize(), 6.) && ok;
+
+  // Shrinking the global capacity drops the oldest low priority arrays.
+  vtkExodusIICache::SetGlobalCacheCapacity(4.);
+  ok = Check("global size", vtkExodusIICache::GetGlobalCacheSize(), 4.) && ok;
+  ok = Check("low priority space left", low->GetSpaceLeft(), 9.) && ok;
+  ok = Check("low priority evictions",
+             static_cast<double>(low->GetNumberOfEvictions()), 2.) && ok;
+  ok = Check("high priority evictions",
+             static_cast<double>(high->GetNumberOfEvictions()), 0.) && ok;
+  if (Has(low, 0) || Has(low, 1) || !Has(low, 2))
+    {
+    cerr << "The wrong low priority arrays were dropped" << endl;
+    ok = 0;
+    }
+  ok = Check("hits", static_cast<double>(low->GetNumberOfHits()), 1.) && ok;
+  ok = Check("misses", static_cast<double>(low->GetNumberOfMisses()), 2.) && ok;
+
+  // A pinned cache keeps its arrays even when it has the lowest priority.
+  low->SetPriority(2);
+  high->Pin();
+  InsertArray(low, 3);
+  InsertArray(low, 4);
+  high->Unpin();
+  ok = Check("global size", vtkExodusIICache::GetGlobalCacheSize(), 4.) && ok;
+  ok = Check("pinned evictions",
+             static_cast<double>(high->GetNumberOfEvictions()), 0.) && ok;
+  if (!Has(low, 4) || Has(low, 3) || Has(low, 2))
+    {
+    cerr << "Inserting into the cache did not drop its own arrays" << endl;
+    ok = 0;
+    }
+
+  // With equal priorities the least recently used array goes, whichever
+  // cache holds it.  Using array 0 of the high priority cache makes array
+  // 1 the oldest.
+  high->SetPriority(2);
+  Has(high, 0);
+  InsertArray(low, 5);
+  if (!Has(high, 0) || Has(high, 1) || !Has(high, 2) || !Has(low, 4) ||
+      !Has(low, 5))
+    {
+    cerr << "The least recently used array was not dropped" << endl;
+    ok = 0;
+    }
+
+  low->ResetCounters();
+  ok = Check("hits after reset",
+             static_cast<double>(low->GetNumberOfHits()), 0.) && ok;
+  ok = Check("evictions after reset",
+             static_cast<double>(low->GetNumberOfEvictions()), 0.) && ok;
+
+  // Invalidating and clearing return the space to the global capacity.
+  low->Invalidate(vtkExodusIICacheKey(5, 0, 0, 0));
+  ok = Check("global size", vtkExodusIICache::GetGlobalCacheSize(), 3.) && ok;
+  high->Clear();
+  low->Clear();
+  ok = Check("global size", vtkExodusIICache::GetGlobalCacheSize(), 0.) && ok;
+
+  vtkExodusIICache::SetGlobalCacheCapacity(0.);
+  return ok ? 0 : 1;
+}
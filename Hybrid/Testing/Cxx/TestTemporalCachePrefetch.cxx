@@ -0,0 +1,209 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTemporalCachePrefetch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the time step prefetch of vtkTemporalDataSetCache
+// .SECTION Description
+// Plays a source with ten time steps through the cache forward, backward
+// with a stride of two and with a memory limit too small to prefetch.
+// Every time step must carry the right data, and with prefetching the
+// source must execute on the calling thread only for the requests that
+// cannot be predicted.  Finally releases a pipeline while it prefetches.
+
+#include "vtkCompositeDataPipeline.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTemporalDataSet.h"
+#include "vtkTemporalDataSetCache.h"
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+//----------------------------------------------------------------------------
+// A source producing a single point at x = t for the time steps 0 to 9.
+class vtkTestPrefetchSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestPrefetchSource *New();
+  vtkTypeMacro(vtkTestPrefetchSource, vtkPolyDataAlgorithm);
+
+  int Executions;
+  int MainThreadExecutions;
+  vtkMultiThreaderIDType MainThread;
+
+protected:
+  vtkTestPrefetchSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->Executions = 0;
+    this->MainThreadExecutions = 0;
+    this->MainThread = vtkMultiThreader::GetCurrentThreadID();
+    }
+
+  virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+                                 vtkInformationVector* outputVector)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double steps[10];
+    for (int i = 0; i < 10; ++i)
+      {
+      steps[i] = i;
+      }
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), steps, 10);
+    double range[2] = { 0, 9 };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    return 1;
+    }
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**,
+                          vtkInformationVector* outputVector)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData* output = vtkPolyData::SafeDownCast(
+      outInfo->Get(vtkDataObject::DATA_OBJECT()));
+    double time = 0;
+    if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()))
+      {
+      time = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS())[0];
+      }
+    VTK_CREATE(vtkPoints, points);
+    points->InsertNextPoint(time, 0, 0);
+    output->SetPoints(points);
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEPS(), &time, 1);
+
+    ++this->Executions;
+    if (vtkMultiThreader::ThreadsEqual(this->MainThread,
+                                       vtkMultiThreader::GetCurrentThreadID()))
+      {
+      ++this->MainThreadExecutions;
+      }
+    return 1;
+    }
+
+private:
+  vtkTestPrefetchSource(const vtkTestPrefetchSource&);  // Not implemented.
+  void operator=(const vtkTestPrefetchSource&);  // Not implemented.
+};
+
+vtkStandardNewMacro(vtkTestPrefetchSource);
+
+//----------------------------------------------------------------------------
+// Request the times through a prefetching cache and return the number of
+// source executions on this thread, or -1 if the data are wrong.
+static int Play(const double* times, int numTimes, unsigned long memoryLimit)
+{
+  VTK_CREATE(vtkTestPrefetchSource, source);
+  VTK_CREATE(vtkTemporalDataSetCache, cache);
+  cache->SetInputConnection(source->GetOutputPort());
+  cache->SetCacheSize(10);
+  cache->PrefetchOn();
+  cache->SetPrefetchDepth(2);
+  cache->SetPrefetchMemoryLimit(memoryLimit);
+
+  vtkStreamingDemandDrivenPipeline* sdd =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(cache->GetExecutive());
+  cache->UpdateInformation();
+  for (int i = 0; i < numTimes; ++i)
+    {
+    double time = times[i];
+    sdd->SetUpdateTimeSteps(0, &time, 1);
+    cache->Update();
+    vtkTemporalDataSet* output = vtkTemporalDataSet::SafeDownCast(
+      cache->GetOutputDataObject(0));
+    vtkPolyData* step = output ?
+      vtkPolyData::SafeDownCast(output->GetTimeStep(0)) : 0;
+    if (!step || step->GetNumberOfPoints() != 1 ||
+        step->GetPoint(0)[0] != time)
+      {
+      cerr << "Wrong data for time " << time << endl;
+      return -1;
+      }
+    }
+  // Wait for the last prefetch before counting.
+  cache->SetPrefetch(0);
+  cout << numTimes << " requests, " << source->Executions
+       << " executions of the source, " << source->MainThreadExecutions
+       << " on the calling thread" << endl;
+  return source->MainThreadExecutions;
+}
+
+//----------------------------------------------------------------------------
+// Release the pipeline while the prefetch of the next time step runs.  The
+// garbage collector must stop it before it deletes the pipeline.
+static void Release()
+{
+  VTK_CREATE(vtkTestPrefetchSource, source);
+  VTK_CREATE(vtkTemporalDataSetCache, cache);
+  cache->SetInputConnection(source->GetOutputPort());
+  cache->PrefetchOn();
+  vtkStreamingDemandDrivenPipeline* sdd =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(cache->GetExecutive());
+  cache->UpdateInformation();
+  double time = 0;
+  sdd->SetUpdateTimeSteps(0, &time, 1);
+  cache->Update();
+}
+
+//----------------------------------------------------------------------------
+int TestTemporalCachePrefetch(int, char*[])
+{
+  vtkCompositeDataPipeline* prototype = vtkCompositeDataPipeline::New();
+  vtkAlgorithm::SetDefaultExecutivePrototype(prototype);
+  prototype->Delete();
+
+  int ok = 1;
+
+  // Playing forward, every request after the first is prefetched.
+  double forward[10];
+  for (int i = 0; i < 10; ++i)
+    {
+    forward[i] = i;
+    }
+  int executions = Play(forward, 10, 0);
+  if (executions != 1)
+    {
+    cerr << "Playing forward executed the source " << executions
+         << " times on the calling thread instead of once" << endl;
+    ok = 0;
+    }
+
+  // The stride is known after two requests.
+  double backward[5] = { 9, 7, 5, 3, 1 };
+  executions = Play(backward, 5, 0);
+  if (executions != 2)
+    {
+    cerr << "Playing backward executed the source " << executions
+         << " times on the calling thread instead of twice" << endl;
+    ok = 0;
+    }
+
+  // A memory limit below the size of a time step prevents prefetching.
+  executions = Play(forward, 10, 1);
+  if (executions != 10)
+    {
+    cerr << "Prefetching exceeded the memory limit" << endl;
+    ok = 0;
+    }
+
+  Release();
+
+  vtkAlgorithm::SetDefaultExecutivePrototype(0);
+  return ok ? 0 : 1;
+}
@@ -1,8 +1,11 @@
 #include "vtkExodusIICache.h"
 
+#include "vtkCriticalSection.h"
 #include "vtkDataArray.h"
 #include "vtkObjectFactory.h"
 
+#include <vtkstd/set>
+
 // Define VTK_EXO_DBG_CACHE to print cache adds, drops, and replacements.
 //#undef VTK_EXO_DBG_CACHE
 
@@ -35,11 +38,13 @@ static void printCache( vtkExodusIICacheSet& cache, vtkExodusIICacheLRU& lru )
 vtkExodusIICacheEntry::vtkExodusIICacheEntry()
 {
   this->Value = 0;
+  this->LastUse = 0;
 }
 
 vtkExodusIICacheEntry::vtkExodusIICacheEntry( vtkDataArray* arr )
 {
   this->Value = arr;
+  this->LastUse = 0;
   if ( arr )
     this->Value->Register( 0 );
 }
@@ -52,6 +57,7 @@ vtkExodusIICacheEntry::~vtkExodusIICacheEntry()
 vtkExodusIICacheEntry::vtkExodusIICacheEntry( const vtkExodusIICacheEntry& other )
 {
   this->Value = other.Value;
+  this->LastUse = other.LastUse;
   if ( this->Value )
     this->Value->Register( 0 );
 }
@@ -65,17 +71,60 @@ void printLRUBack( vtkExodusIICacheRef& cit )
 
 // ============================================================================
 
+// State shared by all the caches in the process. It is never freed so that
+// caches destroyed during static destruction can still unregister.
+struct vtkExodusIICacheGlobals
+{
+  vtkExodusIICacheGlobals()
+    {
+    this->Capacity = 0.;
+    this->Size = 0.;
+    this->Clock = 0;
+    }
+
+  vtkSimpleCriticalSection Lock;
+  vtkstd::set<vtkExodusIICache*> Caches;
+  double Capacity;
+  double Size;
+  vtkTypeUInt64 Clock;
+};
+
+static vtkExodusIICacheGlobals* vtkExodusIICacheGetGlobals()
+{
+  static vtkExodusIICacheGlobals* globals = new vtkExodusIICacheGlobals;
+  return globals;
+}
+
+// Construct the globals before main() so that no two threads race to do it.
+static vtkExodusIICacheGlobals* vtkExodusIICacheGlobalsInstance = vtkExodusIICacheGetGlobals();
+
+// ============================================================================
+
 vtkStandardNewMacro(vtkExodusIICache);
 
 vtkExodusIICache::vtkExodusIICache()
 {
   this->Size = 0.;
   this->Capacity = 2.;
+  this->Priority = 0;
+  this->PinCount = 0;
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  g->Caches.insert( this );
+  g->Lock.Unlock();
 }
 
 vtkExodusIICache::~vtkExodusIICache()
 {
-  this->ReduceToSize( 0. );
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  this->ReduceToSizeInternal( 0., 0 );
+  g->Caches.erase( this );
+  g->Lock.Unlock();
 }
 
 void vtkExodusIICache::PrintSelf( ostream& os, vtkIndent indent )
@@ -83,6 +132,13 @@ void vtkExodusIICache::PrintSelf( ostream& os, vtkIndent indent )
   this->Superclass::PrintSelf( os, indent );
   os << indent << "Capacity: " << this->Capacity << " MiB\n";
   os << indent << "Size: " << this->Size << " MiB\n";
+  os << indent << "GlobalCacheCapacity: " << vtkExodusIICache::GetGlobalCacheCapacity() << " MiB\n";
+  os << indent << "GlobalCacheSize: " << vtkExodusIICache::GetGlobalCacheSize() << " MiB\n";
+  os << indent << "Priority: " << this->Priority << "\n";
+  os << indent << "PinCount: " << this->PinCount << "\n";
+  os << indent << "NumberOfHits: " << this->NumberOfHits << "\n";
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << "\n";
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << "\n";
   os << indent << "Cache: " << &this->Cache << " (" << this->Cache.size() << ")\n";
   os << indent << "LRU: " << &this->LRU << "\n";
 }
@@ -90,7 +146,10 @@ void vtkExodusIICache::PrintSelf( ostream& os, vtkIndent indent )
 void vtkExodusIICache::Clear()
 {
   //printCache( this->Cache, this->LRU );
-  this->ReduceToSize( 0. );
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  this->ReduceToSizeInternal( 0., 0 );
+  g->Lock.Unlock();
 }
 
 void vtkExodusIICache::SetCacheCapacity( double sizeInMiB )
@@ -98,95 +157,175 @@ void vtkExodusIICache::SetCacheCapacity( double sizeInMiB )
   if ( sizeInMiB == this->Capacity )
     return;
 
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
   if ( this->Size > sizeInMiB )
     {
-    this->ReduceToSize( sizeInMiB );
+    this->ReduceToSizeInternal( sizeInMiB, 1 );
     }
 
   this->Capacity =  sizeInMiB < 0 ? 0 : sizeInMiB;
+  g->Lock.Unlock();
+}
+
+void vtkExodusIICache::SetGlobalCacheCapacity( double sizeInMiB )
+{
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  g->Capacity = sizeInMiB < 0 ? 0 : sizeInMiB;
+  vtkExodusIICache::ReduceGlobalSize( 0, 0. );
+  g->Lock.Unlock();
+}
+
+double vtkExodusIICache::GetGlobalCacheCapacity()
+{
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  double capacity = g->Capacity;
+  g->Lock.Unlock();
+  return capacity;
+}
+
+double vtkExodusIICache::GetGlobalCacheSize()
+{
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  double size = g->Size;
+  g->Lock.Unlock();
+  return size;
+}
+
+void vtkExodusIICache::Pin()
+{
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  ++this->PinCount;
+  g->Lock.Unlock();
+}
+
+void vtkExodusIICache::Unpin()
+{
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  if ( this->PinCount > 0 )
+    {
+    --this->PinCount;
+    }
+  g->Lock.Unlock();
+}
+
+void vtkExodusIICache::ResetCounters()
+{
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+  g->Lock.Unlock();
 }
 
 int vtkExodusIICache::ReduceToSize( double newSize )
+{
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
+  int deletedSomething = this->ReduceToSizeInternal( newSize, 1 );
+  g->Lock.Unlock();
+  return deletedSomething;
+}
+
+int vtkExodusIICache::ReduceToSizeInternal( double newSize, int evicting )
 {
   int deletedSomething = 0;
   while ( this->Size > newSize && ! this->LRU.empty() )
     {
     vtkExodusIICacheRef cit( this->LRU.back() );
-    vtkDataArray* arr = cit->second->Value;
-    if ( arr )
+    if ( cit->second->Value )
       {
       deletedSomething = 1;
-      double arrSz = (double) arr->GetActualMemorySize() / 1024.;
-      this->Size -= arrSz;
-#ifdef VTK_EXO_DBG_CACHE
-      cout << "Dropping " << VTK_EXO_PRT_KEY( cit->first ) << VTK_EXO_PRT_ARR( arr ) << "\n";
-#endif // VTK_EXO_DBG_CACHE
-      if ( this->Size <= 0 )
-        {
-        if ( this->Cache.size() == 0 )
-          this->Size = 0.;
-        else
-          this->RecomputeSize(); // oops, FP roundoff
-        }
       }
-    else
+    if ( evicting )
       {
-#ifdef VTK_EXO_DBG_CACHE
-      cout << "Dropping " << VTK_EXO_PRT_KEY( cit->first ) << VTK_EXO_PRT_ARR( arr ) << "\n";
-#endif // VTK_EXO_DBG_CACHE
+      ++this->NumberOfEvictions;
       }
-
-    delete cit->second;
-    this->Cache.erase( cit );
-    this->LRU.pop_back();
+    this->Drop( cit );
     }
 
   if ( this->Cache.size() == 0 )
     {
-    this->Size = 0;
+    this->AddToSize( -this->Size );
     }
 
   return deletedSomething;
 }
 
+void vtkExodusIICache::ReduceGlobalSize( vtkExodusIICache* inserting, double vsize )
+{
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  if ( g->Capacity <= 0. )
+    return;
+
+  while ( g->Size + vsize > g->Capacity )
+    {
+    // Evict from the lowest priority first, and among equal priorities
+    // from the cache holding the least recently used entry.
+    vtkExodusIICache* victim = 0;
+    vtkTypeUInt64 victimUse = 0;
+    vtkstd::set<vtkExodusIICache*>::iterator cit;
+    for ( cit = g->Caches.begin(); cit != g->Caches.end(); ++cit )
+      {
+      vtkExodusIICache* cache = *cit;
+      if ( cache->LRU.empty() || ( cache != inserting && cache->PinCount > 0 ) )
+        continue;
+
+      vtkTypeUInt64 lastUse = cache->LRU.back()->second->LastUse;
+      if ( ! victim || cache->Priority < victim->Priority ||
+        ( cache->Priority == victim->Priority && lastUse < victimUse ) )
+        {
+        victim = cache;
+        victimUse = lastUse;
+        }
+      }
+    if ( ! victim )
+      break;
+
+    ++victim->NumberOfEvictions;
+    victim->Drop( victim->LRU.back() );
+    }
+}
+
 void vtkExodusIICache::Insert( vtkExodusIICacheKey& key, vtkDataArray* value )
 {
   double vsize = value ? value->GetActualMemorySize() / 1024. : 0.;
 
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
   vtkExodusIICacheRef it = this->Cache.find( key );
   if ( it != this->Cache.end() )
     {
     if ( it->second->Value == value )
+      {
+      g->Lock.Unlock();
       return;
+      }
 
     // Remove existing array and put in our new one.
-    this->Size -= vsize;
-    if ( this->Size <= 0 )
-      {
-      this->RecomputeSize();
-      }
-    this->ReduceToSize( this->Capacity - vsize );
-    it->second->Value->Delete();
-    it->second->Value = value;
-    it->second->Value->Register( 0 ); // Since we re-use the cache entry, the constructor's Register won't get called.
-    this->Size += vsize;
 #ifdef VTK_EXO_DBG_CACHE
     cout << "Replacing " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    this->LRU.erase( it->second->LRUEntry );
-    it->second->LRUEntry = this->LRU.insert( this->LRU.begin(), it );
+    this->Drop( it );
     }
-  else
-    {
-    this->ReduceToSize( this->Capacity - vsize );
-    vtkstd::pair<const vtkExodusIICacheKey,vtkExodusIICacheEntry*> entry( key, new vtkExodusIICacheEntry(value) );
-    vtkstd::pair<vtkExodusIICacheSet::iterator, bool> iret = this->Cache.insert( entry );
-    this->Size += vsize;
+
+  this->ReduceToSizeInternal( this->Capacity - vsize, 1 );
+  vtkExodusIICache::ReduceGlobalSize( this, vsize );
+  vtkstd::pair<const vtkExodusIICacheKey,vtkExodusIICacheEntry*> entry( key, new vtkExodusIICacheEntry(value) );
+  vtkstd::pair<vtkExodusIICacheSet::iterator, bool> iret = this->Cache.insert( entry );
+  this->AddToSize( vsize );
 #ifdef VTK_EXO_DBG_CACHE
-    cout << "Adding " << VTK_EXO_PRT_KEY( key ) << VTK_EXO_PRT_ARR( value ) << "\n";
+  cout << "Adding " << VTK_EXO_PRT_KEY( key ) << VTK_EXO_PRT_ARR( value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    iret.first->second->LRUEntry = this->LRU.insert( this->LRU.begin(), iret.first );
-    }
+  iret.first->second->LRUEntry = this->LRU.insert( this->LRU.begin(), iret.first );
+  iret.first->second->LastUse = ++g->Clock;
+  g->Lock.Unlock();
   //printCache( this->Cache, this->LRU );
 }
 
@@ -194,44 +333,37 @@ vtkDataArray*& vtkExodusIICache::Find( vtkExodusIICacheKey key )
 {
   static vtkDataArray* dummy = 0;
 
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
   vtkExodusIICacheRef it = this->Cache.find( key );
   if ( it != this->Cache.end() )
     {
+    ++this->NumberOfHits;
     this->LRU.erase( it->second->LRUEntry );
     it->second->LRUEntry = this->LRU.insert( this->LRU.begin(), it );
+    it->second->LastUse = ++g->Clock;
+    g->Lock.Unlock();
     return it->second->Value;
     }
 
+  ++this->NumberOfMisses;
+  g->Lock.Unlock();
   dummy = 0;
   return dummy;
 }
 
 int vtkExodusIICache::Invalidate( vtkExodusIICacheKey key )
 {
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
   vtkExodusIICacheRef it = this->Cache.find( key );
   if ( it != this->Cache.end() )
     {
-#ifdef VTK_EXO_DBG_CACHE
-    cout << "Dropping " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( it->second->Value ) << "\n";
-#endif // VTK_EXO_DBG_CACHE
-    this->LRU.erase( it->second->LRUEntry );
-    if ( it->second->Value )
-      {
-      this->Size -= it->second->Value->GetActualMemorySize() / 1024.;
-      }
-    delete it->second;
-    this->Cache.erase( it );
-
-    if ( this->Size <= 0 )
-      {
-      if ( this->Cache.size() == 0 )
-        this->Size = 0.;
-      else
-        this->RecomputeSize(); // oops, FP roundoff
-      }
-
+    this->Drop( it );
+    g->Lock.Unlock();
     return 1;
     }
+  g->Lock.Unlock();
   return 0;
 }
 
@@ -239,6 +371,8 @@ int vtkExodusIICache::Invalidate( vtkExodusIICacheKey key, vtkExodusIICacheKey p
 {
   vtkExodusIICacheRef it;
   int nDropped = 0;
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  g->Lock.Lock();
   it = this->Cache.begin();
   while ( it != this->Cache.end() )
     {
@@ -248,40 +382,57 @@ int vtkExodusIICache::Invalidate( vtkExodusIICacheKey key, vtkExodusIICacheKey p
       continue;
       }
 
+    vtkExodusIICacheRef tmpIt = it++;
+    this->Drop( tmpIt );
+    ++nDropped;
+    }
+  g->Lock.Unlock();
+  return nDropped;
+}
+
+void vtkExodusIICache::Drop( vtkExodusIICacheRef it )
+{
 #ifdef VTK_EXO_DBG_CACHE
-    cout << "Dropping " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( it->second->Value ) << "\n";
+  cout << "Dropping " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( it->second->Value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    this->LRU.erase( it->second->LRUEntry );
-    if ( it->second->Value )
-      {
-      this->Size -= it->second->Value->GetActualMemorySize() / 1024.;
-      }
-    vtkExodusIICacheRef tmpIt = it++;
-    delete tmpIt->second;
-    this->Cache.erase( tmpIt );
+  this->LRU.erase( it->second->LRUEntry );
+  if ( it->second->Value )
+    {
+    this->AddToSize( -(double)it->second->Value->GetActualMemorySize() / 1024. );
+    }
+  delete it->second;
+  this->Cache.erase( it );
 
-    if ( this->Size <= 0 )
-      {
-      if ( this->Cache.size() == 0 )
-        this->Size = 0.;
-      else
-        this->RecomputeSize(); // oops, FP roundoff
-      }
+  if ( this->Size <= 0 )
+    {
+    if ( this->Cache.size() == 0 )
+      this->AddToSize( -this->Size );
+    else
+      this->RecomputeSize(); // oops, FP roundoff
+    }
+}
 
-    ++nDropped;
+void vtkExodusIICache::AddToSize( double delta )
+{
+  vtkExodusIICacheGlobals* g = vtkExodusIICacheGetGlobals();
+  this->Size += delta;
+  g->Size += delta;
+  if ( g->Size < 0. )
+    {
+    g->Size = 0.;
     }
-  return nDropped;
 }
 
 void vtkExodusIICache::RecomputeSize()
 {
-  this->Size = 0.;
+  double size = 0.;
   vtkExodusIICacheRef it;
   for ( it = this->Cache.begin(); it != this->Cache.end(); ++it )
     {
     if ( it->second->Value )
       {
-      this->Size += (double)it->second->Value->GetActualMemorySize() / 1024.;
+      size += (double)it->second->Value->GetActualMemorySize() / 1024.;
       }
     }
+  this->AddToSize( size - this->Size );
 }
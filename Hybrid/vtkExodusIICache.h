@@ -22,6 +22,15 @@
 // entries O(1). Each cache entry stores an iterator into
 // the list of references so that it can be located quickly for
 // removal.
+//
+// Besides its own capacity, every cache counts against a global
+// capacity shared by all the caches in the process. When an insertion
+// would exceed it, least recently used entries are dropped from the
+// caches with the lowest priority first, whichever reader they belong
+// to. Caches that are pinned by another thread are left alone, so the
+// arrays a reader is working with are not dropped under it. All cache
+// operations are serialized by a process-wide lock, so readers may
+// fill their caches from background threads.
 
 #include "vtkObject.h"
 
@@ -112,6 +121,8 @@ public:
 protected:
   vtkDataArray* Value;
   vtkExodusIICacheLRURef LRUEntry;
+  /// The global cache clock when the entry was last used.
+  vtkTypeUInt64 LastUse;
 
   friend class vtkExodusIICache;
 };
@@ -169,6 +180,43 @@ public:
   int Invalidate( vtkExodusIICacheKey key, vtkExodusIICacheKey pattern );
   //ETX
 
+  /** Set the capacity shared by all the caches in the process, in MiB.
+    * Entries are dropped from the caches with the lowest priority, least
+    * recently used first, to stay below it. A capacity of 0 (the default)
+    * leaves only the capacity of each cache.
+    */
+  static void SetGlobalCacheCapacity( double sizeInMiB );
+  static double GetGlobalCacheCapacity();
+
+  /// The size of all the caches in the process in MiB.
+  static double GetGlobalCacheSize();
+
+  /** Set the priority of the cache. Entries of caches with a lower
+    * priority are dropped first to stay within the global capacity.
+    * The default is 0.
+    */
+  vtkSetMacro(Priority,int);
+  vtkGetMacro(Priority,int);
+
+  /** Pin the cache while a thread is using arrays returned by Find().
+    * Insertions into other caches do not drop the entries of a pinned
+    * cache. Calls must be balanced by Unpin().
+    */
+  void Pin();
+  void Unpin();
+
+  /// The number of calls to Find() that found an entry.
+  vtkGetMacro(NumberOfHits,vtkIdType);
+
+  /// The number of calls to Find() that found nothing.
+  vtkGetMacro(NumberOfMisses,vtkIdType);
+
+  /// The number of entries dropped to make room for new ones, by this cache or by others.
+  vtkGetMacro(NumberOfEvictions,vtkIdType);
+
+  /// Reset the hit, miss and eviction counts.
+  void ResetCounters();
+
 protected:
   /// Default constructor
   vtkExodusIICache();
@@ -180,6 +228,30 @@ protected:
   /// Avoid (some) FP problems
   void RecomputeSize();
 
+  /// Change the size of this cache and of all caches. The lock must be held.
+  void AddToSize( double delta );
+
+  /// ReduceToSize() with the lock held.
+  int ReduceToSizeInternal( double newSize, int evicting );
+
+  /// Invalidate() with the lock held.
+  void Drop( vtkExodusIICacheRef it );
+
+  /** Drop entries of the unpinned caches until the global size leaves room for the given size.
+    * The entries of \a inserting are candidates even when it is pinned. The lock must be held.
+    */
+  static void ReduceGlobalSize( vtkExodusIICache* inserting, double vsize );
+
+  /// The priority used to pick the caches to drop entries from.
+  int Priority;
+
+  /// The number of Pin() calls not yet balanced by Unpin().
+  int PinCount;
+
+  vtkIdType NumberOfHits;
+  vtkIdType NumberOfMisses;
+  vtkIdType NumberOfEvictions;
+
   /// The capacity of the cache (i.e., the maximum size of all arrays it contains) in MiB.
   double Capacity;
 
@@ -22,15 +22,18 @@
 #include "vtkCellData.h"
 #include "vtkCellType.h"
 #include "vtkCharArray.h"
+#include "vtkCriticalSection.h"
 #include "vtkDoubleArray.h"
 #include "vtkExodusModel.h"
 #include "vtkFloatArray.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
+#include "vtkInformationIdTypeKey.h"
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
 #include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
 #include "vtkMutableDirectedGraph.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
@@ -362,6 +365,12 @@ vtkExodusIIReaderPrivate::vtkExodusIIReaderPrivate()
   this->DiskWordSize = 8;
 
   this->Cache = vtkExodusIICache::New();
+  this->CacheSize = 0.;
+  this->PrefetchNextTimeStep = 0;
+  this->PrefetchStep = -1;
+  this->Prefetching = 0;
+  this->Threader = 0;
+  this->PrefetchThreadId = -1;
 
   this->TimeStep = 0;
   this->HasModeShapes = 0;
@@ -397,6 +406,11 @@ vtkExodusIIReaderPrivate::vtkExodusIIReaderPrivate()
 //-----------------------------------------------------------------------------
 vtkExodusIIReaderPrivate::~vtkExodusIIReaderPrivate()
 {
+  this->FinishPrefetch();
+  if ( this->Threader )
+    {
+    this->Threader->Delete();
+    }
   this->CloseFile();
   this->Cache->Delete();
   this->ClearConnectivityCaches();
@@ -1500,6 +1514,13 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
     arr = this->Cache->Find( key );
     }
 
+  // Remember the time-varying arrays of the requested step so that the
+  // same arrays can be read for the next step in the background.
+  if ( key.Time >= 0 && key.Time == this->PrefetchStep && ! this->Prefetching )
+    {
+    this->PrefetchKeys.insert( key );
+    }
+
   if ( arr )
     {
     //
@@ -3337,6 +3358,10 @@ void vtkExodusIIReader::PrintSelf( ostream& os, vtkIndent indent )
   os << indent << "ExodusModel: " << this->ExodusModel << "\n";
   os << indent << "SILUpdateStamp: " << this->SILUpdateStamp << "\n";
   os << indent << "ProducedFastPathOutput: " << this->ProducedFastPathOutput << "\n";
+  os << indent << "CacheSize: " << this->GetCacheSize() << " MiB\n";
+  os << indent << "CachePriority: " << this->GetCachePriority() << "\n";
+  os << indent << "GlobalCacheSize: " << vtkExodusIIReader::GetGlobalCacheSize() << " MiB\n";
+  os << indent << "PrefetchNextTimeStep: " << this->GetPrefetchNextTimeStep() << "\n";
   if ( this->Metadata )
     {
     os << indent << "Metadata:\n";
@@ -3457,6 +3482,8 @@ void vtkExodusIIReaderPrivate::PrintData( ostream& os, vtkIndent indent )
 
   os << indent << "Array Cache:\n";
   this->Cache->PrintSelf( os, inden2 );
+  os << indent << "CacheSize: " << this->CacheSize << " MiB\n";
+  os << indent << "PrefetchNextTimeStep: " << this->PrefetchNextTimeStep << "\n";
 
   os << indent << "SqueezePoints: " << this->SqueezePoints << "\n";
   os << indent << "ApplyDisplacements: " << this->ApplyDisplacements << "\n";
@@ -4549,6 +4576,10 @@ int vtkExodusIIReaderPrivate::RequestData( vtkIdType timeStep, vtkMultiBlockData
     vtkErrorMacro( "You must specify an output mesh" );
     }
 
+  this->PrefetchKeys.clear();
+  this->PrefetchStep =
+    ( this->PrefetchNextTimeStep && ! this->HasModeShapes && this->CacheSize > 0. ) ? timeStep : -1;
+
   // Iterate over all block and set types, creating a
   // multiblock dataset to hold objects of each type.
   int conntypidx;
@@ -4773,6 +4804,7 @@ int vtkExodusIIReaderPrivate::SetUpEmptyGrid( vtkMultiBlockDataSet* output )
 
 void vtkExodusIIReaderPrivate::Reset()
 {
+  this->FinishPrefetch();
   this->CloseFile();
   this->ResetCache(); // must come before BlockInfo and SetInfo are cleared.
   this->BlockInfo.clear();
@@ -4822,15 +4854,95 @@ void vtkExodusIIReaderPrivate::ResetSettings()
   this->FastPathObjectType = vtkExodusIIReader::NODAL;
   this->FastPathObjectId = -1;
   this->SetFastPathIdType( 0 );
+
+  this->PrefetchNextTimeStep = 0;
+  this->Cache->SetPriority( 0 );
+  this->SetCacheSize( 0. );
 }
 
 void vtkExodusIIReaderPrivate::ResetCache()
 {
+  this->FinishPrefetch();
   this->Cache->Clear();
-  this->Cache->SetCacheCapacity( 0.0 ); // FIXME: Perhaps Cache should have a Reset and a Clear method?  
+  this->Cache->SetCacheCapacity( this->CacheSize ); // FIXME: Perhaps Cache should have a Reset and a Clear method?  
   this->ClearConnectivityCaches();
 }
 
+void vtkExodusIIReaderPrivate::SetCacheSize( double sizeInMiB )
+{
+  if ( sizeInMiB < 0. )
+    {
+    sizeInMiB = 0.;
+    }
+  if ( sizeInMiB == this->CacheSize )
+    {
+    return;
+    }
+  this->FinishPrefetch();
+  this->CacheSize = sizeInMiB;
+  this->Cache->SetCacheCapacity( sizeInMiB );
+}
+
+//-----------------------------------------------------------------------------
+// Serializes the calls into the Exodus and netCDF libraries, which are not
+// thread safe, between all the readers and their background reads.
+static vtkSimpleCriticalSection vtkExodusIIReaderIOLock;
+
+static VTK_THREAD_RETURN_TYPE vtkExodusIIReaderPrefetch( void* arg )
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+  static_cast<vtkExodusIIReaderPrivate*>( info->UserData )->Prefetch();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+void vtkExodusIIReaderPrivate::StartPrefetch( const char* filename )
+{
+  this->FinishPrefetch();
+  if ( this->PrefetchStep < 0 || this->PrefetchKeys.empty() || ! filename ||
+    this->PrefetchStep + 1 >= static_cast<int>( this->Times.size() ) )
+    {
+    return;
+    }
+
+  if ( ! this->Threader )
+    {
+    this->Threader = vtkMultiThreader::New();
+    }
+  this->PrefetchFileName = filename;
+  this->PrefetchThreadId = this->Threader->SpawnThread( vtkExodusIIReaderPrefetch, this );
+}
+
+void vtkExodusIIReaderPrivate::FinishPrefetch()
+{
+  if ( this->PrefetchThreadId >= 0 )
+    {
+    this->Threader->TerminateThread( this->PrefetchThreadId );
+    this->PrefetchThreadId = -1;
+    }
+}
+
+void vtkExodusIIReaderPrivate::Prefetch()
+{
+  vtkExodusIIReaderIOLock.Lock();
+  this->Cache->Pin();
+  this->Prefetching = 1;
+  if ( this->OpenFile( this->PrefetchFileName.c_str() ) )
+    {
+    vtkstd::set<vtkExodusIICacheKey>::iterator it;
+    for ( it = this->PrefetchKeys.begin(); it != this->PrefetchKeys.end(); ++it )
+      {
+      vtkExodusIICacheKey key( *it );
+      key.Time = this->PrefetchStep + 1;
+      // The cache keeps the array alive.
+      this->GetCacheOrRead( key );
+      }
+    this->CloseFile();
+    }
+  this->Prefetching = 0;
+  this->Cache->Unpin();
+  vtkExodusIIReaderIOLock.Unlock();
+}
+
 bool vtkExodusIIReaderPrivate::IsXMLMetadataValid()
 {
   // Make sure that each block id referred to in the metadata arrays exist
@@ -5317,6 +5429,9 @@ vtkDataArray* vtkExodusIIReaderPrivate::FindDisplacementVectors( int timeStep )
 vtkStandardNewMacro(vtkExodusIIReader);
 vtkCxxSetObjectMacro(vtkExodusIIReader,Metadata,vtkExodusIIReaderPrivate);
 vtkCxxSetObjectMacro(vtkExodusIIReader,ExodusModel,vtkExodusModel);
+vtkInformationKeyMacro(vtkExodusIIReader,CACHE_HITS,IdType);
+vtkInformationKeyMacro(vtkExodusIIReader,CACHE_MISSES,IdType);
+vtkInformationKeyMacro(vtkExodusIIReader,CACHE_EVICTIONS,IdType);
 
 vtkExodusIIReader::vtkExodusIIReader()
 {
@@ -5453,6 +5568,9 @@ int vtkExodusIIReader::ProcessRequest(vtkInformation* request,
                                         vtkInformationVector** inputVector,
                                         vtkInformationVector* outputVector)
 {
+  // Wait for the background read of the cache before touching the file.
+  this->Metadata->FinishPrefetch();
+
   if(request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
     {
     return this->RequestData(request, inputVector, outputVector);
@@ -5480,6 +5598,7 @@ int vtkExodusIIReader::RequestInformation(
   // If the metadata is older than the filename
   if ( this->GetMetadataMTime() < this->FileNameMTime )
     {
+    vtkExodusIIReaderIOLock.Lock();
     if ( this->Metadata->OpenFile( this->FileName ) )
       {
       // We need to initialize the XML parser before calling RequestInformation
@@ -5517,10 +5636,12 @@ int vtkExodusIIReader::RequestInformation(
       this->SILUpdateStamp++; // update the timestamp.
 
       this->Metadata->CloseFile();
+      vtkExodusIIReaderIOLock.Unlock();
       newMetadata = 1;
       }
     else
       {
+      vtkExodusIIReaderIOLock.Unlock();
       vtkErrorMacro( "Unable to open file \"" << (this->FileName ? this->FileName : "(null)") << "\" to read metadata" );
       return 0;
       }
@@ -5545,8 +5666,10 @@ int vtkExodusIIReader::RequestData(
   vtkInformationVector* outputVector )
 {
   this->ProducedFastPathOutput = false;
+  vtkExodusIIReaderIOLock.Lock();
   if ( ! this->FileName || ! this->Metadata->OpenFile( this->FileName ) )
     {
+    vtkExodusIIReaderIOLock.Unlock();
     vtkErrorMacro( "Unable to open file \"" << (this->FileName ? this->FileName : "(null)") << "\" to read data" );
     return 0;
     }
@@ -5632,6 +5755,7 @@ int vtkExodusIIReader::RequestData(
 
   //cout << "Requesting step " << this->TimeStep << " for output " << output << "\n";
   this->Metadata->RequestData( this->TimeStep, output );
+  vtkExodusIIReaderIOLock.Unlock();
   this->ProducedFastPathOutput = this->Metadata->ProducedFastPathOutput;
 
   // Restore previous fastpath values so we don't respond to old pipeline requests
@@ -5643,6 +5767,13 @@ int vtkExodusIIReader::RequestData(
     delete [] oldFastPathIdType;
     }
 
+  vtkExodusIICache* cache = this->Metadata->Cache;
+  output->GetInformation()->Set( vtkExodusIIReader::CACHE_HITS(), cache->GetNumberOfHits() );
+  output->GetInformation()->Set( vtkExodusIIReader::CACHE_MISSES(), cache->GetNumberOfMisses() );
+  output->GetInformation()->Set( vtkExodusIIReader::CACHE_EVICTIONS(), cache->GetNumberOfEvictions() );
+
+  // Read the next time step while the pipeline works on this one.
+  this->Metadata->StartPrefetch( this->FileName );
 
   return 1;
 }
@@ -6595,8 +6726,50 @@ void vtkExodusIIReader::ResetCache()
   this->Metadata->ResetCache();
 }
 
+void vtkExodusIIReader::SetCacheSize( double sizeInMiB )
+{
+  this->Metadata->SetCacheSize( sizeInMiB );
+}
+
+double vtkExodusIIReader::GetCacheSize()
+{
+  return this->Metadata->GetCacheSize();
+}
+
+void vtkExodusIIReader::SetCachePriority( int priority )
+{
+  this->Metadata->Cache->SetPriority( priority );
+}
+
+int vtkExodusIIReader::GetCachePriority()
+{
+  return this->Metadata->Cache->GetPriority();
+}
+
+void vtkExodusIIReader::SetGlobalCacheSize( double sizeInMiB )
+{
+  vtkExodusIICache::SetGlobalCacheCapacity( sizeInMiB );
+}
+
+double vtkExodusIIReader::GetGlobalCacheSize()
+{
+  return vtkExodusIICache::GetGlobalCacheCapacity();
+}
+
+void vtkExodusIIReader::SetPrefetchNextTimeStep( int prefetch )
+{
+  this->Metadata->SetPrefetchNextTimeStep( prefetch );
+}
+
+int vtkExodusIIReader::GetPrefetchNextTimeStep()
+{
+  return this->Metadata->GetPrefetchNextTimeStep();
+}
+
 void vtkExodusIIReader::UpdateTimeInformation()
 {
+  this->Metadata->FinishPrefetch();
+  vtkExodusIIReaderIOLock.Lock();
   if ( this->Metadata->OpenFile( this->FileName ) )
     {
     this->Metadata->UpdateTimeInformation();
@@ -6612,5 +6785,6 @@ void vtkExodusIIReader::UpdateTimeInformation()
       }
     this->Metadata->CloseFile();
     }
+  vtkExodusIIReaderIOLock.Unlock();
 }
 
@@ -44,6 +44,7 @@ class vtkExodusIIReaderPrivate;
 class vtkExodusModel;
 class vtkFloatArray;
 class vtkGraph;
+class vtkInformationIdTypeKey;
 class vtkIntArray;
 class vtkPoints;
 class vtkUnstructuredGrid;
@@ -692,6 +693,47 @@ public:
   // Clears out the cache entries.
   void ResetCache();
 
+  // Description:
+  // Set the size of the array cache of this reader in MiB.  Arrays read
+  // from the file are kept for later requests until the cache is full,
+  // then the least recently used arrays are dropped.  The default of 0
+  // keeps only the last array read.
+  void SetCacheSize( double sizeInMiB );
+  double GetCacheSize();
+
+  // Description:
+  // Set the priority of the array cache of this reader.  When the global
+  // cache size is reached, arrays are dropped from the readers with the
+  // lowest priority first.  The default is 0.
+  void SetCachePriority( int priority );
+  int GetCachePriority();
+
+  // Description:
+  // Set the size in MiB that the array caches of all the Exodus readers
+  // in the process may use together.  The default of 0 leaves only the
+  // cache size of each reader.
+  static void SetGlobalCacheSize( double sizeInMiB );
+  static double GetGlobalCacheSize();
+
+  // Description:
+  // When on, the time-varying arrays read for a time step are read for
+  // the next time step on a background thread after RequestData returns,
+  // so that stepping forward in time finds them in the cache.  The cache
+  // size must be large enough to hold the arrays of two time steps.  The
+  // readers of a process access files one at a time, so another reader
+  // waits for the background read to finish.  Off by default.
+  void SetPrefetchNextTimeStep( int prefetch );
+  int GetPrefetchNextTimeStep();
+  vtkBooleanMacro(PrefetchNextTimeStep,int);
+
+  // Description:
+  // The number of array cache hits, misses and evictions of the reader
+  // since it was created, set on the information of the output data
+  // object after each update.
+  static vtkInformationIdTypeKey* CACHE_HITS();
+  static vtkInformationIdTypeKey* CACHE_MISSES();
+  static vtkInformationIdTypeKey* CACHE_EVICTIONS();
+
   // Description:
   // Re-reads time information from the exodus file and updates
   // TimeStepRange accordingly.
@@ -15,11 +15,14 @@ class vtkMultiProcessController;
 #include "vtksys/RegularExpression.hxx"
 
 #include <vtkstd/map>
+#include <vtkstd/set>
+#include <vtkstd/string>
 #include <vtkstd/vector>
 
 #include "vtk_exodusII.h"
 
 class vtkExodusIIReaderParser;
+class vtkMultiThreader;
 class vtkMutableDirectedGraph;
 
 /** This class holds metadata for an Exodus file.
@@ -83,6 +86,31 @@ public:
   /// Clears out any data in the cache and restores it to its initial state.
   void ResetCache();
 
+  /** Set the capacity of the array cache in MiB.
+    * ResetCache() restores the cache to this capacity.
+    */
+  void SetCacheSize( double sizeInMiB );
+  double GetCacheSize() { return this->CacheSize; }
+
+  /** Should the arrays read for a time step be read for the next time step
+    * on a background thread once RequestData() returns?
+    * The cache must be large enough to hold the arrays of a time step.
+    */
+  void SetPrefetchNextTimeStep( int prefetch ) { this->PrefetchNextTimeStep = prefetch; }
+  int GetPrefetchNextTimeStep() { return this->PrefetchNextTimeStep; }
+
+  /** Start reading the arrays of the time step after the one last
+    * requested into the cache on a background thread.
+    * Does nothing unless PrefetchNextTimeStep is on.
+    */
+  void StartPrefetch( const char* filename );
+
+  /// Wait for the background read started by StartPrefetch() to finish.
+  void FinishPrefetch();
+
+  /// The body of the background read. Do not call it directly.
+  void Prefetch();
+
   /** Return the number of time steps in the open file.
     * You must have called RequestInformation() before 
     * invoking this member function.
@@ -791,6 +819,32 @@ protected:
   /// A least-recently-used cache to hold raw arrays.
   vtkExodusIICache* Cache;
 
+  /// The capacity of the cache set by ResetCache().
+  double CacheSize;
+
+  /// Read the arrays of the next time step in the background?
+  int PrefetchNextTimeStep;
+
+  /** The time step whose cache keys are recorded in PrefetchKeys,
+    * or -1 when no prefetch will follow the current request.
+    */
+  int PrefetchStep;
+
+  /// The keys of the time-varying arrays read for PrefetchStep.
+  vtkstd::set<vtkExodusIICacheKey> PrefetchKeys;
+
+  /// The file read by the background thread.
+  vtkstd::string PrefetchFileName;
+
+  /// Non-zero while the background thread is reading.
+  int Prefetching;
+
+  /// Runs the background read.
+  vtkMultiThreader* Threader;
+
+  /// The thread running the background read, or -1.
+  int PrefetchThreadId;
+
   int ApplyDisplacements;
   float DisplacementMagnitude;
   int HasModeShapes;
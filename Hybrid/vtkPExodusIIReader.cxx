@@ -594,6 +594,9 @@ int vtkPExodusIIReader::RequestData(
     this->ReaderList[reader_idx]->SetDisplacementMagnitude( this->GetDisplacementMagnitude() );
     this->ReaderList[reader_idx]->SetHasModeShapes( this->GetHasModeShapes() );
     this->ReaderList[reader_idx]->SetAnimateModeShapes( this->GetAnimateModeShapes() );
+    this->ReaderList[reader_idx]->SetCacheSize( this->GetCacheSize() );
+    this->ReaderList[reader_idx]->SetCachePriority( this->GetCachePriority() );
+    this->ReaderList[reader_idx]->SetPrefetchNextTimeStep( this->GetPrefetchNextTimeStep() );
 
     this->ReaderList[reader_idx]->SetExodusModelMetadata( this->ExodusModelMetadata );
     // For now, this *must* come last before the UpdateInformation() call because its MTime is compared to the metadata's MTime,
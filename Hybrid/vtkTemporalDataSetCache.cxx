@@ -15,13 +15,92 @@
 #include "vtkTemporalDataSetCache.h"
 
 #include "vtkTemporalDataSet.h"
+#include "vtkAlgorithmOutput.h"
+#include "vtkCompositeDataPipeline.h"
+#include "vtkGarbageCollector.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vtkstd/algorithm>
 #include <vtkstd/vector>
 
+#include <math.h>
+
+//----------------------------------------------------------------------------
+// The executive of the cache.  It starts the prefetch once the cache has
+// executed and nothing in the pipeline uses the input information anymore,
+// and waits for it before any request passes through the cache.
+class vtkTemporalDataSetCachePipeline : public vtkCompositeDataPipeline
+{
+public:
+  static vtkTemporalDataSetCachePipeline* New();
+  vtkTypeMacro(vtkTemporalDataSetCachePipeline,vtkCompositeDataPipeline);
+
+  virtual int ProcessRequest(vtkInformation* request,
+                             vtkInformationVector** inInfoVec,
+                             vtkInformationVector* outInfoVec)
+    {
+    this->FinishPrefetch();
+    return this->Superclass::ProcessRequest(request, inInfoVec, outInfoVec);
+    }
+
+  virtual int ComputePipelineMTime(vtkInformation* request,
+                                   vtkInformationVector** inInfoVec,
+                                   vtkInformationVector* outInfoVec,
+                                   int requestFromOutputPort,
+                                   unsigned long* mtime)
+    {
+    this->FinishPrefetch();
+    return this->Superclass::ComputePipelineMTime(
+      request, inInfoVec, outInfoVec, requestFromOutputPort, mtime);
+    }
+
+  static VTK_THREAD_RETURN_TYPE PrefetchThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    static_cast<vtkTemporalDataSetCache*>(info->UserData)->ExecutePrefetch();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+protected:
+  vtkTemporalDataSetCachePipeline() {}
+
+  virtual int ExecuteData(vtkInformation* request,
+                          vtkInformationVector** inInfoVec,
+                          vtkInformationVector* outInfoVec)
+    {
+    int result = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+    vtkTemporalDataSetCache* cache =
+      vtkTemporalDataSetCache::SafeDownCast(this->GetAlgorithm());
+    if (cache && result)
+      {
+      cache->StartPrefetch();
+      }
+    return result;
+    }
+
+  void FinishPrefetch()
+    {
+    vtkTemporalDataSetCache* cache =
+      vtkTemporalDataSetCache::SafeDownCast(this->GetAlgorithm());
+    if (cache)
+      {
+      cache->FinishPrefetch(0);
+      }
+    }
+
+private:
+  vtkTemporalDataSetCachePipeline(const vtkTemporalDataSetCachePipeline&);  // Not implemented.
+  void operator=(const vtkTemporalDataSetCachePipeline&);  // Not implemented.
+};
+
+vtkStandardNewMacro(vtkTemporalDataSetCachePipeline);
+
 //---------------------------------------------------------------------------
 vtkStandardNewMacro(vtkTemporalDataSetCache);
 
@@ -29,11 +108,27 @@ vtkStandardNewMacro(vtkTemporalDataSetCache);
 vtkTemporalDataSetCache::vtkTemporalDataSetCache()
 {
   this->CacheSize = 10;
+  this->Prefetch = 0;
+  this->PrefetchDepth = 1;
+  this->PrefetchMemoryLimit = 0;
+  this->LastRequestIndex = -1;
+  this->Threader = 0;
+  this->PrefetchThreadId = -1;
+  this->AbortPrefetch = 0;
+  this->PrefetchLock = vtkMutexLock::New();
+  this->PrefetchExecutive = 0;
+  this->PrefetchPort = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkTemporalDataSetCache::~vtkTemporalDataSetCache()
 {
+  this->FinishPrefetch(1);
+  if (this->Threader)
+    {
+    this->Threader->Delete();
+    }
+  this->PrefetchLock->Delete();
   CacheType::iterator pos = this->Cache.begin();
   for (; pos != this->Cache.end();)
     {
@@ -58,6 +153,38 @@ void vtkTemporalDataSetCache::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "CacheSize: " << this->CacheSize << endl;
+  os << indent << "Prefetch: " << this->Prefetch << endl;
+  os << indent << "PrefetchDepth: " << this->PrefetchDepth << endl;
+  os << indent << "PrefetchMemoryLimit: " << this->PrefetchMemoryLimit << endl;
+}
+
+//----------------------------------------------------------------------------
+vtkExecutive* vtkTemporalDataSetCache::CreateDefaultExecutive()
+{
+  return vtkTemporalDataSetCachePipeline::New();
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::SetPrefetch(int prefetch)
+{
+  // Not a pipeline change, the cached data stay valid.
+  this->FinishPrefetch(1);
+  this->Prefetch = prefetch;
+  this->LastRequestIndex = -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::SetPrefetchDepth(int depth)
+{
+  this->FinishPrefetch(1);
+  this->PrefetchDepth = depth < 1 ? 1 : depth;
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::SetPrefetchMemoryLimit(unsigned long limit)
+{
+  this->FinishPrefetch(1);
+  this->PrefetchMemoryLimit = limit;
 }
 //----------------------------------------------------------------------------
 void vtkTemporalDataSetCache::SetCacheSize(int size)
@@ -67,6 +194,7 @@ void vtkTemporalDataSetCache::SetCacheSize(int size)
     vtkErrorMacro("Attempt to set cache size to less than 1");
     return;
     }
+  this->FinishPrefetch(1);
 
   // if growing the cache, there is no need to do anything
   this->CacheSize = size;
@@ -218,6 +346,10 @@ int vtkTemporalDataSetCache::RequestData(
   vtkInformationVector **inputVector,
   vtkInformationVector *outputVector)
 {
+  // The executive of the cache has already waited for the prefetch, but
+  // another executive may have been set meanwhile.
+  this->FinishPrefetch(0);
+
   vtkInformation      *inInfo = inputVector[0]->GetInformationObject(0);
   vtkInformation     *outInfo = outputVector->GetInformationObject(0);
   vtkDataObject       *output = outInfo->Get(vtkDataObject::DATA_OBJECT());
@@ -356,5 +488,244 @@ int vtkTemporalDataSetCache::RequestData(
         }
       }
     }
+
+  // Predict the next requests from the direction and stride of the last
+  // two, for the executive to prefetch once this request is complete.
+  this->PrefetchTimes.clear();
+  this->RequestedTimes.assign(upTimes, upTimes + numUpTimes);
+  int numSteps = inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  if (this->Prefetch && numUpTimes > 0 && numSteps > 0)
+    {
+    double *steps = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    int index = 0;
+    for (i = 1; i < numSteps; ++i)
+      {
+      if (fabs(steps[i] - upTimes[0]) < fabs(steps[index] - upTimes[0]))
+        {
+        index = i;
+        }
+      }
+    int stride = 1;
+    if (this->LastRequestIndex >= 0 && this->LastRequestIndex != index)
+      {
+      stride = index - this->LastRequestIndex;
+      }
+    this->LastRequestIndex = index;
+
+    // Consumers such as interpolators ask for consecutive steps at once.
+    for (int k = 1; k <= this->PrefetchDepth; ++k)
+      {
+      for (i = 0; i < numUpTimes; ++i)
+        {
+        int next = index + stride * k + i;
+        if (next < 0 || next >= numSteps ||
+            this->Cache.find(steps[next]) != this->Cache.end() ||
+            vtkstd::find(this->PrefetchTimes.begin(), this->PrefetchTimes.end(),
+                         steps[next]) != this->PrefetchTimes.end())
+          {
+          continue;
+          }
+        this->PrefetchTimes.push_back(steps[next]);
+        }
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::SetReleaseDataFlag(int release)
+{
+  this->FinishPrefetch(1);
+  this->Superclass::SetReleaseDataFlag(release);
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::RegisterInternal(vtkObjectBase* o, int check)
+{
+  if (!check && o && o->IsA("vtkGarbageCollector"))
+    {
+    this->JoinPrefetch(1);
+    }
+  this->Superclass::RegisterInternal(o, check);
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::ReportReferences(vtkGarbageCollector* collector)
+{
+  this->Superclass::ReportReferences(collector);
+  vtkGarbageCollectorReport(collector, this->PrefetchExecutive,
+                            "PrefetchExecutive");
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::StartPrefetch()
+{
+  if (this->PrefetchTimes.empty() || this->GetNumberOfInputConnections(0) < 1)
+    {
+    return;
+    }
+  vtkAlgorithmOutput* conn = this->GetInputConnection(0, 0);
+  vtkStreamingDemandDrivenPipeline* sddp = conn ?
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(
+      conn->GetProducer()->GetExecutive()) : 0;
+  if (!sddp)
+    {
+    return;
+    }
+
+  // Keep the producer for the thread, the connection may change meanwhile.
+  this->PrefetchExecutive = sddp;
+  this->PrefetchExecutive->Register(this);
+  this->PrefetchPort = conn->GetIndex();
+  if (!this->Threader)
+    {
+    this->Threader = vtkMultiThreader::New();
+    }
+  this->AbortPrefetch = 0;
+  this->PrefetchThreadId = this->Threader->SpawnThread(
+    vtkTemporalDataSetCachePipeline::PrefetchThread, this);
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::FinishPrefetch(int abort)
+{
+  this->JoinPrefetch(abort);
+  if (this->PrefetchExecutive)
+    {
+    this->PrefetchExecutive->UnRegister(this);
+    this->PrefetchExecutive = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::JoinPrefetch(int abort)
+{
+  if (this->PrefetchThreadId >= 0)
+    {
+    this->PrefetchLock->Lock();
+    this->AbortPrefetch = abort;
+    this->PrefetchLock->Unlock();
+    int id = this->PrefetchThreadId;
+    this->PrefetchThreadId = -1;
+    this->Threader->TerminateThread(id);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::ExecutePrefetch()
+{
+  vtkStreamingDemandDrivenPipeline* sddp = this->PrefetchExecutive;
+  int port = this->PrefetchPort;
+
+  vtkstd::vector<double>::iterator it;
+  for (it = this->PrefetchTimes.begin(); it != this->PrefetchTimes.end(); ++it)
+    {
+    this->PrefetchLock->Lock();
+    int abort = this->AbortPrefetch;
+    this->PrefetchLock->Unlock();
+    if (abort)
+      {
+      break;
+      }
+    double time = *it;
+    if (this->Cache.find(time) != this->Cache.end())
+      {
+      continue;
+      }
+    if (!this->MakeRoomForPrefetch())
+      {
+      break;
+      }
+
+    // Ask for the time step the way the cache input does, so that a
+    // composite producer keeps its temporal output.
+    vtkInformation *info = sddp->GetOutputInformation(port);
+    sddp->SetUpdateTimeSteps(port, &time, 1);
+    info->Set(vtkCompositeDataPipeline::REQUIRES_TIME_DOWNSTREAM(), 1);
+    int result = sddp->Update(port);
+    info->Remove(vtkCompositeDataPipeline::REQUIRES_TIME_DOWNSTREAM());
+    if (!result)
+      {
+      break;
+      }
+    vtkDataObject *dobj = sddp->GetOutputData(port);
+    if (!dobj)
+      {
+      break;
+      }
+
+    double *times = dobj->GetInformation()->Get(vtkDataObject::DATA_TIME_STEPS());
+    int numTimes = dobj->GetInformation()->Length(vtkDataObject::DATA_TIME_STEPS());
+    vtkTemporalDataSet *temporal = vtkTemporalDataSet::SafeDownCast(dobj);
+    for (int j = 0; j < numTimes; ++j)
+      {
+      if (this->Cache.find(times[j]) != this->Cache.end())
+        {
+        continue;
+        }
+      vtkDataObject *step;
+      if (temporal)
+        {
+        step = temporal->GetTimeStep(j);
+        if (!step)
+          {
+          continue;
+          }
+        step->Register(this);
+        }
+      else
+        {
+        // The producer reuses its output, so keep a copy.
+        step = dobj->NewInstance();
+        step->ShallowCopy(dobj);
+        }
+      this->Cache[times[j]] =
+        vtkstd::pair<unsigned long, vtkDataObject *>(dobj->GetUpdateTime(), step);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkTemporalDataSetCache::MakeRoomForPrefetch()
+{
+  CacheType::iterator pos;
+  if (this->PrefetchMemoryLimit > 0)
+    {
+    unsigned long size = 0;
+    for (pos = this->Cache.begin(); pos != this->Cache.end(); ++pos)
+      {
+      size += pos->second.second->GetActualMemorySize();
+      }
+    if (size >= this->PrefetchMemoryLimit)
+      {
+      return 0;
+      }
+    }
+
+  // get rid of the oldest data that was not just requested
+  while (this->Cache.size() >= static_cast<unsigned long>(this->CacheSize))
+    {
+    CacheType::iterator oldestpos = this->Cache.end();
+    for (pos = this->Cache.begin(); pos != this->Cache.end(); ++pos)
+      {
+      if (vtkstd::find(this->RequestedTimes.begin(), this->RequestedTimes.end(),
+                       pos->first) != this->RequestedTimes.end())
+        {
+        continue;
+        }
+      if (oldestpos == this->Cache.end() ||
+          pos->second.first < oldestpos->second.first)
+        {
+        oldestpos = pos;
+        }
+      }
+    if (oldestpos == this->Cache.end())
+      {
+      return 0;
+      }
+    oldestpos->second.second->UnRegister(this);
+    this->Cache.erase(oldestpos);
+    }
   return 1;
 }
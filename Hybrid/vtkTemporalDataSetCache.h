@@ -16,6 +16,17 @@
 // .SECTION Description
 // vtkTemporalDataSetCache cache time step requests of a temporal dataset,
 // when cached data is requested it is returned using a shallow copy.
+//
+// With Prefetch on, the cache predicts the next time steps from the
+// direction and stride of the last two requests and, once it has
+// executed, updates its input for them on a background thread.  The
+// pipeline downstream of the cache (e.g. rendering) thus overlaps with
+// the reading of the next time steps.  Any request reaching the cache
+// waits for the background update to finish, changing the cache settings
+// or deleting the pipeline stops it after the time step being read.  The
+// input must not be
+// updated through another consumer while prefetching, and the observers
+// of the upstream algorithms are invoked from the background thread.
 // .SECTION Thanks
 // Ken Martin (Kitware) and John Bidiscombe of 
 // CSCS - Swiss National Supercomputing Centre
@@ -31,6 +42,11 @@
 #include "vtkTemporalDataSetAlgorithm.h"
 
 #include <vtkstd/map> // used for the cache
+#include <vtkstd/vector> // used for the prefetched times
+
+class vtkMultiThreader;
+class vtkMutexLock;
+class vtkStreamingDemandDrivenPipeline;
 
 class VTK_HYBRID_EXPORT vtkTemporalDataSetCache : public vtkTemporalDataSetAlgorithm
 {
@@ -45,18 +61,94 @@ public:
   void SetCacheSize(int size);
   vtkGetMacro(CacheSize,int);
 
+  // Description:
+  // Turn on/off reading the next time steps into the cache on a
+  // background thread after each update.  Off by default.  Changing the
+  // prefetch settings does not invalidate the cache.
+  void SetPrefetch(int prefetch);
+  vtkGetMacro(Prefetch,int);
+  vtkBooleanMacro(Prefetch,int);
+
+  // Description:
+  // The number of requests to read ahead.  It defaults to 1.
+  void SetPrefetchDepth(int depth);
+  vtkGetMacro(PrefetchDepth,int);
+
+  // Description:
+  // Stop prefetching once the cached time steps use this many kilobytes.
+  // It defaults to 0, which leaves only CacheSize as a limit.
+  void SetPrefetchMemoryLimit(unsigned long limit);
+  vtkGetMacro(PrefetchMemoryLimit,unsigned long);
+
+  // Description:
+  // Releasing the data of the cache output stops the prefetch first.
+  virtual void SetReleaseDataFlag(int);
+
 protected:
   vtkTemporalDataSetCache();
   ~vtkTemporalDataSetCache();
 
   int CacheSize;
+  int Prefetch;
+  int PrefetchDepth;
+  unsigned long PrefetchMemoryLimit;
 
 //BTX
   typedef vtkstd::map<double,vtkstd::pair<unsigned long,vtkDataObject *> >
   CacheType;
   CacheType Cache;
+
+  // The times of the last request, and the input times to prefetch.
+  vtkstd::vector<double> RequestedTimes;
+  vtkstd::vector<double> PrefetchTimes;
 //ETX
 
+  // The index in the input time steps of the last request, or -1.
+  int LastRequestIndex;
+
+  // Runs the background update of the input producer.
+  // PrefetchThreadId is only used by the thread that updates the
+  // pipeline, AbortPrefetch is also read by the background thread and is
+  // guarded by PrefetchLock.
+  vtkMultiThreader* Threader;
+  int PrefetchThreadId;
+  int AbortPrefetch;
+  vtkMutexLock* PrefetchLock;
+  vtkStreamingDemandDrivenPipeline* PrefetchExecutive;
+  int PrefetchPort;
+
+  // Description:
+  // Start updating the input for PrefetchTimes on a background thread.
+  // Called by the executive once the cache has executed.
+  void StartPrefetch();
+
+  // Description:
+  // Wait for the background update to finish.  With abort set, it stops
+  // after the time step being read.  FinishPrefetch also releases the
+  // producer of the input, which JoinPrefetch leaves to the garbage
+  // collector.
+  void FinishPrefetch(int abort);
+  void JoinPrefetch(int abort);
+
+  // Description:
+  // The body of the background update.
+  void ExecutePrefetch();
+
+  // Description:
+  // Drop old time steps to make room for a prefetched one.  Returns 0
+  // when the memory limit is reached or only requested times are cached.
+  int MakeRoomForPrefetch();
+
+  // The garbage collector registers the objects it is about to delete
+  // before it breaks their references, so the cache stops the prefetch
+  // then.  The producer updated by the prefetch is reported for the
+  // pipeline to be collected while it is held.
+  virtual void RegisterInternal(vtkObjectBase*, int check);
+  virtual void ReportReferences(vtkGarbageCollector*);
+
+  // The cache uses an executive that starts and waits for the prefetch.
+  virtual vtkExecutive* CreateDefaultExecutive();
+
   virtual int FillInputPortInformation(int port, vtkInformation* info);
 
   virtual int RequestUpdateExtent (vtkInformation *,
@@ -70,6 +162,10 @@ protected:
 private:
   vtkTemporalDataSetCache(const vtkTemporalDataSetCache&);  // Not implemented.
   void operator=(const vtkTemporalDataSetCache&);  // Not implemented.
+
+//BTX
+  friend class vtkTemporalDataSetCachePipeline;
+//ETX
 };
 
 
@@ -0,0 +1,238 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLegacyReaders.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test and benchmark of the legacy vtk file readers
+// .SECTION Description
+// Reads numbers in every notation the legacy format allows from a string,
+// then writes structured points, poly data and an unstructured grid as
+// ASCII and binary legacy files, reads them back and prints the read
+// throughput.  The data must round trip.  The size of the synthetic data
+// in megabytes can be given as the first argument, e.g. 1024 for a 1 GB
+// benchmark; the default keeps the test fast.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataReader.h"
+#include "vtkPolyDataWriter.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredPoints.h"
+#include "vtkStructuredPointsReader.h"
+#include "vtkStructuredPointsWriter.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkUnstructuredGridReader.h"
+#include "vtkUnstructuredGridWriter.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <stdlib.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Numbers in the notations the writers and other programs produce.
+static int TestParsing()
+{
+  const char* file =
+    "# vtk DataFile Version 3.0\n"
+    "numbers\n"
+    "ASCII\n"
+    "DATASET POLYDATA\n"
+    "POINTS 4 double\n"
+    "0 -1.5 +2.25e3\n"
+    "1E-2 .5 -0.000123456789012\n"
+    "1.7976931348623157e308 4.9406564584124654e-324 123456789012345678901\n"
+    "-0 3.14159265358979 1e22\n"
+    "POINT_DATA 4\n"
+    "SCALARS ints int 1\n"
+    "LOOKUP_TABLE default\n"
+    "2147483647 -2147483648 +7 -0\n";
+  const double points[] =
+    {
+    0, -1.5, 2250,
+    0.01, 0.5, -0.000123456789012,
+    1.7976931348623157e308, 4.9406564584124654e-324, 123456789012345678901.0,
+    0, 3.14159265358979, 1e22
+    };
+  const int ints[] = { 2147483647, -2147483647 - 1, 7, 0 };
+
+  VTK_CREATE(vtkPolyDataReader, reader);
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(file);
+  reader->Update();
+  vtkPolyData* output = reader->GetOutput();
+  vtkDataArray* scalars = output->GetPointData()->GetArray("ints");
+  if (output->GetNumberOfPoints() != 4 || !scalars)
+    {
+    cerr << "Cannot read the numbers" << endl;
+    return 0;
+    }
+  int ok = 1;
+  for (int i = 0; i < 12; ++i)
+    {
+    double value = output->GetPoint(i / 3)[i % 3];
+    if (value != points[i])
+      {
+      cerr << "Read " << value << " instead of " << points[i] << endl;
+      ok = 0;
+      }
+    }
+  for (int i = 0; i < 4; ++i)
+    {
+    if (scalars->GetTuple1(i) != ints[i])
+      {
+      cerr << "Read " << scalars->GetTuple1(i) << " instead of " << ints[i]
+           << endl;
+      ok = 0;
+      }
+    }
+  return ok;
+}
+
+static int SameArray(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!b || a->GetNumberOfComponents() != b->GetNumberOfComponents() ||
+      a->GetNumberOfTuples() != b->GetNumberOfTuples())
+    {
+    return 0;
+    }
+  int numComp = a->GetNumberOfComponents();
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+    {
+    for (int j = 0; j < numComp; ++j)
+      {
+      // ASCII files keep 6 digits for floats.
+      double x = a->GetComponent(i, j);
+      double y = b->GetComponent(i, j);
+      if (fabs(x - y) > 1.0e-5 * (fabs(x) + 1.0))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+// Write the data set with the legacy writer in both file types, read it
+// back and print the read throughput in megabytes per second.
+template <class TWriter, class TReader>
+int Benchmark(vtkDataSet* data, const char* fileName)
+{
+  const char* names[] = { "ascii", "binary" };
+  int ok = 1;
+  VTK_CREATE(vtkTimerLog, timer);
+  for (int binary = 0; binary < 2; ++binary)
+    {
+    VTK_CREATE(TWriter, writer);
+    writer->SetInput(data);
+    writer->SetFileName(fileName);
+    writer->SetFileType(binary ? VTK_BINARY : VTK_ASCII);
+    writer->Write();
+
+    VTK_CREATE(TReader, reader);
+    reader->SetFileName(fileName);
+    timer->StartTimer();
+    reader->Update();
+    timer->StopTimer();
+    double readTime = timer->GetElapsedTime();
+
+    double megabytes = vtksys::SystemTools::FileLength(fileName) /
+      (1024.0 * 1024.0);
+    cout << "  " << names[binary] << ": " << megabytes << " MB, read "
+         << (readTime > 0 ? megabytes / readTime : 0.0) << " MB/s" << endl;
+
+    vtkDataSet* output = reader->GetOutput();
+    if (output->GetNumberOfPoints() != data->GetNumberOfPoints() ||
+        output->GetNumberOfCells() != data->GetNumberOfCells() ||
+        !SameArray(data->GetPointData()->GetScalars(),
+                   output->GetPointData()->GetScalars()))
+      {
+      cerr << fileName << ": " << names[binary] << " did not round trip"
+           << endl;
+      ok = 0;
+      }
+    }
+  vtksys::SystemTools::RemoveFile(fileName);
+  return ok;
+}
+
+int TestLegacyReaders(int argc, char* argv[])
+{
+  int ok = TestParsing();
+
+  // Each data set takes about this many megabytes as an ASCII file.
+  double megabytes = argc > 1 ? atof(argv[1]) : 4.0;
+  vtkIdType numPts = static_cast<vtkIdType>(megabytes * 1024 * 1024 / 64);
+  if (numPts < 1000)
+    {
+    numPts = 1000;
+    }
+  vtkMath::RandomSeed(8775070);
+
+  VTK_CREATE(vtkFloatArray, scalars);
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(numPts);
+  VTK_CREATE(vtkPoints, points);
+  points->SetNumberOfPoints(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    points->SetPoint(i, vtkMath::Random(-1, 1), vtkMath::Random(-1, 1),
+                     vtkMath::Random(-1, 1));
+    scalars->SetValue(i, static_cast<float>(vtkMath::Random(-1000, 1000)));
+    }
+
+  VTK_CREATE(vtkStructuredPoints, image);
+  image->SetDimensions(static_cast<int>(numPts / 100), 10, 10);
+  VTK_CREATE(vtkFloatArray, imageScalars);
+  imageScalars->DeepCopy(scalars);
+  imageScalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  image->GetPointData()->SetScalars(imageScalars);
+  cout << "vtkStructuredPointsReader:" << endl;
+  ok &= Benchmark<vtkStructuredPointsWriter, vtkStructuredPointsReader>(
+    image, "TestLegacyReaders.vtk");
+
+  VTK_CREATE(vtkPolyData, poly);
+  poly->SetPoints(points);
+  poly->GetPointData()->SetScalars(scalars);
+  poly->Allocate(numPts / 3);
+  for (vtkIdType i = 0; i + 2 < numPts; i += 3)
+    {
+    vtkIdType ids[3] = { i, i + 1, i + 2 };
+    poly->InsertNextCell(VTK_TRIANGLE, 3, ids);
+    }
+  cout << "vtkPolyDataReader:" << endl;
+  ok &= Benchmark<vtkPolyDataWriter, vtkPolyDataReader>(
+    poly, "TestLegacyReaders.vtk");
+
+  VTK_CREATE(vtkUnstructuredGrid, grid);
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+  grid->Allocate(numPts / 4);
+  for (vtkIdType i = 0; i + 3 < numPts; i += 4)
+    {
+    vtkIdType ids[4] = { i, i + 1, i + 2, i + 3 };
+    grid->InsertNextCell(VTK_TETRA, 4, ids);
+    }
+  cout << "vtkUnstructuredGridReader:" << endl;
+  ok &= Benchmark<vtkUnstructuredGridWriter, vtkUnstructuredGridReader>(
+    grid, "TestLegacyReaders.vtk");
+
+  return ok ? 0 : 1;
+}
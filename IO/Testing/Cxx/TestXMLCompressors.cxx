@@ -0,0 +1,369 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCompressors.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the compressors of the XML writers
+// .SECTION Description
+// Round trips buffers through vtkLZ4DataCompressor and checks that
+// truncated and corrupt blocks fail without writing past the output.  Then
+// writes and reads back an image and an unstructured grid with every
+// compressor type and prints the size and throughput of each.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkLZ4DataCompressor.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+#include "vtkZLibDataCompressor.h"
+
+#include <math.h>
+#include <vtksys/SystemTools.hxx>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static int RoundTrip(vtkLZ4DataCompressor* compressor,
+                     const unsigned char* data, unsigned long size,
+                     const char* name)
+{
+  unsigned long space = compressor->GetMaximumCompressionSpace(size);
+  unsigned char* compressed = new unsigned char[space];
+  unsigned char* uncompressed = new unsigned char[size + 1];
+  int ok = 0;
+  unsigned long length = compressor->Compress(data, size, compressed, space);
+  if (length > 0 &&
+      compressor->Uncompress(compressed, length, uncompressed, size) == size &&
+      memcmp(data, uncompressed, size) == 0)
+    {
+    ok = 1;
+    }
+  else
+    {
+    cerr << "LZ4 level " << compressor->GetCompressionLevel() << ": "
+         << name << " of " << size << " bytes did not round trip" << endl;
+    }
+  delete [] compressed;
+  delete [] uncompressed;
+  return ok;
+}
+
+static int TestLZ4Buffers()
+{
+  const unsigned long size = 200000;
+  unsigned char* random = new unsigned char[size];
+  unsigned char* runs = new unsigned char[size];
+  unsigned char* mixed = new unsigned char[size];
+  vtkMath::RandomSeed(1234);
+  for (unsigned long i = 0; i < size; ++i)
+    {
+    random[i] = static_cast<unsigned char>(vtkMath::Random(0, 255.999));
+    // Short periods give matches that overlap their own output.
+    runs[i] = static_cast<unsigned char>((i / 1000) % 3 ? i % 3 : 7);
+    // Repeats more than 64KB apart cannot be referenced.
+    mixed[i] = (i % 70000 < 500) ? random[i % 500] : random[i];
+    }
+
+  VTK_CREATE(vtkLZ4DataCompressor, compressor);
+  int ok = 1;
+  int levels[] = { 1, 4, 9 };
+  unsigned long sizes[] = { 1, 12, 13, 17, 100, 65536, 65537, size };
+  for (int l = 0; l < 3; ++l)
+    {
+    compressor->SetCompressionLevel(levels[l]);
+    for (int s = 0; s < 8; ++s)
+      {
+      ok &= RoundTrip(compressor, random, sizes[s], "random data");
+      ok &= RoundTrip(compressor, runs, sizes[s], "runs");
+      ok &= RoundTrip(compressor, mixed, sizes[s], "mixed data");
+      }
+    }
+
+  // Runs must actually compress.
+  unsigned long space = compressor->GetMaximumCompressionSpace(size);
+  unsigned char* compressed = new unsigned char[space];
+  compressor->SetCompressionLevel(1);
+  unsigned long fast = compressor->Compress(runs, size, compressed, space);
+  compressor->SetCompressionLevel(9);
+  unsigned long small = compressor->Compress(runs, size, compressed, space);
+  if (fast == 0 || fast > size / 20 || small == 0 || small > size / 20)
+    {
+    cerr << "LZ4 compressed runs to " << fast << " and " << small
+         << " bytes" << endl;
+    ok = 0;
+    }
+  delete [] compressed;
+
+  delete [] random;
+  delete [] runs;
+  delete [] mixed;
+  return ok;
+}
+
+// Uncompress a block that may be malformed into a buffer followed by
+// guard bytes.  The result must be a failure or the full size, and the
+// guard bytes must be left alone.
+static int SafeUncompress(vtkLZ4DataCompressor* compressor,
+                          const unsigned char* block, unsigned long length,
+                          unsigned long size, int mustFail, const char* name)
+{
+  // An exact copy lets memory checkers catch reads past the block.
+  unsigned char* input = new unsigned char[length + 1];
+  memcpy(input, block, length);
+  const unsigned long guard = 64;
+  unsigned char* output = new unsigned char[size + guard];
+  memset(output + size, 0xa5, guard);
+  unsigned long result = compressor->Uncompress(input, length, output, size);
+  int ok = (result == 0 || (!mustFail && result == size));
+  for (unsigned long i = size; i < size + guard; ++i)
+    {
+    ok = ok && output[i] == 0xa5;
+    }
+  if (!ok)
+    {
+    cerr << "LZ4 " << name << " of " << length << " bytes gave " << result
+         << " bytes or wrote past the output" << endl;
+    }
+  delete [] input;
+  delete [] output;
+  return ok;
+}
+
+// Truncated, corrupt and hand-made malformed blocks must fail cleanly.
+static int TestLZ4MalformedBlocks()
+{
+  const unsigned long size = 4000;
+  unsigned char data[size];
+  vtkMath::RandomSeed(5678);
+  for (unsigned long i = 0; i < size; ++i)
+    {
+    data[i] = static_cast<unsigned char>(
+      (i / 300) % 2 ? vtkMath::Random(0, 255.999) : i % 7);
+    }
+  VTK_CREATE(vtkLZ4DataCompressor, compressor);
+  compressor->SetCompressionLevel(9);
+  unsigned long space = compressor->GetMaximumCompressionSpace(size);
+  unsigned char* block = new unsigned char[space];
+  unsigned long length = compressor->Compress(data, size, block, space);
+
+  int display = vtkObject::GetGlobalWarningDisplay();
+  vtkObject::GlobalWarningDisplayOff();
+  int ok = 1;
+  for (unsigned long l = 0; l < length; ++l)
+    {
+    ok &= SafeUncompress(compressor, block, l, size, 1, "truncated block");
+    }
+  unsigned char* corrupt = new unsigned char[length];
+  for (int trial = 0; trial < 2000; ++trial)
+    {
+    memcpy(corrupt, block, length);
+    int changes = 1 + trial % 4;
+    for (int c = 0; c < changes; ++c)
+      {
+      unsigned long pos = static_cast<unsigned long>(
+        vtkMath::Random(0, length - 0.001));
+      corrupt[pos] = static_cast<unsigned char>(vtkMath::Random(0, 255.999));
+      }
+    ok &= SafeUncompress(compressor, corrupt, length, size, 0,
+                         "corrupt block");
+    }
+  delete [] corrupt;
+
+  // A literal length that never ends, an extension cut short, a zero
+  // offset, an offset before the output, a match past the output and a cut
+  // offset.
+  unsigned char* runs = new unsigned char[100000];
+  runs[0] = 0xf0;
+  memset(runs + 1, 255, 99999);
+  ok &= SafeUncompress(compressor, runs, 100000, size, 1, "endless length");
+  delete [] runs;
+  const unsigned char cut[] = { 0xf0, 255, 255 };
+  const unsigned char zero[] = { 0x10, 'a', 0, 0, 0x50, 'a','b','c','d','e' };
+  const unsigned char before[] = { 0x10, 'a', 2, 0, 0x10, 'a' };
+  const unsigned char past[] = { 0x1f, 'a', 1, 0, 255, 255, 255, 0, 0x10, 'a' };
+  const unsigned char offset[] = { 0x10, 'a', 1 };
+  ok &= SafeUncompress(compressor, cut, sizeof(cut), 8, 1, "cut length");
+  ok &= SafeUncompress(compressor, zero, sizeof(zero), 10, 1, "zero offset");
+  ok &= SafeUncompress(compressor, before, sizeof(before), 6, 1,
+                       "offset before the output");
+  ok &= SafeUncompress(compressor, past, sizeof(past), 300, 1,
+                       "match past the output");
+  ok &= SafeUncompress(compressor, offset, sizeof(offset), 8, 1,
+                       "cut offset");
+  if (display)
+    {
+    vtkObject::GlobalWarningDisplayOn();
+    }
+
+  // The intact block still decodes.
+  ok &= RoundTrip(compressor, data, size, "data after the malformed blocks");
+  delete [] block;
+  return ok;
+}
+
+static int SameArrays(vtkDataSet* a, vtkDataSet* b)
+{
+  vtkPointData* pa = a->GetPointData();
+  vtkPointData* pb = b->GetPointData();
+  if (pa->GetNumberOfArrays() != pb->GetNumberOfArrays())
+    {
+    return 0;
+    }
+  for (int i = 0; i < pa->GetNumberOfArrays(); ++i)
+    {
+    vtkDataArray* x = pa->GetArray(i);
+    vtkDataArray* y = pb->GetArray(x->GetName());
+    if (!y || x->GetDataType() != y->GetDataType() ||
+        x->GetNumberOfTuples() != y->GetNumberOfTuples() ||
+        x->GetNumberOfComponents() != y->GetNumberOfComponents() ||
+        memcmp(x->GetVoidPointer(0), y->GetVoidPointer(0),
+               x->GetNumberOfTuples() * x->GetNumberOfComponents() *
+               x->GetDataTypeSize()) != 0)
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// Write and read back the data set with every compressor and print the
+// throughput in uncompressed megabytes per second.
+template <class TWriter, class TReader>
+int BenchmarkWriter(vtkDataSet* data, const char* fileName, double megabytes)
+{
+  const char* names[] = { "none", "zlib", "lz4 level 1", "lz4 level 9" };
+  int ok = 1;
+  VTK_CREATE(vtkTimerLog, timer);
+  for (int c = 0; c < 4; ++c)
+    {
+    VTK_CREATE(TWriter, writer);
+    writer->SetInput(data);
+    writer->SetFileName(fileName);
+    writer->SetDataModeToAppended();
+    writer->EncodeAppendedDataOff();
+    if (c == 0)
+      {
+      writer->SetCompressorTypeToNone();
+      }
+    else if (c == 1)
+      {
+      writer->SetCompressorTypeToZLib();
+      }
+    else
+      {
+      // The level must carry over to the compressor created afterwards.
+      writer->SetCompressionLevel(c == 2 ? 1 : 9);
+      writer->SetCompressorTypeToLZ4();
+      if (writer->GetCompressor()->GetCompressionLevel() !=
+          writer->GetCompressionLevel())
+        {
+        cerr << names[c] << ": the compressor has level "
+             << writer->GetCompressor()->GetCompressionLevel() << endl;
+        ok = 0;
+        }
+      }
+    timer->StartTimer();
+    writer->Write();
+    timer->StopTimer();
+    double writeTime = timer->GetElapsedTime();
+
+    VTK_CREATE(TReader, reader);
+    reader->SetFileName(fileName);
+    timer->StartTimer();
+    reader->Update();
+    timer->StopTimer();
+    double readTime = timer->GetElapsedTime();
+
+    unsigned long fileSize = vtksys::SystemTools::FileLength(fileName);
+    cout << "  " << names[c] << ": " << fileSize << " bytes, write "
+         << (writeTime > 0 ? megabytes / writeTime : 0.0) << " MB/s, read "
+         << (readTime > 0 ? megabytes / readTime : 0.0) << " MB/s" << endl;
+
+    if (!SameArrays(data, reader->GetOutput()))
+      {
+      cerr << fileName << ": " << names[c] << " did not round trip" << endl;
+      ok = 0;
+      }
+    }
+  vtksys::SystemTools::RemoveFile(fileName);
+  return ok;
+}
+
+int TestXMLCompressors(int, char*[])
+{
+  int ok = TestLZ4Buffers();
+  ok &= TestLZ4MalformedBlocks();
+
+  // A smooth field and a noisy one, as in simulation output.
+  const int n = 48;
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(n, n, n);
+  image->SetSpacing(1.0 / (n - 1), 1.0 / (n - 1), 1.0 / (n - 1));
+  VTK_CREATE(vtkFloatArray, smooth);
+  smooth->SetName("smooth");
+  smooth->SetNumberOfTuples(image->GetNumberOfPoints());
+  VTK_CREATE(vtkIntArray, labels);
+  labels->SetName("labels");
+  labels->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    smooth->SetValue(i, static_cast<float>(sin(6.0 * x[0]) * cos(4.0 * x[1])
+                                           + x[2]));
+    labels->SetValue(i, static_cast<int>(8.0 * x[0]) +
+                     (vtkMath::Random() < 0.05 ? 1 : 0));
+    }
+  image->GetPointData()->AddArray(smooth);
+  image->GetPointData()->AddArray(labels);
+
+  // The same points as hexahedra.
+  VTK_CREATE(vtkUnstructuredGrid, grid);
+  VTK_CREATE(vtkPoints, points);
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    points->SetPoint(i, image->GetPoint(i));
+    }
+  grid->SetPoints(points);
+  grid->Allocate(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+    {
+    grid->InsertNextCell(image->GetCellType(i), image->GetCell(i)->GetPointIds());
+    }
+  grid->GetPointData()->ShallowCopy(image->GetPointData());
+
+  double imageMB = 2.0 * 4.0 * image->GetNumberOfPoints() / (1024.0 * 1024.0);
+  cout << "vtkXMLImageDataWriter, " << imageMB << " MB:" << endl;
+  ok &= BenchmarkWriter<vtkXMLImageDataWriter, vtkXMLImageDataReader>(
+    image, "TestXMLCompressors.vti", imageMB);
+
+  double gridMB = imageMB + (3.0 * sizeof(float) * grid->GetNumberOfPoints() +
+    9.0 * sizeof(vtkIdType) * grid->GetNumberOfCells()) / (1024.0 * 1024.0);
+  cout << "vtkXMLUnstructuredGridWriter, " << gridMB << " MB:" << endl;
+  ok &= BenchmarkWriter<vtkXMLUnstructuredGridWriter,
+                        vtkXMLUnstructuredGridReader>(
+    grid, "TestXMLCompressors.vtu", gridMB);
+
+  return ok ? 0 : 1;
+}
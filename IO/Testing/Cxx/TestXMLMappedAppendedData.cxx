@@ -0,0 +1,287 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLMappedAppendedData.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of reading raw appended data in place
+// .SECTION Description
+// Writes image data, poly data and an unstructured grid with raw,
+// uncompressed appended data and reads them back with MapAppendedData on
+// and off.  Both outputs must match the input, the arrays read with the
+// mapping must wrap the mapped file, and those read without it must not.
+// Compressed files must be read normally even with the mapping on.
+
+#include "vtkCellArray.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMemoryMappedFile.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLPolyDataReader.h"
+#include "vtkXMLPolyDataWriter.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Returns 1 if the array wraps the mapped file it refers to.
+static int IsMapped(vtkDataArray* a)
+{
+  vtkMemoryMappedFile* file = vtkMemoryMappedFile::SafeDownCast(
+    a->GetInformation()->Get(vtkXMLReader::MAPPED_FILE()));
+  if (!file)
+    {
+    return 0;
+    }
+  unsigned char* p = static_cast<unsigned char*>(a->GetVoidPointer(0));
+  return (p >= file->GetData() &&
+          p + a->GetDataSize()*a->GetDataTypeSize() <=
+          file->GetData() + file->GetSize());
+}
+
+static int SameArray(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!b || a->GetDataType() != b->GetDataType() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents() ||
+      a->GetNumberOfTuples() != b->GetNumberOfTuples())
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < a->GetDataSize(); ++i)
+    {
+    if (a->GetComponent(i / a->GetNumberOfComponents(),
+                        static_cast<int>(i % a->GetNumberOfComponents())) !=
+        b->GetComponent(i / b->GetNumberOfComponents(),
+                        static_cast<int>(i % b->GetNumberOfComponents())))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// Checks the arrays read from a file against the input, and whether they
+// wrap the mapping.
+static int Check(const char* what, vtkDataArray* in, vtkDataArray* out,
+                 int mapped)
+{
+  if (!SameArray(in, out))
+    {
+    cerr << what << ": array did not round trip" << endl;
+    return 0;
+    }
+  if (IsMapped(out) != mapped)
+    {
+    cerr << what << ": array " << (mapped ? "does not wrap" : "wraps")
+         << " the mapped file" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+static void SetUpWriter(vtkXMLWriter* writer, const char* fileName,
+                        int compress)
+{
+  writer->SetFileName(fileName);
+  writer->SetDataModeToAppended();
+  writer->SetEncodeAppendedData(0);
+  if (compress)
+    {
+    writer->SetCompressorTypeToZLib();
+    }
+  else
+    {
+    writer->SetCompressor(0);
+    }
+}
+
+static int TestImageData(int compress)
+{
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(17, 13, 5);
+  VTK_CREATE(vtkFloatArray, scalars);
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+    {
+    scalars->SetValue(i, static_cast<float>(vtkMath::Random(-1, 1)));
+    }
+  image->GetPointData()->SetScalars(scalars);
+
+  const char* fileName = "TestXMLMappedAppendedData.vti";
+  VTK_CREATE(vtkXMLImageDataWriter, writer);
+  writer->SetInput(image);
+  SetUpWriter(writer, fileName, compress);
+  if (!writer->Write())
+    {
+    cerr << "Cannot write " << fileName << endl;
+    return 0;
+    }
+
+  int ok = 1;
+  for (int map = 0; map < 2; ++map)
+    {
+    VTK_CREATE(vtkXMLImageDataReader, reader);
+    reader->SetFileName(fileName);
+    reader->SetMapAppendedData(map);
+    reader->Update();
+    ok = Check("image scalars", scalars,
+               reader->GetOutput()->GetPointData()->GetArray("scalars"),
+               map && !compress) && ok;
+    }
+  vtksys::SystemTools::RemoveFile(fileName);
+  return ok;
+}
+
+static int TestPolyData(int compress)
+{
+  const vtkIdType numPts = 1001;
+  VTK_CREATE(vtkPolyData, poly);
+  VTK_CREATE(vtkPoints, points);
+  VTK_CREATE(vtkIntArray, labels);
+  labels->SetName("labels");
+  points->SetNumberOfPoints(numPts);
+  labels->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    points->SetPoint(i, vtkMath::Random(), vtkMath::Random(),
+                     vtkMath::Random());
+    labels->SetValue(i, static_cast<int>(i % 7));
+    }
+  poly->SetPoints(points);
+  poly->GetPointData()->AddArray(labels);
+  poly->Allocate(numPts / 3);
+  for (vtkIdType i = 0; i + 2 < numPts; i += 3)
+    {
+    vtkIdType ids[3] = { i, i + 1, i + 2 };
+    poly->InsertNextCell(VTK_TRIANGLE, 3, ids);
+    }
+
+  const char* fileName = "TestXMLMappedAppendedData.vtp";
+  VTK_CREATE(vtkXMLPolyDataWriter, writer);
+  writer->SetInput(poly);
+  SetUpWriter(writer, fileName, compress);
+  if (!writer->Write())
+    {
+    cerr << "Cannot write " << fileName << endl;
+    return 0;
+    }
+
+  int ok = 1;
+  for (int map = 0; map < 2; ++map)
+    {
+    VTK_CREATE(vtkXMLPolyDataReader, reader);
+    reader->SetFileName(fileName);
+    reader->SetMapAppendedData(map);
+    reader->Update();
+    vtkPolyData* output = reader->GetOutput();
+    ok = Check("poly data points", points->GetData(),
+               output->GetPoints()->GetData(), map && !compress) && ok;
+    ok = Check("poly data labels", labels,
+               output->GetPointData()->GetArray("labels"),
+               map && !compress) && ok;
+    if (output->GetNumberOfPolys() != poly->GetNumberOfPolys())
+      {
+      cerr << "poly data polygons did not round trip" << endl;
+      ok = 0;
+      }
+    }
+  vtksys::SystemTools::RemoveFile(fileName);
+  return ok;
+}
+
+static int TestUnstructuredGrid(int compress)
+{
+  const vtkIdType numPts = 2000;
+  VTK_CREATE(vtkUnstructuredGrid, grid);
+  VTK_CREATE(vtkPoints, points);
+  VTK_CREATE(vtkDoubleArray, values);
+  values->SetName("values");
+  values->SetNumberOfComponents(3);
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPts);
+  values->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    points->SetPoint(i, vtkMath::Random(), vtkMath::Random(),
+                     vtkMath::Random());
+    values->SetTuple3(i, vtkMath::Random(), vtkMath::Random(),
+                      vtkMath::Random());
+    }
+  grid->SetPoints(points);
+  grid->GetPointData()->AddArray(values);
+  grid->Allocate(numPts / 4);
+  for (vtkIdType i = 0; i + 3 < numPts; i += 4)
+    {
+    vtkIdType ids[4] = { i, i + 1, i + 2, i + 3 };
+    grid->InsertNextCell(VTK_TETRA, 4, ids);
+    }
+
+  const char* fileName = "TestXMLMappedAppendedData.vtu";
+  VTK_CREATE(vtkXMLUnstructuredGridWriter, writer);
+  writer->SetInput(grid);
+  SetUpWriter(writer, fileName, compress);
+  if (!writer->Write())
+    {
+    cerr << "Cannot write " << fileName << endl;
+    return 0;
+    }
+
+  int ok = 1;
+  for (int map = 0; map < 2; ++map)
+    {
+    VTK_CREATE(vtkXMLUnstructuredGridReader, reader);
+    reader->SetFileName(fileName);
+    reader->SetMapAppendedData(map);
+    reader->Update();
+    vtkUnstructuredGrid* output = reader->GetOutput();
+    ok = Check("unstructured grid points", points->GetData(),
+               output->GetPoints()->GetData(), map && !compress) && ok;
+    ok = Check("unstructured grid values", values,
+               output->GetPointData()->GetArray("values"),
+               map && !compress) && ok;
+    if (output->GetNumberOfCells() != grid->GetNumberOfCells() ||
+        output->GetCellType(0) != VTK_TETRA)
+      {
+      cerr << "unstructured grid cells did not round trip" << endl;
+      ok = 0;
+      }
+    }
+  vtksys::SystemTools::RemoveFile(fileName);
+  return ok;
+}
+
+int TestXMLMappedAppendedData(int, char*[])
+{
+  vtkMath::RandomSeed(1234);
+  int ok = 1;
+  for (int compress = 0; compress < 2; ++compress)
+    {
+    ok = TestImageData(compress) && ok;
+    ok = TestPolyData(compress) && ok;
+    ok = TestUnstructuredGrid(compress) && ok;
+    }
+  return ok ? 0 : 1;
+}
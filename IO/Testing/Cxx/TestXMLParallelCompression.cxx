@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLParallelCompression.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded block compression of the XML writers
+// .SECTION Description
+// Writes an unstructured grid with the blocks compressed serially and on
+// several threads, in every data mode, byte order and id type, and checks
+// that the files are identical.  The file is then read back with the
+// blocks decompressed serially and on several threads, and both outputs
+// must match the input.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/sstream>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static int SameData(vtkUnstructuredGrid* a, vtkUnstructuredGrid* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+    double x[3], y[3];
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+      return 0;
+      }
+    }
+  vtkIdTypeArray* ca = a->GetCells()->GetData();
+  vtkIdTypeArray* cb = b->GetCells()->GetData();
+  if (ca->GetNumberOfTuples() != cb->GetNumberOfTuples())
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < ca->GetNumberOfTuples(); ++i)
+    {
+    if (ca->GetValue(i) != cb->GetValue(i))
+      {
+      return 0;
+      }
+    }
+  vtkDataArray* da = a->GetPointData()->GetArray("values");
+  vtkDataArray* db = b->GetPointData()->GetArray("values");
+  if (!db || da->GetNumberOfTuples() != db->GetNumberOfTuples())
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < da->GetNumberOfTuples(); ++i)
+    {
+    if (da->GetTuple1(i) != db->GetTuple1(i))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static int WriteFile(vtkUnstructuredGrid* grid, const char* fileName,
+                     int parallel, int dataMode, int byteOrder, int idType)
+{
+  VTK_CREATE(vtkXMLUnstructuredGridWriter, writer);
+  writer->SetInput(grid);
+  writer->SetFileName(fileName);
+  writer->SetDataMode(dataMode);
+  writer->SetByteOrder(byteOrder);
+  writer->SetIdType(idType);
+  writer->SetCompressorTypeToZLib();
+  // Small blocks give every array many of them.
+  writer->SetBlockSize(1024);
+  writer->SetParallelExecution(parallel);
+  return writer->Write();
+}
+
+int TestXMLParallelCompression(int, char*[])
+{
+  // Random points and values compress poorly, so the compressed blocks
+  // all have different sizes.
+  const vtkIdType numPts = 20000;
+  vtkMath::RandomSeed(4321);
+  VTK_CREATE(vtkUnstructuredGrid, grid);
+  VTK_CREATE(vtkPoints, points);
+  VTK_CREATE(vtkDoubleArray, values);
+  values->SetName("values");
+  points->SetNumberOfPoints(numPts);
+  values->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    points->SetPoint(i, vtkMath::Random(), vtkMath::Random(),
+                     vtkMath::Random());
+    values->SetValue(i, vtkMath::Random(-1, 1));
+    }
+  grid->SetPoints(points);
+  grid->GetPointData()->AddArray(values);
+  grid->Allocate(numPts / 4);
+  for (vtkIdType i = 0; i + 3 < numPts; i += 4)
+    {
+    vtkIdType ids[4] = { i, i + 1, i + 2, i + 3 };
+    grid->InsertNextCell(VTK_TETRA, 4, ids);
+    }
+
+  const char* serialName = "TestXMLParallelCompressionSerial.vtu";
+  const char* parallelName = "TestXMLParallelCompressionParallel.vtu";
+  int dataModes[] = { vtkXMLWriter::Binary, vtkXMLWriter::Appended };
+  int byteOrders[] = { vtkXMLWriter::LittleEndian, vtkXMLWriter::BigEndian };
+  int idTypes[] = { vtkXMLWriter::Int32, vtkXMLWriter::Int64 };
+  int ok = 1;
+  for (int m = 0; m < 2; ++m)
+    {
+    for (int b = 0; b < 2; ++b)
+      {
+      for (int t = 0; t < 2; ++t)
+        {
+        vtksys_ios::ostringstream what;
+        what << "data mode " << dataModes[m] << ", byte order "
+             << byteOrders[b] << ", id type " << idTypes[t];
+
+        if (!WriteFile(grid, serialName, 0, dataModes[m], byteOrders[b],
+                       idTypes[t]) ||
+            !WriteFile(grid, parallelName, 1, dataModes[m], byteOrders[b],
+                       idTypes[t]))
+          {
+          cerr << what.str() << ": writing failed" << endl;
+          ok = 0;
+          continue;
+          }
+        if (vtksys::SystemTools::FilesDiffer(serialName, parallelName))
+          {
+          cerr << what.str() << ": serial and parallel files differ" << endl;
+          ok = 0;
+          }
+
+        for (int parallel = 0; parallel < 2; ++parallel)
+          {
+          VTK_CREATE(vtkXMLUnstructuredGridReader, reader);
+          reader->SetFileName(parallelName);
+          reader->SetParallelExecution(parallel);
+          reader->Update();
+          if (!SameData(grid, reader->GetOutput()))
+            {
+            cerr << what.str() << ": data did not round trip with "
+                 << (parallel ? "parallel" : "serial") << " reading" << endl;
+            ok = 0;
+            }
+          }
+        }
+      }
+    }
+  vtksys::SystemTools::RemoveFile(serialName);
+  vtksys::SystemTools::RemoveFile(parallelName);
+
+  return ok ? 0 : 1;
+}
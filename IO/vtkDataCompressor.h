@@ -18,6 +18,14 @@
 // compression.  Subclasses provide one compression method and one
 // decompression method.  The public interface to all compressors
 // remains the same, and is defined by this class.
+//
+// vtkXMLWriter and vtkXMLDataParser compress and decompress independent
+// blocks on several threads at once with the same compressor.  The
+// CompressBuffer and UncompressBuffer methods of a subclass must
+// therefore be reentrant: they may read the compressor's settings but
+// must keep all their working state on the stack or in the buffers they
+// are given.  A compressor that cannot do this must be used with
+// ParallelExecution turned off on the writer and the reader.
 
 #ifndef __vtkDataCompressor_h
 #define __vtkDataCompressor_h
@@ -38,6 +46,13 @@ public:
   // size of the output buffer that can be passed to the four-argument
   // Compress method.
   virtual unsigned long GetMaximumCompressionSpace(unsigned long size)=0;
+
+  // Description:
+  // Get/Set the compression level.  Higher levels give smaller output
+  // and take longer.  Every compressor clamps the level to the range it
+  // supports.
+  virtual void SetCompressionLevel(int level)=0;
+  virtual int GetCompressionLevel()=0;
   
   // Description:
   // Compress the given input data buffer into the given output
@@ -80,12 +95,14 @@ protected:
   
   // Actual compression method.  This must be provided by a subclass.
   // Must return the size of the compressed data, or zero on error.
+  // Must be reentrant; see the class description.
   virtual unsigned long CompressBuffer(const unsigned char* uncompressedData,
                                        unsigned long uncompressedSize,
                                        unsigned char* compressedData,
                                        unsigned long compressionSpace)=0;  
   // Actual decompression method.  This must be provided by a subclass.
   // Must return the size of the uncompressed data, or zero on error.
+  // Must be reentrant; see the class description.
   virtual unsigned long UncompressBuffer(const unsigned char* compressedData,
                                          unsigned long compressedSize,
                                          unsigned char* uncompressedData,
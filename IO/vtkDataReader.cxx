@@ -53,7 +53,10 @@
 #endif
 
 #include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <sys/stat.h>
+#include <vtkstd/limits>
 
 // I need a safe way to read a line of arbitrary length.  It exists on
 // some platforms but not others so I'm afraid I have to write it
@@ -91,6 +94,7 @@ vtkDataReader::vtkDataReader()
   this->InputStringPos = 0;
   this->ReadFromInputString = 0;
   this->IS = NULL;
+  this->StreamBuffer = NULL;
   this->Header = NULL;
 
   this->InputArray = 0;
@@ -179,6 +183,7 @@ vtkDataReader::~vtkDataReader()
     {
     delete this->IS;
     }
+  delete [] this->StreamBuffer;
 }
 
 void vtkDataReader::SetInputString(const char *in)
@@ -268,156 +273,312 @@ int vtkDataReader::ReadString(char result[256])
   return 1;
 }
 
-// Internal function to read in an integer value.
-// Returns zero if there was an error.
-int vtkDataReader::Read(char *result)
+// The longest number vtkDataReaderScanNumber collects.  Longer ones are
+// not valid.
+#define VTK_DATA_READER_MAX_NUMBER 128
+
+// The size of the buffer of file streams.
+#define VTK_DATA_READER_BUFFER_SIZE (1 << 20)
+
+// Collect the characters of the next number in the stream into buf,
+// skipping white space first like operator>> does.  Integers are an
+// optional sign and digits, reals may also have a fraction and an
+// exponent.  The characters are taken straight from the stream buffer,
+// which avoids the sentry and locale facets of operator>> for every
+// value.  Returns the number of characters, 0 if there is no number.
+static int vtkDataReaderScanNumber(istream* is, char* buf, int real)
 {
-  int intData;
-  *this->IS >> intData;
-  if (this->IS->fail())
+  if (!is->good())
     {
+    is->setstate(ios::failbit);
     return 0;
     }
+  vtkstd::streambuf* sb = is->rdbuf();
+  int c = sb->sgetc();
+  while (c != EOF && isspace(c))
+    {
+    c = sb->snextc();
+    }
 
-  *result = (char) intData;
-  return 1;
+  int n = 0;
+  int digits = 0;
+  const int last = VTK_DATA_READER_MAX_NUMBER - 1;
+  if (c == '-' || c == '+')
+    {
+    buf[n++] = static_cast<char>(c);
+    c = sb->snextc();
+    }
+  while (c != EOF && isdigit(c) && n < last)
+    {
+    buf[n++] = static_cast<char>(c);
+    c = sb->snextc();
+    ++digits;
+    }
+  if (real)
+    {
+    if (c == '.' && n < last)
+      {
+      buf[n++] = static_cast<char>(c);
+      c = sb->snextc();
+      while (c != EOF && isdigit(c) && n < last)
+        {
+        buf[n++] = static_cast<char>(c);
+        c = sb->snextc();
+        ++digits;
+        }
+      }
+    if (digits && (c == 'e' || c == 'E') && n < last)
+      {
+      buf[n++] = static_cast<char>(c);
+      c = sb->snextc();
+      if ((c == '-' || c == '+') && n < last)
+        {
+        buf[n++] = static_cast<char>(c);
+        c = sb->snextc();
+        }
+      int expDigits = 0;
+      while (c != EOF && isdigit(c) && n < last)
+        {
+        buf[n++] = static_cast<char>(c);
+        c = sb->snextc();
+        ++expDigits;
+        }
+      if (!expDigits)
+        {
+        digits = 0;
+        }
+      }
+    }
+  buf[n] = 0;
+
+  if (c == EOF)
+    {
+    is->setstate(ios::eofbit);
+    }
+  if (!digits || n == last)
+    {
+    is->setstate(ios::failbit);
+    return 0;
+    }
+  return n;
 }
 
-int vtkDataReader::Read(unsigned char *result)
+// Read an integer value without going through operator>>.
+template <class T>
+static int vtkDataReaderReadInteger(istream* is, T* result)
 {
-  int intData;
-  *this->IS >> intData;
-  if (this->IS->fail())
+  char buf[VTK_DATA_READER_MAX_NUMBER];
+  if (!vtkDataReaderScanNumber(is, buf, 0))
     {
     return 0;
     }
 
-  *result = (unsigned char) intData;
+  const char* p = buf;
+  int negative = (*p == '-');
+  if (*p == '-' || *p == '+')
+    {
+    ++p;
+    }
+  const vtkTypeUInt64 maxValue =
+    static_cast<vtkTypeUInt64>(vtkstd::numeric_limits<T>::max());
+  // The magnitude of the most negative value of a signed type.
+  const vtkTypeUInt64 maxMagnitude =
+    (negative && vtkstd::numeric_limits<T>::is_signed) ? maxValue + 1 :
+    maxValue;
+  vtkTypeUInt64 value = 0;
+  for (; *p; ++p)
+    {
+    vtkTypeUInt64 digit = static_cast<vtkTypeUInt64>(*p - '0');
+    if (value > (maxMagnitude - digit) / 10)
+      {
+      is->setstate(ios::failbit);
+      return 0;
+      }
+    value = value*10 + digit;
+    }
+  // Negative values wrap around for unsigned types, as with strtoul.
+  *result = negative ? static_cast<T>(0 - value) : static_cast<T>(value);
   return 1;
 }
 
-int vtkDataReader::Read(short *result)
+// Read a real value without going through operator>>.  Values with at
+// most 15 significant digits and small exponents, which is what
+// vtkDataWriter produces, are converted exactly with one multiplication
+// or division.  Others are left to strtod.
+static int vtkDataReaderReadReal(istream* is, double* result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
+  static const double powersOf10[] =
+    {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+  char buf[VTK_DATA_READER_MAX_NUMBER];
+  int n = vtkDataReaderScanNumber(is, buf, 1);
+  if (!n)
     {
     return 0;
     }
-  return 1;
-}
 
-int vtkDataReader::Read(unsigned short *result)
-{
-  *this->IS >> *result;
-  if (this->IS->fail())
+  const char* p = buf;
+  int negative = (*p == '-');
+  if (*p == '-' || *p == '+')
+    {
+    ++p;
+    }
+  vtkTypeUInt64 mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  for (; isdigit(*p); ++p)
+    {
+    if (mantissa || *p != '0')
+      {
+      mantissa = mantissa*10 + static_cast<vtkTypeUInt64>(*p - '0');
+      ++digits;
+      }
+    }
+  if (*p == '.')
+    {
+    for (++p; isdigit(*p); ++p)
+      {
+      if (mantissa || *p != '0')
+        {
+        mantissa = mantissa*10 + static_cast<vtkTypeUInt64>(*p - '0');
+        ++digits;
+        }
+      --exponent;
+      }
+    }
+  if (*p == 'e' || *p == 'E')
+    {
+    ++p;
+    int expNegative = (*p == '-');
+    if (*p == '-' || *p == '+')
+      {
+      ++p;
+      }
+    int e = 0;
+    for (; isdigit(*p) && e < 10000; ++p)
+      {
+      e = e*10 + (*p - '0');
+      }
+    exponent += expNegative ? -e : e;
+    }
+
+  // Every integer up to 15 digits and every power of 10 up to 22 is
+  // exact in a double, so the one rounding gives the nearest value.
+  if (digits <= 15 && exponent >= -22 && exponent <= 22)
+    {
+    double value = static_cast<double>(static_cast<vtkTypeInt64>(mantissa));
+    value = exponent < 0 ? value / powersOf10[-exponent] :
+      value * powersOf10[exponent];
+    *result = negative ? -value : value;
+    return 1;
+    }
+
+  char* end;
+  *result = strtod(buf, &end);
+  if (end != buf + n)
     {
+    is->setstate(ios::failbit);
     return 0;
     }
   return 1;
 }
 
-int vtkDataReader::Read(int *result)
+// Internal function to read in an integer value.
+// Returns zero if there was an error.
+int vtkDataReader::Read(char *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
+  int intData;
+  if (!vtkDataReaderReadInteger(this->IS, &intData))
     {
     return 0;
     }
+
+  *result = (char) intData;
   return 1;
 }
 
-int vtkDataReader::Read(unsigned int *result)
+int vtkDataReader::Read(unsigned char *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
+  int intData;
+  if (!vtkDataReaderReadInteger(this->IS, &intData))
     {
     return 0;
     }
+
+  *result = (unsigned char) intData;
   return 1;
 }
 
+int vtkDataReader::Read(short *result)
+{
+  return vtkDataReaderReadInteger(this->IS, result);
+}
+
+int vtkDataReader::Read(unsigned short *result)
+{
+  return vtkDataReaderReadInteger(this->IS, result);
+}
+
+int vtkDataReader::Read(int *result)
+{
+  return vtkDataReaderReadInteger(this->IS, result);
+}
+
+int vtkDataReader::Read(unsigned int *result)
+{
+  return vtkDataReaderReadInteger(this->IS, result);
+}
+
 int vtkDataReader::Read(long *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
-    {
-    return 0;
-    }
-  return 1;
+  return vtkDataReaderReadInteger(this->IS, result);
 }
 
 int vtkDataReader::Read(unsigned long *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
-    {
-    return 0;
-    }
-  return 1;
+  return vtkDataReaderReadInteger(this->IS, result);
 }
 
 #if defined(VTK_TYPE_USE___INT64)
 int vtkDataReader::Read(__int64 *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
-    {
-    return 0;
-    }
-  return 1;
+  return vtkDataReaderReadInteger(this->IS, result);
 }
 
 int vtkDataReader::Read(unsigned __int64 *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
-    {
-    return 0;
-    }
-  return 1;
+  return vtkDataReaderReadInteger(this->IS, result);
 }
 #endif
 
 #if defined(VTK_TYPE_USE_LONG_LONG)
 int vtkDataReader::Read(long long *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
-    {
-    return 0;
-    }
-  return 1;
+  return vtkDataReaderReadInteger(this->IS, result);
 }
 
 int vtkDataReader::Read(unsigned long long *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
-    {
-    return 0;
-    }
-  return 1;
+  return vtkDataReaderReadInteger(this->IS, result);
 }
 #endif
 
 int vtkDataReader::Read(float *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail())
+  double value;
+  if (!vtkDataReaderReadReal(this->IS, &value))
     {
     return 0;
     }
+  *result = static_cast<float>(value);
   return 1;
 }
 
 int vtkDataReader::Read(double *result)
 {
-  *this->IS >> *result;
-  if (this->IS->fail()) 
-    {
-    return 0;
-    }
-  return 1;
+  return vtkDataReaderReadReal(this->IS, result);
 }
 
 
@@ -463,7 +624,16 @@ int vtkDataReader::OpenVTKFile()
       this->SetErrorCode( vtkErrorCode::CannotOpenFileError );
       return 0;
       }
-    this->IS = new ifstream(this->FileName, ios::in);
+    // Give the stream a large buffer so that the file is read in big
+    // blocks.  It must be set before the file is opened.
+    if (!this->StreamBuffer)
+      {
+      this->StreamBuffer = new char[VTK_DATA_READER_BUFFER_SIZE];
+      }
+    ifstream* file = new ifstream;
+    file->rdbuf()->pubsetbuf(this->StreamBuffer, VTK_DATA_READER_BUFFER_SIZE);
+    file->open(this->FileName, ios::in);
+    this->IS = file;
     if (this->IS->fail())
       {
       vtkErrorMacro(<< "Unable to open file: "<< this->FileName);
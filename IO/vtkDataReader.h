@@ -342,6 +342,9 @@ protected:
   int FileType;
   istream *IS;
 
+  // The buffer of the file stream, see OpenVTKFile().
+  char *StreamBuffer;
+
   char *ScalarsName;
   char *VectorsName;
   char *TensorsName;
@@ -0,0 +1,407 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkLZ4DataCompressor.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLZ4DataCompressor.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/vector>
+
+// Constants of the LZ4 block format.  A match is at least 4 bytes long,
+// the last 5 bytes of a block are always literals, the last match starts
+// at least 12 bytes before the end of the block, and matches are at most
+// 64KB back.
+#define VTK_LZ4_MIN_MATCH 4
+#define VTK_LZ4_LAST_LITERALS 5
+#define VTK_LZ4_MF_LIMIT 12
+#define VTK_LZ4_MAX_DISTANCE 65535
+#define VTK_LZ4_MAX_HASH_LOG 16
+
+vtkStandardNewMacro(vtkLZ4DataCompressor);
+
+//----------------------------------------------------------------------------
+static inline unsigned int vtkLZ4Read32(const unsigned char* p)
+{
+  unsigned int v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+//----------------------------------------------------------------------------
+static inline unsigned long vtkLZ4Hash(unsigned int sequence, int hashLog)
+{
+  return (sequence * 2654435761U) >> (32 - hashLog);
+}
+
+//----------------------------------------------------------------------------
+// Number of equal bytes at p and m, stopping at limit.
+static inline unsigned long vtkLZ4Count(const unsigned char* p,
+                                        const unsigned char* m,
+                                        const unsigned char* limit)
+{
+  const unsigned char* start = p;
+  while (p + 4 <= limit && vtkLZ4Read32(p) == vtkLZ4Read32(m))
+    {
+    p += 4;
+    m += 4;
+    }
+  while (p < limit && *p == *m)
+    {
+    ++p;
+    ++m;
+    }
+  return static_cast<unsigned long>(p - start);
+}
+
+//----------------------------------------------------------------------------
+// Write the bytes that extend a length field of the token.
+static inline unsigned char* vtkLZ4WriteLength(unsigned char* op,
+                                               unsigned long length)
+{
+  while (length >= 255)
+    {
+    *op++ = 255;
+    length -= 255;
+    }
+  *op++ = static_cast<unsigned char>(length);
+  return op;
+}
+
+//----------------------------------------------------------------------------
+// Read the bytes that extend a length field of the token.  Returns 0 when
+// the input ends first or the length exceeds limit, which also keeps the
+// sum from wrapping around.
+static inline int vtkLZ4ReadLength(const unsigned char*& ip,
+                                   const unsigned char* iend,
+                                   unsigned long limit,
+                                   unsigned long& length)
+{
+  unsigned char b;
+  do
+    {
+    if (ip >= iend || length > limit)
+      {
+      return 0;
+      }
+    b = *ip++;
+    length += b;
+    }
+  while (b == 255);
+  return length <= limit;
+}
+
+//----------------------------------------------------------------------------
+// Write one sequence: the literals followed by a match, or only the
+// literals when matchLength is 0, which ends the block.  Returns NULL
+// when the output buffer is too small.
+static unsigned char* vtkLZ4WriteSequence(unsigned char* op,
+                                          unsigned char* oend,
+                                          const unsigned char* literals,
+                                          unsigned long literalLength,
+                                          unsigned long offset,
+                                          unsigned long matchLength)
+{
+  unsigned long needed = 1 + literalLength/255 + 1 + literalLength +
+    2 + matchLength/255 + 1;
+  if (static_cast<unsigned long>(oend - op) < needed)
+    {
+    return 0;
+    }
+
+  unsigned char* token = op++;
+  if (literalLength >= 15)
+    {
+    *token = 15 << 4;
+    op = vtkLZ4WriteLength(op, literalLength - 15);
+    }
+  else
+    {
+    *token = static_cast<unsigned char>(literalLength << 4);
+    }
+  memcpy(op, literals, literalLength);
+  op += literalLength;
+
+  if (matchLength)
+    {
+    *op++ = static_cast<unsigned char>(offset & 0xff);
+    *op++ = static_cast<unsigned char>((offset >> 8) & 0xff);
+    unsigned long length = matchLength - VTK_LZ4_MIN_MATCH;
+    if (length >= 15)
+      {
+      *token |= 15;
+      op = vtkLZ4WriteLength(op, length - 15);
+      }
+    else
+      {
+      *token |= static_cast<unsigned char>(length);
+      }
+    }
+  return op;
+}
+
+//----------------------------------------------------------------------------
+vtkLZ4DataCompressor::vtkLZ4DataCompressor()
+{
+  this->CompressionLevel = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkLZ4DataCompressor::~vtkLZ4DataCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkLZ4DataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
+}
+
+//----------------------------------------------------------------------------
+unsigned long
+vtkLZ4DataCompressor::CompressBuffer(const unsigned char* uncompressedData,
+                                     unsigned long uncompressedSize,
+                                     unsigned char* compressedData,
+                                     unsigned long compressionSpace)
+{
+  const unsigned char* src = uncompressedData;
+  unsigned char* op = compressedData;
+  unsigned char* oend = compressedData + compressionSpace;
+  unsigned long anchor = 0;
+
+  // Blocks shorter than this are stored as literals only.
+  if (uncompressedSize > VTK_LZ4_MF_LIMIT)
+    {
+    // The hash table holds the last position (plus one) of every hashed
+    // 4-byte sequence.  Above level 1, the chain table links every position
+    // to the previous one with the same hash, as far back as a match can
+    // reach.  Both are sized after the block so that small blocks stay
+    // cheap to set up.
+    int hashLog = 8;
+    while (hashLog < VTK_LZ4_MAX_HASH_LOG &&
+           (1UL << hashLog) < uncompressedSize)
+      {
+      ++hashLog;
+      }
+    vtkstd::vector<unsigned long> head(1UL << hashLog, 0);
+    vtkstd::vector<unsigned long> chain;
+    unsigned long chainMask = 0;
+    int maxAttempts = 1 << (this->CompressionLevel - 1);
+    if (maxAttempts > 1)
+      {
+      chain.resize(1UL << hashLog, 0);
+      chainMask = (1UL << hashLog) - 1;
+      }
+
+    const unsigned long mflimit = uncompressedSize - VTK_LZ4_MF_LIMIT;
+    const unsigned char* matchLimit =
+      src + uncompressedSize - VTK_LZ4_LAST_LITERALS;
+    unsigned long ip = 0;
+    unsigned long misses = 0;
+    while (ip <= mflimit)
+      {
+      unsigned int sequence = vtkLZ4Read32(src + ip);
+      unsigned long h = vtkLZ4Hash(sequence, hashLog);
+
+      // Look for the longest match among the earlier positions.
+      unsigned long bestLength = 0;
+      unsigned long bestPos = 0;
+      unsigned long candidate = head[h];
+      for (int attempt = 0; candidate && attempt < maxAttempts; ++attempt)
+        {
+        unsigned long pos = candidate - 1;
+        if (ip - pos > VTK_LZ4_MAX_DISTANCE)
+          {
+          break;
+          }
+        if (vtkLZ4Read32(src + pos) == sequence)
+          {
+          unsigned long length = VTK_LZ4_MIN_MATCH +
+            vtkLZ4Count(src + ip + VTK_LZ4_MIN_MATCH,
+                        src + pos + VTK_LZ4_MIN_MATCH, matchLimit);
+          if (length > bestLength)
+            {
+            bestLength = length;
+            bestPos = pos;
+            }
+          }
+        if (!chainMask)
+          {
+          break;
+          }
+        candidate = chain[pos & chainMask];
+        }
+      if (chainMask)
+        {
+        chain[ip & chainMask] = head[h];
+        }
+      head[h] = ip + 1;
+
+      if (bestLength < VTK_LZ4_MIN_MATCH)
+        {
+        // At level 1, skip faster and faster through data that does not
+        // compress, as LZ4 does.
+        ip += chainMask ? 1 : 1 + (misses++ >> 6);
+        continue;
+        }
+      misses = 0;
+
+      // Extend the match backwards over the pending literals.
+      unsigned long start = ip;
+      while (start > anchor && bestPos > 0 &&
+             src[start - 1] == src[bestPos - 1])
+        {
+        --start;
+        --bestPos;
+        ++bestLength;
+        }
+
+      op = vtkLZ4WriteSequence(op, oend, src + anchor, start - anchor,
+                               start - bestPos, bestLength);
+      if (!op)
+        {
+        vtkErrorMacro("Output buffer too small while compressing data.");
+        return 0;
+        }
+
+      // Hash the positions covered by the match.  Level 1 only hashes the
+      // one before the last, like LZ4's fast mode.
+      unsigned long end = start + bestLength;
+      for (unsigned long p = chainMask ? ip + 1 : end - 2;
+           p < end && p <= mflimit; ++p)
+        {
+        h = vtkLZ4Hash(vtkLZ4Read32(src + p), hashLog);
+        if (chainMask)
+          {
+          chain[p & chainMask] = head[h];
+          }
+        head[h] = p + 1;
+        }
+      ip = end;
+      anchor = end;
+      }
+    }
+
+  // The block ends with the remaining literals.
+  op = vtkLZ4WriteSequence(op, oend, src + anchor, uncompressedSize - anchor,
+                           0, 0);
+  if (!op)
+    {
+    vtkErrorMacro("Output buffer too small while compressing data.");
+    return 0;
+    }
+  return static_cast<unsigned long>(op - compressedData);
+}
+
+//----------------------------------------------------------------------------
+unsigned long
+vtkLZ4DataCompressor::UncompressBuffer(const unsigned char* compressedData,
+                                       unsigned long compressedSize,
+                                       unsigned char* uncompressedData,
+                                       unsigned long uncompressedSize)
+{
+  const unsigned char* ip = compressedData;
+  const unsigned char* iend = compressedData + compressedSize;
+  unsigned char* op = uncompressedData;
+  unsigned char* oend = uncompressedData + uncompressedSize;
+
+  while (ip < iend)
+    {
+    unsigned int token = *ip++;
+
+    // Copy the literals.
+    unsigned long length = token >> 4;
+    if (length == 15 &&
+        !vtkLZ4ReadLength(ip, iend, uncompressedSize, length))
+      {
+      vtkErrorMacro("LZ4 error while uncompressing data.");
+      return 0;
+      }
+    if (static_cast<unsigned long>(iend - ip) < length ||
+        static_cast<unsigned long>(oend - op) < length)
+      {
+      vtkErrorMacro("LZ4 error while uncompressing data.");
+      return 0;
+      }
+    memcpy(op, ip, length);
+    op += length;
+    ip += length;
+
+    // The last sequence has no match.
+    if (ip == iend)
+      {
+      break;
+      }
+
+    // Copy the match, which may overlap the bytes it produces.
+    if (iend - ip < 2)
+      {
+      vtkErrorMacro("LZ4 error while uncompressing data.");
+      return 0;
+      }
+    unsigned long offset = ip[0] | (static_cast<unsigned long>(ip[1]) << 8);
+    ip += 2;
+    if (offset == 0 ||
+        offset > static_cast<unsigned long>(op - uncompressedData))
+      {
+      vtkErrorMacro("LZ4 error while uncompressing data.");
+      return 0;
+      }
+    length = token & 15;
+    if (length == 15 &&
+        !vtkLZ4ReadLength(ip, iend, uncompressedSize, length))
+      {
+      vtkErrorMacro("LZ4 error while uncompressing data.");
+      return 0;
+      }
+    length += VTK_LZ4_MIN_MATCH;
+    if (static_cast<unsigned long>(oend - op) < length)
+      {
+      vtkErrorMacro("LZ4 error while uncompressing data.");
+      return 0;
+      }
+    const unsigned char* match = op - offset;
+    if (offset >= length)
+      {
+      memcpy(op, match, length);
+      op += length;
+      }
+    else
+      {
+      for (unsigned long i = 0; i < length; ++i)
+        {
+        *op++ = *match++;
+        }
+      }
+    }
+
+  // Make sure the output size matched that expected.
+  unsigned long decSize = static_cast<unsigned long>(op - uncompressedData);
+  if(decSize != uncompressedSize)
+    {
+    vtkErrorMacro("Decompression produced incorrect size.\n"
+                  "Expected " << uncompressedSize << " and got " << decSize);
+    return 0;
+    }
+
+  return decSize;
+}
+
+//----------------------------------------------------------------------------
+unsigned long
+vtkLZ4DataCompressor::GetMaximumCompressionSpace(unsigned long size)
+{
+  // Same bound as LZ4_compressBound().
+  return size + size/255 + 16;
+}
@@ -0,0 +1,77 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkLZ4DataCompressor.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkLZ4DataCompressor - Data compression using the LZ4 block format.
+// .SECTION Description
+// vtkLZ4DataCompressor provides a concrete vtkDataCompressor class that
+// stores data in the LZ4 block format.  LZ4 compresses less than zlib but
+// is several times faster, both ways, so that writing compressed data is
+// no longer limited by the compression.  Each buffer is one independent
+// LZ4 block, as produced by LZ4_compress_default(), and can be read back
+// by any LZ4 implementation.
+//
+// The codec is part of this class, so no external library is needed.
+// .SECTION See Also
+// vtkZLibDataCompressor vtkXMLWriter
+
+#ifndef __vtkLZ4DataCompressor_h
+#define __vtkLZ4DataCompressor_h
+
+#include "vtkDataCompressor.h"
+
+class VTK_IO_EXPORT vtkLZ4DataCompressor : public vtkDataCompressor
+{
+public:
+  vtkTypeMacro(vtkLZ4DataCompressor,vtkDataCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+  static vtkLZ4DataCompressor* New();
+
+  // Description:
+  // Get the maximum space that may be needed to store data of the
+  // given uncompressed size after compression.  This is the minimum
+  // size of the output buffer that can be passed to the four-argument
+  // Compress method.
+  unsigned long GetMaximumCompressionSpace(unsigned long size);
+
+  // Description:
+  // Get/Set the compression level, from 1 (the default, fastest) to 9
+  // (smallest output).  Level 1 only tries the last position with the same
+  // hash, like LZ4's fast mode.  Higher levels follow a chain of up to
+  // 2^(level-1) earlier positions looking for a longer match.  The level
+  // does not change the format, decompression speed is the same.
+  vtkSetClampMacro(CompressionLevel, int, 1, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+protected:
+  vtkLZ4DataCompressor();
+  ~vtkLZ4DataCompressor();
+
+  int CompressionLevel;
+
+  // Compression method required by vtkDataCompressor.
+  unsigned long CompressBuffer(const unsigned char* uncompressedData,
+                               unsigned long uncompressedSize,
+                               unsigned char* compressedData,
+                               unsigned long compressionSpace);
+  // Decompression method required by vtkDataCompressor.
+  unsigned long UncompressBuffer(const unsigned char* compressedData,
+                                 unsigned long compressedSize,
+                                 unsigned char* uncompressedData,
+                                 unsigned long uncompressedSize);
+private:
+  vtkLZ4DataCompressor(const vtkLZ4DataCompressor&);  // Not implemented.
+  void operator=(const vtkLZ4DataCompressor&);  // Not implemented.
+};
+
+#endif
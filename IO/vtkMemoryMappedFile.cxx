@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMemoryMappedFile.h"
+#include "vtkObjectFactory.h"
+
+#ifdef _WIN32
+# include "vtkWindows.h"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+vtkStandardNewMacro(vtkMemoryMappedFile);
+
+//----------------------------------------------------------------------------
+vtkMemoryMappedFile::vtkMemoryMappedFile()
+{
+  this->Data = 0;
+  this->Size = 0;
+  this->FileHandle = 0;
+  this->MappingHandle = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMemoryMappedFile::~vtkMemoryMappedFile()
+{
+  this->Close();
+}
+
+//----------------------------------------------------------------------------
+void vtkMemoryMappedFile::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "Data: " << static_cast<void*>(this->Data) << "\n";
+  os << indent << "Size: " << this->Size << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkMemoryMappedFile::Open(const char* fileName)
+{
+  this->Close();
+  if(!fileName)
+    {
+    return 0;
+    }
+
+#ifdef _WIN32
+  HANDLE file = CreateFile(fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if(file == INVALID_HANDLE_VALUE)
+    {
+    vtkDebugMacro("Cannot open " << fileName);
+    return 0;
+    }
+  LARGE_INTEGER size;
+  if(!GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+     static_cast<vtkTypeUInt64>(size.QuadPart) >
+     static_cast<vtkTypeUInt64>(static_cast<size_t>(-1)))
+    {
+    CloseHandle(file);
+    return 0;
+    }
+  HANDLE mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  if(!mapping)
+    {
+    vtkDebugMacro("Cannot map " << fileName);
+    CloseHandle(file);
+    return 0;
+    }
+  void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  if(!data)
+    {
+    vtkDebugMacro("Cannot map " << fileName);
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return 0;
+    }
+  this->FileHandle = file;
+  this->MappingHandle = mapping;
+  this->Size = static_cast<vtkTypeUInt64>(size.QuadPart);
+#else
+  int fd = open(fileName, O_RDONLY);
+  if(fd < 0)
+    {
+    vtkDebugMacro("Cannot open " << fileName);
+    return 0;
+    }
+  struct stat fs;
+  if(fstat(fd, &fs) != 0 || fs.st_size <= 0 ||
+     static_cast<vtkTypeUInt64>(fs.st_size) >
+     static_cast<vtkTypeUInt64>(static_cast<size_t>(-1)))
+    {
+    close(fd);
+    return 0;
+    }
+  // A private writable mapping gives copy-on-write pages, so the arrays
+  // wrapping it can still be modified.  The descriptor is not needed once
+  // the file is mapped.
+  size_t size = static_cast<size_t>(fs.st_size);
+  void* data = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED)
+    {
+    vtkDebugMacro("Cannot map " << fileName);
+    return 0;
+    }
+  this->Size = static_cast<vtkTypeUInt64>(size);
+#endif
+
+  this->Data = static_cast<unsigned char*>(data);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMemoryMappedFile::Close()
+{
+  if(!this->Data)
+    {
+    return;
+    }
+#ifdef _WIN32
+  UnmapViewOfFile(this->Data);
+  CloseHandle(static_cast<HANDLE>(this->MappingHandle));
+  CloseHandle(static_cast<HANDLE>(this->FileHandle));
+  this->MappingHandle = 0;
+  this->FileHandle = 0;
+#else
+  munmap(this->Data, static_cast<size_t>(this->Size));
+#endif
+  this->Data = 0;
+  this->Size = 0;
+}
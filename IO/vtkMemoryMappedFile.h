@@ -0,0 +1,78 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkMemoryMappedFile - A whole file mapped into memory.
+// .SECTION Description
+// vtkMemoryMappedFile maps a file into the address space of the process
+// with mmap() or MapViewOfFile().  The pages are read from the file on
+// first access and are copy-on-write: the memory can be modified, but the
+// changes never reach the file.  The mapping stays valid until Close()
+// is called or the object is destroyed, so code handing out pointers into
+// the mapping keeps a reference to it.  vtkXMLReader uses it to read raw
+// appended data in place.
+//
+// Pages that were never modified may show later changes made to the file
+// by other processes.  On Windows the file cannot be deleted while it is
+// mapped.
+// .SECTION See Also
+// vtkXMLReader
+
+#ifndef __vtkMemoryMappedFile_h
+#define __vtkMemoryMappedFile_h
+
+#include "vtkObject.h"
+
+class VTK_IO_EXPORT vtkMemoryMappedFile : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkMemoryMappedFile,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+  static vtkMemoryMappedFile* New();
+
+  // Description:
+  // Map the whole file, closing any previous mapping first.  Returns 1
+  // for success, 0 for failure.  Empty files cannot be mapped.
+  int Open(const char* fileName);
+
+  // Description:
+  // Unmap the file.
+  void Close();
+
+  //BTX
+  // Description:
+  // Get the first byte of the mapped file, or NULL if none is mapped.
+  unsigned char* GetData() { return this->Data; }
+
+  // Description:
+  // Get the size of the mapped file in bytes.
+  vtkTypeUInt64 GetSize() { return this->Size; }
+  //ETX
+
+protected:
+  vtkMemoryMappedFile();
+  ~vtkMemoryMappedFile();
+
+  unsigned char* Data;
+  vtkTypeUInt64 Size;
+
+  // The file and mapping handles on Windows.
+  void* FileHandle;
+  void* MappingHandle;
+
+private:
+  vtkMemoryMappedFile(const vtkMemoryMappedFile&);  // Not implemented.
+  void operator=(const vtkMemoryMappedFile&);  // Not implemented.
+};
+
+#endif
@@ -19,10 +19,13 @@
 #include "vtkCommand.h"
 #include "vtkDataCompressor.h"
 #include "vtkInputStream.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkXMLDataElement.h"
 
 #include <vtksys/ios/sstream>
+#include <vtkstd/vector>
 
 #include "vtkXMLUtilities.h"
 
@@ -30,6 +33,42 @@
 vtkStandardNewMacro(vtkXMLDataParser);
 vtkCxxSetObjectMacro(vtkXMLDataParser, Compressor, vtkDataCompressor);
 
+//----------------------------------------------------------------------------
+// Decompress and byte swap a range of the complete blocks of one batch.
+// The compressed blocks lie back to back in Input, and every block is
+// decompressed into its own place in Output.
+class vtkXMLDataParserUncompressFunctor
+{
+public:
+  vtkXMLDataParser* Parser;
+  unsigned int FirstBlock;
+  const unsigned char* Input;
+  unsigned char* Output;
+  int WordSize;
+  unsigned char* Results;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkXMLDataParser::OffsetType firstOffset =
+      this->Parser->BlockStartOffsets[this->FirstBlock];
+    unsigned int blockSize = this->Parser->BlockUncompressedSize;
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      unsigned int block = this->FirstBlock + static_cast<unsigned int>(i);
+      unsigned char* output = this->Output + i*blockSize;
+      unsigned long result = this->Parser->Compressor->Uncompress(
+        this->Input + (this->Parser->BlockStartOffsets[block] - firstOffset),
+        this->Parser->BlockCompressedSizes[block], output, blockSize);
+      if (result > 0)
+        {
+        this->Parser->PerformByteSwap(output, blockSize / this->WordSize,
+                                      this->WordSize);
+        }
+      this->Results[i] = result > 0;
+      }
+    }
+};
+
 //----------------------------------------------------------------------------
 vtkXMLDataParser::vtkXMLDataParser()
 {
@@ -46,6 +85,7 @@ vtkXMLDataParser::vtkXMLDataParser()
   this->BlockCompressedSizes = 0;
   this->BlockStartOffsets = 0;
   this->Compressor = 0;
+  this->ParallelExecution = 1;
 
   this->AsciiDataBuffer = 0;
   this->AsciiDataBufferLength = 0;
@@ -100,6 +140,7 @@ void vtkXMLDataParser::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << indent << "Compressor: (none)\n";
     }
+  os << indent << "ParallelExecution: " << this->ParallelExecution << "\n";
   os << indent << "Progress: " << this->Progress << "\n";
   os << indent << "Abort: " << this->Abort << "\n";
   os << indent << "AttributesEncoding: " << this->AttributesEncoding << "\n";
@@ -466,6 +507,36 @@ void vtkXMLDataParser::PerformByteSwap(void* data, OffsetType numWords,
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkXMLDataParser::PerformByteSwapCopy(const void* in, void* out,
+                                           OffsetType numWords, int wordSize)
+{
+  if(this->ByteOrder == vtkXMLDataParser::BigEndian)
+    {
+    switch (wordSize)
+      {
+      case 1: memcpy(out, in, numWords); break;
+      case 2: vtkByteSwap::Swap2BERangeCopy(in, out, numWords); break;
+      case 4: vtkByteSwap::Swap4BERangeCopy(in, out, numWords); break;
+      case 8: vtkByteSwap::Swap8BERangeCopy(in, out, numWords); break;
+      default:
+        vtkErrorMacro("Unsupported data type size " << wordSize);
+      }
+    }
+  else
+    {
+    switch (wordSize)
+      {
+      case 1: memcpy(out, in, numWords); break;
+      case 2: vtkByteSwap::Swap2LERangeCopy(in, out, numWords); break;
+      case 4: vtkByteSwap::Swap4LERangeCopy(in, out, numWords); break;
+      case 8: vtkByteSwap::Swap8LERangeCopy(in, out, numWords); break;
+      default:
+        vtkErrorMacro("Unsupported data type size " << wordSize);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLDataParser::ReadCompressionHeader()
 {
@@ -588,6 +659,47 @@ unsigned char* vtkXMLDataParser::ReadBlock(unsigned int block)
   return decompressBuffer;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::ReadBlocks(unsigned int firstBlock,
+                                 unsigned int numBlocks,
+                                 unsigned char* buffer, int wordSize)
+{
+  // The compressed blocks are contiguous in the stream, so the whole
+  // batch is read with one call.
+  unsigned int lastBlock = firstBlock+numBlocks-1;
+  OffsetType compressedSize = this->BlockStartOffsets[lastBlock] -
+    this->BlockStartOffsets[firstBlock] + this->BlockCompressedSizes[lastBlock];
+  if(!this->DataStream->Seek(this->BlockStartOffsets[firstBlock]))
+    {
+    return 0;
+    }
+  vtkstd::vector<unsigned char> readBuffer(compressedSize+1);
+  if(this->DataStream->Read(&readBuffer[0], compressedSize) <
+     static_cast<unsigned long>(compressedSize))
+    {
+    return 0;
+    }
+
+  vtkstd::vector<unsigned char> results(numBlocks);
+  vtkXMLDataParserUncompressFunctor functor;
+  functor.Parser = this;
+  functor.FirstBlock = firstBlock;
+  functor.Input = &readBuffer[0];
+  functor.Output = buffer;
+  functor.WordSize = wordSize;
+  functor.Results = &results[0];
+  vtkSMPTools::For(0, numBlocks, 1, functor);
+
+  for(unsigned int i=0; i < numBlocks; ++i)
+    {
+    if(!results[i])
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 vtkXMLDataParser::OffsetType
 vtkXMLDataParser::ReadUncompressedData(unsigned char* data,
@@ -717,12 +829,12 @@ vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     unsigned char* blockBuffer = this->ReadBlock(firstBlock);
     if(!blockBuffer) { return 0; }
     long n = endBlockOffset - beginBlockOffset;
-    memcpy(data, blockBuffer+beginBlockOffset, n);
-    delete [] blockBuffer;
 
-    // Byte swap this block.  Note that n will always be an integer
-    // multiple of the word size.
-    this->PerformByteSwap(data, n / wordSize, wordSize);
+    // Byte swap this block while copying it.  Note that n will always
+    // be an integer multiple of the word size.
+    this->PerformByteSwapCopy(blockBuffer+beginBlockOffset, data,
+                              n / wordSize, wordSize);
+    delete [] blockBuffer;
     }
   else
     {
@@ -738,12 +850,12 @@ vtkXMLDataParser::ReadCompressedData(unsigned char* data,
       return 0;
       }
     long n = blockSize-beginBlockOffset;
-    memcpy(outputPointer, blockBuffer+beginBlockOffset, n);
-    delete [] blockBuffer;
 
-    // Byte swap the first block.  Note that n will always be an
-    // integer multiple of the word size.
-    this->PerformByteSwap(outputPointer, n / wordSize, wordSize);
+    // Byte swap the first block while copying it.  Note that n will
+    // always be an integer multiple of the word size.
+    this->PerformByteSwapCopy(blockBuffer+beginBlockOffset, outputPointer,
+                              n / wordSize, wordSize);
+    delete [] blockBuffer;
 
     // Advance the pointer to the beginning of the second block.
     outputPointer += blockSize-beginBlockOffset;
@@ -752,6 +864,34 @@ vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     this->UpdateProgress(float(outputPointer-data)/length);
 
     unsigned int currentBlock = firstBlock+1;
+    if(this->ParallelExecution)
+      {
+      // Decompress the complete blocks a batch at a time.  A batch gives
+      // every thread several blocks.
+      int numThreads = vtkSMPTools::GetNumberOfThreads();
+      if(numThreads <= 0)
+        {
+        numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+        }
+      unsigned int batchBlocks = 4*numThreads;
+      while(currentBlock != lastBlock && !this->Abort)
+        {
+        unsigned int n = lastBlock - currentBlock;
+        if(n > batchBlocks)
+          {
+          n = batchBlocks;
+          }
+        if(!this->ReadBlocks(currentBlock, n, outputPointer, wordSize))
+          {
+          return 0;
+          }
+        outputPointer += n*blockSize;
+        currentBlock += n;
+
+        // Report progress.
+        this->UpdateProgress(float(outputPointer-data)/length);
+        }
+      }
     for(;currentBlock != lastBlock && !this->Abort; ++currentBlock)
       {
       // Read this block.
@@ -776,12 +916,13 @@ vtkXMLDataParser::ReadCompressedData(unsigned char* data,
         {
         return 0;
         }
-      memcpy(outputPointer, blockBuffer, endBlockOffset);
-      delete [] blockBuffer;
 
-      // Byte swap the partial block.  Note that endBlockOffset will
-      // always be an integer multiple of the word size.
-      this->PerformByteSwap(outputPointer, endBlockOffset / wordSize, wordSize);
+      // Byte swap the partial block while copying it.  Note that
+      // endBlockOffset will always be an integer multiple of the word
+      // size.
+      this->PerformByteSwapCopy(blockBuffer, outputPointer,
+                                endBlockOffset / wordSize, wordSize);
+      delete [] blockBuffer;
       }
     }
   this->UpdateProgress(1);
@@ -836,6 +977,40 @@ vtkXMLDataParser::ReadBinaryData(void* in_buffer,
   return this->Abort? 0:actualWords;
 }
 
+//----------------------------------------------------------------------------
+vtkXMLDataParser::OffsetType
+vtkXMLDataParser::FindRawAppendedData(OffsetType offset, OffsetType& numBytes)
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  const int nativeByteOrder = vtkXMLDataParser::BigEndian;
+#else
+  const int nativeByteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  if(!this->AppendedDataPosition || this->Compressor ||
+     this->ByteOrder != nativeByteOrder ||
+     this->AppendedDataStream->IsA("vtkBase64InputStream"))
+    {
+    return -1;
+    }
+
+  // Read the length of the data.
+  this->DataStream = this->AppendedDataStream;
+  this->SeekG(this->AppendedDataPosition+offset);
+  this->DataStream->SetStream(this->Stream);
+  this->DataStream->StartReading();
+  HeaderType rsize;
+  const unsigned long len = sizeof(HeaderType);
+  unsigned long n =
+    this->DataStream->Read(reinterpret_cast<unsigned char*>(&rsize), len);
+  this->DataStream->EndReading();
+  if(n < len)
+    {
+    return -1;
+    }
+  numBytes = rsize;
+  return this->AppendedDataPosition+offset+len;
+}
+
 //----------------------------------------------------------------------------
 vtkXMLDataParser::OffsetType
 vtkXMLDataParser::ReadAsciiData(void* buffer,
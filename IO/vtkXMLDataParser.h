@@ -90,6 +90,15 @@ public:
   // stream.  Returns the number of words read.
   OffsetType ReadBinaryData(void* buffer, OffsetType startWord,
                             OffsetType maxWords, int wordType);
+
+  // Description:
+  // Find the bytes of the appended data array at the given appended
+  // data offset in the input stream.  Returns the stream position of the
+  // first byte and sets numBytes to the data size stored in front of
+  // them.  Returns -1 when the bytes cannot be used as they are: the
+  // appended data is base64 encoded or compressed, or not in the native
+  // byte order.
+  OffsetType FindRawAppendedData(OffsetType offset, OffsetType& numBytes);
   //ETX
 
   // Description:
@@ -98,6 +107,15 @@ public:
   virtual void SetCompressor(vtkDataCompressor*);
   vtkGetObjectMacro(Compressor, vtkDataCompressor);
 
+  // Description:
+  // Turn on/off decompressing the blocks of compressed data on several
+  // threads with vtkSMPTools.  The compressed bytes of a batch of blocks
+  // are read at once and then decompressed straight into the output
+  // buffer.  Default is on.
+  vtkSetMacro(ParallelExecution, int);
+  vtkGetMacro(ParallelExecution, int);
+  vtkBooleanMacro(ParallelExecution, int);
+
   // Description:
   // Get the size of a word of the given type.
   unsigned long GetWordTypeSize(int wordType);
@@ -159,12 +177,17 @@ protected:
   vtkXMLDataElement* PopOpenElement();
   void FreeAllElements();
   void PerformByteSwap(void* data, OffsetType numWords, int wordSize);
+  // Copy the words and swap them in the same pass.
+  void PerformByteSwapCopy(const void* in, void* out, OffsetType numWords,
+                           int wordSize);
 
   // Data reading methods.
   void ReadCompressionHeader();
   unsigned int FindBlockSize(unsigned int block);
   int ReadBlock(unsigned int block, unsigned char* buffer);
   unsigned char* ReadBlock(unsigned int block);
+  int ReadBlocks(unsigned int firstBlock, unsigned int numBlocks,
+                 unsigned char* buffer, int wordSize);
   OffsetType ReadUncompressedData(unsigned char* data,
                                   OffsetType startWord,
                                   OffsetType numWords,
@@ -233,6 +256,7 @@ protected:
   unsigned int PartialLastBlockUncompressedSize;
   HeaderType* BlockCompressedSizes;
   OffsetType* BlockStartOffsets;
+  int ParallelExecution;
 
   // Ascii data parsing.
   unsigned char* AsciiDataBuffer;
@@ -248,6 +272,10 @@ protected:
 
   int AttributesEncoding;
 
+  //BTX
+  friend class vtkXMLDataParserUncompressFunctor;
+  //ETX
+
 private:
   vtkXMLDataParser(const vtkXMLDataParser&);  // Not implemented.
   void operator=(const vtkXMLDataParser&);  // Not implemented.
@@ -20,6 +20,7 @@
 #include "vtkDataArray.h"
 #include "vtkDataArraySelection.h"
 #include "vtkDataSet.h"
+#include "vtkMemoryMappedFile.h"
 #include "vtkPointData.h"
 #include "vtkXMLDataElement.h"
 #include "vtkXMLDataParser.h"
@@ -760,19 +761,26 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
     }
   this->InReadData = 1;
   int result;
-  // All arrays types except vtkBitArray.
-  vtkArrayIterator* iter = array->NewIterator();
-  switch (array->GetDataType())
+  if (this->MapArrayValues(da, arrayIndex, array, startIndex, numValues))
     {
-    vtkArrayIteratorTemplateMacro(
-      result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
-        arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
-  default:
-    result = 0;
+    result = 1;
     }
-  if (iter)
+  else
     {
-    iter->Delete();
+    // All arrays types except vtkBitArray.
+    vtkArrayIterator* iter = array->NewIterator();
+    switch (array->GetDataType())
+      {
+      vtkArrayIteratorTemplateMacro(
+        result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
+          arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
+    default:
+      result = 0;
+      }
+    if (iter)
+      {
+      iter->Delete();
+      }
     }
   // Marking the array modified is essential, since otherwise, when reading
   // multiple time-steps, the array does not realize that its contents may have
@@ -786,6 +794,50 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
   return result;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataReader::MapArrayValues(vtkXMLDataElement* da,
+                                     vtkIdType arrayIndex,
+                                     vtkAbstractArray* array,
+                                     vtkIdType startIndex,
+                                     vtkIdType numValues)
+{
+  // The array must be filled whole from the start of its appended data.
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  if (!this->MapAppendedData || !dataArray ||
+      dataArray->GetDataType() == VTK_BIT || arrayIndex != 0 ||
+      startIndex != 0 || numValues <= 0 || !da->GetAttribute("offset") ||
+      numValues != (dataArray->GetNumberOfTuples() *
+                    dataArray->GetNumberOfComponents()))
+    {
+    return 0;
+    }
+  vtkMemoryMappedFile* file = this->GetMappedFile();
+  if (!file)
+    {
+    return 0;
+    }
+
+  unsigned long offset = 0;
+  da->GetScalarAttribute("offset", offset);
+  vtkXMLDataParser::OffsetType numBytes = 0;
+  vtkXMLDataParser::OffsetType position =
+    this->XMLParser->FindRawAppendedData(offset, numBytes);
+
+  // The mapping starts on a page boundary, so the values are aligned in
+  // memory when their file position is.
+  vtkXMLDataParser::OffsetType wordSize = dataArray->GetDataTypeSize();
+  vtkXMLDataParser::OffsetType length = numValues*wordSize;
+  if (position < 0 || position % wordSize != 0 || numBytes < length ||
+      static_cast<vtkTypeUInt64>(position + length) > file->GetSize())
+    {
+    return 0;
+    }
+
+  dataArray->SetVoidArray(file->GetData() + position, numValues, 1);
+  dataArray->GetInformation()->Set(vtkXMLReader::MAPPED_FILE(), file);
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLDataReader::DataProgressCallbackFunction(vtkObject*, unsigned long,
                                                     void* clientdata, void*)
@@ -87,6 +87,14 @@ protected:
   // values will be put in the array.
   int ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex, vtkAbstractArray* array,
     vtkIdType startIndex, vtkIdType numValues);
+
+  // Make the array wrap its values in the mapped file instead of reading
+  // them, see vtkXMLReader::SetMapAppendedData().  Only whole arrays
+  // with raw, aligned appended data qualify.  Returns 1 if the array now
+  // wraps the mapping, 0 if the values must be read.
+  int MapArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex,
+                     vtkAbstractArray* array, vtkIdType startIndex,
+                     vtkIdType numValues);
     
 
   
@@ -19,7 +19,10 @@
 #include "vtkDataCompressor.h"
 #include "vtkDataSet.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkInformationObjectBaseKey.h"
 #include "vtkInstantiator.h"
+#include "vtkLZ4DataCompressor.h"
+#include "vtkMemoryMappedFile.h"
 #include "vtkObjectFactory.h"
 #include "vtkXMLDataElement.h"
 #include "vtkXMLDataParser.h"
@@ -77,6 +80,9 @@ static void ReadStringVersion(const char* version, int& major, int& minor)
       }
     }
 }
+
+vtkInformationKeyMacro(vtkXMLReader, MAPPED_FILE, ObjectBase);
+
 //----------------------------------------------------------------------------
 vtkXMLReader::vtkXMLReader()
 {
@@ -119,6 +125,11 @@ vtkXMLReader::vtkXMLReader()
   this->CurrentTimeStep = 0;
   this->TimeStepWasReadOnce = 0;
 
+  this->ParallelExecution = 1;
+  this->MapAppendedData = 0;
+  this->MappedFile = 0;
+  this->MappedFileFailed = 0;
+
   this->FileMinorVersion = -1;
   this->FileMajorVersion = -1;
   
@@ -139,6 +150,10 @@ vtkXMLReader::~vtkXMLReader()
   this->CellDataArraySelection->Delete();
   this->PointDataArraySelection->Delete();
   delete[] this->TimeSteps;
+  if(this->MappedFile)
+    {
+    this->MappedFile->Delete();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -163,6 +178,8 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NumberOfTimeSteps:" << this->NumberOfTimeSteps << "\n";
   os << indent << "TimeStepRange:(" << this->TimeStepRange[0] << "," 
                                     << this->TimeStepRange[1] << ")\n";
+  os << indent << "ParallelExecution: " << this->ParallelExecution << "\n";
+  os << indent << "MapAppendedData: " << this->MapAppendedData << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -259,6 +276,37 @@ void vtkXMLReader::CloseVTKFile()
     this->FileStream = 0;
     this->Stream = 0;
     }
+
+  // Arrays that wrap the mapping keep their own reference to it.
+  if(this->MappedFile)
+    {
+    this->MappedFile->Delete();
+    this->MappedFile = 0;
+    }
+  this->MappedFileFailed = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMemoryMappedFile* vtkXMLReader::GetMappedFile()
+{
+  if(!this->MapAppendedData || !this->FileName || !this->FileStream ||
+     this->Stream != this->FileStream)
+    {
+    return 0;
+    }
+  if(!this->MappedFile && !this->MappedFileFailed)
+    {
+    this->MappedFile = vtkMemoryMappedFile::New();
+    if(!this->MappedFile->Open(this->FileName))
+      {
+      vtkDebugMacro("Cannot map " << this->FileName
+                    << ", reading appended data normally.");
+      this->MappedFile->Delete();
+      this->MappedFile = 0;
+      this->MappedFileFailed = 1;
+      }
+    }
+  return this->MappedFile;
 }
 
 //----------------------------------------------------------------------------
@@ -270,6 +318,7 @@ void vtkXMLReader::CreateXMLParser()
     this->DestroyXMLParser();
     }
   this->XMLParser = vtkXMLDataParser::New();
+  this->XMLParser->SetParallelExecution(this->ParallelExecution);
 }
 
 //----------------------------------------------------------------------------
@@ -296,12 +345,16 @@ void vtkXMLReader::SetupCompressor(const char* type)
   vtkObject* object = vtkInstantiator::CreateInstance(type);
   vtkDataCompressor* compressor = vtkDataCompressor::SafeDownCast(object);
   
-  // In static builds, the vtkZLibDataCompressor may not have been
-  // registered with the vtkInstantiator.  Check for it here.
+  // In static builds, the compressors may not have been registered
+  // with the vtkInstantiator.  Check for them here.
   if(!compressor && (strcmp(type, "vtkZLibDataCompressor") == 0))
     {
     compressor = vtkZLibDataCompressor::New();
     }
+  else if(!compressor && (strcmp(type, "vtkLZ4DataCompressor") == 0))
+    {
+    compressor = vtkLZ4DataCompressor::New();
+    }
   
   if(!compressor)
     {
@@ -32,6 +32,8 @@ class vtkXMLDataElement;
 class vtkXMLDataParser;
 class vtkInformationVector;
 class vtkInformation;
+class vtkInformationObjectBaseKey;
+class vtkMemoryMappedFile;
 
 class VTK_IO_EXPORT vtkXMLReader : public vtkAlgorithm
 {
@@ -95,6 +97,34 @@ public:
   vtkGetVector2Macro(TimeStepRange, int);
   vtkSetVector2Macro(TimeStepRange, int);
 
+  // Description:
+  // Turn on/off decompressing the blocks of compressed data on several
+  // threads.  This is passed to the vtkXMLDataParser that reads the
+  // file.  Default is on.
+  vtkSetMacro(ParallelExecution, int);
+  vtkGetMacro(ParallelExecution, int);
+  vtkBooleanMacro(ParallelExecution, int);
+
+  // Description:
+  // Turn on/off reading raw appended data in place.  When on, and the
+  // file is read from FileName with raw, uncompressed appended data in
+  // the native byte order, the file is mapped into memory with
+  // vtkMemoryMappedFile and every array that is read whole and whose
+  // data are suitably aligned in the file wraps the mapped bytes instead
+  // of copying them.  Such an array keeps the mapping alive through its
+  // MAPPED_FILE() information entry.  The pages are copy-on-write, so the
+  // arrays can be modified, but unmodified pages may show later changes
+  // to the file.  vtkXMLWriter aligns raw, uncompressed appended arrays
+  // for this.  Default is off.
+  vtkSetMacro(MapAppendedData, int);
+  vtkGetMacro(MapAppendedData, int);
+  vtkBooleanMacro(MapAppendedData, int);
+
+  // Description:
+  // Key set on the information of arrays that wrap a mapped file, which
+  // holds a reference to the vtkMemoryMappedFile.
+  static vtkInformationObjectBaseKey* MAPPED_FILE();
+
   virtual int ProcessRequest(vtkInformation *request,
                              vtkInformationVector **inputVector,
                              vtkInformationVector *outputVector);
@@ -147,6 +177,12 @@ protected:
   // Internal utility methods.
   virtual int OpenVTKFile();
   virtual void CloseVTKFile();
+
+  // Get the mapping of FileName used to read appended data in place.  It
+  // is created on first use and released by CloseVTKFile().  Returns
+  // NULL when MapAppendedData is off, the input does not come from
+  // FileName, or the file cannot be mapped.
+  vtkMemoryMappedFile* GetMappedFile();
   virtual void CreateXMLParser();
   virtual void DestroyXMLParser();
   void SetupCompressor(const char* type);
@@ -259,6 +295,9 @@ protected:
   // Store the range of time steps
   int TimeStepRange[2];
 
+  int ParallelExecution;
+  int MapAppendedData;
+
   // Now we need to save what was the last time read for each kind of 
   // data to avoid rereading it that is to say we need a var for 
   // e.g. PointData/CellData/Points/Cells...
@@ -273,6 +312,10 @@ protected:
 private:
   // The stream used to read the input if it is in a file.
   ifstream* FileStream;  
+
+  // The mapping of the file being read, see GetMappedFile().
+  vtkMemoryMappedFile* MappedFile;
+  int MappedFileFailed;
   int TimeStepWasReadOnce;
 
   int FileMajorVersion;
@@ -24,9 +24,12 @@
 #include "vtkErrorCode.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkLZ4DataCompressor.h"
+#include "vtkMultiThreader.h"
 #include "vtkOutputStream.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
@@ -42,6 +45,7 @@
 
 #include <assert.h>
 #include <vtkstd/string>
+#include <vtkstd/vector>
 
 #if !defined(_WIN32) || defined(__CYGWIN__)
 # include <unistd.h> /* unlink */
@@ -79,6 +83,79 @@ public:
    {
    return writer->ByteSwapBuffer;
    }
+ static inline int CompressesInParallel(vtkXMLWriter* writer)
+   {
+   return writer->Compressor && writer->ParallelExecution;
+   }
+ static inline int WriteCompressionBlocks(vtkXMLWriter* writer,
+   unsigned char* data, vtkXMLWriter::OffsetType numWords,
+   vtkXMLWriter::OffsetType memWordSize, int wordType)
+   {
+   return writer->WriteCompressionBlocks(data, numWords, memWordSize,
+                                         wordType);
+   }
+};
+
+//----------------------------------------------------------------------------
+// Convert, byte swap and compress a range of the blocks of one batch.
+// Every block has its own slot in the scratch and output buffers, so the
+// blocks of a batch are independent.
+class vtkXMLWriterCompressFunctor
+{
+public:
+  vtkXMLWriter* Writer;
+  unsigned char* Data;
+  vtkXMLWriter::OffsetType NumberOfWords;
+  vtkXMLWriter::OffsetType BlockWords;
+  vtkXMLWriter::OffsetType MemWordSize;
+  vtkXMLWriter::OffsetType OutWordSize;
+  int ConvertIds;
+  int Swap;
+  unsigned char* Scratch;
+  unsigned char* Output;
+  unsigned long CompressionSpace;
+  unsigned long* CompressedSizes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkXMLWriter::OffsetType firstWord = i*this->BlockWords;
+      vtkXMLWriter::OffsetType numWords = this->NumberOfWords - firstWord;
+      if (numWords > this->BlockWords)
+        {
+        numWords = this->BlockWords;
+        }
+      unsigned char* data = this->Data + firstWord*this->MemWordSize;
+      unsigned char* scratch = this->Scratch + i*this->Writer->BlockSize;
+#ifdef VTK_USE_64BIT_IDS
+      if (this->ConvertIds)
+        {
+        vtkIdType* ids = reinterpret_cast<vtkIdType*>(data);
+        vtkXMLWriter::Int32IdType* out =
+          reinterpret_cast<vtkXMLWriter::Int32IdType*>(scratch);
+        for (vtkXMLWriter::OffsetType j = 0; j < numWords; ++j)
+          {
+          out[j] = static_cast<vtkXMLWriter::Int32IdType>(ids[j]);
+          }
+        data = scratch;
+        }
+#endif
+      if (this->Swap)
+        {
+        if (data != scratch)
+          {
+          memcpy(scratch, data, numWords*this->OutWordSize);
+          data = scratch;
+          }
+        this->Writer->PerformByteSwap(scratch, numWords,
+                                      static_cast<int>(this->OutWordSize));
+        }
+      this->CompressedSizes[i] = this->Writer->Compressor->Compress(
+        data, numWords*this->OutWordSize,
+        this->Output + i*this->CompressionSpace, this->CompressionSpace);
+      }
+    }
 };
 
 //----------------------------------------------------------------------------
@@ -96,6 +173,14 @@ int vtkXMLWriterWriteBinaryDataBlocks(vtkXMLWriter* writer,
   unsigned char* ptr = reinterpret_cast<unsigned char*>(iter->GetTuple(0));
   vtkXMLWriter::OffsetType wordsLeft = numWords;
 
+  // The array is contiguous, so compressed output can cut it into all its
+  // blocks at once and compress them on several threads.
+  if(vtkXMLWriterHelper::CompressesInParallel(writer))
+    {
+    return vtkXMLWriterHelper::WriteCompressionBlocks(writer, ptr, numWords,
+                                                      memWordSize, wordType);
+    }
+
   // Do the complete blocks.
   vtkXMLWriterHelper::SetProgressPartial(writer, 0);
   int result = 1;
@@ -214,7 +299,6 @@ int vtkXMLWriterWriteBinaryDataBlocks(vtkXMLWriter* writer,
 }
 //*****************************************************************************
 
-vtkCxxSetObjectMacro(vtkXMLWriter, Compressor, vtkDataCompressor);
 //----------------------------------------------------------------------------
 vtkXMLWriter::vtkXMLWriter()
 {
@@ -244,6 +328,8 @@ vtkXMLWriter::vtkXMLWriter()
   this->CompressionHeader = 0;
   this->Int32IdTypeBuffer = 0;
   this->ByteSwapBuffer = 0;
+  this->ParallelExecution = 1;
+  this->CompressionLevel = -1;
 
   this->EncodeAppendedData = 1;
   this->AppendedDataPosition = 0;
@@ -279,6 +365,45 @@ vtkXMLWriter::~vtkXMLWriter()
   delete[] this->NumberOfTimeValues;
 }
 
+//----------------------------------------------------------------------------
+void vtkXMLWriter::SetCompressor(vtkDataCompressor* compressor)
+{
+  if (this->Compressor == compressor)
+    {
+    return;
+    }
+  if (this->Compressor)
+    {
+    this->Compressor->UnRegister(this);
+    }
+  this->Compressor = compressor;
+  if (this->Compressor)
+    {
+    this->Compressor->Register(this);
+    if (this->CompressionLevel >= 0)
+      {
+      this->Compressor->SetCompressionLevel(this->CompressionLevel);
+      }
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkXMLWriter::SetCompressionLevel(int level)
+{
+  level = (level < 1 ? -1 : (level > 9 ? 9 : level));
+  if (this->CompressionLevel == level)
+    {
+    return;
+    }
+  this->CompressionLevel = level;
+  if (this->Compressor && level >= 0)
+    {
+    this->Compressor->SetCompressionLevel(level);
+    }
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLWriter::SetCompressorType(int compressorType)
 {
@@ -293,17 +418,42 @@ void vtkXMLWriter::SetCompressorType(int compressorType)
     return;
     }
 
+  const char* type;
   if (compressorType == ZLIB)
     {
-    if (this->Compressor && !this->Compressor->IsTypeOf("vtkZLibDataCompressor"))
-      {
-      this->Compressor->Delete();
-      }
+    type = "vtkZLibDataCompressor";
+    }
+  else if (compressorType == LZ4)
+    {
+    type = "vtkLZ4DataCompressor";
+    }
+  else
+    {
+    vtkWarningMacro("Unknown compressor type " << compressorType << ".");
+    return;
+    }
 
-    this->Compressor = vtkZLibDataCompressor::New();
-    this->Modified();
+  if (this->Compressor && this->Compressor->IsTypeOf(type))
+    {
     return;
     }
+  if (this->Compressor)
+    {
+    this->Compressor->Delete();
+    }
+  if (compressorType == ZLIB)
+    {
+    this->Compressor = vtkZLibDataCompressor::New();
+    }
+  else
+    {
+    this->Compressor = vtkLZ4DataCompressor::New();
+    }
+  if (this->CompressionLevel >= 0)
+    {
+    this->Compressor->SetCompressionLevel(this->CompressionLevel);
+    }
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -350,6 +500,8 @@ void vtkXMLWriter::PrintSelf(ostream& os, vtkIndent indent)
     }
   os << indent << "EncodeAppendedData: " << this->EncodeAppendedData << "\n";
   os << indent << "BlockSize: " << this->BlockSize << "\n";
+  os << indent << "ParallelExecution: " << this->ParallelExecution << "\n";
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
   if(this->Stream)
     {
     os << indent << "Stream: " << this->Stream << "\n";
@@ -1095,11 +1247,13 @@ int vtkXMLWriter::WriteBinaryDataInternal(vtkAbstractArray* a,
     }
 
 #ifdef VTK_USE_64BIT_IDS
-  // Free the id-type conversion buffer if it was allocated.
+  // Free the id-type conversion buffer if it was allocated.  The byte
+  // swap buffer may share it.
   if(this->Int32IdTypeBuffer)
     {
     delete [] this->Int32IdTypeBuffer;
     this->Int32IdTypeBuffer = 0;
+    this->ByteSwapBuffer = 0;
     }
 #endif
   return ret;
@@ -1300,6 +1454,98 @@ int vtkXMLWriter::WriteCompressionBlock(unsigned char* data,
   return result;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLWriter::WriteCompressionBlocks(unsigned char* data,
+                                         OffsetType numWords,
+                                         OffsetType memWordSize,
+                                         int wordType)
+{
+  OffsetType outWordSize = this->GetOutputWordTypeSize(wordType);
+  OffsetType blockWords = this->BlockSize/outWordSize;
+  OffsetType numBlocks = (numWords + blockWords - 1)/blockWords;
+  if(numBlocks == 0)
+    {
+    return 1;
+    }
+
+  vtkXMLWriterCompressFunctor functor;
+  functor.Writer = this;
+  functor.BlockWords = blockWords;
+  functor.MemWordSize = memWordSize;
+  functor.OutWordSize = outWordSize;
+  functor.ConvertIds = 0;
+#ifdef VTK_USE_64BIT_IDS
+  functor.ConvertIds =
+    (wordType == VTK_ID_TYPE) && (this->IdType == vtkXMLWriter::Int32);
+#endif
+  functor.Swap = this->ByteSwapBuffer != 0;
+  functor.CompressionSpace =
+    this->Compressor->GetMaximumCompressionSpace(this->BlockSize);
+
+  // Blocks are compressed a batch at a time so that only a few of them
+  // are held in memory.  A batch gives every thread several blocks.
+  int numThreads = vtkSMPTools::GetNumberOfThreads();
+  if(numThreads <= 0)
+    {
+    numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  OffsetType batchBlocks = 4*numThreads;
+  if(batchBlocks > numBlocks)
+    {
+    batchBlocks = numBlocks;
+    }
+  int needScratch = functor.ConvertIds || functor.Swap;
+  vtkstd::vector<unsigned char> scratch(
+    needScratch? batchBlocks*this->BlockSize : 0);
+  vtkstd::vector<unsigned char> output(batchBlocks*functor.CompressionSpace);
+  vtkstd::vector<unsigned long> sizes(batchBlocks);
+  functor.Scratch = needScratch? &scratch[0] : 0;
+  functor.Output = &output[0];
+  functor.CompressedSizes = &sizes[0];
+
+  this->SetProgressPartial(0);
+  int result = 1;
+  OffsetType firstBlock = 0;
+  while(result && firstBlock < numBlocks)
+    {
+    OffsetType n = numBlocks - firstBlock;
+    if(n > batchBlocks)
+      {
+      n = batchBlocks;
+      }
+    OffsetType firstWord = firstBlock*blockWords;
+    functor.Data = data + firstWord*memWordSize;
+    functor.NumberOfWords = numWords - firstWord;
+    vtkSMPTools::For(0, n, 1, functor);
+
+    // Write the compressed blocks in order and record their sizes.
+    for(OffsetType i = 0; result && i < n; ++i)
+      {
+      if(!sizes[i])
+        {
+        vtkErrorMacro("Compressing block " << (firstBlock+i) << " of "
+                      << numBlocks << " failed.");
+        result = 0;
+        break;
+        }
+      result = this->DataStream->Write(&output[i*functor.CompressionSpace],
+                                       sizes[i]);
+      this->CompressionHeader[3+this->CompressionBlockNumber++] =
+        static_cast<HeaderType>(sizes[i]);
+      }
+    this->Stream->flush();
+    if (this->Stream->fail())
+      {
+      this->SetErrorCode(vtkErrorCode::GetLastSystemError());
+      return 0;
+      }
+    firstBlock += n;
+    this->SetProgressPartial(float(firstBlock)/numBlocks);
+    }
+  this->SetProgressPartial(1);
+  return result;
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionHeader()
 {
@@ -1763,6 +2009,19 @@ void vtkXMLWriter::WriteArrayAppended(
 void vtkXMLWriter::WriteArrayAppendedData(vtkAbstractArray* a,
   OffsetType pos, OffsetType& lastoffset)
 {
+  if(!this->EncodeAppendedData && !this->Compressor)
+    {
+    // Pad raw values to an 8 byte boundary in the file so that readers
+    // can use them in place, see vtkXMLReader::SetMapAppendedData().
+    // Readers seek to each offset, so the padding is never read.
+    ostream& os = *(this->Stream);
+    OffsetType end = static_cast<OffsetType>(os.tellp()) +
+      static_cast<OffsetType>(sizeof(HeaderType));
+    for(OffsetType i = end; i % 8 != 0; ++i)
+      {
+      os.put('\0');
+      }
+    }
   this->WriteAppendedDataOffset(pos, lastoffset, "offset");
   this->WriteBinaryData(a); 
 }
@@ -114,7 +114,8 @@ public:
   enum CompressorType
     {
     NONE,
-    ZLIB
+    ZLIB,
+    LZ4
     };
 //ETX
 
@@ -129,6 +130,18 @@ public:
     {
     this->SetCompressorType(ZLIB);
     }
+  void SetCompressorTypeToLZ4()
+    {
+    this->SetCompressorType(LZ4);
+    }
+
+  // Description:
+  // Get/Set the compression level given to the compressor, from 1
+  // (fastest) to 9 (smallest output).  The level is kept when the
+  // compressor is replaced.  The default, -1, leaves every compressor at
+  // its own default level.
+  virtual void SetCompressionLevel(int level);
+  vtkGetMacro(CompressionLevel, int);
 
   // Description:
   // Get/Set the block size used in compression.  When reading, this
@@ -157,6 +170,15 @@ public:
   vtkSetMacro(EncodeAppendedData, int);
   vtkGetMacro(EncodeAppendedData, int);
   vtkBooleanMacro(EncodeAppendedData, int);
+
+  // Description:
+  // Turn on/off compressing the blocks of binary and appended data on
+  // several threads with vtkSMPTools.  The blocks are independent, so
+  // they are compressed a batch at a time and then written in order;
+  // the file is the same either way.  Default is on.
+  vtkSetMacro(ParallelExecution, int);
+  vtkGetMacro(ParallelExecution, int);
+  vtkBooleanMacro(ParallelExecution, int);
   
   // Description:
   // Set/Get an input of this algorithm. You should not override these
@@ -280,6 +302,8 @@ protected:
   HeaderType*    CompressionHeader;
   unsigned int   CompressionHeaderLength;
   OffsetType  CompressionHeaderPosition;
+  int ParallelExecution;
+  int CompressionLevel;
   
   // The output stream used to write binary and appended data.  May
   // transparently encode the data.
@@ -416,6 +440,8 @@ protected:
   void PerformByteSwap(void* data, OffsetType numWords, int wordSize);
   int CreateCompressionHeader(OffsetType size);
   int WriteCompressionBlock(unsigned char* data, OffsetType size);
+  int WriteCompressionBlocks(unsigned char* data, OffsetType numWords,
+                             OffsetType memWordSize, int wordType);
   int WriteCompressionHeader();
   OffsetType GetWordTypeSize(int dataType);
   const char* GetWordTypeName(int dataType);
@@ -452,6 +478,7 @@ protected:
   unsigned long *NumberOfTimeValues; //one per piece / per timestep
   //BTX
   friend class vtkXMLWriterHelper;
+  friend class vtkXMLWriterCompressFunctor;
   //ETX
 
 private:
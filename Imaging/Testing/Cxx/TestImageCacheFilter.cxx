@@ -0,0 +1,172 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageCacheFilter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Scroll through a volume with vtkImageCacheFilter the way a slice viewer
+// does.  A request inside a cached image must not update the source, a
+// request shifted by one slice must only ask the source for that slice,
+// and the memory limit must drop the older images.  The data must always
+// match the source.
+
+#include "vtkImageAlgorithm.h"
+#include "vtkImageCacheFilter.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+// A source recording the extents it produces.
+class vtkTestCacheSource : public vtkImageAlgorithm
+{
+public:
+  static vtkTestCacheSource *New();
+  vtkTypeMacro(vtkTestCacheSource, vtkImageAlgorithm);
+
+  int Executions;
+  int LastExtent[6];
+
+protected:
+  vtkTestCacheSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->Executions = 0;
+    }
+
+  virtual int RequestInformation(vtkInformation *, vtkInformationVector **,
+                                 vtkInformationVector *outputVector)
+    {
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    int wholeExtent[6] = { 0, 15, 0, 15, 0, 15 };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+                 wholeExtent, 6);
+    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_FLOAT, 1);
+    return 1;
+    }
+
+  virtual int RequestData(vtkInformation *, vtkInformationVector **,
+                          vtkInformationVector *outputVector)
+    {
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkImageData *output = vtkImageData::GetData(outInfo);
+    int *ext = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT());
+    this->AllocateOutputData(output, ext);
+    float *ptr = static_cast<float *>(output->GetScalarPointer());
+    for (int z = ext[4]; z <= ext[5]; ++z)
+      {
+      for (int y = ext[2]; y <= ext[3]; ++y)
+        {
+        for (int x = ext[0]; x <= ext[1]; ++x)
+          {
+          *ptr++ = x + 100.0f * y + 10000.0f * z;
+          }
+        }
+      }
+    for (int i = 0; i < 6; ++i)
+      {
+      this->LastExtent[i] = ext[i];
+      }
+    ++this->Executions;
+    return 1;
+    }
+
+private:
+  vtkTestCacheSource(const vtkTestCacheSource&);  // Not implemented.
+  void operator=(const vtkTestCacheSource&);  // Not implemented.
+};
+
+vtkStandardNewMacro(vtkTestCacheSource);
+
+// Update slices zmin to zmax and check the output and what the source
+// produced.  A negative execZ means the source must not execute.
+static int Scroll(vtkImageCacheFilter *cache, vtkTestCacheSource *source,
+                  int zmin, int zmax, int execZMin, int execZMax)
+{
+  int executions = source->Executions;
+  int extent[6] = { 0, 15, 0, 15, zmin, zmax };
+  cache->UpdateInformation();
+  cache->GetOutput()->SetUpdateExtent(extent);
+  cache->Update();
+
+  vtkImageData *output = cache->GetOutput();
+  int *outExt = output->GetExtent();
+  if (outExt[4] > zmin || outExt[5] < zmax)
+    {
+    cerr << "Slices " << zmin << " to " << zmax << ": the output only has "
+         << outExt[4] << " to " << outExt[5] << endl;
+    return 0;
+    }
+  for (int z = zmin; z <= zmax; ++z)
+    {
+    for (int y = 0; y <= 15; ++y)
+      {
+      for (int x = 0; x <= 15; ++x)
+        {
+        if (output->GetScalarComponentAsDouble(x, y, z, 0) !=
+            x + 100.0 * y + 10000.0 * z)
+          {
+          cerr << "Slices " << zmin << " to " << zmax << ": wrong value at "
+               << x << " " << y << " " << z << endl;
+          return 0;
+          }
+        }
+      }
+    }
+
+  if (execZMin < 0)
+    {
+    if (source->Executions != executions)
+      {
+      cerr << "Slices " << zmin << " to " << zmax
+           << " were not taken from the cache" << endl;
+      return 0;
+      }
+    return 1;
+    }
+  if (source->Executions != executions + 1 ||
+      source->LastExtent[4] != execZMin || source->LastExtent[5] != execZMax)
+    {
+    cerr << "Slices " << zmin << " to " << zmax << ": the source produced "
+         << source->LastExtent[4] << " to " << source->LastExtent[5]
+         << " instead of " << execZMin << " to " << execZMax << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestImageCacheFilter(int, char *[])
+{
+  vtkSmartPointer<vtkTestCacheSource> source =
+    vtkSmartPointer<vtkTestCacheSource>::New();
+  vtkSmartPointer<vtkImageCacheFilter> cache =
+    vtkSmartPointer<vtkImageCacheFilter>::New();
+  cache->SetInputConnection(source->GetOutputPort());
+
+  int ok = 1;
+  ok = Scroll(cache, source, 0, 7, 0, 7) && ok;
+  // Inside the cached slices.
+  ok = Scroll(cache, source, 2, 5, -1, -1) && ok;
+  // One slice further, and one slice back.
+  ok = Scroll(cache, source, 1, 8, 8, 8) && ok;
+  ok = Scroll(cache, source, 3, 9, 9, 9) && ok;
+  ok = Scroll(cache, source, 0, 4, -1, -1) && ok;
+
+  // With a limit smaller than an image only the last one is kept.
+  cache->SetCacheMemoryLimit(1);
+  ok = Scroll(cache, source, 12, 15, 12, 15) && ok;
+  ok = Scroll(cache, source, 0, 3, 0, 3) && ok;
+  ok = Scroll(cache, source, 1, 2, -1, -1) && ok;
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageFourierFilter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test and benchmark of vtkImageFFT and vtkImageRFFT
+// .SECTION Description
+// Transforms real and complex volumes whose sizes have factors of 2, 3, 4
+// and larger primes, and compares the result with a discrete Fourier
+// transform computed term by term.  The inverse transform must give back
+// the input.  Then prints the time of a forward and inverse transform of
+// a larger volume, whose size along each axis can be given as the first
+// argument, e.g. 256 for a benchmark; the default keeps the test fast.
+
+#include "vtkImageData.h"
+#include "vtkImageFFT.h"
+#include "vtkImageRFFT.h"
+#include "vtkMath.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/vector>
+
+#include <math.h>
+#include <stdlib.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Transform the lines along one axis of an array of complex numbers.
+static void DiscreteFourierTransform(vtkstd::vector<double> &data,
+                                     const int dims[3], int axis)
+{
+  int inc[3] = { 1, dims[0], dims[0]*dims[1] };
+  int n = dims[axis];
+  int axis1 = (axis + 1) % 3;
+  int axis2 = (axis + 2) % 3;
+  vtkstd::vector<double> line(2*n);
+  for (int i2 = 0; i2 < dims[axis2]; ++i2)
+    {
+    for (int i1 = 0; i1 < dims[axis1]; ++i1)
+      {
+      int start = i1*inc[axis1] + i2*inc[axis2];
+      for (int k = 0; k < n; ++k)
+        {
+        double real = 0.0;
+        double imag = 0.0;
+        for (int j = 0; j < n; ++j)
+          {
+          double phase = -2.0*vtkMath::DoublePi()*((j*k) % n)/n;
+          double a = data[2*(start + j*inc[axis])];
+          double b = data[2*(start + j*inc[axis]) + 1];
+          real += a*cos(phase) - b*sin(phase);
+          imag += a*sin(phase) + b*cos(phase);
+          }
+        line[2*k] = real;
+        line[2*k + 1] = imag;
+        }
+      for (int k = 0; k < n; ++k)
+        {
+        data[2*(start + k*inc[axis])] = line[2*k];
+        data[2*(start + k*inc[axis]) + 1] = line[2*k + 1];
+        }
+      }
+    }
+}
+
+static int TestTransform(int nx, int ny, int nz, int numComponents)
+{
+  int dims[3] = { nx, ny, nz };
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(dims);
+  image->SetScalarTypeToDouble();
+  image->SetNumberOfScalarComponents(numComponents);
+  image->AllocateScalars();
+  double *scalars = static_cast<double *>(image->GetScalarPointer());
+  vtkIdType n = image->GetNumberOfPoints();
+  vtkstd::vector<double> expected(2*n, 0.0);
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    for (int c = 0; c < numComponents; ++c)
+      {
+      scalars[numComponents*i + c] = vtkMath::Random(-1, 1);
+      expected[2*i + c] = scalars[numComponents*i + c];
+      }
+    }
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    DiscreteFourierTransform(expected, dims, axis);
+    }
+
+  VTK_CREATE(vtkImageFFT, fft);
+  fft->SetInput(image);
+  fft->SetDimensionality(3);
+  VTK_CREATE(vtkImageRFFT, rfft);
+  rfft->SetInputConnection(fft->GetOutputPort());
+  rfft->SetDimensionality(3);
+  rfft->Update();
+
+  double *output = static_cast<double *>(fft->GetOutput()->GetScalarPointer());
+  double *inverse =
+    static_cast<double *>(rfft->GetOutput()->GetScalarPointer());
+  double error = 0.0;
+  double inverseError = 0.0;
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    for (int c = 0; c < 2; ++c)
+      {
+      double d = fabs(output[2*i + c] - expected[2*i + c]);
+      error = (d > error ? d : error);
+      d = fabs(inverse[2*i + c] -
+               (c < numComponents ? scalars[numComponents*i + c] : 0.0));
+      inverseError = (d > inverseError ? d : inverseError);
+      }
+    }
+  if (error > 1e-9*n || inverseError > 1e-12*n)
+    {
+    cerr << nx << "x" << ny << "x" << nz << " with " << numComponents
+         << " components: error " << error << ", inverse error "
+         << inverseError << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestImageFourierFilter(int argc, char *argv[])
+{
+  vtkMath::RandomSeed(4711);
+  int ok = 1;
+  for (int c = 1; c <= 2; ++c)
+    {
+    ok = TestTransform(12, 9, 5, c) && ok;
+    ok = TestTransform(64, 70, 3, c) && ok;
+    ok = TestTransform(1, 7, 16, c) && ok;
+    ok = TestTransform(30, 1, 1, c) && ok;
+    }
+
+  int size = (argc > 1 ? atoi(argv[1]) : 0);
+  if (size < 2)
+    {
+    size = 64;
+    }
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(size, size, size);
+  image->SetScalarTypeToFloat();
+  image->SetNumberOfScalarComponents(1);
+  image->AllocateScalars();
+  float *scalars = static_cast<float *>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    scalars[i] = static_cast<float>(vtkMath::Random(0, 255));
+    }
+
+  VTK_CREATE(vtkTimerLog, timer);
+  VTK_CREATE(vtkImageFFT, fft);
+  fft->SetInput(image);
+  fft->SetDimensionality(3);
+  timer->StartTimer();
+  fft->Update();
+  timer->StopTimer();
+  cout << size << "^3 fft: " << timer->GetElapsedTime() << " s" << endl;
+
+  VTK_CREATE(vtkImageRFFT, rfft);
+  rfft->SetInputConnection(fft->GetOutputPort());
+  rfft->SetDimensionality(3);
+  timer->StartTimer();
+  rfft->Update();
+  timer->StopTimer();
+  cout << size << "^3 rfft: " << timer->GetElapsedTime() << " s" << endl;
+
+  return ok ? 0 : 1;
+}
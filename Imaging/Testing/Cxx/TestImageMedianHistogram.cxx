@@ -0,0 +1,190 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageMedianHistogram.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test and benchmark of the histogram mode of vtkImageMedian3D
+// .SECTION Description
+// Filters unsigned char, short and int volumes, with one and two
+// components, and compares the histogram mode with medians computed pixel
+// by pixel.  The sort mode must agree wherever the neighborhood has an
+// odd number of pixels.  The int volume spans more values than the
+// histogram holds, so it checks the fallback to sorting.  Then prints the
+// times of both modes on a larger short volume, whose size along each
+// axis can be given as the first argument, e.g. 256 for a benchmark; the
+// default keeps the test fast.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageMedian3D.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+#include <stdlib.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static void Median(vtkImageData *image, int mode, int k0, int k1, int k2,
+                   vtkImageData *output, double *time = 0)
+{
+  VTK_CREATE(vtkImageMedian3D, median);
+  median->SetInput(image);
+  median->SetKernelSize(k0, k1, k2);
+  median->SetMedianMode(mode);
+  VTK_CREATE(vtkTimerLog, timer);
+  timer->StartTimer();
+  median->Update();
+  timer->StopTimer();
+  if (time)
+    {
+    *time = timer->GetElapsedTime();
+    }
+  output->DeepCopy(median->GetOutput());
+}
+
+template <class T>
+int CompareMedians(vtkImageData *image, vtkImageData *histogram,
+                   vtkImageData *sorted, int k[3], int fallback, T *)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  int numComps = image->GetNumberOfScalarComponents();
+  T *in = static_cast<T *>(image->GetScalarPointer());
+  T *out = static_cast<T *>(histogram->GetScalarPointer());
+  T *sort = static_cast<T *>(sorted->GetScalarPointer());
+  vtkstd::vector<T> values;
+  int idx[3], lo[3], hi[3], j[3];
+  for (idx[2] = 0; idx[2] < dims[2]; ++idx[2])
+    {
+    for (idx[1] = 0; idx[1] < dims[1]; ++idx[1])
+      {
+      for (idx[0] = 0; idx[0] < dims[0]; ++idx[0])
+        {
+        for (int a = 0; a < 3; ++a)
+          {
+          lo[a] = idx[a] - k[a]/2;
+          hi[a] = lo[a] + k[a] - 1;
+          lo[a] = (lo[a] < 0 ? 0 : lo[a]);
+          hi[a] = (hi[a] < dims[a] ? hi[a] : dims[a] - 1);
+          }
+        int center = (idx[2]*dims[1] + idx[1])*dims[0] + idx[0];
+        for (int c = 0; c < numComps; ++c)
+          {
+          values.clear();
+          for (j[2] = lo[2]; j[2] <= hi[2]; ++j[2])
+            {
+            for (j[1] = lo[1]; j[1] <= hi[1]; ++j[1])
+              {
+              for (j[0] = lo[0]; j[0] <= hi[0]; ++j[0])
+                {
+                values.push_back(
+                  in[((j[2]*dims[1] + j[1])*dims[0] + j[0])*numComps + c]);
+                }
+              }
+            }
+          size_t n = values.size();
+          vtkstd::nth_element(values.begin(), values.begin() + n/2,
+                              values.end());
+          T expected = values[n/2];
+          T value = out[center*numComps + c];
+          T sortValue = sort[center*numComps + c];
+          // the fallback sorts, which only defines odd medians
+          if ((n % 2 == 1 && (value != expected || sortValue != expected)) ||
+              (n % 2 == 0 && !fallback && value != expected))
+            {
+            cerr << image->GetScalarTypeAsString() << " " << k[0] << "x"
+                 << k[1] << "x" << k[2] << ": histogram " << value
+                 << ", sort " << sortValue << " instead of " << expected
+                 << " at (" << idx[0] << ", " << idx[1] << ", " << idx[2]
+                 << ") component " << c << endl;
+            return 0;
+            }
+          }
+        }
+      }
+    }
+  return 1;
+}
+
+static int TestMedian(int scalarType, int numComps, double range,
+                      int k0, int k1, int k2, int fallback = 0)
+{
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(21, 16, 11);
+  image->SetScalarType(scalarType);
+  image->SetNumberOfScalarComponents(numComps);
+  image->AllocateScalars();
+  vtkIdType n = image->GetNumberOfPoints()*numComps;
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    image->GetPointData()->GetScalars()->SetComponent(
+      i/numComps, i%numComps, floor(vtkMath::Random(-range, range)));
+    }
+
+  VTK_CREATE(vtkImageData, histogram);
+  VTK_CREATE(vtkImageData, sorted);
+  Median(image, VTK_IMAGE_MEDIAN_HISTOGRAM, k0, k1, k2, histogram);
+  Median(image, VTK_IMAGE_MEDIAN_SORT, k0, k1, k2, sorted);
+
+  int k[3] = { k0, k1, k2 };
+  switch (scalarType)
+    {
+    vtkTemplateMacro(
+      return CompareMedians(image, histogram, sorted, k, fallback,
+                            static_cast<VTK_TT *>(0)));
+    }
+  return 0;
+}
+
+int TestImageMedianHistogram(int argc, char *argv[])
+{
+  vtkMath::RandomSeed(1618);
+  int ok = 1;
+  ok = TestMedian(VTK_UNSIGNED_CHAR, 1, 127, 5, 5, 5) && ok;
+  ok = TestMedian(VTK_UNSIGNED_CHAR, 2, 127, 3, 4, 1) && ok;
+  ok = TestMedian(VTK_SHORT, 1, 3000, 7, 7, 1) && ok;
+  ok = TestMedian(VTK_SHORT, 1, 30000, 3, 1, 9) && ok;
+  ok = TestMedian(VTK_INT, 1, 100000, 3, 3, 3, 1) && ok;
+
+  int size = (argc > 1 ? atoi(argv[1]) : 0);
+  if (size < 8)
+    {
+    size = 48;
+    }
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(size, size, size);
+  image->SetScalarTypeToShort();
+  image->SetNumberOfScalarComponents(1);
+  image->AllocateScalars();
+  short *ptr = static_cast<short *>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    ptr[i] = static_cast<short>(vtkMath::Random(0, 4096));
+    }
+  VTK_CREATE(vtkImageData, output);
+  const char *names[2] = { "sort", "histogram" };
+  for (int mode = 0; mode < 2; ++mode)
+    {
+    double time;
+    Median(image, mode, 7, 7, 7, output, &time);
+    cout << size << "^3 short, 7x7x7 median, " << names[mode] << ": "
+         << time << " s" << endl;
+    }
+
+  return ok ? 0 : 1;
+}
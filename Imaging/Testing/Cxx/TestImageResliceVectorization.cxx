@@ -0,0 +1,192 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageResliceVectorization.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test and benchmark of the vectorized interpolation in vtkImageReslice
+// .SECTION Description
+// Reslices unsigned char, short and float volumes and a single slice with
+// an axis-aligned and an oblique matrix using nearest, linear and cubic
+// interpolation, with the vectorized row kernels on and off, and prints
+// the time of each.  The outputs must be identical.  The size of the
+// volume along each axis can be given as the first argument, e.g. 256 for
+// a benchmark; the default keeps the test fast.
+
+#include "vtkImageData.h"
+#include "vtkImageReslice.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkTransform.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// A reslice filter producing double output, so that the comparison sees
+// every bit of the interpolated values.
+class vtkTestDoubleReslice : public vtkImageReslice
+{
+public:
+  static vtkTestDoubleReslice *New();
+  vtkTypeMacro(vtkTestDoubleReslice, vtkImageReslice);
+
+protected:
+  vtkTestDoubleReslice()
+    {
+    this->OutputScalarType = VTK_DOUBLE;
+    }
+
+private:
+  vtkTestDoubleReslice(const vtkTestDoubleReslice&);  // Not implemented.
+  void operator=(const vtkTestDoubleReslice&);  // Not implemented.
+};
+
+vtkStandardNewMacro(vtkTestDoubleReslice);
+
+// Reslice with the row kernels off and on, print the times and compare.
+static int Compare(vtkImageData *image, vtkMatrix4x4 *axes,
+                   const char *matrixName, int interpolationMode)
+{
+  const char *modeNames[] = { "nearest", "linear", "", "cubic" };
+  double times[2];
+  VTK_CREATE(vtkImageData, output0);
+  VTK_CREATE(vtkImageData, output1);
+  vtkImageData *outputs[2] = { output0, output1 };
+  VTK_CREATE(vtkTimerLog, timer);
+
+  for (int vectorize = 0; vectorize < 2; ++vectorize)
+    {
+    vtkImageReslice::SetGlobalVectorization(vectorize);
+    VTK_CREATE(vtkTestDoubleReslice, reslice);
+    reslice->SetInput(image);
+    reslice->SetResliceAxes(axes);
+    reslice->SetInterpolationMode(interpolationMode);
+    reslice->SetOutputSpacing(0.7, 0.7, 0.7);
+    timer->StartTimer();
+    reslice->Update();
+    timer->StopTimer();
+    times[vectorize] = timer->GetElapsedTime();
+    outputs[vectorize]->DeepCopy(reslice->GetOutput());
+    }
+  vtkImageReslice::SetGlobalVectorization(1);
+
+  cout << "  " << matrixName << " " << modeNames[interpolationMode]
+       << ": scalar " << times[0] << " s, vectorized " << times[1] << " s"
+       << endl;
+
+  vtkIdType size = output0->GetNumberOfPoints();
+  if (size == 0 || output1->GetNumberOfPoints() != size ||
+      memcmp(output0->GetScalarPointer(), output1->GetScalarPointer(),
+             size*sizeof(double)) != 0)
+    {
+    cerr << image->GetScalarTypeAsString() << " " << matrixName << " "
+         << modeNames[interpolationMode]
+         << ": the vectorized output is not the same" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+static int TestImage(int scalarType, int nx, int ny, int nz)
+{
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(nx, ny, nz);
+  image->SetScalarType(scalarType);
+  image->SetNumberOfScalarComponents(1);
+  image->AllocateScalars();
+  vtkIdType n = image->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    double value = vtkMath::Random(0, 255);
+    switch (scalarType)
+      {
+      case VTK_UNSIGNED_CHAR:
+        static_cast<unsigned char *>(image->GetScalarPointer())[i] =
+          static_cast<unsigned char>(value);
+        break;
+      case VTK_SHORT:
+        static_cast<short *>(image->GetScalarPointer())[i] =
+          static_cast<short>(100*value - 12000);
+        break;
+      default:
+        static_cast<float *>(image->GetScalarPointer())[i] =
+          static_cast<float>(value);
+        break;
+      }
+    }
+  cout << image->GetScalarTypeAsString() << " " << nx << "x" << ny << "x"
+       << nz << ":" << endl;
+
+  // Swap x and z and shift by a fraction of a voxel.
+  VTK_CREATE(vtkMatrix4x4, permute);
+  permute->Zero();
+  permute->SetElement(0, 2, 1);
+  permute->SetElement(1, 1, 1);
+  permute->SetElement(2, 0, 1);
+  permute->SetElement(3, 3, 1);
+  permute->SetElement(0, 3, 0.3);
+  permute->SetElement(1, 3, 0.3);
+  if (nz == 1)
+    {
+    permute->SetElement(0, 2, 0);
+    permute->SetElement(2, 0, 0);
+    permute->SetElement(0, 0, 1);
+    permute->SetElement(2, 2, 1);
+    }
+
+  // Rotate about the center, within the slice for a single slice.
+  VTK_CREATE(vtkTransform, transform);
+  transform->Translate(0.5*nx, 0.5*ny, 0.5*(nz - 1));
+  if (nz == 1)
+    {
+    transform->RotateZ(30);
+    }
+  else
+    {
+    transform->RotateWXYZ(30, 1, 2, 3);
+    }
+  transform->Translate(-0.5*nx, -0.5*ny, -0.5*(nz - 1));
+
+  int ok = 1;
+  int modes[3] = { VTK_RESLICE_NEAREST, VTK_RESLICE_LINEAR,
+                   VTK_RESLICE_CUBIC };
+  for (int i = 0; i < 3; ++i)
+    {
+    ok = Compare(image, permute, "axis-aligned", modes[i]) && ok;
+    ok = Compare(image, transform->GetMatrix(), "oblique", modes[i]) && ok;
+    }
+  return ok;
+}
+
+int TestImageResliceVectorization(int argc, char *argv[])
+{
+  int size = (argc > 1 ? atoi(argv[1]) : 0);
+  if (size < 8)
+    {
+    size = 40;
+    }
+  vtkMath::RandomSeed(3141);
+
+  int ok = 1;
+  int types[3] = { VTK_UNSIGNED_CHAR, VTK_SHORT, VTK_FLOAT };
+  for (int i = 0; i < 3; ++i)
+    {
+    ok = TestImage(types[i], size, size, size) && ok;
+    ok = TestImage(types[i], 4*size, 4*size, 1) && ok;
+    }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageSmoothingModes.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test and benchmark of the recursive and box smoothing modes
+// .SECTION Description
+// Compares the recursive and box modes of vtkImageGaussianSmooth with a
+// wide gaussian kernel, and checks that the result does not depend on
+// how the image is split between threads.  Compares a box kernel in
+// vtkImageSeparableConvolution, and the box kernels of
+// vtkImageContinuousDilate3D and vtkImageContinuousErode3D, with sums and
+// extrema computed pixel by pixel.  Then prints the times of each mode on
+// a larger volume, whose size along each axis can be given as the first
+// argument, e.g. 256 for a benchmark; the default keeps the test fast.
+
+#include "vtkFloatArray.h"
+#include "vtkImageContinuousDilate3D.h"
+#include "vtkImageContinuousErode3D.h"
+#include "vtkImageData.h"
+#include "vtkImageGaussianSmooth.h"
+#include "vtkImageSeparableConvolution.h"
+#include "vtkMath.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// A smooth image with a step, scaled to about 0 to 200.
+static void FillImage(vtkImageData *image, int nx, int ny, int nz)
+{
+  image->SetDimensions(nx, ny, nz);
+  image->SetScalarTypeToFloat();
+  image->SetNumberOfScalarComponents(1);
+  image->AllocateScalars();
+  float *ptr = static_cast<float *>(image->GetScalarPointer());
+  for (int z = 0; z < nz; ++z)
+    {
+    for (int y = 0; y < ny; ++y)
+      {
+      for (int x = 0; x < nx; ++x)
+        {
+        *ptr++ = static_cast<float>(
+          50.0 + 50.0*sin(x/5.0)*cos(y/7.0) + (z > nz/2 ? 100.0 : 0.0));
+        }
+      }
+    }
+}
+
+static double MaxDifference(vtkImageData *a, vtkImageData *b)
+{
+  float *pa = static_cast<float *>(a->GetScalarPointer());
+  float *pb = static_cast<float *>(b->GetScalarPointer());
+  double diff = 0.0;
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+    double d = fabs(pa[i] - pb[i]);
+    diff = (d > diff ? d : diff);
+    }
+  return diff;
+}
+
+static void Smooth(vtkImageData *image, int mode, double std, int threads,
+                   vtkImageData *output, double *time = 0)
+{
+  VTK_CREATE(vtkImageGaussianSmooth, smooth);
+  smooth->SetInput(image);
+  smooth->SetSmoothingMode(mode);
+  smooth->SetStandardDeviation(std);
+  if (mode == VTK_IMAGE_GAUSSIAN_SMOOTH_KERNEL)
+    {
+    smooth->SetRadiusFactor(4.0);
+    }
+  if (threads)
+    {
+    smooth->SetNumberOfThreads(threads);
+    }
+  VTK_CREATE(vtkTimerLog, timer);
+  timer->StartTimer();
+  smooth->Update();
+  timer->StopTimer();
+  if (time)
+    {
+    *time = timer->GetElapsedTime();
+    }
+  output->DeepCopy(smooth->GetOutput());
+}
+
+static int TestGaussianSmooth()
+{
+  int ok = 1;
+  VTK_CREATE(vtkImageData, image);
+  FillImage(image, 40, 30, 24);
+  VTK_CREATE(vtkImageData, reference);
+  VTK_CREATE(vtkImageData, output);
+  VTK_CREATE(vtkImageData, split);
+
+  // the tolerances are in percent of the range of the image, the largest
+  // errors are near the edges where the renormalization magnifies the
+  // heavier tails of the recursive filter
+  double stds[2] = { 1.5, 4.0 };
+  int modes[2] = { VTK_IMAGE_GAUSSIAN_SMOOTH_RECURSIVE,
+                   VTK_IMAGE_GAUSSIAN_SMOOTH_BOX };
+  double tolerances[2] = { 10.0, 4.0 };
+  for (int i = 0; i < 2; ++i)
+    {
+    Smooth(image, VTK_IMAGE_GAUSSIAN_SMOOTH_KERNEL, stds[i], 1, reference);
+    for (int j = 0; j < 2; ++j)
+      {
+      Smooth(image, modes[j], stds[i], 1, output);
+      Smooth(image, modes[j], stds[i], 4, split);
+      double error = MaxDifference(output, reference);
+      double seams = MaxDifference(output, split);
+      if (error > 2.0*tolerances[j] || seams > 1e-2)
+        {
+        cerr << "Standard deviation " << stds[i] << ", mode " << modes[j]
+             << ": the difference from the kernel is " << error
+             << ", between thread splits " << seams << endl;
+        ok = 0;
+        }
+      }
+    }
+  return ok;
+}
+
+static int TestSeparableConvolution()
+{
+  int n = 50;
+  VTK_CREATE(vtkImageData, image);
+  FillImage(image, n, 3, 2);
+  VTK_CREATE(vtkFloatArray, kernel);
+  int size = 9;
+  for (int i = 0; i < size; ++i)
+    {
+    kernel->InsertNextValue(1.0f/size);
+    }
+  VTK_CREATE(vtkImageSeparableConvolution, convolution);
+  convolution->SetInput(image);
+  convolution->SetXKernel(kernel);
+  convolution->Update();
+
+  float *in = static_cast<float *>(image->GetScalarPointer());
+  float *out =
+    static_cast<float *>(convolution->GetOutput()->GetScalarPointer());
+  double error = 0.0;
+  for (int line = 0; line < 6; ++line)
+    {
+    for (int x = 0; x < n; ++x)
+      {
+      double sum = 0.0;
+      for (int k = x - size/2; k <= x + size/2; ++k)
+        {
+        sum += in[line*n + (k < 0 ? 0 : (k < n ? k : n - 1))];
+        }
+      double d = fabs(sum/size - out[line*n + x]);
+      error = (d > error ? d : error);
+      }
+    }
+  if (error > 1e-3)
+    {
+    cerr << "Separable box convolution: error " << error << endl;
+    return 0;
+    }
+  return 1;
+}
+
+static int TestMorphology(int dilate, int k0, int k1, int k2)
+{
+  int dims[3] = { 20, 17, 13 };
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(dims);
+  image->SetScalarTypeToShort();
+  image->SetNumberOfScalarComponents(1);
+  image->AllocateScalars();
+  short *in = static_cast<short *>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    in[i] = static_cast<short>(vtkMath::Random(-1000, 1000));
+    }
+
+  vtkImageData *output;
+  VTK_CREATE(vtkImageContinuousDilate3D, dilation);
+  VTK_CREATE(vtkImageContinuousErode3D, erosion);
+  if (dilate)
+    {
+    dilation->SetInput(image);
+    dilation->SetKernelSize(k0, k1, k2);
+    dilation->BoxKernelOn();
+    dilation->Update();
+    output = dilation->GetOutput();
+    }
+  else
+    {
+    erosion->SetInput(image);
+    erosion->SetKernelSize(k0, k1, k2);
+    erosion->BoxKernelOn();
+    erosion->Update();
+    output = erosion->GetOutput();
+    }
+  short *out = static_cast<short *>(output->GetScalarPointer());
+
+  int k[3] = { k0, k1, k2 };
+  int lo[3], hi[3], idx[3], j[3];
+  for (idx[2] = 0; idx[2] < dims[2]; ++idx[2])
+    {
+    for (idx[1] = 0; idx[1] < dims[1]; ++idx[1])
+      {
+      for (idx[0] = 0; idx[0] < dims[0]; ++idx[0])
+        {
+        for (int a = 0; a < 3; ++a)
+          {
+          lo[a] = idx[a] - k[a]/2;
+          hi[a] = lo[a] + k[a] - 1;
+          lo[a] = (lo[a] < 0 ? 0 : lo[a]);
+          hi[a] = (hi[a] < dims[a] ? hi[a] : dims[a] - 1);
+          }
+        int center = (idx[2]*dims[1] + idx[1])*dims[0] + idx[0];
+        short expected = in[center];
+        for (j[2] = lo[2]; j[2] <= hi[2]; ++j[2])
+          {
+          for (j[1] = lo[1]; j[1] <= hi[1]; ++j[1])
+            {
+            for (j[0] = lo[0]; j[0] <= hi[0]; ++j[0])
+              {
+              short v = in[(j[2]*dims[1] + j[1])*dims[0] + j[0]];
+              if (dilate ? v > expected : v < expected)
+                {
+                expected = v;
+                }
+              }
+            }
+          }
+        if (out[center] != expected)
+          {
+          cerr << (dilate ? "Dilation" : "Erosion") << " with a " << k0
+               << "x" << k1 << "x" << k2 << " box: " << out[center]
+               << " instead of " << expected << " at (" << idx[0] << ", "
+               << idx[1] << ", " << idx[2] << ")" << endl;
+          return 0;
+          }
+        }
+      }
+    }
+  return 1;
+}
+
+int TestImageSmoothingModes(int argc, char *argv[])
+{
+  vtkMath::RandomSeed(2718);
+  int ok = TestGaussianSmooth();
+  ok = TestSeparableConvolution() && ok;
+  for (int dilate = 0; dilate < 2; ++dilate)
+    {
+    ok = TestMorphology(dilate, 5, 3, 7) && ok;
+    ok = TestMorphology(dilate, 4, 1, 2) && ok;
+    ok = TestMorphology(dilate, 25, 9, 1) && ok;
+    }
+
+  int size = (argc > 1 ? atoi(argv[1]) : 0);
+  if (size < 8)
+    {
+    size = 48;
+    }
+  VTK_CREATE(vtkImageData, image);
+  FillImage(image, size, size, size);
+  VTK_CREATE(vtkImageData, output);
+  const char *names[3] = { "kernel", "recursive", "box" };
+  for (int mode = 0; mode < 3; ++mode)
+    {
+    double time;
+    Smooth(image, mode, 8.0, 0, output, &time);
+    cout << size << "^3 gaussian, deviation 8, " << names[mode] << ": "
+         << time << " s" << endl;
+    }
+
+  VTK_CREATE(vtkTimerLog, timer);
+  for (int box = 0; box < 2; ++box)
+    {
+    VTK_CREATE(vtkImageContinuousDilate3D, dilation);
+    dilation->SetInput(image);
+    dilation->SetKernelSize(9, 9, 9);
+    dilation->SetBoxKernel(box);
+    timer->StartTimer();
+    dilation->Update();
+    timer->StopTimer();
+    cout << size << "^3 dilation, 9x9x9 " << (box ? "box" : "ellipsoid")
+         << ": " << timer->GetElapsedTime() << " s" << endl;
+    }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThreadedImageAlgorithmLatency.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Benchmark the per-update latency of a small threaded image filter when
+// threads are spawned on every execution, when they come from the thread
+// pool, and when the extent is split into many stealable pieces.  The
+// outputs of all modes must be identical.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageGaussianSmooth.h"
+#include "vtkPointData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+static double TimeUpdates(vtkImageGaussianSmooth *smooth, int updates)
+{
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+  timer->StartTimer();
+  for (int i = 0; i < updates; ++i)
+    {
+    smooth->Modified();
+    smooth->Update();
+    }
+  timer->StopTimer();
+  return timer->GetElapsedTime() / updates;
+}
+
+static int CompareOutputs(vtkImageData *a, vtkImageData *b)
+{
+  vtkDataArray *sa = a->GetPointData()->GetScalars();
+  vtkDataArray *sb = b->GetPointData()->GetScalars();
+  if (sa->GetNumberOfTuples() != sb->GetNumberOfTuples())
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < sa->GetNumberOfTuples(); ++i)
+    {
+    if (sa->GetTuple1(i) != sb->GetTuple1(i))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+int TestThreadedImageAlgorithmLatency(int, char *[])
+{
+  const int updates = 200;
+
+  vtkSmartPointer<vtkRTAnalyticSource> source =
+    vtkSmartPointer<vtkRTAnalyticSource>::New();
+  source->SetWholeExtent(0, 63, 0, 63, 0, 15);
+  source->Update();
+
+  vtkSmartPointer<vtkImageGaussianSmooth> smooth =
+    vtkSmartPointer<vtkImageGaussianSmooth>::New();
+  smooth->SetInputConnection(source->GetOutputPort());
+  smooth->SetDimensionality(3);
+
+  // Spawn and join threads on every update.
+  smooth->UseThreadPoolOff();
+  double spawn = TimeUpdates(smooth, updates);
+  vtkSmartPointer<vtkImageData> reference =
+    vtkSmartPointer<vtkImageData>::New();
+  reference->DeepCopy(smooth->GetOutput());
+
+  // Persistent threads, one slab per thread.
+  smooth->UseThreadPoolOn();
+  double pooled = TimeUpdates(smooth, updates);
+  int ok = CompareOutputs(reference, smooth->GetOutput());
+
+  // Persistent threads, many small pieces that idle threads steal.
+  smooth->SetPiecesPerThread(8);
+  double stealing = TimeUpdates(smooth, updates);
+  ok = ok && CompareOutputs(reference, smooth->GetOutput());
+
+  cout << "Threads: " << smooth->GetNumberOfThreads() << endl;
+  cout << "Spawn per update:     " << spawn * 1000.0 << " ms" << endl;
+  cout << "Thread pool:          " << pooled * 1000.0 << " ms" << endl;
+  cout << "Thread pool, 8 pieces per thread: "
+       << stealing * 1000.0 << " ms" << endl;
+
+  if (!ok)
+    {
+    cerr << "Thread pool output differs from the spawned threads output"
+         << endl;
+    return 1;
+    }
+  return 0;
+}
@@ -48,6 +48,7 @@ void vtkImageCacheFilter::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "CacheSize: " << this->GetCacheSize() << endl;
+  os << indent << "CacheMemoryLimit: " << this->GetCacheMemoryLimit() << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -73,6 +74,29 @@ int vtkImageCacheFilter::GetCacheSize()
   return 0;
 }
 
+//----------------------------------------------------------------------------
+void vtkImageCacheFilter::SetCacheMemoryLimit(unsigned long limit)
+{
+  vtkCachedStreamingDemandDrivenPipeline *csddp = 
+    vtkCachedStreamingDemandDrivenPipeline::SafeDownCast(this->GetExecutive());
+  if (csddp)
+    {
+    csddp->SetCacheMemoryLimit(limit);
+    }
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkImageCacheFilter::GetCacheMemoryLimit()
+{
+  vtkCachedStreamingDemandDrivenPipeline *csddp = 
+    vtkCachedStreamingDemandDrivenPipeline::SafeDownCast(this->GetExecutive());
+  if (csddp)
+    {
+    return csddp->GetCacheMemoryLimit();
+    }
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 // This method simply copies by reference the input data to the output.
 void vtkImageCacheFilter::ExecuteData(vtkDataObject *)
@@ -18,7 +18,10 @@
 // vtkImageCacheFilter keep a number of vtkImageDataObjects from previous
 // updates to satisfy future updates without needing to update the input.  It
 // does not change the data at all.  It just makes the pipeline more
-// efficient at the expense of using extra memory.
+// efficient at the expense of using extra memory.  A request inside a
+// cached image is answered with that image without copying it, and when a
+// cached image covers all of a request but one slab, e.g. after scrolling
+// by a slice, only that slab is requested from the input.
 
 #ifndef __vtkImageCacheFilter_h
 #define __vtkImageCacheFilter_h
@@ -39,6 +42,13 @@ public:
   // it defaults to 10.
   void SetCacheSize(int size);
   int GetCacheSize();
+
+  // Description:
+  // The maximum memory in kilobytes used by the cached images.  The least
+  // recently used images are dropped first.  It defaults to 0, which
+  // limits the cache by CacheSize only.
+  void SetCacheMemoryLimit(unsigned long limit);
+  unsigned long GetCacheMemoryLimit();
   
 protected:
   vtkImageCacheFilter();
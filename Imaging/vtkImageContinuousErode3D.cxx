@@ -35,6 +35,8 @@ vtkImageContinuousErode3D::vtkImageContinuousErode3D()
   this->KernelSize[1] = 1;
   this->KernelSize[2] = 1;
 
+  this->BoxKernel = 0;
+
   this->Ellipse = vtkImageEllipsoidSource::New();
   // Setup the Ellipse to default size
   this->SetKernelSize(1, 1, 1);
@@ -54,6 +56,8 @@ vtkImageContinuousErode3D::~vtkImageContinuousErode3D()
 void vtkImageContinuousErode3D::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "BoxKernel: " << (this->BoxKernel ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
@@ -269,6 +273,176 @@ void vtkImageContinuousErode3DExecute(vtkImageContinuousErode3D *self,
     }
 }
 
+//----------------------------------------------------------------------------
+// This templated function takes the minimum of a line over windows of
+// 'size' pixels starting 'lo' pixels from each output pixel, with the
+// van Herk/Gil-Werman algorithm.  The line is valid from inMin to inMax,
+// and the windows are clipped to that range.  'g' and 'h' hold the
+// running minimums from the start and from the end of each block of
+// 'size' pixels, so any window is covered by the end of one block and
+// the start of the next.
+template <class T>
+void vtkImageContinuousErode3DBoxLine(T *inPtr, vtkIdType inInc,
+                                      int inMin, int inMax,
+                                      T *outPtr, vtkIdType outInc,
+                                      int outMin, int outMax,
+                                      int lo, int size, T *g, T *h)
+{
+  int start = (outMin + lo > inMin ? outMin + lo : inMin);
+  int end = (outMax + lo + size - 1 < inMax ? outMax + lo + size - 1 : inMax);
+  int n = end - start + 1;
+  int idx, block;
+  T value;
+
+  inPtr += (start - inMin)*inInc;
+  for (idx = 0, block = 0; idx < n; ++idx, ++block)
+    {
+    value = inPtr[idx*inInc];
+    if (block == size)
+      {
+      block = 0;
+      }
+    g[idx] = ((block == 0 || value < g[idx-1]) ? value : g[idx-1]);
+    }
+  for (idx = n - 1; idx >= 0; --idx)
+    {
+    value = inPtr[idx*inInc];
+    h[idx] = ((idx == n - 1 || (idx + 1) % size == 0 || value < h[idx+1]) ?
+              value : h[idx+1]);
+    }
+
+  for (idx = outMin; idx <= outMax; ++idx)
+    {
+    int a = idx + lo - start;
+    int b = a + size - 1;
+    a = (a > 0 ? a : 0);
+    b = (b < n - 1 ? b : n - 1);
+    // only a window clipped at an end can be shorter than a block
+    if (a/size != b/size)
+      {
+      *outPtr = (h[a] < g[b] ? h[a] : g[b]);
+      }
+    else if (a % size == 0)
+      {
+      *outPtr = g[b];
+      }
+    else
+      {
+      *outPtr = h[a];
+      }
+    outPtr += outInc;
+    }
+}
+
+//----------------------------------------------------------------------------
+// This templated function executes the filter for a box neighborhood,
+// one axis after the other.  The passes along x and y keep the rows of
+// the neighborhood that the next passes need in temporary arrays.
+template <class T>
+void vtkImageContinuousErode3DBoxExecute(vtkImageContinuousErode3D *self,
+                                         vtkImageData *inData, T *inPtr,
+                                         vtkImageData *outData,
+                                         int *outExt, T *outPtr, int id,
+                                         vtkInformation *inInfo)
+{
+  int *kernelMiddle = self->GetKernelMiddle();
+  int *kernelSize = self->GetKernelSize();
+  int *inExt = inData->GetExtent();
+  vtkIdType inInc0, inInc1, inInc2;
+  vtkIdType outInc0, outInc1, outInc2;
+  int inImageExt[6], range[6], lo[3];
+  int axis, idxC, idx0, idx1;
+  unsigned long count = 0;
+  unsigned long target;
+
+  inData->GetIncrements(inInc0, inInc1, inInc2);
+  outData->GetIncrements(outInc0, outInc1, outInc2);
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inImageExt);
+  int numComps = outData->GetNumberOfScalarComponents();
+
+  // the part of the image within the neighborhood of the output
+  int maxLength = 0;
+  for (axis = 0; axis < 3; ++axis)
+    {
+    lo[axis] = -kernelMiddle[axis];
+    range[2*axis] = outExt[2*axis] + lo[axis];
+    range[2*axis] = (range[2*axis] > inImageExt[2*axis] ?
+                     range[2*axis] : inImageExt[2*axis]);
+    range[2*axis+1] = outExt[2*axis+1] + lo[axis] + kernelSize[axis] - 1;
+    range[2*axis+1] = (range[2*axis+1] < inImageExt[2*axis+1] ?
+                       range[2*axis+1] : inImageExt[2*axis+1]);
+    int length = range[2*axis+1] - range[2*axis] + 1;
+    maxLength = (length > maxLength ? length : maxLength);
+    }
+  int n0 = outExt[1] - outExt[0] + 1;
+  int n1 = outExt[3] - outExt[2] + 1;
+  int m1 = range[3] - range[2] + 1;
+  int m2 = range[5] - range[4] + 1;
+
+  T *g = new T[2*maxLength];
+  T *h = g + maxLength;
+  // after x: x in the output, y and z in the range
+  T *temp0 = new T[n0*m1*m2];
+  // after y: x and y in the output, z in the range
+  T *temp1 = new T[n0*n1*m2];
+
+  target = static_cast<unsigned long>(
+    numComps*(m1*m2 + n0*m2 + n0*n1)/50.0);
+  target++;
+
+  inPtr += (range[0] - inExt[0])*inInc0 + (range[2] - inExt[2])*inInc1 +
+    (range[4] - inExt[4])*inInc2;
+  for (idxC = 0; idxC < numComps; ++idxC)
+    {
+    for (idx1 = 0; !self->AbortExecute && idx1 < m2; ++idx1)
+      {
+      for (idx0 = 0; idx0 < m1; ++idx0)
+        {
+        if (!id && !(count++%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        vtkImageContinuousErode3DBoxLine(
+          inPtr + idx0*inInc1 + idx1*inInc2 + idxC, inInc0,
+          range[0], range[1], temp0 + (idx1*m1 + idx0)*n0, 1,
+          outExt[0], outExt[1], lo[0], kernelSize[0], g, h);
+        }
+      }
+    for (idx1 = 0; !self->AbortExecute && idx1 < m2; ++idx1)
+      {
+      for (idx0 = 0; idx0 < n0; ++idx0)
+        {
+        if (!id && !(count++%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        vtkImageContinuousErode3DBoxLine(
+          temp0 + idx1*m1*n0 + idx0, n0, range[2], range[3],
+          temp1 + idx1*n1*n0 + idx0, n0,
+          outExt[2], outExt[3], lo[1], kernelSize[1], g, h);
+        }
+      }
+    for (idx1 = 0; !self->AbortExecute && idx1 < n1; ++idx1)
+      {
+      for (idx0 = 0; idx0 < n0; ++idx0)
+        {
+        if (!id && !(count++%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        vtkImageContinuousErode3DBoxLine(
+          temp1 + idx1*n0 + idx0, n0*n1, range[4], range[5],
+          outPtr + idx0*outInc0 + idx1*outInc1 + idxC, outInc2,
+          outExt[4], outExt[5], lo[2], kernelSize[2], g, h);
+        }
+      }
+    }
+
+  delete [] temp1;
+  delete [] temp0;
+  delete [] g;
+}
+
 //----------------------------------------------------------------------------
 // This method contains the first switch statement that calls the correct
 // templated function for the input and output Data types.
@@ -319,6 +493,22 @@ void vtkImageContinuousErode3D::ThreadedRequestData(
     return;
     }
   
+  if (this->BoxKernel)
+    {
+    switch (inArray->GetDataType())
+      {
+      vtkTemplateMacro(
+        vtkImageContinuousErode3DBoxExecute(this, inData[0][0],
+                                          static_cast<VTK_TT *>(inPtr),
+                                          outData[0], outExt,
+                                          static_cast<VTK_TT *>(outPtr), id,
+                                          inInfo) );
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+      }
+    return;
+    }
+
   switch (inArray->GetDataType())
     {
     vtkTemplateMacro(
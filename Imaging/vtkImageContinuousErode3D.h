@@ -42,11 +42,22 @@ public:
   // default middle of the neighborhood and computes the elliptical foot print.
   void SetKernelSize(int size0, int size1, int size2);
 
+  // Description:
+  // If BoxKernel is on, the neighborhood is the whole box of KernelSize
+  // instead of the ellipsoid inside it.  The minimum over the box is then
+  // taken one axis at a time with the van Herk/Gil-Werman algorithm,
+  // whose cost per pixel does not depend on the kernel size.
+  // The default is off.
+  vtkSetMacro(BoxKernel, int);
+  vtkGetMacro(BoxKernel, int);
+  vtkBooleanMacro(BoxKernel, int);
+
 protected:
   vtkImageContinuousErode3D();
   ~vtkImageContinuousErode3D();
 
   vtkImageEllipsoidSource *Ellipse;
+  int BoxKernel;
     
   void ThreadedRequestData(vtkInformation *request,
                            vtkInformationVector **inputVector,
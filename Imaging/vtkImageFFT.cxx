@@ -58,7 +58,9 @@ int vtkImageFFT::IterativeRequestUpdateExtent(
 
 //----------------------------------------------------------------------------
 // This templated execute method handles any type input, but the output
-// is always doubles.
+// is always doubles.  Several lines are transformed at once, interleaved
+// so that the transform runs over contiguous memory, and two lines of
+// real input are transformed as the real and imaginary parts of one.
 template <class T>
 void vtkImageFFTExecute(vtkImageFFT *self,
                         vtkImageData *inData, int inExt[6], T *inPtr,
@@ -78,7 +80,9 @@ void vtkImageFFTExecute(vtkImageFFT *self,
   double *outPtr0, *outPtr1, *outPtr2;
   //
   int idx0, idx1, idx2, inSize0, numberOfComponents;
+  int batchSize, numLines, numArrays, line;
   unsigned long count = 0;
+  unsigned long nextCount = 0;
   unsigned long target;
   double startProgress;
 
@@ -101,9 +105,10 @@ void vtkImageFFTExecute(vtkImageFFT *self,
     return;
     }
 
-  // Allocate the arrays of complex numbers
-  inComplex = new vtkImageComplex[inSize0];
-  outComplex = new vtkImageComplex[inSize0];
+  // Allocate the arrays of complex numbers for a batch of lines
+  batchSize = vtkImageFourierFilter::GetBatchSize(inSize0);
+  inComplex = new vtkImageComplex[inSize0*batchSize];
+  outComplex = new vtkImageComplex[inSize0*batchSize];
 
   target = static_cast<unsigned long>((outMax2-outMin2+1)*(outMax1-outMin1+1)
                                       * self->GetNumberOfIterations() / 50.0);
@@ -116,46 +121,113 @@ void vtkImageFFTExecute(vtkImageFFT *self,
     {
     inPtr1 = inPtr2;
     outPtr1 = outPtr2;
-    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; ++idx1)
+    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1;
+         idx1 += numLines)
       {
-      if (!id) 
+      numLines = outMax1 - idx1 + 1;
+      numLines = (numLines < batchSize ? numLines : batchSize);
+      if (!id)
         {
-        if (!(count%target))
+        if (count >= nextCount)
           {
           self->UpdateProgress(count/(50.0*target) + startProgress);
+          nextCount = count - count%target + target;
           }
-        count++;
+        count += numLines;
         }
-      // copy into complex numbers
-      inPtr0 = inPtr1;
-      pComplex = inComplex;
-      for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+
+      // copy into complex numbers, line b is array b/2 if the input is
+      // real, otherwise array b
+      numArrays = (numberOfComponents > 1 ? numLines : (numLines + 1)/2);
+      if (numberOfComponents == 1 && numLines % 2)
         {
-        pComplex->Real = static_cast<double>(*inPtr0);
-        pComplex->Imag = 0.0;
+        pComplex = inComplex + (numLines - 1)/2;
+        for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+          {
+          pComplex->Imag = 0.0;
+          pComplex += numArrays;
+          }
+        }
+      for (line = 0; line < numLines; ++line)
+        {
+        inPtr0 = inPtr1 + line*inInc1;
         if (numberOfComponents > 1)
           { // yes we have an imaginary input
-          pComplex->Imag = static_cast<double>(inPtr0[1]);;
+          pComplex = inComplex + line;
+          for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+            {
+            pComplex->Real = static_cast<double>(*inPtr0);
+            pComplex->Imag = static_cast<double>(inPtr0[1]);
+            inPtr0 += inInc0;
+            pComplex += numArrays;
+            }
+          }
+        else if (line%2 == 0)
+          {
+          pComplex = inComplex + line/2;
+          for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+            {
+            pComplex->Real = static_cast<double>(*inPtr0);
+            inPtr0 += inInc0;
+            pComplex += numArrays;
+            }
+          }
+        else
+          {
+          pComplex = inComplex + line/2;
+          for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+            {
+            pComplex->Imag = static_cast<double>(*inPtr0);
+            inPtr0 += inInc0;
+            pComplex += numArrays;
+            }
           }
-        inPtr0 += inInc0;
-        ++pComplex;
         }
       
       // Call the method that performs the fft
-      self->ExecuteFft(inComplex, outComplex, inSize0);
+      self->ExecuteFft(inComplex, outComplex, inSize0, numArrays);
 
       // copy into output
-      outPtr0 = outPtr1;
-      pComplex = outComplex + (outMin0 - inMin0);
-      for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+      for (line = 0; line < numLines; ++line)
         {
-        *outPtr0 = static_cast<double>(pComplex->Real);
-        outPtr0[1] = static_cast<double>(pComplex->Imag);
-        outPtr0 += outInc0;
-        ++pComplex;
+        outPtr0 = outPtr1 + line*outInc1;
+        if (numberOfComponents > 1)
+          {
+          pComplex = outComplex + (outMin0 - inMin0)*numArrays + line;
+          for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+            {
+            *outPtr0 = pComplex->Real;
+            outPtr0[1] = pComplex->Imag;
+            outPtr0 += outInc0;
+            pComplex += numArrays;
+            }
+          }
+        else
+          {
+          // separate the transforms of the two real lines with
+          // X[k] = (Z[k] + conj(Z[N-k]))/2 and Y[k] = (Z[k] - conj(Z[N-k]))/2i
+          for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+            {
+            int k = idx0 - inMin0;
+            vtkImageComplex z = outComplex[k*numArrays + line/2];
+            vtkImageComplex zc = outComplex[((inSize0 - k)%inSize0)*numArrays +
+                                            line/2];
+            if (line%2 == 0)
+              {
+              *outPtr0 = 0.5*(z.Real + zc.Real);
+              outPtr0[1] = 0.5*(z.Imag - zc.Imag);
+              }
+            else
+              {
+              *outPtr0 = 0.5*(z.Imag + zc.Imag);
+              outPtr0[1] = 0.5*(zc.Real - z.Real);
+              }
+            outPtr0 += outInc0;
+            }
+          }
         }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
+      inPtr1 += numLines*inInc1;
+      outPtr1 += numLines*outInc1;
       }
     inPtr2 += inInc2;
     outPtr2 += outInc2;
@@ -171,7 +243,7 @@ void vtkImageFFTExecute(vtkImageFFT *self,
 //----------------------------------------------------------------------------
 // This method is passed input and output Datas, and executes the fft
 // algorithm to fill the output from the input.
-// Not threaded yet.
+// The lines are split between the threads by SplitExtent.
 void vtkImageFFT::ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
                                   int outExt[6], int threadId)
 {
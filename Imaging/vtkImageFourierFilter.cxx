@@ -14,208 +14,321 @@
 =========================================================================*/
 #include "vtkImageFourierFilter.h"
 
-#include <math.h>
+#include "vtkCriticalSection.h"
+#include "vtkMath.h"
+
+#include <vtkstd/map>
+#include <vtkstd/vector>
 
+#include <math.h>
 
+// The work space of a batch: the arrays and the second buffer.
+#define VTK_IMAGE_FOURIER_CACHE_SIZE 262144
+#define VTK_IMAGE_FOURIER_MAX_BATCH 64
 
 /*=========================================================================
-        Vectors of complex numbers.
+        Plans of the transforms.
 =========================================================================*/
 
 //----------------------------------------------------------------------------
-// This function calculates one step of a FFT.
-// It is specialized for a factor of 2. 
-// It is engineered for no decimation.
-// (forward: fb = 1, backward: fb = -1)
-void vtkImageFourierFilter::ExecuteFftStep2(vtkImageComplex *p_in, 
-                                            vtkImageComplex *p_out, 
-                                            int N, int bsize, int fb)
+// The factors of an array size and the twiddle factors of every step.
+// Each step splits arrays of length n into p arrays of length n/p (the
+// self-sorting Stockham algorithm), so no bit reversal is needed.
+class vtkImageFourierPlan
 {
-  int i1, i2;
-  vtkImageComplex *p1, *p2, *p3;
-  vtkImageComplex q, fact1, fact, temp;
-  
-  /* Copy the links with no factors. */
-  p1 = p_in;
-  p3 = p_out;
-  for(i1 = 0; i1 < N / (bsize * 2); ++i1)   // loop 0->1
+public:
+  // the radix of each step
+  vtkstd::vector<int> Factors;
+  // exp(-2 pi i q t / n) for q < n/p and 0 < t < p, for each step
+  vtkstd::vector<vtkstd::vector<vtkImageComplex> > Twiddles;
+  // exp(-2 pi i k / p) for k < p, for each step
+  vtkstd::vector<vtkstd::vector<vtkImageComplex> > Roots;
+
+  vtkImageFourierPlan(int N)
     {
-    p2 = p1;
-    for(i2 = 0; i2 < bsize; ++i2)    // loop 0->2
+    // radix 4 first, it takes the fewest operations per element
+    int rest = N;
+    while (rest % 4 == 0)
       {
-      *p3 = *p2;         // out[0] = in[0];  out[1] = in[1];
-      ++p2;
-      ++p3;
+      this->Factors.push_back(4);
+      rest /= 4;
       }
-    p2 = p1;
-    for(i2 = 0; i2 < bsize; ++i2)
+    for (int p = 2; p <= rest; ++p)
       {
-      *p3 = *p2;         // out[2] = in[0];   out[3] = in[1];
-      ++p2;
-      ++p3;
+      while (rest % p == 0)
+        {
+        this->Factors.push_back(p);
+        rest /= p;
+        }
+      }
+
+    int n = N;
+    for (size_t i = 0; i < this->Factors.size(); ++i)
+      {
+      int p = this->Factors[i];
+      int m = n / p;
+      vtkstd::vector<vtkImageComplex> twiddles(m*(p - 1));
+      for (int q = 0; q < m; ++q)
+        {
+        for (int t = 1; t < p; ++t)
+          {
+          double phase = -2.0*vtkMath::DoublePi()*q*t/n;
+          vtkImageComplexPolarSet(twiddles[q*(p - 1) + t - 1], 1.0, phase);
+          }
+        }
+      vtkstd::vector<vtkImageComplex> roots(p);
+      for (int k = 0; k < p; ++k)
+        {
+        vtkImageComplexPolarSet(roots[k], 1.0, -2.0*vtkMath::DoublePi()*k/p);
+        }
+      this->Twiddles.push_back(twiddles);
+      this->Roots.push_back(roots);
+      n = m;
       }
-    p1 = p1 + bsize;
     }
-  
-  /* Add the links with factors. */
-  fact1.Real = 1.0;
-  fact1.Imag = 0.0;
-  q.Real = 0.0;
-  q.Imag = -2.0 * 3.141592654 * static_cast<float>(fb)
-    / static_cast<float>(bsize * 2);
-  vtkImageComplexExponential(q, q);
-  p3 = p_out;
-  for(i1 = 0; i1 < N / (bsize * 2); ++i1)
+};
+
+//----------------------------------------------------------------------------
+// The plans are computed once per size and kept until exit.
+class vtkImageFourierPlanCache
+{
+public:
+  ~vtkImageFourierPlanCache()
     {
-    fact = fact1;
-    p2 = p1;
-    for(i2 = 0; i2 < bsize; ++i2)
+    vtkstd::map<int, vtkImageFourierPlan *>::iterator i;
+    for (i = this->Plans.begin(); i != this->Plans.end(); ++i)
       {
-      vtkImageComplexMultiply(fact, *p2, temp);
-      vtkImageComplexAdd(temp, *p3, *p3);
-      vtkImageComplexMultiply(q, fact, fact);
-      ++p2;    // out[0] += in[2];   out[1] += -i*in[3];
-      ++p3;
+      delete i->second;
       }
-    p2 = p1;
-    for(i2 = 0; i2 < bsize; ++i2)
+    }
+
+  const vtkImageFourierPlan *GetPlan(int N)
+    {
+    this->Lock.Lock();
+    vtkImageFourierPlan *&plan = this->Plans[N];
+    if (!plan)
       {
-      vtkImageComplexMultiply(fact, *p2, temp);
-      vtkImageComplexAdd(temp, *p3, *p3);
-      vtkImageComplexMultiply(q, fact, fact);
-      ++p2;
-      ++p3;
+      plan = new vtkImageFourierPlan(N);
       }
-    p1 = p1 + bsize;
+    this->Lock.Unlock();
+    return plan;
     }
+
+private:
+  vtkstd::map<int, vtkImageFourierPlan *> Plans;
+  vtkSimpleCriticalSection Lock;
+};
+
+static vtkImageFourierPlanCache vtkImageFourierPlans;
+
+/*=========================================================================
+        Vectors of complex numbers.
+=========================================================================*/
+
+//----------------------------------------------------------------------------
+// Multiply by the twiddle factor w, or by its conjugate for fb = -1.
+static inline void vtkImageFourierTwiddle(vtkImageComplex &c,
+                                          const vtkImageComplex &w, int fb)
+{
+  double wi = fb*w.Imag;
+  double real = c.Real*w.Real - c.Imag*wi;
+  c.Imag = c.Real*wi + c.Imag*w.Real;
+  c.Real = real;
 }
 
 //----------------------------------------------------------------------------
-// This function calculates one step of a FFT (using any factor).
-// It is engineered for no decimation.
-//  N: length of arrays 
-//  bsize: Size of FFT so far (should be scaled by n after this step)
-//  n: size of this steps butterfly.
-//  fb: forward: fb = 1, backward: fb = -1 
-void vtkImageFourierFilter::ExecuteFftStepN(vtkImageComplex *p_in, 
-                                            vtkImageComplex *p_out,
-                                            int N, int bsize, int n, int fb)
+// This function calculates one step of the fft of 'count' interleaved
+// arrays, from arrays of length n with stride s to arrays of length n/p
+// with stride s*p.
+// (forward: fb = 1, backward: fb = -1)
+static void vtkImageFourierStep(const vtkImageComplex *x, vtkImageComplex *y,
+                                int n, int s, int p, int count,
+                                const vtkImageComplex *twiddles,
+                                const vtkImageComplex *roots, int fb)
 {
-  int i0, i1, i2, i3;
-  vtkImageComplex *p1, *p2, *p3;
-  vtkImageComplex q, fact, temp;
+  int m = n / p;
+  // the elements of all the arrays with the same index in a sub-array
+  // are contiguous
+  int run = s*count;
+  vtkImageComplex a0, a1, a2, a3, b0, b1, b2, b3;
 
-  p3 = p_out; 
-  for(i0 = 0; i0 < N; ++i0)
+  if (p == 2)
+    {
+    for (int q = 0; q < m; ++q)
+      {
+      const vtkImageComplex *x0 = x + q*run;
+      const vtkImageComplex *x1 = x + (q + m)*run;
+      vtkImageComplex *y0 = y + 2*q*run;
+      vtkImageComplex *y1 = y0 + run;
+      const vtkImageComplex &w = twiddles[q];
+      for (int r = 0; r < run; ++r)
+        {
+        a0 = x0[r];
+        a1 = x1[r];
+        vtkImageComplexAdd(a0, a1, y0[r]);
+        vtkImageComplexSubtract(a0, a1, b1);
+        vtkImageFourierTwiddle(b1, w, fb);
+        y1[r] = b1;
+        }
+      }
+    }
+  else if (p == 4)
     {
-    p3->Real = 0.0;
-    p3->Imag = 0.0;
-    ++p3;
+    for (int q = 0; q < m; ++q)
+      {
+      const vtkImageComplex *x0 = x + q*run;
+      const vtkImageComplex *x1 = x + (q + m)*run;
+      const vtkImageComplex *x2 = x + (q + 2*m)*run;
+      const vtkImageComplex *x3 = x + (q + 3*m)*run;
+      vtkImageComplex *y0 = y + 4*q*run;
+      vtkImageComplex *y1 = y0 + run;
+      vtkImageComplex *y2 = y1 + run;
+      vtkImageComplex *y3 = y2 + run;
+      const vtkImageComplex *w = twiddles + 3*q;
+      for (int r = 0; r < run; ++r)
+        {
+        a0 = x0[r];
+        a1 = x1[r];
+        a2 = x2[r];
+        a3 = x3[r];
+        vtkImageComplexAdd(a0, a2, b0);
+        vtkImageComplexSubtract(a0, a2, b1);
+        vtkImageComplexAdd(a1, a3, b2);
+        vtkImageComplexSubtract(a1, a3, b3);
+        // b3 times -i for the forward transform, times i for the backward
+        a3.Real = fb*b3.Imag;
+        a3.Imag = -fb*b3.Real;
+        vtkImageComplexAdd(b0, b2, y0[r]);
+        vtkImageComplexAdd(b1, a3, a1);
+        vtkImageComplexSubtract(b0, b2, a2);
+        vtkImageComplexSubtract(b1, a3, b3);
+        vtkImageFourierTwiddle(a1, w[0], fb);
+        vtkImageFourierTwiddle(a2, w[1], fb);
+        vtkImageFourierTwiddle(b3, w[2], fb);
+        y1[r] = a1;
+        y2[r] = a2;
+        y3[r] = b3;
+        }
+      }
     }
-  
-  p1 = p_in;
-  for(i0 = 0; i0 < n; ++i0)
+  else
     {
-    q.Real = 0.0;
-    q.Imag = -2.0 * 3.141592654 * static_cast<float>(i0) *
-      static_cast<float>(fb) / static_cast<float>(bsize*n);
-    vtkImageComplexExponential(q, q);
-    p3 = p_out;
-    for(i1 = 0; i1 < N / (bsize * n); ++i1)
+    // a discrete Fourier transform of size p
+    vtkstd::vector<vtkImageComplex> a(p);
+    for (int q = 0; q < m; ++q)
       {
-      fact.Real = 1.0;
-      fact.Imag = 0.0;
-      for(i3 = 0; i3 < n; ++i3)
+      const vtkImageComplex *w = twiddles + (p - 1)*q;
+      for (int r = 0; r < run; ++r)
         {
-        p2 = p1;
-        for(i2 = 0; i2 < bsize; ++i2)
+        for (int j = 0; j < p; ++j)
           {
-          vtkImageComplexMultiply(fact, *p2, temp);
-          vtkImageComplexAdd(temp, *p3, *p3);
-          vtkImageComplexMultiply(q, fact, fact);
-          ++p2;
-          ++p3;
+          a[j] = x[(q + j*m)*run + r];
+          }
+        for (int t = 0; t < p; ++t)
+          {
+          vtkImageComplex sum = a[0];
+          int k = 0;
+          for (int j = 1; j < p; ++j)
+            {
+            k += t;
+            k = (k < p ? k : k - p);
+            b0 = a[j];
+            vtkImageFourierTwiddle(b0, roots[k], fb);
+            vtkImageComplexAdd(sum, b0, sum);
+            }
+          if (t > 0)
+            {
+            vtkImageFourierTwiddle(sum, w[t - 1], fb);
+            }
+          y[(p*q + t)*run + r] = sum;
           }
         }
-      
-      p1 = p1 + bsize;
       }
     }
 }
 
-
-
 //----------------------------------------------------------------------------
 // This function calculates the whole fft (or rfft) of an array.
 // The contents of the input array are changed.
 // It is engineered for no decimation so input and output cannot be equal.
 // (fb = 1) => fft, (fb = -1) => rfft;
-void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in, 
-                                                      vtkImageComplex *out, 
+void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in,
+                                                      vtkImageComplex *out,
                                                       int N, int fb)
+{
+  this->ExecuteFftForwardBackward(in, out, N, 1, fb);
+}
+
+//----------------------------------------------------------------------------
+// The same for 'count' interleaved arrays.
+void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in,
+                                                      vtkImageComplex *out,
+                                                      int N, int count,
+                                                      int fb)
 {
   vtkImageComplex *p1, *p2, *p3;
-  int block_size = 1;
-  int rest_size = N;
-  int n = 2;
   int idx;
+  int size = N*count;
+  if (N < 1)
+    {
+    return;
+    }
 
   // If this is a reverse transform (scale accordingly).
   if(fb == -1)
-    {  
+    {
     p1 = in;
-    for(idx = 0; idx < N; ++idx)
+    for(idx = 0; idx < size; ++idx)
       {
-      p1->Real = p1->Real / static_cast<float>(N);
-      p1->Imag = p1->Imag / static_cast<float>(N);
+      p1->Real = p1->Real / N;
+      p1->Imag = p1->Imag / N;
       ++p1;
       }
     }
+
+  const vtkImageFourierPlan *plan = vtkImageFourierPlans.GetPlan(N);
   p1 = in;
   p2 = out;
-  while(block_size < N && n <= N)
+  int n = N;
+  int s = 1;
+  for (size_t i = 0; i < plan->Factors.size(); ++i)
     {
-    if((rest_size % n) == 0)
-      {
-      // n is a prime factor, perform one "butterfly" stage of the fft.
-      if(n == 2)
-        {
-        this->ExecuteFftStep2(p1, p2, N, block_size, fb);
-        }
-      else
-        {
-        this->ExecuteFftStepN(p1, p2, N, block_size, n, fb);
-        }
-      block_size = block_size * n;
-      rest_size = rest_size / n;
-      // switch input and output.
-      p3 = p1;
-      p1 = p2;
-      p2 = p3;
-      }
-    else
-      {
-      // n is not a prime factor. increment n to see if n+1 is.
-      ++n;
-      }
+    // perform one "butterfly" stage of the fft.
+    int p = plan->Factors[i];
+    vtkImageFourierStep(p1, p2, n, s, p, count, &plan->Twiddles[i][0],
+                        &plan->Roots[i][0], fb);
+    n /= p;
+    s *= p;
+    // switch input and output.
+    p3 = p1;
+    p1 = p2;
+    p2 = p3;
     }
   // If the results ended up in the input, copy to output.
   if(p1 != out)
     {
-    for(n = 0; n < N; ++n)
+    for(idx = 0; idx < size; ++idx)
       {
       *out++ = *p1++;
       }
     }
 }
 
-
+//----------------------------------------------------------------------------
+int vtkImageFourierFilter::GetBatchSize(int N)
+{
+  int count = VTK_IMAGE_FOURIER_CACHE_SIZE /
+    (2*static_cast<int>(sizeof(vtkImageComplex))*(N > 0 ? N : 1));
+  count = (count < VTK_IMAGE_FOURIER_MAX_BATCH ?
+           count : VTK_IMAGE_FOURIER_MAX_BATCH);
+  return (count > 1 ? count : 1);
+}
 
 //----------------------------------------------------------------------------
 // This function calculates the whole fft of an array.
 // The contents of the input array are changed.
 // (It is engineered for no decimation)
-void vtkImageFourierFilter::ExecuteFft(vtkImageComplex *in, 
+void vtkImageFourierFilter::ExecuteFft(vtkImageComplex *in,
                                        vtkImageComplex *out, int N)
 {
   this->ExecuteFftForwardBackward(in, out, N, 1);
@@ -225,10 +338,24 @@ void vtkImageFourierFilter::ExecuteFft(vtkImageComplex *in,
 // This function calculates the whole fft of an array.
 // The contents of the input array are changed.
 // (It is engineered for no decimation)
-void vtkImageFourierFilter::ExecuteRfft(vtkImageComplex *in, 
+void vtkImageFourierFilter::ExecuteRfft(vtkImageComplex *in,
                                         vtkImageComplex *out, int N)
 {
   this->ExecuteFftForwardBackward(in, out, N, -1);
 }
- 
 
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::ExecuteFft(vtkImageComplex *in,
+                                       vtkImageComplex *out, int N,
+                                       int count)
+{
+  this->ExecuteFftForwardBackward(in, out, N, count, 1);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::ExecuteRfft(vtkImageComplex *in,
+                                        vtkImageComplex *out, int N,
+                                        int count)
+{
+  this->ExecuteFftForwardBackward(in, out, N, count, -1);
+}
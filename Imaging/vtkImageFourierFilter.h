@@ -18,6 +18,8 @@
 // this superclass is a container for methods that manipulate these structure
 // including fast Fourier transforms.  Complex numbers may become a class.
 // This should really be a helper class.
+// The transforms use a plan of the factors and twiddle factors of the
+// array size, which is computed once per size and shared by all filters.
 #ifndef __vtkImageFourierFilter_h
 #define __vtkImageFourierFilter_h
 
@@ -105,6 +107,21 @@ public:
   // (It is engineered for no decimation)
   void ExecuteRfft(vtkImageComplex *in, vtkImageComplex *out, int N);
 
+  // Description:
+  // These functions calculate the fft of 'count' arrays of length N at
+  // once.  The arrays are interleaved: element k of array b is at
+  // in[k*count + b], so that every step of the transform runs over
+  // contiguous memory.  The contents of the input array are changed.
+  void ExecuteFft(vtkImageComplex *in, vtkImageComplex *out, int N,
+                  int count);
+  void ExecuteRfft(vtkImageComplex *in, vtkImageComplex *out, int N,
+                   int count);
+
+  // Description:
+  // The number of arrays of length N to transform at once so that the
+  // work space stays in the processor cache.
+  static int GetBatchSize(int N);
+
   //ETX
   
 protected:
@@ -112,12 +129,10 @@ protected:
   ~vtkImageFourierFilter() {};
 
   //BTX
-  void ExecuteFftStep2(vtkImageComplex *p_in, vtkImageComplex *p_out, 
-                       int N, int bsize, int fb);
-  void ExecuteFftStepN(vtkImageComplex *p_in, vtkImageComplex *p_out,
-                       int N, int bsize, int n, int fb);
   void ExecuteFftForwardBackward(vtkImageComplex *in, vtkImageComplex *out, 
                                  int N, int fb);
+  void ExecuteFftForwardBackward(vtkImageComplex *in, vtkImageComplex *out,
+                                 int N, int count, int fb);
   //ETX
 private:
   vtkImageFourierFilter(const vtkImageFourierFilter&);  // Not implemented.
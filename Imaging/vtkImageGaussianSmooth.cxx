@@ -34,6 +34,7 @@ vtkImageGaussianSmooth::vtkImageGaussianSmooth()
   this->RadiusFactors[0] = 1.5;
   this->RadiusFactors[1] = 1.5;
   this->RadiusFactors[2] = 1.5;
+  this->SmoothingMode = VTK_IMAGE_GAUSSIAN_SMOOTH_KERNEL;
 }
 
 //----------------------------------------------------------------------------
@@ -61,6 +62,99 @@ void vtkImageGaussianSmooth::PrintSelf(ostream& os, vtkIndent indent)
      << this->StandardDeviations[0] << ", "
      << this->StandardDeviations[1] << ", "
      << this->StandardDeviations[2] << " )\n";
+
+  os << indent << "SmoothingMode: "
+     << this->GetSmoothingModeAsString() << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char *vtkImageGaussianSmooth::GetSmoothingModeAsString()
+{
+  switch (this->SmoothingMode)
+    {
+    case VTK_IMAGE_GAUSSIAN_SMOOTH_KERNEL:
+      return "Kernel";
+    case VTK_IMAGE_GAUSSIAN_SMOOTH_RECURSIVE:
+      return "Recursive";
+    case VTK_IMAGE_GAUSSIAN_SMOOTH_BOX:
+      return "Box";
+    }
+  return "";
+}
+
+//----------------------------------------------------------------------------
+// The recursive filter is not accurate for small standard deviations.
+static int vtkImageGaussianSmoothGetMode(int mode, double std)
+{
+  if (mode == VTK_IMAGE_GAUSSIAN_SMOOTH_RECURSIVE && std < 0.5)
+    {
+    return VTK_IMAGE_GAUSSIAN_SMOOTH_KERNEL;
+    }
+  return mode;
+}
+
+//----------------------------------------------------------------------------
+// Find the radii of three boxes whose variances add up to about std^2
+// (a box of width 2r+1 has a variance of r(r+1)/3), and return their sum.
+static int vtkImageGaussianSmoothBoxRadii(double std, int radii[3])
+{
+  int n = 3;
+  int wl = static_cast<int>(sqrt(12.0*std*std/n + 1.0));
+  if (wl % 2 == 0)
+    {
+    --wl;
+    }
+  // the number of boxes of width wl, the others have width wl+2
+  int m = static_cast<int>(
+    floor((12.0*std*std - n*wl*wl - 4*n*wl - 3*n)/(-4.0*wl - 4.0) + 0.5));
+  m = (m < 0 ? 0 : (m > n ? n : m));
+  int sum = 0;
+  for (int i = 0; i < n; ++i)
+    {
+    radii[i] = (i < m ? wl - 1 : wl + 1)/2;
+    sum += radii[i];
+    }
+  return sum;
+}
+
+//----------------------------------------------------------------------------
+// The coefficients of the recursive filter of Young and van Vliet:
+// w[i] = c[0]*x[i] + c[1]*w[i-1] + c[2]*w[i-2] + c[3]*w[i-3]
+static void vtkImageGaussianSmoothRecursiveCoefficients(double std,
+                                                        double c[4])
+{
+  double q;
+  if (std >= 2.5)
+    {
+    q = 0.98711*std - 0.96330;
+    }
+  else
+    {
+    q = 3.97156 - 4.14554*sqrt(1.0 - 0.26891*std);
+    }
+  double q2 = q*q;
+  double q3 = q2*q;
+  double b0 = 1.57825 + 2.44413*q + 1.4281*q2 + 0.422205*q3;
+  c[1] = (2.44413*q + 2.85619*q2 + 1.26661*q3)/b0;
+  c[2] = -(1.4281*q2 + 1.26661*q3)/b0;
+  c[3] = 0.422205*q3/b0;
+  c[0] = 1.0 - c[1] - c[2] - c[3];
+}
+
+//----------------------------------------------------------------------------
+// The number of pixels the smoothing reads on each side of an output pixel.
+int vtkImageGaussianSmooth::ComputeRadius(int axis)
+{
+  double std = this->StandardDeviations[axis];
+  int radii[3];
+  switch (vtkImageGaussianSmoothGetMode(this->SmoothingMode, std))
+    {
+    case VTK_IMAGE_GAUSSIAN_SMOOTH_RECURSIVE:
+      return static_cast<int>(ceil(4.0*std));
+    case VTK_IMAGE_GAUSSIAN_SMOOTH_BOX:
+      return vtkImageGaussianSmoothBoxRadii(std, radii);
+    }
+  return static_cast<int>(std * this->RadiusFactors[axis]);
 }
 
 //----------------------------------------------------------------------------
@@ -125,8 +219,7 @@ void vtkImageGaussianSmooth::InternalRequestUpdateExtent(int *inExt,
   // Expand filtered axes
   for (idx = 0; idx < this->Dimensionality; ++idx)
     {
-    radius = static_cast<int>(this->StandardDeviations[idx]
-                              * this->RadiusFactors[idx]);
+    radius = this->ComputeRadius(idx);
     inExt[idx*2] -= radius;
     if (inExt[idx*2] < wholeExtent[idx*2])
       {
@@ -243,6 +336,200 @@ size_t vtkImageGaussianSmoothGetTypeSize(T*)
   return sizeof(T);
 }
 
+//----------------------------------------------------------------------------
+// Average each pixel of a line over a box of the given radius, with
+// running sums.  The box is clipped to the line and renormalized.
+static void vtkImageGaussianSmoothBox(double *line, double *sums, int n,
+                                      int radius)
+{
+  int i;
+  sums[0] = 0.0;
+  for (i = 0; i < n; ++i)
+    {
+    sums[i + 1] = sums[i] + line[i];
+    }
+  for (i = 0; i < n; ++i)
+    {
+    int lo = (i - radius > 0 ? i - radius : 0);
+    int hi = (i + radius < n - 1 ? i + radius : n - 1);
+    line[i] = (sums[hi + 1] - sums[lo])/(hi - lo + 1);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Run the recursive filter forward and backward along a line, with zeros
+// past the ends.  Dividing by the same filter applied to ones renormalizes
+// it near the ends, as the clipped kernel is.
+static void vtkImageGaussianSmoothRecursive(double *line, int n,
+                                            const double c[4])
+{
+  int i;
+  double w1, w2, w3;
+  w1 = w2 = w3 = 0.0;
+  for (i = 0; i < n; ++i)
+    {
+    double w = c[0]*line[i] + c[1]*w1 + c[2]*w2 + c[3]*w3;
+    line[i] = w;
+    w3 = w2;
+    w2 = w1;
+    w1 = w;
+    }
+  w1 = w2 = w3 = 0.0;
+  for (i = n - 1; i >= 0; --i)
+    {
+    double w = c[0]*line[i] + c[1]*w1 + c[2]*w2 + c[3]*w3;
+    line[i] = w;
+    w3 = w2;
+    w2 = w1;
+    w1 = w;
+    }
+}
+
+//----------------------------------------------------------------------------
+// For the recursive and box modes, this method copies each line along the
+// axis into a buffer, smooths it, and copies the part within the output
+// extent back.  Successive lines are next to each other in memory, so the
+// copies mostly hit the cache even along z.
+template <class T>
+void
+vtkImageGaussianSmoothExecuteLines(vtkImageGaussianSmooth *self, int axis,
+                                   int mode, double std,
+                                   vtkImageData *inData, int inExt[6],
+                                   vtkImageData *outData, int outExt[6],
+                                   T *, int *pcycle, int target,
+                                   int *pcount, int total)
+{
+  int maxC, max0 = 0, max1 = 0;
+  int idxC, idx0, idx1, idxA;
+  vtkIdType *inIncs, *outIncs;
+  vtkIdType inInc0 = 0, inInc1 = 0, inIncA, outInc0 = 0, outInc1 = 0, outIncA;
+  T *inPtrC, *outPtrC, *inPtr1, *outPtr1, *inPtr0, *outPtr0, *ptrA;
+  int coords[3];
+
+  // the lines start at the input extent, the output is a part of them
+  // (get the pointers first, they allocate the temporary data)
+  int lineLength = inExt[axis*2+1] - inExt[axis*2] + 1;
+  int outStart = outExt[axis*2] - inExt[axis*2];
+  int outLength = outExt[axis*2+1] - outExt[axis*2] + 1;
+  coords[0] = outExt[0];
+  coords[1] = outExt[2];
+  coords[2] = outExt[4];
+  coords[axis] = inExt[axis*2];
+  inPtrC = static_cast<T *>(inData->GetScalarPointer(coords));
+  outPtrC = static_cast<T *>(outData->GetScalarPointerForExtent(outExt));
+
+  // Do the correct shuffling of the axes (increments, extents)
+  inIncs = inData->GetIncrements();
+  outIncs = outData->GetIncrements();
+  inIncA = inIncs[axis];
+  outIncA = outIncs[axis];
+  maxC = outData->GetNumberOfScalarComponents();
+  switch (axis)
+    {
+    case 0:
+      inInc0 = inIncs[1];  inInc1 = inIncs[2];
+      outInc0 = outIncs[1];  outInc1 = outIncs[2];
+      max0 = outExt[3] - outExt[2] + 1;   max1 = outExt[5] - outExt[4] + 1;
+      break;
+    case 1:
+      inInc0 = inIncs[0];  inInc1 = inIncs[2];
+      outInc0 = outIncs[0];  outInc1 = outIncs[2];
+      max0 = outExt[1] - outExt[0] + 1;   max1 = outExt[5] - outExt[4] + 1;
+      break;
+    case 2:
+      inInc0 = inIncs[0];  inInc1 = inIncs[1];
+      outInc0 = outIncs[0];  outInc1 = outIncs[1];
+      max0 = outExt[1] - outExt[0] + 1;   max1 = outExt[3] - outExt[2] + 1;
+      break;
+    }
+
+  int radii[3];
+  double coefficients[4];
+  if (mode == VTK_IMAGE_GAUSSIAN_SMOOTH_BOX)
+    {
+    vtkImageGaussianSmoothBoxRadii(std, radii);
+    }
+  else
+    {
+    vtkImageGaussianSmoothRecursiveCoefficients(std, coefficients);
+    }
+  double *line = new double[2*lineLength + 1];
+  double *sums = line + lineLength;
+  if (mode == VTK_IMAGE_GAUSSIAN_SMOOTH_RECURSIVE)
+    {
+    // the weights of the pixels inside the line
+    for (idxA = 0; idxA < lineLength; ++idxA)
+      {
+      sums[idxA] = 1.0;
+      }
+    vtkImageGaussianSmoothRecursive(sums, lineLength, coefficients);
+    }
+
+  for (idxC = 0; idxC < maxC; ++idxC)
+    {
+    inPtr1 = inPtrC;
+    outPtr1 = outPtrC;
+    for (idx1 = 0; !self->AbortExecute && idx1 < max1; ++idx1)
+      {
+      inPtr0 = inPtr1;
+      outPtr0 = outPtr1;
+      for (idx0 = 0; idx0 < max0; ++idx0)
+        {
+        ptrA = inPtr0;
+        for (idxA = 0; idxA < lineLength; ++idxA)
+          {
+          line[idxA] = static_cast<double>(*ptrA);
+          ptrA += inIncA;
+          }
+        if (mode == VTK_IMAGE_GAUSSIAN_SMOOTH_BOX)
+          {
+          for (int i = 0; i < 3; ++i)
+            {
+            if (radii[i] > 0)
+              {
+              vtkImageGaussianSmoothBox(line, sums, lineLength, radii[i]);
+              }
+            }
+          }
+        else
+          {
+          vtkImageGaussianSmoothRecursive(line, lineLength, coefficients);
+          for (idxA = outStart; idxA < outStart + outLength; ++idxA)
+            {
+            line[idxA] /= sums[idxA];
+            }
+          }
+        ptrA = outPtr0;
+        for (idxA = 0; idxA < outLength; ++idxA)
+          {
+          *ptrA = static_cast<T>(line[outStart + idxA]);
+          ptrA += outIncA;
+          }
+        inPtr0 += inInc0;
+        outPtr0 += outInc0;
+        }
+      inPtr1 += inInc1;
+      outPtr1 += outInc1;
+      // we finished a row ... do we update ???
+      if (total)
+        { // yes this is the main thread
+        *pcycle += max0*outLength;
+        if (target > 0 && *pcycle > target)
+          {
+          *pcount += *pcycle - *pcycle % target;
+          *pcycle %= target;
+          self->UpdateProgress(static_cast<double>(*pcount) /
+                               static_cast<double>(total));
+          }
+        }
+      }
+    ++inPtrC;
+    ++outPtrC;
+    }
+
+  delete [] line;
+}
+
 //----------------------------------------------------------------------------
 // This method convolves over one axis. It loops over the convolved axis,
 // and handles boundary conditions.
@@ -267,6 +554,26 @@ void vtkImageGaussianSmooth::ExecuteAxis(int axis,
   int coords[3];
   vtkIdType *outIncs, outIncA;
   
+  // the recursive and box modes smooth whole lines at a time
+  int mode = vtkImageGaussianSmoothGetMode(this->SmoothingMode,
+                                           this->StandardDeviations[axis]);
+  if (mode != VTK_IMAGE_GAUSSIAN_SMOOTH_KERNEL)
+    {
+    switch (inData->GetScalarType())
+      {
+      vtkTemplateMacro(
+        vtkImageGaussianSmoothExecuteLines(this, axis, mode,
+                                           this->StandardDeviations[axis],
+                                           inData, inExt, outData, outExt,
+                                           static_cast<VTK_TT*>(0),
+                                           pcycle, target, pcount, total)
+        );
+      default:
+        vtkErrorMacro("Unknown scalar type");
+      }
+    return;
+    }
+
   // Get the correct starting pointer of the output
   outPtr = outData->GetScalarPointerForExtent(outExt);
   outIncs = outData->GetIncrements();
@@ -294,8 +601,7 @@ void vtkImageGaussianSmooth::ExecuteAxis(int axis,
   wholeMax = wholeExtent[axis*2+1];  
 
   // allocate memory for the kernel
-  radius = static_cast<int>(this->StandardDeviations[axis]
-                            * this->RadiusFactors[axis]);
+  radius = this->ComputeRadius(axis);
   size = 2*radius + 1;
   kernel = new double[size];
   
@@ -16,6 +16,9 @@
 // .SECTION Description
 // vtkImageGaussianSmooth implements a convolution of the input image
 // with a gaussian. Supports from one to three dimensional convolutions.
+// The cost of the default mode grows with the radius of the kernel.
+// For large standard deviations, the recursive and box modes give an
+// approximation whose cost per pixel does not depend on the radius.
 
 #ifndef __vtkImageGaussianSmooth_h
 #define __vtkImageGaussianSmooth_h
@@ -23,6 +26,10 @@
 
 #include "vtkThreadedImageAlgorithm.h"
 
+#define VTK_IMAGE_GAUSSIAN_SMOOTH_KERNEL 0
+#define VTK_IMAGE_GAUSSIAN_SMOOTH_RECURSIVE 1
+#define VTK_IMAGE_GAUSSIAN_SMOOTH_BOX 2
+
 class VTK_IMAGING_EXPORT vtkImageGaussianSmooth : public vtkThreadedImageAlgorithm
 {
 public:
@@ -69,6 +76,28 @@ public:
   vtkSetMacro(Dimensionality, int);
   vtkGetMacro(Dimensionality, int);
 
+  // Description:
+  // Set/Get how the gaussian is computed (default: Kernel).
+  // Kernel convolves with the sampled gaussian, clipped at the radius.
+  // Recursive runs the recursive filter of Young and van Vliet forward
+  // and backward along each line.  It ignores the RadiusFactors and reads
+  // four standard deviations past the output, and falls back to the
+  // kernel for standard deviations below 0.5.  Box averages the pixels in
+  // three successive boxes whose combined variance approximates the
+  // gaussian, using running sums.  Near the edges of the image, all modes
+  // are renormalized to the pixels inside the image.
+  vtkSetClampMacro(SmoothingMode, int,
+                   VTK_IMAGE_GAUSSIAN_SMOOTH_KERNEL,
+                   VTK_IMAGE_GAUSSIAN_SMOOTH_BOX);
+  vtkGetMacro(SmoothingMode, int);
+  void SetSmoothingModeToKernel() {
+    this->SetSmoothingMode(VTK_IMAGE_GAUSSIAN_SMOOTH_KERNEL); };
+  void SetSmoothingModeToRecursive() {
+    this->SetSmoothingMode(VTK_IMAGE_GAUSSIAN_SMOOTH_RECURSIVE); };
+  void SetSmoothingModeToBox() {
+    this->SetSmoothingMode(VTK_IMAGE_GAUSSIAN_SMOOTH_BOX); };
+  const char *GetSmoothingModeAsString();
+
 protected:
   vtkImageGaussianSmooth();
   ~vtkImageGaussianSmooth();
@@ -76,7 +105,9 @@ protected:
   int Dimensionality;
   double StandardDeviations[3];
   double RadiusFactors[3];
+  int SmoothingMode;
   
+  int ComputeRadius(int axis);
   void ComputeKernel(double *kernel, int min, int max, double std);
   virtual int RequestUpdateExtent (vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   void InternalRequestUpdateExtent(int *, int*);
@@ -19,9 +19,7 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
-#include <vtkstd/vector>
 #include <vtkstd/algorithm>
-#include <vtkstd/numeric>
 
 vtkStandardNewMacro(vtkImageHybridMedian2D);
 
@@ -53,7 +51,9 @@ void vtkImageHybridMedian2DExecute(vtkImageHybridMedian2D *self,
   T *inPtr0, *inPtr1, *inPtrC;
   T *outPtr0, *outPtr1, *outPtrC, *ptr;
   T median1, median2, temp;
-  vtkstd::vector<T> array;
+  // at most nine pixels, kept on the stack
+  T array[9];
+  int n;
   unsigned long count = 0;
   unsigned long target;
 
@@ -98,119 +98,121 @@ void vtkImageHybridMedian2DExecute(vtkImageHybridMedian2D *self,
           // compute median of + neighborhood
           // note that y axis direction is up in vtk images, not down
           // as in screen coordinates
-          array.clear();
+          n = 0;
           // Center
           ptr = inPtrC;
-          array.push_back( *ptr );
+          array[n++] = *ptr;
           // left
           ptr = inPtrC;
           if (idx0 > wholeMin0)
             {
             ptr -= inInc0;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           if (idx0 - 1 > wholeMin0)
             {
             ptr -= inInc0;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           // right
           ptr = inPtrC;
           if (idx0 < wholeMax0)
             {
             ptr += inInc0;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           if (idx0 + 1 < wholeMax0)
             {
             ptr += inInc0;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           // down
           ptr = inPtrC;
           if (idx1 > wholeMin1)
             {
             ptr -= inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           if (idx1 - 1 > wholeMin1)
             {
             ptr -= inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           // up
           ptr = inPtrC;
           if (idx1 < wholeMax1)
             {
             ptr += inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           if (idx1 + 1 < wholeMax1)
             {
             ptr += inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
 
-          vtkstd::sort(array.begin(),array.end());
-          median1 = array[static_cast<unsigned int>(0.5*array.size())];
+          // only the middle needs to be in place
+          vtkstd::nth_element(array, array + n/2, array + n);
+          median1 = array[n/2];
 
           // compute median of x neighborhood
           // note that y axis direction is up in vtk images, not down
           // as in screen coordinates
-          array.clear();
+          n = 0;
           // Center
           ptr = inPtrC;
-          array.push_back( *ptr );
+          array[n++] = *ptr;
           // lower left
           if (idx0 > wholeMin0 && idx1 > wholeMin1)
             {
             ptr -= inInc0 + inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           if (idx0-1 > wholeMin0 && idx1-1 > wholeMin1)
             {
             ptr -= inInc0 + inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           // upper right
           ptr = inPtrC;
           if (idx0 < wholeMax0 && idx1 < wholeMax1)
             {
             ptr += inInc0 + inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           if (idx0+1 < wholeMax0 && idx1+1 < wholeMax1)
             {
             ptr += inInc0 + inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           // upper left
           ptr = inPtrC;
           if (idx0 > wholeMin0 && idx1 < wholeMax1)
             {
             ptr += -inInc0 + inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           if (idx0-1 > wholeMin0 && idx1+1 < wholeMax1)
             {
             ptr += -inInc0 + inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           // lower right
           ptr = inPtrC;
           if (idx0 < wholeMax0 && idx1 > wholeMin1)
             {
             ptr += inInc0 - inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
           if (idx0+1 < wholeMax0 && idx1-1 > wholeMin1)
             {
             ptr += inInc0 - inInc1;
-            array.push_back( *ptr );
+            array[n++] = *ptr;
             }
 
-          vtkstd::sort(array.begin(),array.end());
-          median2 = array[static_cast<unsigned int>(0.5*array.size())];
+          // only the middle needs to be in place
+          vtkstd::nth_element(array, array + n/2, array + n);
+          median2 = array[n/2];
 
           // Compute the median of the three. (med1, med2 and center)
           if (median1 > median2)
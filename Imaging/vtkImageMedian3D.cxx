@@ -30,6 +30,7 @@ vtkStandardNewMacro(vtkImageMedian3D);
 vtkImageMedian3D::vtkImageMedian3D()
 {
   this->NumberOfElements = 0;
+  this->MedianMode = VTK_IMAGE_MEDIAN_SORT;
   this->SetKernelSize(1,1,1);
   this->HandleBoundaries = 1;
 }
@@ -45,6 +46,20 @@ void vtkImageMedian3D::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "NumberOfElements: " << this->NumberOfElements << endl;
+  os << indent << "MedianMode: " << this->GetMedianModeAsString() << endl;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkImageMedian3D::GetMedianModeAsString()
+{
+  switch (this->MedianMode)
+    {
+    case VTK_IMAGE_MEDIAN_SORT:
+      return "Sort";
+    case VTK_IMAGE_MEDIAN_HISTOGRAM:
+      return "Histogram";
+    }
+  return "";
 }
 
 //-----------------------------------------------------------------------------
@@ -365,6 +380,221 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
   delete [] Sort;
 }
 
+//-----------------------------------------------------------------------------
+// Add (inc = 1) or remove (inc = -1) the pixels of the neighborhood at one
+// position along the row to the histogram.  'below' counts the pixels in
+// the coarse bins before the one at 'coarseIdx'.
+template <class T>
+void vtkImageMedian3DHistogramSlab(T *ptr, vtkIdType inInc1,
+                                   vtkIdType inInc2, int num1, int num2,
+                                   T minValue, int shift, int *hist,
+                                   int *coarse, int coarseIdx, int &below,
+                                   int &total, int inc)
+{
+  for (int idx2 = 0; idx2 < num2; ++idx2)
+    {
+    T *ptr1 = ptr;
+    for (int idx1 = 0; idx1 < num1; ++idx1)
+      {
+      int bin = static_cast<int>(*ptr1 - minValue);
+      hist[bin] += inc;
+      coarse[bin >> shift] += inc;
+      if ((bin >> shift) < coarseIdx)
+        {
+        below += inc;
+        }
+      ptr1 += inInc1;
+      }
+    ptr += inInc2;
+    }
+  total += inc*num1*num2;
+}
+
+//-----------------------------------------------------------------------------
+// The median from a histogram that slides along each row: moving one pixel
+// along x removes the slab of the neighborhood that it leaves and adds the
+// slab that it enters.  The median is found with a coarse histogram, whose
+// current bin follows the median, then a scan of the fine bins inside it.
+// The histogram is empty again at the end of each row, so it is only
+// cleared once.
+template <class T>
+void vtkImageMedian3DHistogramExecute(vtkImageMedian3D *self,
+                                      vtkImageData *inData, T *inPtr,
+                                      vtkImageData *outData, T *outPtr,
+                                      int outExt[6], int id,
+                                      vtkDataArray *inArray)
+{
+  int *kernelMiddle = self->GetKernelMiddle();
+  int *kernelSize = self->GetKernelSize();
+  int *inExt = inData->GetExtent();
+  vtkIdType inInc0, inInc1, inInc2;
+  vtkIdType outInc0, outInc1, outInc2;
+  int hoodMin[3], hoodMax[3];
+  int idx, idx0, idx1, idx2, idxC;
+  unsigned long count = 0;
+  unsigned long target;
+
+  inData->GetIncrements(inInc0, inInc1, inInc2);
+  outData->GetIncrements(outInc0, outInc1, outInc2);
+  int numComp = inArray->GetNumberOfComponents();
+
+  // the part of the input within the neighborhoods of the output
+  for (idx = 0; idx < 3; ++idx)
+    {
+    hoodMin[idx] = outExt[2*idx] - kernelMiddle[idx];
+    hoodMin[idx] = (hoodMin[idx] > inExt[2*idx] ?
+                    hoodMin[idx] : inExt[2*idx]);
+    hoodMax[idx] = outExt[2*idx+1] - kernelMiddle[idx] + kernelSize[idx] - 1;
+    hoodMax[idx] = (hoodMax[idx] < inExt[2*idx+1] ?
+                    hoodMax[idx] : inExt[2*idx+1]);
+    }
+
+  // the range of the values decides the size of the histogram
+  T minValue = inPtr[(hoodMin[0] - inExt[0])*inInc0 +
+                     (hoodMin[1] - inExt[2])*inInc1 +
+                     (hoodMin[2] - inExt[4])*inInc2];
+  T maxValue = minValue;
+  for (idx2 = hoodMin[2]; idx2 <= hoodMax[2]; ++idx2)
+    {
+    for (idx1 = hoodMin[1]; idx1 <= hoodMax[1]; ++idx1)
+      {
+      T *ptr = inPtr + (hoodMin[0] - inExt[0])*inInc0 +
+        (idx1 - inExt[2])*inInc1 + (idx2 - inExt[4])*inInc2;
+      for (idx0 = hoodMin[0]; idx0 <= hoodMax[0]; ++idx0)
+        {
+        for (idxC = 0; idxC < numComp; ++idxC)
+          {
+          minValue = (ptr[idxC] < minValue ? ptr[idxC] : minValue);
+          maxValue = (ptr[idxC] > maxValue ? ptr[idxC] : maxValue);
+          }
+        ptr += inInc0;
+        }
+      }
+    }
+  if (static_cast<double>(maxValue) - static_cast<double>(minValue) >= 65536)
+    {
+    vtkImageMedian3DExecute(self, inData, inPtr, outData, outPtr,
+                            outExt, id, inArray);
+    return;
+    }
+  int numBins = static_cast<int>(maxValue - minValue) + 1;
+
+  // about as many coarse bins as fine bins in each coarse bin
+  int shift = 0;
+  while ((1 << (2*shift)) < numBins)
+    {
+    ++shift;
+    }
+  int numCoarse = ((numBins - 1) >> shift) + 1;
+  int *hist = new int[(numCoarse << shift) + numCoarse];
+  int *coarse = hist + (numCoarse << shift);
+  for (idx = 0; idx < (numCoarse << shift) + numCoarse; ++idx)
+    {
+    hist[idx] = 0;
+    }
+
+  target = static_cast<unsigned long>(numComp*(outExt[5] - outExt[4] + 1)*
+                                      (outExt[3] - outExt[2] + 1)/50.0);
+  target++;
+
+  for (idxC = 0; idxC < numComp; ++idxC)
+    {
+    for (idx2 = outExt[4]; idx2 <= outExt[5]; ++idx2)
+      {
+      int min2 = idx2 - kernelMiddle[2];
+      int max2 = min2 + kernelSize[2] - 1;
+      min2 = (min2 > inExt[4] ? min2 : inExt[4]);
+      max2 = (max2 < inExt[5] ? max2 : inExt[5]);
+      for (idx1 = outExt[2];
+           !self->AbortExecute && idx1 <= outExt[3]; ++idx1)
+        {
+        if (!id)
+          {
+          if (!(count%target))
+            {
+            self->UpdateProgress(count/(50.0*target));
+            }
+          count++;
+          }
+        int min1 = idx1 - kernelMiddle[1];
+        int max1 = min1 + kernelSize[1] - 1;
+        min1 = (min1 > inExt[2] ? min1 : inExt[2]);
+        max1 = (max1 < inExt[3] ? max1 : inExt[3]);
+        // the first pixel of the row at x = inExt[0]
+        T *rowPtr = inPtr + (min1 - inExt[2])*inInc1 +
+          (min2 - inExt[4])*inInc2 + idxC;
+        int num1 = max1 - min1 + 1;
+        int num2 = max2 - min2 + 1;
+        T *outPtr0 = outPtr + (idx1 - outExt[2])*outInc1 +
+          (idx2 - outExt[4])*outInc2 + idxC;
+
+        int total = 0;
+        int coarseIdx = 0;
+        int below = 0;
+        int lo = 0;
+        int hi = -1;
+        for (idx0 = outExt[0]; idx0 <= outExt[1]; ++idx0)
+          {
+          int min0 = idx0 - kernelMiddle[0];
+          int max0 = min0 + kernelSize[0] - 1;
+          min0 = (min0 > inExt[0] ? min0 : inExt[0]);
+          max0 = (max0 < inExt[1] ? max0 : inExt[1]);
+          if (hi < lo)
+            {
+            lo = hi = min0;
+            --hi;
+            }
+          for (; lo < min0; ++lo)
+            {
+            vtkImageMedian3DHistogramSlab(
+              rowPtr + (lo - inExt[0])*inInc0, inInc1, inInc2, num1, num2,
+              minValue, shift, hist, coarse, coarseIdx, below, total, -1);
+            }
+          for (; hi < max0; ++hi)
+            {
+            vtkImageMedian3DHistogramSlab(
+              rowPtr + (hi + 1 - inExt[0])*inInc0, inInc1, inInc2, num1,
+              num2, minValue, shift, hist, coarse, coarseIdx, below, total,
+              1);
+            }
+
+          // the upper median
+          int rank = total/2;
+          while (below > rank)
+            {
+            --coarseIdx;
+            below -= coarse[coarseIdx];
+            }
+          while (below + coarse[coarseIdx] <= rank)
+            {
+            below += coarse[coarseIdx];
+            ++coarseIdx;
+            }
+          int bin = coarseIdx << shift;
+          int sum = below;
+          while (sum + hist[bin] <= rank)
+            {
+            sum += hist[bin];
+            ++bin;
+            }
+          *outPtr0 = static_cast<T>(minValue + bin);
+          outPtr0 += outInc0;
+          }
+
+        // empty the histogram for the next row
+        for (; lo <= hi; ++lo)
+          {
+          vtkImageMedian3DHistogramSlab(
+            rowPtr + (lo - inExt[0])*inInc0, inInc1, inInc2, num1, num2,
+            minValue, shift, hist, coarse, coarseIdx, below, total, -1);
+          }
+        }
+      }
+    }
+
+  delete [] hist;
+}
+
 //-----------------------------------------------------------------------------
 // This method contains the first switch statement that calls the correct
 // templated function for the input and output region types.
@@ -396,6 +626,25 @@ void vtkImageMedian3D::ThreadedRequestData(
     return;
     }
   
+  // the histogram needs integer values
+  if (this->MedianMode == VTK_IMAGE_MEDIAN_HISTOGRAM &&
+      inArray->GetDataType() != VTK_FLOAT &&
+      inArray->GetDataType() != VTK_DOUBLE)
+    {
+    switch (inArray->GetDataType())
+      {
+      vtkTemplateMacro(
+        vtkImageMedian3DHistogramExecute(this, inData[0][0],
+                                         static_cast<VTK_TT *>(inPtr),
+                                         outData[0],
+                                         static_cast<VTK_TT *>(outPtr),
+                                         outExt, id, inArray));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown input ScalarType");
+      }
+    return;
+    }
+
   switch (inArray->GetDataType())
     {
     vtkTemplateMacro(
@@ -18,7 +18,9 @@
 // median value from a rectangular neighborhood around that pixel.
 // Neighborhoods can be no more than 3 dimensional.  Setting one
 // axis of the neighborhood kernelSize to 1 changes the filter
-// into a 2D median.  
+// into a 2D median.  For integer scalars, the median can be taken from a
+// histogram that slides along each row instead of sorting every
+// neighborhood, which is much faster for large kernels.
 
 
 #ifndef __vtkImageMedian3D_h
@@ -27,6 +29,9 @@
 
 #include "vtkImageSpatialAlgorithm.h"
 
+#define VTK_IMAGE_MEDIAN_SORT 0
+#define VTK_IMAGE_MEDIAN_HISTOGRAM 1
+
 class VTK_IMAGING_EXPORT vtkImageMedian3D : public vtkImageSpatialAlgorithm
 {
 public:
@@ -43,11 +48,32 @@ public:
   // Return the number of elements in the median mask
   vtkGetMacro(NumberOfElements,int);
 
+  // Description:
+  // Set/Get how the median is computed (default: Sort).  Sort inserts
+  // each pixel of the neighborhood into a sorted array.  Histogram counts
+  // the values of the neighborhood in a histogram that is updated as the
+  // neighborhood moves along a row, so each step only adds and removes
+  // one slab of pixels.  It is used for integer scalars whose range in
+  // the neighborhood of the output spans at most 65536 values, otherwise
+  // the filter falls back to sorting.  When a neighborhood has an even
+  // number of pixels (even kernel sizes, or near the edges of the image),
+  // the histogram gives the upper of the two middle values, while sorting
+  // gives either of them depending on the order of the pixels.
+  vtkSetClampMacro(MedianMode, int,
+                   VTK_IMAGE_MEDIAN_SORT, VTK_IMAGE_MEDIAN_HISTOGRAM);
+  vtkGetMacro(MedianMode, int);
+  void SetMedianModeToSort() {
+    this->SetMedianMode(VTK_IMAGE_MEDIAN_SORT); };
+  void SetMedianModeToHistogram() {
+    this->SetMedianMode(VTK_IMAGE_MEDIAN_HISTOGRAM); };
+  const char *GetMedianModeAsString();
+
 protected:
   vtkImageMedian3D();
   ~vtkImageMedian3D();
 
   int NumberOfElements;
+  int MedianMode;
 
   void ThreadedRequestData(vtkInformation *request,
                            vtkInformationVector **inputVector,
@@ -58,7 +58,8 @@ int vtkImageRFFT::IterativeRequestUpdateExtent(
 
 //----------------------------------------------------------------------------
 // This templated execute method handles any type input, but the output
-// is always doubles.
+// is always doubles.  Several lines are transformed at once, interleaved
+// so that the transform runs over contiguous memory.
 template <class T>
 void vtkImageRFFTExecute(vtkImageRFFT *self,
                          vtkImageData *inData, int inExt[6], T *inPtr,
@@ -78,7 +79,9 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
   double *outPtr0, *outPtr1, *outPtr2;
   //
   int idx0, idx1, idx2, inSize0, numberOfComponents;
+  int batchSize, numLines, line;
   unsigned long count = 0;
+  unsigned long nextCount = 0;
   unsigned long target;
   double startProgress;
 
@@ -101,9 +104,10 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
     return;
     }
 
-  // Allocate the arrays of complex numbers
-  inComplex = new vtkImageComplex[inSize0];
-  outComplex = new vtkImageComplex[inSize0];
+  // Allocate the arrays of complex numbers for a batch of lines
+  batchSize = vtkImageFourierFilter::GetBatchSize(inSize0);
+  inComplex = new vtkImageComplex[inSize0*batchSize];
+  outComplex = new vtkImageComplex[inSize0*batchSize];
 
   target = static_cast<unsigned long>((outMax2-outMin2+1)*(outMax1-outMin1+1)
                                       * self->GetNumberOfIterations() / 50.0);
@@ -116,46 +120,57 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
     {
     inPtr1 = inPtr2;
     outPtr1 = outPtr2;
-    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; ++idx1)
+    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1;
+         idx1 += numLines)
       {
-      if (!id) 
+      numLines = outMax1 - idx1 + 1;
+      numLines = (numLines < batchSize ? numLines : batchSize);
+      if (!id)
         {
-        if (!(count%target))
+        if (count >= nextCount)
           {
           self->UpdateProgress(count/(50.0*target) + startProgress);
+          nextCount = count - count%target + target;
           }
-        count++;
+        count += numLines;
         }
+
       // copy into complex numbers
-      inPtr0 = inPtr1;
-      pComplex = inComplex;
-      for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+      for (line = 0; line < numLines; ++line)
         {
-        pComplex->Real = static_cast<double>(*inPtr0);
-        pComplex->Imag = 0.0;
-        if (numberOfComponents > 1)
-          { // yes we have an imaginary input
-          pComplex->Imag = static_cast<double>(inPtr0[1]);;
+        inPtr0 = inPtr1 + line*inInc1;
+        pComplex = inComplex + line;
+        for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+          {
+          pComplex->Real = static_cast<double>(*inPtr0);
+          pComplex->Imag = 0.0;
+          if (numberOfComponents > 1)
+            { // yes we have an imaginary input
+            pComplex->Imag = static_cast<double>(inPtr0[1]);
+            }
+          inPtr0 += inInc0;
+          pComplex += numLines;
           }
-        inPtr0 += inInc0;
-        ++pComplex;
         }
       
       // Call the method that performs the RFFT
-      self->ExecuteRfft(inComplex, outComplex, inSize0);
+      self->ExecuteRfft(inComplex, outComplex, inSize0, numLines);
 
       // copy into output
-      outPtr0 = outPtr1;
-      pComplex = outComplex + (outMin0 - inMin0);
-      for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+      for (line = 0; line < numLines; ++line)
         {
-        *outPtr0 = static_cast<double>(pComplex->Real);
-        outPtr0[1] = static_cast<double>(pComplex->Imag);
-        outPtr0 += outInc0;
-        ++pComplex;
+        outPtr0 = outPtr1 + line*outInc1;
+        pComplex = outComplex + (outMin0 - inMin0)*numLines + line;
+        for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+          {
+          *outPtr0 = pComplex->Real;
+          outPtr0[1] = pComplex->Imag;
+          outPtr0 += outInc0;
+          pComplex += numLines;
+          }
         }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
+      inPtr1 += numLines*inInc1;
+      outPtr1 += numLines*outInc1;
       }
     inPtr2 += inInc2;
     outPtr2 += outInc2;
@@ -171,7 +186,7 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
 //----------------------------------------------------------------------------
 // This method is passed input and output Datas, and executes the RFFT
 // algorithm to fill the output from the input.
-// Not threaded yet.
+// The lines are split between the threads by SplitExtent.
 void vtkImageRFFT::ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
                                   int outExt[6], int threadId)
 {
@@ -38,11 +38,40 @@
 #include <float.h>
 #include <math.h>
 
+// Interpolate whole rows with AVX2 where the compiler can target it for
+// single functions.  The processor is checked before the kernels are used.
+#if defined(_MSC_VER) && _MSC_VER >= 1700 && defined(_M_X64)
+# include <immintrin.h>
+# include <intrin.h>
+# define VTK_RESLICE_USE_AVX2
+# define VTK_RESLICE_AVX2_TARGET
+#elif defined(__x86_64__) && (defined(__clang__) || \
+  (defined(__GNUC__) && (__GNUC__ > 4 || \
+                         (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+# include <immintrin.h>
+# define VTK_RESLICE_USE_AVX2
+# define VTK_RESLICE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
 vtkStandardNewMacro(vtkImageReslice);
 vtkCxxSetObjectMacro(vtkImageReslice, InformationInput, vtkImageData);
 vtkCxxSetObjectMacro(vtkImageReslice,ResliceAxes,vtkMatrix4x4);
 vtkCxxSetObjectMacro(vtkImageReslice,ResliceTransform,vtkAbstractTransform);
 
+//--------------------------------------------------------------------------
+// Whether whole rows are interpolated with vector instructions
+static int vtkImageResliceGlobalVectorization = 1;
+
+void vtkImageReslice::SetGlobalVectorization(int val)
+{
+  vtkImageResliceGlobalVectorization = val;
+}
+
+int vtkImageReslice::GetGlobalVectorization()
+{
+  return vtkImageResliceGlobalVectorization;
+}
+
 //--------------------------------------------------------------------------
 // DO NOT SET MAX KERNEL SIZE TO LARGER THAN 14
 #define VTK_RESLICE_MAX_KERNEL_SIZE 14
@@ -3016,6 +3045,484 @@ void vtkResliceApplyTransform(vtkAbstractTransform *newtrans,
   inPoint[2] *= inInvSpacing[2];
 }
 
+#if defined(VTK_RESLICE_USE_AVX2)
+//----------------------------------------------------------------------------
+// The row kernels below interpolate four output voxels at a time with
+// AVX2.  They do the same double precision operations in the same order
+// as the scalar functions, without fused multiply-adds, so the output
+// does not depend on which code ran.  The index arithmetic is done with
+// 32-bit ints, so the input must have fewer than 2^31 elements.
+
+// Check once whether the processor and the system support AVX2.
+static int vtkResliceCheckAVX2()
+{
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    {
+    return 0;
+    }
+  __cpuid(info, 1);
+  // the system must save the ymm registers
+  if ((info[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 0x6) != 0x6)
+    {
+    return 0;
+    }
+  __cpuidex(info, 7, 0);
+  return ((info[1] & 0x20) != 0);
+#else
+  __builtin_cpu_init();
+  return (__builtin_cpu_supports("avx2") != 0);
+#endif
+}
+
+static const int vtkResliceHasAVX2 = vtkResliceCheckAVX2();
+
+// The vector version of vtkResliceFloor() for VTK_RESLICE_64BIT_FLOOR.
+VTK_RESLICE_AVX2_TARGET
+static inline __m128i vtkResliceFloorAVX2(__m256d x, __m256d &f)
+{
+  x = _mm256_add_pd(x, _mm256_set1_pd(103079215104.0 + VTK_RESLICE_FLOOR_TOL));
+  __m256d i = _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  f = _mm256_sub_pd(x, i);
+  return _mm256_cvttpd_epi32(_mm256_sub_pd(i, _mm256_set1_pd(103079215104.0)));
+}
+
+// The vector version of vtkResliceRound().
+VTK_RESLICE_AVX2_TARGET
+static inline __m128i vtkResliceRoundAVX2(__m256d x)
+{
+  x = _mm256_add_pd(x, _mm256_set1_pd(103079215104.5 + VTK_RESLICE_FLOOR_TOL));
+  __m256d i = _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  return _mm256_cvttpd_epi32(_mm256_sub_pd(i, _mm256_set1_pd(103079215104.0)));
+}
+
+// The vector version of vtkInterpolateClamp().
+VTK_RESLICE_AVX2_TARGET
+static inline __m128i vtkResliceClampAVX2(__m128i a, int b, int c)
+{
+  a = _mm_min_epi32(a, _mm_set1_epi32(c));
+  a = _mm_sub_epi32(a, _mm_set1_epi32(b));
+  return _mm_max_epi32(a, _mm_setzero_si128());
+}
+
+// Return 1 in the lanes where f is not zero, and 0 elsewhere.
+VTK_RESLICE_AVX2_TARGET
+static inline __m128i vtkResliceNonZeroAVX2(__m256d f)
+{
+  __m256d mask = _mm256_cmp_pd(f, _mm256_setzero_pd(), _CMP_NEQ_OQ);
+  return _mm256_cvttpd_epi32(_mm256_and_pd(mask, _mm256_set1_pd(1.0)));
+}
+
+// Load the input values at four offsets.
+template <class T>
+VTK_RESLICE_AVX2_TARGET
+static inline __m256d vtkResliceGatherAVX2(const T *inPtr, __m128i offsets)
+{
+  int o[4];
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(o), offsets);
+  return _mm256_set_pd(inPtr[o[3]], inPtr[o[2]], inPtr[o[1]], inPtr[o[0]]);
+}
+
+VTK_RESLICE_AVX2_TARGET
+static inline __m256d vtkResliceGatherAVX2(const float *inPtr, __m128i offsets)
+{
+  return _mm256_cvtps_pd(_mm_i32gather_ps(inPtr, offsets, 4));
+}
+
+template <class T>
+VTK_RESLICE_AVX2_TARGET
+static inline __m256d vtkResliceGatherAVX2(const T *inPtr, vtkIdType o0,
+                                           vtkIdType o1, vtkIdType o2,
+                                           vtkIdType o3)
+{
+  return _mm256_set_pd(inPtr[o3], inPtr[o2], inPtr[o1], inPtr[o0]);
+}
+
+// The weights of the cubic rule of vtkTricubicInterpWeights(), with
+// the weights 0, 1, 0, 0 in the lanes that are not interpolated.
+VTK_RESLICE_AVX2_TARGET
+static inline void vtkResliceTricubicWeightsAVX2(__m256d F[4], __m256d f,
+                                                 __m256d interpolate)
+{
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d sign = _mm256_set1_pd(-0.0);
+
+  __m256d fm1 = _mm256_sub_pd(f, one);
+  __m256d fd2 = _mm256_mul_pd(f, _mm256_set1_pd(0.5));
+  __m256d ft3 = _mm256_mul_pd(f, _mm256_set1_pd(3.0));
+  __m256d F0 = _mm256_mul_pd(_mm256_mul_pd(_mm256_xor_pd(fd2, sign), fm1),
+                             fm1);
+  __m256d F1 = _mm256_mul_pd(
+    _mm256_sub_pd(_mm256_mul_pd(_mm256_sub_pd(ft3, _mm256_set1_pd(2.0)), fd2),
+                  one), fm1);
+  __m256d F2 = _mm256_mul_pd(_mm256_xor_pd(
+    _mm256_sub_pd(_mm256_mul_pd(_mm256_sub_pd(ft3, _mm256_set1_pd(4.0)), f),
+                  one), sign), fd2);
+  __m256d F3 = _mm256_mul_pd(_mm256_mul_pd(f, fd2), fm1);
+
+  F[0] = _mm256_blendv_pd(zero, F0, interpolate);
+  F[1] = _mm256_blendv_pd(one, F1, interpolate);
+  F[2] = _mm256_blendv_pd(zero, F2, interpolate);
+  F[3] = _mm256_blendv_pd(zero, F3, interpolate);
+}
+
+// The points of four consecutive output voxels along one axis.
+VTK_RESLICE_AVX2_TARGET
+static inline __m256d vtkResliceRowPointAVX2(double point, double axis,
+                                             int idX)
+{
+  __m256d x = _mm256_cvtepi32_pd(
+    _mm_add_epi32(_mm_set1_epi32(idX), _mm_setr_epi32(0, 1, 2, 3)));
+  return _mm256_add_pd(_mm256_set1_pd(point),
+                       _mm256_mul_pd(x, _mm256_set1_pd(axis)));
+}
+
+//----------------------------------------------------------------------------
+// Interpolate the n output voxels starting at idX of the row that starts
+// at 'point' and steps by 'xAxis', for one-component input with clamped
+// borders.  The voxels left over from the vector loop are done with the
+// scalar functions.
+template <class T>
+struct vtkImageResliceRowAVX2
+{
+  VTK_RESLICE_AVX2_TARGET static void NearestNeighbor(
+    double *outPtr, const void *inPtr, const int inExt[6],
+    const vtkIdType inInc[3], const double point[4], const double xAxis[4],
+    int idX, int n, int mode);
+
+  VTK_RESLICE_AVX2_TARGET static void Trilinear(
+    double *outPtr, const void *inPtr, const int inExt[6],
+    const vtkIdType inInc[3], const double point[4], const double xAxis[4],
+    int idX, int n, int mode);
+
+  VTK_RESLICE_AVX2_TARGET static void Tricubic(
+    double *outPtr, const void *inPtr, const int inExt[6],
+    const vtkIdType inInc[3], const double point[4], const double xAxis[4],
+    int idX, int n, int mode);
+};
+
+template <class T>
+VTK_RESLICE_AVX2_TARGET
+void vtkImageResliceRowAVX2<T>::NearestNeighbor(
+  double *outPtr, const void *inVoidPtr, const int inExt[6],
+  const vtkIdType inInc[3], const double point[4], const double xAxis[4],
+  int idX, int n, int mode)
+{
+  const T *inPtr = static_cast<const T *>(inVoidPtr);
+  const __m128i incX = _mm_set1_epi32(static_cast<int>(inInc[0]));
+  const __m128i incY = _mm_set1_epi32(static_cast<int>(inInc[1]));
+  const __m128i incZ = _mm_set1_epi32(static_cast<int>(inInc[2]));
+
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+    __m128i inIdX = vtkResliceClampAVX2(vtkResliceRoundAVX2(
+      vtkResliceRowPointAVX2(point[0], xAxis[0], idX + i)), inExt[0], inExt[1]);
+    __m128i inIdY = vtkResliceClampAVX2(vtkResliceRoundAVX2(
+      vtkResliceRowPointAVX2(point[1], xAxis[1], idX + i)), inExt[2], inExt[3]);
+    __m128i inIdZ = vtkResliceClampAVX2(vtkResliceRoundAVX2(
+      vtkResliceRowPointAVX2(point[2], xAxis[2], idX + i)), inExt[4], inExt[5]);
+
+    __m128i offset = _mm_add_epi32(
+      _mm_add_epi32(_mm_mullo_epi32(inIdX, incX), _mm_mullo_epi32(inIdY, incY)),
+      _mm_mullo_epi32(inIdZ, incZ));
+    _mm256_storeu_pd(outPtr + i, vtkResliceGatherAVX2(inPtr, offset));
+    }
+
+  for (; i < n; i++)
+    {
+    double inPoint[3];
+    inPoint[0] = point[0] + (idX + i)*xAxis[0];
+    inPoint[1] = point[1] + (idX + i)*xAxis[1];
+    inPoint[2] = point[2] + (idX + i)*xAxis[2];
+    vtkImageResliceInterpolate<double, T>::NearestNeighbor(
+      outPtr + i, inPtr, inExt, inInc, 1, inPoint, mode);
+    }
+}
+
+template <class T>
+VTK_RESLICE_AVX2_TARGET
+void vtkImageResliceRowAVX2<T>::Trilinear(
+  double *outPtr, const void *inVoidPtr, const int inExt[6],
+  const vtkIdType inInc[3], const double point[4], const double xAxis[4],
+  int idX, int n, int mode)
+{
+  const T *inPtr = static_cast<const T *>(inVoidPtr);
+  const __m128i incX = _mm_set1_epi32(static_cast<int>(inInc[0]));
+  const __m128i incY = _mm_set1_epi32(static_cast<int>(inInc[1]));
+  const __m128i incZ = _mm_set1_epi32(static_cast<int>(inInc[2]));
+  const __m256d one = _mm256_set1_pd(1.0);
+
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+    __m256d fx, fy, fz;
+    __m128i inIdX0 = vtkResliceFloorAVX2(
+      vtkResliceRowPointAVX2(point[0], xAxis[0], idX + i), fx);
+    __m128i inIdY0 = vtkResliceFloorAVX2(
+      vtkResliceRowPointAVX2(point[1], xAxis[1], idX + i), fy);
+    __m128i inIdZ0 = vtkResliceFloorAVX2(
+      vtkResliceRowPointAVX2(point[2], xAxis[2], idX + i), fz);
+
+    __m128i inIdX1 = _mm_add_epi32(inIdX0, vtkResliceNonZeroAVX2(fx));
+    __m128i inIdY1 = _mm_add_epi32(inIdY0, vtkResliceNonZeroAVX2(fy));
+    __m128i inIdZ1 = _mm_add_epi32(inIdZ0, vtkResliceNonZeroAVX2(fz));
+
+    __m128i factX0 = _mm_mullo_epi32(
+      vtkResliceClampAVX2(inIdX0, inExt[0], inExt[1]), incX);
+    __m128i factX1 = _mm_mullo_epi32(
+      vtkResliceClampAVX2(inIdX1, inExt[0], inExt[1]), incX);
+    __m128i factY0 = _mm_mullo_epi32(
+      vtkResliceClampAVX2(inIdY0, inExt[2], inExt[3]), incY);
+    __m128i factY1 = _mm_mullo_epi32(
+      vtkResliceClampAVX2(inIdY1, inExt[2], inExt[3]), incY);
+    __m128i factZ0 = _mm_mullo_epi32(
+      vtkResliceClampAVX2(inIdZ0, inExt[4], inExt[5]), incZ);
+    __m128i factZ1 = _mm_mullo_epi32(
+      vtkResliceClampAVX2(inIdZ1, inExt[4], inExt[5]), incZ);
+
+    __m128i i00 = _mm_add_epi32(factY0, factZ0);
+    __m128i i01 = _mm_add_epi32(factY0, factZ1);
+    __m128i i10 = _mm_add_epi32(factY1, factZ0);
+    __m128i i11 = _mm_add_epi32(factY1, factZ1);
+
+    __m256d rx = _mm256_sub_pd(one, fx);
+    __m256d ry = _mm256_sub_pd(one, fy);
+    __m256d rz = _mm256_sub_pd(one, fz);
+
+    __m256d ryrz = _mm256_mul_pd(ry, rz);
+    __m256d fyrz = _mm256_mul_pd(fy, rz);
+    __m256d ryfz = _mm256_mul_pd(ry, fz);
+    __m256d fyfz = _mm256_mul_pd(fy, fz);
+
+    __m256d v0 = _mm256_mul_pd(ryrz, vtkResliceGatherAVX2(
+      inPtr, _mm_add_epi32(factX0, i00)));
+    v0 = _mm256_add_pd(v0, _mm256_mul_pd(ryfz, vtkResliceGatherAVX2(
+      inPtr, _mm_add_epi32(factX0, i01))));
+    v0 = _mm256_add_pd(v0, _mm256_mul_pd(fyrz, vtkResliceGatherAVX2(
+      inPtr, _mm_add_epi32(factX0, i10))));
+    v0 = _mm256_add_pd(v0, _mm256_mul_pd(fyfz, vtkResliceGatherAVX2(
+      inPtr, _mm_add_epi32(factX0, i11))));
+
+    __m256d v1 = _mm256_mul_pd(ryrz, vtkResliceGatherAVX2(
+      inPtr, _mm_add_epi32(factX1, i00)));
+    v1 = _mm256_add_pd(v1, _mm256_mul_pd(ryfz, vtkResliceGatherAVX2(
+      inPtr, _mm_add_epi32(factX1, i01))));
+    v1 = _mm256_add_pd(v1, _mm256_mul_pd(fyrz, vtkResliceGatherAVX2(
+      inPtr, _mm_add_epi32(factX1, i10))));
+    v1 = _mm256_add_pd(v1, _mm256_mul_pd(fyfz, vtkResliceGatherAVX2(
+      inPtr, _mm_add_epi32(factX1, i11))));
+
+    _mm256_storeu_pd(outPtr + i, _mm256_add_pd(_mm256_mul_pd(rx, v0),
+                                               _mm256_mul_pd(fx, v1)));
+    }
+
+  for (; i < n; i++)
+    {
+    double inPoint[3];
+    inPoint[0] = point[0] + (idX + i)*xAxis[0];
+    inPoint[1] = point[1] + (idX + i)*xAxis[1];
+    inPoint[2] = point[2] + (idX + i)*xAxis[2];
+    vtkImageResliceInterpolate<double, T>::Trilinear(
+      outPtr + i, inPtr, inExt, inInc, 1, inPoint, mode);
+    }
+}
+
+template <class T>
+VTK_RESLICE_AVX2_TARGET
+void vtkImageResliceRowAVX2<T>::Tricubic(
+  double *outPtr, const void *inVoidPtr, const int inExt[6],
+  const vtkIdType inInc[3], const double point[4], const double xAxis[4],
+  int idX, int n, int mode)
+{
+  const T *inPtr = static_cast<const T *>(inVoidPtr);
+  const __m128i incX = _mm_set1_epi32(static_cast<int>(inInc[0]));
+  const __m128i incY = _mm_set1_epi32(static_cast<int>(inInc[1]));
+  const __m128i incZ = _mm_set1_epi32(static_cast<int>(inInc[2]));
+  const __m256d zero = _mm256_setzero_pd();
+
+  // lanes in which an axis is not interpolated have weights 0, 1, 0, 0
+  const __m256d multipleX = _mm256_castsi256_pd(
+    _mm256_set1_epi64x(inExt[0] != inExt[1] ? -1 : 0));
+  const __m256d multipleY = _mm256_castsi256_pd(
+    _mm256_set1_epi64x(inExt[2] != inExt[3] ? -1 : 0));
+  const __m256d multipleZ = _mm256_castsi256_pd(
+    _mm256_set1_epi64x(inExt[4] != inExt[5] ? -1 : 0));
+
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+    __m256d fx, fy, fz;
+    __m128i inIdX0 = vtkResliceFloorAVX2(
+      vtkResliceRowPointAVX2(point[0], xAxis[0], idX + i), fx);
+    __m128i inIdY0 = vtkResliceFloorAVX2(
+      vtkResliceRowPointAVX2(point[1], xAxis[1], idX + i), fy);
+    __m128i inIdZ0 = vtkResliceFloorAVX2(
+      vtkResliceRowPointAVX2(point[2], xAxis[2], idX + i), fz);
+
+    __m128i factX[4], factY[4], factZ[4];
+    for (int l = 0; l < 4; l++)
+      {
+      __m128i d = _mm_set1_epi32(l - 1);
+      factX[l] = _mm_mullo_epi32(vtkResliceClampAVX2(
+        _mm_add_epi32(inIdX0, d), inExt[0], inExt[1]), incX);
+      factY[l] = _mm_mullo_epi32(vtkResliceClampAVX2(
+        _mm_add_epi32(inIdY0, d), inExt[2], inExt[3]), incY);
+      factZ[l] = _mm_mullo_epi32(vtkResliceClampAVX2(
+        _mm_add_epi32(inIdZ0, d), inExt[4], inExt[5]), incZ);
+      }
+
+    __m256d interpX = _mm256_and_pd(
+      multipleX, _mm256_cmp_pd(fx, zero, _CMP_NEQ_OQ));
+    __m256d interpY = _mm256_and_pd(
+      multipleY, _mm256_cmp_pd(fy, zero, _CMP_NEQ_OQ));
+    __m256d interpZ = _mm256_and_pd(
+      multipleZ, _mm256_cmp_pd(fz, zero, _CMP_NEQ_OQ));
+
+    __m256d fX[4], fY[4], fZ[4];
+    vtkResliceTricubicWeightsAVX2(fX, fx, interpX);
+    vtkResliceTricubicWeightsAVX2(fY, fy, interpY);
+    vtkResliceTricubicWeightsAVX2(fZ, fz, interpZ);
+
+    // the rows that no lane interpolates are skipped, and in the other
+    // lanes the terms with zero weight are skipped by the mask
+    int j1 = 1, j2 = 1, k1 = 1, k2 = 1;
+    if (_mm256_movemask_pd(interpY))
+      {
+      j1 = 0;
+      j2 = 3;
+      }
+    if (_mm256_movemask_pd(interpZ))
+      {
+      k1 = 0;
+      k2 = 3;
+      }
+
+    __m256d val = zero;
+    for (int k = k1; k <= k2; k++)
+      {
+      for (int j = j1; j <= j2; j++)
+        {
+        __m256d fzy = _mm256_mul_pd(fZ[k], fY[j]);
+        __m128i factzy = _mm_add_epi32(factZ[k], factY[j]);
+        __m256d tmp = _mm256_mul_pd(fX[0], vtkResliceGatherAVX2(
+          inPtr, _mm_add_epi32(factzy, factX[0])));
+        tmp = _mm256_add_pd(tmp, _mm256_mul_pd(fX[1], vtkResliceGatherAVX2(
+          inPtr, _mm_add_epi32(factzy, factX[1]))));
+        tmp = _mm256_add_pd(tmp, _mm256_mul_pd(fX[2], vtkResliceGatherAVX2(
+          inPtr, _mm_add_epi32(factzy, factX[2]))));
+        tmp = _mm256_add_pd(tmp, _mm256_mul_pd(fX[3], vtkResliceGatherAVX2(
+          inPtr, _mm_add_epi32(factzy, factX[3]))));
+        tmp = _mm256_and_pd(_mm256_mul_pd(fzy, tmp),
+                            _mm256_cmp_pd(fzy, zero, _CMP_NEQ_OQ));
+        val = _mm256_add_pd(val, tmp);
+        }
+      }
+
+    _mm256_storeu_pd(outPtr + i, val);
+    }
+
+  for (; i < n; i++)
+    {
+    double inPoint[3];
+    inPoint[0] = point[0] + (idX + i)*xAxis[0];
+    inPoint[1] = point[1] + (idX + i)*xAxis[1];
+    inPoint[2] = point[2] + (idX + i)*xAxis[2];
+    vtkImageResliceInterpolate<double, T>::Tricubic(
+      outPtr + i, inPtr, inExt, inInc, 1, inPoint, mode);
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Get the row kernel for the input, or null if there is none.  Only the
+// double precision version has row kernels.
+template <class F>
+void vtkGetResliceRowInterpFunc(vtkImageReslice *, vtkImageData *,
+  void (**rowInterpolate)(F *outPtr, const void *inPtr,
+                          const int inExt[6], const vtkIdType inInc[3],
+                          const F point[4], const F xAxis[4],
+                          int idX, int n, int mode))
+{
+  *rowInterpolate = 0;
+}
+
+void vtkGetResliceRowInterpFunc(vtkImageReslice *self, vtkImageData *inData,
+  void (**rowInterpolate)(double *outPtr, const void *inPtr,
+                          const int inExt[6], const vtkIdType inInc[3],
+                          const double point[4], const double xAxis[4],
+                          int idX, int n, int mode))
+{
+  *rowInterpolate = 0;
+#if defined(VTK_RESLICE_USE_AVX2)
+  int inExt[6];
+  inData->GetExtent(inExt);
+  vtkIdType inInc[3];
+  inData->GetIncrements(inInc);
+  if (!vtkResliceHasAVX2 || !vtkImageResliceGlobalVectorization ||
+      self->GetWrap() || self->GetMirror() ||
+      inData->GetNumberOfScalarComponents() != 1 ||
+      inInc[2]*(inExt[5] - inExt[4] + 1) > VTK_INT_MAX)
+    {
+    return;
+    }
+
+  switch (self->GetInterpolationMode())
+    {
+    case VTK_RESLICE_NEAREST:
+      switch (inData->GetScalarType())
+        {
+        case VTK_UNSIGNED_CHAR:
+          *rowInterpolate =
+            &(vtkImageResliceRowAVX2<unsigned char>::NearestNeighbor);
+          break;
+        case VTK_SHORT:
+          *rowInterpolate = &(vtkImageResliceRowAVX2<short>::NearestNeighbor);
+          break;
+        case VTK_FLOAT:
+          *rowInterpolate = &(vtkImageResliceRowAVX2<float>::NearestNeighbor);
+          break;
+        }
+      break;
+    case VTK_RESLICE_LINEAR:
+    case VTK_RESLICE_RESERVED_2:
+      switch (inData->GetScalarType())
+        {
+        case VTK_UNSIGNED_CHAR:
+          *rowInterpolate = &(vtkImageResliceRowAVX2<unsigned char>::Trilinear);
+          break;
+        case VTK_SHORT:
+          *rowInterpolate = &(vtkImageResliceRowAVX2<short>::Trilinear);
+          break;
+        case VTK_FLOAT:
+          *rowInterpolate = &(vtkImageResliceRowAVX2<float>::Trilinear);
+          break;
+        }
+      break;
+    case VTK_RESLICE_CUBIC:
+      switch (inData->GetScalarType())
+        {
+        case VTK_UNSIGNED_CHAR:
+          *rowInterpolate = &(vtkImageResliceRowAVX2<unsigned char>::Tricubic);
+          break;
+        case VTK_SHORT:
+          *rowInterpolate = &(vtkImageResliceRowAVX2<short>::Tricubic);
+          break;
+        case VTK_FLOAT:
+          *rowInterpolate = &(vtkImageResliceRowAVX2<float>::Tricubic);
+          break;
+        }
+      break;
+    }
+#else
+  (void)self;
+  (void)inData;
+#endif
+}
+
 // The vtkOptimizedExecute() is like vtkImageResliceExecute, except that
 // it provides a few optimizations:
 // 1) the ResliceAxes and ResliceTransform are joined to create a
@@ -3035,6 +3542,10 @@ void vtkOptimizedExecute(vtkImageReslice *self,
   void (*interpolate)(F *outPtr, const void *inPtr,
                       const int inExt[6], const vtkIdType inInc[3],
                       int numscalars, const F point[3], int mode);
+  void (*rowInterpolate)(F *outPtr, const void *inPtr,
+                         const int inExt[6], const vtkIdType inInc[3],
+                         const F point[4], const F xAxis[4],
+                         int idX, int n, int mode);
   void (*convertpixels)(void *&out, const F *in, int numscalars, int n);
   void (*setpixels)(void *&out, const void *in, int numscalars, int n);
   void (*composite)(F *in, int numscalars, int n);
@@ -3119,6 +3630,11 @@ void vtkOptimizedExecute(vtkImageReslice *self,
 
   // Set interpolation method
   vtkGetResliceInterpFunc(self, &interpolate);
+  rowInterpolate = 0;
+  if (!(optimizeNearest || newtrans || perspective || nsamples > 1))
+    { // interpolate whole segments of a row at once if possible
+    vtkGetResliceRowInterpFunc(self, inData, &rowInterpolate);
+    }
   vtkGetConversionFunc(self, &convertpixels);
   vtkGetSetPixelsFunc(self, &setpixels);
   vtkGetCompositeFunc(self, &composite);
@@ -3225,8 +3741,11 @@ void vtkOptimizedExecute(vtkImageReslice *self,
                   // do the interpolation
                   sampleCount++;
                   isInBounds = 1;
-                  interpolate(tmpPtr, inPtr, inExt, inInc, inComponents,
-                              inPoint, mode);
+                  if (!rowInterpolate)
+                    {
+                    interpolate(tmpPtr, inPtr, inExt, inInc, inComponents,
+                                inPoint, mode);
+                    }
                   tmpPtr += inComponents;
                   }
                 }
@@ -3245,6 +3764,13 @@ void vtkOptimizedExecute(vtkImageReslice *self,
 
             if (wasInBounds)
               {
+              if (rowInterpolate)
+                {
+                rowInterpolate(tmpPtr - inComponents*(idX - startIdX), inPtr,
+                               inExt, inInc, inPoint1, xAxis, startIdX,
+                               numpixels, mode);
+                }
+
               if (outputStencil)
                 {
                 outputStencil->InsertNextExtent(startIdX, endIdX, idY, idZ);
@@ -3767,6 +4293,278 @@ void vtkImageResliceSummation<F, T>::General(
   outVoidPtr = outPtr;
 }
 
+#if defined(VTK_RESLICE_USE_AVX2)
+//----------------------------------------------------------------------------
+// The summation functions for one-component input with AVX2.  They do
+// the same operations as the scalar ones for four output voxels at a time,
+// and leave the cases without interpolation along x to the scalar ones.
+template <class T>
+struct vtkImageResliceSummationAVX2
+{
+  VTK_RESLICE_AVX2_TARGET static void Trilinear(
+    void *&outPtr, const void *inPtr, int numscalars, int n, int mode,
+    const vtkIdType *iX, const double *fX, const vtkIdType *iY,
+    const double *fY, const vtkIdType *iZ, const double *fZ);
+
+  VTK_RESLICE_AVX2_TARGET static void Tricubic(
+    void *&outPtr, const void *inPtr, int numscalars, int n, int mode,
+    const vtkIdType *iX, const double *fX, const vtkIdType *iY,
+    const double *fY, const vtkIdType *iZ, const double *fZ);
+};
+
+template <class T>
+VTK_RESLICE_AVX2_TARGET
+void vtkImageResliceSummationAVX2<T>::Trilinear(
+  void *&outVoidPtr, const void *inVoidPtr, int numscalars, int n, int mode,
+  const vtkIdType *iX, const double *fX, const vtkIdType *iY,
+  const double *fY, const vtkIdType *iZ, const double *fZ)
+{
+  double fy = fY[1];
+  double fz = fZ[1];
+  if (numscalars != 1 || ((mode & VTK_RESLICE_X_NEAREST) != 0 && fy == 0))
+    {
+    vtkImageResliceSummation<double, T>::Trilinear(
+      outVoidPtr, inVoidPtr, numscalars, n, mode, iX, fX, iY, fY, iZ, fZ);
+    return;
+    }
+
+  const T *inPtr = static_cast<const T *>(inVoidPtr);
+  double *outPtr = static_cast<double *>(outVoidPtr);
+
+  vtkIdType i00 = iY[0] + iZ[0];
+  vtkIdType i01 = iY[0] + iZ[1];
+  vtkIdType i10 = iY[1] + iZ[0];
+  vtkIdType i11 = iY[1] + iZ[1];
+
+  double ry = fY[0];
+  double rz = fZ[0];
+
+  __m256d ryrz = _mm256_set1_pd(ry*rz);
+  __m256d ryfz = _mm256_set1_pd(ry*fz);
+  __m256d fyrz = _mm256_set1_pd(fy*rz);
+  __m256d fyfz = _mm256_set1_pd(fy*fz);
+
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+    // split the interleaved coefficients into rx and fx
+    __m256d c0 = _mm256_loadu_pd(fX);
+    __m256d c1 = _mm256_loadu_pd(fX + 4);
+    __m256d rx = _mm256_permute4x64_pd(_mm256_unpacklo_pd(c0, c1), 0xD8);
+    __m256d fx = _mm256_permute4x64_pd(_mm256_unpackhi_pd(c0, c1), 0xD8);
+    fX += 8;
+
+    const T *inPtr0 = inPtr + i00;
+    const T *inPtr1 = inPtr + i10;
+    __m256d v0, v1;
+    if (fz == 0)
+      { // bilinear interpolation in x,y
+      __m256d ryv = _mm256_set1_pd(ry);
+      __m256d fyv = _mm256_set1_pd(fy);
+      v0 = _mm256_add_pd(
+        _mm256_mul_pd(ryv, vtkResliceGatherAVX2(
+          inPtr0, iX[0], iX[2], iX[4], iX[6])),
+        _mm256_mul_pd(fyv, vtkResliceGatherAVX2(
+          inPtr1, iX[0], iX[2], iX[4], iX[6])));
+      v1 = _mm256_add_pd(
+        _mm256_mul_pd(ryv, vtkResliceGatherAVX2(
+          inPtr0, iX[1], iX[3], iX[5], iX[7])),
+        _mm256_mul_pd(fyv, vtkResliceGatherAVX2(
+          inPtr1, iX[1], iX[3], iX[5], iX[7])));
+      }
+    else
+      { // do full trilinear interpolation
+      const T *inPtr2 = inPtr + i01;
+      const T *inPtr3 = inPtr + i11;
+      v0 = _mm256_mul_pd(ryrz, vtkResliceGatherAVX2(
+        inPtr0, iX[0], iX[2], iX[4], iX[6]));
+      v0 = _mm256_add_pd(v0, _mm256_mul_pd(ryfz, vtkResliceGatherAVX2(
+        inPtr2, iX[0], iX[2], iX[4], iX[6])));
+      v0 = _mm256_add_pd(v0, _mm256_mul_pd(fyrz, vtkResliceGatherAVX2(
+        inPtr1, iX[0], iX[2], iX[4], iX[6])));
+      v0 = _mm256_add_pd(v0, _mm256_mul_pd(fyfz, vtkResliceGatherAVX2(
+        inPtr3, iX[0], iX[2], iX[4], iX[6])));
+      v1 = _mm256_mul_pd(ryrz, vtkResliceGatherAVX2(
+        inPtr0, iX[1], iX[3], iX[5], iX[7]));
+      v1 = _mm256_add_pd(v1, _mm256_mul_pd(ryfz, vtkResliceGatherAVX2(
+        inPtr2, iX[1], iX[3], iX[5], iX[7])));
+      v1 = _mm256_add_pd(v1, _mm256_mul_pd(fyrz, vtkResliceGatherAVX2(
+        inPtr1, iX[1], iX[3], iX[5], iX[7])));
+      v1 = _mm256_add_pd(v1, _mm256_mul_pd(fyfz, vtkResliceGatherAVX2(
+        inPtr3, iX[1], iX[3], iX[5], iX[7])));
+      }
+    iX += 8;
+
+    _mm256_storeu_pd(outPtr, _mm256_add_pd(_mm256_mul_pd(rx, v0),
+                                           _mm256_mul_pd(fx, v1)));
+    outPtr += 4;
+    }
+
+  outVoidPtr = outPtr;
+  if (i < n)
+    {
+    vtkImageResliceSummation<double, T>::Trilinear(
+      outVoidPtr, inVoidPtr, 1, n - i, mode, iX, fX, iY, fY, iZ, fZ);
+    }
+}
+
+template <class T>
+VTK_RESLICE_AVX2_TARGET
+void vtkImageResliceSummationAVX2<T>::Tricubic(
+  void *&outVoidPtr, const void *inVoidPtr, int numscalars, int n, int mode,
+  const vtkIdType *iX, const double *fX, const vtkIdType *iY,
+  const double *fY, const vtkIdType *iZ, const double *fZ)
+{
+  if (numscalars != 1)
+    {
+    vtkImageResliceSummation<double, T>::Tricubic(
+      outVoidPtr, inVoidPtr, numscalars, n, mode, iX, fX, iY, fY, iZ, fZ);
+    return;
+    }
+
+  const T *inPtr = static_cast<const T *>(inVoidPtr);
+  double *outPtr = static_cast<double *>(outVoidPtr);
+
+  // speed things up a bit for bicubic interpolation
+  int k1 = 0;
+  int k2 = 3;
+  if ((mode & VTK_RESLICE_Z_NEAREST) != 0)
+    {
+    k1 = k2 = 1;
+    }
+
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+    // transpose the coefficients of the four voxels
+    __m256d c0 = _mm256_loadu_pd(fX);
+    __m256d c1 = _mm256_loadu_pd(fX + 4);
+    __m256d c2 = _mm256_loadu_pd(fX + 8);
+    __m256d c3 = _mm256_loadu_pd(fX + 12);
+    fX += 16;
+    __m256d t0 = _mm256_unpacklo_pd(c0, c1);
+    __m256d t1 = _mm256_unpackhi_pd(c0, c1);
+    __m256d t2 = _mm256_unpacklo_pd(c2, c3);
+    __m256d t3 = _mm256_unpackhi_pd(c2, c3);
+    __m256d fX0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+    __m256d fX1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+    __m256d fX2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+    __m256d fX3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+
+    __m256d result = _mm256_setzero_pd();
+    int k = k1;
+    do
+      { // loop over z
+      double fz = fZ[k];
+      if (fz != 0)
+        {
+        vtkIdType iz = iZ[k];
+        int j = 0;
+        do
+          { // loop over y
+          double fy = fY[j];
+          double fzy = fz*fy;
+          const T *tmpPtr = inPtr + iz + iY[j];
+          __m256d tmp = _mm256_mul_pd(fX0, vtkResliceGatherAVX2(
+            tmpPtr, iX[0], iX[4], iX[8], iX[12]));
+          tmp = _mm256_add_pd(tmp, _mm256_mul_pd(fX1, vtkResliceGatherAVX2(
+            tmpPtr, iX[1], iX[5], iX[9], iX[13])));
+          tmp = _mm256_add_pd(tmp, _mm256_mul_pd(fX2, vtkResliceGatherAVX2(
+            tmpPtr, iX[2], iX[6], iX[10], iX[14])));
+          tmp = _mm256_add_pd(tmp, _mm256_mul_pd(fX3, vtkResliceGatherAVX2(
+            tmpPtr, iX[3], iX[7], iX[11], iX[15])));
+          result = _mm256_add_pd(result,
+                                 _mm256_mul_pd(_mm256_set1_pd(fzy), tmp));
+          }
+        while (++j <= 3);
+        }
+      }
+    while (++k <= k2);
+    iX += 16;
+
+    _mm256_storeu_pd(outPtr, result);
+    outPtr += 4;
+    }
+
+  outVoidPtr = outPtr;
+  if (i < n)
+    {
+    vtkImageResliceSummation<double, T>::Tricubic(
+      outVoidPtr, inVoidPtr, 1, n - i, mode, iX, fX, iY, fY, iZ, fZ);
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Replace the summation function with one that uses AVX2 if possible.
+// Only the double precision version has them.
+template <class F>
+void vtkGetResliceSummationFuncAVX2(vtkImageReslice *,
+  void (**)(void *&out, const void *in,
+            int numscalars, int n, int mode,
+            const vtkIdType *iX, const F *fX,
+            const vtkIdType *iY, const F *fY,
+            const vtkIdType *iZ, const F *fZ),
+  int, int)
+{
+}
+
+void vtkGetResliceSummationFuncAVX2(vtkImageReslice *self,
+  void (**summation)(void *&out, const void *in,
+                     int numscalars, int n, int mode,
+                     const vtkIdType *iX, const double *fX,
+                     const vtkIdType *iY, const double *fY,
+                     const vtkIdType *iZ, const double *fZ),
+  int interpolationMode, int doConversion)
+{
+#if defined(VTK_RESLICE_USE_AVX2)
+  vtkImageData *input = static_cast<vtkImageData *>(self->GetInput());
+  if (!vtkResliceHasAVX2 || !vtkImageResliceGlobalVectorization ||
+      !doConversion || input->GetNumberOfScalarComponents() != 1)
+    {
+    return;
+    }
+
+  switch (interpolationMode)
+    {
+    case VTK_RESLICE_LINEAR:
+    case VTK_RESLICE_RESERVED_2:
+      switch (input->GetScalarType())
+        {
+        case VTK_UNSIGNED_CHAR:
+          *summation = &(vtkImageResliceSummationAVX2<unsigned char>::Trilinear);
+          break;
+        case VTK_SHORT:
+          *summation = &(vtkImageResliceSummationAVX2<short>::Trilinear);
+          break;
+        case VTK_FLOAT:
+          *summation = &(vtkImageResliceSummationAVX2<float>::Trilinear);
+          break;
+        }
+      break;
+    case VTK_RESLICE_CUBIC:
+      switch (input->GetScalarType())
+        {
+        case VTK_UNSIGNED_CHAR:
+          *summation = &(vtkImageResliceSummationAVX2<unsigned char>::Tricubic);
+          break;
+        case VTK_SHORT:
+          *summation = &(vtkImageResliceSummationAVX2<short>::Tricubic);
+          break;
+        case VTK_FLOAT:
+          *summation = &(vtkImageResliceSummationAVX2<float>::Tricubic);
+          break;
+        }
+      break;
+    }
+#else
+  (void)self;
+  (void)summation;
+  (void)interpolationMode;
+  (void)doConversion;
+#endif
+}
+
 //----------------------------------------------------------------------------
 // get appropriate summation function for different interpolation modes
 // and different scalar types
@@ -3874,6 +4672,9 @@ void vtkGetResliceSummationFunc(vtkImageReslice *self,
         }
       break;
     }
+
+  vtkGetResliceSummationFuncAVX2(self, summation, interpolationMode,
+                                 doConversion);
 }
 
 //----------------------------------------------------------------------------
@@ -260,6 +260,16 @@ public:
   vtkGetMacro(Optimization, int);
   vtkBooleanMacro(Optimization, int);
 
+  // Description:
+  // Turn on and off the vectorized interpolation of whole rows for all
+  // reslice filters (default on).  It is used for one-component unsigned
+  // char, short and float input with nearest, linear and cubic
+  // interpolation when the processor supports AVX2, and it gives exactly
+  // the same output as the scalar code, so it should only be turned off
+  // for testing and benchmarks.
+  static void SetGlobalVectorization(int val);
+  static int GetGlobalVectorization();
+
   // Description:
   // Set the background color (for multi-component images).
   vtkSetVector4Macro(BackgroundColor, double);
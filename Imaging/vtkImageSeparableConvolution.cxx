@@ -85,6 +85,31 @@ void ExecuteConvolve (float* kernel, int kernelSize, float* image, float* outIma
     }
 }
 
+// A kernel whose values are all the same is a box: keep a running sum of
+// the pixels under it, so that the cost does not depend on its size.
+static void vtkImageSeparableConvolutionBox(float value, int kernelSize,
+                                            float* image, float* outImage,
+                                            int imageSize)
+{
+  int center = (kernelSize - 1) / 2;
+  int i, j;
+  double sum = 0.0;
+
+  // the edge pixels are repeated past the ends, as for the other kernels
+  for ( j = -center; j <= center; ++j )
+    {
+    sum += image[j < 0 ? 0 : (j < imageSize ? j : imageSize - 1)];
+    }
+  for ( i = 0; i < imageSize; ++i )
+    {
+    outImage[i] = static_cast<float>(value * sum);
+    j = i + center + 1;
+    sum += image[j < imageSize ? j : imageSize - 1];
+    j = i - center;
+    sum -= image[j > 0 ? j : 0];
+    }
+}
+
 // Description:
 // Overload standard modified time function. If kernel arrays are modified,
 // then this object is modified as well.
@@ -233,6 +258,7 @@ void vtkImageSeparableConvolutionExecute ( vtkImageSeparableConvolution* self,
     }
   int kernelSize = 0;
   float* kernel = NULL;
+  int box = 0;
 
   if ( KernelArray )
     {
@@ -240,10 +266,14 @@ void vtkImageSeparableConvolutionExecute ( vtkImageSeparableConvolution* self,
     kernelSize = KernelArray->GetNumberOfTuples();
     kernel = new float[kernelSize];
     // Copy the kernel
+    box = 1;
     for ( i = 0; i < kernelSize; i++ )
       {
       kernel[i] = KernelArray->GetValue ( i );
+      box = box && ( kernel[i] == kernel[0] );
       }
+    // A running sum only pays off past a few values
+    box = box && ( kernelSize > 3 );
     }
 
   int imageSize = inMax0 + 1;
@@ -276,7 +306,13 @@ void vtkImageSeparableConvolutionExecute ( vtkImageSeparableConvolution* self,
         }
 
       // Call the method that performs the convolution
-      if ( kernel )
+      if ( box )
+        {
+        vtkImageSeparableConvolutionBox ( kernel[0], kernelSize, image,
+                                          outImage, imageSize );
+        imagePtr = outImage;
+        }
+      else if ( kernel )
         {
         ExecuteConvolve ( kernel, kernelSize, image, outImage, imageSize );
         imagePtr = outImage;
@@ -21,7 +21,9 @@
 // that dimension is skipped.  This filter is designed to efficiently
 // convolve separable filters that can be decomposed into 1 or more 1D
 // convolutions.  It also handles arbitrarly large kernel sizes, and
-// uses edge replication to handle boundaries.
+// uses edge replication to handle boundaries.  A kernel whose values are
+// all equal (a box) is applied with a running sum, so its cost does not
+// depend on its size.
 
 #ifndef __vtkImageSeparableConvolution_h
 #define __vtkImageSeparableConvolution_h
@@ -0,0 +1,376 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThreadedController.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkThreadedController
+// .SECTION Description
+// Runs four processes as threads and checks the messages between them,
+// that data objects are handed over without copying their arrays, the
+// collective operations and the controller of every thread.
+// ExerciseMultiProcessController cannot be used here because it expects
+// every process to have its own vtkMath random sequence.
+
+#include "vtkCommunicator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkThreadedController.h"
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static const int NumberOfProcesses = 4;
+static const int Length = 10;
+
+// The points of the sphere process 0 sends.  The processes share the
+// memory, so the others can check that they received this very array.
+static vtkDataArray *SentPoints = 0;
+
+// B = A, so a reduction gives the values of process 0.
+class KeepFirstOperation : public vtkCommunicator::Operation
+{
+public:
+  void Function(const void *A, void *B, vtkIdType length, int)
+    {
+    const int *a = reinterpret_cast<const int*>(A);
+    int *b = reinterpret_cast<int*>(B);
+    for (vtkIdType i = 0; i < length; i++)
+      {
+      b[i] = a[i];
+      }
+    }
+  int Commutative() { return 0; }
+};
+
+//----------------------------------------------------------------------------
+static int ExercisePointToPoint(vtkMultiProcessController *controller)
+{
+  int rank = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+  int next = (rank + 1) % numProcs;
+  int previous = (rank + numProcs - 1) % numProcs;
+  int ok = 1;
+
+  // Sends do not block, so every process can send around the ring first.
+  int values[Length];
+  int received[Length];
+  for (int i = 0; i < Length; i++)
+    {
+    values[i] = 100*rank + i;
+    }
+  controller->Send(values, Length, next, 100);
+  if (!controller->Receive(received, Length, previous, 100) ||
+      controller->GetCount() != Length)
+    {
+    cerr << "Process " << rank << " did not receive the ring message" << endl;
+    ok = 0;
+    }
+  for (int i = 0; ok && i < Length; i++)
+    {
+    if (received[i] != 100*previous + i)
+      {
+      cerr << "Process " << rank << " received a corrupt ring message" << endl;
+      ok = 0;
+      }
+    }
+
+  if (rank == 0)
+    {
+    int sum = 0;
+    for (int i = 1; i < numProcs; i++)
+      {
+      int value = 0;
+      controller->Receive(&value, 1,
+                          vtkMultiProcessController::ANY_SOURCE, 101);
+      sum += value;
+      }
+    if (sum != numProcs*(numProcs - 1)/2)
+      {
+      cerr << "Receiving from ANY_SOURCE gave " << sum << endl;
+      ok = 0;
+      }
+    }
+  else
+    {
+    controller->Send(&rank, 1, 0, 101);
+    }
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+static int ExerciseDataObject(vtkMultiProcessController *controller)
+{
+  int rank = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+  int ok = 1;
+
+  if (rank == 0)
+    {
+    VTK_CREATE(vtkSphereSource, sphere);
+    sphere->Update();
+    vtkPolyData *output = sphere->GetOutput();
+    SentPoints = output->GetPoints()->GetData();
+    for (int i = 1; i < numProcs; i++)
+      {
+      controller->Send(output, i, 200);
+      controller->Send(output, i, 201);
+      }
+    // The receivers hold their own references to the points.
+    controller->Barrier();
+    }
+  else
+    {
+    VTK_CREATE(vtkPolyData, received);
+    controller->Receive(received, 0, 200);
+    vtkDataObject *object = controller->ReceiveDataObject(0, 201);
+    vtkPolyData *polyData = vtkPolyData::SafeDownCast(object);
+    if (!received->GetPoints() ||
+        received->GetPoints()->GetData() != SentPoints ||
+        received->GetNumberOfCells() != 96 ||
+        !polyData || !polyData->GetPoints() ||
+        polyData->GetPoints()->GetData() != SentPoints)
+      {
+      cerr << "Process " << rank << " did not receive the points of the "
+           << "sphere" << endl;
+      ok = 0;
+      }
+    if (object)
+      {
+      object->Delete();
+      }
+    controller->Barrier();
+    }
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+static int ExerciseCollectives(vtkMultiProcessController *controller)
+{
+  int rank = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+  int ok = 1;
+  int i;
+
+  int data[Length];
+  for (i = 0; i < Length; i++)
+    {
+    data[i] = (rank == numProcs - 1 ? i : -1);
+    }
+  controller->Broadcast(data, Length, numProcs - 1);
+  for (i = 0; i < Length; i++)
+    {
+    ok = ok && (data[i] == i);
+    }
+  if (!ok)
+    {
+    cerr << "Process " << rank << ": wrong Broadcast" << endl;
+    }
+
+  int send[2] = { rank, rank*rank };
+  int gathered[2*NumberOfProcesses];
+  controller->Gather(send, gathered, 2, 1);
+  for (i = 0; rank == 1 && i < numProcs; i++)
+    {
+    if (gathered[2*i] != i || gathered[2*i + 1] != i*i)
+      {
+      cerr << "Process " << rank << ": wrong Gather" << endl;
+      ok = 0;
+      break;
+      }
+    }
+  controller->AllGather(send, gathered, 2);
+  for (i = 0; i < numProcs; i++)
+    {
+    if (gathered[2*i] != i || gathered[2*i + 1] != i*i)
+      {
+      cerr << "Process " << rank << ": wrong AllGather" << endl;
+      ok = 0;
+      break;
+      }
+    }
+
+  // Process i sends i + 1 values.
+  vtkIdType lengths[NumberOfProcesses];
+  vtkIdType offsets[NumberOfProcesses];
+  int sendV[NumberOfProcesses];
+  int gatheredV[NumberOfProcesses*(NumberOfProcesses + 1)/2];
+  for (i = 0; i < numProcs; i++)
+    {
+    lengths[i] = i + 1;
+    offsets[i] = i*(i + 1)/2;
+    sendV[i] = rank;
+    }
+  controller->AllGatherV(sendV, gatheredV, rank + 1, lengths, offsets);
+  for (i = 0; i < numProcs; i++)
+    {
+    for (int j = 0; j <= i; j++)
+      {
+      if (gatheredV[offsets[i] + j] != i)
+        {
+        cerr << "Process " << rank << ": wrong AllGatherV" << endl;
+        ok = 0;
+        i = numProcs;
+        break;
+        }
+      }
+    }
+
+  int scatterSend[2*NumberOfProcesses];
+  int scattered[2];
+  for (i = 0; i < 2*numProcs; i++)
+    {
+    scatterSend[i] = (rank == 0 ? i : -1);
+    }
+  controller->Scatter(scatterSend, scattered, 2, 0);
+  if (scattered[0] != 2*rank || scattered[1] != 2*rank + 1)
+    {
+    cerr << "Process " << rank << ": wrong Scatter" << endl;
+    ok = 0;
+    }
+
+  // Sums of rank + i.
+  int values[Length];
+  int sums[Length];
+  for (i = 0; i < Length; i++)
+    {
+    values[i] = rank + i;
+    }
+  controller->Reduce(values, sums, Length, vtkCommunicator::SUM_OP, 2);
+  for (i = 0; rank == 2 && i < Length; i++)
+    {
+    if (sums[i] != numProcs*i + numProcs*(numProcs - 1)/2)
+      {
+      cerr << "Process " << rank << ": wrong Reduce" << endl;
+      ok = 0;
+      break;
+      }
+    }
+  controller->AllReduce(values, sums, Length, vtkCommunicator::SUM_OP);
+  for (i = 0; i < Length; i++)
+    {
+    if (sums[i] != numProcs*i + numProcs*(numProcs - 1)/2)
+      {
+      cerr << "Process " << rank << ": wrong AllReduce" << endl;
+      ok = 0;
+      break;
+      }
+    }
+
+  double value = rank + 0.5;
+  double maximum = 0.0;
+  controller->AllReduce(&value, &maximum, 1, vtkCommunicator::MAX_OP);
+  if (maximum != numProcs - 0.5)
+    {
+    cerr << "Process " << rank << ": wrong AllReduce of the maximum" << endl;
+    ok = 0;
+    }
+
+  KeepFirstOperation keepFirst;
+  controller->AllReduce(values, sums, Length, &keepFirst);
+  for (i = 0; i < Length; i++)
+    {
+    if (sums[i] != i)
+      {
+      cerr << "Process " << rank << ": wrong AllReduce with an operation"
+           << endl;
+      ok = 0;
+      break;
+      }
+    }
+
+  controller->Barrier();
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+static void Run(vtkMultiProcessController *controller, void *arg)
+{
+  int *success = reinterpret_cast<int*>(arg);
+  int rank = controller->GetLocalProcessId();
+
+  int ok = 1;
+  if (controller->GetNumberOfProcesses() != NumberOfProcesses ||
+      vtkMultiProcessController::GetGlobalController() != controller)
+    {
+    cerr << "Process " << rank << " has the wrong controller" << endl;
+    ok = 0;
+    }
+  ok = ExercisePointToPoint(controller) && ok;
+  ok = ExerciseDataObject(controller) && ok;
+  ok = ExerciseCollectives(controller) && ok;
+  success[rank] = ok;
+}
+
+//----------------------------------------------------------------------------
+static void RunProcess(vtkMultiProcessController *controller, void *arg)
+{
+  *reinterpret_cast<int*>(arg) = controller->GetLocalProcessId() + 1;
+}
+
+//----------------------------------------------------------------------------
+int TestThreadedController(int argc, char* argv[])
+{
+  VTK_CREATE(vtkThreadedController, controller);
+  controller->Initialize(&argc, &argv);
+  controller->SetNumberOfProcesses(NumberOfProcesses);
+
+  // The information keys are created when they are first used and their
+  // registration is not thread safe, so let the main thread create those
+  // of the sphere before the processes do.
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->Update();
+
+  int retVal = 0;
+  int success[NumberOfProcesses];
+  int i;
+  for (i = 0; i < NumberOfProcesses; i++)
+    {
+    success[i] = 0;
+    }
+  controller->SetSingleMethod(Run, success);
+  controller->SingleMethodExecute();
+  for (i = 0; i < NumberOfProcesses; i++)
+    {
+    if (!success[i])
+      {
+      cerr << "Process " << i << " failed" << endl;
+      retVal = 1;
+      }
+    }
+
+  for (i = 0; i < NumberOfProcesses; i++)
+    {
+    success[i] = 0;
+    controller->SetMultipleMethod(i, RunProcess, success + i);
+    }
+  controller->MultipleMethodExecute();
+  for (i = 0; i < NumberOfProcesses; i++)
+    {
+    if (success[i] != i + 1)
+      {
+      cerr << "Multiple method " << i << " was not run by process " << i
+           << endl;
+      retVal = 1;
+      }
+    }
+
+  if (controller->GetLocalProcessId() != 0)
+    {
+    cerr << "The controller is not process 0 after the execution" << endl;
+    retVal = 1;
+    }
+
+  controller->Finalize();
+  return retVal;
+}
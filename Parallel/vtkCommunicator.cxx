@@ -1382,16 +1382,12 @@ int vtkCommunicator::AllGatherV(vtkDataArray *sendBuffer,
 }
 
 //-----------------------------------------------------------------------------
-int vtkCommunicator::ReduceVoidArray(const void *sendBuffer,
-                                     void *recvBuffer,
-                                     vtkIdType length, int type,
-                                     int operation, int destProcessId)
+vtkCommunicator::Operation *vtkCommunicator::NewStandardOperation(
+                                                                 int operation)
 {
 #define OP_CASE(id, opclass) \
-  case id: opClass = new vtkCommunicator##opclass##Class; break;
+  case id: return new vtkCommunicator##opclass##Class;
 
-  vtkCommunicator::Operation *opClass = 0;
-  
   switch (operation)
     {
     OP_CASE(MAX_OP, Max);
@@ -1404,21 +1400,31 @@ int vtkCommunicator::ReduceVoidArray(const void *sendBuffer,
     OP_CASE(BITWISE_OR_OP, BitwiseOr);
     OP_CASE(LOGICAL_XOR_OP, LogicalXor);
     OP_CASE(BITWISE_XOR_OP, BitwiseXor);
-    default:
-      vtkWarningMacro(<< "Operation number " << operation << " not supported.");
-      return 0;
     }
+  return 0;
 
-  int retVal = this->ReduceVoidArray(sendBuffer, recvBuffer, length, type,
-                                     opClass, destProcessId);
-  if (opClass)
+#undef OP_CASE
+}
+
+//-----------------------------------------------------------------------------
+int vtkCommunicator::ReduceVoidArray(const void *sendBuffer,
+                                     void *recvBuffer,
+                                     vtkIdType length, int type,
+                                     int operation, int destProcessId)
+{
+  vtkCommunicator::Operation *opClass =
+    vtkCommunicator::NewStandardOperation(operation);
+  if (!opClass)
     {
-    delete opClass;
+    vtkWarningMacro(<< "Operation number " << operation << " not supported.");
+    return 0;
     }
 
-  return retVal;
+  int retVal = this->ReduceVoidArray(sendBuffer, recvBuffer, length, type,
+                                     opClass, destProcessId);
+  delete opClass;
 
-#undef OP_CASE
+  return retVal;
 }
 
 //-----------------------------------------------------------------------------
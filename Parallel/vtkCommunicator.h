@@ -844,18 +844,27 @@ protected:
   ~vtkCommunicator();
 
   // Internal methods called by Send/Receive(vtkDataObject *... ) above.
-  int SendElementalDataObject(vtkDataObject* data, int remoteHandle, int tag);
+  // The elemental methods marshal the data object; communicators whose
+  // processes share memory may pass the object itself instead.
+  virtual int SendElementalDataObject(vtkDataObject* data, int remoteHandle,
+                                      int tag);
   int SendMultiBlockDataSet(vtkMultiBlockDataSet* data, int remoteHandle, int tag);
   int SendTemporalDataSet(vtkTemporalDataSet* data, int remoteHandle, int tag);
   int ReceiveDataObject(vtkDataObject* data,
                         int remoteHandle, int tag, int type=-1);
-  int ReceiveElementalDataObject(vtkDataObject* data,
-                                 int remoteHandle, int tag);
+  virtual int ReceiveElementalDataObject(vtkDataObject* data,
+                                         int remoteHandle, int tag);
   int ReceiveMultiBlockDataSet(
     vtkMultiBlockDataSet* data, int remoteHandle, int tag);
   int ReceiveTemporalDataSet(
     vtkTemporalDataSet* data, int remoteHandle, int tag);
 
+//BTX
+  // Create the Operation of one of the StandardOperations, NULL if the
+  // operation is not supported.  The caller deletes it.
+  static Operation *NewStandardOperation(int operation);
+//ETX
+
   int MaximumNumberOfProcesses;
   int NumberOfProcesses;
 
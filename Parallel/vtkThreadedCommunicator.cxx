@@ -0,0 +1,677 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadedCommunicator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkThreadedCommunicator.h"
+
+#include "vtkAbstractArray.h"
+#include "vtkConditionVariable.h"
+#include "vtkDataObject.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/list>
+#include <vtkstd/vector>
+
+#include <string.h>
+
+//----------------------------------------------------------------------------
+// The state shared by the communicators of all the processes: a mailbox per
+// process, the buffers published for the current collective operation and
+// a barrier.  It is deleted with the last communicator using it.
+class vtkThreadedCommunicatorShared
+{
+public:
+  struct Message
+  {
+    int Source;
+    int Tag;
+    vtkIdType Size;          // in bytes
+    char *Data;              // new[], owned by the message
+    vtkDataObject *Object;   // owned by the message, 0 for arrays
+  };
+
+  struct Mailbox
+  {
+    vtkSimpleMutexLock Lock;
+    vtkSimpleConditionVariable Arrived;
+    vtkstd::list<Message> Messages;
+  };
+
+  struct Buffers
+  {
+    const void *SendBuffer;
+    void *RecvBuffer;
+    vtkIdType *Lengths;
+    vtkIdType *Offsets;
+  };
+
+  vtkThreadedCommunicatorShared(int numberOfProcesses)
+    : NumberOfProcesses(numberOfProcesses),
+      Mailboxes(numberOfProcesses),
+      Published(numberOfProcesses),
+      NumberWaiting(0),
+      Generation(0),
+      ReferenceCount(0)
+    {
+    for (int i = 0; i < numberOfProcesses; ++i)
+      {
+      this->Mailboxes[i] = new Mailbox;
+      }
+    }
+
+  ~vtkThreadedCommunicatorShared()
+    {
+    for (int i = 0; i < this->NumberOfProcesses; ++i)
+      {
+      vtkstd::list<Message>::iterator it;
+      for (it = this->Mailboxes[i]->Messages.begin();
+           it != this->Mailboxes[i]->Messages.end(); ++it)
+        {
+        delete [] it->Data;
+        if (it->Object)
+          {
+          it->Object->Delete();
+          }
+        }
+      delete this->Mailboxes[i];
+      }
+    }
+
+  void Register()
+    {
+    this->ReferenceLock.Lock();
+    ++this->ReferenceCount;
+    this->ReferenceLock.Unlock();
+    }
+
+  void UnRegister()
+    {
+    this->ReferenceLock.Lock();
+    int count = --this->ReferenceCount;
+    this->ReferenceLock.Unlock();
+    if (count == 0)
+      {
+      delete this;
+      }
+    }
+
+  // Append a message to the mailbox of destination.
+  void Post(int destination, const Message &message)
+    {
+    Mailbox *box = this->Mailboxes[destination];
+    box->Lock.Lock();
+    box->Messages.push_back(message);
+    box->Lock.Unlock();
+    // Only the owner of a mailbox waits on it.
+    box->Arrived.Signal();
+    }
+
+  // Remove the first message from source (or any source) with the tag from
+  // the mailbox of destination, waiting until there is one.
+  Message Take(int destination, int source, int tag)
+    {
+    Mailbox *box = this->Mailboxes[destination];
+    box->Lock.Lock();
+    for (;;)
+      {
+      vtkstd::list<Message>::iterator it;
+      for (it = box->Messages.begin(); it != box->Messages.end(); ++it)
+        {
+        if (it->Tag == tag &&
+            (source == vtkMultiProcessController::ANY_SOURCE ||
+             it->Source == source))
+          {
+          Message message = *it;
+          box->Messages.erase(it);
+          box->Lock.Unlock();
+          return message;
+          }
+        }
+      box->Arrived.Wait(box->Lock);
+      }
+    }
+
+  void Publish(int id, const void *sendBuffer, void *recvBuffer,
+               vtkIdType *lengths = 0, vtkIdType *offsets = 0)
+    {
+    Buffers &buffers = this->Published[id];
+    buffers.SendBuffer = sendBuffer;
+    buffers.RecvBuffer = recvBuffer;
+    buffers.Lengths = lengths;
+    buffers.Offsets = offsets;
+    }
+
+  // Wait until all processes reach the barrier.  What a process published
+  // before the barrier is visible to all of them after it.
+  void Barrier()
+    {
+    this->BarrierLock.Lock();
+    int generation = this->Generation;
+    if (++this->NumberWaiting == this->NumberOfProcesses)
+      {
+      this->NumberWaiting = 0;
+      ++this->Generation;
+      this->BarrierLock.Unlock();
+      this->BarrierReached.Broadcast();
+      return;
+      }
+    while (generation == this->Generation)
+      {
+      this->BarrierReached.Wait(this->BarrierLock);
+      }
+    this->BarrierLock.Unlock();
+    }
+
+  const char *GetSendBuffer(int id, vtkIdType offset)
+    {
+    return static_cast<const char*>(this->Published[id].SendBuffer) + offset;
+    }
+
+  int NumberOfProcesses;
+  vtkstd::vector<Mailbox*> Mailboxes;
+  vtkstd::vector<Buffers> Published;
+
+  vtkSimpleMutexLock BarrierLock;
+  vtkSimpleConditionVariable BarrierReached;
+  int NumberWaiting;
+  int Generation;
+
+  vtkSimpleMutexLock ReferenceLock;
+  int ReferenceCount;
+};
+
+typedef vtkThreadedCommunicatorShared::Message vtkThreadedCommunicatorMessage;
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkThreadedCommunicator);
+
+//----------------------------------------------------------------------------
+vtkThreadedCommunicator::vtkThreadedCommunicator()
+{
+  this->MaximumNumberOfProcesses = VTK_MAX_THREADS;
+  this->Shared = 0;
+
+  // Until the controller connects it, the communicator is a single process
+  // that can send to itself.
+  vtkThreadedCommunicator *self = this;
+  vtkThreadedCommunicator::Connect(&self, 1);
+}
+
+//----------------------------------------------------------------------------
+vtkThreadedCommunicator::~vtkThreadedCommunicator()
+{
+  this->Shared->UnRegister();
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedCommunicator::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedCommunicator::Connect(vtkThreadedCommunicator **communicators,
+                                      int numberOfProcesses)
+{
+  vtkThreadedCommunicatorShared *shared =
+    new vtkThreadedCommunicatorShared(numberOfProcesses);
+  for (int i = 0; i < numberOfProcesses; ++i)
+    {
+    vtkThreadedCommunicator *communicator = communicators[i];
+    shared->Register();
+    if (communicator->Shared)
+      {
+      communicator->Shared->UnRegister();
+      }
+    communicator->Shared = shared;
+    communicator->NumberOfProcesses = numberOfProcesses;
+    communicator->LocalProcessId = i;
+    communicator->Count = 0;
+    communicator->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::CheckProcessId(int id)
+{
+  if (id < 0 || id >= this->Shared->NumberOfProcesses)
+    {
+    vtkErrorMacro(<< "Invalid process id " << id << ", there are "
+                  << this->Shared->NumberOfProcesses << " processes.");
+    return 0;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::SendVoidArray(const void *data, vtkIdType length,
+                                           int type, int remoteHandle,
+                                           int tag)
+{
+  if (!this->CheckProcessId(remoteHandle))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorMessage message;
+  message.Source = this->LocalProcessId;
+  message.Tag = tag;
+  message.Size = length*vtkAbstractArray::GetDataTypeSize(type);
+  message.Data = 0;
+  message.Object = 0;
+  if (message.Size > 0)
+    {
+    message.Data = new char[message.Size];
+    memcpy(message.Data, data, message.Size);
+    }
+  this->Shared->Post(remoteHandle, message);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::ReceiveVoidArray(void *data, vtkIdType maxlength,
+                                              int type, int remoteHandle,
+                                              int tag)
+{
+  this->Count = 0;
+  if (remoteHandle != vtkMultiProcessController::ANY_SOURCE &&
+      !this->CheckProcessId(remoteHandle))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorMessage message =
+    this->Shared->Take(this->LocalProcessId, remoteHandle, tag);
+  if (message.Object)
+    {
+    vtkErrorMacro(<< "Received a data object from process " << message.Source
+                  << " instead of an array.");
+    message.Object->Delete();
+    return 0;
+    }
+
+  int result = 1;
+  int size = vtkAbstractArray::GetDataTypeSize(type);
+  vtkIdType length = (size > 0 ? message.Size/size : 0);
+  if (length > maxlength)
+    {
+    vtkErrorMacro(<< "Received " << length << " values from process "
+                  << message.Source << " in a buffer of " << maxlength
+                  << ".");
+    result = 0;
+    }
+  else
+    {
+    if (message.Size > 0)
+      {
+      memcpy(data, message.Data, message.Size);
+      }
+    this->Count = length;
+    }
+  delete [] message.Data;
+  return result;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::SendElementalDataObject(vtkDataObject* data,
+                                                     int remoteHandle,
+                                                     int tag)
+{
+  if (!this->CheckProcessId(remoteHandle))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorMessage message;
+  message.Source = this->LocalProcessId;
+  message.Tag = tag;
+  message.Size = 0;
+  message.Data = 0;
+  message.Object = data->NewInstance();
+  message.Object->ShallowCopy(data);
+  this->Shared->Post(remoteHandle, message);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::ReceiveElementalDataObject(vtkDataObject* data,
+                                                        int remoteHandle,
+                                                        int tag)
+{
+  if (remoteHandle != vtkMultiProcessController::ANY_SOURCE &&
+      !this->CheckProcessId(remoteHandle))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorMessage message =
+    this->Shared->Take(this->LocalProcessId, remoteHandle, tag);
+  if (!message.Object)
+    {
+    vtkErrorMacro(<< "Received an array from process " << message.Source
+                  << " instead of a data object.");
+    delete [] message.Data;
+    return 0;
+    }
+  data->ShallowCopy(message.Object);
+  message.Object->Delete();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Every collective operation publishes the buffers of the process and
+// waits on a barrier before reading the buffers of the others, and waits
+// on a barrier again before returning, so that no buffer is released or
+// republished while another process reads it.
+
+//----------------------------------------------------------------------------
+void vtkThreadedCommunicator::Barrier()
+{
+  this->Shared->Barrier();
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::BroadcastVoidArray(void *data, vtkIdType length,
+                                                int type, int srcProcessId)
+{
+  if (!this->CheckProcessId(srcProcessId))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  shared->Publish(this->LocalProcessId, data, data);
+  shared->Barrier();
+  if (this->LocalProcessId != srcProcessId && length > 0)
+    {
+    memcpy(data, shared->GetSendBuffer(srcProcessId, 0),
+           length*vtkAbstractArray::GetDataTypeSize(type));
+    }
+  shared->Barrier();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::GatherVoidArray(const void *sendBuffer,
+                                             void *recvBuffer,
+                                             vtkIdType length, int type,
+                                             int destProcessId)
+{
+  if (!this->CheckProcessId(destProcessId))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  shared->Publish(this->LocalProcessId, sendBuffer, recvBuffer);
+  shared->Barrier();
+  if (this->LocalProcessId == destProcessId && length > 0)
+    {
+    vtkIdType size = length*vtkAbstractArray::GetDataTypeSize(type);
+    for (int i = 0; i < shared->NumberOfProcesses; ++i)
+      {
+      memcpy(static_cast<char*>(recvBuffer) + i*size,
+             shared->GetSendBuffer(i, 0), size);
+      }
+    }
+  shared->Barrier();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::GatherVVoidArray(const void *sendBuffer,
+                                              void *recvBuffer,
+                                              vtkIdType vtkNotUsed(sendLength),
+                                              vtkIdType *recvLengths,
+                                              vtkIdType *offsets, int type,
+                                              int destProcessId)
+{
+  if (!this->CheckProcessId(destProcessId))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  shared->Publish(this->LocalProcessId, sendBuffer, recvBuffer);
+  shared->Barrier();
+  if (this->LocalProcessId == destProcessId)
+    {
+    int size = vtkAbstractArray::GetDataTypeSize(type);
+    for (int i = 0; i < shared->NumberOfProcesses; ++i)
+      {
+      if (recvLengths[i] > 0)
+        {
+        memcpy(static_cast<char*>(recvBuffer) + offsets[i]*size,
+               shared->GetSendBuffer(i, 0), recvLengths[i]*size);
+        }
+      }
+    }
+  shared->Barrier();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::ScatterVoidArray(const void *sendBuffer,
+                                              void *recvBuffer,
+                                              vtkIdType length, int type,
+                                              int srcProcessId)
+{
+  if (!this->CheckProcessId(srcProcessId))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  shared->Publish(this->LocalProcessId, sendBuffer, recvBuffer);
+  shared->Barrier();
+  if (length > 0)
+    {
+    vtkIdType size = length*vtkAbstractArray::GetDataTypeSize(type);
+    memcpy(recvBuffer,
+           shared->GetSendBuffer(srcProcessId, this->LocalProcessId*size),
+           size);
+    }
+  shared->Barrier();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::ScatterVVoidArray(const void *sendBuffer,
+                                               void *recvBuffer,
+                                               vtkIdType *sendLengths,
+                                               vtkIdType *offsets,
+                                               vtkIdType recvLength, int type,
+                                               int srcProcessId)
+{
+  if (!this->CheckProcessId(srcProcessId))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  shared->Publish(this->LocalProcessId, sendBuffer, recvBuffer,
+                  sendLengths, offsets);
+  shared->Barrier();
+  const vtkThreadedCommunicatorShared::Buffers &src =
+    shared->Published[srcProcessId];
+  vtkIdType length =
+    vtkstd::min(src.Lengths[this->LocalProcessId], recvLength);
+  if (length > 0)
+    {
+    int size = vtkAbstractArray::GetDataTypeSize(type);
+    memcpy(recvBuffer,
+           shared->GetSendBuffer(srcProcessId,
+                                 src.Offsets[this->LocalProcessId]*size),
+           length*size);
+    }
+  shared->Barrier();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::AllGatherVoidArray(const void *sendBuffer,
+                                                void *recvBuffer,
+                                                vtkIdType length, int type)
+{
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  shared->Publish(this->LocalProcessId, sendBuffer, recvBuffer);
+  shared->Barrier();
+  if (length > 0)
+    {
+    vtkIdType size = length*vtkAbstractArray::GetDataTypeSize(type);
+    for (int i = 0; i < shared->NumberOfProcesses; ++i)
+      {
+      memcpy(static_cast<char*>(recvBuffer) + i*size,
+             shared->GetSendBuffer(i, 0), size);
+      }
+    }
+  shared->Barrier();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::AllGatherVVoidArray(const void *sendBuffer,
+                                                 void *recvBuffer,
+                                                 vtkIdType vtkNotUsed(sendLength),
+                                                 vtkIdType *recvLengths,
+                                                 vtkIdType *offsets, int type)
+{
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  shared->Publish(this->LocalProcessId, sendBuffer, recvBuffer);
+  shared->Barrier();
+  int size = vtkAbstractArray::GetDataTypeSize(type);
+  for (int i = 0; i < shared->NumberOfProcesses; ++i)
+    {
+    if (recvLengths[i] > 0)
+      {
+      memcpy(static_cast<char*>(recvBuffer) + offsets[i]*size,
+             shared->GetSendBuffer(i, 0), recvLengths[i]*size);
+      }
+    }
+  shared->Barrier();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedCommunicator::ReduceValues(void *recvBuffer, vtkIdType begin,
+                                           vtkIdType end, int type,
+                                           Operation *operation)
+{
+  if (end <= begin)
+    {
+    return;
+    }
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  int size = vtkAbstractArray::GetDataTypeSize(type);
+  char *recv = static_cast<char*>(recvBuffer) + begin*size;
+  int last = shared->NumberOfProcesses - 1;
+  memcpy(recv, shared->GetSendBuffer(last, begin*size), (end - begin)*size);
+  // Same order as the superclass: A0*(A1*(...*An-1)).
+  for (int i = last - 1; i >= 0; --i)
+    {
+    operation->Function(shared->GetSendBuffer(i, begin*size), recv,
+                        end - begin, type);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::ReduceVoidArray(const void *sendBuffer,
+                                             void *recvBuffer,
+                                             vtkIdType length, int type,
+                                             int operation, int destProcessId)
+{
+  return this->Superclass::ReduceVoidArray(sendBuffer, recvBuffer, length,
+                                           type, operation, destProcessId);
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedCommunicator::ReduceVoidArray(const void *sendBuffer,
+                                             void *recvBuffer,
+                                             vtkIdType length, int type,
+                                             Operation *operation,
+                                             int destProcessId)
+{
+  if (!this->CheckProcessId(destProcessId))
+    {
+    return 0;
+    }
+
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  shared->Publish(this->LocalProcessId, sendBuffer, recvBuffer);
+  shared->Barrier();
+  if (this->LocalProcessId == destProcessId)
+    {
+    this->ReduceValues(recvBuffer, 0, length, type, operation);
+    }
+  shared->Barrier();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// The standard operations work value by value, so every process reduces a
+// slice of the arrays and then copies the slices of the others.
+int vtkThreadedCommunicator::AllReduceVoidArray(const void *sendBuffer,
+                                                void *recvBuffer,
+                                                vtkIdType length, int type,
+                                                int operation)
+{
+  Operation *opClass = vtkCommunicator::NewStandardOperation(operation);
+  if (!opClass)
+    {
+    vtkWarningMacro(<< "Operation number " << operation << " not supported.");
+    return 0;
+    }
+
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  int numProcs = shared->NumberOfProcesses;
+  int size = vtkAbstractArray::GetDataTypeSize(type);
+  shared->Publish(this->LocalProcessId, sendBuffer, recvBuffer);
+  shared->Barrier();
+  this->ReduceValues(recvBuffer, length*this->LocalProcessId/numProcs,
+                     length*(this->LocalProcessId + 1)/numProcs, type,
+                     opClass);
+  shared->Barrier();
+  for (int i = 0; i < numProcs; ++i)
+    {
+    vtkIdType begin = length*i/numProcs;
+    vtkIdType end = length*(i + 1)/numProcs;
+    if (i != this->LocalProcessId && end > begin)
+      {
+      memcpy(static_cast<char*>(recvBuffer) + begin*size,
+             static_cast<const char*>(shared->Published[i].RecvBuffer) +
+             begin*size, (end - begin)*size);
+      }
+    }
+  shared->Barrier();
+  delete opClass;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// A custom operation may not work value by value, so every process reduces
+// the whole arrays.
+int vtkThreadedCommunicator::AllReduceVoidArray(const void *sendBuffer,
+                                                void *recvBuffer,
+                                                vtkIdType length, int type,
+                                                Operation *operation)
+{
+  vtkThreadedCommunicatorShared *shared = this->Shared;
+  shared->Publish(this->LocalProcessId, sendBuffer, recvBuffer);
+  shared->Barrier();
+  this->ReduceValues(recvBuffer, 0, length, type, operation);
+  shared->Barrier();
+  return 1;
+}
@@ -0,0 +1,130 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadedCommunicator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkThreadedCommunicator - Communicator between threads of one process
+// .SECTION Description
+// vtkThreadedCommunicator is the communicator of vtkThreadedController,
+// whose processes are threads sharing the memory of a single process.
+// Every process has a mailbox.  A send copies the values into the mailbox
+// of the destination and returns at once; a receive waits until a message
+// with the requested source and tag is in its mailbox.  Messages from one
+// process to another are received in the order they were sent.
+//
+// Data objects are not marshalled: the receiver gets a shallow copy of the
+// object that was sent, which shares its points, cells and arrays.  The
+// sender must not modify the contents of these arrays after the send, but
+// it may replace them or release the object.
+//
+// The collective operations do not use the mailboxes.  Every process
+// publishes its buffers and waits for the others on a barrier, then reads
+// what it needs from the buffers of the others directly.  AllReduce with a
+// standard operation splits the reduction, so every process reduces a
+// slice of the arrays.
+// .SECTION See Also
+// vtkThreadedController vtkCommunicator
+
+#ifndef __vtkThreadedCommunicator_h
+#define __vtkThreadedCommunicator_h
+
+#include "vtkCommunicator.h"
+
+//BTX
+class vtkThreadedCommunicatorShared;
+//ETX
+
+class VTK_PARALLEL_EXPORT vtkThreadedCommunicator : public vtkCommunicator
+{
+public:
+  vtkTypeMacro(vtkThreadedCommunicator, vtkCommunicator);
+  static vtkThreadedCommunicator *New();
+  virtual void PrintSelf(ostream &os, vtkIndent indent);
+
+  // Description:
+  // Implementation for the abstract superclass.  Sends never block.
+  virtual int SendVoidArray(const void *data, vtkIdType length, int type,
+                            int remoteHandle, int tag);
+  virtual int ReceiveVoidArray(void *data, vtkIdType maxlength, int type,
+                               int remoteHandle, int tag);
+
+  // Description:
+  // Collective operations on the buffers of all the processes.
+  virtual void Barrier();
+  virtual int BroadcastVoidArray(void *data, vtkIdType length, int type,
+                                 int srcProcessId);
+  virtual int GatherVoidArray(const void *sendBuffer, void *recvBuffer,
+                              vtkIdType length, int type, int destProcessId);
+  virtual int GatherVVoidArray(const void *sendBuffer, void *recvBuffer,
+                               vtkIdType sendLength, vtkIdType *recvLengths,
+                               vtkIdType *offsets, int type, int destProcessId);
+  virtual int ScatterVoidArray(const void *sendBuffer, void *recvBuffer,
+                               vtkIdType length, int type, int srcProcessId);
+  virtual int ScatterVVoidArray(const void *sendBuffer, void *recvBuffer,
+                                vtkIdType *sendLengths, vtkIdType *offsets,
+                                vtkIdType recvLength, int type,
+                                int srcProcessId);
+  virtual int AllGatherVoidArray(const void *sendBuffer, void *recvBuffer,
+                                 vtkIdType length, int type);
+  virtual int AllGatherVVoidArray(const void *sendBuffer, void *recvBuffer,
+                                  vtkIdType sendLength, vtkIdType *recvLengths,
+                                  vtkIdType *offsets, int type);
+  virtual int ReduceVoidArray(const void *sendBuffer, void *recvBuffer,
+                              vtkIdType length, int type,
+                              int operation, int destProcessId);
+  virtual int ReduceVoidArray(const void *sendBuffer, void *recvBuffer,
+                              vtkIdType length, int type,
+                              Operation *operation, int destProcessId);
+  virtual int AllReduceVoidArray(const void *sendBuffer, void *recvBuffer,
+                                 vtkIdType length, int type,
+                                 int operation);
+  virtual int AllReduceVoidArray(const void *sendBuffer, void *recvBuffer,
+                                 vtkIdType length, int type,
+                                 Operation *operation);
+
+//BTX
+  // Description:
+  // Connect communicators[i] as process i of numberOfProcesses to a new
+  // set of mailboxes.  Messages pending on their previous connections are
+  // discarded.  Called by vtkThreadedController before it starts the
+  // threads.
+  static void Connect(vtkThreadedCommunicator **communicators,
+                      int numberOfProcesses);
+//ETX
+
+protected:
+  vtkThreadedCommunicator();
+  ~vtkThreadedCommunicator();
+
+  // Pass a shallow copy of the data object instead of marshalling it.
+  virtual int SendElementalDataObject(vtkDataObject* data, int remoteHandle,
+                                      int tag);
+  virtual int ReceiveElementalDataObject(vtkDataObject* data,
+                                         int remoteHandle, int tag);
+
+  // Returns 1 if id is a process of this communicator, reports an error
+  // otherwise.
+  int CheckProcessId(int id);
+
+  // Reduce the values [begin, end) of the send buffers of all processes
+  // into recvBuffer, in the order of the processes.
+  void ReduceValues(void *recvBuffer, vtkIdType begin, vtkIdType end,
+                    int type, Operation *operation);
+
+  vtkThreadedCommunicatorShared *Shared;
+
+private:
+  vtkThreadedCommunicator(const vtkThreadedCommunicator &); // Not implemented
+  void operator=(const vtkThreadedCommunicator &);          // Not implemented
+};
+
+#endif //__vtkThreadedCommunicator_h
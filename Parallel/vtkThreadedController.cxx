@@ -0,0 +1,235 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadedController.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkThreadedController.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkThreadedCommunicator.h"
+
+#include <vtkstd/vector>
+
+vtkStandardNewMacro(vtkThreadedController);
+
+//----------------------------------------------------------------------------
+vtkThreadedController::vtkThreadedController()
+{
+  this->Communicator = vtkThreadedCommunicator::New();
+  this->RMICommunicator = vtkThreadedCommunicator::New();
+  this->Controllers = 0;
+  this->ThreadIds = 0;
+  this->NumberOfControllers = 0;
+  this->MultiThreader = 0;
+  this->ExecutingMultipleMethods = 0;
+  this->Running = 0;
+
+  this->SetNumberOfProcesses(
+    vtkMultiThreader::GetGlobalDefaultNumberOfThreads());
+}
+
+//----------------------------------------------------------------------------
+vtkThreadedController::~vtkThreadedController()
+{
+  this->DeleteProcessControllers();
+  if (this->MultiThreader)
+    {
+    this->MultiThreader->Delete();
+    }
+  this->Communicator->Delete();
+  this->RMICommunicator->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedController::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "NumberOfControllers: " << this->NumberOfControllers
+     << endl;
+  os << indent << "Running: " << this->Running << endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedController::CreateProcessControllers()
+{
+  this->DeleteProcessControllers();
+
+  int numProcs = this->GetNumberOfProcesses();
+  this->Controllers = new vtkThreadedController*[numProcs];
+  this->ThreadIds = new vtkMultiThreaderIDType[numProcs];
+  this->NumberOfControllers = numProcs;
+
+  vtkstd::vector<vtkThreadedCommunicator*> communicators(numProcs);
+  vtkstd::vector<vtkThreadedCommunicator*> rmiCommunicators(numProcs);
+  for (int i = 0; i < numProcs; ++i)
+    {
+    vtkThreadedController *controller =
+      (i == 0 ? this : vtkThreadedController::New());
+    controller->Running = 1;
+    this->Controllers[i] = controller;
+    communicators[i] =
+      static_cast<vtkThreadedCommunicator*>(controller->Communicator);
+    rmiCommunicators[i] =
+      static_cast<vtkThreadedCommunicator*>(controller->RMICommunicator);
+    }
+  // The RMI messages have their own mailboxes, so they never interfere
+  // with the messages of the user.
+  vtkThreadedCommunicator::Connect(&communicators[0], numProcs);
+  vtkThreadedCommunicator::Connect(&rmiCommunicators[0], numProcs);
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedController::DeleteProcessControllers()
+{
+  for (int i = 1; i < this->NumberOfControllers; ++i)
+    {
+    this->Controllers[i]->Delete();
+    }
+  delete [] this->Controllers;
+  delete [] this->ThreadIds;
+  this->Controllers = 0;
+  this->ThreadIds = 0;
+  this->NumberOfControllers = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedController::SingleMethodExecute()
+{
+  if (!this->SingleMethod)
+    {
+    vtkWarningMacro("SingleMethod not set.");
+    return;
+    }
+  this->Execute(0);
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedController::MultipleMethodExecute()
+{
+  this->Execute(1);
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedController::Execute(int multipleMethods)
+{
+  if (this->Running)
+    {
+    this->ExecuteLocalProcess(multipleMethods);
+    return;
+    }
+
+  // The processes wait for each other, so they cannot share threads.
+  int numProcs = this->GetNumberOfProcesses();
+  int maxThreads = vtkMultiThreader::GetGlobalMaximumNumberOfThreads();
+  if (maxThreads > 0 && numProcs > maxThreads)
+    {
+    vtkErrorMacro(<< numProcs << " processes need more threads than the "
+                  << "global maximum of " << maxThreads << ".");
+    return;
+    }
+  if (!this->MultiThreader)
+    {
+    this->MultiThreader = vtkMultiThreader::New();
+    }
+
+  this->CreateProcessControllers();
+  this->ExecutingMultipleMethods = multipleMethods;
+  vtkMultiProcessController::SetGlobalController(this);
+
+  this->MultiThreader->SetNumberOfThreads(numProcs);
+  this->MultiThreader->SetSingleMethod(
+    vtkThreadedController::ExecuteProcess, this);
+  this->MultiThreader->SingleMethodExecute();
+
+  // The controllers of the other processes are released with their
+  // threads.  This one remains process 0.
+  this->DeleteProcessControllers();
+  this->Running = 0;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkThreadedController::ExecuteProcess(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkThreadedController *self =
+    static_cast<vtkThreadedController*>(info->UserData);
+  int id = info->ThreadID;
+  vtkThreadedController *controller = self->Controllers[id];
+
+  // Wait until every thread is known before any of them looks for its
+  // controller.
+  self->ThreadIds[id] = vtkMultiThreader::GetCurrentThreadID();
+  controller->Barrier();
+
+  // The methods are those set on the controller that started the threads.
+  if (controller != self)
+    {
+    controller->SingleMethod = self->SingleMethod;
+    controller->SingleData = self->SingleData;
+    for (int i = 0; self->ExecutingMultipleMethods &&
+           i < self->NumberOfControllers; ++i)
+      {
+      vtkProcessFunctionType multipleMethod;
+      void *multipleData;
+      self->GetMultipleMethod(i, multipleMethod, multipleData);
+      controller->SetMultipleMethod(i, multipleMethod, multipleData);
+      }
+    }
+  controller->ExecuteLocalProcess(self->ExecutingMultipleMethods);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedController::ExecuteLocalProcess(int multipleMethods)
+{
+  if (!multipleMethods)
+    {
+    if (this->SingleMethod)
+      {
+      (this->SingleMethod)(this, this->SingleData);
+      }
+    else
+      {
+      vtkWarningMacro("SingleMethod not set.");
+      }
+    return;
+    }
+
+  int i = this->GetLocalProcessId();
+  vtkProcessFunctionType multipleMethod;
+  void *multipleData;
+  this->GetMultipleMethod(i, multipleMethod, multipleData);
+  if (multipleMethod)
+    {
+    (multipleMethod)(this, multipleData);
+    }
+  else
+    {
+    vtkWarningMacro("MultipleMethod " << i << " not set.");
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMultiProcessController *vtkThreadedController::GetLocalController()
+{
+  vtkMultiThreaderIDType threadId = vtkMultiThreader::GetCurrentThreadID();
+  for (int i = 0; i < this->NumberOfControllers; ++i)
+    {
+    if (vtkMultiThreader::ThreadsEqual(this->ThreadIds[i], threadId))
+      {
+      return this->Controllers[i];
+      }
+    }
+  return this;
+}
@@ -0,0 +1,116 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadedController.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkThreadedController - Controller whose processes are threads
+// .SECTION Description
+// vtkThreadedController runs the processes of a parallel job as threads
+// of the current process, so that the parallel filters (vtkPKdTree,
+// vtkDistributedDataFilter, vtkPStreamTracer, ...) can use the cores of a
+// single machine without MPI.  SingleMethodExecute() and
+// MultipleMethodExecute() start one thread per process and return when all
+// of them have finished.  The calling thread runs process 0 with this
+// controller; every other thread gets its own controller, which is the one
+// passed to its method and the one vtkMultiProcessController::
+// GetGlobalController() returns on that thread.
+//
+// The processes communicate through vtkThreadedCommunicator: sends do not
+// block, data objects are passed as shallow copies instead of being
+// marshalled, and the collective operations read the buffers of the other
+// threads directly.  Since the processes share the memory, the methods
+// must not use the same objects from several threads unless those objects
+// are thread safe.  The information keys are created when they are first
+// used and their creation is not thread safe, so a pipeline should run once
+// on the calling thread before the processes run it.
+//
+// The number of processes defaults to
+// vtkMultiThreader::GetGlobalDefaultNumberOfThreads(), the number of
+// processors, and is limited to VTK_MAX_THREADS.
+// .SECTION See Also
+// vtkThreadedCommunicator vtkMultiProcessController vtkMPIController
+
+#ifndef __vtkThreadedController_h
+#define __vtkThreadedController_h
+
+#include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h" // Needed for VTK_THREAD_RETURN_TYPE
+
+class VTK_PARALLEL_EXPORT vtkThreadedController : public vtkMultiProcessController
+{
+public:
+  static vtkThreadedController *New();
+  vtkTypeMacro(vtkThreadedController,vtkMultiProcessController);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // There is nothing to set up: the threads are started by the execute
+  // methods.
+  virtual void Initialize(int*, char***, int) {}
+  virtual void Initialize(int*, char***) {}
+  virtual void Finalize() {}
+  virtual void Finalize(int) {}
+
+  // Description:
+  // Execute the SingleMethod on NumberOfProcesses threads.  Called from
+  // the thread of a process, it executes the method of that process only,
+  // as vtkMPIController does.
+  virtual void SingleMethodExecute();
+
+  // Description:
+  // Execute MultipleMethod i on thread i, for every process i.  Called
+  // from the thread of a process, it executes the method of that process
+  // only.
+  virtual void MultipleMethodExecute();
+
+  // Description:
+  // Does nothing: all threads write to the output window of the process.
+  virtual void CreateOutputWindow() {}
+
+protected:
+  vtkThreadedController();
+  ~vtkThreadedController();
+
+  // Start one thread per process, which runs the single method or its
+  // multiple method.
+  void Execute(int multipleMethods);
+  static VTK_THREAD_RETURN_TYPE ExecuteProcess(void *arg);
+
+  // Run the single method or the multiple method of this process on the
+  // calling thread.
+  void ExecuteLocalProcess(int multipleMethods);
+
+  // Create the controllers of processes 1 to NumberOfProcesses-1 and
+  // connect their communicators with the communicators of this one.
+  void CreateProcessControllers();
+  void DeleteProcessControllers();
+
+  // Returns the controller of the calling thread.
+  virtual vtkMultiProcessController *GetLocalController();
+
+  // The controller and thread of every process while they execute.
+  vtkThreadedController **Controllers;
+  vtkMultiThreaderIDType *ThreadIds;
+  int NumberOfControllers;
+
+  vtkMultiThreader *MultiThreader;
+  int ExecutingMultipleMethods;
+
+  // Set while the threads of the processes run.
+  int Running;
+
+private:
+  vtkThreadedController(const vtkThreadedController&);  // Not implemented.
+  void operator=(const vtkThreadedController&);  // Not implemented.
+};
+
+#endif
@@ -190,6 +190,9 @@ public:
   virtual void GetPointCells(vtkIdType, vtkIdList*);
   virtual vtkIdType FindCell(double*, vtkCell*, vtkIdType, double, int&, double*, double*);
   virtual vtkIdType FindCell(double*, vtkCell*, vtkGenericCell*, vtkIdType, double, int&, double*, double*);
+  //BTX
+  using vtkPointSet::FindCell;
+  //ETX
   virtual int GetMaxCellSize();
 
   //BTX